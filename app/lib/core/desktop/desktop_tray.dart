@@ -0,0 +1,55 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:flutter/services.dart';
+
+/// Close-to-tray on Windows. The runner hides the window behind a
+/// notification-area icon and drops the process to background priority;
+/// the engine and backend stay up, so sync keeps the wallet at the tip and
+/// reopening is instant.
+class DesktopTray {
+  static const MethodChannel _channel = MethodChannel('com.pirate.wallet/tray');
+
+  static final StreamController<void> _quitRequests =
+      StreamController<void>.broadcast();
+  static bool _started = false;
+
+  static bool get isSupported => Platform.isWindows;
+
+  /// Fires when the user picks Quit from the tray icon's menu. The listener
+  /// must close the app; the runner closes the window itself if nobody
+  /// answers.
+  static Stream<void> get quitRequests => _quitRequests.stream;
+
+  static void start() {
+    if (_started || !isSupported) {
+      return;
+    }
+    _started = true;
+    _channel.setMethodCallHandler((call) async {
+      if (call.method == 'quit') {
+        if (!_quitRequests.hasListener) {
+          throw MissingPluginException('No quit listener');
+        }
+        _quitRequests.add(null);
+        return null;
+      }
+      throw MissingPluginException();
+    });
+  }
+
+  /// Hide the window to the tray. Returns false when the tray is not
+  /// available, in which case the caller should close normally.
+  static Future<bool> hideToTray() async {
+    if (!isSupported) {
+      return false;
+    }
+    try {
+      return await _channel.invokeMethod<bool>('hideToTray') ?? false;
+    } on PlatformException {
+      return false;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+}
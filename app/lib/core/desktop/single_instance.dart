@@ -1,5 +1,7 @@
+import 'dart:async';
 import 'dart:io';
 
+import 'package:flutter/services.dart';
 import 'package:path_provider/path_provider.dart';
 
 class SingleInstanceLock {
@@ -50,3 +52,67 @@ class SingleInstanceLock {
     } catch (_) {}
   }
 }
+
+/// Launches that a second process (a `pirate:` link, a taskbar relaunch)
+/// handed to this one. The Windows and Linux runners forward the arguments
+/// and exit before that process starts an engine.
+class ForwardedLaunches {
+  static const MethodChannel _channel = MethodChannel(
+    'com.pirate.wallet/instance',
+  );
+
+  // Single-subscription so launches that arrive before anyone listens are
+  // kept rather than dropped.
+  static final StreamController<List<String>> _launches =
+      StreamController<List<String>>();
+  static bool _started = false;
+
+  static bool get isSupported => Platform.isWindows || Platform.isLinux;
+
+  /// Arguments of each forwarded launch, in arrival order. Listen once.
+  static Stream<List<String>> get stream => _launches.stream;
+
+  /// The first `pirate:` payment URI among [arguments], if any.
+  static String? paymentUri(List<String> arguments) {
+    for (final argument in arguments) {
+      final trimmed = argument.trim();
+      if (trimmed.toLowerCase().startsWith('pirate:')) {
+        return trimmed;
+      }
+    }
+    return null;
+  }
+
+  /// Start receiving launches, including any the runner held while Dart was
+  /// starting up.
+  static Future<void> start() async {
+    if (_started || !isSupported) {
+      return;
+    }
+    _started = true;
+    _channel.setMethodCallHandler((call) async {
+      if (call.method == 'openArguments') {
+        _launches.add(_arguments(call.arguments));
+      }
+    });
+    try {
+      final pending = await _channel.invokeListMethod<Object?>(
+        'takePendingArguments',
+      );
+      for (final launch in pending ?? const <Object?>[]) {
+        _launches.add(_arguments(launch));
+      }
+    } on PlatformException {
+      // Ignore.
+    } on MissingPluginException {
+      // Ignore.
+    }
+  }
+
+  static List<String> _arguments(Object? value) {
+    if (value is! List) {
+      return const <String>[];
+    }
+    return value.whereType<String>().toList(growable: false);
+  }
+}
@@ -0,0 +1,64 @@
+// Startup timeline recorded by the desktop runners.
+//
+// The Windows and Linux runners time process start, engine creation, plugin
+// registration and the first frame, and merge in the backend's spans. Dart
+// adds its own milestones with [StartupTimeline.mark]. The result is Chrome
+// trace-event JSON (chrome://tracing, Perfetto).
+
+import 'dart:io';
+
+import 'package:flutter/services.dart';
+
+class StartupTimeline {
+  static const MethodChannel _channel = MethodChannel('com.pirate.wallet/perf');
+
+  static bool get _supported => Platform.isWindows || Platform.isLinux;
+
+  /// Record an instant event named [name]. Never throws: timing must not
+  /// affect startup.
+  static Future<void> mark(String name) async {
+    if (!_supported) {
+      return;
+    }
+    try {
+      await _channel.invokeMethod<void>('mark', {'name': name});
+    } on PlatformException {
+      // Ignore.
+    } on MissingPluginException {
+      // Ignore.
+    }
+  }
+
+  /// The timeline so far as `{"traceEvents": [...]}`, or null when the
+  /// runner does not record one.
+  static Future<String?> traceJson() async {
+    if (!_supported) {
+      return null;
+    }
+    try {
+      return await _channel.invokeMethod<String>('getTimeline');
+    } on PlatformException {
+      return null;
+    } on MissingPluginException {
+      return null;
+    }
+  }
+
+  /// Write the timeline to [path], or to `$PIRATE_STARTUP_TRACE` when [path]
+  /// is omitted. The runners also write it there on exit.
+  static Future<bool> writeTrace([String? path]) async {
+    if (!_supported) {
+      return false;
+    }
+    try {
+      final result = await _channel.invokeMethod<bool>('writeTrace', {
+        if (path != null) 'path': path,
+      });
+      return result ?? false;
+    } on PlatformException {
+      return false;
+    } on MissingPluginException {
+      return false;
+    }
+  }
+}
@@ -0,0 +1,142 @@
+import 'dart:async';
+import 'dart:convert';
+import 'dart:io';
+
+import 'package:flutter/services.dart';
+import 'package:flutter_rust_bridge/flutter_rust_bridge_for_generated.dart';
+
+import '../ffi/generated/models.dart';
+
+/// Last-known dashboard state for one wallet, from the previous session.
+class WarmWalletSnapshot {
+  const WarmWalletSnapshot({
+    required this.walletId,
+    required this.syncedHeight,
+    required this.balance,
+    required this.transactions,
+  });
+
+  final String walletId;
+  final int syncedHeight;
+  final Balance balance;
+
+  /// Newest transactions first, without memos.
+  final List<TxInfo> transactions;
+}
+
+/// Warm-start snapshot written by the backend after sync checkpoints and
+/// sealed by the runner (DPAPI on Windows, Secret Service on Linux). The
+/// runner unseals it while the engine starts, so the dashboard can paint the
+/// last known balance and activity before the wallet database answers. The
+/// real queries replace it as soon as they complete.
+class WarmStart {
+  static const MethodChannel _channel = MethodChannel(
+    'com.pirate.wallet/warm_start',
+  );
+
+  /// Must match WARM_SNAPSHOT_VERSION in the backend.
+  static const int _version = 1;
+
+  /// The runner answers from memory once its load finished; a keyring that
+  /// is slow to answer is not worth waiting for.
+  static const Duration _timeout = Duration(milliseconds: 500);
+
+  static Future<Map<String, WarmWalletSnapshot>>? _snapshots;
+
+  static bool get isSupported => Platform.isWindows || Platform.isLinux;
+
+  /// Start fetching the snapshot early in startup. The runner hands it out
+  /// once per launch; later calls share the first result.
+  static Future<Map<String, WarmWalletSnapshot>> snapshots() {
+    return _snapshots ??= _take();
+  }
+
+  static Future<Map<String, WarmWalletSnapshot>> _take() async {
+    if (!isSupported) {
+      return const {};
+    }
+    try {
+      final bytes = await _channel
+          .invokeMethod<Uint8List>('takeSnapshot')
+          .timeout(_timeout);
+      if (bytes == null || bytes.isEmpty) {
+        return const {};
+      }
+      return _decode(bytes);
+    } on PlatformException {
+      return const {};
+    } on MissingPluginException {
+      return const {};
+    } on TimeoutException {
+      return const {};
+    } on FormatException {
+      return const {};
+    }
+  }
+
+  static Map<String, WarmWalletSnapshot> _decode(Uint8List bytes) {
+    final document = jsonDecode(utf8.decode(bytes));
+    if (document is! Map<String, dynamic> || document['v'] != _version) {
+      return const {};
+    }
+    final wallets = document['wallets'];
+    if (wallets is! List) {
+      return const {};
+    }
+    final result = <String, WarmWalletSnapshot>{};
+    for (final wallet in wallets.whereType<Map<String, dynamic>>()) {
+      final snapshot = _decodeWallet(wallet);
+      if (snapshot != null) {
+        result[snapshot.walletId] = snapshot;
+      }
+    }
+    return result;
+  }
+
+  static WarmWalletSnapshot? _decodeWallet(Map<String, dynamic> wallet) {
+    final walletId = wallet['wallet_id'];
+    final height = wallet['synced_height'];
+    final balance = wallet['balance'];
+    if (walletId is! String || height is! int || balance is! Map) {
+      return null;
+    }
+    final transactions = wallet['transactions'];
+    return WarmWalletSnapshot(
+      walletId: walletId,
+      syncedHeight: height,
+      balance: Balance(
+        total: _amount(balance['total']),
+        spendable: _amount(balance['spendable']),
+        pending: _amount(balance['pending']),
+      ),
+      transactions: transactions is List
+          ? transactions
+                .whereType<Map<String, dynamic>>()
+                .map(_decodeTx)
+                .toList(growable: false)
+          : const [],
+    );
+  }
+
+  static TxInfo _decodeTx(Map<String, dynamic> tx) {
+    return TxInfo(
+      txid: tx['txid'] as String? ?? '',
+      height: tx['height'] as int?,
+      timestamp: PlatformInt64Util.from(tx['timestamp'] as int? ?? 0),
+      amount: PlatformInt64Util.from(_amount(tx['amount']).toInt()),
+      fee: _amount(tx['fee']),
+      confirmed: tx['confirmed'] as bool? ?? false,
+    );
+  }
+
+  /// Amounts are decimal strings so u64 values survive JSON.
+  static BigInt _amount(Object? value) {
+    if (value is String) {
+      return BigInt.tryParse(value) ?? BigInt.zero;
+    }
+    if (value is int) {
+      return BigInt.from(value);
+    }
+    return BigInt.zero;
+  }
+}
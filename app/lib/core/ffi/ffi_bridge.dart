@@ -957,6 +957,7 @@ class FfiBridge {
   //
   // Mirrors Rust: crates/pirate-ffi-frb/src/api.rs
   // - set_lightd_endpoint(), get_lightd_endpoint(), get_lightd_endpoint_config()
+  // - set_lightd_mirrors(), get_lightd_mirrors()
   // ============================================================================
 
   /// Default lightwalletd endpoint (known-working mainnet)
@@ -1007,6 +1008,27 @@ class FfiBridge {
     throw UnimplementedError('FRB bindings not available');
   }
 
+  /// Mirror lightwalletd servers sync spreads block-range fetches across.
+  static Future<void> setLightdMirrors({
+    required WalletId walletId,
+    required List<String> urls,
+  }) async {
+    if (kUseFrbBindings) {
+      await api.setLightdMirrors(walletId: walletId, urls: urls);
+      return;
+    }
+    // Fallback stub (should not be reached if kUseFrbBindings is true)
+    throw UnimplementedError('FRB bindings not available');
+  }
+
+  static Future<List<String>> getLightdMirrors(WalletId id) async {
+    if (kUseFrbBindings) {
+      return await api.getLightdMirrors(walletId: id);
+    }
+    // Fallback stub (should not be reached if kUseFrbBindings is true)
+    throw UnimplementedError('FRB bindings not available');
+  }
+
   // Network Tunnel
   static Future<void> setTunnel(
     TunnelMode mode, {
@@ -650,6 +650,19 @@ Future<String> getLightdEndpoint({required String walletId}) =>
 Future<LightdEndpoint> getLightdEndpointConfig({required String walletId}) =>
     RustLib.instance.api.crateApiGetLightdEndpointConfig(walletId: walletId);
 
+/// Set the mirror lightwalletd URLs sync spreads block fetches across
+Future<void> setLightdMirrors({
+  required String walletId,
+  required List<String> urls,
+}) => RustLib.instance.api.crateApiSetLightdMirrors(
+  walletId: walletId,
+  urls: urls,
+);
+
+/// Get the configured mirror lightwalletd URLs
+Future<List<String>> getLightdMirrors({required String walletId}) =>
+    RustLib.instance.api.crateApiGetLightdMirrors(walletId: walletId);
+
 /// Set network tunnel mode
 Future<void> setTunnel({required TunnelMode mode}) =>
     RustLib.instance.api.crateApiSetTunnel(mode: mode);
@@ -1016,6 +1029,13 @@ Future<List<SyncLogEntryFfi>> getSyncLogs({
 }) =>
     RustLib.instance.api.crateApiGetSyncLogs(walletId: walletId, limit: limit);
 
+/// Per-method call counts and latency histograms of the wallet service, as
+/// JSON. Covers the calls made through these bindings as well as requests
+/// served through the service request path (native C ABI, batch and CBOR
+/// entry points).
+Future<String> getServiceStatsJson() =>
+    RustLib.instance.api.crateApiGetServiceStatsJson();
+
 /// Get checkpoint details at specific height
 Future<CheckpointInfo?> getCheckpointDetails({
   required String walletId,
@@ -331,6 +331,8 @@ abstract class RustLibApi extends BaseApi {
     required String walletId,
   });
 
+  Future<List<String>> crateApiGetLightdMirrors({required String walletId});
+
   Future<NetworkInfo> crateApiGetNetworkInfo();
 
   Future<List<AddressBookEntryFfi>> crateApiGetRecentlyUsedAddresses({
@@ -354,6 +356,8 @@ abstract class RustLibApi extends BaseApi {
 
   Future<SeedExportWarnings> crateApiGetSeedExportWarnings();
 
+  Future<String> crateApiGetServiceStatsJson();
+
   Future<SpendabilityStatus> crateApiGetSpendabilityStatus({
     required String walletId,
   });
@@ -525,6 +529,11 @@ abstract class RustLibApi extends BaseApi {
     String? tlsPinOpt,
   });
 
+  Future<void> crateApiSetLightdMirrors({
+    required String walletId,
+    required List<String> urls,
+  });
+
   Future<void> crateApiSetPanicPin({required String pin});
 
   Future<void> crateApiSetTorBridgeSettings({
@@ -2517,6 +2526,30 @@ class RustLibApiImpl extends RustLibApiImplPlatform implements RustLibApi {
         argNames: ["walletId"],
       );
 
+  @override
+  Future<List<String>> crateApiGetLightdMirrors({required String walletId}) {
+    return handler.executeNormal(
+      NormalTask(
+        callFfi: (port_) {
+          var arg0 = cst_encode_String(walletId);
+          return wire.wire__crate__api__get_lightd_mirrors(port_, arg0);
+        },
+        codec: DcoCodec(
+          decodeSuccessData: dco_decode_list_String,
+          decodeErrorData: dco_decode_AnyhowException,
+        ),
+        constMeta: kCrateApiGetLightdMirrorsConstMeta,
+        argValues: [walletId],
+        apiImpl: this,
+      ),
+    );
+  }
+
+  TaskConstMeta get kCrateApiGetLightdMirrorsConstMeta => const TaskConstMeta(
+    debugName: "get_lightd_mirrors",
+    argNames: ["walletId"],
+  );
+
   @override
   Future<NetworkInfo> crateApiGetNetworkInfo() {
     return handler.executeNormal(
@@ -2706,6 +2739,27 @@ class RustLibApiImpl extends RustLibApiImplPlatform implements RustLibApi {
   TaskConstMeta get kCrateApiGetSeedExportWarningsConstMeta =>
       const TaskConstMeta(debugName: "get_seed_export_warnings", argNames: []);
 
+  @override
+  Future<String> crateApiGetServiceStatsJson() {
+    return handler.executeNormal(
+      NormalTask(
+        callFfi: (port_) {
+          return wire.wire__crate__api__get_service_stats_json(port_);
+        },
+        codec: DcoCodec(
+          decodeSuccessData: dco_decode_String,
+          decodeErrorData: dco_decode_AnyhowException,
+        ),
+        constMeta: kCrateApiGetServiceStatsJsonConstMeta,
+        argValues: [],
+        apiImpl: this,
+      ),
+    );
+  }
+
+  TaskConstMeta get kCrateApiGetServiceStatsJsonConstMeta =>
+      const TaskConstMeta(debugName: "get_service_stats_json", argNames: []);
+
   @override
   Future<SpendabilityStatus> crateApiGetSpendabilityStatus({
     required String walletId,
@@ -3999,6 +4053,34 @@ class RustLibApiImpl extends RustLibApiImplPlatform implements RustLibApi {
     argNames: ["walletId", "url", "tlsPinOpt"],
   );
 
+  @override
+  Future<void> crateApiSetLightdMirrors({
+    required String walletId,
+    required List<String> urls,
+  }) {
+    return handler.executeNormal(
+      NormalTask(
+        callFfi: (port_) {
+          var arg0 = cst_encode_String(walletId);
+          var arg1 = cst_encode_list_String(urls);
+          return wire.wire__crate__api__set_lightd_mirrors(port_, arg0, arg1);
+        },
+        codec: DcoCodec(
+          decodeSuccessData: dco_decode_unit,
+          decodeErrorData: dco_decode_AnyhowException,
+        ),
+        constMeta: kCrateApiSetLightdMirrorsConstMeta,
+        argValues: [walletId, urls],
+        apiImpl: this,
+      ),
+    );
+  }
+
+  TaskConstMeta get kCrateApiSetLightdMirrorsConstMeta => const TaskConstMeta(
+    debugName: "set_lightd_mirrors",
+    argNames: ["walletId", "urls"],
+  );
+
   @override
   Future<void> crateApiSetPanicPin({required String pin}) {
     return handler.executeNormal(
@@ -3595,6 +3595,28 @@ class RustLibWire implements BaseWire {
             void Function(int, ffi.Pointer<wire_cst_list_prim_u_8_strict>)
           >();
 
+  void wire__crate__api__get_lightd_mirrors(
+    int port_,
+    ffi.Pointer<wire_cst_list_prim_u_8_strict> wallet_id,
+  ) {
+    return _wire__crate__api__get_lightd_mirrors(port_, wallet_id);
+  }
+
+  late final _wire__crate__api__get_lightd_mirrorsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Int64,
+            ffi.Pointer<wire_cst_list_prim_u_8_strict>,
+          )
+        >
+      >('frbgen_pirate_wallet_wire__crate__api__get_lightd_mirrors');
+  late final _wire__crate__api__get_lightd_mirrors =
+      _wire__crate__api__get_lightd_mirrorsPtr
+          .asFunction<
+            void Function(int, ffi.Pointer<wire_cst_list_prim_u_8_strict>)
+          >();
+
   void wire__crate__api__get_network_info(int port_) {
     return _wire__crate__api__get_network_info(port_);
   }
@@ -3730,6 +3752,17 @@ class RustLibWire implements BaseWire {
       _wire__crate__api__get_seed_export_warningsPtr
           .asFunction<void Function(int)>();
 
+  void wire__crate__api__get_service_stats_json(int port_) {
+    return _wire__crate__api__get_service_stats_json(port_);
+  }
+
+  late final _wire__crate__api__get_service_stats_jsonPtr =
+      _lookup<ffi.NativeFunction<ffi.Void Function(ffi.Int64)>>(
+        'frbgen_pirate_wallet_wire__crate__api__get_service_stats_json',
+      );
+  late final _wire__crate__api__get_service_stats_json = _wire__crate__api__get_service_stats_jsonPtr
+      .asFunction<void Function(int)>();
+
   void wire__crate__api__get_spendability_status(
     int port_,
     ffi.Pointer<wire_cst_list_prim_u_8_strict> wallet_id,
@@ -4789,6 +4822,34 @@ class RustLibWire implements BaseWire {
             )
           >();
 
+  void wire__crate__api__set_lightd_mirrors(
+    int port_,
+    ffi.Pointer<wire_cst_list_prim_u_8_strict> wallet_id,
+    ffi.Pointer<wire_cst_list_String> urls,
+  ) {
+    return _wire__crate__api__set_lightd_mirrors(port_, wallet_id, urls);
+  }
+
+  late final _wire__crate__api__set_lightd_mirrorsPtr =
+      _lookup<
+        ffi.NativeFunction<
+          ffi.Void Function(
+            ffi.Int64,
+            ffi.Pointer<wire_cst_list_prim_u_8_strict>,
+            ffi.Pointer<wire_cst_list_String>,
+          )
+        >
+      >('frbgen_pirate_wallet_wire__crate__api__set_lightd_mirrors');
+  late final _wire__crate__api__set_lightd_mirrors =
+      _wire__crate__api__set_lightd_mirrorsPtr
+          .asFunction<
+            void Function(
+              int,
+              ffi.Pointer<wire_cst_list_prim_u_8_strict>,
+              ffi.Pointer<wire_cst_list_String>,
+            )
+          >();
+
   void wire__crate__api__set_panic_pin(
     int port_,
     ffi.Pointer<wire_cst_list_prim_u_8_strict> pin,
@@ -2245,6 +2245,11 @@ class RustLibWire implements BaseWire {
   ) =>
       wasmModule.wire__crate__api__get_lightd_endpoint_config(port_, wallet_id);
 
+  void wire__crate__api__get_lightd_mirrors(
+    NativePortType port_,
+    String wallet_id,
+  ) => wasmModule.wire__crate__api__get_lightd_mirrors(port_, wallet_id);
+
   void wire__crate__api__get_network_info(NativePortType port_) =>
       wasmModule.wire__crate__api__get_network_info(port_);
 
@@ -2288,6 +2293,9 @@ class RustLibWire implements BaseWire {
   void wire__crate__api__get_seed_export_warnings(NativePortType port_) =>
       wasmModule.wire__crate__api__get_seed_export_warnings(port_);
 
+  void wire__crate__api__get_service_stats_json(NativePortType port_) =>
+      wasmModule.wire__crate__api__get_service_stats_json(port_);
+
   void wire__crate__api__get_spendability_status(
     NativePortType port_,
     String wallet_id,
@@ -2587,6 +2595,12 @@ class RustLibWire implements BaseWire {
     tls_pin_opt,
   );
 
+  void wire__crate__api__set_lightd_mirrors(
+    NativePortType port_,
+    String wallet_id,
+    JSAny urls,
+  ) => wasmModule.wire__crate__api__set_lightd_mirrors(port_, wallet_id, urls);
+
   void wire__crate__api__set_panic_pin(NativePortType port_, String pin) =>
       wasmModule.wire__crate__api__set_panic_pin(port_, pin);
 
@@ -3186,6 +3200,11 @@ extension type RustLibWasmModule._(JSObject _) implements JSObject {
     String wallet_id,
   );
 
+  external void wire__crate__api__get_lightd_mirrors(
+    NativePortType port_,
+    String wallet_id,
+  );
+
   external void wire__crate__api__get_network_info(NativePortType port_);
 
   external void wire__crate__api__get_recently_used_addresses(
@@ -3217,6 +3236,8 @@ extension type RustLibWasmModule._(JSObject _) implements JSObject {
     NativePortType port_,
   );
 
+  external void wire__crate__api__get_service_stats_json(NativePortType port_);
+
   external void wire__crate__api__get_spendability_status(
     NativePortType port_,
     String wallet_id,
@@ -3446,6 +3467,12 @@ extension type RustLibWasmModule._(JSObject _) implements JSObject {
     String? tls_pin_opt,
   );
 
+  external void wire__crate__api__set_lightd_mirrors(
+    NativePortType port_,
+    String wallet_id,
+    JSAny urls,
+  );
+
   external void wire__crate__api__set_panic_pin(
     NativePortType port_,
     String pin,
@@ -0,0 +1,2 @@
+export 'prover_prewarm_native_stub.dart'
+    if (dart.library.io) 'prover_prewarm_native_io.dart';
@@ -0,0 +1,52 @@
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+class _ProverPrewarmBindings {
+  _ProverPrewarmBindings(ffi.DynamicLibrary library)
+    : prewarm = library.lookupFunction<ffi.Void Function(), void Function()>(
+        'pirate_prewarm_prover',
+      );
+
+  final void Function() prewarm;
+}
+
+_ProverPrewarmBindings? _bindings;
+
+ffi.DynamicLibrary _openLibrary() {
+  if (Platform.isIOS || Platform.isMacOS) {
+    try {
+      return ffi.DynamicLibrary.process();
+    } catch (_) {
+      if (Platform.isIOS) {
+        rethrow;
+      }
+    }
+  }
+
+  if (Platform.isWindows) {
+    return ffi.DynamicLibrary.open('pirate_ffi_frb.dll');
+  }
+  if (Platform.isAndroid || Platform.isLinux) {
+    return ffi.DynamicLibrary.open('libpirate_ffi_frb.so');
+  }
+  if (Platform.isMacOS) {
+    return ffi.DynamicLibrary.open('libpirate_ffi_frb.dylib');
+  }
+
+  return ffi.DynamicLibrary.process();
+}
+
+_ProverPrewarmBindings? _loadBindings() {
+  try {
+    return _bindings ??= _ProverPrewarmBindings(_openLibrary());
+  } catch (_) {
+    return null;
+  }
+}
+
+/// Starts loading the proving parameters on a low-priority backend thread so
+/// the first send does not freeze on them. Returns at once; later calls are
+/// no-ops.
+void prewarmNativeProver() {
+  _loadBindings()?.prewarm();
+}
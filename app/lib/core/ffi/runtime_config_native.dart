@@ -0,0 +1,2 @@
+export 'runtime_config_native_stub.dart'
+    if (dart.library.io) 'runtime_config_native_io.dart';
@@ -0,0 +1,104 @@
+import 'dart:ffi' as ffi;
+import 'dart:io';
+
+typedef _ConfigureRuntimeNative =
+    ffi.Int32 Function(ffi.Uint32, ffi.Uint32, ffi.Uint64);
+typedef _ConfigureRuntimeDart = int Function(int, int, int);
+typedef _SetMemoryBudgetNative = ffi.Int32 Function(ffi.Uint64);
+typedef _SetMemoryBudgetDart = int Function(int);
+
+/// Devices at or below this much RAM get a memory budget.
+const int _lowRamThresholdBytes = 3 * 1024 * 1024 * 1024;
+/// Smallest budget the backend accepts.
+const int _minMemoryBudgetBytes = 128 * 1000 * 1000;
+
+ffi.DynamicLibrary _openLibrary() {
+  if (Platform.isIOS || Platform.isMacOS) {
+    try {
+      return ffi.DynamicLibrary.process();
+    } catch (_) {
+      if (Platform.isIOS) {
+        rethrow;
+      }
+    }
+  }
+
+  if (Platform.isWindows) {
+    return ffi.DynamicLibrary.open('pirate_ffi_frb.dll');
+  }
+  if (Platform.isAndroid || Platform.isLinux) {
+    return ffi.DynamicLibrary.open('libpirate_ffi_frb.so');
+  }
+  if (Platform.isMacOS) {
+    return ffi.DynamicLibrary.open('libpirate_ffi_frb.dylib');
+  }
+
+  return ffi.DynamicLibrary.process();
+}
+
+/// Sizes the backend runtime. Only takes effect before the first wallet
+/// call; returns false when the runtime already started or the call failed.
+/// Zero keeps the backend default for that size.
+Future<bool> configureNativeRuntime({
+  int workerThreads = 0,
+  int maxBlockingThreads = 0,
+  int cpuAffinityMask = 0,
+}) async {
+  try {
+    final configure = _openLibrary()
+        .lookupFunction<_ConfigureRuntimeNative, _ConfigureRuntimeDart>(
+          'pirate_configure_runtime',
+        );
+    return configure(workerThreads, maxBlockingThreads, cpuAffinityMask) == 0;
+  } catch (_) {
+    return false;
+  }
+}
+
+/// Caps backend sync batches, block cache reads and proving to [bytes] of
+/// memory; 0 removes the cap. Can be called at any time. Returns false when
+/// the budget was rejected (below 128 MB) or the call failed.
+Future<bool> configureNativeMemoryBudget(int bytes) async {
+  try {
+    final setBudget = _openLibrary()
+        .lookupFunction<_SetMemoryBudgetNative, _SetMemoryBudgetDart>(
+          'pirate_set_memory_budget',
+        );
+    return setBudget(bytes) == 0;
+  } catch (_) {
+    return false;
+  }
+}
+
+/// Desktop hosts get a worker per two cores (2 to 8) so several wallets can
+/// sync at once; phones keep the small default to save battery, and Android
+/// phones with 3 GB of RAM or less get a memory budget of a quarter of it.
+Future<bool> configureNativeRuntimeForHost() async {
+  if (Platform.isAndroid) {
+    final totalRam = await _androidTotalRamBytes();
+    if (totalRam != null && totalRam <= _lowRamThresholdBytes) {
+      final budget = totalRam ~/ 4;
+      await configureNativeMemoryBudget(
+        budget < _minMemoryBudgetBytes ? _minMemoryBudgetBytes : budget,
+      );
+    }
+  }
+  if (!(Platform.isWindows || Platform.isLinux || Platform.isMacOS)) {
+    return false;
+  }
+  final cores = Platform.numberOfProcessors;
+  return configureNativeRuntime(workerThreads: (cores ~/ 2).clamp(2, 8));
+}
+
+/// `MemTotal` from /proc/meminfo, or null when it cannot be read.
+Future<int?> _androidTotalRamBytes() async {
+  try {
+    final meminfo = await File('/proc/meminfo').readAsString();
+    final match = RegExp(r'^MemTotal:\s+(\d+)\s+kB', multiLine: true)
+        .firstMatch(meminfo);
+    final kib = match == null ? null : int.tryParse(match.group(1)!);
+    return kib == null ? null : kib * 1024;
+  } catch (_) {
+    return null;
+  }
+}
@@ -0,0 +1,9 @@
+Future<bool> configureNativeRuntime({
+  int workerThreads = 0,
+  int maxBlockingThreads = 0,
+  int cpuAffinityMask = 0,
+}) async => false;
+
+Future<bool> configureNativeMemoryBudget(int bytes) async => false;
+
+Future<bool> configureNativeRuntimeForHost() async => false;
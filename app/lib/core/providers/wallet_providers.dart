@@ -5,6 +5,7 @@ import 'dart:async';
 import 'package:flutter_riverpod/flutter_riverpod.dart';
 import '../background/background_sync_handler.dart';
 import '../background/background_sync_manager.dart' as bg;
+import '../desktop/warm_start.dart';
 import '../ffi/ffi_bridge.dart';
 import '../ffi/generated/models.dart' hide SyncLogEntryFfi;
 import '../ffi/generated/api.dart' as api;
@@ -299,6 +300,20 @@ final balanceProvider = FutureProvider<Balance?>((ref) async {
   return FfiBridge.getBalance(walletId);
 });
 
+/// Previous session's dashboard state for the active wallet, painted while
+/// the first balance and history queries are in flight. Null when there is
+/// none or it belongs to another wallet.
+final warmWalletSnapshotProvider = Provider<WarmWalletSnapshot?>((ref) {
+  final walletId = ref.watch(activeWalletProvider);
+  if (walletId == null) return null;
+  final snapshots = ref.watch(_warmSnapshotsProvider).asData?.value;
+  return snapshots?[walletId];
+});
+
+final _warmSnapshotsProvider = FutureProvider<Map<String, WarmWalletSnapshot>>(
+  (ref) => WarmStart.snapshots(),
+);
+
 /// Balance stream
 final balanceStreamProvider = StreamProvider<Balance?>((ref) async* {
   final walletId = ref.watch(activeWalletProvider);
@@ -0,0 +1,43 @@
+import 'dart:async';
+import 'dart:io';
+
+import 'package:flutter/services.dart';
+
+/// Opt-in fast unlock on desktop. After an unlock that ran the passphrase
+/// KDF, the backend hands the derived database keys to the runner, which
+/// seals them with DPAPI (Windows) or the Secret Service (Linux). The next
+/// unlock checks the passphrase against that bundle and skips Argon2id.
+///
+/// The keys are then only as safe as the OS account, so the bundle expires
+/// after [maxAge] and is deleted when the preference is turned off, the
+/// passphrase changes or a decoy vault opens.
+class FastUnlock {
+  static const MethodChannel _channel = MethodChannel(
+    'com.pirate.wallet/fast_unlock',
+  );
+
+  /// How long a bundle can stand in for the KDF before one full unlock is
+  /// needed again.
+  static const Duration maxAge = Duration(days: 7);
+
+  static bool get isSupported => Platform.isWindows || Platform.isLinux;
+
+  /// Apply the preference. Must run after the backend library is loaded; the
+  /// runner forwards it to the backend and deletes the stored bundle when
+  /// [enabled] is false.
+  static Future<void> configure({required bool enabled}) async {
+    if (!isSupported) {
+      return;
+    }
+    try {
+      await _channel.invokeMethod<void>('configure', <String, Object>{
+        'enabled': enabled,
+        'maxAgeSeconds': maxAge.inSeconds,
+      });
+    } on PlatformException {
+      // Unlock keeps using the full KDF.
+    } on MissingPluginException {
+      // Unlock keeps using the full KDF.
+    }
+  }
+}
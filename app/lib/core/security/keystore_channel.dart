@@ -7,7 +7,10 @@
 // - Windows DPAPI
 // - Linux libsecret
 
+import 'dart:async';
 import 'dart:io';
+import 'dart:typed_data';
+
 import 'package:flutter/services.dart';
 
 import '../i18n/arb_text_localizer.dart';
@@ -35,7 +38,14 @@ class KeystoreChannel {
   }
 
   /// Retrieve sealed key from OS keystore
+  ///
+  /// On Windows and Linux, lookups issued in the same microtask (such as a
+  /// `Future.wait` over every wallet at startup) go out as one retrieveKeys
+  /// call.
   static Future<List<int>?> retrieveKey(String keyId) async {
+    if (_hasBulkKeyMethods) {
+      return _retrieveBatch.add(keyId);
+    }
     try {
       final result = await _channel.invokeMethod<List<dynamic>>('retrieveKey', {
         'keyId': keyId,
@@ -59,7 +69,12 @@ class KeystoreChannel {
   }
 
   /// Check if key exists
+  ///
+  /// Batched into one keysExist call like [retrieveKey].
   static Future<bool> keyExists(String keyId) async {
+    if (_hasBulkKeyMethods) {
+      return _existsBatch.add(keyId);
+    }
     try {
       final result = await _channel.invokeMethod<bool>('keyExists', {
         'keyId': keyId,
@@ -70,6 +85,75 @@ class KeystoreChannel {
     }
   }
 
+  /// Whether the native side answers the bulk key methods in one call.
+  static bool get _hasBulkKeyMethods => Platform.isWindows || Platform.isLinux;
+
+  static final _retrieveBatch = _KeyBatch<List<int>?>(retrieveKeys);
+  static final _existsBatch = _KeyBatch<bool>(keysExist);
+
+  /// Store several sealed keys in one channel call.
+  static Future<bool> storeKeys(Map<String, List<int>> keys) async {
+    if (!_hasBulkKeyMethods) {
+      for (final entry in keys.entries) {
+        if (!await storeKey(keyId: entry.key, encryptedKey: entry.value)) {
+          return false;
+        }
+      }
+      return true;
+    }
+    try {
+      final result = await _channel.invokeMethod<bool>('storeKeys', {
+        'keys': {
+          for (final entry in keys.entries)
+            entry.key: Uint8List.fromList(entry.value),
+        },
+      });
+      return result ?? false;
+    } on PlatformException catch (e) {
+      throw KeystoreException('Failed to store keys: ${e.message}');
+    }
+  }
+
+  /// Retrieve several sealed keys in one channel call. Missing keys map to
+  /// null.
+  static Future<Map<String, List<int>?>> retrieveKeys(
+    List<String> keyIds,
+  ) async {
+    if (!_hasBulkKeyMethods) {
+      return {for (final keyId in keyIds) keyId: await retrieveKey(keyId)};
+    }
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'retrieveKeys',
+        {'keyIds': keyIds},
+      );
+      return {
+        for (final keyId in keyIds)
+          keyId: (result?[keyId] as List<dynamic>?)?.cast<int>(),
+      };
+    } on PlatformException catch (e) {
+      throw KeystoreException('Failed to retrieve keys: ${e.message}');
+    }
+  }
+
+  /// Check several keys in one channel call.
+  static Future<Map<String, bool>> keysExist(List<String> keyIds) async {
+    if (!_hasBulkKeyMethods) {
+      return {for (final keyId in keyIds) keyId: await keyExists(keyId)};
+    }
+    try {
+      final result = await _channel.invokeMethod<Map<dynamic, dynamic>>(
+        'keysExist',
+        {'keyIds': keyIds},
+      );
+      return {
+        for (final keyId in keyIds) keyId: result?[keyId] as bool? ?? false,
+      };
+    } on PlatformException catch (e) {
+      throw KeystoreException('Failed to check keys: ${e.message}');
+    }
+  }
+
   /// Seal master key with OS keystore
   ///
   /// On Android: Uses Keystore with StrongBox if available
@@ -108,6 +192,40 @@ class KeystoreChannel {
     }
   }
 
+  /// Keep the unsealed master key in locked native memory for [idleTtl] after
+  /// its last use, so repeat unlocks skip the keystore round trip.
+  ///
+  /// Windows and Linux only; a zero duration disables the cache. The cache is
+  /// also wiped on session lock and system suspend.
+  static Future<void> configureMasterKeyCache({
+    required Duration idleTtl,
+  }) async {
+    if (!Platform.isWindows && !Platform.isLinux) {
+      return;
+    }
+    try {
+      await _channel.invokeMethod<bool>('configureMasterKeyCache', {
+        'idleTtlMs': idleTtl.inMilliseconds,
+      });
+    } on PlatformException catch (e) {
+      throw KeystoreException(
+        'Failed to configure master key cache: ${e.message}',
+      );
+    }
+  }
+
+  /// Wipe the native master key cache configured by [configureMasterKeyCache].
+  static Future<void> clearMasterKeyCache() async {
+    if (!Platform.isWindows && !Platform.isLinux) {
+      return;
+    }
+    try {
+      await _channel.invokeMethod<bool>('clearMasterKeyCache');
+    } on PlatformException catch (e) {
+      throw KeystoreException('Failed to clear master key cache: ${e.message}');
+    }
+  }
+
   /// Get keystore capabilities for current platform
   static Future<KeystoreCapabilities> getCapabilities() async {
     try {
@@ -154,6 +272,42 @@ class KeystoreChannel {
   }
 }
 
+/// Coalesces single-key lookups made in one microtask into one bulk call.
+class _KeyBatch<T> {
+  _KeyBatch(this._lookup);
+
+  final Future<Map<String, T>> Function(List<String> keyIds) _lookup;
+  Map<String, List<Completer<T>>> _waiting = {};
+
+  Future<T> add(String keyId) {
+    if (_waiting.isEmpty) {
+      scheduleMicrotask(_flush);
+    }
+    final completer = Completer<T>();
+    _waiting.putIfAbsent(keyId, () => []).add(completer);
+    return completer.future;
+  }
+
+  Future<void> _flush() async {
+    final batch = _waiting;
+    _waiting = {};
+    try {
+      final results = await _lookup(batch.keys.toList());
+      for (final entry in batch.entries) {
+        for (final completer in entry.value) {
+          completer.complete(results[entry.key] as T);
+        }
+      }
+    } catch (e, stackTrace) {
+      for (final completers in batch.values) {
+        for (final completer in completers) {
+          completer.completeError(e, stackTrace);
+        }
+      }
+    }
+  }
+}
+
 /// Keystore capabilities
 class KeystoreCapabilities {
   /// Has secure hardware (TEE/Secure Enclave)
@@ -0,0 +1,215 @@
+// Binary keystore channel for bulk payloads
+//
+// Encrypted seed and key exports, watch-only bundles and backup archives go
+// through com.pirate.wallet/keystore_raw instead of the method channel, so
+// they are never copied out of StandardMessageCodec maps or base64 encoded.
+// Every message is a 16-byte little-endian header and a body; payloads above
+// one chunk are streamed. The framing matches KeystoreStream in the Windows
+// runner and the keystore_raw handler in the Linux runner.
+
+import 'dart:convert';
+import 'dart:io';
+import 'dart:typed_data';
+
+import 'package:flutter/services.dart';
+
+import 'keystore_channel.dart';
+
+/// Raw keystore transfers (Windows and Linux runners)
+class KeystoreRawChannel {
+  static const BasicMessageChannel<ByteData> _channel = BasicMessageChannel(
+    'com.pirate.wallet/keystore_raw',
+    BinaryCodec(),
+  );
+
+  static const int _opStore = 1;
+  static const int _opRetrieve = 2;
+  static const int _opRead = 3;
+  static const int _opCancel = 4;
+
+  static const int _statusOk = 0;
+  static const int _statusNotFound = 1;
+
+  static const int _flagFinal = 0x01;
+  static const int _headerBytes = 16;
+
+  /// Largest chunk either side sends in one message.
+  static const int chunkBytes = 256 * 1024;
+
+  /// Largest payload the runners accept.
+  static const int maxPayloadBytes = 64 * 1024 * 1024;
+
+  static int _nextTransferId = 1;
+
+  /// Whether the runner answers keystore_raw.
+  static bool get isSupported => Platform.isWindows || Platform.isLinux;
+
+  /// Store [payload] under [keyId], in chunks of [chunkBytes].
+  static Future<void> store(String keyId, Uint8List payload) async {
+    if (payload.length > maxPayloadBytes) {
+      throw KeystoreException('Keystore payload too large');
+    }
+    final keyIdBytes = Uint8List.fromList(utf8.encode(keyId));
+    final transferId = _takeTransferId();
+    var offset = 0;
+    do {
+      final end = offset + chunkBytes < payload.length
+          ? offset + chunkBytes
+          : payload.length;
+      final request = _request(
+        op: _opStore,
+        last: end == payload.length,
+        transferId: transferId,
+        totalLength: payload.length,
+        offset: offset,
+        keyId: keyIdBytes,
+        chunk: Uint8List.sublistView(payload, offset, end),
+      );
+      try {
+        final reply = await _send(request, transferId);
+        if (reply.status != _statusOk) {
+          throw KeystoreException('Failed to store key: ${reply.message}');
+        }
+      } catch (_) {
+        // Drop the chunks the runner already holds for this transfer.
+        await _cancel(transferId);
+        rethrow;
+      } finally {
+        _wipe(request);
+      }
+      offset = end;
+    } while (offset < payload.length);
+  }
+
+  /// Retrieve the payload stored under [keyId], or null if there is none.
+  /// Large payloads arrive in chunks written straight into the result.
+  static Future<Uint8List?> retrieve(String keyId) async {
+    final transferId = _takeTransferId();
+    final first = await _send(
+      _request(
+        op: _opRetrieve,
+        transferId: transferId,
+        keyId: Uint8List.fromList(utf8.encode(keyId)),
+      ),
+      transferId,
+    );
+    if (first.status == _statusNotFound) {
+      return null;
+    }
+    if (first.status != _statusOk) {
+      throw KeystoreException('Failed to retrieve key: ${first.message}');
+    }
+
+    final payload = Uint8List(first.totalLength);
+    payload.setRange(0, first.body.length, first.body);
+    var offset = first.body.length;
+    try {
+      while (offset < payload.length) {
+        final reply = await _send(
+          _request(op: _opRead, transferId: transferId, offset: offset),
+          transferId,
+        );
+        if (reply.status != _statusOk ||
+            reply.offset != offset ||
+            reply.body.isEmpty ||
+            offset + reply.body.length > payload.length) {
+          throw KeystoreException('Failed to retrieve key: ${reply.message}');
+        }
+        payload.setRange(offset, offset + reply.body.length, reply.body);
+        offset += reply.body.length;
+      }
+    } catch (_) {
+      _wipe(payload);
+      await _cancel(transferId);
+      rethrow;
+    }
+    return payload;
+  }
+
+  static int _takeTransferId() {
+    final id = _nextTransferId;
+    _nextTransferId = id == 0xFFFFFFFF ? 1 : id + 1;
+    return id;
+  }
+
+  static Future<void> _cancel(int transferId) async {
+    try {
+      await _channel.send(
+        ByteData.sublistView(_request(op: _opCancel, transferId: transferId)),
+      );
+    } on PlatformException {
+      // The runner drops abandoned transfers on its own when it exits.
+    }
+  }
+
+  static Uint8List _request({
+    required int op,
+    bool last = true,
+    required int transferId,
+    int totalLength = 0,
+    int offset = 0,
+    Uint8List? keyId,
+    Uint8List? chunk,
+  }) {
+    final keyIdLength = keyId?.length ?? 0;
+    final chunkLength = chunk?.length ?? 0;
+    final frame = Uint8List(_headerBytes + keyIdLength + chunkLength);
+    ByteData.sublistView(frame)
+      ..setUint8(0, op)
+      ..setUint8(1, last ? _flagFinal : 0)
+      ..setUint16(2, keyIdLength, Endian.little)
+      ..setUint32(4, transferId, Endian.little)
+      ..setUint32(8, totalLength, Endian.little)
+      ..setUint32(12, offset, Endian.little);
+    if (keyId != null) {
+      frame.setRange(_headerBytes, _headerBytes + keyIdLength, keyId);
+    }
+    if (chunk != null) {
+      frame.setRange(_headerBytes + keyIdLength, frame.length, chunk);
+    }
+    return frame;
+  }
+
+  static Future<_Reply> _send(Uint8List request, int transferId) async {
+    final ByteData? data;
+    try {
+      data = await _channel.send(ByteData.sublistView(request));
+    } on PlatformException catch (e) {
+      throw KeystoreException('Keystore channel failed: ${e.message}');
+    }
+    if (data == null || data.lengthInBytes < _headerBytes) {
+      throw KeystoreException('Malformed keystore reply');
+    }
+    final reply = _Reply(
+      status: data.getUint8(0),
+      transferId: data.getUint32(4, Endian.little),
+      totalLength: data.getUint32(8, Endian.little),
+      offset: data.getUint32(12, Endian.little),
+      body: Uint8List.sublistView(data, _headerBytes),
+    );
+    if (reply.transferId != transferId && reply.transferId != 0) {
+      throw KeystoreException('Keystore reply for another transfer');
+    }
+    return reply;
+  }
+
+  static void _wipe(Uint8List bytes) => bytes.fillRange(0, bytes.length, 0);
+}
+
+class _Reply {
+  final int status;
+  final int transferId;
+  final int totalLength;
+  final int offset;
+  final Uint8List body;
+
+  _Reply({
+    required this.status,
+    required this.transferId,
+    required this.totalLength,
+    required this.offset,
+    required this.body,
+  });
+
+  String get message => utf8.decode(body, allowMalformed: true);
+}
@@ -13,8 +13,12 @@ class PassphraseCache {
   static const _storage = FlutterSecureStorage();
   static const _key = 'app_passphrase_wrapped_v1';
   static const _fallbackFileName = 'app_passphrase_wrapped_v1.txt';
+  // How long desktop runners keep the unsealed passphrase after its last use.
+  static const _masterKeyCacheIdleTtl = Duration(minutes: 5);
+  static bool _masterKeyCacheConfigured = false;
 
   static Future<void> store(String passphrase) async {
+    await _configureMasterKeyCache();
     final sealed = await KeystoreChannel.sealMasterKey(utf8.encode(passphrase));
     final encoded = base64Encode(sealed);
     if (Platform.isMacOS) {
@@ -33,6 +37,7 @@ class PassphraseCache {
     if (encoded == null || encoded.isEmpty) {
       return null;
     }
+    await _configureMasterKeyCache();
     final sealed = base64Decode(encoded);
     final unsealed = await KeystoreChannel.unsealMasterKey(sealed);
     return utf8.decode(unsealed, allowMalformed: false);
@@ -44,14 +49,31 @@ class PassphraseCache {
   }
 
   static Future<void> clear() async {
+    // Drop the stored secret first so a cache failure cannot leave it behind.
     if (Platform.isMacOS) {
       await _deleteFallbackMarker();
       try {
         await _storage.delete(key: _key);
       } catch (_) {}
+    } else {
+      await _storage.delete(key: _key);
+    }
+    try {
+      await KeystoreChannel.clearMasterKeyCache();
+    } catch (_) {}
+  }
+
+  // The runners keep the cache disabled until told a TTL; configure it once.
+  static Future<void> _configureMasterKeyCache() async {
+    if (_masterKeyCacheConfigured) {
       return;
     }
-    await _storage.delete(key: _key);
+    try {
+      await KeystoreChannel.configureMasterKeyCache(
+        idleTtl: _masterKeyCacheIdleTtl,
+      );
+      _masterKeyCacheConfigured = true;
+    } catch (_) {}
   }
 
   static Future<String?> _readEncodedMarker() async {
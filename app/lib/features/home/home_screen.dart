@@ -211,7 +211,7 @@ class _HomeHeader extends ConsumerWidget {
 
     final balanceData = balanceAsync.when(
       data: (b) => b,
-      loading: () => null,
+      loading: () => ref.watch(warmWalletSnapshotProvider)?.balance,
       error: (_, _) => null,
     );
     final totalBalance = balanceData?.total ?? BigInt.zero;
@@ -442,7 +442,8 @@ class _HomeTransactionsSection extends ConsumerWidget {
 
     final transactions = transactionsAsync.when(
       data: (txs) => txs,
-      loading: () => <TxInfo>[],
+      loading: () =>
+          ref.watch(warmWalletSnapshotProvider)?.transactions ?? <TxInfo>[],
       error: (_, _) => <TxInfo>[],
     );
 
@@ -28,6 +28,7 @@ import '../../ui/molecules/watch_only_banner.dart';
 import '../../ui/organisms/p_app_bar.dart';
 import '../../ui/organisms/p_scaffold.dart';
 import '../../core/ffi/ffi_bridge.dart';
+import '../../core/ffi/prover_prewarm_native.dart';
 import '../../core/ffi/generated/models.dart' hide AddressBookEntryFfi;
 import '../../core/providers/wallet_providers.dart';
 import '../../core/providers/price_providers.dart';
@@ -192,7 +193,10 @@ enum SendStep {
 
 /// Send screen with multi-output support
 class SendScreen extends ConsumerStatefulWidget {
-  const SendScreen({super.key});
+  const SendScreen({super.key, this.paymentUri});
+
+  /// A `pirate:` payment URI to prefill the first recipient from.
+  final String? paymentUri;
 
   @override
   ConsumerState<SendScreen> createState() => _SendScreenState();
@@ -247,6 +251,14 @@ class _SendScreenState extends ConsumerState<SendScreen> {
   @override
   void initState() {
     super.initState();
+    // Load proving parameters while the user fills in the form.
+    prewarmNativeProver();
+    final paymentUri = widget.paymentUri;
+    if (paymentUri != null && paymentUri.isNotEmpty) {
+      _outputs.first.addressController.text = paymentUri;
+      _applyPiratePaymentRequest(0);
+      _outputs.first.syncFromControllers();
+    }
     _checkWatchOnlyStatus();
     _updateFeePreview();
     _loadFeeInfo();
@@ -6,6 +6,7 @@ import 'package:flutter_secure_storage/flutter_secure_storage.dart';
 import 'package:path_provider/path_provider.dart';
 
 import '../../../core/security/biometric_auth.dart';
+import '../../../core/security/fast_unlock.dart';
 import '../../../core/security/keystore_channel.dart';
 import '../../../core/security/passphrase_cache.dart';
 import '../../../core/ffi/generated/models.dart';
@@ -711,6 +712,7 @@ class BiometricsPreferenceNotifier extends Notifier<bool> {
 
 abstract class _SecureBoolPreferenceNotifier extends Notifier<bool> {
   late final FlutterSecureStorage _storage;
+  late final Future<void> _loaded;
 
   String get storageKey;
   bool get defaultValue;
@@ -718,7 +720,7 @@ abstract class _SecureBoolPreferenceNotifier extends Notifier<bool> {
   @override
   bool build() {
     _storage = const FlutterSecureStorage();
-    _load();
+    _loaded = _load();
     return defaultValue;
   }
 
@@ -818,6 +820,43 @@ class DebugLoggingPreferenceNotifier extends _SecureBoolPreferenceNotifier {
   }
 }
 
+/// Desktop: unlock with keys sealed by the OS keystore instead of re-running
+/// the passphrase KDF. See [FastUnlock] for the trade-off.
+class FastUnlockPreferenceNotifier extends _SecureBoolPreferenceNotifier {
+  @override
+  String get storageKey => 'desktop_fast_unlock_v1';
+
+  @override
+  bool get defaultValue => false;
+
+  Future<void> setEnabled({required bool enabled}) async {
+    await setValue(value: enabled);
+    await FastUnlock.configure(enabled: enabled);
+  }
+
+  /// Send the stored choice to the backend once it is loaded. Waits for the
+  /// preference to be read, so a default of false never deletes a bundle the
+  /// user opted into.
+  Future<void> applyToBackend() async {
+    await _loaded;
+    if (!ref.mounted) {
+      return;
+    }
+    await FastUnlock.configure(enabled: state);
+  }
+}
+
+/// Windows: closing the window hides it to the tray and sync keeps running.
+class CloseToTrayPreferenceNotifier extends _SecureBoolPreferenceNotifier {
+  @override
+  String get storageKey => 'desktop_close_to_tray_v1';
+
+  @override
+  bool get defaultValue => false;
+
+  Future<void> setEnabled({required bool enabled}) => setValue(value: enabled);
+}
+
 final appThemeModeProvider = NotifierProvider<ThemeModeNotifier, AppThemeMode>(
   ThemeModeNotifier.new,
 );
@@ -891,6 +930,16 @@ final debugLoggingProvider =
       DebugLoggingPreferenceNotifier.new,
     );
 
+final fastUnlockProvider =
+    NotifierProvider<FastUnlockPreferenceNotifier, bool>(
+      FastUnlockPreferenceNotifier.new,
+    );
+
+final closeToTrayProvider =
+    NotifierProvider<CloseToTrayPreferenceNotifier, bool>(
+      CloseToTrayPreferenceNotifier.new,
+    );
+
 final allowPriceApisProvider = Provider<bool>((ref) {
   final master = ref.watch(externalApiMasterProvider);
   final prices = ref.watch(externalPriceApiProvider);
@@ -14,6 +14,8 @@ import 'package:share_plus/share_plus.dart';
 import '../../design/deep_space_theme.dart';
 import '../../core/ffi/ffi_bridge.dart';
 import '../../core/crypto/mnemonic_language.dart';
+import '../../core/desktop/desktop_tray.dart';
+import '../../core/security/fast_unlock.dart';
 import '../../core/providers/wallet_providers.dart';
 import 'providers/preferences_providers.dart';
 import 'providers/transport_providers.dart';
@@ -100,6 +102,25 @@ class SettingsScreen extends ConsumerWidget {
               onTap: () => context.push('/settings/passphrase'),
               trailing: const Icon(Icons.chevron_right),
             ),
+            if (FastUnlock.isSupported)
+              Consumer(
+                builder: (context, ref, _) {
+                  final enabled = ref.watch(fastUnlockProvider);
+                  return PListTile(
+                    leading: const Icon(Icons.bolt_outlined),
+                    title: 'Fast unlock'.tr,
+                    subtitle:
+                        'Skip the slow key derivation for 7 days. Keys are protected by your computer account instead.'
+                            .tr,
+                    trailing: Switch(
+                      value: enabled,
+                      onChanged: (value) => ref
+                          .read(fastUnlockProvider.notifier)
+                          .setEnabled(enabled: value),
+                    ),
+                  );
+                },
+              ),
             PListTile(
               leading: Icon(Icons.emergency, color: AppColors.warning),
               title: 'Duress passphrase'.tr,
@@ -350,6 +371,25 @@ class SettingsScreen extends ConsumerWidget {
                 );
               },
             ),
+            if (DesktopTray.isSupported)
+              Consumer(
+                builder: (context, ref, _) {
+                  final enabled = ref.watch(closeToTrayProvider);
+                  return PListTile(
+                    leading: const Icon(Icons.minimize_outlined),
+                    title: 'Keep syncing in the notification area'.tr,
+                    subtitle:
+                        'Closing the window keeps the wallet syncing in the background'
+                            .tr,
+                    trailing: Switch(
+                      value: enabled,
+                      onChanged: (value) => ref
+                          .read(closeToTrayProvider.notifier)
+                          .setEnabled(enabled: value),
+                    ),
+                  );
+                },
+              ),
             Consumer(
               builder: (context, ref, _) {
                 final enabled = ref.watch(debugLoggingProvider);
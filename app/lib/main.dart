@@ -11,15 +11,20 @@ import 'package:window_manager/window_manager.dart';
 import 'core/background/background_sync_handler.dart';
 import 'core/background/background_sync_manager.dart';
 import 'core/desktop/adaptive_window.dart';
+import 'core/desktop/desktop_tray.dart';
 import 'core/ffi/ffi_bridge.dart';
+import 'core/ffi/runtime_config_native.dart';
 import 'core/ffi/generated/models.dart' show SyncMode;
 import 'core/desktop/single_instance.dart';
+import 'core/desktop/startup_timeline.dart';
+import 'core/desktop/warm_start.dart';
 import 'core/desktop/desktop_update_prompt_host.dart';
 import 'core/desktop/windows_version.dart';
 import 'core/i18n/arb_text_localizer.dart';
 import 'core/logging/debug_log_controller.dart';
 import 'core/logging/debug_log_writer.dart';
 import 'core/security/clipboard_manager.dart';
+import 'core/security/fast_unlock.dart';
 import 'core/swaps/swap_providers.dart';
 import 'design/theme.dart';
 import 'design/tokens/colors.dart';
@@ -27,6 +32,7 @@ import 'features/settings/providers/preferences_providers.dart';
 import 'features/settings/providers/transport_providers.dart';
 import 'routes/app_router.dart';
 import 'core/providers/rust_init_provider.dart';
+import 'core/providers/wallet_providers.dart' show appUnlockedProvider;
 import 'ui/molecules/p_overlay_toast.dart';
 
 SingleInstanceLock? _singleInstanceLock;
@@ -41,10 +47,14 @@ void main() async {
   _appInitialized = true;
 
   WidgetsFlutterBinding.ensureInitialized();
+  unawaited(StartupTimeline.mark('dart_main'));
   await DebugLogController.initialize();
   _installFlutterErrorLogging();
 
   final isTest = Platform.environment.containsKey('FLUTTER_TEST');
+  if (!isTest) {
+    await configureNativeRuntimeForHost();
+  }
 
   if (!isTest && (Platform.isWindows || Platform.isLinux || Platform.isMacOS)) {
     _singleInstanceLock = await SingleInstanceLock.acquire();
@@ -54,6 +64,12 @@ void main() async {
     }
   }
 
+  // The runner is unsealing last session's dashboard snapshot; ask for it
+  // now so it is in hand by the time the dashboard builds.
+  if (!isTest && WarmStart.isSupported) {
+    unawaited(WarmStart.snapshots());
+  }
+
   // Desktop window setup
   if (!isTest && (Platform.isWindows || Platform.isLinux || Platform.isMacOS)) {
     await windowManager.ensureInitialized();
@@ -75,8 +91,11 @@ void main() async {
       await windowManager.show();
       await windowManager.focus();
     });
+
+    unawaited(ForwardedLaunches.start());
   }
 
+  unawaited(StartupTimeline.mark('run_app'));
   runApp(const ProviderScope(child: PirateWalletApp()));
 }
 
@@ -171,6 +190,10 @@ class PirateWalletApp extends ConsumerStatefulWidget {
 class _PirateWalletAppState extends ConsumerState<PirateWalletApp>
     with WindowListener, WidgetsBindingObserver {
   bool _closing = false;
+  StreamSubscription<void>? _trayQuitSubscription;
+  StreamSubscription<List<String>>? _forwardedLaunchSubscription;
+  ProviderSubscription<bool>? _unlockSubscription;
+  String? _pendingPaymentUri;
   Color? _lastWindowBackground;
   ProviderSubscription<AsyncValue<void>>? _rustInitSubscription;
   String? _lastArbLocale;
@@ -205,12 +228,37 @@ class _PirateWalletAppState extends ConsumerState<PirateWalletApp>
         ..addListener(this)
         ..setPreventClose(true);
     }
+    if (DesktopTray.isSupported) {
+      // Loads the stored choice before the first close.
+      ref.read(closeToTrayProvider);
+      DesktopTray.start();
+      _trayQuitSubscription = DesktopTray.quitRequests.listen(
+        (_) => unawaited(_closeApp()),
+      );
+    }
+    if (ForwardedLaunches.isSupported) {
+      _forwardedLaunchSubscription = ForwardedLaunches.stream.listen(
+        (arguments) => unawaited(_onForwardedLaunch(arguments)),
+      );
+      // A link that arrives while locked opens once the wallet is unlocked.
+      _unlockSubscription = ref.listenManual<bool>(appUnlockedProvider, (
+        _,
+        unlocked,
+      ) {
+        if (unlocked) {
+          _openPendingPaymentUri();
+        }
+      });
+    }
 
     _rustInitSubscription = ref.listenManual<AsyncValue<void>>(
       rustInitProvider,
       (_, next) {
         if (next.hasValue) {
           unawaited(ref.read(transportConfigProvider.notifier).refresh());
+          if (FastUnlock.isSupported) {
+            unawaited(ref.read(fastUnlockProvider.notifier).applyToBackend());
+          }
         }
       },
       fireImmediately: true,
@@ -224,6 +272,9 @@ class _PirateWalletAppState extends ConsumerState<PirateWalletApp>
       windowManager.removeListener(this);
     }
     _rustInitSubscription?.close();
+    _unlockSubscription?.close();
+    unawaited(_trayQuitSubscription?.cancel());
+    unawaited(_forwardedLaunchSubscription?.cancel());
     final release = _singleInstanceLock?.release();
     if (release != null) {
       unawaited(release);
@@ -277,6 +328,34 @@ class _PirateWalletAppState extends ConsumerState<PirateWalletApp>
     }
   }
 
+  Future<void> _onForwardedLaunch(List<String> arguments) async {
+    await windowManager.show();
+    await windowManager.focus();
+    final uri = ForwardedLaunches.paymentUri(arguments);
+    if (uri == null) {
+      return;
+    }
+    _pendingPaymentUri = uri;
+    if (ref.read(appUnlockedProvider)) {
+      _openPendingPaymentUri();
+    } else {
+      debugPrint('Payment link held until the wallet is unlocked');
+    }
+  }
+
+  void _openPendingPaymentUri() {
+    final uri = _pendingPaymentUri;
+    if (uri == null || !mounted) {
+      return;
+    }
+    _pendingPaymentUri = null;
+    unawaited(
+      ref
+          .read(appRouterProvider)
+          .push<void>('/send?uri=${Uri.encodeComponent(uri)}'),
+    );
+  }
+
   @override
   void onWindowFocus() {
     FfiBridge.setAppActive(true);
@@ -305,6 +384,15 @@ class _PirateWalletAppState extends ConsumerState<PirateWalletApp>
 
   @override
   Future<void> onWindowClose() async {
+    if (_closing) return;
+    if (ref.read(closeToTrayProvider) && await DesktopTray.hideToTray()) {
+      FfiBridge.setAppActive(false);
+      return;
+    }
+    await _closeApp();
+  }
+
+  Future<void> _closeApp() async {
     if (_closing) return;
     _closing = true;
     FfiBridge.setAppActive(false);
@@ -337,7 +337,7 @@ final appRouterProvider = Provider<GoRouter>((ref) {
         pageBuilder: (context, state) => _buildPageWithTransition(
           context: context,
           state: state,
-          child: const SendScreen(),
+          child: SendScreen(paymentUri: state.uri.queryParameters['uri']),
         ),
       ),
 
@@ -0,0 +1,36 @@
+#include "headless_sync.h"
+
+#include <dlfcn.h>
+#include <stdio.h>
+#include <string.h>
+
+namespace {
+const char kHeadlessSyncFlag[] = "--headless-sync";
+const char kBackendLibrary[] = "libpirate_ffi_frb.so";
+}  // namespace
+
+bool headless_sync_requested(int argc, char** argv) {
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], kHeadlessSyncFlag) == 0) {
+      return true;
+    }
+  }
+  return false;
+}
+
+int headless_sync_run() {
+  void* backend = dlopen(kBackendLibrary, RTLD_NOW);
+  if (backend == nullptr) {
+    fprintf(stderr, "headless sync: %s\n", dlerror());
+    return 1;
+  }
+  // The backend reads its own options from the process arguments.
+  using HeadlessSyncMainFn = int (*)();
+  auto headless_main = reinterpret_cast<HeadlessSyncMainFn>(
+      dlsym(backend, "pirate_headless_sync_main"));
+  if (headless_main == nullptr) {
+    fprintf(stderr, "headless sync: backend has no headless mode\n");
+    return 1;
+  }
+  return headless_main();
+}
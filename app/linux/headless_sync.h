@@ -0,0 +1,15 @@
+#ifndef FLUTTER_HEADLESS_SYNC_H_
+#define FLUTTER_HEADLESS_SYNC_H_
+
+// `--headless-sync` runs the backend's sync daemon instead of the app: no GTK
+// window and no Flutter engine, just the wallet service keeping every
+// registered wallet synced and serving status on a local socket.
+
+// Returns true when |argv| asks for headless sync.
+bool headless_sync_requested(int argc, char** argv);
+
+// Loads the backend and runs the daemon until it is stopped. Returns the
+// process exit status.
+int headless_sync_run();
+
+#endif  // FLUTTER_HEADLESS_SYNC_H_
@@ -1,6 +1,14 @@
+#include "headless_sync.h"
 #include "my_application.h"
+#include "perf_timeline.h"
 
 int main(int argc, char** argv) {
+  // Before GTK: headless hosts have no display to open.
+  if (headless_sync_requested(argc, argv)) {
+    return headless_sync_run();
+  }
+
+  perf_mark("main");
   g_autoptr(MyApplication) app = my_application_new();
   return g_application_run(G_APPLICATION(app), argc, argv);
 }
@@ -6,30 +6,126 @@
 #ifdef GDK_WINDOWING_X11
 #include <gdk/gdkx.h>
 #endif
+#include <dlfcn.h>
+#include <malloc.h>
 #include <string.h>
+#include <sys/mman.h>
+#include <unistd.h>
 
 #include "flutter/generated_plugin_registrant.h"
+#include "perf_timeline.h"
+
+// The unsealed master key, kept so a re-unlock within the idle TTL skips the
+// Secret Service round trip. The bytes live in an mlock'ed anonymous mapping
+// that is excluded from core dumps and wiped with explicit_bzero on evict.
+// Disabled until Dart configures a non-zero TTL.
+struct MasterKeyCache {
+  guint8* data;
+  gsize length;
+  gsize mapped_length;
+  guint ttl_ms;
+  gint64 last_used_us;
+  guint sweep_source_id;
+  // Bumped by every clear so an unseal already in flight when the cache was
+  // cleared (seal, lock, sleep, TTL change) does not repopulate it.
+  guint generation;
+};
+
+// Host state forwarded to the backend so running syncs can throttle.
+struct SyncPowerState {
+  gboolean on_ac_power;
+  gboolean window_visible;
+  gboolean window_focused;
+  gboolean session_locked;
+  gboolean sleeping;
+};
 
 struct _MyApplication {
   GtkApplication parent_instance;
   char** dart_entrypoint_arguments;
   FlMethodChannel* keystore_channel;
+  FlBasicMessageChannel* keystore_raw_channel;
+  // Chunked keystore_raw transfers by transfer id, each a RawTransfer.
+  GHashTable* raw_transfers;
   FlMethodChannel* security_channel;
+  FlMethodChannel* perf_channel;
+  FlMethodChannel* instance_channel;
+  FlMethodChannel* warm_start_channel;
+  FlMethodChannel* fast_unlock_channel;
+  // The previous session's warm-start snapshot until Dart takes it.
+  GBytes* warm_snapshot;
+  gboolean warm_snapshot_loaded;
+  gboolean warm_snapshot_sink_installed;
+  // takeSnapshot calls that arrived before the load finished.
+  GPtrArray* pending_warm_snapshot_calls;
+  // The main window, cleared when it is destroyed.
+  GtkWidget* window;
+  // Launches forwarded from later processes before Dart listened, each an
+  // FlValue list of strings.
+  GPtrArray* pending_instance_arguments;
+  gboolean instance_channel_ready;
+  // Secret Service proxy shared by every keystore call once connected.
+  SecretService* secret_service;
+  // Keystore requests waiting for the proxy while it is being connected.
+  GPtrArray* pending_keystore_requests;
+  gboolean secret_service_connecting;
+  // Optional copy of the unsealed master key, wiped on idle, lock and sleep.
+  MasterKeyCache master_key_cache;
+  GDBusConnection* system_bus;
+  guint prepare_for_sleep_subscription;
+  guint session_lock_subscription;
+  guint session_unlock_subscription;
+  guint upower_subscription;
+  SyncPowerState sync_power;
+  GThread* prewarm_thread;
 };
 
 G_DEFINE_TYPE(MyApplication, my_application, GTK_TYPE_APPLICATION)
 
 namespace {
 const char kKeystoreChannelName[] = "com.pirate.wallet/keystore";
+const char kKeystoreRawChannelName[] = "com.pirate.wallet/keystore_raw";
 const char kSecurityChannelName[] = "com.pirate.wallet/security";
+const char kPerfChannelName[] = "com.pirate.wallet/perf";
+const char kInstanceChannelName[] = "com.pirate.wallet/instance";
+const char kWarmStartChannelName[] = "com.pirate.wallet/warm_start";
+// Keystore item holding the warm-start snapshot, stored as raw bytes.
+const char kWarmSnapshotKeyId[] = "pirate_warm_snapshot_v1";
+// The backend keeps snapshots to a few KiB; anything far larger is ignored.
+const gsize kMaxWarmSnapshotBytes = 256 * 1024;
+const char kFastUnlockChannelName[] = "com.pirate.wallet/fast_unlock";
+// Keystore item holding the fast-unlock bundle, stored as raw bytes.
+const char kFastUnlockKeyId[] = "pirate_fast_unlock_v1";
+// A bundle is two keys per wallet plus the registry's.
+const gsize kMaxFastUnlockBundleBytes = 64 * 1024;
+// When set, the startup trace is written here on shutdown.
+const char kStartupTraceEnv[] = "PIRATE_STARTUP_TRACE";
 const char kMasterKeyId[] = "pirate_wallet_master_key";
 const uint8_t kSealedMarker[] = {'l', 'i', 'n', 'u', 'x', '-', 'k', 'e', 'y',
                                  'c', 'h', 'a', 'i', 'n', '-', 'v', '1'};
+// Secrets written by keystore_raw are stored as bytes; the method channel
+// stores base64 text/plain. Lookups on either channel read both.
+const char kRawSecretContentType[] = "application/octet-stream";
+// keystore_raw framing, shared with the Windows runner's KeystoreStream and
+// keystore_raw_channel.dart: a 16-byte little-endian header, then the body.
+//   request: u8 op | u8 flags | u16 key_id_length | u32 transfer_id |
+//            u32 total_length | u32 offset | key_id | chunk
+//   reply:   u8 status | u8[3] 0 | u32 transfer_id | u32 total_length |
+//            u32 offset | chunk, or a UTF-8 message on kError
+const gsize kRawHeaderBytes = 16;
+const guint32 kRawChunkBytes = 256 * 1024;
+const guint32 kRawMaxPayloadBytes = 64 * 1024 * 1024;
+const guint8 kRawFlagFinal = 0x01;
+// Transfers in flight at once, bounding memory held for Dart.
+const guint kRawMaxTransfers = 4;
 const double kPreferredWindowWidth = 1180.0;
 const double kPreferredWindowHeight = 760.0;
 const double kVisibleMargin = 48.0;
 const double kMaxVisibleFraction = 0.92;
 
+const guint kMasterKeyCacheSweepSeconds = 1;
+const char kBackendLibrary[] = "libpirate_ffi_frb.so";
+
 struct DesktopWindowSize {
   int width;
   int height;
@@ -102,6 +198,141 @@ const SecretSchema kPirateKeystoreSchema = {
     {{"key_id", SECRET_SCHEMA_ATTRIBUTE_STRING},
      {nullptr, static_cast<SecretSchemaAttributeType>(0)}}};
 
+// Loads the Rust backend and warms it (registry and block cache pages) while
+// the Flutter engine starts, so Dart's first call lands on a hot backend. The
+// library stays loaded; Dart opens the same module by name.
+gpointer prewarm_backend_thread(gpointer data) {
+  const gint64 started = perf_now();
+  void* backend = dlopen(kBackendLibrary, RTLD_LAZY);
+  if (backend != nullptr) {
+    using PrewarmFn = void (*)();
+    auto prewarm =
+        reinterpret_cast<PrewarmFn>(dlsym(backend, "pirate_prewarm"));
+    if (prewarm != nullptr) {
+      prewarm();
+    }
+  }
+  perf_span("backend_prewarm", started);
+  return nullptr;
+}
+
+// Returns the startup trace with the backend's spans merged in. Never loads
+// the backend: reading the timeline must not change startup. Free with
+// g_free().
+gchar* startup_trace_json() {
+  g_autofree gchar* backend_events = nullptr;
+  void* backend = dlopen(kBackendLibrary, RTLD_LAZY | RTLD_NOLOAD);
+  if (backend != nullptr) {
+    using TraceEventsFn = const char* (*)();
+    auto trace_events = reinterpret_cast<TraceEventsFn>(
+        dlsym(backend, "pirate_perf_trace_events_json"));
+    const char* json = trace_events != nullptr ? trace_events() : nullptr;
+    backend_events = g_strdup(json);
+    dlclose(backend);
+  }
+  return perf_trace_json(backend_events);
+}
+
+bool write_startup_trace(const gchar* path) {
+  g_autofree gchar* json = startup_trace_json();
+  g_autoptr(GError) error = nullptr;
+  if (!g_file_set_contents(path, json, -1, &error)) {
+    g_warning("Failed to write startup trace: %s", error->message);
+    return false;
+  }
+  return true;
+}
+
+// Hands the current power and window state to the backend. Never loads it;
+// the first frame re-sends the state once Dart has opened the library.
+void forward_sync_power_state(const SyncPowerState& state) {
+  void* backend = dlopen(kBackendLibrary, RTLD_LAZY | RTLD_NOLOAD);
+  if (backend == nullptr) {
+    return;
+  }
+  using SetSyncPowerStateFn = void (*)(guint8, guint8, guint8, guint8);
+  auto set_state = reinterpret_cast<SetSyncPowerStateFn>(
+      dlsym(backend, "pirate_set_sync_power_state"));
+  if (set_state != nullptr) {
+    set_state(state.on_ac_power ? 1 : 0, state.window_visible ? 1 : 0,
+              state.window_focused ? 1 : 0,
+              state.session_locked || state.sleeping ? 1 : 0);
+  }
+  dlclose(backend);
+}
+
+void warm_snapshot_install_sink(MyApplication* self);
+
+void on_first_frame(FlView* view, gpointer user_data) {
+  perf_mark("first_frame");
+  forward_sync_power_state(MY_APPLICATION(user_data)->sync_power);
+  warm_snapshot_install_sink(MY_APPLICATION(user_data));
+}
+
+gboolean on_window_state_event(GtkWidget* widget,
+                               GdkEventWindowState* event,
+                               gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  const gboolean visible =
+      (event->new_window_state &
+       (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) == 0;
+  if (visible != self->sync_power.window_visible) {
+    self->sync_power.window_visible = visible;
+    forward_sync_power_state(self->sync_power);
+  }
+  return FALSE;
+}
+
+void on_window_active_changed(GObject* object,
+                              GParamSpec* pspec,
+                              gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  self->sync_power.window_focused = gtk_window_is_active(GTK_WINDOW(object));
+  forward_sync_power_state(self->sync_power);
+}
+
+void set_on_battery(MyApplication* self, gboolean on_battery) {
+  if (self->sync_power.on_ac_power == !on_battery) {
+    return;
+  }
+  self->sync_power.on_ac_power = !on_battery;
+  forward_sync_power_state(self->sync_power);
+}
+
+void on_upower_properties_changed(GDBusConnection* connection,
+                                  const gchar* sender_name,
+                                  const gchar* object_path,
+                                  const gchar* interface_name,
+                                  const gchar* signal_name,
+                                  GVariant* parameters,
+                                  gpointer user_data) {
+  const gchar* changed_interface = nullptr;
+  g_autoptr(GVariant) changed = nullptr;
+  g_variant_get(parameters, "(&s@a{sv}@as)", &changed_interface, &changed,
+                nullptr);
+  gboolean on_battery = FALSE;
+  if (g_variant_lookup(changed, "OnBattery", "b", &on_battery)) {
+    set_on_battery(MY_APPLICATION(user_data), on_battery);
+  }
+}
+
+void on_upower_on_battery_ready(GObject* source,
+                                GAsyncResult* result,
+                                gpointer data) {
+  MyApplication* self = MY_APPLICATION(data);
+  g_autoptr(GVariant) reply = g_dbus_connection_call_finish(
+      G_DBUS_CONNECTION(source), result, nullptr);
+  // No UPower (desktops, containers): stay on AC.
+  if (reply != nullptr) {
+    g_autoptr(GVariant) value = nullptr;
+    g_variant_get(reply, "(v)", &value);
+    if (g_variant_is_of_type(value, G_VARIANT_TYPE_BOOLEAN)) {
+      set_on_battery(self, g_variant_get_boolean(value));
+    }
+  }
+  g_object_unref(self);
+}
+
 FlMethodResponse* error_response(const char* code, const char* message) {
   return FL_METHOD_RESPONSE(fl_method_error_response_new(code, message, nullptr));
 }
@@ -129,79 +360,1254 @@ bool extract_bytes_arg(FlValue* args,
   return true;
 }
 
-bool store_secret(const gchar* key_id,
-                  const uint8_t* data,
-                  size_t length,
-                  const char* label,
-                  gchar** error_message) {
-  GError* error = nullptr;
-  g_autofree gchar* encoded =
-      g_base64_encode(reinterpret_cast<const guchar*>(data), length);
-  gboolean stored = secret_password_store_sync(
-      &kPirateKeystoreSchema, SECRET_COLLECTION_DEFAULT, label, encoded,
-      nullptr, &error, "key_id", key_id, nullptr);
-  if (!stored) {
-    if (error_message) {
-      *error_message =
-          error ? g_strdup(error->message) : g_strdup("Failed to store secret");
-    }
-    if (error) {
-      g_error_free(error);
+void master_key_cache_clear(MasterKeyCache* cache) {
+  if (cache->data != nullptr) {
+    explicit_bzero(cache->data, cache->mapped_length);
+    munlock(cache->data, cache->mapped_length);
+    munmap(cache->data, cache->mapped_length);
+  }
+  cache->data = nullptr;
+  cache->length = 0;
+  cache->mapped_length = 0;
+  cache->generation++;
+  if (cache->sweep_source_id != 0) {
+    g_source_remove(cache->sweep_source_id);
+    cache->sweep_source_id = 0;
+  }
+}
+
+bool master_key_cache_expired(const MasterKeyCache* cache) {
+  return cache->ttl_ms == 0 ||
+         g_get_monotonic_time() - cache->last_used_us >
+             static_cast<gint64>(cache->ttl_ms) * G_TIME_SPAN_MILLISECOND;
+}
+
+gboolean on_master_key_cache_sweep(gpointer data) {
+  MasterKeyCache* cache = static_cast<MasterKeyCache*>(data);
+  if (!master_key_cache_expired(cache)) {
+    return G_SOURCE_CONTINUE;
+  }
+  // Returning G_SOURCE_REMOVE drops the source; forget its id first so clear
+  // does not remove it twice.
+  cache->sweep_source_id = 0;
+  master_key_cache_clear(cache);
+  return G_SOURCE_REMOVE;
+}
+
+void master_key_cache_put(MasterKeyCache* cache,
+                          const guint8* data,
+                          gsize length) {
+  master_key_cache_clear(cache);
+  if (cache->ttl_ms == 0 || length == 0) {
+    return;
+  }
+  const gsize page = static_cast<gsize>(sysconf(_SC_PAGESIZE));
+  const gsize mapped_length = (length + page - 1) / page * page;
+  void* memory = mmap(nullptr, mapped_length, PROT_READ | PROT_WRITE,
+                      MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+  if (memory == MAP_FAILED) {
+    return;
+  }
+  if (mlock(memory, mapped_length) != 0) {
+    // Refuse to cache a key that could be swapped out.
+    munmap(memory, mapped_length);
+    return;
+  }
+#ifdef MADV_DONTDUMP
+  madvise(memory, mapped_length, MADV_DONTDUMP);
+#endif
+  cache->data = static_cast<guint8*>(memory);
+  cache->length = length;
+  cache->mapped_length = mapped_length;
+  memcpy(cache->data, data, length);
+  cache->last_used_us = g_get_monotonic_time();
+  cache->sweep_source_id = g_timeout_add_seconds(
+      kMasterKeyCacheSweepSeconds, on_master_key_cache_sweep, cache);
+}
+
+// Returns the cached key and restarts the idle timer, or nullptr on a miss.
+FlValue* master_key_cache_get(MasterKeyCache* cache) {
+  if (cache->data == nullptr) {
+    return nullptr;
+  }
+  if (master_key_cache_expired(cache)) {
+    master_key_cache_clear(cache);
+    return nullptr;
+  }
+  cache->last_used_us = g_get_monotonic_time();
+  return fl_value_new_uint8_list(cache->data, cache->length);
+}
+
+void on_session_state_signal(GDBusConnection* connection,
+                             const gchar* sender_name,
+                             const gchar* object_path,
+                             const gchar* interface_name,
+                             const gchar* signal_name,
+                             GVariant* parameters,
+                             gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  if (g_strcmp0(signal_name, "PrepareForSleep") == 0) {
+    gboolean going_to_sleep = FALSE;
+    g_variant_get(parameters, "(b)", &going_to_sleep);
+    self->sync_power.sleeping = going_to_sleep;
+    forward_sync_power_state(self->sync_power);
+    if (!going_to_sleep) {
+      return;
     }
+  } else if (g_strcmp0(signal_name, "Unlock") == 0) {
+    self->sync_power.session_locked = FALSE;
+    forward_sync_power_state(self->sync_power);
+    return;
+  } else {
+    self->sync_power.session_locked = TRUE;
+    forward_sync_power_state(self->sync_power);
+  }
+  master_key_cache_clear(&self->master_key_cache);
+}
+
+void on_system_bus_ready(GObject* source, GAsyncResult* result, gpointer data) {
+  MyApplication* self = MY_APPLICATION(data);
+  g_autoptr(GError) error = nullptr;
+  GDBusConnection* bus = g_bus_get_finish(result, &error);
+  if (bus == nullptr) {
+    g_warning("Session lock, sleep and power changes are not tracked: %s",
+              error->message);
+  } else {
+    self->system_bus = bus;
+    self->prepare_for_sleep_subscription = g_dbus_connection_signal_subscribe(
+        bus, "org.freedesktop.login1", "org.freedesktop.login1.Manager",
+        "PrepareForSleep", "/org/freedesktop/login1", nullptr,
+        G_DBUS_SIGNAL_FLAGS_NONE, on_session_state_signal, self, nullptr);
+    // Any session lock clears the cache; matching only our own session path
+    // would need a blocking GetSession call first.
+    self->session_lock_subscription = g_dbus_connection_signal_subscribe(
+        bus, "org.freedesktop.login1", "org.freedesktop.login1.Session", "Lock",
+        nullptr, nullptr, G_DBUS_SIGNAL_FLAGS_NONE, on_session_state_signal,
+        self, nullptr);
+    self->session_unlock_subscription = g_dbus_connection_signal_subscribe(
+        bus, "org.freedesktop.login1", "org.freedesktop.login1.Session",
+        "Unlock", nullptr, nullptr, G_DBUS_SIGNAL_FLAGS_NONE,
+        on_session_state_signal, self, nullptr);
+    self->upower_subscription = g_dbus_connection_signal_subscribe(
+        bus, "org.freedesktop.UPower", "org.freedesktop.DBus.Properties",
+        "PropertiesChanged", "/org/freedesktop/UPower",
+        "org.freedesktop.UPower", G_DBUS_SIGNAL_FLAGS_NONE,
+        on_upower_properties_changed, self, nullptr);
+    g_dbus_connection_call(
+        bus, "org.freedesktop.UPower", "/org/freedesktop/UPower",
+        "org.freedesktop.DBus.Properties", "Get",
+        g_variant_new("(ss)", "org.freedesktop.UPower", "OnBattery"),
+        G_VARIANT_TYPE("(v)"), G_DBUS_CALL_FLAGS_NONE, -1, nullptr,
+        on_upower_on_battery_ready, g_object_ref(self));
+  }
+  g_object_unref(self);
+}
+
+// Copies a list of strings out of |args|. Returns false unless every element
+// is a string.
+bool extract_string_list_arg(FlValue* args, const char* key, GPtrArray** out) {
+  FlValue* value = fl_value_lookup_string(args, key);
+  if (value == nullptr || fl_value_get_type(value) != FL_VALUE_TYPE_LIST) {
     return false;
   }
+  g_autoptr(GPtrArray) list = g_ptr_array_new_with_free_func(g_free);
+  for (size_t i = 0; i < fl_value_get_length(value); ++i) {
+    FlValue* item = fl_value_get_list_value(value, i);
+    if (fl_value_get_type(item) != FL_VALUE_TYPE_STRING) {
+      return false;
+    }
+    g_ptr_array_add(list, g_strdup(fl_value_get_string(item)));
+  }
+  *out = static_cast<GPtrArray*>(g_steal_pointer(&list));
   return true;
 }
 
-FlMethodResponse* handle_retrieve_secret(const gchar* key_id) {
-  GError* error = nullptr;
-  gchar* encoded = secret_password_lookup_sync(&kPirateKeystoreSchema, nullptr,
-                                               &error, "key_id", key_id, nullptr);
-  if (encoded == nullptr) {
-    if (error) {
-      g_autofree gchar* message = g_strdup(error->message);
-      g_error_free(error);
-      return error_response("KEYSTORE_ERROR", message);
+enum class KeystoreOp {
+  kStore,
+  kRetrieve,
+  kDelete,
+  kExists,
+  // Bulk variants over |key_ids|.
+  kStoreMany,
+  kRetrieveMany,
+  kExistsMany,
+  // keystore_raw store of |raw_value| and retrieve.
+  kRawStore,
+  kRawRetrieve,
+  // Warm-start snapshot load, store of |raw_value| and delete. These have no
+  // caller waiting on a response.
+  kWarmSnapshotLoad,
+  kWarmSnapshotStore,
+  kWarmSnapshotClear,
+  // The same for the fast-unlock bundle.
+  kFastUnlockLoad,
+  kFastUnlockStore,
+  kFastUnlockClear,
+};
+
+enum class RawOp : guint8 {
+  kStore = 1,
+  kRetrieve = 2,
+  kRead = 3,
+  kCancel = 4,
+};
+
+enum class RawStatus : guint8 {
+  kOk = 0,
+  kNotFound = 1,
+  kError = 2,
+};
+
+// A parsed keystore_raw request; |chunk| points into the message.
+struct RawRequest {
+  RawOp op;
+  gboolean final;
+  guint32 transfer_id;
+  guint32 total_length;
+  guint32 offset;
+  gchar* key_id;
+  const guint8* chunk;
+  gsize chunk_length;
+};
+
+// A chunked keystore_raw transfer: a store being received into |upload|, or
+// a retrieved secret being read out of |download|.
+struct RawTransfer {
+  gchar* key_id;
+  guint32 total_length;
+  GByteArray* upload;
+  GBytes* download;
+};
+
+// One keystore call in flight, from the method channel or keystore_raw.
+// libsecret's async API completes on the main loop, where the deferred
+// response is sent.
+struct KeystoreRequest {
+  MyApplication* app;
+  FlMethodCall* method_call;
+  // keystore_raw requests answer through |raw_response| instead.
+  FlBasicMessageChannelResponseHandle* raw_response;
+  guint32 transfer_id;
+  SecretValue* raw_value;
+  KeystoreOp op;
+  gchar* key_id;
+  // Base64 payload for kStore, matching what secret_password_store wrote.
+  gchar* encoded;
+  const char* label;
+  const char* error_code;
+  // sealMasterKey answers with kSealedMarker instead of `true`.
+  bool respond_with_marker;
+  // unsealMasterKey keeps the retrieved key in the master key cache, unless
+  // the cache was cleared after |cache_generation| was taken.
+  bool cache_result;
+  guint cache_generation;
+  // Bulk ops: the requested keyIds and, for kStoreMany, their base64 payloads
+  // at the same index.
+  GPtrArray* key_ids;
+  GPtrArray* encoded_values;
+  // Bulk ops: calls still in flight and the first one that failed.
+  guint pending;
+  GError* first_error;
+  // kRetrieveMany/kExistsMany: the keyId map answered once all finish.
+  FlValue* bulk_values;
+  // kWarmSnapshotLoad: when the load started, for the startup trace.
+  gint64 started_us;
+};
+
+KeystoreRequest* keystore_request_new(MyApplication* app,
+                                      FlMethodCall* method_call,
+                                      KeystoreOp op,
+                                      const gchar* key_id) {
+  KeystoreRequest* request = g_new0(KeystoreRequest, 1);
+  request->app = MY_APPLICATION(g_object_ref(app));
+  request->method_call =
+      method_call != nullptr ? FL_METHOD_CALL(g_object_ref(method_call))
+                             : nullptr;
+  request->op = op;
+  request->key_id = g_strdup(key_id);
+  request->error_code = "KEYSTORE_ERROR";
+  return request;
+}
+
+void keystore_request_free(gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_object_unref(request->app);
+  g_clear_object(&request->method_call);
+  g_clear_object(&request->raw_response);
+  g_clear_pointer(&request->raw_value, secret_value_unref);
+  g_free(request->key_id);
+  g_free(request->encoded);
+  g_clear_pointer(&request->key_ids, g_ptr_array_unref);
+  g_clear_pointer(&request->bulk_values, fl_value_unref);
+  g_clear_pointer(&request->encoded_values, g_ptr_array_unref);
+  g_clear_error(&request->first_error);
+  g_free(request);
+}
+
+void keystore_request_respond(KeystoreRequest* request,
+                              FlMethodResponse* response) {
+  fl_method_call_respond(request->method_call, response, nullptr);
+  keystore_request_free(request);
+}
+
+guint32 read_u32(const guint8* bytes) {
+  return static_cast<guint32>(bytes[0]) |
+         (static_cast<guint32>(bytes[1]) << 8) |
+         (static_cast<guint32>(bytes[2]) << 16) |
+         (static_cast<guint32>(bytes[3]) << 24);
+}
+
+void write_u32(guint8* bytes, guint32 value) {
+  bytes[0] = static_cast<guint8>(value);
+  bytes[1] = static_cast<guint8>(value >> 8);
+  bytes[2] = static_cast<guint8>(value >> 16);
+  bytes[3] = static_cast<guint8>(value >> 24);
+}
+
+// Returns false if |message| is too short or its lengths do not add up. On
+// success the caller owns |request->key_id|.
+bool raw_request_parse(FlValue* message, RawRequest* request) {
+  if (message == nullptr ||
+      fl_value_get_type(message) != FL_VALUE_TYPE_UINT8_LIST) {
+    return false;
+  }
+  const guint8* bytes = fl_value_get_uint8_list(message);
+  const gsize size = fl_value_get_length(message);
+  if (size < kRawHeaderBytes || bytes[0] < static_cast<guint8>(RawOp::kStore) ||
+      bytes[0] > static_cast<guint8>(RawOp::kCancel)) {
+    return false;
+  }
+  const gsize key_id_length = bytes[2] | (bytes[3] << 8);
+  if (key_id_length > size - kRawHeaderBytes) {
+    return false;
+  }
+  request->op = static_cast<RawOp>(bytes[0]);
+  request->final = (bytes[1] & kRawFlagFinal) != 0;
+  request->transfer_id = read_u32(bytes + 4);
+  request->total_length = read_u32(bytes + 8);
+  request->offset = read_u32(bytes + 12);
+  request->key_id = g_strndup(
+      reinterpret_cast<const gchar*>(bytes + kRawHeaderBytes), key_id_length);
+  request->chunk = bytes + kRawHeaderBytes + key_id_length;
+  request->chunk_length = size - kRawHeaderBytes - key_id_length;
+  return true;
+}
+
+// The frame is built once and copied into the reply; the copy is wiped.
+FlValue* raw_reply_new(RawStatus status,
+                       guint32 transfer_id,
+                       guint32 total_length,
+                       guint32 offset,
+                       const guint8* data,
+                       gsize length) {
+  const gsize frame_length = kRawHeaderBytes + length;
+  guint8* frame = static_cast<guint8*>(g_malloc0(frame_length));
+  frame[0] = static_cast<guint8>(status);
+  write_u32(frame + 4, transfer_id);
+  write_u32(frame + 8, total_length);
+  write_u32(frame + 12, offset);
+  if (length > 0) {
+    memcpy(frame + kRawHeaderBytes, data, length);
+  }
+  FlValue* reply = fl_value_new_uint8_list(frame, frame_length);
+  explicit_bzero(frame, frame_length);
+  g_free(frame);
+  return reply;
+}
+
+FlValue* raw_error_new(guint32 transfer_id, const gchar* message) {
+  return raw_reply_new(RawStatus::kError, transfer_id, 0, 0,
+                       reinterpret_cast<const guint8*>(message),
+                       strlen(message));
+}
+
+void raw_respond(FlBasicMessageChannel* channel,
+                 FlBasicMessageChannelResponseHandle* response_handle,
+                 FlValue* reply) {
+  g_autoptr(FlValue) owned_reply = reply;
+  g_autoptr(GError) error = nullptr;
+  if (channel != nullptr &&
+      !fl_basic_message_channel_respond(channel, response_handle, owned_reply,
+                                        &error)) {
+    g_warning("Failed to answer keystore_raw: %s", error->message);
+  }
+}
+
+void raw_transfer_free(gpointer data) {
+  RawTransfer* transfer = static_cast<RawTransfer*>(data);
+  if (transfer->upload != nullptr) {
+    explicit_bzero(transfer->upload->data, transfer->upload->len);
+    g_byte_array_unref(transfer->upload);
+  }
+  g_clear_pointer(&transfer->download, g_bytes_unref);
+  g_free(transfer->key_id);
+  g_free(transfer);
+}
+
+// Appends a store chunk in place. When |request| is the final chunk, hands
+// the whole payload to |payload| and forgets the transfer.
+bool raw_upload_append(MyApplication* self,
+                       const RawRequest* request,
+                       GByteArray** payload,
+                       const gchar** error) {
+  gpointer key = GUINT_TO_POINTER(request->transfer_id);
+  RawTransfer* transfer =
+      static_cast<RawTransfer*>(g_hash_table_lookup(self->raw_transfers, key));
+  if (request->offset == 0) {
+    // A first chunk restarts the transfer.
+    g_hash_table_remove(self->raw_transfers, key);
+    if (request->total_length > kRawMaxPayloadBytes) {
+      *error = "Keystore payload too large";
+      return false;
     }
-    return FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    if (g_hash_table_size(self->raw_transfers) >= kRawMaxTransfers) {
+      *error = "Too many keystore transfers";
+      return false;
+    }
+    transfer = g_new0(RawTransfer, 1);
+    transfer->key_id = g_strdup(request->key_id);
+    transfer->total_length = request->total_length;
+    transfer->upload = g_byte_array_sized_new(request->total_length);
+    g_hash_table_insert(self->raw_transfers, key, transfer);
+  } else if (transfer == nullptr || transfer->upload == nullptr) {
+    *error = "Unknown keystore transfer";
+    return false;
+  }
+
+  const guint received = transfer->upload->len;
+  if (request->offset != received ||
+      request->total_length != transfer->total_length ||
+      g_strcmp0(request->key_id, transfer->key_id) != 0 ||
+      request->chunk_length > transfer->total_length - received) {
+    g_hash_table_remove(self->raw_transfers, key);
+    *error = "Keystore chunk out of order";
+    return false;
+  }
+  g_byte_array_append(transfer->upload, request->chunk,
+                      request->chunk_length);
+  if (!request->final) {
+    return true;
   }
+  if (transfer->upload->len != transfer->total_length) {
+    g_hash_table_remove(self->raw_transfers, key);
+    *error = "Keystore payload incomplete";
+    return false;
+  }
+  *payload = g_steal_pointer(&transfer->upload);
+  g_hash_table_remove(self->raw_transfers, key);
+  return true;
+}
+
+// Reply with the chunk at |offset| of a retrieved secret. The transfer is
+// dropped after its last chunk.
+FlValue* raw_download_read(MyApplication* self,
+                           guint32 transfer_id,
+                           guint32 offset) {
+  gpointer key = GUINT_TO_POINTER(transfer_id);
+  RawTransfer* transfer =
+      static_cast<RawTransfer*>(g_hash_table_lookup(self->raw_transfers, key));
+  if (transfer == nullptr || transfer->download == nullptr) {
+    return raw_error_new(transfer_id, "Unknown keystore transfer");
+  }
+  if (offset >= transfer->total_length) {
+    g_hash_table_remove(self->raw_transfers, key);
+    return raw_error_new(transfer_id, "Keystore read past end");
+  }
+  const guint32 length = MIN(kRawChunkBytes, transfer->total_length - offset);
+  const guint8* data =
+      static_cast<const guint8*>(g_bytes_get_data(transfer->download, nullptr));
+  FlValue* reply = raw_reply_new(RawStatus::kOk, transfer_id,
+                                 transfer->total_length, offset,
+                                 data + offset, length);
+  if (offset + length == transfer->total_length) {
+    g_hash_table_remove(self->raw_transfers, key);
+  }
+  return reply;
+}
+
+// SecretValue destroy notify: libsecret only hands back the pointer, so the
+// whole allocation is wiped before it is released.
+void raw_secret_free(gpointer data) {
+  if (data != nullptr) {
+    explicit_bzero(data, malloc_usable_size(data));
+  }
+  g_free(data);
+}
+
+void raw_wipe_free(gpointer data) {
+  GBytes* bytes = static_cast<GBytes*>(data);
+  gsize length = 0;
+  gpointer buffer = const_cast<gpointer>(g_bytes_get_data(bytes, &length));
+  explicit_bzero(buffer, length);
+  g_bytes_unref(bytes);
+}
+
+// Payload of |secret| without copying where possible: keystore_raw secrets
+// are the bytes themselves, method channel secrets are base64 decoded.
+GBytes* secret_payload(SecretValue* secret) {
+  if (g_strcmp0(secret_value_get_content_type(secret),
+                kRawSecretContentType) == 0) {
+    gsize length = 0;
+    const gchar* bytes = secret_value_get(secret, &length);
+    return g_bytes_new_with_free_func(
+        bytes, length, reinterpret_cast<GDestroyNotify>(secret_value_unref),
+        secret_value_ref(secret));
+  }
+  const gchar* encoded = secret_value_get_text(secret);
   gsize decoded_length = 0;
-  g_autofree guchar* decoded = g_base64_decode(encoded, &decoded_length);
-  secret_password_free(encoded);
+  guchar* decoded = g_base64_decode(encoded ? encoded : "", &decoded_length);
+  GBytes* decoded_bytes = g_bytes_new_take(decoded, decoded_length);
+  // Wiped by raw_wipe_free when the last reference goes.
+  return g_bytes_new_with_free_func(decoded, decoded_length, raw_wipe_free,
+                                    decoded_bytes);
+}
+
+// Answers takeSnapshot with the loaded snapshot, then drops it: one reader
+// per launch, later calls get null.
+void warm_snapshot_respond(MyApplication* self, FlMethodCall* method_call) {
+  g_autoptr(FlValue) value = nullptr;
+  if (self->warm_snapshot != nullptr) {
+    gsize length = 0;
+    const guint8* bytes = static_cast<const guint8*>(
+        g_bytes_get_data(self->warm_snapshot, &length));
+    value = fl_value_new_uint8_list(bytes, length);
+    g_clear_pointer(&self->warm_snapshot, g_bytes_unref);
+  } else {
+    value = fl_value_new_null();
+  }
+  g_autoptr(FlMethodResponse) response =
+      FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+// Keeps |snapshot| (may be null) and answers takeSnapshot calls that were
+// waiting for it.
+void warm_snapshot_loaded(MyApplication* self, GBytes* snapshot) {
+  g_clear_pointer(&self->warm_snapshot, g_bytes_unref);
+  self->warm_snapshot = snapshot;
+  self->warm_snapshot_loaded = TRUE;
+  g_autoptr(GPtrArray) pending = self->pending_warm_snapshot_calls;
+  self->pending_warm_snapshot_calls =
+      g_ptr_array_new_with_free_func(g_object_unref);
+  for (guint i = 0; i < pending->len; ++i) {
+    warm_snapshot_respond(
+        self, FL_METHOD_CALL(g_ptr_array_index(pending, i)));
+  }
+}
+
+// Fast-unlock bundle unsealed at startup until the backend takes it; guarded
+// because the backend asks for it from its own threads.
+// |fast_unlock_pending| is set while the lookup is still running.
+G_LOCK_DEFINE_STATIC(fast_unlock_bundle);
+GBytes* fast_unlock_bundle = nullptr;
+gboolean fast_unlock_pending = FALSE;
+
+// Size the fast-unlock load hook reports while the bundle is still being
+// unsealed (FAST_UNLOCK_LOAD_PENDING in the backend).
+constexpr gsize kFastUnlockLoadPending = G_MAXSIZE;
+
+// Ends the startup lookup, keeping |bundle| (may be null; takes ownership).
+void fast_unlock_loaded(GBytes* bundle) {
+  G_LOCK(fast_unlock_bundle);
+  fast_unlock_pending = FALSE;
+  if (bundle != nullptr) {
+    g_clear_pointer(&fast_unlock_bundle, g_bytes_unref);
+    fast_unlock_bundle = bundle;
+  }
+  G_UNLOCK(fast_unlock_bundle);
+}
+
+void keystore_request_respond_raw(KeystoreRequest* request, FlValue* reply) {
+  raw_respond(request->app->keystore_raw_channel, request->raw_response,
+              reply);
+  keystore_request_free(request);
+}
+
+void keystore_request_fail(KeystoreRequest* request, GError* error) {
+  // A dropped D-Bus connection invalidates the cached proxy; the next call
+  // reconnects instead of failing forever.
+  if (error->domain == G_DBUS_ERROR || error->domain == G_IO_ERROR) {
+    g_clear_object(&request->app->secret_service);
+  }
+  if (request->raw_response != nullptr) {
+    keystore_request_respond_raw(
+        request, raw_error_new(request->transfer_id, error->message));
+    return;
+  }
+  if (request->op == KeystoreOp::kWarmSnapshotLoad) {
+    // A cold first paint; Dart falls back to the real queries.
+    warm_snapshot_loaded(request->app, nullptr);
+    keystore_request_free(request);
+    return;
+  }
+  if (request->op == KeystoreOp::kFastUnlockLoad) {
+    // The backend then runs the full KDF.
+    fast_unlock_loaded(nullptr);
+  }
+  if (request->method_call == nullptr) {
+    g_debug("Keystore item %s not updated: %s", request->key_id,
+            error->message);
+    keystore_request_free(request);
+    return;
+  }
+  g_autoptr(FlMethodResponse) response =
+      error_response(request->error_code, error->message);
+  keystore_request_respond(request, response);
+}
+
+GHashTable* keystore_attributes(const gchar* key_id) {
+  return secret_attributes_build(&kPirateKeystoreSchema, "key_id", key_id,
+                                 nullptr);
+}
+
+void on_secret_stored(GObject* source, GAsyncResult* result, gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  if (!secret_service_store_finish(SECRET_SERVICE(source), result, &error)) {
+    keystore_request_fail(request, error);
+    return;
+  }
   g_autoptr(FlValue) value =
-      fl_value_new_uint8_list(decoded, decoded_length);
-  return FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+      request->respond_with_marker
+          ? fl_value_new_uint8_list(kSealedMarker, sizeof(kSealedMarker))
+          : fl_value_new_bool(true);
+  g_autoptr(FlMethodResponse) response =
+      FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+  keystore_request_respond(request, response);
+}
+
+void on_secret_looked_up(GObject* source, GAsyncResult* result, gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  SecretValue* secret =
+      secret_service_lookup_finish(SECRET_SERVICE(source), result, &error);
+  if (error != nullptr) {
+    keystore_request_fail(request, error);
+    return;
+  }
+
+  g_autoptr(FlValue) value = nullptr;
+  if (request->op == KeystoreOp::kExists) {
+    value = fl_value_new_bool(secret != nullptr);
+  } else if (secret != nullptr) {
+    g_autoptr(GBytes) payload = secret_payload(secret);
+    gsize length = 0;
+    const guint8* bytes =
+        static_cast<const guint8*>(g_bytes_get_data(payload, &length));
+    value = fl_value_new_uint8_list(bytes, length);
+    if (request->cache_result &&
+        request->cache_generation ==
+            request->app->master_key_cache.generation) {
+      master_key_cache_put(&request->app->master_key_cache, bytes, length);
+    }
+  }
+  if (secret != nullptr) {
+    secret_value_unref(secret);
+  }
+  g_autoptr(FlMethodResponse) response =
+      FL_METHOD_RESPONSE(fl_method_success_response_new(value));
+  keystore_request_respond(request, response);
 }
 
-FlMethodResponse* handle_delete_secret(const gchar* key_id) {
-  GError* error = nullptr;
-  gboolean cleared = secret_password_clear_sync(&kPirateKeystoreSchema, nullptr,
-                                                &error, "key_id", key_id,
-                                                nullptr);
+void on_secret_cleared(GObject* source, GAsyncResult* result, gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  gboolean cleared =
+      secret_service_clear_finish(SECRET_SERVICE(source), result, &error);
   if (!cleared && error != nullptr) {
-    g_autofree gchar* message = g_strdup(error->message);
-    g_error_free(error);
-    return error_response("KEYSTORE_ERROR", message);
+    keystore_request_fail(request, error);
+    return;
+  }
+  g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(
+      fl_method_success_response_new(fl_value_new_bool(true)));
+  keystore_request_respond(request, response);
+}
+
+void on_secret_stored_many(GObject* source,
+                           GAsyncResult* result,
+                           gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  if (!secret_service_store_finish(SECRET_SERVICE(source), result, &error) &&
+      request->first_error == nullptr) {
+    request->first_error = g_steal_pointer(&error);
+  }
+  if (--request->pending != 0) {
+    return;
+  }
+  if (request->first_error != nullptr) {
+    g_autoptr(GError) first_error = g_steal_pointer(&request->first_error);
+    keystore_request_fail(request, first_error);
+    return;
   }
-  return FL_METHOD_RESPONSE(
+  g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(
       fl_method_success_response_new(fl_value_new_bool(true)));
+  keystore_request_respond(request, response);
+}
+
+// One keyId of a kRetrieveMany/kExistsMany request.
+struct KeystoreBulkLookup {
+  KeystoreRequest* request;
+  guint index;
+};
+
+void on_secret_found_for_key(GObject* source,
+                             GAsyncResult* result,
+                             gpointer data) {
+  KeystoreBulkLookup* lookup = static_cast<KeystoreBulkLookup*>(data);
+  KeystoreRequest* request = lookup->request;
+  const gchar* key_id = static_cast<const gchar*>(
+      g_ptr_array_index(request->key_ids, lookup->index));
+  g_free(lookup);
+
+  g_autoptr(GError) error = nullptr;
+  GList* items =
+      secret_service_search_finish(SECRET_SERVICE(source), result, &error);
+  if (error != nullptr) {
+    if (request->first_error == nullptr) {
+      request->first_error = g_steal_pointer(&error);
+    }
+  } else if (items != nullptr) {
+    if (request->op == KeystoreOp::kExistsMany) {
+      fl_value_set_string_take(request->bulk_values, key_id,
+                               fl_value_new_bool(true));
+    } else if (SecretValue* secret =
+                   secret_item_get_secret(SECRET_ITEM(items->data))) {
+      g_autoptr(GBytes) payload = secret_payload(secret);
+      gsize length = 0;
+      const guint8* bytes =
+          static_cast<const guint8*>(g_bytes_get_data(payload, &length));
+      fl_value_set_string_take(request->bulk_values, key_id,
+                               fl_value_new_uint8_list(bytes, length));
+      secret_value_unref(secret);
+    }
+  }
+  g_list_free_full(items, g_object_unref);
+
+  if (--request->pending != 0) {
+    return;
+  }
+  if (request->first_error != nullptr) {
+    g_autoptr(GError) first_error = g_steal_pointer(&request->first_error);
+    keystore_request_fail(request, first_error);
+    return;
+  }
+  g_autoptr(FlMethodResponse) response = FL_METHOD_RESPONSE(
+      fl_method_success_response_new(request->bulk_values));
+  keystore_request_respond(request, response);
+}
+
+void on_raw_secret_stored(GObject* source, GAsyncResult* result, gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  if (!secret_service_store_finish(SECRET_SERVICE(source), result, &error)) {
+    keystore_request_fail(request, error);
+    return;
+  }
+  keystore_request_respond_raw(
+      request,
+      raw_reply_new(RawStatus::kOk, request->transfer_id, 0, 0, nullptr, 0));
+}
+
+// Answers with the whole secret, or with its first chunk and keeps it for
+// kRead.
+void on_raw_secret_looked_up(GObject* source,
+                             GAsyncResult* result,
+                             gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  MyApplication* self = request->app;
+  const guint32 transfer_id = request->transfer_id;
+  g_autoptr(GError) error = nullptr;
+  SecretValue* secret =
+      secret_service_lookup_finish(SECRET_SERVICE(source), result, &error);
+  if (error != nullptr) {
+    keystore_request_fail(request, error);
+    return;
+  }
+  if (secret == nullptr) {
+    keystore_request_respond_raw(
+        request,
+        raw_reply_new(RawStatus::kNotFound, transfer_id, 0, 0, nullptr, 0));
+    return;
+  }
+  GBytes* payload = secret_payload(secret);
+  secret_value_unref(secret);
+  gsize length = 0;
+  const guint8* bytes =
+      static_cast<const guint8*>(g_bytes_get_data(payload, &length));
+  FlValue* reply = nullptr;
+  if (length > kRawMaxPayloadBytes) {
+    reply = raw_error_new(transfer_id, "Keystore payload too large");
+  } else if (length <= kRawChunkBytes) {
+    reply = raw_reply_new(RawStatus::kOk, transfer_id, length, 0, bytes,
+                          length);
+  } else if (self->raw_transfers == nullptr ||
+             g_hash_table_size(self->raw_transfers) >= kRawMaxTransfers ||
+             g_hash_table_contains(self->raw_transfers,
+                                   GUINT_TO_POINTER(transfer_id))) {
+    reply = raw_error_new(transfer_id, "Too many keystore transfers");
+  } else {
+    reply = raw_reply_new(RawStatus::kOk, transfer_id, length, 0, bytes,
+                          kRawChunkBytes);
+    RawTransfer* transfer = g_new0(RawTransfer, 1);
+    transfer->key_id = g_strdup(request->key_id);
+    transfer->total_length = length;
+    transfer->download = g_steal_pointer(&payload);
+    g_hash_table_insert(self->raw_transfers, GUINT_TO_POINTER(transfer_id),
+                        transfer);
+  }
+  g_clear_pointer(&payload, g_bytes_unref);
+  keystore_request_respond_raw(request, reply);
+}
+
+// The snapshot unsealed at startup until the backend reads it back to seed
+// its own copy; guarded because the backend asks from its own threads.
+G_LOCK_DEFINE_STATIC(warm_snapshot_seed);
+GBytes* warm_snapshot_seed = nullptr;
+
+void on_warm_snapshot_looked_up(GObject* source,
+                                GAsyncResult* result,
+                                gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  SecretValue* secret =
+      secret_service_lookup_finish(SECRET_SERVICE(source), result, &error);
+  if (error != nullptr) {
+    keystore_request_fail(request, error);
+    return;
+  }
+  GBytes* payload = nullptr;
+  if (secret != nullptr) {
+    payload = secret_payload(secret);
+    secret_value_unref(secret);
+  }
+  perf_span("warm_snapshot_load", request->started_us);
+  if (payload != nullptr) {
+    G_LOCK(warm_snapshot_seed);
+    g_clear_pointer(&warm_snapshot_seed, g_bytes_unref);
+    warm_snapshot_seed = g_bytes_ref(payload);
+    G_UNLOCK(warm_snapshot_seed);
+  }
+  warm_snapshot_loaded(request->app, payload);
+  keystore_request_free(request);
+}
+
+void on_fast_unlock_looked_up(GObject* source,
+                              GAsyncResult* result,
+                              gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  SecretValue* secret =
+      secret_service_lookup_finish(SECRET_SERVICE(source), result, &error);
+  if (error != nullptr) {
+    keystore_request_fail(request, error);
+    return;
+  }
+  GBytes* payload = nullptr;
+  if (secret != nullptr) {
+    payload = secret_payload(secret);
+    secret_value_unref(secret);
+  }
+  fast_unlock_loaded(payload);
+  keystore_request_free(request);
+}
+
+// Completes the runner's own stores and deletes (warm-start snapshot,
+// fast-unlock bundle), which no caller waits on.
+void on_unattended_secret_saved(GObject* source,
+                                GAsyncResult* result,
+                                gpointer data) {
+  KeystoreRequest* request = static_cast<KeystoreRequest*>(data);
+  g_autoptr(GError) error = nullptr;
+  const gboolean ok =
+      request->op == KeystoreOp::kWarmSnapshotClear ||
+              request->op == KeystoreOp::kFastUnlockClear
+          ? secret_service_clear_finish(SECRET_SERVICE(source), result, &error)
+          : secret_service_store_finish(SECRET_SERVICE(source), result,
+                                        &error);
+  // Clearing an item that was never stored is not an error.
+  if (!ok && error != nullptr) {
+    keystore_request_fail(request, error);
+    return;
+  }
+  keystore_request_free(request);
+}
+
+void keystore_request_run(KeystoreRequest* request) {
+  SecretService* service = request->app->secret_service;
+  if (request->op == KeystoreOp::kStoreMany) {
+    request->pending = request->key_ids->len;
+    for (guint i = 0; i < request->key_ids->len; ++i) {
+      const gchar* key_id =
+          static_cast<const gchar*>(g_ptr_array_index(request->key_ids, i));
+      g_autoptr(GHashTable) attributes = keystore_attributes(key_id);
+      SecretValue* value = secret_value_new(
+          static_cast<const gchar*>(
+              g_ptr_array_index(request->encoded_values, i)),
+          -1, "text/plain");
+      secret_service_store(service, &kPirateKeystoreSchema, attributes,
+                           SECRET_COLLECTION_DEFAULT, request->label, value,
+                           nullptr, on_secret_stored_many, request);
+      secret_value_unref(value);
+    }
+    return;
+  }
+  if (request->op == KeystoreOp::kRetrieveMany ||
+      request->op == KeystoreOp::kExistsMany) {
+    // Secret Service can only AND attributes, so each keyId is its own
+    // search on the shared proxy; only the requested items are unlocked and
+    // loaded. Every keyId gets an entry, even if its search finds nothing.
+    const bool exists_only = request->op == KeystoreOp::kExistsMany;
+    const int flags =
+        exists_only ? SECRET_SEARCH_NONE
+                    : SECRET_SEARCH_UNLOCK | SECRET_SEARCH_LOAD_SECRETS;
+    request->bulk_values = fl_value_new_map();
+    request->pending = request->key_ids->len;
+    for (guint i = 0; i < request->key_ids->len; ++i) {
+      const gchar* key_id =
+          static_cast<const gchar*>(g_ptr_array_index(request->key_ids, i));
+      fl_value_set_string_take(request->bulk_values, key_id,
+                               exists_only ? fl_value_new_bool(false)
+                                           : fl_value_new_null());
+    }
+    for (guint i = 0; i < request->key_ids->len; ++i) {
+      g_autoptr(GHashTable) attributes = keystore_attributes(
+          static_cast<const gchar*>(g_ptr_array_index(request->key_ids, i)));
+      KeystoreBulkLookup* lookup = g_new0(KeystoreBulkLookup, 1);
+      lookup->request = request;
+      lookup->index = i;
+      secret_service_search(service, &kPirateKeystoreSchema, attributes,
+                            static_cast<SecretSearchFlags>(flags), nullptr,
+                            on_secret_found_for_key, lookup);
+    }
+    return;
+  }
+
+  g_autoptr(GHashTable) attributes = keystore_attributes(request->key_id);
+  switch (request->op) {
+    case KeystoreOp::kStore: {
+      SecretValue* value = secret_value_new(request->encoded, -1, "text/plain");
+      secret_service_store(service, &kPirateKeystoreSchema, attributes,
+                           SECRET_COLLECTION_DEFAULT, request->label, value,
+                           nullptr, on_secret_stored, request);
+      secret_value_unref(value);
+      break;
+    }
+    case KeystoreOp::kRetrieve:
+    case KeystoreOp::kExists:
+      secret_service_lookup(service, &kPirateKeystoreSchema, attributes,
+                            nullptr, on_secret_looked_up, request);
+      break;
+    case KeystoreOp::kDelete:
+      secret_service_clear(service, &kPirateKeystoreSchema, attributes,
+                           nullptr, on_secret_cleared, request);
+      break;
+    case KeystoreOp::kRawStore:
+      secret_service_store(service, &kPirateKeystoreSchema, attributes,
+                           SECRET_COLLECTION_DEFAULT, request->label,
+                           request->raw_value, nullptr, on_raw_secret_stored,
+                           request);
+      break;
+    case KeystoreOp::kRawRetrieve:
+      secret_service_lookup(service, &kPirateKeystoreSchema, attributes,
+                            nullptr, on_raw_secret_looked_up, request);
+      break;
+    case KeystoreOp::kWarmSnapshotLoad:
+      secret_service_lookup(service, &kPirateKeystoreSchema, attributes,
+                            nullptr, on_warm_snapshot_looked_up, request);
+      break;
+    case KeystoreOp::kFastUnlockLoad:
+      secret_service_lookup(service, &kPirateKeystoreSchema, attributes,
+                            nullptr, on_fast_unlock_looked_up, request);
+      break;
+    case KeystoreOp::kWarmSnapshotStore:
+    case KeystoreOp::kFastUnlockStore:
+      secret_service_store(service, &kPirateKeystoreSchema, attributes,
+                           SECRET_COLLECTION_DEFAULT, request->label,
+                           request->raw_value, nullptr,
+                           on_unattended_secret_saved, request);
+      break;
+    case KeystoreOp::kWarmSnapshotClear:
+    case KeystoreOp::kFastUnlockClear:
+      secret_service_clear(service, &kPirateKeystoreSchema, attributes,
+                           nullptr, on_unattended_secret_saved, request);
+      break;
+    default:
+      break;
+  }
+}
+
+void on_secret_service_ready(GObject* source,
+                             GAsyncResult* result,
+                             gpointer data) {
+  MyApplication* self = MY_APPLICATION(data);
+  g_autoptr(GError) error = nullptr;
+  self->secret_service = secret_service_get_finish(result, &error);
+  self->secret_service_connecting = FALSE;
+
+  g_autoptr(GPtrArray) pending = self->pending_keystore_requests;
+  self->pending_keystore_requests = g_ptr_array_new();
+  for (guint i = 0; i < pending->len; ++i) {
+    KeystoreRequest* request =
+        static_cast<KeystoreRequest*>(g_ptr_array_index(pending, i));
+    if (self->secret_service == nullptr) {
+      keystore_request_fail(request, error);
+    } else {
+      keystore_request_run(request);
+    }
+  }
+  g_object_unref(self);
+}
+
+// Runs |request| on the cached Secret Service proxy, connecting it first if
+// needed. Never blocks the main loop.
+void keystore_request_start(KeystoreRequest* request) {
+  MyApplication* self = request->app;
+  if (self->secret_service != nullptr) {
+    keystore_request_run(request);
+    return;
+  }
+  g_ptr_array_add(self->pending_keystore_requests, request);
+  if (!self->secret_service_connecting) {
+    self->secret_service_connecting = TRUE;
+    secret_service_get(SECRET_SERVICE_OPEN_SESSION, nullptr,
+                       on_secret_service_ready, g_object_ref(self));
+  }
+}
+
+// Application that receives the backend's warm-start snapshots; guarded by
+// warm_snapshot_app because the sink runs on backend threads.
+G_LOCK_DEFINE_STATIC(warm_snapshot_app);
+MyApplication* warm_snapshot_app = nullptr;
+
+// Starts unsealing the previous session's snapshot while the engine boots,
+// so takeSnapshot can answer before the wallet database is open. Connecting
+// the Secret Service proxy here also takes it off the unlock path.
+void warm_snapshot_load(MyApplication* self) {
+  KeystoreRequest* request = keystore_request_new(
+      self, nullptr, KeystoreOp::kWarmSnapshotLoad, kWarmSnapshotKeyId);
+  request->started_us = perf_now();
+  keystore_request_start(request);
+}
+
+// Stores |payload| (consumed) as raw bytes under |key_id| with |store_op|,
+// or deletes the item with |clear_op| when it is empty.
+void unattended_secret_save(MyApplication* self,
+                            GBytes* payload,
+                            const char* key_id,
+                            const char* label,
+                            KeystoreOp store_op,
+                            KeystoreOp clear_op) {
+  const gsize length = g_bytes_get_size(payload);
+  KeystoreRequest* request = keystore_request_new(
+      self, nullptr, length == 0 ? clear_op : store_op, key_id);
+  if (length > 0) {
+    // The SecretValue takes the copied buffer as is.
+    gsize data_length = 0;
+    gchar* bytes =
+        static_cast<gchar*>(g_bytes_unref_to_data(payload, &data_length));
+    request->raw_value = secret_value_new_full(
+        bytes, data_length, kRawSecretContentType, raw_secret_free);
+    request->label = label;
+  } else {
+    g_bytes_unref(payload);
+  }
+  keystore_request_start(request);
 }
 
-FlMethodResponse* handle_key_exists(const gchar* key_id) {
-  GError* error = nullptr;
-  gchar* encoded = secret_password_lookup_sync(&kPirateKeystoreSchema, nullptr,
-                                               &error, "key_id", key_id, nullptr);
-  if (error) {
-    g_autofree gchar* message = g_strdup(error->message);
-    g_error_free(error);
-    return error_response("KEYSTORE_ERROR", message);
+// Runs on the main loop with a snapshot from the backend: stores it, or
+// deletes the stored one when it is empty.
+gboolean warm_snapshot_save(gpointer data) {
+  GBytes* document = static_cast<GBytes*>(data);
+  MyApplication* self = nullptr;
+  G_LOCK(warm_snapshot_app);
+  if (warm_snapshot_app != nullptr) {
+    self = MY_APPLICATION(g_object_ref(warm_snapshot_app));
   }
-  bool exists = encoded != nullptr;
-  if (encoded) {
-    secret_password_free(encoded);
+  G_UNLOCK(warm_snapshot_app);
+  if (self == nullptr) {
+    g_bytes_unref(document);
+    return G_SOURCE_REMOVE;
+  }
+  unattended_secret_save(self, document, kWarmSnapshotKeyId,
+                         "Pirate Wallet Snapshot",
+                         KeystoreOp::kWarmSnapshotStore,
+                         KeystoreOp::kWarmSnapshotClear);
+  g_object_unref(self);
+  return G_SOURCE_REMOVE;
+}
+
+// The backend's warm-start sink. Called on a backend thread; the bytes are
+// only valid during the call.
+void on_warm_snapshot(const guint8* data, gsize length) {
+  if (length > kMaxWarmSnapshotBytes) {
+    return;
+  }
+  g_main_context_invoke(nullptr, warm_snapshot_save,
+                        g_bytes_new(data, data != nullptr ? length : 0));
+}
+
+// The backend's warm-start load hook: reports the snapshot size for a null
+// |buffer|, otherwise copies it out once.
+gsize on_warm_snapshot_load(guint8* buffer, gsize capacity) {
+  G_LOCK(warm_snapshot_seed);
+  gsize length = warm_snapshot_seed != nullptr
+                     ? g_bytes_get_size(warm_snapshot_seed)
+                     : 0;
+  if (buffer != nullptr && capacity > 0) {
+    if (capacity < length) {
+      length = 0;
+    } else if (length > 0) {
+      memcpy(buffer, g_bytes_get_data(warm_snapshot_seed, nullptr), length);
+      g_clear_pointer(&warm_snapshot_seed, g_bytes_unref);
+    }
+  }
+  G_UNLOCK(warm_snapshot_seed);
+  return length;
+}
+
+// Registers on_warm_snapshot with the backend once Dart has loaded it.
+void warm_snapshot_install_sink(MyApplication* self) {
+  if (self->warm_snapshot_sink_installed) {
+    return;
+  }
+  void* backend = dlopen(kBackendLibrary, RTLD_LAZY | RTLD_NOLOAD);
+  if (backend == nullptr) {
+    return;
+  }
+  using StoreFn = void (*)(const guint8*, gsize);
+  using LoadFn = gsize (*)(guint8*, gsize);
+  using SetHostFn = void (*)(StoreFn, LoadFn);
+  auto set_host = reinterpret_cast<SetHostFn>(
+      dlsym(backend, "pirate_set_warm_snapshot_host"));
+  if (set_host != nullptr) {
+    G_LOCK(warm_snapshot_app);
+    warm_snapshot_app = self;
+    G_UNLOCK(warm_snapshot_app);
+    set_host(on_warm_snapshot, on_warm_snapshot_load);
+    self->warm_snapshot_sink_installed = TRUE;
+  }
+  dlclose(backend);
+}
+
+// Application that seals fast-unlock bundles while the preference is on;
+// guarded because the store hook runs on backend threads.
+G_LOCK_DEFINE_STATIC(fast_unlock_app);
+MyApplication* fast_unlock_app = nullptr;
+
+// Starts unsealing the bundle of derived database keys from the last session,
+// so the backend can skip the passphrase KDF if Dart turns fast unlock on.
+void fast_unlock_load(MyApplication* self) {
+  G_LOCK(fast_unlock_bundle);
+  fast_unlock_pending = TRUE;
+  G_UNLOCK(fast_unlock_bundle);
+  keystore_request_start(keystore_request_new(
+      self, nullptr, KeystoreOp::kFastUnlockLoad, kFastUnlockKeyId));
+}
+
+void fast_unlock_forget_bundle() {
+  G_LOCK(fast_unlock_bundle);
+  g_clear_pointer(&fast_unlock_bundle, g_bytes_unref);
+  G_UNLOCK(fast_unlock_bundle);
+}
+
+// Runs on the main loop with a bundle from the backend.
+gboolean fast_unlock_save(gpointer data) {
+  GBytes* bundle = static_cast<GBytes*>(data);
+  MyApplication* self = nullptr;
+  G_LOCK(fast_unlock_app);
+  if (fast_unlock_app != nullptr) {
+    self = MY_APPLICATION(g_object_ref(fast_unlock_app));
+  }
+  G_UNLOCK(fast_unlock_app);
+  if (self == nullptr) {
+    raw_wipe_free(bundle);
+    return G_SOURCE_REMOVE;
+  }
+  unattended_secret_save(self, bundle, kFastUnlockKeyId, "Pirate Wallet Key",
+                         KeystoreOp::kFastUnlockStore,
+                         KeystoreOp::kFastUnlockClear);
+  g_object_unref(self);
+  return G_SOURCE_REMOVE;
+}
+
+// The backend's fast-unlock store hook. Called on a backend thread; the
+// bytes are only valid during the call.
+void on_fast_unlock_store(const guint8* data, gsize length) {
+  if (length > kMaxFastUnlockBundleBytes) {
+    return;
+  }
+  g_main_context_invoke(nullptr, fast_unlock_save,
+                        g_bytes_new(data, data != nullptr ? length : 0));
+}
+
+// The backend's fast-unlock load hook: reports the bundle size for a null
+// |buffer| (or kFastUnlockLoadPending while the lookup runs), otherwise
+// copies the bundle out once and wipes it.
+gsize on_fast_unlock_load(guint8* buffer, gsize capacity) {
+  G_LOCK(fast_unlock_bundle);
+  gsize length = fast_unlock_bundle != nullptr
+                     ? g_bytes_get_size(fast_unlock_bundle)
+                     : 0;
+  if (buffer == nullptr || capacity == 0) {
+    if (fast_unlock_pending) {
+      length = kFastUnlockLoadPending;
+    }
+  } else if (capacity < length) {
+    length = 0;
+  } else if (length > 0) {
+    memcpy(buffer, g_bytes_get_data(fast_unlock_bundle, nullptr), length);
+    g_clear_pointer(&fast_unlock_bundle, g_bytes_unref);
+  }
+  G_UNLOCK(fast_unlock_bundle);
+  return length;
+}
+
+// Applies the preference sent by Dart: installs the backend hooks and
+// policy, or removes them and deletes the stored bundle.
+void fast_unlock_configure(MyApplication* self,
+                           gboolean enabled,
+                           guint64 max_age_seconds) {
+  using StoreFn = void (*)(const guint8*, gsize);
+  using LoadFn = gsize (*)(guint8*, gsize);
+  using SetHostFn = void (*)(StoreFn, LoadFn);
+  using SetPolicyFn = void (*)(guint8, guint64);
+  void* backend = dlopen(kBackendLibrary, RTLD_LAZY | RTLD_NOLOAD);
+  SetHostFn set_host = nullptr;
+  SetPolicyFn set_policy = nullptr;
+  if (backend != nullptr) {
+    set_host = reinterpret_cast<SetHostFn>(
+        dlsym(backend, "pirate_set_fast_unlock_host"));
+    set_policy = reinterpret_cast<SetPolicyFn>(
+        dlsym(backend, "pirate_set_fast_unlock_policy"));
+  }
+  if (enabled && set_host != nullptr && set_policy != nullptr) {
+    G_LOCK(fast_unlock_app);
+    fast_unlock_app = self;
+    G_UNLOCK(fast_unlock_app);
+    set_host(on_fast_unlock_store, on_fast_unlock_load);
+    set_policy(1, max_age_seconds);
+  } else {
+    if (set_policy != nullptr) {
+      set_policy(0, 0);
+    }
+    if (set_host != nullptr) {
+      set_host(nullptr, nullptr);
+    }
+    G_LOCK(fast_unlock_app);
+    if (fast_unlock_app == self) {
+      fast_unlock_app = nullptr;
+    }
+    G_UNLOCK(fast_unlock_app);
+    fast_unlock_forget_bundle();
+    if (!enabled) {
+      keystore_request_start(keystore_request_new(
+          self, nullptr, KeystoreOp::kFastUnlockClear, kFastUnlockKeyId));
+    }
+  }
+  if (backend != nullptr) {
+    dlclose(backend);
   }
-  return FL_METHOD_RESPONSE(
-      fl_method_success_response_new(fl_value_new_bool(exists)));
 }
 
 FlMethodResponse* handle_get_capabilities() {
@@ -218,6 +1624,7 @@ FlMethodResponse* handle_get_capabilities() {
 static void keystore_method_call_handler(FlMethodChannel* channel,
                                          FlMethodCall* method_call,
                                          gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
   const gchar* method = fl_method_call_get_name(method_call);
   FlValue* args = fl_method_call_get_args(method_call);
 
@@ -225,8 +1632,27 @@ static void keystore_method_call_handler(FlMethodChannel* channel,
 
   if (strcmp(method, "getCapabilities") == 0) {
     response = handle_get_capabilities();
+  } else if (strcmp(method, "clearMasterKeyCache") == 0) {
+    master_key_cache_clear(&self->master_key_cache);
+    response = FL_METHOD_RESPONSE(
+        fl_method_success_response_new(fl_value_new_bool(true)));
   } else if (args == nullptr || fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
     response = error_response("INVALID_ARGUMENT", "Arguments missing");
+  } else if (strcmp(method, "configureMasterKeyCache") == 0) {
+    FlValue* ttl = fl_value_lookup_string(args, "idleTtlMs");
+    if (ttl == nullptr || fl_value_get_type(ttl) != FL_VALUE_TYPE_INT ||
+        fl_value_get_int(ttl) < 0) {
+      response = error_response("INVALID_ARGUMENT", "idleTtlMs required");
+    } else {
+      MasterKeyCache* cache = &self->master_key_cache;
+      cache->ttl_ms = static_cast<guint>(
+          MIN(fl_value_get_int(ttl), static_cast<int64_t>(G_MAXUINT)));
+      if (cache->ttl_ms == 0) {
+        master_key_cache_clear(cache);
+      }
+      response = FL_METHOD_RESPONSE(
+          fl_method_success_response_new(fl_value_new_bool(true)));
+    }
   } else if (strcmp(method, "storeKey") == 0) {
     const gchar* key_id = nullptr;
     const uint8_t* data = nullptr;
@@ -236,37 +1662,80 @@ static void keystore_method_call_handler(FlMethodChannel* channel,
       response = error_response("INVALID_ARGUMENT",
                                 "keyId and encryptedKey required");
     } else {
-      g_autofree gchar* error_message = nullptr;
-      if (!store_secret(key_id, data, length, "Pirate Wallet Key",
-                        &error_message)) {
-        response = error_response("KEYSTORE_ERROR",
-                                  error_message ? error_message
-                                                : "Failed to store key");
-      } else {
-        response = FL_METHOD_RESPONSE(
-            fl_method_success_response_new(fl_value_new_bool(true)));
+      KeystoreRequest* request =
+          keystore_request_new(self, method_call, KeystoreOp::kStore, key_id);
+      request->encoded =
+          g_base64_encode(reinterpret_cast<const guchar*>(data), length);
+      request->label = "Pirate Wallet Key";
+      keystore_request_start(request);
+      return;
+    }
+  } else if (strcmp(method, "storeKeys") == 0) {
+    FlValue* keys = fl_value_lookup_string(args, "keys");
+    g_autoptr(GPtrArray) key_ids = g_ptr_array_new_with_free_func(g_free);
+    g_autoptr(GPtrArray) encoded = g_ptr_array_new_with_free_func(g_free);
+    bool valid = keys != nullptr && fl_value_get_type(keys) == FL_VALUE_TYPE_MAP;
+    for (size_t i = 0; valid && i < fl_value_get_length(keys); ++i) {
+      FlValue* key = fl_value_get_map_key(keys, i);
+      FlValue* data = fl_value_get_map_value(keys, i);
+      if (fl_value_get_type(key) != FL_VALUE_TYPE_STRING ||
+          fl_value_get_type(data) != FL_VALUE_TYPE_UINT8_LIST) {
+        valid = false;
+        continue;
       }
+      g_ptr_array_add(key_ids, g_strdup(fl_value_get_string(key)));
+      g_ptr_array_add(encoded,
+                      g_base64_encode(fl_value_get_uint8_list(data),
+                                      fl_value_get_length(data)));
     }
-  } else if (strcmp(method, "retrieveKey") == 0) {
-    const gchar* key_id = nullptr;
-    if (!extract_string_arg(args, "keyId", &key_id)) {
-      response = error_response("INVALID_ARGUMENT", "keyId required");
+    if (!valid) {
+      response = error_response("INVALID_ARGUMENT",
+                                "keys must map keyId to encryptedKey");
+    } else if (key_ids->len == 0) {
+      response = FL_METHOD_RESPONSE(
+          fl_method_success_response_new(fl_value_new_bool(true)));
     } else {
-      response = handle_retrieve_secret(key_id);
+      KeystoreRequest* request = keystore_request_new(
+          self, method_call, KeystoreOp::kStoreMany, nullptr);
+      request->key_ids = static_cast<GPtrArray*>(g_steal_pointer(&key_ids));
+      request->encoded_values =
+          static_cast<GPtrArray*>(g_steal_pointer(&encoded));
+      request->label = "Pirate Wallet Key";
+      keystore_request_start(request);
+      return;
     }
-  } else if (strcmp(method, "deleteKey") == 0) {
-    const gchar* key_id = nullptr;
-    if (!extract_string_arg(args, "keyId", &key_id)) {
-      response = error_response("INVALID_ARGUMENT", "keyId required");
+  } else if (strcmp(method, "retrieveKeys") == 0 ||
+             strcmp(method, "keysExist") == 0) {
+    GPtrArray* key_ids = nullptr;
+    if (!extract_string_list_arg(args, "keyIds", &key_ids)) {
+      response = error_response("INVALID_ARGUMENT", "keyIds required");
+    } else if (key_ids->len == 0) {
+      g_ptr_array_unref(key_ids);
+      response = FL_METHOD_RESPONSE(
+          fl_method_success_response_new(fl_value_new_map()));
     } else {
-      response = handle_delete_secret(key_id);
+      KeystoreOp op = strcmp(method, "retrieveKeys") == 0
+                          ? KeystoreOp::kRetrieveMany
+                          : KeystoreOp::kExistsMany;
+      KeystoreRequest* request =
+          keystore_request_new(self, method_call, op, nullptr);
+      request->key_ids = key_ids;
+      keystore_request_start(request);
+      return;
     }
-  } else if (strcmp(method, "keyExists") == 0) {
+  } else if (strcmp(method, "retrieveKey") == 0 ||
+             strcmp(method, "deleteKey") == 0 ||
+             strcmp(method, "keyExists") == 0) {
     const gchar* key_id = nullptr;
     if (!extract_string_arg(args, "keyId", &key_id)) {
       response = error_response("INVALID_ARGUMENT", "keyId required");
     } else {
-      response = handle_key_exists(key_id);
+      KeystoreOp op = strcmp(method, "retrieveKey") == 0 ? KeystoreOp::kRetrieve
+                      : strcmp(method, "deleteKey") == 0 ? KeystoreOp::kDelete
+                                                         : KeystoreOp::kExists;
+      keystore_request_start(
+          keystore_request_new(self, method_call, op, key_id));
+      return;
     }
   } else if (strcmp(method, "sealMasterKey") == 0) {
     const uint8_t* data = nullptr;
@@ -274,26 +1743,153 @@ static void keystore_method_call_handler(FlMethodChannel* channel,
     if (!extract_bytes_arg(args, "masterKey", &data, &length)) {
       response = error_response("INVALID_ARGUMENT", "masterKey required");
     } else {
-      g_autofree gchar* error_message = nullptr;
-      if (!store_secret(kMasterKeyId, data, length,
-                        "Pirate Wallet Master Key", &error_message)) {
-        response = error_response("SEAL_ERROR",
-                                  error_message ? error_message
-                                                : "Failed to seal key");
-      } else {
-        // Return a non-empty marker so Dart-side cache existence checks work.
-        g_autoptr(FlValue) marker = fl_value_new_uint8_list(
-            kSealedMarker, sizeof(kSealedMarker));
-        response = FL_METHOD_RESPONSE(fl_method_success_response_new(marker));
-      }
+      // A new seal replaces the key the cached plaintext belongs to.
+      master_key_cache_clear(&self->master_key_cache);
+      KeystoreRequest* request = keystore_request_new(
+          self, method_call, KeystoreOp::kStore, kMasterKeyId);
+      request->encoded =
+          g_base64_encode(reinterpret_cast<const guchar*>(data), length);
+      request->label = "Pirate Wallet Master Key";
+      request->error_code = "SEAL_ERROR";
+      // Return a non-empty marker so Dart-side cache existence checks work.
+      request->respond_with_marker = true;
+      keystore_request_start(request);
+      return;
     }
   } else if (strcmp(method, "unsealMasterKey") == 0) {
     const uint8_t* unused = nullptr;
     size_t length = 0;
     if (!extract_bytes_arg(args, "sealedKey", &unused, &length)) {
       response = error_response("INVALID_ARGUMENT", "sealedKey required");
+    } else if (FlValue* cached =
+                   master_key_cache_get(&self->master_key_cache)) {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(cached));
+      fl_value_unref(cached);
     } else {
-      response = handle_retrieve_secret(kMasterKeyId);
+      KeystoreRequest* request = keystore_request_new(
+          self, method_call, KeystoreOp::kRetrieve, kMasterKeyId);
+      request->cache_result = true;
+      request->cache_generation = self->master_key_cache.generation;
+      keystore_request_start(request);
+      return;
+    }
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+// keystore_raw: bulk keystore payloads as framed bytes, streamed in chunks
+// above kRawChunkBytes so nothing goes through StandardMessageCodec maps or
+// base64.
+static void keystore_raw_message_handler(
+    FlBasicMessageChannel* channel,
+    FlValue* message,
+    FlBasicMessageChannelResponseHandle* response_handle,
+    gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  RawRequest request = {};
+  if (!raw_request_parse(message, &request)) {
+    raw_respond(channel, response_handle,
+                raw_error_new(0, "Malformed keystore message"));
+    return;
+  }
+  g_autofree gchar* key_id = request.key_id;
+  const guint32 transfer_id = request.transfer_id;
+
+  switch (request.op) {
+    case RawOp::kStore: {
+      if (key_id[0] == '\0') {
+        raw_respond(channel, response_handle,
+                    raw_error_new(transfer_id, "keyId must be non-empty"));
+        return;
+      }
+      GByteArray* payload = nullptr;
+      const gchar* error = nullptr;
+      if (!raw_upload_append(self, &request, &payload, &error)) {
+        raw_respond(channel, response_handle,
+                    raw_error_new(transfer_id, error));
+        return;
+      }
+      if (payload == nullptr) {
+        raw_respond(channel, response_handle,
+                    raw_reply_new(RawStatus::kOk, transfer_id,
+                                  request.total_length,
+                                  request.offset + request.chunk_length,
+                                  nullptr, 0));
+        return;
+      }
+      // The SecretValue takes the received buffer as is, without a copy.
+      const gsize length = payload->len;
+      gchar* bytes = reinterpret_cast<gchar*>(g_byte_array_free(payload, FALSE));
+      KeystoreRequest* keystore_request =
+          keystore_request_new(self, nullptr, KeystoreOp::kRawStore, key_id);
+      keystore_request->raw_response =
+          FL_BASIC_MESSAGE_CHANNEL_RESPONSE_HANDLE(
+              g_object_ref(response_handle));
+      keystore_request->transfer_id = transfer_id;
+      keystore_request->raw_value = secret_value_new_full(
+          bytes, length, kRawSecretContentType, raw_secret_free);
+      keystore_request->label = "Pirate Wallet Key";
+      keystore_request_start(keystore_request);
+      return;
+    }
+    case RawOp::kRetrieve: {
+      KeystoreRequest* keystore_request = keystore_request_new(
+          self, nullptr, KeystoreOp::kRawRetrieve, key_id);
+      keystore_request->raw_response =
+          FL_BASIC_MESSAGE_CHANNEL_RESPONSE_HANDLE(
+              g_object_ref(response_handle));
+      keystore_request->transfer_id = transfer_id;
+      keystore_request_start(keystore_request);
+      return;
+    }
+    case RawOp::kRead:
+      raw_respond(channel, response_handle,
+                  raw_download_read(self, transfer_id, request.offset));
+      return;
+    case RawOp::kCancel:
+      g_hash_table_remove(self->raw_transfers, GUINT_TO_POINTER(transfer_id));
+      raw_respond(channel, response_handle,
+                  raw_reply_new(RawStatus::kOk, transfer_id, 0, 0, nullptr, 0));
+      return;
+  }
+}
+
+static void perf_method_call_handler(FlMethodChannel* channel,
+                                     FlMethodCall* method_call,
+                                     gpointer user_data) {
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+  const bool has_args =
+      args != nullptr && fl_value_get_type(args) == FL_VALUE_TYPE_MAP;
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (strcmp(method, "getTimeline") == 0) {
+    g_autofree gchar* json = startup_trace_json();
+    response = FL_METHOD_RESPONSE(
+        fl_method_success_response_new(fl_value_new_string(json)));
+  } else if (strcmp(method, "mark") == 0) {
+    const gchar* name = nullptr;
+    if (!has_args || !extract_string_arg(args, "name", &name) ||
+        name[0] == '\0') {
+      response = error_response("INVALID_ARGUMENT", "name required");
+    } else {
+      perf_mark(name);
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+    }
+  } else if (strcmp(method, "writeTrace") == 0) {
+    const gchar* path = nullptr;
+    if (!has_args || !extract_string_arg(args, "path", &path) ||
+        path[0] == '\0') {
+      path = g_getenv(kStartupTraceEnv);
+    }
+    if (path == nullptr || path[0] == '\0') {
+      response = error_response("INVALID_ARGUMENT", "path required");
+    } else {
+      response = FL_METHOD_RESPONSE(fl_method_success_response_new(
+          fl_value_new_bool(write_startup_trace(path))));
     }
   } else {
     response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
@@ -318,13 +1914,134 @@ static void security_method_call_handler(FlMethodChannel* channel,
 
   fl_method_call_respond(method_call, response, nullptr);
 }
+
+static void instance_method_call_handler(FlMethodChannel* channel,
+                                         FlMethodCall* method_call,
+                                         gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (strcmp(method, "takePendingArguments") == 0) {
+    g_autoptr(FlValue) pending = fl_value_new_list();
+    for (guint i = 0; i < self->pending_instance_arguments->len; i++) {
+      fl_value_append(pending, static_cast<FlValue*>(g_ptr_array_index(
+                                   self->pending_instance_arguments, i)));
+    }
+    g_ptr_array_set_size(self->pending_instance_arguments, 0);
+    self->instance_channel_ready = TRUE;
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(pending));
+  } else {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  }
+
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+static void warm_start_method_call_handler(FlMethodChannel* channel,
+                                           FlMethodCall* method_call,
+                                           gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+
+  if (strcmp(method, "takeSnapshot") == 0) {
+    warm_snapshot_install_sink(self);
+    if (!self->warm_snapshot_loaded) {
+      g_ptr_array_add(self->pending_warm_snapshot_calls,
+                      g_object_ref(method_call));
+      return;
+    }
+    warm_snapshot_respond(self, method_call);
+    return;
+  }
+
+  g_autoptr(FlMethodResponse) response =
+      FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+static void fast_unlock_method_call_handler(FlMethodChannel* channel,
+                                            FlMethodCall* method_call,
+                                            gpointer user_data) {
+  MyApplication* self = MY_APPLICATION(user_data);
+  const gchar* method = fl_method_call_get_name(method_call);
+  FlValue* args = fl_method_call_get_args(method_call);
+
+  g_autoptr(FlMethodResponse) response = nullptr;
+  if (strcmp(method, "configure") != 0) {
+    response = FL_METHOD_RESPONSE(fl_method_not_implemented_response_new());
+  } else if (args == nullptr ||
+             fl_value_get_type(args) != FL_VALUE_TYPE_MAP) {
+    response = error_response("INVALID_ARGUMENT", "arguments required");
+  } else {
+    FlValue* enabled = fl_value_lookup_string(args, "enabled");
+    FlValue* max_age = fl_value_lookup_string(args, "maxAgeSeconds");
+    const gboolean on = enabled != nullptr &&
+                        fl_value_get_type(enabled) == FL_VALUE_TYPE_BOOL &&
+                        fl_value_get_bool(enabled);
+    const int64_t seconds =
+        max_age != nullptr && fl_value_get_type(max_age) == FL_VALUE_TYPE_INT
+            ? fl_value_get_int(max_age)
+            : 0;
+    fast_unlock_configure(self, on,
+                          seconds > 0 ? static_cast<guint64>(seconds) : 0);
+    response = FL_METHOD_RESPONSE(fl_method_success_response_new(nullptr));
+  }
+
+  fl_method_call_respond(method_call, response, nullptr);
+}
+
+// Raises the window and passes a later launch's |arguments| to Dart, or
+// holds them until Dart asks for them.
+void forward_instance_arguments(MyApplication* self,
+                                const gchar* const* arguments) {
+  if (self->window != nullptr) {
+    gtk_window_present(GTK_WINDOW(self->window));
+  }
+
+  FlValue* values = fl_value_new_list();
+  for (const gchar* const* argument = arguments;
+       argument != nullptr && *argument != nullptr; argument++) {
+    fl_value_append_take(values, fl_value_new_string(*argument));
+  }
+  if (self->instance_channel_ready && self->instance_channel != nullptr) {
+    fl_method_channel_invoke_method(self->instance_channel, "openArguments",
+                                    values, nullptr, nullptr, nullptr);
+    fl_value_unref(values);
+  } else {
+    g_ptr_array_add(self->pending_instance_arguments, values);
+  }
+}
+
+// Starts the app with |arguments| on the first launch; later launches reach
+// the running instance through GApplication and are forwarded to Dart.
+void handle_launch(MyApplication* self, const gchar* const* arguments) {
+  if (self->window != nullptr) {
+    forward_instance_arguments(self, arguments);
+    return;
+  }
+  g_clear_pointer(&self->dart_entrypoint_arguments, g_strfreev);
+  self->dart_entrypoint_arguments = g_strdupv(const_cast<gchar**>(arguments));
+  g_application_activate(G_APPLICATION(self));
+}
 }  // namespace
 
 // Implements GApplication::activate.
 static void my_application_activate(GApplication* application) {
   MyApplication* self = MY_APPLICATION(application);
+  if (self->window != nullptr) {
+    gtk_window_present(GTK_WINDOW(self->window));
+    return;
+  }
+  if (self->prewarm_thread == nullptr) {
+    self->prewarm_thread =
+        g_thread_new("backend-prewarm", prewarm_backend_thread, nullptr);
+  }
   GtkWindow* window =
       GTK_WINDOW(gtk_application_window_new(GTK_APPLICATION(application)));
+  self->window = GTK_WIDGET(window);
+  g_signal_connect(window, "destroy", G_CALLBACK(gtk_widget_destroyed),
+                   &self->window);
 
   // Use a header bar when running in GNOME as this is the common style used
   // by applications and is the setup most users will be using (e.g. Ubuntu
@@ -353,6 +2070,12 @@ static void my_application_activate(GApplication* application) {
     gtk_window_set_title(window, "app");
   }
 
+  // Minimizing or leaving the window lets sync back off.
+  g_signal_connect(window, "window-state-event",
+                   G_CALLBACK(on_window_state_event), self);
+  g_signal_connect(window, "notify::is-active",
+                   G_CALLBACK(on_window_active_changed), self);
+
   const DesktopWindowSize initial_size = resolve_initial_window_size(window);
   gtk_window_set_default_size(window, initial_size.width, initial_size.height);
   gtk_widget_show(GTK_WIDGET(window));
@@ -360,11 +2083,16 @@ static void my_application_activate(GApplication* application) {
   g_autoptr(FlDartProject) project = fl_dart_project_new();
   fl_dart_project_set_dart_entrypoint_arguments(project, self->dart_entrypoint_arguments);
 
+  const gint64 view_started = perf_now();
   FlView* view = fl_view_new(project);
+  perf_span("fl_view_new", view_started);
+  g_signal_connect(view, "first-frame", G_CALLBACK(on_first_frame), self);
   gtk_widget_show(GTK_WIDGET(view));
   gtk_container_add(GTK_CONTAINER(window), GTK_WIDGET(view));
 
+  const gint64 plugins_started = perf_now();
   fl_register_plugins(FL_PLUGIN_REGISTRY(view));
+  perf_span("register_plugins", plugins_started);
 
   FlEngine* engine = fl_view_get_engine(view);
   FlBinaryMessenger* messenger = fl_engine_get_binary_messenger(engine);
@@ -375,48 +2103,114 @@ static void my_application_activate(GApplication* application) {
                                             keystore_method_call_handler, self,
                                             nullptr);
 
+  g_autoptr(FlBinaryCodec) binary_codec = fl_binary_codec_new();
+  self->keystore_raw_channel = fl_basic_message_channel_new(
+      messenger, kKeystoreRawChannelName, FL_MESSAGE_CODEC(binary_codec));
+  fl_basic_message_channel_set_message_handler(
+      self->keystore_raw_channel, keystore_raw_message_handler, self, nullptr);
+
   self->security_channel = fl_method_channel_new(
       messenger, kSecurityChannelName, FL_METHOD_CODEC(codec));
   fl_method_channel_set_method_call_handler(self->security_channel,
                                             security_method_call_handler, self,
                                             nullptr);
 
+  self->perf_channel = fl_method_channel_new(messenger, kPerfChannelName,
+                                             FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      self->perf_channel, perf_method_call_handler, self, nullptr);
+
+  self->instance_channel = fl_method_channel_new(
+      messenger, kInstanceChannelName, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      self->instance_channel, instance_method_call_handler, self, nullptr);
+
+  self->warm_start_channel = fl_method_channel_new(
+      messenger, kWarmStartChannelName, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      self->warm_start_channel, warm_start_method_call_handler, self, nullptr);
+  warm_snapshot_load(self);
+
+  self->fast_unlock_channel = fl_method_channel_new(
+      messenger, kFastUnlockChannelName, FL_METHOD_CODEC(codec));
+  fl_method_channel_set_method_call_handler(
+      self->fast_unlock_channel, fast_unlock_method_call_handler, self,
+      nullptr);
+  fast_unlock_load(self);
+
   gtk_widget_grab_focus(GTK_WIDGET(view));
 }
 
-// Implements GApplication::local_command_line.
-static gboolean my_application_local_command_line(GApplication* application, gchar*** arguments, int* exit_status) {
+// Implements GApplication::command_line. Runs in the primary instance for
+// its own launch and for every later one, which GApplication forwards over
+// D-Bus before that process starts an engine.
+static int my_application_command_line(GApplication* application,
+                                       GApplicationCommandLine* command_line) {
   MyApplication* self = MY_APPLICATION(application);
+  g_auto(GStrv) arguments =
+      g_application_command_line_get_arguments(command_line, nullptr);
   // Strip out the first argument as it is the binary name.
-  self->dart_entrypoint_arguments = g_strdupv(*arguments + 1);
+  const gchar* const* launch_arguments =
+      arguments != nullptr && arguments[0] != nullptr ? arguments + 1
+                                                      : arguments;
+  handle_launch(self, launch_arguments);
+  return 0;
+}
 
-  g_autoptr(GError) error = nullptr;
-  if (!g_application_register(application, nullptr, &error)) {
-     g_warning("Failed to register: %s", error->message);
-     *exit_status = 1;
-     return TRUE;
+// Implements GApplication::open, used for pirate: URIs activated through the
+// desktop file.
+static void my_application_open(GApplication* application,
+                                GFile** files,
+                                gint n_files,
+                                const gchar* hint) {
+  MyApplication* self = MY_APPLICATION(application);
+  g_auto(GStrv) uris = g_new0(gchar*, n_files + 1);
+  for (gint i = 0; i < n_files; i++) {
+    uris[i] = g_file_get_uri(files[i]);
   }
-
-  g_application_activate(application);
-  *exit_status = 0;
-
-  return TRUE;
+  handle_launch(self, uris);
 }
 
 // Implements GApplication::startup.
 static void my_application_startup(GApplication* application) {
-  //MyApplication* self = MY_APPLICATION(object);
+  MyApplication* self = MY_APPLICATION(application);
 
-  // Perform any actions required at application startup.
+  // Session lock and sleep signals wipe the master key cache.
+  g_bus_get(G_BUS_TYPE_SYSTEM, nullptr, on_system_bus_ready,
+            g_object_ref(self));
 
   G_APPLICATION_CLASS(my_application_parent_class)->startup(application);
 }
 
 // Implements GApplication::shutdown.
 static void my_application_shutdown(GApplication* application) {
-  //MyApplication* self = MY_APPLICATION(object);
+  MyApplication* self = MY_APPLICATION(application);
+
+  // The backend pre-warm may still be paging files in on a slow disk.
+  if (self->prewarm_thread != nullptr) {
+    g_thread_join(self->prewarm_thread);
+    self->prewarm_thread = nullptr;
+  }
+
+  G_LOCK(warm_snapshot_app);
+  if (warm_snapshot_app == self) {
+    warm_snapshot_app = nullptr;
+  }
+  G_UNLOCK(warm_snapshot_app);
+  G_LOCK(warm_snapshot_seed);
+  g_clear_pointer(&warm_snapshot_seed, g_bytes_unref);
+  G_UNLOCK(warm_snapshot_seed);
+  G_LOCK(fast_unlock_app);
+  if (fast_unlock_app == self) {
+    fast_unlock_app = nullptr;
+  }
+  G_UNLOCK(fast_unlock_app);
+  fast_unlock_forget_bundle();
 
-  // Perform any actions required at application shutdown.
+  const gchar* trace_path = g_getenv(kStartupTraceEnv);
+  if (trace_path != nullptr && trace_path[0] != '\0') {
+    write_startup_trace(trace_path);
+  }
 
   G_APPLICATION_CLASS(my_application_parent_class)->shutdown(application);
 }
@@ -425,14 +2219,38 @@ static void my_application_shutdown(GApplication* application) {
 static void my_application_dispose(GObject* object) {
   MyApplication* self = MY_APPLICATION(object);
   g_clear_object(&self->keystore_channel);
+  g_clear_object(&self->keystore_raw_channel);
+  g_clear_pointer(&self->raw_transfers, g_hash_table_unref);
   g_clear_object(&self->security_channel);
+  g_clear_object(&self->perf_channel);
+  g_clear_object(&self->instance_channel);
+  g_clear_object(&self->warm_start_channel);
+  g_clear_object(&self->fast_unlock_channel);
+  g_clear_pointer(&self->warm_snapshot, g_bytes_unref);
+  g_clear_pointer(&self->pending_warm_snapshot_calls, g_ptr_array_unref);
+  g_clear_pointer(&self->pending_instance_arguments, g_ptr_array_unref);
+  g_clear_object(&self->secret_service);
+  g_clear_pointer(&self->pending_keystore_requests, g_ptr_array_unref);
+  if (self->system_bus != nullptr) {
+    g_dbus_connection_signal_unsubscribe(self->system_bus,
+                                         self->prepare_for_sleep_subscription);
+    g_dbus_connection_signal_unsubscribe(self->system_bus,
+                                         self->session_lock_subscription);
+    g_dbus_connection_signal_unsubscribe(self->system_bus,
+                                         self->session_unlock_subscription);
+    g_dbus_connection_signal_unsubscribe(self->system_bus,
+                                         self->upower_subscription);
+    g_clear_object(&self->system_bus);
+  }
+  master_key_cache_clear(&self->master_key_cache);
   g_clear_pointer(&self->dart_entrypoint_arguments, g_strfreev);
   G_OBJECT_CLASS(my_application_parent_class)->dispose(object);
 }
 
 static void my_application_class_init(MyApplicationClass* klass) {
   G_APPLICATION_CLASS(klass)->activate = my_application_activate;
-  G_APPLICATION_CLASS(klass)->local_command_line = my_application_local_command_line;
+  G_APPLICATION_CLASS(klass)->command_line = my_application_command_line;
+  G_APPLICATION_CLASS(klass)->open = my_application_open;
   G_APPLICATION_CLASS(klass)->startup = my_application_startup;
   G_APPLICATION_CLASS(klass)->shutdown = my_application_shutdown;
   G_OBJECT_CLASS(klass)->dispose = my_application_dispose;
@@ -440,12 +2258,41 @@ static void my_application_class_init(MyApplicationClass* klass) {
 
 static void my_application_init(MyApplication* self) {
   self->keystore_channel = nullptr;
+  self->keystore_raw_channel = nullptr;
+  self->raw_transfers = g_hash_table_new_full(g_direct_hash, g_direct_equal,
+                                              nullptr, raw_transfer_free);
   self->security_channel = nullptr;
+  self->perf_channel = nullptr;
+  self->instance_channel = nullptr;
+  self->warm_start_channel = nullptr;
+  self->fast_unlock_channel = nullptr;
+  self->warm_snapshot = nullptr;
+  self->warm_snapshot_loaded = FALSE;
+  self->warm_snapshot_sink_installed = FALSE;
+  self->pending_warm_snapshot_calls =
+      g_ptr_array_new_with_free_func(g_object_unref);
+  self->window = nullptr;
+  self->pending_instance_arguments =
+      g_ptr_array_new_with_free_func(reinterpret_cast<GDestroyNotify>(fl_value_unref));
+  self->instance_channel_ready = FALSE;
+  self->secret_service = nullptr;
+  self->pending_keystore_requests = g_ptr_array_new();
+  self->secret_service_connecting = FALSE;
+  self->master_key_cache = MasterKeyCache{};
+  self->system_bus = nullptr;
+  self->prepare_for_sleep_subscription = 0;
+  self->session_lock_subscription = 0;
+  self->session_unlock_subscription = 0;
+  self->upower_subscription = 0;
+  self->sync_power = SyncPowerState{TRUE, TRUE, TRUE, FALSE, FALSE};
+  self->prewarm_thread = nullptr;
 }
 
 MyApplication* my_application_new() {
   return MY_APPLICATION(g_object_new(my_application_get_type(),
                                      "application-id", APPLICATION_ID,
-                                     "flags", G_APPLICATION_NON_UNIQUE,
+                                     "flags",
+                                     G_APPLICATION_HANDLES_COMMAND_LINE |
+                                         G_APPLICATION_HANDLES_OPEN,
                                      nullptr));
 }
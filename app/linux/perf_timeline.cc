@@ -0,0 +1,181 @@
+#include "perf_timeline.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace {
+// Keeps a runaway caller from growing the timeline without bound.
+constexpr guint kMaxEvents = 1024;
+
+struct PerfEvent {
+  gchar* name;
+  char phase;
+  gint64 ts_us;
+  gint64 dur_us;
+  gint64 tid;
+};
+
+struct Timeline {
+  gint64 origin_monotonic_us;
+  gint64 origin_real_us;
+  GArray* events;
+};
+
+GMutex timeline_mutex;
+
+gint64 current_tid() { return static_cast<gint64>(syscall(SYS_gettid)); }
+
+// The kernel records the process start in clock ticks since boot; the loader
+// and static initializers run before main(), so this covers them.
+bool process_start_real_us(gint64* out) {
+  g_autofree gchar* stat = nullptr;
+  if (!g_file_get_contents("/proc/self/stat", &stat, nullptr, nullptr)) {
+    return false;
+  }
+  // Field 2 (comm) may hold spaces; parsing starts after its closing paren.
+  const gchar* fields = strrchr(stat, ')');
+  unsigned long long start_ticks = 0;
+  if (fields == nullptr ||
+      sscanf(fields + 1,
+             " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %*u %*u %*d %*d "
+             "%*d %*d %*d %*d %llu",
+             &start_ticks) != 1) {
+    return false;
+  }
+
+  g_autofree gchar* proc_stat = nullptr;
+  if (!g_file_get_contents("/proc/stat", &proc_stat, nullptr, nullptr)) {
+    return false;
+  }
+  const gchar* btime = strstr(proc_stat, "\nbtime ");
+  unsigned long long boot_seconds = 0;
+  if (btime == nullptr || sscanf(btime, "\nbtime %llu", &boot_seconds) != 1) {
+    return false;
+  }
+
+  const long ticks_per_second = sysconf(_SC_CLK_TCK);
+  if (ticks_per_second <= 0) {
+    return false;
+  }
+  *out = static_cast<gint64>(boot_seconds) * G_USEC_PER_SEC +
+         static_cast<gint64>(start_ticks) * G_USEC_PER_SEC / ticks_per_second;
+  return true;
+}
+
+void add_event_locked(Timeline* timeline, PerfEvent event) {
+  if (timeline->events->len >= kMaxEvents) {
+    g_free(event.name);
+    return;
+  }
+  g_array_append_val(timeline->events, event);
+}
+
+// Must be called with timeline_mutex held.
+Timeline* timeline_locked() {
+  static Timeline* timeline = nullptr;
+  if (timeline == nullptr) {
+    timeline = g_new0(Timeline, 1);
+    timeline->origin_monotonic_us = g_get_monotonic_time();
+    timeline->origin_real_us = g_get_real_time();
+    timeline->events = g_array_new(FALSE, FALSE, sizeof(PerfEvent));
+    gint64 started = 0;
+    if (process_start_real_us(&started)) {
+      add_event_locked(timeline, {g_strdup("process_created"), 'i', started,
+                                  0, current_tid()});
+    }
+  }
+  return timeline;
+}
+
+gint64 to_real_us(Timeline* timeline, gint64 monotonic_us) {
+  return timeline->origin_real_us +
+         (monotonic_us - timeline->origin_monotonic_us);
+}
+
+void append_json_string(GString* out, const gchar* value) {
+  g_string_append_c(out, '"');
+  for (const unsigned char* c = reinterpret_cast<const unsigned char*>(value);
+       *c != '\0'; ++c) {
+    if (*c == '"' || *c == '\\') {
+      g_string_append_c(out, '\\');
+      g_string_append_c(out, static_cast<char>(*c));
+    } else if (*c < 0x20) {
+      g_string_append_printf(out, "\\u%04x", *c);
+    } else {
+      g_string_append_c(out, static_cast<char>(*c));
+    }
+  }
+  g_string_append_c(out, '"');
+}
+}  // namespace
+
+gint64 perf_now() {
+  {
+    // Pin the origin before the first span starts.
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&timeline_mutex);
+    timeline_locked();
+  }
+  return g_get_monotonic_time();
+}
+
+void perf_mark(const gchar* name) {
+  const gint64 now = g_get_monotonic_time();
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&timeline_mutex);
+  Timeline* timeline = timeline_locked();
+  add_event_locked(timeline, {g_strdup(name), 'i', to_real_us(timeline, now),
+                              0, current_tid()});
+}
+
+void perf_span(const gchar* name, gint64 start) {
+  const gint64 end = g_get_monotonic_time();
+  g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&timeline_mutex);
+  Timeline* timeline = timeline_locked();
+  add_event_locked(timeline, {g_strdup(name), 'X', to_real_us(timeline, start),
+                              end - start, current_tid()});
+}
+
+gchar* perf_trace_json(const gchar* extra_events) {
+  GString* out = g_string_new("{\"traceEvents\":[");
+  const pid_t pid = getpid();
+  bool first = true;
+  {
+    g_autoptr(GMutexLocker) locker = g_mutex_locker_new(&timeline_mutex);
+    Timeline* timeline = timeline_locked();
+    for (guint i = 0; i < timeline->events->len; i++) {
+      const PerfEvent& event = g_array_index(timeline->events, PerfEvent, i);
+      if (!first) {
+        g_string_append_c(out, ',');
+      }
+      first = false;
+      g_string_append(out, "{\"name\":");
+      append_json_string(out, event.name);
+      g_string_append_printf(out, ",\"cat\":\"runner\",\"ph\":\"%c\",\"ts\":%"
+                             G_GINT64_FORMAT, event.phase, event.ts_us);
+      if (event.phase == 'X') {
+        g_string_append_printf(out, ",\"dur\":%" G_GINT64_FORMAT,
+                               event.dur_us);
+      } else {
+        // Instant events span the whole process track.
+        g_string_append(out, ",\"s\":\"p\"");
+      }
+      g_string_append_printf(out, ",\"pid\":%d,\"tid\":%" G_GINT64_FORMAT "}",
+                             static_cast<int>(pid), event.tid);
+    }
+  }
+
+  // |extra_events| is a JSON array; splice its elements in.
+  const gchar* open = extra_events != nullptr ? strchr(extra_events, '[')
+                                              : nullptr;
+  const gchar* close = extra_events != nullptr ? strrchr(extra_events, ']')
+                                               : nullptr;
+  if (open != nullptr && close != nullptr && close > open + 1) {
+    if (!first) {
+      g_string_append_c(out, ',');
+    }
+    g_string_append_len(out, open + 1, close - open - 1);
+  }
+  g_string_append(out, "]}");
+  return g_string_free(out, FALSE);
+}
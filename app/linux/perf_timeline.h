@@ -0,0 +1,25 @@
+#ifndef FLUTTER_PERF_TIMELINE_H_
+#define FLUTTER_PERF_TIMELINE_H_
+
+#include <glib.h>
+
+// Process-wide startup timeline. Events are timed with the monotonic clock
+// and exported as Chrome trace events with wall-clock microsecond timestamps,
+// which is also how the Rust backend stamps its spans. All functions are
+// thread-safe.
+
+// Returns the current monotonic time, for use as a perf_span() start.
+gint64 perf_now();
+
+// Records an instant event.
+void perf_mark(const gchar* name);
+
+// Records a complete event from |start| (a perf_now() value) until now.
+void perf_span(const gchar* name, gint64 start);
+
+// Returns {"traceEvents": [...]} holding the runner's events followed by
+// |extra_events|, a JSON array of already-encoded events (may be nullptr).
+// Free with g_free().
+gchar* perf_trace_json(const gchar* extra_events);
+
+#endif  // FLUTTER_PERF_TIMELINE_H_
@@ -0,0 +1,584 @@
+// pirate_wallet_bench: measures the wallet service C ABI the way the native
+// bindings call it, plus the libsecret path the runner's keystore uses.
+//
+// The backend (libpirate_ffi_native.so) is loaded at run time so the bench
+// builds without the Rust toolchain. A throwaway fixture wallet is created in
+// a temporary data directory; nothing touches the user's wallets. Results go
+// to stdout as one JSON document so runs can be diffed and tracked.
+//
+//   pirate_wallet_bench [--library=PATH] [--data-dir=DIR] [--iterations=N]
+//                       [--threads=N] [--skip-keystore]
+
+#include <dlfcn.h>
+#include <glib.h>
+#include <libsecret/secret.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "pirate_wallet_service.h"
+
+namespace {
+
+const char kDefaultLibrary[] = "libpirate_ffi_native.so";
+const char kFixturePassphrase[] = "pirate-wallet-bench-passphrase";
+const int kDefaultIterations = 200;
+const int kDefaultThreads = 4;
+const int kWarmupIterations = 10;
+// Each keystore operation is a D-Bus round trip to the secret service.
+const int kMaxKeystoreIterations = 50;
+
+const SecretSchema kBenchKeystoreSchema = {
+    "com.pirate.wallet.bench",
+    SECRET_SCHEMA_NONE,
+    {{"key_id", SECRET_SCHEMA_ATTRIBUTE_STRING},
+     {nullptr, static_cast<SecretSchemaAttributeType>(0)}}};
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::string library = kDefaultLibrary;
+  std::string data_dir;
+  int iterations = kDefaultIterations;
+  int threads = kDefaultThreads;
+  bool keystore = true;
+};
+
+struct Backend {
+  decltype(&pirate_wallet_service_invoke_json) invoke_json = nullptr;
+  decltype(&pirate_wallet_service_free_string) free_string = nullptr;
+  decltype(&pirate_wallet_service_new) service_new = nullptr;
+  decltype(&pirate_wallet_service_free) service_free = nullptr;
+  decltype(&pirate_wallet_service_invoke_json_arena) invoke_json_arena =
+      nullptr;
+  decltype(&pirate_wallet_service_invoke_batch_json_arena)
+      invoke_batch_json_arena = nullptr;
+};
+
+struct Result {
+  std::string group;
+  std::string name;
+  int threads = 1;
+  size_t request_bytes = 0;
+  size_t response_bytes = 0;
+  std::vector<double> samples_us;
+  double wall_us = 0;
+  std::string error;
+};
+
+std::vector<Result> g_results;
+
+void append_json_string(std::string* out, const std::string& value) {
+  out->push_back('"');
+  for (unsigned char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(static_cast<char>(c));
+    } else if (c < 0x20) {
+      char escaped[8];
+      snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out->append(escaped);
+    } else {
+      out->push_back(static_cast<char>(c));
+    }
+  }
+  out->push_back('"');
+}
+
+double elapsed_us(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+double percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = static_cast<size_t>(fraction * (sorted.size() - 1));
+  return sorted[index];
+}
+
+// Envelopes are serialized with `ok` first.
+bool response_ok(const char* response) {
+  return response != nullptr && strncmp(response, "{\"ok\":true", 10) == 0;
+}
+
+// The string `result` of an envelope, e.g. the id from create_wallet.
+std::string result_string(const char* response) {
+  const char* key = "\"result\":\"";
+  const char* start = response != nullptr ? strstr(response, key) : nullptr;
+  if (start == nullptr) {
+    return std::string();
+  }
+  start += strlen(key);
+  const char* end = strchr(start, '"');
+  return end != nullptr ? std::string(start, end) : std::string();
+}
+
+// Runs |op| |iterations| times after a short warm up and records each call.
+// |op| returns false to abort with |*error| set.
+void measure(Result result,
+             int iterations,
+             const std::function<bool(std::string*)>& op) {
+  std::string error;
+  for (int i = 0; i < kWarmupIterations && iterations > 1; i++) {
+    if (!op(&error)) {
+      break;
+    }
+  }
+  const Clock::time_point wall_start = Clock::now();
+  for (int i = 0; i < iterations && error.empty(); i++) {
+    const Clock::time_point start = Clock::now();
+    if (!op(&error)) {
+      break;
+    }
+    result.samples_us.push_back(elapsed_us(start));
+  }
+  result.wall_us = elapsed_us(wall_start);
+  result.error = error;
+  g_results.push_back(std::move(result));
+}
+
+class Bench {
+ public:
+  Bench(const Backend& backend, const Options& options)
+      : backend_(backend), options_(options) {}
+
+  ~Bench() {
+    if (handle_ != nullptr) {
+      backend_.service_free(handle_);
+    }
+  }
+
+  // Creates the fixture wallet. Returns false when the backend is unusable.
+  bool set_up() {
+    handle_ = backend_.service_new();
+    if (handle_ == nullptr) {
+      fprintf(stderr, "bench: pirate_wallet_service_new failed\n");
+      return false;
+    }
+    std::string passphrase;
+    append_json_string(&passphrase, kFixturePassphrase);
+    if (!call_ok("{\"method\":\"set_app_passphrase\",\"passphrase\":" +
+                 passphrase + "}") ||
+        !call_ok("{\"method\":\"unlock_app\",\"passphrase\":" + passphrase +
+                 "}")) {
+      return false;
+    }
+    char* response = backend_.invoke_json(
+        "{\"method\":\"create_wallet\",\"name\":\"bench\","
+        "\"birthday_opt\":null,\"mnemonic_language\":null}",
+        false);
+    wallet_id_ = result_string(response);
+    const bool ok = response_ok(response) && !wallet_id_.empty();
+    if (!ok) {
+      fprintf(stderr, "bench: create_wallet failed: %s\n",
+              response != nullptr ? response : "(null)");
+    }
+    backend_.free_string(response);
+    return ok;
+  }
+
+  void run_method_latency() {
+    const std::string wallet = "\"wallet_id\":\"" + wallet_id_ + "\"";
+    const std::vector<std::pair<std::string, std::string>> requests = {
+        {"get_build_info", "{\"method\":\"get_build_info\"}"},
+        {"list_wallets", "{\"method\":\"list_wallets\"}"},
+        {"get_active_wallet", "{\"method\":\"get_active_wallet\"}"},
+        {"get_balance", "{\"method\":\"get_balance\"," + wallet + "}"},
+        {"sync_status", "{\"method\":\"sync_status\"," + wallet + "}"},
+        {"list_transactions",
+         "{\"method\":\"list_transactions\"," + wallet + ",\"limit\":50}"},
+        {"get_fee_info", "{\"method\":\"get_fee_info\"}"},
+    };
+    for (const auto& request : requests) {
+      // invoke_json allocates a fresh string per call; the arena entry point
+      // reuses the handle's buffer. Bindings use one or the other.
+      measure_invoke_json("invoke_json", request.first, request.second);
+      measure_invoke_arena("invoke_json_arena", request.first,
+                           request.second);
+    }
+  }
+
+  void run_throughput() {
+    const std::string request =
+        "{\"method\":\"get_balance\",\"wallet_id\":\"" + wallet_id_ + "\"}";
+    const int threads = std::max(1, options_.threads);
+    const int per_thread = options_.iterations;
+    std::atomic<bool> failed(false);
+
+    Result result;
+    result.group = "throughput";
+    result.name = "get_balance";
+    result.threads = threads;
+    result.request_bytes = request.size();
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<std::thread> workers;
+    const Clock::time_point wall_start = Clock::now();
+    for (int t = 0; t < threads; t++) {
+      workers.emplace_back([&, t]() {
+        samples[t].reserve(per_thread);
+        for (int i = 0; i < per_thread && !failed.load(); i++) {
+          const Clock::time_point start = Clock::now();
+          char* response = backend_.invoke_json(request.c_str(), false);
+          const bool ok = response_ok(response);
+          backend_.free_string(response);
+          if (!ok) {
+            failed.store(true);
+            break;
+          }
+          samples[t].push_back(elapsed_us(start));
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    result.wall_us = elapsed_us(wall_start);
+    for (const auto& thread_samples : samples) {
+      result.samples_us.insert(result.samples_us.end(), thread_samples.begin(),
+                               thread_samples.end());
+    }
+    if (failed.load()) {
+      result.error = "get_balance failed";
+    }
+    g_results.push_back(std::move(result));
+  }
+
+  void run_payload_scaling() {
+    // Request side: parse and copy cost for growing request bodies.
+    for (size_t size : {64u, 4096u, 65536u, 1048576u}) {
+      const std::string request = "{\"method\":\"validate_address\","
+                                  "\"address\":\"" +
+                                  std::string(size, 'z') + "\"}";
+      measure_invoke_arena("request_size", "validate_address_" +
+                                               std::to_string(size),
+                           request, scaled_iterations(size));
+    }
+    // Both sides: batches grow the request array and the response array.
+    for (int count : {1, 16, 256, 1024}) {
+      std::string request = "[";
+      for (int i = 0; i < count; i++) {
+        if (i > 0) {
+          request.push_back(',');
+        }
+        request += "{\"method\":\"get_balance\",\"wallet_id\":\"" +
+                   wallet_id_ + "\"}";
+      }
+      request.push_back(']');
+      measure_batch("batch_size", "get_balance_x" + std::to_string(count),
+                    request, scaled_iterations(request.size()));
+    }
+  }
+
+ private:
+  bool call_ok(const std::string& request) {
+    char* response = backend_.invoke_json(request.c_str(), false);
+    const bool ok = response_ok(response);
+    if (!ok) {
+      fprintf(stderr, "bench: request failed: %s\n",
+              response != nullptr ? response : "(null)");
+    }
+    backend_.free_string(response);
+    return ok;
+  }
+
+  // Large payloads get fewer iterations so a run stays in seconds.
+  int scaled_iterations(size_t bytes) const {
+    const size_t scale = std::max<size_t>(1, bytes / 4096);
+    return std::max(10, static_cast<int>(options_.iterations / scale));
+  }
+
+  void measure_invoke_json(const std::string& group,
+                           const std::string& name,
+                           const std::string& request) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_bytes = 0;
+    measure(std::move(result), options_.iterations,
+            [&](std::string* error) {
+              char* response = backend_.invoke_json(request.c_str(), false);
+              const bool ok = response_ok(response);
+              response_bytes = response != nullptr ? strlen(response) : 0;
+              if (!ok) {
+                *error = response != nullptr ? response : "null response";
+              }
+              backend_.free_string(response);
+              return ok;
+            });
+    g_results.back().response_bytes = response_bytes;
+  }
+
+  void measure_invoke_arena(const std::string& group,
+                            const std::string& name,
+                            const std::string& request,
+                            int iterations = 0) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_len = 0;
+    measure(std::move(result),
+            iterations > 0 ? iterations : options_.iterations,
+            [&](std::string* error) {
+              const char* response = nullptr;
+              const int32_t status = backend_.invoke_json_arena(
+                  handle_, request.data(), request.size(), false, &response,
+                  &response_len);
+              if (status != PIRATE_WALLET_SERVICE_OK ||
+                  !response_ok(response)) {
+                *error = status != PIRATE_WALLET_SERVICE_OK
+                             ? "status " + std::to_string(status)
+                             : std::string(response, response_len);
+                return false;
+              }
+              return true;
+            });
+    g_results.back().response_bytes = response_len;
+  }
+
+  void measure_batch(const std::string& group,
+                     const std::string& name,
+                     const std::string& request,
+                     int iterations) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_len = 0;
+    measure(std::move(result), iterations, [&](std::string* error) {
+      const char* response = nullptr;
+      const int32_t status = backend_.invoke_batch_json_arena(
+          handle_, request.data(), request.size(), false, &response,
+          &response_len);
+      if (status != PIRATE_WALLET_SERVICE_OK) {
+        *error = "status " + std::to_string(status);
+        return false;
+      }
+      return true;
+    });
+    g_results.back().response_bytes = response_len;
+  }
+
+  const Backend& backend_;
+  const Options& options_;
+  pirate_wallet_service_t* handle_ = nullptr;
+  std::string wallet_id_;
+};
+
+// Seal is a store into the default collection, unseal a lookup, matching
+// the runner's keystore channel. Bench items are cleared afterwards.
+void run_keystore(const Options& options) {
+  const int iterations = std::min(options.iterations, kMaxKeystoreIterations);
+  for (size_t size : {32u, 4096u}) {
+    std::vector<guchar> payload(size);
+    for (size_t i = 0; i < size; i++) {
+      payload[i] = static_cast<guchar>(i * 31 + 7);
+    }
+    g_autofree gchar* encoded = g_base64_encode(payload.data(), size);
+    const std::string key_id = "bench-" + std::to_string(size);
+    const std::string suffix = "_" + std::to_string(size);
+
+    Result seal;
+    seal.group = "keystore";
+    seal.name = "libsecret_seal" + suffix;
+    seal.request_bytes = size;
+    measure(std::move(seal), iterations, [&](std::string* error) {
+      GError* gerror = nullptr;
+      const gboolean stored = secret_password_store_sync(
+          &kBenchKeystoreSchema, SECRET_COLLECTION_DEFAULT,
+          "Pirate Wallet benchmark", encoded, nullptr, &gerror, "key_id",
+          key_id.c_str(), nullptr);
+      if (!stored) {
+        *error = gerror != nullptr ? gerror->message : "store failed";
+        g_clear_error(&gerror);
+        return false;
+      }
+      return true;
+    });
+    if (!g_results.back().error.empty()) {
+      continue;
+    }
+
+    Result unseal;
+    unseal.group = "keystore";
+    unseal.name = "libsecret_unseal" + suffix;
+    unseal.response_bytes = size;
+    measure(std::move(unseal), iterations, [&](std::string* error) {
+      GError* gerror = nullptr;
+      gchar* secret =
+          secret_password_lookup_sync(&kBenchKeystoreSchema, nullptr, &gerror,
+                                      "key_id", key_id.c_str(), nullptr);
+      if (secret == nullptr) {
+        *error = gerror != nullptr ? gerror->message : "lookup found nothing";
+        g_clear_error(&gerror);
+        return false;
+      }
+      gsize decoded_len = 0;
+      g_free(g_base64_decode(secret, &decoded_len));
+      secret_password_free(secret);
+      return true;
+    });
+
+    secret_password_clear_sync(&kBenchKeystoreSchema, nullptr, nullptr,
+                               "key_id", key_id.c_str(), nullptr);
+  }
+}
+
+std::string results_json(const Options& options) {
+  std::string out = "{\"benchmark\":\"pirate_wallet_bench\"";
+  out += ",\"platform\":\"linux\"";
+  out += ",\"timestamp\":" + std::to_string(g_get_real_time() / 1000000);
+  out += ",\"iterations\":" + std::to_string(options.iterations);
+  out += ",\"results\":[";
+  bool first = true;
+  char number[64];
+  for (auto& result : g_results) {
+    std::sort(result.samples_us.begin(), result.samples_us.end());
+    double total = 0;
+    for (double sample : result.samples_us) {
+      total += sample;
+    }
+    const size_t count = result.samples_us.size();
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    out += "{\"group\":";
+    append_json_string(&out, result.group);
+    out += ",\"name\":";
+    append_json_string(&out, result.name);
+    out += ",\"threads\":" + std::to_string(result.threads);
+    out += ",\"iterations\":" + std::to_string(count);
+    out += ",\"request_bytes\":" + std::to_string(result.request_bytes);
+    out += ",\"response_bytes\":" + std::to_string(result.response_bytes);
+    snprintf(number, sizeof(number),
+             ",\"mean_us\":%.2f,\"min_us\":%.2f,\"p50_us\":%.2f",
+             count > 0 ? total / count : 0.0,
+             count > 0 ? result.samples_us.front() : 0.0,
+             percentile(result.samples_us, 0.50));
+    out += number;
+    snprintf(number, sizeof(number),
+             ",\"p95_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f",
+             percentile(result.samples_us, 0.95),
+             percentile(result.samples_us, 0.99),
+             count > 0 ? result.samples_us.back() : 0.0);
+    out += number;
+    snprintf(number, sizeof(number), ",\"ops_per_sec\":%.1f",
+             result.wall_us > 0 ? count * 1e6 / result.wall_us : 0.0);
+    out += number;
+    if (!result.error.empty()) {
+      out += ",\"error\":";
+      append_json_string(&out, result.error);
+    }
+    out.push_back('}');
+  }
+  out += "]}";
+  return out;
+}
+
+bool parse_options(int argc, char** argv, Options* options) {
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (g_str_has_prefix(arg, "--library=")) {
+      options->library = arg + strlen("--library=");
+    } else if (g_str_has_prefix(arg, "--data-dir=")) {
+      options->data_dir = arg + strlen("--data-dir=");
+    } else if (g_str_has_prefix(arg, "--iterations=")) {
+      options->iterations = atoi(arg + strlen("--iterations="));
+    } else if (g_str_has_prefix(arg, "--threads=")) {
+      options->threads = atoi(arg + strlen("--threads="));
+    } else if (strcmp(arg, "--skip-keystore") == 0) {
+      options->keystore = false;
+    } else {
+      fprintf(stderr, "bench: unknown argument %s\n", arg);
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->threads > 0;
+}
+
+bool load_backend(const std::string& library, Backend* backend) {
+  void* handle = dlopen(library.c_str(), RTLD_NOW);
+  if (handle == nullptr) {
+    fprintf(stderr, "bench: %s\n", dlerror());
+    return false;
+  }
+#define PIRATE_BENCH_SYMBOL(field, symbol)                         \
+  backend->field = reinterpret_cast<decltype(backend->field)>(     \
+      dlsym(handle, #symbol));                                     \
+  if (backend->field == nullptr) {                                 \
+    fprintf(stderr, "bench: %s is missing " #symbol "\n",          \
+            library.c_str());                                      \
+    return false;                                                  \
+  }
+  PIRATE_BENCH_SYMBOL(invoke_json, pirate_wallet_service_invoke_json)
+  PIRATE_BENCH_SYMBOL(free_string, pirate_wallet_service_free_string)
+  PIRATE_BENCH_SYMBOL(service_new, pirate_wallet_service_new)
+  PIRATE_BENCH_SYMBOL(service_free, pirate_wallet_service_free)
+  PIRATE_BENCH_SYMBOL(invoke_json_arena,
+                      pirate_wallet_service_invoke_json_arena)
+  PIRATE_BENCH_SYMBOL(invoke_batch_json_arena,
+                      pirate_wallet_service_invoke_batch_json_arena)
+#undef PIRATE_BENCH_SYMBOL
+  return true;
+}
+
+}  // namespace
+
+int main(int argc, char** argv) {
+  Options options;
+  if (!parse_options(argc, argv, &options)) {
+    return 2;
+  }
+
+  // The backend reads its data directory from the environment on first use,
+  // so this has to happen before any call.
+  g_autofree gchar* temp_dir = nullptr;
+  if (options.data_dir.empty()) {
+    GError* error = nullptr;
+    temp_dir = g_dir_make_tmp("pirate-wallet-bench-XXXXXX", &error);
+    if (temp_dir == nullptr) {
+      fprintf(stderr, "bench: %s\n", error->message);
+      g_error_free(error);
+      return 1;
+    }
+    options.data_dir = temp_dir;
+  }
+  g_setenv("PIRATE_WALLET_DB_DIR", options.data_dir.c_str(), TRUE);
+
+  Backend backend;
+  if (!load_backend(options.library, &backend)) {
+    return 1;
+  }
+
+  {
+    Bench bench(backend, options);
+    if (!bench.set_up()) {
+      return 1;
+    }
+    bench.run_method_latency();
+    bench.run_throughput();
+    bench.run_payload_scaling();
+  }
+  if (options.keystore) {
+    run_keystore(options);
+  }
+
+  printf("%s\n", results_json(options).c_str());
+  if (temp_dir != nullptr) {
+    fprintf(stderr, "bench: fixture data left in %s\n", temp_dir);
+  }
+  return 0;
+}
@@ -1,24 +1,65 @@
 #include "flutter_window.h"
 
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
 #include <filesystem>
 #include <fstream>
+#include <functional>
+#include <mutex>
 #include <optional>
 #include <string>
 #include <vector>
 
 #include <windows.h>
 #include <dpapi.h>
+#include <shellapi.h>
 #include <wincrypt.h>
+#include <wtsapi32.h>
 
 #include <flutter/method_channel.h>
+#include <flutter/method_result_functions.h>
 #include <flutter/standard_method_codec.h>
 
 #include "flutter/generated_plugin_registrant.h"
+#include "perf_timeline.h"
+#include "single_instance.h"
 
 namespace {
 constexpr char kKeystoreChannelName[] = "com.pirate.wallet/keystore";
+constexpr char kKeystoreRawChannelName[] = "com.pirate.wallet/keystore_raw";
 constexpr char kSecurityChannelName[] = "com.pirate.wallet/security";
+constexpr char kPerfChannelName[] = "com.pirate.wallet/perf";
+constexpr char kInstanceChannelName[] = "com.pirate.wallet/instance";
+constexpr char kTrayChannelName[] = "com.pirate.wallet/tray";
+constexpr char kWarmStartChannelName[] = "com.pirate.wallet/warm_start";
+// Keystore record holding the sealed warm-start snapshot.
+constexpr char kWarmSnapshotKeyId[] = "pirate_warm_snapshot_v1";
+// The backend keeps snapshots to a few KiB; anything far larger is ignored.
+constexpr size_t kMaxWarmSnapshotBytes = 256 * 1024;
+constexpr char kFastUnlockChannelName[] = "com.pirate.wallet/fast_unlock";
+// Keystore record holding the sealed fast-unlock bundle.
+constexpr char kFastUnlockKeyId[] = "pirate_fast_unlock_v1";
+// A bundle is two keys per wallet plus the registry's.
+constexpr size_t kMaxFastUnlockBundleBytes = 64 * 1024;
+// When set, the startup trace is written here as the window closes.
+constexpr wchar_t kStartupTraceEnv[] = L"PIRATE_STARTUP_TRACE";
+constexpr wchar_t kBackendLibrary[] = L"pirate_ffi_frb.dll";
 constexpr wchar_t kDpapiDescription[] = L"Pirate Wallet Key";
+// Posted to the window to run a keystore completion on the platform thread.
+constexpr UINT kRunOnPlatformThreadMessage = WM_APP + 1;
+// Sent by the shell for clicks on the close-to-tray icon.
+constexpr UINT kTrayIconMessage = WM_APP + 2;
+// DPAPI and file I/O are mostly waiting, so a couple of threads is enough to
+// keep independent keys from queueing behind each other.
+constexpr size_t kKeystoreWorkerThreads = 2;
+// Error returned to keystore calls still queued when the window closes.
+constexpr char kKeystoreShutdownCode[] = "KEYSTORE_SHUTDOWN";
+constexpr char kKeystoreShutdownMessage[] = "Keystore is shutting down";
+// Timer that wipes the cached master key once its idle TTL has elapsed.
+constexpr UINT_PTR kMasterKeyCacheTimerId = 1;
+constexpr UINT kMasterKeyCacheSweepMs = 1000;
 
 #ifndef WDA_EXCLUDEFROMCAPTURE
 #define WDA_EXCLUDEFROMCAPTURE 0x00000011
@@ -50,25 +91,6 @@ std::filesystem::path GetKeystoreDir() {
   return std::filesystem::path(buffer) / L"PirateWallet" / L"keystore";
 }
 
-std::string HexEncode(const std::string& input) {
-  static const char kHex[] = "0123456789abcdef";
-  std::string out;
-  out.reserve(input.size() * 2);
-  for (unsigned char c : input) {
-    out.push_back(kHex[c >> 4]);
-    out.push_back(kHex[c & 0x0F]);
-  }
-  return out;
-}
-
-std::filesystem::path KeyPathForId(const std::string& key_id) {
-  std::string hex = HexEncode(key_id);
-  std::wstring filename = L"key_";
-  filename.append(hex.begin(), hex.end());
-  filename.append(L".bin");
-  return GetKeystoreDir() / filename;
-}
-
 bool ProtectData(const std::vector<uint8_t>& input,
                  std::vector<uint8_t>* output,
                  std::string* error) {
@@ -119,55 +141,98 @@ bool UnprotectData(const std::vector<uint8_t>& input,
   return true;
 }
 
-bool WriteFileBytes(const std::filesystem::path& path,
-                    const std::vector<uint8_t>& data,
-                    std::string* error) {
-  std::error_code ec;
-  std::filesystem::create_directories(path.parent_path(), ec);
-  if (ec) {
-    if (error) {
-      *error = "Failed to create keystore directory";
-    }
-    return false;
+// The backend's spans as a JSON array, or "[]" when the backend is not loaded
+// yet. Never loads it: reading the timeline must not change startup.
+std::string BackendTraceEvents() {
+  HMODULE backend = ::GetModuleHandleW(kBackendLibrary);
+  if (backend == nullptr) {
+    return "[]";
   }
-  std::ofstream out(path, std::ios::binary | std::ios::trunc);
-  if (!out) {
-    if (error) {
-      *error = "Failed to open keystore file";
-    }
-    return false;
-  }
-  out.write(reinterpret_cast<const char*>(data.data()),
-            static_cast<std::streamsize>(data.size()));
-  if (!out) {
-    if (error) {
-      *error = "Failed to write keystore file";
-    }
-    return false;
-  }
-  return true;
+  using TraceEventsFn = const char* (*)();
+  auto trace_events = reinterpret_cast<TraceEventsFn>(
+      ::GetProcAddress(backend, "pirate_perf_trace_events_json"));
+  const char* json = trace_events != nullptr ? trace_events() : nullptr;
+  return json != nullptr ? std::string(json) : std::string("[]");
 }
 
-bool ReadFileBytes(const std::filesystem::path& path,
-                   std::vector<uint8_t>* data,
-                   std::string* error) {
-  std::ifstream in(path, std::ios::binary);
-  if (!in) {
-    return false;
+bool IsOnAcPower() {
+  SYSTEM_POWER_STATUS status;
+  // ACLineStatus is 0 on battery, 1 online and 255 when unknown.
+  return !::GetSystemPowerStatus(&status) || status.ACLineStatus != 0;
+}
+
+std::wstring StartupTracePath() {
+  wchar_t buffer[MAX_PATH];
+  const DWORD length =
+      ::GetEnvironmentVariableW(kStartupTraceEnv, buffer, MAX_PATH);
+  if (length == 0 || length >= MAX_PATH) {
+    return std::wstring();
   }
-  std::vector<uint8_t> buffer((std::istreambuf_iterator<char>(in)),
-                              std::istreambuf_iterator<char>());
-  if (!in && !in.eof()) {
-    if (error) {
-      *error = "Failed to read keystore file";
-    }
-    return false;
+  return std::wstring(buffer, length);
+}
+
+bool WriteTraceFile(const std::filesystem::path& path) {
+  const std::string json = PerfTraceJson(BackendTraceEvents());
+  std::ofstream out(path, std::ios::binary | std::ios::trunc);
+  out.write(json.data(), static_cast<std::streamsize>(json.size()));
+  return out.good();
+}
+
+// Window that receives the backend's warm-start snapshots, and the snapshot
+// unsealed at startup until the backend reads it back; guarded by
+// g_warm_snapshot_mutex because both hooks run on backend threads.
+std::mutex g_warm_snapshot_mutex;
+FlutterWindow* g_warm_snapshot_window = nullptr;
+std::vector<uint8_t> g_warm_snapshot_seed;
+
+// Window that seals fast-unlock bundles, and the bundle unsealed at startup
+// until the backend takes it; guarded by g_fast_unlock_mutex because both
+// hooks run on backend threads. |g_fast_unlock_pending| is set while the
+// keystore worker is still unsealing it.
+std::mutex g_fast_unlock_mutex;
+FlutterWindow* g_fast_unlock_window = nullptr;
+std::vector<uint8_t> g_fast_unlock_bundle;
+bool g_fast_unlock_pending = false;
+
+// Size the fast-unlock load hook reports while the bundle is still being
+// unsealed (FAST_UNLOCK_LOAD_PENDING in the backend).
+constexpr size_t kFastUnlockLoadPending = SIZE_MAX;
+
+// Runs |callback| on the thread that owns |hwnd|. Safe to call from any
+// thread; the callback is dropped if the window is already gone.
+void PostToWindowThread(HWND hwnd, std::function<void()> callback) {
+  auto* heap_callback = new std::function<void()>(std::move(callback));
+  if (hwnd == nullptr ||
+      !::PostMessage(hwnd, kRunOnPlatformThreadMessage, 0,
+                     reinterpret_cast<LPARAM>(heap_callback))) {
+    delete heap_callback;
   }
-  *data = std::move(buffer);
-  return true;
 }
 }  // namespace
 
+// Outcome of a keystore method, computed on a worker thread and delivered to
+// the MethodResult on the platform thread.
+struct FlutterWindow::KeystoreReply {
+  bool ok = true;
+  flutter::EncodableValue value;
+  std::string error_code;
+  std::string error_message;
+
+  static KeystoreReply Success(flutter::EncodableValue value) {
+    KeystoreReply reply;
+    reply.value = std::move(value);
+    return reply;
+  }
+
+  static KeystoreReply Failure(std::string code, std::string message) {
+    KeystoreReply reply;
+    reply.ok = false;
+    reply.error_code = std::move(code);
+    reply.error_message = std::move(message);
+    return reply;
+  }
+};
+
 FlutterWindow::FlutterWindow(const flutter::DartProject& project)
     : project_(project) {}
 
@@ -182,15 +247,30 @@ bool FlutterWindow::OnCreate() {
 
   // The size here must match the window dimensions to avoid unnecessary surface
   // creation / destruction in the startup path.
-  flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
-      frame.right - frame.left, frame.bottom - frame.top, project_);
+  {
+    PerfSpan span("flutter_view_controller");
+    flutter_controller_ = std::make_unique<flutter::FlutterViewController>(
+        frame.right - frame.left, frame.bottom - frame.top, project_);
+  }
   // Ensure that basic setup of the controller was successful.
   if (!flutter_controller_->engine() || !flutter_controller_->view()) {
     return false;
   }
-  RegisterPlugins(flutter_controller_->engine());
+  {
+    PerfSpan span("register_plugins");
+    RegisterPlugins(flutter_controller_->engine());
+  }
   SetChildContent(flutter_controller_->view()->GetNativeWindow());
 
+  on_ac_power_ = IsOnAcPower();
+  ForwardSyncPowerState();
+
+  keystore_pack_ = std::make_unique<KeystorePack>(GetKeystoreDir());
+  keystore_worker_ = std::make_unique<KeystoreWorker>(kKeystoreWorkerThreads);
+  LoadWarmSnapshot();
+  LoadFastUnlockBundle();
+  // Session lock notifications invalidate the cached master key.
+  ::WTSRegisterSessionNotification(GetHandle(), NOTIFY_FOR_THIS_SESSION);
   keystore_channel_ =
       std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
           flutter_controller_->engine()->messenger(), kKeystoreChannelName,
@@ -214,6 +294,12 @@ bool FlutterWindow::OnCreate() {
           return;
         }
 
+        if (method == "clearMasterKeyCache") {
+          master_key_cache_.Clear();
+          result->Success(flutter::EncodableValue(true));
+          return;
+        }
+
         const auto* args =
             std::get_if<flutter::EncodableMap>(call.arguments());
         if (!args) {
@@ -243,6 +329,100 @@ bool FlutterWindow::OnCreate() {
           return true;
         };
 
+        auto get_string_list = [args](const std::string& key,
+                                      std::vector<std::string>* value) -> bool {
+          auto it = args->find(flutter::EncodableValue(key));
+          if (it == args->end() ||
+              !std::holds_alternative<flutter::EncodableList>(it->second)) {
+            return false;
+          }
+          const auto& list = std::get<flutter::EncodableList>(it->second);
+          value->clear();
+          value->reserve(list.size());
+          for (const auto& item : list) {
+            const auto* text = std::get_if<std::string>(&item);
+            if (text == nullptr) {
+              return false;
+            }
+            value->push_back(*text);
+          }
+          return true;
+        };
+
+        if (method == "configureMasterKeyCache") {
+          auto it = args->find(flutter::EncodableValue("idleTtlMs"));
+          int64_t ttl_ms = -1;
+          if (it != args->end()) {
+            if (const auto* value = std::get_if<int32_t>(&it->second)) {
+              ttl_ms = *value;
+            } else if (const auto* wide = std::get_if<int64_t>(&it->second)) {
+              ttl_ms = *wide;
+            }
+          }
+          if (ttl_ms < 0) {
+            result->Error("INVALID_ARGUMENT", "idleTtlMs required");
+            return;
+          }
+          master_key_cache_.SetIdleTtl(std::chrono::milliseconds(ttl_ms));
+          if (ttl_ms > 0) {
+            ::SetTimer(GetHandle(), kMasterKeyCacheTimerId,
+                       kMasterKeyCacheSweepMs, nullptr);
+          } else {
+            ::KillTimer(GetHandle(), kMasterKeyCacheTimerId);
+          }
+          result->Success(flutter::EncodableValue(true));
+          return;
+        }
+
+        // Per-key work shared by the single and bulk methods. These run on
+        // the keystore worker.
+        KeystorePack* pack = keystore_pack_.get();
+
+        // Protects every key and writes them with one pack rewrite.
+        auto store_keys = [pack](const std::vector<KeystorePack::Record>& keys) {
+          std::vector<KeystorePack::Record> records;
+          records.reserve(keys.size());
+          std::string error;
+          for (const auto& key : keys) {
+            std::vector<uint8_t> protected_data;
+            if (!ProtectData(key.second, &protected_data, &error)) {
+              return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+            }
+            records.emplace_back(key.first, std::move(protected_data));
+          }
+          if (!pack->Put(records, &error)) {
+            return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+          }
+          return KeystoreReply::Success(flutter::EncodableValue(true));
+        };
+
+        auto retrieve_key = [pack](const std::string& key_id) {
+          std::vector<uint8_t> protected_data;
+          bool found = false;
+          std::string error;
+          if (!pack->Get(key_id, &protected_data, &found, &error)) {
+            return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+          }
+          if (!found) {
+            return KeystoreReply::Success(flutter::EncodableValue());
+          }
+          std::vector<uint8_t> plaintext;
+          if (!UnprotectData(protected_data, &plaintext, &error)) {
+            return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+          }
+          return KeystoreReply::Success(
+              flutter::EncodableValue(std::move(plaintext)));
+        };
+
+        auto key_exists = [pack](const std::string& key_id) {
+          bool exists = false;
+          std::string error;
+          if (!pack->Contains(key_id, &exists, &error)) {
+            return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+          }
+          return KeystoreReply::Success(flutter::EncodableValue(exists));
+        };
+
         if (method == "storeKey") {
           std::string key_id;
           std::vector<uint8_t> encrypted_key;
@@ -251,17 +431,50 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "keyId and encryptedKey required");
             return;
           }
-          std::vector<uint8_t> protected_data;
-          std::string error;
-          if (!ProtectData(encrypted_key, &protected_data, &error)) {
-            result->Error("KEYSTORE_ERROR", error);
-            return;
+          RunKeystoreTask(
+              key_id, std::move(result),
+              [store_keys, key_id, encrypted_key = std::move(encrypted_key)]() {
+                return store_keys({{key_id, encrypted_key}});
+              });
+          return;
+        }
+
+        if (method == "storeKeys") {
+          auto it = args->find(flutter::EncodableValue("keys"));
+          const auto* entries =
+              it == args->end()
+                  ? nullptr
+                  : std::get_if<flutter::EncodableMap>(&it->second);
+          std::vector<KeystorePack::Record> keys;
+          bool valid = entries != nullptr;
+          if (valid) {
+            for (const auto& entry : *entries) {
+              const auto* key_id = std::get_if<std::string>(&entry.first);
+              const auto* data =
+                  std::get_if<std::vector<uint8_t>>(&entry.second);
+              if (key_id == nullptr || data == nullptr) {
+                valid = false;
+                break;
+              }
+              keys.emplace_back(*key_id, *data);
+            }
           }
-          if (!WriteFileBytes(KeyPathForId(key_id), protected_data, &error)) {
-            result->Error("KEYSTORE_ERROR", error);
+          if (!valid) {
+            result->Error("INVALID_ARGUMENT",
+                          "keys must map keyId to encryptedKey");
             return;
           }
-          result->Success(flutter::EncodableValue(true));
+          // One task and one pack rewrite for the whole batch, ordered
+          // against single-key calls still queued for any of these keyIds.
+          std::vector<std::string> key_ids;
+          key_ids.reserve(keys.size());
+          for (const auto& key : keys) {
+            key_ids.push_back(key.first);
+          }
+          RunKeystoreTask(key_ids, std::move(result),
+                          [store_keys, keys = std::move(keys)]() {
+                            return store_keys(keys);
+                          });
           return;
         }
 
@@ -271,23 +484,26 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "keyId required");
             return;
           }
-          auto path = KeyPathForId(key_id);
-          if (!std::filesystem::exists(path)) {
-            result->Success(flutter::EncodableValue());
-            return;
-          }
-          std::vector<uint8_t> protected_data;
-          std::string error;
-          if (!ReadFileBytes(path, &protected_data, &error)) {
-            result->Error("KEYSTORE_ERROR", error);
+          RunKeystoreTask(key_id, std::move(result),
+                          [retrieve_key, key_id]() {
+                            return retrieve_key(key_id);
+                          });
+          return;
+        }
+
+        if (method == "retrieveKeys" || method == "keysExist") {
+          std::vector<std::string> key_ids;
+          if (!get_string_list("keyIds", &key_ids)) {
+            result->Error("INVALID_ARGUMENT", "keyIds required");
             return;
           }
-          std::vector<uint8_t> plaintext;
-          if (!UnprotectData(protected_data, &plaintext, &error)) {
-            result->Error("KEYSTORE_ERROR", error);
-            return;
+          if (method == "retrieveKeys") {
+            RunBulkKeystoreTask(std::move(key_ids), std::move(result),
+                                retrieve_key);
+          } else {
+            RunBulkKeystoreTask(std::move(key_ids), std::move(result),
+                                key_exists);
           }
-          result->Success(flutter::EncodableValue(plaintext));
           return;
         }
 
@@ -297,13 +513,13 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "keyId required");
             return;
           }
-          std::error_code ec;
-          std::filesystem::remove(KeyPathForId(key_id), ec);
-          if (ec) {
-            result->Error("KEYSTORE_ERROR", "Failed to delete key");
-            return;
-          }
-          result->Success(flutter::EncodableValue(true));
+          RunKeystoreTask(key_id, std::move(result), [pack, key_id]() {
+            std::string error;
+            if (!pack->Remove(key_id, &error)) {
+              return KeystoreReply::Failure("KEYSTORE_ERROR", error);
+            }
+            return KeystoreReply::Success(flutter::EncodableValue(true));
+          });
           return;
         }
 
@@ -313,8 +529,9 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "keyId required");
             return;
           }
-          bool exists = std::filesystem::exists(KeyPathForId(key_id));
-          result->Success(flutter::EncodableValue(exists));
+          RunKeystoreTask(key_id, std::move(result), [key_exists, key_id]() {
+            return key_exists(key_id);
+          });
           return;
         }
 
@@ -324,13 +541,19 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "masterKey required");
             return;
           }
-          std::vector<uint8_t> sealed;
-          std::string error;
-          if (!ProtectData(master_key, &sealed, &error)) {
-            result->Error("SEAL_ERROR", error);
-            return;
-          }
-          result->Success(flutter::EncodableValue(sealed));
+          // A new seal replaces the key the cached plaintext belongs to.
+          master_key_cache_.Clear();
+          RunKeystoreTask(
+              std::string(), std::move(result),
+              [master_key = std::move(master_key)]() {
+                std::vector<uint8_t> sealed;
+                std::string error;
+                if (!ProtectData(master_key, &sealed, &error)) {
+                  return KeystoreReply::Failure("SEAL_ERROR", error);
+                }
+                return KeystoreReply::Success(
+                    flutter::EncodableValue(std::move(sealed)));
+              });
           return;
         }
 
@@ -340,19 +563,37 @@ bool FlutterWindow::OnCreate() {
             result->Error("INVALID_ARGUMENT", "sealedKey required");
             return;
           }
-          std::vector<uint8_t> unsealed;
-          std::string error;
-          if (!UnprotectData(sealed_key, &unsealed, &error)) {
-            result->Error("UNSEAL_ERROR", error);
+          std::vector<uint8_t> cached;
+          if (master_key_cache_.Get(sealed_key, &cached)) {
+            result->Success(flutter::EncodableValue(std::move(cached)));
             return;
           }
-          result->Success(flutter::EncodableValue(unsealed));
+          const uint64_t cache_generation = master_key_cache_.generation();
+          RunKeystoreTask(
+              std::string(), std::move(result),
+              [this, sealed_key = std::move(sealed_key), cache_generation]() {
+                std::vector<uint8_t> unsealed;
+                std::string error;
+                if (!UnprotectData(sealed_key, &unsealed, &error)) {
+                  return KeystoreReply::Failure("UNSEAL_ERROR", error);
+                }
+                master_key_cache_.Put(sealed_key, unsealed, cache_generation);
+                return KeystoreReply::Success(
+                    flutter::EncodableValue(std::move(unsealed)));
+              });
           return;
         }
 
         result->NotImplemented();
       });
 
+  // Bulk payloads skip the method codec; see KeystoreStream for the framing.
+  flutter_controller_->engine()->messenger()->SetMessageHandler(
+      kKeystoreRawChannelName,
+      [this](const uint8_t* message, size_t size, flutter::BinaryReply reply) {
+        HandleRawKeystoreMessage(message, size, std::move(reply));
+      });
+
   security_channel_ =
       std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
           flutter_controller_->engine()->messenger(), kSecurityChannelName,
@@ -374,7 +615,155 @@ bool FlutterWindow::OnCreate() {
         result->NotImplemented();
       });
 
+  perf_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          flutter_controller_->engine()->messenger(), kPerfChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+
+  perf_channel_->SetMethodCallHandler([](const auto& call, auto result) {
+    const auto& method = call.method_name();
+    const auto* args = std::get_if<flutter::EncodableMap>(call.arguments());
+    auto get_string = [args](const char* key, std::string* out) {
+      if (args == nullptr) {
+        return false;
+      }
+      auto it = args->find(flutter::EncodableValue(key));
+      if (it == args->end()) {
+        return false;
+      }
+      const auto* value = std::get_if<std::string>(&it->second);
+      if (value == nullptr) {
+        return false;
+      }
+      *out = *value;
+      return true;
+    };
+
+    if (method == "getTimeline") {
+      result->Success(
+          flutter::EncodableValue(PerfTraceJson(BackendTraceEvents())));
+      return;
+    }
+    if (method == "mark") {
+      std::string name;
+      if (!get_string("name", &name) || name.empty()) {
+        result->Error("INVALID_ARGUMENT", "name required");
+        return;
+      }
+      PerfMark(name);
+      result->Success();
+      return;
+    }
+    if (method == "writeTrace") {
+      std::string path;
+      std::filesystem::path target;
+      if (get_string("path", &path) && !path.empty()) {
+        target = std::filesystem::u8path(path);
+      } else {
+        target = StartupTracePath();
+      }
+      if (target.empty()) {
+        result->Error("INVALID_ARGUMENT", "path required");
+        return;
+      }
+      result->Success(flutter::EncodableValue(WriteTraceFile(target)));
+      return;
+    }
+    result->NotImplemented();
+  });
+
+  instance_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          flutter_controller_->engine()->messenger(), kInstanceChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+
+  instance_channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        if (call.method_name() == "takePendingArguments") {
+          flutter::EncodableList pending;
+          pending.swap(pending_instance_arguments_);
+          instance_channel_ready_ = true;
+          result->Success(flutter::EncodableValue(std::move(pending)));
+          return;
+        }
+        result->NotImplemented();
+      });
+
+  tray_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          flutter_controller_->engine()->messenger(), kTrayChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+
+  tray_channel_->SetMethodCallHandler([this](const auto& call, auto result) {
+    if (call.method_name() == "hideToTray") {
+      result->Success(flutter::EncodableValue(HideToTray()));
+      return;
+    }
+    result->NotImplemented();
+  });
+
+  warm_start_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          flutter_controller_->engine()->messenger(), kWarmStartChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+
+  warm_start_channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        if (call.method_name() == "takeSnapshot") {
+          InstallWarmSnapshotSink();
+          if (!warm_snapshot_loaded_) {
+            pending_warm_snapshot_results_.push_back(std::move(result));
+            return;
+          }
+          ReplyWarmSnapshot(std::move(result));
+          return;
+        }
+        result->NotImplemented();
+      });
+
+  fast_unlock_channel_ =
+      std::make_unique<flutter::MethodChannel<flutter::EncodableValue>>(
+          flutter_controller_->engine()->messenger(), kFastUnlockChannelName,
+          &flutter::StandardMethodCodec::GetInstance());
+
+  fast_unlock_channel_->SetMethodCallHandler(
+      [this](const auto& call, auto result) {
+        if (call.method_name() != "configure") {
+          result->NotImplemented();
+          return;
+        }
+        const auto* args = std::get_if<flutter::EncodableMap>(call.arguments());
+        if (args == nullptr) {
+          result->Error("INVALID_ARGUMENT", "arguments required");
+          return;
+        }
+        bool enabled = false;
+        int64_t max_age_seconds = 0;
+        auto it = args->find(flutter::EncodableValue("enabled"));
+        if (it != args->end()) {
+          if (const auto* value = std::get_if<bool>(&it->second)) {
+            enabled = *value;
+          }
+        }
+        it = args->find(flutter::EncodableValue("maxAgeSeconds"));
+        if (it != args->end()) {
+          if (const auto* value = std::get_if<int32_t>(&it->second)) {
+            max_age_seconds = *value;
+          } else if (const auto* wide = std::get_if<int64_t>(&it->second)) {
+            max_age_seconds = *wide;
+          }
+        }
+        ConfigureFastUnlock(enabled, max_age_seconds > 0
+                                         ? static_cast<uint64_t>(max_age_seconds)
+                                         : 0);
+        result->Success();
+      });
+
   flutter_controller_->engine()->SetNextFrameCallback([&]() {
+    PerfMark("first_frame");
+    // Dart has opened the backend by now; make sure it has the state.
+    ForwardSyncPowerState();
+    InstallWarmSnapshotSink();
     this->Show();
   });
 
@@ -387,7 +776,49 @@ bool FlutterWindow::OnCreate() {
 }
 
 void FlutterWindow::OnDestroy() {
+  {
+    std::lock_guard<std::mutex> lock(g_warm_snapshot_mutex);
+    if (g_warm_snapshot_window == this) {
+      g_warm_snapshot_window = nullptr;
+    }
+    KeystoreStream::Wipe(&g_warm_snapshot_seed);
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+    if (g_fast_unlock_window == this) {
+      g_fast_unlock_window = nullptr;
+    }
+    KeystoreStream::Wipe(&g_fast_unlock_bundle);
+  }
+  // Finish in-flight keystore work before the engine goes away; calls that
+  // never started are answered with an error by the worker, and completions
+  // that are still queued are dropped by MessageHandler.
+  keystore_worker_ = nullptr;
+  KeystoreStream::Wipe(&warm_snapshot_);
+  // Callers waiting on the snapshot paint cold, as if none was stored.
+  for (auto& result : pending_warm_snapshot_results_) {
+    result->Success();
+  }
+  pending_warm_snapshot_results_.clear();
+  keystore_stream_.Clear();
+  master_key_cache_.Clear();
+  tray_icon_.Hide();
+  if (in_tray_) {
+    in_tray_ = false;
+    SetProcessBackgroundMode(false);
+  }
+  const std::wstring trace_path = StartupTracePath();
+  if (!trace_path.empty()) {
+    WriteTraceFile(trace_path);
+  }
+  if (HWND hwnd = GetHandle()) {
+    SingleInstance::UnmarkPrimaryWindow(hwnd);
+    ::KillTimer(hwnd, kMasterKeyCacheTimerId);
+    ::WTSUnRegisterSessionNotification(hwnd);
+  }
   if (flutter_controller_) {
+    flutter_controller_->engine()->messenger()->SetMessageHandler(
+        kKeystoreRawChannelName, nullptr);
     flutter_controller_ = nullptr;
   }
 
@@ -398,6 +829,35 @@ LRESULT
 FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
                               WPARAM const wparam,
                               LPARAM const lparam) noexcept {
+  if (message == kRunOnPlatformThreadMessage) {
+    std::unique_ptr<std::function<void()>> callback(
+        reinterpret_cast<std::function<void()>*>(lparam));
+    if (flutter_controller_ && callback && *callback) {
+      (*callback)();
+    }
+    return 0;
+  }
+
+  if (message == WM_COPYDATA) {
+    std::vector<std::string> arguments;
+    if (SingleInstance::ParseForwardedArguments(
+            reinterpret_cast<const COPYDATASTRUCT*>(lparam), &arguments)) {
+      HandleForwardedLaunch(std::move(arguments));
+      return TRUE;
+    }
+  }
+
+  if (message == kTrayIconMessage) {
+    HandleTrayIconMessage(lparam);
+    return 0;
+  }
+  if (message == TrayIcon::taskbar_created_message()) {
+    tray_icon_.Restore();
+  }
+
+  // Before Flutter, which may consume focus and size messages.
+  TrackSyncPowerState(message, wparam);
+
   // Give Flutter, including plugins, an opportunity to handle window messages.
   if (flutter_controller_) {
     std::optional<LRESULT> result =
@@ -412,7 +872,622 @@ FlutterWindow::MessageHandler(HWND hwnd, UINT const message,
     case WM_FONTCHANGE:
       flutter_controller_->engine()->ReloadSystemFonts();
       break;
+    case WM_TIMER:
+      if (wparam == kMasterKeyCacheTimerId) {
+        master_key_cache_.EvictIfIdle();
+        return 0;
+      }
+      break;
+    case WM_POWERBROADCAST:
+      if (wparam == PBT_APMSUSPEND) {
+        master_key_cache_.Clear();
+      }
+      break;
+    case WM_WTSSESSION_CHANGE:
+      if (wparam == WTS_SESSION_LOCK) {
+        master_key_cache_.Clear();
+      }
+      break;
   }
 
   return Win32Window::MessageHandler(hwnd, message, wparam, lparam);
 }
+
+void FlutterWindow::HandleForwardedLaunch(std::vector<std::string> arguments) {
+  RestoreFromTray();
+  HWND hwnd = GetHandle();
+  ::ShowWindow(hwnd, ::IsIconic(hwnd) ? SW_RESTORE : SW_SHOW);
+  ::SetForegroundWindow(hwnd);
+
+  flutter::EncodableList values;
+  values.reserve(arguments.size());
+  for (std::string& argument : arguments) {
+    values.emplace_back(std::move(argument));
+  }
+  if (instance_channel_ready_ && instance_channel_) {
+    instance_channel_->InvokeMethod(
+        "openArguments",
+        std::make_unique<flutter::EncodableValue>(std::move(values)));
+  } else {
+    pending_instance_arguments_.emplace_back(std::move(values));
+  }
+}
+
+bool FlutterWindow::HideToTray() {
+  HWND hwnd = GetHandle();
+  if (hwnd == nullptr || !tray_icon_.Show(hwnd, kTrayIconMessage)) {
+    return false;
+  }
+  // WM_SHOWWINDOW tells the backend the window is gone, which moves sync to
+  // its reduced or trickle profile.
+  ::ShowWindow(hwnd, SW_HIDE);
+  master_key_cache_.Clear();
+  if (!in_tray_) {
+    in_tray_ = true;
+    SetProcessBackgroundMode(true);
+  }
+  return true;
+}
+
+void FlutterWindow::RestoreFromTray() {
+  if (!in_tray_) {
+    return;
+  }
+  in_tray_ = false;
+  SetProcessBackgroundMode(false);
+  tray_icon_.Hide();
+  HWND hwnd = GetHandle();
+  ::ShowWindow(hwnd, ::IsIconic(hwnd) ? SW_RESTORE : SW_SHOW);
+  ::SetForegroundWindow(hwnd);
+}
+
+void FlutterWindow::HandleTrayIconMessage(LPARAM const lparam) {
+  switch (LOWORD(lparam)) {
+    case NIN_SELECT:
+    case NIN_KEYSELECT:
+      RestoreFromTray();
+      break;
+    case WM_CONTEXTMENU:
+      switch (tray_icon_.ShowMenu()) {
+        case TrayIcon::Command::kOpen:
+          RestoreFromTray();
+          break;
+        case TrayIcon::Command::kQuit: {
+          in_tray_ = false;
+          SetProcessBackgroundMode(false);
+          tray_icon_.Hide();
+          // Dart shuts the transports down and destroys the window; if it
+          // cannot, close here so Quit always quits.
+          HWND hwnd = GetHandle();
+          tray_channel_->InvokeMethod(
+              "quit", nullptr,
+              std::make_unique<
+                  flutter::MethodResultFunctions<flutter::EncodableValue>>(
+                  nullptr,
+                  [hwnd](const std::string&, const std::string&,
+                         const flutter::EncodableValue*) {
+                    ::DestroyWindow(hwnd);
+                  },
+                  [hwnd]() { ::DestroyWindow(hwnd); }));
+          break;
+        }
+        case TrayIcon::Command::kNone:
+          break;
+      }
+      break;
+  }
+}
+
+void FlutterWindow::TrackSyncPowerState(UINT const message,
+                                        WPARAM const wparam) {
+  const bool was_ac_power = on_ac_power_;
+  const bool was_visible = window_visible_;
+  const bool was_focused = window_focused_;
+  const bool was_locked = session_locked_;
+  const bool was_suspended = suspended_;
+  switch (message) {
+    case WM_POWERBROADCAST:
+      if (wparam == PBT_APMPOWERSTATUSCHANGE) {
+        on_ac_power_ = IsOnAcPower();
+      } else if (wparam == PBT_APMSUSPEND) {
+        suspended_ = true;
+      } else if (wparam == PBT_APMRESUMEAUTOMATIC ||
+                 wparam == PBT_APMRESUMESUSPEND) {
+        suspended_ = false;
+        on_ac_power_ = IsOnAcPower();
+      }
+      break;
+    case WM_WTSSESSION_CHANGE:
+      if (wparam == WTS_SESSION_LOCK) {
+        session_locked_ = true;
+      } else if (wparam == WTS_SESSION_UNLOCK) {
+        session_locked_ = false;
+      }
+      break;
+    case WM_SIZE:
+      if (wparam == SIZE_MINIMIZED) {
+        window_visible_ = false;
+      } else if (wparam == SIZE_RESTORED || wparam == SIZE_MAXIMIZED) {
+        window_visible_ = true;
+      }
+      break;
+    case WM_ACTIVATE:
+      window_focused_ = LOWORD(wparam) != WA_INACTIVE;
+      break;
+    case WM_SHOWWINDOW:
+      window_visible_ = wparam != FALSE;
+      break;
+    default:
+      return;
+  }
+  if (on_ac_power_ != was_ac_power || window_visible_ != was_visible ||
+      window_focused_ != was_focused || session_locked_ != was_locked ||
+      suspended_ != was_suspended) {
+    ForwardSyncPowerState();
+  }
+}
+
+void FlutterWindow::ForwardSyncPowerState() {
+  HMODULE backend = ::GetModuleHandleW(kBackendLibrary);
+  if (backend == nullptr) {
+    return;
+  }
+  using SetSyncPowerStateFn = void (*)(uint8_t, uint8_t, uint8_t, uint8_t);
+  auto set_state = reinterpret_cast<SetSyncPowerStateFn>(
+      ::GetProcAddress(backend, "pirate_set_sync_power_state"));
+  if (set_state != nullptr) {
+    set_state(on_ac_power_ ? 1 : 0, window_visible_ ? 1 : 0,
+              window_focused_ ? 1 : 0,
+              session_locked_ || suspended_ ? 1 : 0);
+  }
+}
+
+void FlutterWindow::LoadWarmSnapshot() {
+  KeystorePack* pack = keystore_pack_.get();
+  HWND hwnd = GetHandle();
+  keystore_worker_->Post(kWarmSnapshotKeyId, [this, pack, hwnd]() {
+    PerfSpan span("warm_snapshot_load");
+    auto snapshot = std::make_shared<std::vector<uint8_t>>();
+    std::vector<uint8_t> protected_data;
+    bool found = false;
+    std::string error;
+    // A missing or unreadable snapshot just means a cold first paint.
+    if (pack->Get(kWarmSnapshotKeyId, &protected_data, &found, &error) &&
+        found && !UnprotectData(protected_data, snapshot.get(), &error)) {
+      snapshot->clear();
+    }
+    {
+      std::lock_guard<std::mutex> lock(g_warm_snapshot_mutex);
+      KeystoreStream::Wipe(&g_warm_snapshot_seed);
+      g_warm_snapshot_seed = *snapshot;
+    }
+    PostToWindowThread(hwnd, [this, snapshot]() {
+      warm_snapshot_ = std::move(*snapshot);
+      warm_snapshot_loaded_ = true;
+      auto pending = std::move(pending_warm_snapshot_results_);
+      pending_warm_snapshot_results_.clear();
+      for (auto& result : pending) {
+        ReplyWarmSnapshot(std::move(result));
+      }
+    });
+  });
+}
+
+void FlutterWindow::InstallWarmSnapshotSink() {
+  if (warm_snapshot_sink_installed_) {
+    return;
+  }
+  HMODULE backend = ::GetModuleHandleW(kBackendLibrary);
+  if (backend == nullptr) {
+    return;
+  }
+  using StoreFn = void (*)(const uint8_t*, size_t);
+  using LoadFn = size_t (*)(uint8_t*, size_t);
+  using SetHostFn = void (*)(StoreFn, LoadFn);
+  auto set_host = reinterpret_cast<SetHostFn>(
+      ::GetProcAddress(backend, "pirate_set_warm_snapshot_host"));
+  if (set_host == nullptr) {
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_warm_snapshot_mutex);
+    g_warm_snapshot_window = this;
+  }
+  set_host(&FlutterWindow::OnWarmSnapshot, &FlutterWindow::OnWarmSnapshotLoad);
+  warm_snapshot_sink_installed_ = true;
+}
+
+void FlutterWindow::StoreWarmSnapshot(std::vector<uint8_t> document) {
+  if (!keystore_worker_) {
+    return;
+  }
+  KeystorePack* pack = keystore_pack_.get();
+  auto shared_document =
+      std::make_shared<std::vector<uint8_t>>(std::move(document));
+  keystore_worker_->Post(kWarmSnapshotKeyId, [pack, shared_document]() {
+    std::string error;
+    if (shared_document->empty()) {
+      pack->Remove(kWarmSnapshotKeyId, &error);
+      return;
+    }
+    std::vector<uint8_t> protected_data;
+    if (ProtectData(*shared_document, &protected_data, &error)) {
+      pack->Put({{kWarmSnapshotKeyId, std::move(protected_data)}}, &error);
+    }
+    KeystoreStream::Wipe(shared_document.get());
+  });
+}
+
+void FlutterWindow::ReplyWarmSnapshot(
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result) {
+  if (warm_snapshot_.empty()) {
+    result->Success();
+    return;
+  }
+  // One reader per launch; later calls get null.
+  std::vector<uint8_t> snapshot;
+  snapshot.swap(warm_snapshot_);
+  result->Success(flutter::EncodableValue(std::move(snapshot)));
+}
+
+void FlutterWindow::OnWarmSnapshot(const uint8_t* data, size_t length) {
+  if (length > kMaxWarmSnapshotBytes) {
+    return;
+  }
+  std::vector<uint8_t> document;
+  if (data != nullptr && length > 0) {
+    document.assign(data, data + length);
+  }
+  std::lock_guard<std::mutex> lock(g_warm_snapshot_mutex);
+  FlutterWindow* window = g_warm_snapshot_window;
+  if (window == nullptr) {
+    return;
+  }
+  // The keystore worker belongs to the window, so hop to its thread first.
+  PostToWindowThread(window->GetHandle(),
+                     [window, document = std::move(document)]() mutable {
+                       window->StoreWarmSnapshot(std::move(document));
+                     });
+}
+
+size_t FlutterWindow::OnWarmSnapshotLoad(uint8_t* buffer, size_t capacity) {
+  std::lock_guard<std::mutex> lock(g_warm_snapshot_mutex);
+  const size_t length = g_warm_snapshot_seed.size();
+  if (buffer == nullptr || capacity == 0) {
+    return length;
+  }
+  if (capacity < length) {
+    return 0;
+  }
+  std::copy(g_warm_snapshot_seed.begin(), g_warm_snapshot_seed.end(), buffer);
+  KeystoreStream::Wipe(&g_warm_snapshot_seed);
+  return length;
+}
+
+void FlutterWindow::LoadFastUnlockBundle() {
+  KeystorePack* pack = keystore_pack_.get();
+  {
+    std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+    g_fast_unlock_pending = true;
+  }
+  keystore_worker_->Post(kFastUnlockKeyId, [pack]() {
+    PerfSpan span("fast_unlock_load");
+    std::vector<uint8_t> protected_data;
+    std::vector<uint8_t> bundle;
+    bool found = false;
+    std::string error;
+    // Without a readable bundle the backend runs the full KDF.
+    const bool loaded =
+        pack->Get(kFastUnlockKeyId, &protected_data, &found, &error) &&
+        found && UnprotectData(protected_data, &bundle, &error);
+    std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+    g_fast_unlock_pending = false;
+    if (loaded) {
+      KeystoreStream::Wipe(&g_fast_unlock_bundle);
+      g_fast_unlock_bundle = std::move(bundle);
+    }
+  });
+}
+
+void FlutterWindow::ConfigureFastUnlock(bool enabled,
+                                        uint64_t max_age_seconds) {
+  HMODULE backend = ::GetModuleHandleW(kBackendLibrary);
+  using StoreFn = void (*)(const uint8_t*, size_t);
+  using LoadFn = size_t (*)(uint8_t*, size_t);
+  using SetHostFn = void (*)(StoreFn, LoadFn);
+  using SetPolicyFn = void (*)(uint8_t, uint64_t);
+  SetHostFn set_host = nullptr;
+  SetPolicyFn set_policy = nullptr;
+  if (backend != nullptr) {
+    set_host = reinterpret_cast<SetHostFn>(
+        ::GetProcAddress(backend, "pirate_set_fast_unlock_host"));
+    set_policy = reinterpret_cast<SetPolicyFn>(
+        ::GetProcAddress(backend, "pirate_set_fast_unlock_policy"));
+  }
+  if (!enabled || set_host == nullptr || set_policy == nullptr) {
+    if (set_policy != nullptr) {
+      set_policy(0, 0);
+    }
+    if (set_host != nullptr) {
+      set_host(nullptr, nullptr);
+    }
+    {
+      std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+      if (g_fast_unlock_window == this) {
+        g_fast_unlock_window = nullptr;
+      }
+      KeystoreStream::Wipe(&g_fast_unlock_bundle);
+    }
+    if (!enabled) {
+      StoreFastUnlockBundle({});
+    }
+    return;
+  }
+  {
+    std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+    g_fast_unlock_window = this;
+  }
+  set_host(&FlutterWindow::OnFastUnlockStore,
+           &FlutterWindow::OnFastUnlockLoad);
+  set_policy(1, max_age_seconds);
+}
+
+void FlutterWindow::StoreFastUnlockBundle(std::vector<uint8_t> bundle) {
+  if (!keystore_worker_) {
+    KeystoreStream::Wipe(&bundle);
+    return;
+  }
+  KeystorePack* pack = keystore_pack_.get();
+  auto shared_bundle =
+      std::make_shared<std::vector<uint8_t>>(std::move(bundle));
+  keystore_worker_->Post(kFastUnlockKeyId, [pack, shared_bundle]() {
+    std::string error;
+    if (shared_bundle->empty()) {
+      pack->Remove(kFastUnlockKeyId, &error);
+      return;
+    }
+    std::vector<uint8_t> protected_data;
+    if (ProtectData(*shared_bundle, &protected_data, &error)) {
+      pack->Put({{kFastUnlockKeyId, std::move(protected_data)}}, &error);
+    }
+    KeystoreStream::Wipe(shared_bundle.get());
+  });
+}
+
+void FlutterWindow::OnFastUnlockStore(const uint8_t* data, size_t length) {
+  if (length > kMaxFastUnlockBundleBytes) {
+    return;
+  }
+  std::vector<uint8_t> bundle;
+  if (data != nullptr && length > 0) {
+    bundle.assign(data, data + length);
+  }
+  std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+  FlutterWindow* window = g_fast_unlock_window;
+  if (window == nullptr) {
+    KeystoreStream::Wipe(&bundle);
+    return;
+  }
+  PostToWindowThread(window->GetHandle(),
+                     [window, bundle = std::move(bundle)]() mutable {
+                       window->StoreFastUnlockBundle(std::move(bundle));
+                     });
+}
+
+size_t FlutterWindow::OnFastUnlockLoad(uint8_t* buffer, size_t capacity) {
+  std::lock_guard<std::mutex> lock(g_fast_unlock_mutex);
+  const size_t length = g_fast_unlock_bundle.size();
+  if (buffer == nullptr || capacity == 0) {
+    return g_fast_unlock_pending ? kFastUnlockLoadPending : length;
+  }
+  if (capacity < length) {
+    return 0;
+  }
+  std::copy(g_fast_unlock_bundle.begin(), g_fast_unlock_bundle.end(), buffer);
+  // Handed over once; the backend keeps it until an unlock accepts it.
+  KeystoreStream::Wipe(&g_fast_unlock_bundle);
+  return length;
+}
+
+void FlutterWindow::RunKeystoreTask(
+    const std::string& key_id,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+    std::function<KeystoreReply()> work) {
+  RunKeystoreTask(key_id.empty() ? std::vector<std::string>()
+                                 : std::vector<std::string>{key_id},
+                  std::move(result), std::move(work));
+}
+
+void FlutterWindow::RunKeystoreTask(
+    const std::vector<std::string>& key_ids,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+    std::function<KeystoreReply()> work) {
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result =
+      std::move(result);
+  HWND hwnd = GetHandle();
+  keystore_worker_->PostAll(
+      key_ids,
+      [hwnd, shared_result, work = std::move(work)]() {
+        auto reply = std::make_shared<KeystoreReply>(work());
+        PostToWindowThread(hwnd, [shared_result, reply]() {
+          if (reply->ok) {
+            shared_result->Success(reply->value);
+          } else {
+            shared_result->Error(reply->error_code, reply->error_message);
+          }
+        });
+      },
+      [shared_result]() {
+        shared_result->Error(kKeystoreShutdownCode, kKeystoreShutdownMessage);
+      });
+}
+
+void FlutterWindow::HandleRawKeystoreMessage(const uint8_t* message,
+                                             size_t size,
+                                             flutter::BinaryReply reply) {
+  auto send = [&reply](std::vector<uint8_t> frame) {
+    reply(frame.data(), frame.size());
+    KeystoreStream::Wipe(&frame);
+  };
+  KeystoreStream::Request request;
+  if (!KeystoreStream::ParseRequest(message, size, &request)) {
+    send(KeystoreStream::EncodeError(0, "Malformed keystore message"));
+    return;
+  }
+  const uint32_t transfer_id = request.transfer_id;
+  KeystorePack* pack = keystore_pack_.get();
+
+  switch (request.op) {
+    case KeystoreStream::Op::kStore: {
+      std::vector<uint8_t> payload;
+      std::string error;
+      if (!keystore_stream_.AppendUpload(request, &payload, &error)) {
+        send(KeystoreStream::EncodeError(transfer_id, error));
+        return;
+      }
+      if (!request.final) {
+        send(KeystoreStream::EncodeReply(
+            KeystoreStream::Status::kOk, transfer_id, request.total_length,
+            request.offset, nullptr, 0));
+        return;
+      }
+      auto shared_payload =
+          std::make_shared<std::vector<uint8_t>>(std::move(payload));
+      RunRawKeystoreTask(
+          request.key_id, transfer_id, std::move(reply),
+          [pack, key_id = request.key_id, shared_payload]() {
+            KeystoreStream::Outcome outcome;
+            std::vector<uint8_t> protected_data;
+            bool ok = ProtectData(*shared_payload, &protected_data,
+                                  &outcome.error);
+            KeystoreStream::Wipe(shared_payload.get());
+            if (ok) {
+              std::vector<KeystorePack::Record> records;
+              records.emplace_back(key_id, std::move(protected_data));
+              ok = pack->Put(records, &outcome.error);
+            }
+            if (!ok) {
+              outcome.status = KeystoreStream::Status::kError;
+            }
+            return outcome;
+          });
+      return;
+    }
+    case KeystoreStream::Op::kRetrieve:
+      RunRawKeystoreTask(
+          request.key_id, transfer_id, std::move(reply),
+          [pack, key_id = request.key_id]() {
+            KeystoreStream::Outcome outcome;
+            std::vector<uint8_t> protected_data;
+            bool found = false;
+            if (!pack->Get(key_id, &protected_data, &found, &outcome.error) ||
+                (found && !UnprotectData(protected_data, &outcome.data,
+                                         &outcome.error))) {
+              outcome.status = KeystoreStream::Status::kError;
+            } else if (!found) {
+              outcome.status = KeystoreStream::Status::kNotFound;
+            }
+            return outcome;
+          });
+      return;
+    case KeystoreStream::Op::kRead:
+      send(keystore_stream_.Read(transfer_id, request.offset));
+      return;
+    case KeystoreStream::Op::kCancel:
+      keystore_stream_.Cancel(transfer_id);
+      send(KeystoreStream::EncodeReply(KeystoreStream::Status::kOk,
+                                       transfer_id, 0, 0, nullptr, 0));
+      return;
+  }
+}
+
+void FlutterWindow::RunRawKeystoreTask(
+    const std::string& key_id, uint32_t transfer_id,
+    flutter::BinaryReply reply,
+    std::function<KeystoreStream::Outcome()> work) {
+  HWND hwnd = GetHandle();
+  auto shared_reply = std::make_shared<flutter::BinaryReply>(std::move(reply));
+  keystore_worker_->Post(
+      key_id,
+      [this, hwnd, transfer_id, shared_reply, work = std::move(work)]() {
+        auto outcome = std::make_shared<KeystoreStream::Outcome>(work());
+        PostToWindowThread(hwnd, [this, transfer_id, shared_reply, outcome]() {
+          std::vector<uint8_t> frame =
+              keystore_stream_.Complete(transfer_id, std::move(*outcome));
+          (*shared_reply)(frame.data(), frame.size());
+          KeystoreStream::Wipe(&frame);
+        });
+      },
+      [transfer_id, shared_reply]() {
+        std::vector<uint8_t> frame =
+            KeystoreStream::EncodeError(transfer_id, kKeystoreShutdownMessage);
+        (*shared_reply)(frame.data(), frame.size());
+      });
+}
+
+void FlutterWindow::RunBulkKeystoreTask(
+    std::vector<std::string> key_ids,
+    std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+    std::function<KeystoreReply(const std::string&)> work) {
+  if (key_ids.empty()) {
+    result->Success(flutter::EncodableValue(flutter::EncodableMap()));
+    return;
+  }
+
+  // Collects the per-key replies; whichever task finishes last answers.
+  struct BulkState {
+    std::mutex mutex;
+    size_t remaining = 0;
+    flutter::EncodableMap values;
+    std::optional<KeystoreReply> failure;
+  };
+  auto state = std::make_shared<BulkState>();
+  state->remaining = key_ids.size();
+  std::shared_ptr<flutter::MethodResult<flutter::EncodableValue>> shared_result =
+      std::move(result);
+  auto shared_work =
+      std::make_shared<std::function<KeystoreReply(const std::string&)>>(
+          std::move(work));
+  HWND hwnd = GetHandle();
+
+  for (const auto& key_id : key_ids) {
+    keystore_worker_->Post(
+        key_id,
+        [hwnd, shared_result, shared_work, state, key_id]() {
+          KeystoreReply reply = (*shared_work)(key_id);
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (!reply.ok) {
+            if (!state->failure) {
+              state->failure = std::move(reply);
+            }
+          } else {
+            state->values[flutter::EncodableValue(key_id)] =
+                std::move(reply.value);
+          }
+          if (--state->remaining != 0) {
+            return;
+          }
+          auto final_reply = std::make_shared<KeystoreReply>(
+              state->failure ? std::move(*state->failure)
+                             : KeystoreReply::Success(flutter::EncodableValue(
+                                   std::move(state->values))));
+          PostToWindowThread(hwnd, [shared_result, final_reply]() {
+            if (final_reply->ok) {
+              shared_result->Success(final_reply->value);
+            } else {
+              shared_result->Error(final_reply->error_code,
+                                   final_reply->error_message);
+            }
+          });
+        },
+        // Drops run after every started key has finished, so the last one
+        // answers for the whole batch.
+        [shared_result, state]() {
+          std::lock_guard<std::mutex> lock(state->mutex);
+          if (--state->remaining == 0) {
+            shared_result->Error(kKeystoreShutdownCode,
+                                 kKeystoreShutdownMessage);
+          }
+        });
+  }
+}
@@ -1,13 +1,22 @@
 #ifndef RUNNER_FLUTTER_WINDOW_H_
 #define RUNNER_FLUTTER_WINDOW_H_
 
+#include <flutter/binary_messenger.h>
 #include <flutter/dart_project.h>
 #include <flutter/encodable_value.h>
 #include <flutter/flutter_view_controller.h>
 #include <flutter/method_channel.h>
 
+#include <functional>
 #include <memory>
+#include <string>
+#include <vector>
 
+#include "keystore_pack.h"
+#include "keystore_stream.h"
+#include "keystore_worker.h"
+#include "master_key_cache.h"
+#include "tray_icon.h"
 #include "win32_window.h"
 
 // A window that does nothing but host a Flutter view.
@@ -25,6 +34,100 @@ class FlutterWindow : public Win32Window {
                          LPARAM const lparam) noexcept override;
 
  private:
+  struct KeystoreReply;
+
+  // Runs |work| on the keystore worker, ordered behind earlier work for the
+  // same |key_id|, and replies to |result| on the platform thread.
+  void RunKeystoreTask(
+      const std::string& key_id,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+      std::function<KeystoreReply()> work);
+
+  // Runs |work| once, ordered behind earlier work for every one of |key_ids|.
+  void RunKeystoreTask(
+      const std::vector<std::string>& key_ids,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+      std::function<KeystoreReply()> work);
+
+  // Runs |work| once per key, each ordered like RunKeystoreTask, and replies
+  // once with a map of keyId to value. The first failure wins.
+  void RunBulkKeystoreTask(
+      std::vector<std::string> key_ids,
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result,
+      std::function<KeystoreReply(const std::string&)> work);
+
+  // Handles one com.pirate.wallet/keystore_raw message; see KeystoreStream.
+  void HandleRawKeystoreMessage(const uint8_t* message, size_t size,
+                                flutter::BinaryReply reply);
+
+  // Runs |work| like RunKeystoreTask and answers |reply| with its framed
+  // outcome for |transfer_id|.
+  void RunRawKeystoreTask(const std::string& key_id, uint32_t transfer_id,
+                          flutter::BinaryReply reply,
+                          std::function<KeystoreStream::Outcome()> work);
+
+  // Tracks power, visibility, focus and session lock from window messages and
+  // forwards any change to the backend's sync throttling.
+  void TrackSyncPowerState(UINT const message, WPARAM const wparam);
+
+  // Sends the tracked state to the backend if it is loaded.
+  void ForwardSyncPowerState();
+
+  // Brings the window forward and passes a second launch's |arguments| to
+  // Dart, or holds them until Dart asks for them.
+  void HandleForwardedLaunch(std::vector<std::string> arguments);
+
+  // Close-to-tray: hides the window behind a notification-area icon and drops
+  // the process to background priority. The engine and the backend keep
+  // running, so sync carries on. Returns false if the icon could not be
+  // added, and Dart closes normally instead.
+  bool HideToTray();
+
+  // Shows the window again at normal priority.
+  void RestoreFromTray();
+
+  // Handles a click or menu on the tray icon.
+  void HandleTrayIconMessage(LPARAM const lparam);
+
+  // Warm-start snapshot: unseals the snapshot persisted by the last session
+  // on the keystore worker while the engine starts, so takeSnapshot can
+  // answer before the wallet database is open.
+  void LoadWarmSnapshot();
+
+  // Registers the warm-start hooks with the backend once it is loaded.
+  void InstallWarmSnapshotSink();
+
+  // Seals and persists |document|, or deletes the stored snapshot when it is
+  // empty.
+  void StoreWarmSnapshot(std::vector<uint8_t> document);
+
+  // Answers takeSnapshot with the loaded snapshot, then drops it.
+  void ReplyWarmSnapshot(
+      std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>> result);
+
+  // The backend's warm-start store and load hooks. Called on backend
+  // threads.
+  static void OnWarmSnapshot(const uint8_t* data, size_t length);
+  static size_t OnWarmSnapshotLoad(uint8_t* buffer, size_t capacity);
+
+  // Fast unlock: unseals the bundle of derived database keys persisted by the
+  // last session, so the backend can skip the passphrase KDF when the
+  // preference is on. The bundle is handed to the backend at most once.
+  void LoadFastUnlockBundle();
+
+  // Applies the preference sent by Dart: installs the backend hooks and
+  // policy, or removes them and deletes the stored bundle.
+  void ConfigureFastUnlock(bool enabled, uint64_t max_age_seconds);
+
+  // Seals and persists |bundle|, or deletes the stored bundle when it is
+  // empty.
+  void StoreFastUnlockBundle(std::vector<uint8_t> bundle);
+
+  // The backend's fast-unlock store and load hooks. Called on backend
+  // threads.
+  static void OnFastUnlockStore(const uint8_t* data, size_t length);
+  static size_t OnFastUnlockLoad(uint8_t* buffer, size_t capacity);
+
   // The project to run.
   flutter::DartProject project_;
 
@@ -32,6 +135,36 @@ class FlutterWindow : public Win32Window {
   std::unique_ptr<flutter::FlutterViewController> flutter_controller_;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> keystore_channel_;
   std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> security_channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> perf_channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> instance_channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> tray_channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> warm_start_channel_;
+  std::unique_ptr<flutter::MethodChannel<flutter::EncodableValue>> fast_unlock_channel_;
+  // Forwarded launches that arrived before Dart listened on instance_channel_.
+  flutter::EncodableList pending_instance_arguments_;
+  bool instance_channel_ready_ = false;
+  TrayIcon tray_icon_;
+  bool in_tray_ = false;
+  // The previous session's warm-start snapshot until Dart takes it.
+  std::vector<uint8_t> warm_snapshot_;
+  bool warm_snapshot_loaded_ = false;
+  bool warm_snapshot_sink_installed_ = false;
+  // takeSnapshot calls that arrived before the load finished.
+  std::vector<std::unique_ptr<flutter::MethodResult<flutter::EncodableValue>>>
+      pending_warm_snapshot_results_;
+  // Outlive keystore_worker_, whose tasks use them.
+  std::unique_ptr<KeystorePack> keystore_pack_;
+  MasterKeyCache master_key_cache_;
+  // Raw channel transfers; platform thread only.
+  KeystoreStream keystore_stream_;
+  // Host state last seen by TrackSyncPowerState.
+  bool on_ac_power_ = true;
+  bool window_visible_ = true;
+  bool window_focused_ = true;
+  bool session_locked_ = false;
+  bool suspended_ = false;
+  // Declared last so it is destroyed first, while the channels still exist.
+  std::unique_ptr<KeystoreWorker> keystore_worker_;
 };
 
 #endif  // RUNNER_FLUTTER_WINDOW_H_
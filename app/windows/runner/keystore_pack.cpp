@@ -0,0 +1,451 @@
+#include "keystore_pack.h"
+
+#include <cstring>
+#include <iterator>
+#include <map>
+
+namespace {
+constexpr char kPackMagic[4] = {'P', 'W', 'K', 'P'};
+constexpr uint32_t kPackVersion = 1;
+// Magic, version and record count.
+constexpr size_t kHeaderSize = sizeof(kPackMagic) + 2 * sizeof(uint32_t);
+constexpr wchar_t kPackFileName[] = L"keystore.pack";
+constexpr wchar_t kCorruptSuffix[] = L".corrupt";
+constexpr wchar_t kLegacyPrefix[] = L"key_";
+constexpr wchar_t kLegacyExtension[] = L".bin";
+
+void AppendU32(std::vector<uint8_t>* out, uint32_t value) {
+  for (int i = 0; i < 4; ++i) {
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void AppendU64(std::vector<uint8_t>* out, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    out->push_back(static_cast<uint8_t>(value >> (8 * i)));
+  }
+}
+
+void PatchU64(std::vector<uint8_t>* out, size_t at, uint64_t value) {
+  for (int i = 0; i < 8; ++i) {
+    (*out)[at + i] = static_cast<uint8_t>(value >> (8 * i));
+  }
+}
+
+// Bounds-checked little-endian reader over the mapped view.
+class Reader {
+ public:
+  Reader(const uint8_t* data, size_t size) : data_(data), size_(size) {}
+
+  bool Bytes(size_t count, const uint8_t** out) {
+    if (count > size_ - position_) {
+      return false;
+    }
+    *out = data_ + position_;
+    position_ += count;
+    return true;
+  }
+
+  bool U32(uint32_t* value) {
+    const uint8_t* bytes = nullptr;
+    if (!Bytes(4, &bytes)) {
+      return false;
+    }
+    *value = 0;
+    for (int i = 0; i < 4; ++i) {
+      *value |= static_cast<uint32_t>(bytes[i]) << (8 * i);
+    }
+    return true;
+  }
+
+  bool U64(uint64_t* value) {
+    const uint8_t* bytes = nullptr;
+    if (!Bytes(8, &bytes)) {
+      return false;
+    }
+    *value = 0;
+    for (int i = 0; i < 8; ++i) {
+      *value |= static_cast<uint64_t>(bytes[i]) << (8 * i);
+    }
+    return true;
+  }
+
+ private:
+  const uint8_t* data_;
+  size_t size_;
+  size_t position_ = 0;
+};
+
+int HexValue(wchar_t c) {
+  if (c >= L'0' && c <= L'9') {
+    return c - L'0';
+  }
+  if (c >= L'a' && c <= L'f') {
+    return c - L'a' + 10;
+  }
+  if (c >= L'A' && c <= L'F') {
+    return c - L'A' + 10;
+  }
+  return -1;
+}
+
+// Recovers the keyId from a legacy key_<hex>.bin file name.
+bool LegacyKeyId(const std::wstring& filename, std::string* key_id) {
+  const size_t prefix = std::wcslen(kLegacyPrefix);
+  const size_t extension = std::wcslen(kLegacyExtension);
+  if (filename.size() <= prefix + extension ||
+      filename.compare(0, prefix, kLegacyPrefix) != 0 ||
+      filename.compare(filename.size() - extension, extension,
+                       kLegacyExtension) != 0) {
+    return false;
+  }
+  const std::wstring hex =
+      filename.substr(prefix, filename.size() - prefix - extension);
+  if (hex.size() % 2 != 0) {
+    return false;
+  }
+  key_id->clear();
+  for (size_t i = 0; i < hex.size(); i += 2) {
+    const int high = HexValue(hex[i]);
+    const int low = HexValue(hex[i + 1]);
+    if (high < 0 || low < 0) {
+      return false;
+    }
+    key_id->push_back(static_cast<char>((high << 4) | low));
+  }
+  return true;
+}
+
+// Reads a whole file with one sized read.
+bool ReadWholeFile(const std::filesystem::path& path,
+                   std::vector<uint8_t>* data) {
+  HANDLE file = ::CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ,
+                              nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL,
+                              nullptr);
+  if (file == INVALID_HANDLE_VALUE) {
+    return false;
+  }
+  LARGE_INTEGER size;
+  bool ok = ::GetFileSizeEx(file, &size) && size.QuadPart >= 0 &&
+            static_cast<uint64_t>(size.QuadPart) <= MAXDWORD;
+  if (ok) {
+    data->resize(static_cast<size_t>(size.QuadPart));
+    DWORD read = 0;
+    ok = data->empty() ||
+         (::ReadFile(file, data->data(), static_cast<DWORD>(data->size()),
+                     &read, nullptr) &&
+          read == data->size());
+  }
+  ::CloseHandle(file);
+  return ok;
+}
+}  // namespace
+
+KeystorePack::KeystorePack(std::filesystem::path directory)
+    : directory_(std::move(directory)), path_(directory_ / kPackFileName) {}
+
+KeystorePack::~KeystorePack() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  UnmapLocked();
+}
+
+bool KeystorePack::Get(const std::string& key_id, std::vector<uint8_t>* data,
+                       bool* found, std::string* error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!EnsureLoadedLocked(error)) {
+    return false;
+  }
+  auto it = index_.find(key_id);
+  *found = it != index_.end();
+  if (*found) {
+    const uint8_t* record = view_ + it->second.offset;
+    data->assign(record, record + it->second.length);
+  }
+  return true;
+}
+
+bool KeystorePack::Contains(const std::string& key_id, bool* exists,
+                            std::string* error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!EnsureLoadedLocked(error)) {
+    return false;
+  }
+  *exists = index_.count(key_id) != 0;
+  return true;
+}
+
+bool KeystorePack::Put(const std::vector<Record>& records,
+                       std::string* error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!EnsureLoadedLocked(error)) {
+    return false;
+  }
+  std::map<std::string, std::vector<uint8_t>> merged;
+  for (auto& record : RecordsLocked()) {
+    merged[record.first] = std::move(record.second);
+  }
+  for (const auto& record : records) {
+    merged[record.first] = record.second;
+  }
+  return WriteLocked(std::vector<Record>(merged.begin(), merged.end()), error);
+}
+
+bool KeystorePack::Remove(const std::string& key_id, std::string* error) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!EnsureLoadedLocked(error)) {
+    return false;
+  }
+  if (index_.count(key_id) == 0) {
+    return true;
+  }
+  std::vector<Record> records = RecordsLocked();
+  for (auto it = records.begin(); it != records.end(); ++it) {
+    if (it->first == key_id) {
+      records.erase(it);
+      break;
+    }
+  }
+  return WriteLocked(records, error);
+}
+
+bool KeystorePack::EnsureLoadedLocked(std::string* error) {
+  if (loaded_) {
+    return true;
+  }
+  if (!MapLocked(error) && !(corrupt_ && SetAsideCorruptPackLocked(error))) {
+    // Retried on the next call.
+    UnmapLocked();
+    return false;
+  }
+  if (!MigrateLegacyFilesLocked(error)) {
+    // Retried on the next call.
+    UnmapLocked();
+    return false;
+  }
+  loaded_ = true;
+  return true;
+}
+
+bool KeystorePack::MapLocked(std::string* error) {
+  UnmapLocked();
+  corrupt_ = false;
+  file_ = ::CreateFileW(path_.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr,
+                        OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (file_ == INVALID_HANDLE_VALUE) {
+    const DWORD code = ::GetLastError();
+    if (code == ERROR_FILE_NOT_FOUND || code == ERROR_PATH_NOT_FOUND) {
+      // No pack yet: an empty keystore.
+      return true;
+    }
+    *error = "Failed to open keystore pack";
+    return false;
+  }
+
+  LARGE_INTEGER size;
+  if (!::GetFileSizeEx(file_, &size) || size.QuadPart < 0 ||
+      static_cast<uint64_t>(size.QuadPart) > SIZE_MAX) {
+    *error = "Failed to size keystore pack";
+    UnmapLocked();
+    return false;
+  }
+  view_size_ = static_cast<size_t>(size.QuadPart);
+  if (view_size_ < kHeaderSize) {
+    *error = "Keystore pack is truncated";
+    corrupt_ = true;
+    UnmapLocked();
+    return false;
+  }
+  mapping_ =
+      ::CreateFileMappingW(file_, nullptr, PAGE_READONLY, 0, 0, nullptr);
+  if (mapping_ != nullptr) {
+    view_ = static_cast<const uint8_t*>(
+        ::MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+  }
+  if (view_ == nullptr) {
+    *error = "Failed to map keystore pack";
+    UnmapLocked();
+    return false;
+  }
+
+  Reader reader(view_, view_size_);
+  const uint8_t* magic = nullptr;
+  uint32_t version = 0;
+  uint32_t count = 0;
+  if (!reader.Bytes(sizeof(kPackMagic), &magic) ||
+      std::memcmp(magic, kPackMagic, sizeof(kPackMagic)) != 0 ||
+      !reader.U32(&version) || version != kPackVersion ||
+      !reader.U32(&count)) {
+    *error = "Keystore pack has an unknown format";
+    corrupt_ = true;
+    UnmapLocked();
+    return false;
+  }
+  for (uint32_t i = 0; i < count; ++i) {
+    uint32_t key_length = 0;
+    const uint8_t* key = nullptr;
+    Span span{};
+    if (!reader.U32(&key_length) || !reader.Bytes(key_length, &key) ||
+        !reader.U64(&span.offset) || !reader.U32(&span.length) ||
+        span.offset > view_size_ || span.length > view_size_ - span.offset) {
+      *error = "Keystore pack index is corrupt";
+      corrupt_ = true;
+      UnmapLocked();
+      return false;
+    }
+    index_[std::string(reinterpret_cast<const char*>(key), key_length)] = span;
+  }
+  return true;
+}
+
+bool KeystorePack::SetAsideCorruptPackLocked(std::string* error) {
+  // Kept rather than deleted so the records can still be recovered by hand.
+  UnmapLocked();
+  std::filesystem::path corrupt_path = path_;
+  corrupt_path += kCorruptSuffix;
+  if (!::MoveFileExW(path_.c_str(), corrupt_path.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    *error = "Failed to set aside corrupt keystore pack";
+    return false;
+  }
+  corrupt_ = false;
+  return true;
+}
+
+void KeystorePack::UnmapLocked() {
+  if (view_ != nullptr) {
+    ::UnmapViewOfFile(view_);
+    view_ = nullptr;
+  }
+  if (mapping_ != nullptr) {
+    ::CloseHandle(mapping_);
+    mapping_ = nullptr;
+  }
+  if (file_ != INVALID_HANDLE_VALUE) {
+    ::CloseHandle(file_);
+    file_ = INVALID_HANDLE_VALUE;
+  }
+  view_size_ = 0;
+  index_.clear();
+}
+
+bool KeystorePack::MigrateLegacyFilesLocked(std::string* error) {
+  std::vector<Record> legacy;
+  std::vector<std::filesystem::path> legacy_paths;
+  std::error_code ec;
+  for (std::filesystem::directory_iterator it(directory_, ec), end;
+       !ec && it != end; it.increment(ec)) {
+    std::string key_id;
+    if (!it->is_regular_file(ec) ||
+        !LegacyKeyId(it->path().filename().wstring(), &key_id)) {
+      continue;
+    }
+    std::vector<uint8_t> data;
+    if (!ReadWholeFile(it->path(), &data)) {
+      *error = "Failed to read legacy keystore file";
+      return false;
+    }
+    legacy_paths.push_back(it->path());
+    // A record already in the pack was written after the legacy file.
+    if (index_.count(key_id) == 0) {
+      legacy.emplace_back(std::move(key_id), std::move(data));
+    }
+  }
+  if (legacy_paths.empty()) {
+    return true;
+  }
+
+  if (!legacy.empty()) {
+    std::vector<Record> records = RecordsLocked();
+    records.insert(records.end(), std::make_move_iterator(legacy.begin()),
+                   std::make_move_iterator(legacy.end()));
+    if (!WriteLocked(records, error)) {
+      return false;
+    }
+  }
+  // The pack now holds every legacy key; a file left behind by a failed
+  // delete is skipped by the index check next time.
+  for (const auto& path : legacy_paths) {
+    std::filesystem::remove(path, ec);
+  }
+  return true;
+}
+
+std::vector<KeystorePack::Record> KeystorePack::RecordsLocked() const {
+  std::vector<Record> records;
+  records.reserve(index_.size());
+  for (const auto& entry : index_) {
+    const uint8_t* record = view_ + entry.second.offset;
+    records.emplace_back(
+        entry.first,
+        std::vector<uint8_t>(record, record + entry.second.length));
+  }
+  return records;
+}
+
+bool KeystorePack::WriteLocked(const std::vector<Record>& records,
+                               std::string* error) {
+  std::vector<uint8_t> buffer(kPackMagic, kPackMagic + sizeof(kPackMagic));
+  AppendU32(&buffer, kPackVersion);
+  AppendU32(&buffer, static_cast<uint32_t>(records.size()));
+  std::vector<size_t> offset_slots;
+  offset_slots.reserve(records.size());
+  for (const auto& record : records) {
+    AppendU32(&buffer, static_cast<uint32_t>(record.first.size()));
+    buffer.insert(buffer.end(), record.first.begin(), record.first.end());
+    offset_slots.push_back(buffer.size());
+    AppendU64(&buffer, 0);
+    AppendU32(&buffer, static_cast<uint32_t>(record.second.size()));
+  }
+  for (size_t i = 0; i < records.size(); ++i) {
+    PatchU64(&buffer, offset_slots[i], buffer.size());
+    buffer.insert(buffer.end(), records[i].second.begin(),
+                  records[i].second.end());
+  }
+  if (buffer.size() > MAXDWORD) {
+    *error = "Keystore pack is too large";
+    return false;
+  }
+
+  std::error_code ec;
+  std::filesystem::create_directories(directory_, ec);
+  if (ec) {
+    *error = "Failed to create keystore directory";
+    return false;
+  }
+  std::filesystem::path temp_path = path_;
+  temp_path += L".tmp";
+  HANDLE temp = ::CreateFileW(temp_path.c_str(), GENERIC_WRITE, 0, nullptr,
+                              CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+  if (temp == INVALID_HANDLE_VALUE) {
+    *error = "Failed to open keystore file";
+    return false;
+  }
+  DWORD written = 0;
+  const bool wrote =
+      ::WriteFile(temp, buffer.data(), static_cast<DWORD>(buffer.size()),
+                  &written, nullptr) &&
+      written == buffer.size() && ::FlushFileBuffers(temp);
+  ::CloseHandle(temp);
+  if (!wrote) {
+    ::DeleteFileW(temp_path.c_str());
+    *error = "Failed to write keystore file";
+    return false;
+  }
+
+  // A mapped file cannot be replaced, so drop the view for the swap. On
+  // failure the old pack is still in place and is mapped again.
+  UnmapLocked();
+  if (!::MoveFileExW(temp_path.c_str(), path_.c_str(),
+                     MOVEFILE_REPLACE_EXISTING | MOVEFILE_WRITE_THROUGH)) {
+    ::DeleteFileW(temp_path.c_str());
+    std::string ignored;
+    loaded_ = loaded_ && MapLocked(&ignored);
+    *error = "Failed to replace keystore pack";
+    return false;
+  }
+  if (!MapLocked(error)) {
+    loaded_ = false;
+    return false;
+  }
+  return true;
+}
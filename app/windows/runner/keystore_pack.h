@@ -0,0 +1,78 @@
+#ifndef RUNNER_KEYSTORE_PACK_H_
+#define RUNNER_KEYSTORE_PACK_H_
+
+#include <windows.h>
+
+#include <cstdint>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+// All keystore records in one file, keystore.pack, instead of one
+// key_<hex>.bin file per key.
+//
+// The file is a small header and index followed by the DPAPI-protected
+// records. It is loaded once and kept memory-mapped, so lookups and existence
+// checks never touch the filesystem. Updates write a complete new pack next to
+// the old one and move it into place, so readers see either the old or the new
+// contents. On first use, legacy per-key files are folded into the pack and
+// deleted. A pack that fails to parse is moved aside to keystore.pack.corrupt
+// and the keystore starts empty, rather than failing every later call.
+//
+// Records are stored as given; callers protect and unprotect them. All methods
+// are thread-safe.
+class KeystorePack {
+ public:
+  using Record = std::pair<std::string, std::vector<uint8_t>>;
+
+  explicit KeystorePack(std::filesystem::path directory);
+  ~KeystorePack();
+
+  KeystorePack(const KeystorePack&) = delete;
+  KeystorePack& operator=(const KeystorePack&) = delete;
+
+  // Copies the record for |key_id| into |data|. |found| is false if there is
+  // no such record. Returns false with |error| set if the pack is unreadable.
+  bool Get(const std::string& key_id, std::vector<uint8_t>* data, bool* found,
+           std::string* error);
+
+  // Sets |exists| to whether |key_id| has a record.
+  bool Contains(const std::string& key_id, bool* exists, std::string* error);
+
+  // Adds or replaces |records| in a single atomic rewrite.
+  bool Put(const std::vector<Record>& records, std::string* error);
+
+  // Removes |key_id|. Removing a missing key succeeds without a rewrite.
+  bool Remove(const std::string& key_id, std::string* error);
+
+ private:
+  struct Span {
+    uint64_t offset;
+    uint32_t length;
+  };
+
+  bool EnsureLoadedLocked(std::string* error);
+  bool MapLocked(std::string* error);
+  bool SetAsideCorruptPackLocked(std::string* error);
+  void UnmapLocked();
+  bool MigrateLegacyFilesLocked(std::string* error);
+  std::vector<Record> RecordsLocked() const;
+  bool WriteLocked(const std::vector<Record>& records, std::string* error);
+
+  std::mutex mutex_;
+  std::filesystem::path directory_;
+  std::filesystem::path path_;
+  bool loaded_ = false;
+  // Set by MapLocked when the file exists but does not parse.
+  bool corrupt_ = false;
+  HANDLE file_ = INVALID_HANDLE_VALUE;
+  HANDLE mapping_ = nullptr;
+  const uint8_t* view_ = nullptr;
+  size_t view_size_ = 0;
+  std::unordered_map<std::string, Span> index_;
+};
+
+#endif  // RUNNER_KEYSTORE_PACK_H_
@@ -0,0 +1,211 @@
+#include "keystore_stream.h"
+
+#include <windows.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace {
+uint16_t ReadU16(const uint8_t* bytes) {
+  return static_cast<uint16_t>(bytes[0] | (bytes[1] << 8));
+}
+
+uint32_t ReadU32(const uint8_t* bytes) {
+  return static_cast<uint32_t>(bytes[0]) |
+         (static_cast<uint32_t>(bytes[1]) << 8) |
+         (static_cast<uint32_t>(bytes[2]) << 16) |
+         (static_cast<uint32_t>(bytes[3]) << 24);
+}
+
+void WriteU32(uint8_t* bytes, uint32_t value) {
+  bytes[0] = static_cast<uint8_t>(value);
+  bytes[1] = static_cast<uint8_t>(value >> 8);
+  bytes[2] = static_cast<uint8_t>(value >> 16);
+  bytes[3] = static_cast<uint8_t>(value >> 24);
+}
+}  // namespace
+
+KeystoreStream::~KeystoreStream() {
+  Clear();
+}
+
+bool KeystoreStream::ParseRequest(const uint8_t* message, size_t size,
+                                  Request* request) {
+  if (message == nullptr || size < kHeaderBytes) {
+    return false;
+  }
+  const uint8_t op = message[0];
+  if (op < static_cast<uint8_t>(Op::kStore) ||
+      op > static_cast<uint8_t>(Op::kCancel)) {
+    return false;
+  }
+  const size_t key_id_length = ReadU16(message + 2);
+  if (key_id_length > size - kHeaderBytes) {
+    return false;
+  }
+  request->op = static_cast<Op>(op);
+  request->final = (message[1] & kFlagFinal) != 0;
+  request->transfer_id = ReadU32(message + 4);
+  request->total_length = ReadU32(message + 8);
+  request->offset = ReadU32(message + 12);
+  request->key_id.assign(reinterpret_cast<const char*>(message + kHeaderBytes),
+                         key_id_length);
+  request->chunk = message + kHeaderBytes + key_id_length;
+  request->chunk_length = size - kHeaderBytes - key_id_length;
+  return true;
+}
+
+std::vector<uint8_t> KeystoreStream::EncodeReply(Status status,
+                                                 uint32_t transfer_id,
+                                                 uint32_t total_length,
+                                                 uint32_t offset,
+                                                 const uint8_t* data,
+                                                 size_t length) {
+  std::vector<uint8_t> reply(kHeaderBytes + length, 0);
+  reply[0] = static_cast<uint8_t>(status);
+  WriteU32(reply.data() + 4, transfer_id);
+  WriteU32(reply.data() + 8, total_length);
+  WriteU32(reply.data() + 12, offset);
+  if (length > 0) {
+    std::memcpy(reply.data() + kHeaderBytes, data, length);
+  }
+  return reply;
+}
+
+std::vector<uint8_t> KeystoreStream::EncodeError(uint32_t transfer_id,
+                                                 const std::string& message) {
+  return EncodeReply(Status::kError, transfer_id, 0, 0,
+                     reinterpret_cast<const uint8_t*>(message.data()),
+                     message.size());
+}
+
+void KeystoreStream::Wipe(std::vector<uint8_t>* data) {
+  if (!data->empty()) {
+    ::SecureZeroMemory(data->data(), data->size());
+  }
+  data->clear();
+  data->shrink_to_fit();
+}
+
+bool KeystoreStream::AppendUpload(const Request& request,
+                                  std::vector<uint8_t>* payload,
+                                  std::string* error) {
+  auto it = transfers_.find(request.transfer_id);
+  if (request.offset == 0) {
+    // A first chunk restarts the transfer.
+    if (it != transfers_.end()) {
+      Cancel(request.transfer_id);
+    }
+    if (request.total_length > kMaxPayloadBytes) {
+      *error = "Keystore payload too large";
+      return false;
+    }
+    if (transfers_.size() >= kMaxTransfers) {
+      *error = "Too many keystore transfers";
+      return false;
+    }
+    Transfer transfer;
+    transfer.upload = true;
+    transfer.key_id = request.key_id;
+    transfer.total_length = request.total_length;
+    transfer.data.reserve(request.total_length);
+    it = transfers_.emplace(request.transfer_id, std::move(transfer)).first;
+  } else if (it == transfers_.end() || !it->second.upload) {
+    *error = "Unknown keystore transfer";
+    return false;
+  }
+
+  Transfer& transfer = it->second;
+  const size_t received = transfer.data.size();
+  if (request.offset != received ||
+      request.total_length != transfer.total_length ||
+      request.key_id != transfer.key_id ||
+      request.chunk_length > transfer.total_length - received) {
+    Cancel(request.transfer_id);
+    *error = "Keystore chunk out of order";
+    return false;
+  }
+  transfer.data.insert(transfer.data.end(), request.chunk,
+                       request.chunk + request.chunk_length);
+  if (!request.final) {
+    return true;
+  }
+  if (transfer.data.size() != transfer.total_length) {
+    Cancel(request.transfer_id);
+    *error = "Keystore payload incomplete";
+    return false;
+  }
+  *payload = std::move(transfer.data);
+  transfers_.erase(it);
+  return true;
+}
+
+std::vector<uint8_t> KeystoreStream::Complete(uint32_t transfer_id,
+                                              Outcome outcome) {
+  if (outcome.status == Status::kError) {
+    return EncodeError(transfer_id, outcome.error);
+  }
+  if (outcome.status != Status::kOk) {
+    return EncodeReply(outcome.status, transfer_id, 0, 0, nullptr, 0);
+  }
+  if (outcome.data.size() > kMaxPayloadBytes) {
+    Wipe(&outcome.data);
+    return EncodeError(transfer_id, "Keystore payload too large");
+  }
+  const uint32_t total = static_cast<uint32_t>(outcome.data.size());
+  if (total <= kChunkBytes) {
+    std::vector<uint8_t> reply = EncodeReply(
+        Status::kOk, transfer_id, total, 0, outcome.data.data(), total);
+    Wipe(&outcome.data);
+    return reply;
+  }
+  if (transfers_.size() >= kMaxTransfers ||
+      transfers_.count(transfer_id) != 0) {
+    Wipe(&outcome.data);
+    return EncodeError(transfer_id, "Too many keystore transfers");
+  }
+  std::vector<uint8_t> reply = EncodeReply(
+      Status::kOk, transfer_id, total, 0, outcome.data.data(), kChunkBytes);
+  Transfer transfer;
+  transfer.total_length = total;
+  transfer.data = std::move(outcome.data);
+  transfers_.emplace(transfer_id, std::move(transfer));
+  return reply;
+}
+
+std::vector<uint8_t> KeystoreStream::Read(uint32_t transfer_id,
+                                          uint32_t offset) {
+  auto it = transfers_.find(transfer_id);
+  if (it == transfers_.end() || it->second.upload) {
+    return EncodeError(transfer_id, "Unknown keystore transfer");
+  }
+  const Transfer& transfer = it->second;
+  if (offset >= transfer.total_length) {
+    Cancel(transfer_id);
+    return EncodeError(transfer_id, "Keystore read past end");
+  }
+  const uint32_t length = std::min(kChunkBytes, transfer.total_length - offset);
+  std::vector<uint8_t> reply =
+      EncodeReply(Status::kOk, transfer_id, transfer.total_length, offset,
+                  transfer.data.data() + offset, length);
+  if (offset + length == transfer.total_length) {
+    Cancel(transfer_id);
+  }
+  return reply;
+}
+
+void KeystoreStream::Cancel(uint32_t transfer_id) {
+  auto it = transfers_.find(transfer_id);
+  if (it == transfers_.end()) {
+    return;
+  }
+  Wipe(&it->second.data);
+  transfers_.erase(it);
+}
+
+void KeystoreStream::Clear() {
+  for (auto& entry : transfers_) {
+    Wipe(&entry.second.data);
+  }
+  transfers_.clear();
+}
@@ -0,0 +1,123 @@
+#ifndef RUNNER_KEYSTORE_STREAM_H_
+#define RUNNER_KEYSTORE_STREAM_H_
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// Framing and transfer state for com.pirate.wallet/keystore_raw, the binary
+// channel for large keystore payloads (seed and key exports, watch-only
+// bundles, backup archives).
+//
+// Every message is a fixed 16-byte little-endian header followed by the body,
+// so nothing is decoded through StandardMessageCodec maps. Requests:
+//
+//   u8 op | u8 flags | u16 key_id_length | u32 transfer_id |
+//   u32 total_length | u32 offset | key_id (UTF-8) | chunk
+//
+// Replies:
+//
+//   u8 status | u8[3] 0 | u32 transfer_id | u32 total_length | u32 offset |
+//   chunk, or a UTF-8 message when status is kError
+//
+// Payloads move in chunks of at most kChunkBytes. A store sends its chunks in
+// order and marks the last with kFlagFinal; a retrieve answers with the first
+// chunk and the total length, and Dart asks for the rest with kRead. Each side
+// holds one copy of the payload plus one chunk, however large it is.
+//
+// Not thread-safe; used on the platform thread only.
+class KeystoreStream {
+ public:
+  enum class Op : uint8_t {
+    kStore = 1,
+    kRetrieve = 2,
+    kRead = 3,
+    kCancel = 4,
+  };
+
+  enum class Status : uint8_t {
+    kOk = 0,
+    kNotFound = 1,
+    kError = 2,
+  };
+
+  static constexpr size_t kHeaderBytes = 16;
+  static constexpr uint32_t kChunkBytes = 256 * 1024;
+  static constexpr uint32_t kMaxPayloadBytes = 64 * 1024 * 1024;
+  static constexpr uint8_t kFlagFinal = 0x01;
+
+  // A parsed request; |chunk| points into the message it came from.
+  struct Request {
+    Op op = Op::kCancel;
+    bool final = false;
+    uint32_t transfer_id = 0;
+    uint32_t total_length = 0;
+    uint32_t offset = 0;
+    std::string key_id;
+    const uint8_t* chunk = nullptr;
+    size_t chunk_length = 0;
+  };
+
+  // Outcome of keystore work for one transfer.
+  struct Outcome {
+    Status status = Status::kOk;
+    std::vector<uint8_t> data;
+    std::string error;
+  };
+
+  KeystoreStream() = default;
+  ~KeystoreStream();
+
+  KeystoreStream(const KeystoreStream&) = delete;
+  KeystoreStream& operator=(const KeystoreStream&) = delete;
+
+  // Returns false if |message| is too short or its lengths do not add up.
+  static bool ParseRequest(const uint8_t* message, size_t size,
+                           Request* request);
+
+  static std::vector<uint8_t> EncodeReply(Status status, uint32_t transfer_id,
+                                          uint32_t total_length,
+                                          uint32_t offset, const uint8_t* data,
+                                          size_t length);
+  static std::vector<uint8_t> EncodeError(uint32_t transfer_id,
+                                          const std::string& message);
+
+  // Zeroes |data| before releasing it.
+  static void Wipe(std::vector<uint8_t>* data);
+
+  // Appends a store chunk in place. When |request| is the final chunk,
+  // moves the whole payload to |payload| and forgets the transfer.
+  bool AppendUpload(const Request& request, std::vector<uint8_t>* payload,
+                    std::string* error);
+
+  // Reply for a finished transfer. A retrieved payload larger than one chunk
+  // is kept for kRead and its first chunk returned.
+  std::vector<uint8_t> Complete(uint32_t transfer_id, Outcome outcome);
+
+  // Reply with the chunk at |offset| of a retrieved payload. The transfer is
+  // dropped after its last chunk.
+  std::vector<uint8_t> Read(uint32_t transfer_id, uint32_t offset);
+
+  // Drops |transfer_id| and wipes whatever it held.
+  void Cancel(uint32_t transfer_id);
+
+  // Drops every transfer.
+  void Clear();
+
+ private:
+  // Uploads and downloads in flight at once, bounding memory held for Dart.
+  static constexpr size_t kMaxTransfers = 4;
+
+  struct Transfer {
+    bool upload = false;
+    std::string key_id;
+    uint32_t total_length = 0;
+    std::vector<uint8_t> data;
+  };
+
+  std::unordered_map<uint32_t, Transfer> transfers_;
+};
+
+#endif  // RUNNER_KEYSTORE_STREAM_H_
@@ -0,0 +1,155 @@
+#include "keystore_worker.h"
+
+#include <algorithm>
+#include <utility>
+
+namespace {
+// Unordered tasks get a private key of their own. The prefix cannot collide
+// with a keyId because keyIds from Dart never contain NUL.
+constexpr char kUnorderedKeyPrefix[] = "\0unordered:";
+}  // namespace
+
+KeystoreWorker::KeystoreWorker(size_t thread_count) {
+  if (thread_count == 0) {
+    thread_count = 1;
+  }
+  threads_.reserve(thread_count);
+  for (size_t i = 0; i < thread_count; ++i) {
+    threads_.emplace_back([this]() { Run(); });
+  }
+}
+
+KeystoreWorker::~KeystoreWorker() {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    stopping_ = true;
+  }
+  ready_cv_.notify_all();
+  for (auto& thread : threads_) {
+    thread.join();
+  }
+
+  // Everything still queued never started. A joint sits in several queues;
+  // moving its callback out answers it once.
+  std::vector<Task> dropped;
+  for (auto& queue : queues_) {
+    for (auto& entry : queue.second) {
+      Task& on_drop =
+          entry.joint != nullptr ? entry.joint->on_drop : entry.on_drop;
+      if (on_drop) {
+        dropped.push_back(std::move(on_drop));
+        on_drop = nullptr;
+      }
+    }
+  }
+  ready_.clear();
+  queues_.clear();
+  for (auto& on_drop : dropped) {
+    on_drop();
+  }
+}
+
+void KeystoreWorker::Post(const std::string& key, Task task, Task on_drop) {
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (stopping_) {
+      return;
+    }
+    std::string queue_key = key;
+    if (queue_key.empty()) {
+      queue_key.assign(kUnorderedKeyPrefix, sizeof(kUnorderedKeyPrefix) - 1);
+      queue_key.append(std::to_string(unordered_sequence_++));
+    }
+    auto& queue = queues_[queue_key];
+    queue.push_back(Entry{std::move(task), std::move(on_drop), nullptr});
+    if (queue.size() == 1) {
+      ActivateLocked(queue_key, queue.front());
+    }
+  }
+}
+
+void KeystoreWorker::PostAll(const std::vector<std::string>& keys, Task task,
+                             Task on_drop) {
+  std::vector<std::string> unique_keys;
+  for (const auto& key : keys) {
+    if (std::find(unique_keys.begin(), unique_keys.end(), key) ==
+        unique_keys.end()) {
+      unique_keys.push_back(key);
+    }
+  }
+  if (unique_keys.empty()) {
+    Post(std::string(), std::move(task), std::move(on_drop));
+    return;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (stopping_) {
+    return;
+  }
+  auto joint = std::make_shared<Joint>();
+  joint->task = std::move(task);
+  joint->on_drop = std::move(on_drop);
+  joint->keys = std::move(unique_keys);
+  joint->waiting = joint->keys.size();
+  // Every share is queued under one lock, so two joints sharing keys are in
+  // the same order on each queue and cannot wait on each other.
+  for (const auto& key : joint->keys) {
+    auto& queue = queues_[key];
+    queue.push_back(Entry{nullptr, nullptr, joint});
+    if (queue.size() == 1) {
+      ActivateLocked(key, queue.front());
+    }
+  }
+}
+
+void KeystoreWorker::ActivateLocked(const std::string& key,
+                                    const Entry& entry) {
+  if (entry.joint == nullptr) {
+    ready_.push_back(Ready{key, nullptr});
+  } else if (--entry.joint->waiting == 0) {
+    ready_.push_back(Ready{std::string(), entry.joint});
+  } else {
+    return;
+  }
+  ready_cv_.notify_one();
+}
+
+void KeystoreWorker::AdvanceLocked(const std::string& key) {
+  auto queue = queues_.find(key);
+  queue->second.pop_front();
+  if (queue->second.empty()) {
+    queues_.erase(queue);
+  } else {
+    ActivateLocked(key, queue->second.front());
+  }
+}
+
+void KeystoreWorker::Run() {
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true) {
+    ready_cv_.wait(lock, [this]() { return stopping_ || !ready_.empty(); });
+    if (stopping_) {
+      // Queued tasks are left for the destructor to drop.
+      return;
+    }
+
+    Ready ready = std::move(ready_.front());
+    ready_.pop_front();
+    Task task = ready.joint != nullptr
+                    ? std::move(ready.joint->task)
+                    : std::move(queues_.find(ready.key)->second.front().task);
+
+    lock.unlock();
+    task();
+    task = nullptr;
+    lock.lock();
+
+    if (ready.joint != nullptr) {
+      for (const auto& key : ready.joint->keys) {
+        AdvanceLocked(key);
+      }
+    } else {
+      AdvanceLocked(ready.key);
+    }
+  }
+}
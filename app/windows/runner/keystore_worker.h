@@ -0,0 +1,86 @@
+#ifndef RUNNER_KEYSTORE_WORKER_H_
+#define RUNNER_KEYSTORE_WORKER_H_
+
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// A small thread pool for keystore work (DPAPI and file I/O) that must not run
+// on the platform thread.
+//
+// Tasks posted with the same key run one at a time in submission order, so
+// writes and reads of one keyId never race. Tasks for different keys run in
+// parallel across the pool.
+//
+// The destructor lets running tasks finish. Tasks that never started are not
+// run; their |on_drop| callbacks run instead, on the destroying thread, so
+// callers can answer whoever is waiting on them.
+class KeystoreWorker {
+ public:
+  using Task = std::function<void()>;
+
+  explicit KeystoreWorker(size_t thread_count);
+  ~KeystoreWorker();
+
+  KeystoreWorker(const KeystoreWorker&) = delete;
+  KeystoreWorker& operator=(const KeystoreWorker&) = delete;
+
+  // Queues |task| behind any pending task with the same |key|. An empty |key|
+  // means the task is not ordered against anything else. |on_drop| runs
+  // instead of |task| if the worker is destroyed before |task| starts.
+  void Post(const std::string& key, Task task, Task on_drop = nullptr);
+
+  // Queues |task| behind pending tasks for every one of |keys|. It runs once
+  // it reaches the front of all of those queues and holds them until done,
+  // so it is ordered against single-key tasks on each of them.
+  void PostAll(const std::vector<std::string>& keys, Task task,
+               Task on_drop = nullptr);
+
+ private:
+  // A PostAll task, waiting at the front of |waiting| more queues.
+  struct Joint {
+    Task task;
+    Task on_drop;
+    std::vector<std::string> keys;
+    size_t waiting = 0;
+  };
+
+  // One queue slot: a single-key task, or a share of a Joint.
+  struct Entry {
+    Task task;
+    Task on_drop;
+    std::shared_ptr<Joint> joint;
+  };
+
+  // A task whose turn has come: the front of |key|, or a whole Joint.
+  struct Ready {
+    std::string key;
+    std::shared_ptr<Joint> joint;
+  };
+
+  void Run();
+  // Called with |mutex_| held when |entry| reaches the front of |key|.
+  void ActivateLocked(const std::string& key, const Entry& entry);
+  // Called with |mutex_| held after the front task of |key| finished.
+  void AdvanceLocked(const std::string& key);
+
+  std::mutex mutex_;
+  std::condition_variable ready_cv_;
+  // Tasks waiting for a thread.
+  std::deque<Ready> ready_;
+  // Pending tasks per key. A key stays in the map while its front task runs,
+  // which is what keeps later tasks for it off other threads.
+  std::unordered_map<std::string, std::deque<Entry>> queues_;
+  uint64_t unordered_sequence_ = 0;
+  bool stopping_ = false;
+  std::vector<std::thread> threads_;
+};
+
+#endif  // RUNNER_KEYSTORE_WORKER_H_
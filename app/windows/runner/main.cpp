@@ -2,9 +2,12 @@
 #include <flutter/flutter_view_controller.h>
 #include <flutter_windows.h>
 #include <cmath>
+#include <thread>
 #include <windows.h>
 
 #include "flutter_window.h"
+#include "perf_timeline.h"
+#include "single_instance.h"
 #include "utils.h"
 
 namespace {
@@ -12,6 +15,26 @@ constexpr double kPreferredWindowWidth = 1180.0;
 constexpr double kPreferredWindowHeight = 760.0;
 constexpr double kVisibleMargin = 48.0;
 constexpr double kMaxVisibleFraction = 0.92;
+constexpr wchar_t kBackendLibrary[] = L"pirate_ffi_frb.dll";
+
+// Loads the Rust backend and warms it (registry and block cache pages)
+// while the Flutter engine starts, so Dart's first call lands on a hot
+// backend. The library stays loaded; Dart opens the same module by name.
+std::thread StartBackendPrewarm() {
+  return std::thread([]() {
+    PerfSpan span("backend_prewarm");
+    HMODULE backend = ::LoadLibraryW(kBackendLibrary);
+    if (backend == nullptr) {
+      return;
+    }
+    using PrewarmFn = void (*)();
+    auto prewarm = reinterpret_cast<PrewarmFn>(
+        ::GetProcAddress(backend, "pirate_prewarm"));
+    if (prewarm != nullptr) {
+      prewarm();
+    }
+  });
+}
 
 double AvailableExtent(double visible_extent) {
   if (visible_extent <= 0) {
@@ -67,15 +90,33 @@ Win32Window::Size ResolveInitialWindowSize(const Win32Window::Point& origin) {
 
 int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
                       _In_ wchar_t *command_line, _In_ int show_command) {
+  PerfMark("wWinMain");
+
   // Attach to console when present (e.g., 'flutter run') or create a
   // new console when running with a debugger.
   if (!::AttachConsole(ATTACH_PARENT_PROCESS) && ::IsDebuggerPresent()) {
     CreateAndAttachConsole();
   }
 
+  // A second launch hands its arguments to the running wallet and exits
+  // before it starts an engine or touches the wallet files.
+  SingleInstance single_instance;
+  if (!single_instance.is_primary()) {
+    // A launch the primary never received (a hung or exiting window) is
+    // reported to whoever started this process.
+    return single_instance.ForwardToPrimary(GetCommandLineArguments())
+               ? EXIT_SUCCESS
+               : EXIT_FAILURE;
+  }
+
   // Initialize COM, so that it is available for use in the library and/or
   // plugins.
-  ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  {
+    PerfSpan span("CoInitializeEx");
+    ::CoInitializeEx(nullptr, COINIT_APARTMENTTHREADED);
+  }
+
+  std::thread prewarm = StartBackendPrewarm();
 
   flutter::DartProject project(L"data");
 
@@ -87,10 +128,17 @@ int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
   FlutterWindow window(project);
   Win32Window::Point origin(10, 10);
   Win32Window::Size size = ResolveInitialWindowSize(origin);
-  if (!window.Create(L"app", origin, size)) {
+  bool created;
+  {
+    PerfSpan span("window_create");
+    created = window.Create(L"app", origin, size);
+  }
+  if (!created) {
+    prewarm.join();
     return EXIT_FAILURE;
   }
   window.SetQuitOnClose(true);
+  SingleInstance::MarkPrimaryWindow(window.GetHandle());
 
   ::MSG msg;
   while (::GetMessage(&msg, nullptr, 0, 0)) {
@@ -98,6 +146,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE instance, _In_opt_ HINSTANCE prev,
     ::DispatchMessage(&msg);
   }
 
+  prewarm.join();
   ::CoUninitialize();
   return EXIT_SUCCESS;
 }
@@ -0,0 +1,101 @@
+#include "master_key_cache.h"
+
+#include <cstring>
+
+MasterKeyCache::~MasterKeyCache() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ClearLocked();
+}
+
+void MasterKeyCache::SetIdleTtl(std::chrono::milliseconds ttl) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  ttl_ = ttl.count() > 0 ? ttl : std::chrono::milliseconds(0);
+  if (ttl_.count() == 0) {
+    ClearLocked();
+  }
+}
+
+bool MasterKeyCache::enabled() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ttl_.count() > 0;
+}
+
+uint64_t MasterKeyCache::generation() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return generation_;
+}
+
+void MasterKeyCache::Put(const std::vector<uint8_t>& sealed,
+                         const std::vector<uint8_t>& plaintext,
+                         uint64_t generation) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (generation != generation_) {
+    return;
+  }
+  ClearLocked();
+  if (ttl_.count() == 0 || plaintext.empty()) {
+    return;
+  }
+
+  void* memory = ::VirtualAlloc(nullptr, plaintext.size(),
+                                MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+  if (memory == nullptr) {
+    return;
+  }
+  if (!::VirtualLock(memory, plaintext.size())) {
+    // Refuse to cache a key that could be paged out to disk.
+    ::VirtualFree(memory, 0, MEM_RELEASE);
+    return;
+  }
+  plaintext_ = static_cast<uint8_t*>(memory);
+  allocation_size_ = plaintext.size();
+  plaintext_length_ = plaintext.size();
+  std::memcpy(plaintext_, plaintext.data(), plaintext.size());
+  sealed_ = sealed;
+  last_used_ = Clock::now();
+}
+
+bool MasterKeyCache::Get(const std::vector<uint8_t>& sealed,
+                         std::vector<uint8_t>* plaintext) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (plaintext_ == nullptr || sealed != sealed_) {
+    return false;
+  }
+  const auto now = Clock::now();
+  if (ExpiredLocked(now)) {
+    ClearLocked();
+    return false;
+  }
+  plaintext->assign(plaintext_, plaintext_ + plaintext_length_);
+  last_used_ = now;
+  return true;
+}
+
+void MasterKeyCache::EvictIfIdle() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (plaintext_ != nullptr && ExpiredLocked(Clock::now())) {
+    ClearLocked();
+  }
+}
+
+void MasterKeyCache::Clear() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  generation_++;
+  ClearLocked();
+}
+
+void MasterKeyCache::ClearLocked() {
+  if (plaintext_ != nullptr) {
+    ::SecureZeroMemory(plaintext_, allocation_size_);
+    ::VirtualUnlock(plaintext_, allocation_size_);
+    ::VirtualFree(plaintext_, 0, MEM_RELEASE);
+  }
+  plaintext_ = nullptr;
+  plaintext_length_ = 0;
+  allocation_size_ = 0;
+  sealed_.clear();
+}
+
+bool MasterKeyCache::ExpiredLocked(Clock::time_point now) const {
+  return ttl_.count() == 0 || now - last_used_ > ttl_;
+}
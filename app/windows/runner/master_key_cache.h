@@ -0,0 +1,64 @@
+#ifndef RUNNER_MASTER_KEY_CACHE_H_
+#define RUNNER_MASTER_KEY_CACHE_H_
+
+#include <windows.h>
+
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+// Keeps the most recently unsealed master key so a re-unlock within the idle
+// TTL is a memory read instead of a CryptUnprotectData round trip.
+//
+// The plaintext lives in VirtualLock'ed pages that are wiped with
+// SecureZeroMemory whenever the entry is evicted. The cache is disabled until
+// SetIdleTtl is called with a non-zero TTL. All methods are thread-safe.
+class MasterKeyCache {
+ public:
+  MasterKeyCache() = default;
+  ~MasterKeyCache();
+
+  MasterKeyCache(const MasterKeyCache&) = delete;
+  MasterKeyCache& operator=(const MasterKeyCache&) = delete;
+
+  // Sets the idle TTL. Zero disables the cache and wipes any entry.
+  void SetIdleTtl(std::chrono::milliseconds ttl);
+  bool enabled();
+
+  // Bumped by every Clear. Read it before starting an unseal and pass it to
+  // Put, so an unseal that overlaps a clear cannot repopulate the cache.
+  uint64_t generation();
+
+  // Remembers |plaintext| as the unsealed form of |sealed|, unless the cache
+  // was cleared since |generation| was read.
+  void Put(const std::vector<uint8_t>& sealed,
+           const std::vector<uint8_t>& plaintext, uint64_t generation);
+
+  // Copies the cached plaintext for |sealed| into |plaintext| and restarts the
+  // idle timer. Returns false on a miss or after the TTL has elapsed.
+  bool Get(const std::vector<uint8_t>& sealed, std::vector<uint8_t>* plaintext);
+
+  // Wipes the entry if it has been idle for longer than the TTL.
+  void EvictIfIdle();
+
+  // Wipes the entry unconditionally.
+  void Clear();
+
+ private:
+  using Clock = std::chrono::steady_clock;
+
+  void ClearLocked();
+  bool ExpiredLocked(Clock::time_point now) const;
+
+  std::mutex mutex_;
+  std::chrono::milliseconds ttl_{0};
+  uint64_t generation_ = 0;
+  std::vector<uint8_t> sealed_;
+  uint8_t* plaintext_ = nullptr;
+  size_t plaintext_length_ = 0;
+  size_t allocation_size_ = 0;
+  Clock::time_point last_used_;
+};
+
+#endif  // RUNNER_MASTER_KEY_CACHE_H_
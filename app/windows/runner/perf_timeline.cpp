@@ -0,0 +1,164 @@
+#include "perf_timeline.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <utility>
+#include <vector>
+
+namespace {
+// FILETIME counts 100ns ticks since 1601; Unix time starts in 1970.
+constexpr int64_t kUnixEpochInFileTime = 116444736000000000LL;
+// Keeps a runaway caller from growing the timeline without bound.
+constexpr size_t kMaxEvents = 1024;
+
+struct PerfEvent {
+  std::string name;
+  char phase;
+  int64_t ts_us;
+  int64_t dur_us;
+  DWORD tid;
+};
+
+int64_t FileTimeToUnixMicros(const FILETIME& time) {
+  ULARGE_INTEGER ticks;
+  ticks.LowPart = time.dwLowDateTime;
+  ticks.HighPart = time.dwHighDateTime;
+  return (static_cast<int64_t>(ticks.QuadPart) - kUnixEpochInFileTime) / 10;
+}
+
+class Timeline {
+ public:
+  static Timeline& Get() {
+    static Timeline timeline;
+    return timeline;
+  }
+
+  int64_t ToUnixMicros(LARGE_INTEGER counter) const {
+    const int64_t delta = counter.QuadPart - origin_counter_.QuadPart;
+    const int64_t frequency = frequency_.QuadPart;
+    return origin_unix_us_ + delta / frequency * 1000000 +
+           delta % frequency * 1000000 / frequency;
+  }
+
+  int64_t ElapsedMicros(LARGE_INTEGER start, LARGE_INTEGER end) const {
+    return (end.QuadPart - start.QuadPart) * 1000000 / frequency_.QuadPart;
+  }
+
+  void Add(PerfEvent event) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (events_.size() < kMaxEvents) {
+      events_.push_back(std::move(event));
+    }
+  }
+
+  std::vector<PerfEvent> Snapshot() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return events_;
+  }
+
+ private:
+  Timeline() {
+    ::QueryPerformanceFrequency(&frequency_);
+    ::QueryPerformanceCounter(&origin_counter_);
+    FILETIME now;
+    ::GetSystemTimePreciseAsFileTime(&now);
+    origin_unix_us_ = FileTimeToUnixMicros(now);
+
+    // The loader and CRT run before wWinMain; the creation time covers them.
+    FILETIME creation, exit, kernel, user;
+    if (::GetProcessTimes(::GetCurrentProcess(), &creation, &exit, &kernel,
+                          &user)) {
+      events_.push_back(
+          {"process_created", 'i', FileTimeToUnixMicros(creation), 0, 0});
+    }
+  }
+
+  LARGE_INTEGER frequency_;
+  LARGE_INTEGER origin_counter_;
+  int64_t origin_unix_us_ = 0;
+  std::mutex mutex_;
+  std::vector<PerfEvent> events_;
+};
+
+void AppendJsonString(std::string* out, const std::string& value) {
+  out->push_back('"');
+  for (unsigned char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(static_cast<char>(c));
+    } else if (c < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out->append(escaped);
+    } else {
+      out->push_back(static_cast<char>(c));
+    }
+  }
+  out->push_back('"');
+}
+}  // namespace
+
+void PerfMark(const std::string& name) {
+  Timeline& timeline = Timeline::Get();
+  LARGE_INTEGER now;
+  ::QueryPerformanceCounter(&now);
+  timeline.Add({name, 'i', timeline.ToUnixMicros(now), 0,
+                ::GetCurrentThreadId()});
+}
+
+PerfSpan::PerfSpan(std::string name) : name_(std::move(name)) {
+  Timeline::Get();
+  ::QueryPerformanceCounter(&start_);
+}
+
+PerfSpan::~PerfSpan() {
+  Timeline& timeline = Timeline::Get();
+  LARGE_INTEGER end;
+  ::QueryPerformanceCounter(&end);
+  timeline.Add({std::move(name_), 'X', timeline.ToUnixMicros(start_),
+                timeline.ElapsedMicros(start_, end), ::GetCurrentThreadId()});
+}
+
+std::string PerfTraceJson(const std::string& extra_events) {
+  const DWORD pid = ::GetCurrentProcessId();
+  std::string out = "{\"traceEvents\":[";
+  bool first = true;
+  for (const auto& event : Timeline::Get().Snapshot()) {
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    out.append("{\"name\":");
+    AppendJsonString(&out, event.name);
+    out.append(",\"cat\":\"runner\",\"ph\":\"");
+    out.push_back(event.phase);
+    out.append("\",\"ts\":");
+    out.append(std::to_string(event.ts_us));
+    if (event.phase == 'X') {
+      out.append(",\"dur\":");
+      out.append(std::to_string(event.dur_us));
+    } else {
+      // Instant events span the whole process track.
+      out.append(",\"s\":\"p\"");
+    }
+    out.append(",\"pid\":");
+    out.append(std::to_string(pid));
+    out.append(",\"tid\":");
+    out.append(std::to_string(event.tid));
+    out.push_back('}');
+  }
+
+  // |extra_events| is a JSON array; splice its elements in.
+  const size_t open = extra_events.find('[');
+  const size_t close = extra_events.rfind(']');
+  if (open != std::string::npos && close != std::string::npos &&
+      close > open + 1) {
+    if (!first) {
+      out.push_back(',');
+    }
+    out.append(extra_events, open + 1, close - open - 1);
+  }
+  out.append("]}");
+  return out;
+}
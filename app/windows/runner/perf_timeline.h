@@ -0,0 +1,34 @@
+#ifndef RUNNER_PERF_TIMELINE_H_
+#define RUNNER_PERF_TIMELINE_H_
+
+#include <windows.h>
+
+#include <string>
+
+// Process-wide startup timeline. Events are timed with
+// QueryPerformanceCounter and exported as Chrome trace events with wall-clock
+// microsecond timestamps, which is also how the Rust backend stamps its spans.
+// All functions are thread-safe.
+
+// Records an instant event.
+void PerfMark(const std::string& name);
+
+// Records a complete event covering the lifetime of the object.
+class PerfSpan {
+ public:
+  explicit PerfSpan(std::string name);
+  ~PerfSpan();
+
+  PerfSpan(const PerfSpan&) = delete;
+  PerfSpan& operator=(const PerfSpan&) = delete;
+
+ private:
+  std::string name_;
+  LARGE_INTEGER start_;
+};
+
+// Returns {"traceEvents": [...]} holding the runner's events followed by
+// |extra_events|, a JSON array of already-encoded events (may be empty).
+std::string PerfTraceJson(const std::string& extra_events);
+
+#endif  // RUNNER_PERF_TIMELINE_H_
@@ -0,0 +1,655 @@
+// pirate_wallet_bench: measures the wallet service C ABI the way the native
+// bindings call it, plus the DPAPI and keystore pack path the runner's
+// keystore channel uses.
+//
+// The backend (pirate_ffi_native.dll) is loaded at run time so the bench
+// builds without the Rust toolchain. A throwaway fixture wallet is created in
+// a temporary data directory; nothing touches the user's wallets or keystore.
+// Results go to stdout as one JSON document so runs can be diffed and tracked.
+//
+//   pirate_wallet_bench [--library=PATH] [--data-dir=DIR] [--iterations=N]
+//                       [--threads=N] [--skip-keystore]
+
+#include <windows.h>
+#include <dpapi.h>
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <cwchar>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "keystore_pack.h"
+#include "pirate_wallet_service.h"
+
+namespace {
+
+constexpr wchar_t kDefaultLibrary[] = L"pirate_ffi_native.dll";
+constexpr char kFixturePassphrase[] = "pirate-wallet-bench-passphrase";
+constexpr wchar_t kDpapiDescription[] = L"PirateWalletBench";
+constexpr int kDefaultIterations = 200;
+constexpr int kDefaultThreads = 4;
+constexpr int kWarmupIterations = 10;
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+  std::wstring library = kDefaultLibrary;
+  std::filesystem::path data_dir;
+  int iterations = kDefaultIterations;
+  int threads = kDefaultThreads;
+  bool keystore = true;
+};
+
+struct Backend {
+  decltype(&pirate_wallet_service_invoke_json) invoke_json = nullptr;
+  decltype(&pirate_wallet_service_free_string) free_string = nullptr;
+  decltype(&pirate_wallet_service_new) service_new = nullptr;
+  decltype(&pirate_wallet_service_free) service_free = nullptr;
+  decltype(&pirate_wallet_service_invoke_json_arena) invoke_json_arena =
+      nullptr;
+  decltype(&pirate_wallet_service_invoke_batch_json_arena)
+      invoke_batch_json_arena = nullptr;
+};
+
+struct Result {
+  std::string group;
+  std::string name;
+  int threads = 1;
+  size_t request_bytes = 0;
+  size_t response_bytes = 0;
+  std::vector<double> samples_us;
+  double wall_us = 0;
+  std::string error;
+};
+
+std::vector<Result> g_results;
+
+void AppendJsonString(std::string* out, const std::string& value) {
+  out->push_back('"');
+  for (unsigned char c : value) {
+    if (c == '"' || c == '\\') {
+      out->push_back('\\');
+      out->push_back(static_cast<char>(c));
+    } else if (c < 0x20) {
+      char escaped[8];
+      std::snprintf(escaped, sizeof(escaped), "\\u%04x", c);
+      out->append(escaped);
+    } else {
+      out->push_back(static_cast<char>(c));
+    }
+  }
+  out->push_back('"');
+}
+
+double ElapsedMicros(Clock::time_point start) {
+  return std::chrono::duration<double, std::micro>(Clock::now() - start)
+      .count();
+}
+
+double Percentile(const std::vector<double>& sorted, double fraction) {
+  if (sorted.empty()) {
+    return 0;
+  }
+  const size_t index = static_cast<size_t>(fraction * (sorted.size() - 1));
+  return sorted[index];
+}
+
+// Envelopes are serialized with `ok` first.
+bool ResponseOk(const char* response) {
+  return response != nullptr &&
+         std::strncmp(response, "{\"ok\":true", 10) == 0;
+}
+
+// The string `result` of an envelope, e.g. the id from create_wallet.
+std::string ResultString(const char* response) {
+  constexpr char kKey[] = "\"result\":\"";
+  const char* start =
+      response != nullptr ? std::strstr(response, kKey) : nullptr;
+  if (start == nullptr) {
+    return std::string();
+  }
+  start += sizeof(kKey) - 1;
+  const char* end = std::strchr(start, '"');
+  return end != nullptr ? std::string(start, end) : std::string();
+}
+
+// Runs |op| |iterations| times after a short warm up and records each call.
+// |op| returns false to abort with |*error| set.
+void Measure(Result result,
+             int iterations,
+             const std::function<bool(std::string*)>& op) {
+  std::string error;
+  for (int i = 0; i < kWarmupIterations && iterations > 1; ++i) {
+    if (!op(&error)) {
+      break;
+    }
+  }
+  const Clock::time_point wall_start = Clock::now();
+  for (int i = 0; i < iterations && error.empty(); ++i) {
+    const Clock::time_point start = Clock::now();
+    if (!op(&error)) {
+      break;
+    }
+    result.samples_us.push_back(ElapsedMicros(start));
+  }
+  result.wall_us = ElapsedMicros(wall_start);
+  result.error = error;
+  g_results.push_back(std::move(result));
+}
+
+class Bench {
+ public:
+  Bench(const Backend& backend, const Options& options)
+      : backend_(backend), options_(options) {}
+
+  ~Bench() {
+    if (handle_ != nullptr) {
+      backend_.service_free(handle_);
+    }
+  }
+
+  Bench(const Bench&) = delete;
+  Bench& operator=(const Bench&) = delete;
+
+  // Creates the fixture wallet. Returns false when the backend is unusable.
+  bool SetUp() {
+    handle_ = backend_.service_new();
+    if (handle_ == nullptr) {
+      std::fprintf(stderr, "bench: pirate_wallet_service_new failed\n");
+      return false;
+    }
+    std::string passphrase;
+    AppendJsonString(&passphrase, kFixturePassphrase);
+    if (!CallOk("{\"method\":\"set_app_passphrase\",\"passphrase\":" +
+                passphrase + "}") ||
+        !CallOk("{\"method\":\"unlock_app\",\"passphrase\":" + passphrase +
+                "}")) {
+      return false;
+    }
+    char* response = backend_.invoke_json(
+        "{\"method\":\"create_wallet\",\"name\":\"bench\","
+        "\"birthday_opt\":null,\"mnemonic_language\":null}",
+        false);
+    wallet_id_ = ResultString(response);
+    const bool ok = ResponseOk(response) && !wallet_id_.empty();
+    if (!ok) {
+      std::fprintf(stderr, "bench: create_wallet failed: %s\n",
+                   response != nullptr ? response : "(null)");
+    }
+    backend_.free_string(response);
+    return ok;
+  }
+
+  void RunMethodLatency() {
+    const std::string wallet = "\"wallet_id\":\"" + wallet_id_ + "\"";
+    const std::vector<std::pair<std::string, std::string>> requests = {
+        {"get_build_info", "{\"method\":\"get_build_info\"}"},
+        {"list_wallets", "{\"method\":\"list_wallets\"}"},
+        {"get_active_wallet", "{\"method\":\"get_active_wallet\"}"},
+        {"get_balance", "{\"method\":\"get_balance\"," + wallet + "}"},
+        {"sync_status", "{\"method\":\"sync_status\"," + wallet + "}"},
+        {"list_transactions",
+         "{\"method\":\"list_transactions\"," + wallet + ",\"limit\":50}"},
+        {"get_fee_info", "{\"method\":\"get_fee_info\"}"},
+    };
+    for (const auto& [name, request] : requests) {
+      // invoke_json allocates a fresh string per call; the arena entry point
+      // reuses the handle's buffer. Bindings use one or the other.
+      MeasureInvokeJson("invoke_json", name, request);
+      MeasureInvokeArena("invoke_json_arena", name, request,
+                         options_.iterations);
+    }
+  }
+
+  void RunThroughput() {
+    const std::string request =
+        "{\"method\":\"get_balance\",\"wallet_id\":\"" + wallet_id_ + "\"}";
+    const int threads = std::max(1, options_.threads);
+    const int per_thread = options_.iterations;
+    std::atomic<bool> failed(false);
+
+    Result result;
+    result.group = "throughput";
+    result.name = "get_balance";
+    result.threads = threads;
+    result.request_bytes = request.size();
+    std::vector<std::vector<double>> samples(threads);
+    std::vector<std::thread> workers;
+    const Clock::time_point wall_start = Clock::now();
+    for (int t = 0; t < threads; ++t) {
+      workers.emplace_back([&, t]() {
+        samples[t].reserve(per_thread);
+        for (int i = 0; i < per_thread && !failed.load(); ++i) {
+          const Clock::time_point start = Clock::now();
+          char* response = backend_.invoke_json(request.c_str(), false);
+          const bool ok = ResponseOk(response);
+          backend_.free_string(response);
+          if (!ok) {
+            failed.store(true);
+            break;
+          }
+          samples[t].push_back(ElapsedMicros(start));
+        }
+      });
+    }
+    for (auto& worker : workers) {
+      worker.join();
+    }
+    result.wall_us = ElapsedMicros(wall_start);
+    for (const auto& thread_samples : samples) {
+      result.samples_us.insert(result.samples_us.end(), thread_samples.begin(),
+                               thread_samples.end());
+    }
+    if (failed.load()) {
+      result.error = "get_balance failed";
+    }
+    g_results.push_back(std::move(result));
+  }
+
+  void RunPayloadScaling() {
+    // Request side: parse and copy cost for growing request bodies.
+    for (size_t size : {size_t{64}, size_t{4096}, size_t{65536},
+                        size_t{1048576}}) {
+      const std::string request =
+          "{\"method\":\"validate_address\",\"address\":\"" +
+          std::string(size, 'z') + "\"}";
+      MeasureInvokeArena("request_size",
+                         "validate_address_" + std::to_string(size), request,
+                         ScaledIterations(size));
+    }
+    // Both sides: batches grow the request array and the response array.
+    for (int count : {1, 16, 256, 1024}) {
+      std::string request = "[";
+      for (int i = 0; i < count; ++i) {
+        if (i > 0) {
+          request.push_back(',');
+        }
+        request += "{\"method\":\"get_balance\",\"wallet_id\":\"" +
+                   wallet_id_ + "\"}";
+      }
+      request.push_back(']');
+      MeasureBatch("batch_size", "get_balance_x" + std::to_string(count),
+                   request, ScaledIterations(request.size()));
+    }
+  }
+
+ private:
+  bool CallOk(const std::string& request) {
+    char* response = backend_.invoke_json(request.c_str(), false);
+    const bool ok = ResponseOk(response);
+    if (!ok) {
+      std::fprintf(stderr, "bench: request failed: %s\n",
+                   response != nullptr ? response : "(null)");
+    }
+    backend_.free_string(response);
+    return ok;
+  }
+
+  // Large payloads get fewer iterations so a run stays in seconds.
+  int ScaledIterations(size_t bytes) const {
+    const size_t scale = std::max<size_t>(1, bytes / 4096);
+    return std::max(10, static_cast<int>(options_.iterations / scale));
+  }
+
+  void MeasureInvokeJson(const std::string& group,
+                         const std::string& name,
+                         const std::string& request) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_bytes = 0;
+    Measure(std::move(result), options_.iterations, [&](std::string* error) {
+      char* response = backend_.invoke_json(request.c_str(), false);
+      const bool ok = ResponseOk(response);
+      response_bytes = response != nullptr ? std::strlen(response) : 0;
+      if (!ok) {
+        *error = response != nullptr ? response : "null response";
+      }
+      backend_.free_string(response);
+      return ok;
+    });
+    g_results.back().response_bytes = response_bytes;
+  }
+
+  void MeasureInvokeArena(const std::string& group,
+                          const std::string& name,
+                          const std::string& request,
+                          int iterations) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_len = 0;
+    Measure(std::move(result), iterations, [&](std::string* error) {
+      const char* response = nullptr;
+      const int32_t status = backend_.invoke_json_arena(
+          handle_, request.data(), request.size(), false, &response,
+          &response_len);
+      if (status != PIRATE_WALLET_SERVICE_OK || !ResponseOk(response)) {
+        *error = status != PIRATE_WALLET_SERVICE_OK
+                     ? "status " + std::to_string(status)
+                     : std::string(response, response_len);
+        return false;
+      }
+      return true;
+    });
+    g_results.back().response_bytes = response_len;
+  }
+
+  void MeasureBatch(const std::string& group,
+                    const std::string& name,
+                    const std::string& request,
+                    int iterations) {
+    Result result;
+    result.group = group;
+    result.name = name;
+    result.request_bytes = request.size();
+    size_t response_len = 0;
+    Measure(std::move(result), iterations, [&](std::string* error) {
+      const char* response = nullptr;
+      const int32_t status = backend_.invoke_batch_json_arena(
+          handle_, request.data(), request.size(), false, &response,
+          &response_len);
+      if (status != PIRATE_WALLET_SERVICE_OK) {
+        *error = "status " + std::to_string(status);
+        return false;
+      }
+      return true;
+    });
+    g_results.back().response_bytes = response_len;
+  }
+
+  const Backend& backend_;
+  const Options& options_;
+  pirate_wallet_service_t* handle_ = nullptr;
+  std::string wallet_id_;
+};
+
+bool Protect(const std::vector<uint8_t>& input,
+             std::vector<uint8_t>* output,
+             std::string* error) {
+  DATA_BLOB in_blob;
+  in_blob.pbData = const_cast<BYTE*>(input.data());
+  in_blob.cbData = static_cast<DWORD>(input.size());
+  DATA_BLOB out_blob;
+  if (!::CryptProtectData(&in_blob, kDpapiDescription, nullptr, nullptr,
+                          nullptr, CRYPTPROTECT_UI_FORBIDDEN, &out_blob)) {
+    *error = "CryptProtectData failed";
+    return false;
+  }
+  output->assign(out_blob.pbData, out_blob.pbData + out_blob.cbData);
+  ::LocalFree(out_blob.pbData);
+  return true;
+}
+
+bool Unprotect(const std::vector<uint8_t>& input,
+               std::vector<uint8_t>* output,
+               std::string* error) {
+  DATA_BLOB in_blob;
+  in_blob.pbData = const_cast<BYTE*>(input.data());
+  in_blob.cbData = static_cast<DWORD>(input.size());
+  DATA_BLOB out_blob;
+  if (!::CryptUnprotectData(&in_blob, nullptr, nullptr, nullptr, nullptr,
+                            CRYPTPROTECT_UI_FORBIDDEN, &out_blob)) {
+    *error = "CryptUnprotectData failed";
+    return false;
+  }
+  output->assign(out_blob.pbData, out_blob.pbData + out_blob.cbData);
+  ::LocalFree(out_blob.pbData);
+  return true;
+}
+
+// DPAPI alone, then seal and unseal as the keystore channel does them: DPAPI
+// plus a keystore pack write or read. The pack lives in the bench data
+// directory.
+void RunKeystore(const Options& options) {
+  KeystorePack pack(options.data_dir / L"keystore");
+  for (size_t size : {size_t{32}, size_t{4096}}) {
+    std::vector<uint8_t> payload(size);
+    for (size_t i = 0; i < size; ++i) {
+      payload[i] = static_cast<uint8_t>(i * 31 + 7);
+    }
+    const std::string key_id = "bench-" + std::to_string(size);
+    const std::string suffix = "_" + std::to_string(size);
+    std::vector<uint8_t> sealed;
+    std::vector<uint8_t> opened;
+
+    Result protect;
+    protect.group = "keystore";
+    protect.name = "dpapi_protect" + suffix;
+    protect.request_bytes = size;
+    Measure(std::move(protect), options.iterations, [&](std::string* error) {
+      return Protect(payload, &sealed, error);
+    });
+    if (!g_results.back().error.empty()) {
+      continue;
+    }
+
+    Result unprotect;
+    unprotect.group = "keystore";
+    unprotect.name = "dpapi_unprotect" + suffix;
+    unprotect.response_bytes = size;
+    Measure(std::move(unprotect), options.iterations,
+            [&](std::string* error) {
+              return Unprotect(sealed, &opened, error);
+            });
+
+    Result seal;
+    seal.group = "keystore";
+    seal.name = "pack_seal" + suffix;
+    seal.request_bytes = size;
+    Measure(std::move(seal), options.iterations, [&](std::string* error) {
+      std::vector<uint8_t> record;
+      return Protect(payload, &record, error) &&
+             pack.Put({{key_id, std::move(record)}}, error);
+    });
+
+    Result unseal;
+    unseal.group = "keystore";
+    unseal.name = "pack_unseal" + suffix;
+    unseal.response_bytes = size;
+    Measure(std::move(unseal), options.iterations, [&](std::string* error) {
+      std::vector<uint8_t> record;
+      bool found = false;
+      if (!pack.Get(key_id, &record, &found, error)) {
+        return false;
+      }
+      if (!found) {
+        *error = "sealed record missing";
+        return false;
+      }
+      return Unprotect(record, &opened, error);
+    });
+
+    std::string ignored;
+    pack.Remove(key_id, &ignored);
+  }
+}
+
+std::string ResultsJson(const Options& options) {
+  const auto now = std::chrono::system_clock::now().time_since_epoch();
+  std::string out = "{\"benchmark\":\"pirate_wallet_bench\"";
+  out += ",\"platform\":\"windows\"";
+  out += ",\"timestamp\":" +
+         std::to_string(
+             std::chrono::duration_cast<std::chrono::seconds>(now).count());
+  out += ",\"iterations\":" + std::to_string(options.iterations);
+  out += ",\"results\":[";
+  bool first = true;
+  char number[96];
+  for (auto& result : g_results) {
+    std::sort(result.samples_us.begin(), result.samples_us.end());
+    double total = 0;
+    for (double sample : result.samples_us) {
+      total += sample;
+    }
+    const size_t count = result.samples_us.size();
+    if (!first) {
+      out.push_back(',');
+    }
+    first = false;
+    out += "{\"group\":";
+    AppendJsonString(&out, result.group);
+    out += ",\"name\":";
+    AppendJsonString(&out, result.name);
+    out += ",\"threads\":" + std::to_string(result.threads);
+    out += ",\"iterations\":" + std::to_string(count);
+    out += ",\"request_bytes\":" + std::to_string(result.request_bytes);
+    out += ",\"response_bytes\":" + std::to_string(result.response_bytes);
+    std::snprintf(number, sizeof(number),
+                  ",\"mean_us\":%.2f,\"min_us\":%.2f,\"p50_us\":%.2f",
+                  count > 0 ? total / count : 0.0,
+                  count > 0 ? result.samples_us.front() : 0.0,
+                  Percentile(result.samples_us, 0.50));
+    out += number;
+    std::snprintf(number, sizeof(number),
+                  ",\"p95_us\":%.2f,\"p99_us\":%.2f,\"max_us\":%.2f",
+                  Percentile(result.samples_us, 0.95),
+                  Percentile(result.samples_us, 0.99),
+                  count > 0 ? result.samples_us.back() : 0.0);
+    out += number;
+    std::snprintf(number, sizeof(number), ",\"ops_per_sec\":%.1f",
+                  result.wall_us > 0 ? count * 1e6 / result.wall_us : 0.0);
+    out += number;
+    if (!result.error.empty()) {
+      out += ",\"error\":";
+      AppendJsonString(&out, result.error);
+    }
+    out.push_back('}');
+  }
+  out += "]}";
+  return out;
+}
+
+bool ParseOptions(int argc, wchar_t** argv, Options* options) {
+  for (int i = 1; i < argc; ++i) {
+    const std::wstring arg = argv[i];
+    auto value = [&arg](const wchar_t* prefix) -> const wchar_t* {
+      const size_t length = std::wcslen(prefix);
+      return arg.compare(0, length, prefix) == 0 ? arg.c_str() + length
+                                                 : nullptr;
+    };
+    if (const wchar_t* library = value(L"--library=")) {
+      options->library = library;
+    } else if (const wchar_t* dir = value(L"--data-dir=")) {
+      options->data_dir = dir;
+    } else if (const wchar_t* iterations = value(L"--iterations=")) {
+      options->iterations =
+          static_cast<int>(std::wcstol(iterations, nullptr, 10));
+    } else if (const wchar_t* threads = value(L"--threads=")) {
+      options->threads =
+          static_cast<int>(std::wcstol(threads, nullptr, 10));
+    } else if (arg == L"--skip-keystore") {
+      options->keystore = false;
+    } else {
+      std::fwprintf(stderr, L"bench: unknown argument %ls\n", arg.c_str());
+      return false;
+    }
+  }
+  return options->iterations > 0 && options->threads > 0;
+}
+
+template <typename Fn>
+bool LoadSymbol(HMODULE library, const char* name, Fn* fn) {
+  *fn = reinterpret_cast<Fn>(::GetProcAddress(library, name));
+  if (*fn == nullptr) {
+    std::fprintf(stderr, "bench: backend is missing %s\n", name);
+    return false;
+  }
+  return true;
+}
+
+bool LoadBackend(const std::wstring& path, Backend* backend) {
+  HMODULE library = ::LoadLibraryW(path.c_str());
+  if (library == nullptr) {
+    std::fwprintf(stderr, L"bench: cannot load %ls (error %lu)\n",
+                  path.c_str(), ::GetLastError());
+    return false;
+  }
+  return LoadSymbol(library, "pirate_wallet_service_invoke_json",
+                    &backend->invoke_json) &&
+         LoadSymbol(library, "pirate_wallet_service_free_string",
+                    &backend->free_string) &&
+         LoadSymbol(library, "pirate_wallet_service_new",
+                    &backend->service_new) &&
+         LoadSymbol(library, "pirate_wallet_service_free",
+                    &backend->service_free) &&
+         LoadSymbol(library, "pirate_wallet_service_invoke_json_arena",
+                    &backend->invoke_json_arena) &&
+         LoadSymbol(library, "pirate_wallet_service_invoke_batch_json_arena",
+                    &backend->invoke_batch_json_arena);
+}
+
+// A fresh directory under %TEMP% for the fixture wallet and keystore pack.
+std::filesystem::path MakeTempDataDir() {
+  wchar_t temp[MAX_PATH + 1];
+  const DWORD length = ::GetTempPathW(MAX_PATH + 1, temp);
+  const std::filesystem::path base =
+      length > 0 ? std::filesystem::path(temp) : std::filesystem::path(L".");
+  const auto ticks = Clock::now().time_since_epoch().count();
+  std::filesystem::path dir =
+      base / (L"pirate-wallet-bench-" +
+              std::to_wstring(::GetCurrentProcessId()) + L"-" +
+              std::to_wstring(ticks));
+  std::error_code error;
+  std::filesystem::create_directories(dir, error);
+  return error ? std::filesystem::path() : dir;
+}
+
+}  // namespace
+
+int wmain(int argc, wchar_t** argv) {
+  Options options;
+  if (!ParseOptions(argc, argv, &options)) {
+    return 2;
+  }
+
+  // The backend reads its data directory from the environment on first use,
+  // so this has to happen before any call.
+  const bool temporary = options.data_dir.empty();
+  if (temporary) {
+    options.data_dir = MakeTempDataDir();
+    if (options.data_dir.empty()) {
+      std::fprintf(stderr,
+                   "bench: cannot create a temporary data directory\n");
+      return 1;
+    }
+  }
+  ::SetEnvironmentVariableW(L"PIRATE_WALLET_DB_DIR",
+                            options.data_dir.wstring().c_str());
+
+  Backend backend;
+  if (!LoadBackend(options.library, &backend)) {
+    return 1;
+  }
+
+  {
+    Bench bench(backend, options);
+    if (!bench.SetUp()) {
+      return 1;
+    }
+    bench.RunMethodLatency();
+    bench.RunThroughput();
+    bench.RunPayloadScaling();
+  }
+  if (options.keystore) {
+    RunKeystore(options);
+  }
+
+  std::printf("%s\n", ResultsJson(options).c_str());
+  if (temporary) {
+    std::fwprintf(stderr, L"bench: fixture data left in %ls\n",
+                  options.data_dir.wstring().c_str());
+  }
+  return 0;
+}
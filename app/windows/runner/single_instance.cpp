@@ -0,0 +1,108 @@
+#include "single_instance.h"
+
+namespace {
+// Per session, so other users on the machine run their own wallet.
+constexpr wchar_t kInstanceMutexName[] = L"Local\\com.pirate.wallet.instance";
+constexpr wchar_t kInstanceWindowProp[] = L"PirateWalletInstance";
+// Matches Win32Window. Other Flutter apps share the class, hence the prop.
+constexpr wchar_t kWindowClassName[] = L"FLUTTER_RUNNER_WIN32_WINDOW";
+// Marks a WM_COPYDATA payload as forwarded launch arguments ('PWIA').
+constexpr ULONG_PTR kForwardedArgumentsTag = 0x50574941;
+// A primary launched a moment earlier may not have its window yet.
+constexpr ULONGLONG kPrimaryWindowWaitMs = 5000;
+constexpr DWORD kPrimaryWindowPollMs = 100;
+constexpr UINT kForwardTimeoutMs = 5000;
+
+HWND FindPrimaryWindow() {
+  HWND candidate = nullptr;
+  while ((candidate = ::FindWindowExW(nullptr, candidate, kWindowClassName,
+                                      nullptr)) != nullptr) {
+    if (::GetPropW(candidate, kInstanceWindowProp) != nullptr) {
+      return candidate;
+    }
+  }
+  return nullptr;
+}
+}  // namespace
+
+SingleInstance::SingleInstance() {
+  mutex_ = ::CreateMutexW(nullptr, FALSE, kInstanceMutexName);
+  // If the mutex cannot be created at all, start normally rather than
+  // refusing to launch.
+  is_primary_ = mutex_ == nullptr || ::GetLastError() != ERROR_ALREADY_EXISTS;
+}
+
+SingleInstance::~SingleInstance() {
+  if (mutex_ != nullptr) {
+    ::CloseHandle(mutex_);
+  }
+}
+
+bool SingleInstance::ForwardToPrimary(
+    const std::vector<std::string>& arguments) const {
+  // NUL-terminated UTF-8 strings back to back.
+  std::string payload;
+  for (const std::string& argument : arguments) {
+    payload.append(argument);
+    payload.push_back('\0');
+  }
+
+  const ULONGLONG deadline = ::GetTickCount64() + kPrimaryWindowWaitMs;
+  HWND primary = FindPrimaryWindow();
+  while (primary == nullptr && ::GetTickCount64() < deadline) {
+    ::Sleep(kPrimaryWindowPollMs);
+    primary = FindPrimaryWindow();
+  }
+  if (primary == nullptr) {
+    return false;
+  }
+
+  // Only the foreground process may hand the foreground on.
+  DWORD primary_process_id = 0;
+  ::GetWindowThreadProcessId(primary, &primary_process_id);
+  ::AllowSetForegroundWindow(primary_process_id);
+
+  COPYDATASTRUCT data = {};
+  data.dwData = kForwardedArgumentsTag;
+  data.cbData = static_cast<DWORD>(payload.size());
+  data.lpData = payload.empty() ? nullptr : &payload[0];
+  DWORD_PTR reply = 0;
+  const LRESULT sent = ::SendMessageTimeoutW(
+      primary, WM_COPYDATA, 0, reinterpret_cast<LPARAM>(&data),
+      SMTO_ABORTIFHUNG, kForwardTimeoutMs, &reply);
+  return sent != 0 && reply == TRUE;
+}
+
+void SingleInstance::MarkPrimaryWindow(HWND hwnd) {
+  if (hwnd != nullptr) {
+    ::SetPropW(hwnd, kInstanceWindowProp, reinterpret_cast<HANDLE>(1));
+  }
+}
+
+void SingleInstance::UnmarkPrimaryWindow(HWND hwnd) {
+  if (hwnd != nullptr) {
+    ::RemovePropW(hwnd, kInstanceWindowProp);
+  }
+}
+
+bool SingleInstance::ParseForwardedArguments(
+    const COPYDATASTRUCT* data, std::vector<std::string>* arguments) {
+  if (data == nullptr || data->dwData != kForwardedArgumentsTag) {
+    return false;
+  }
+  arguments->clear();
+  const char* bytes = static_cast<const char*>(data->lpData);
+  if (bytes == nullptr) {
+    return true;
+  }
+  const char* const end = bytes + data->cbData;
+  while (bytes < end) {
+    const char* terminator = bytes;
+    while (terminator < end && *terminator != '\0') {
+      ++terminator;
+    }
+    arguments->emplace_back(bytes, terminator);
+    bytes = terminator + 1;
+  }
+  return true;
+}
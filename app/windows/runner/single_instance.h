@@ -0,0 +1,46 @@
+#ifndef RUNNER_SINGLE_INSTANCE_H_
+#define RUNNER_SINGLE_INSTANCE_H_
+
+#include <windows.h>
+
+#include <string>
+#include <vector>
+
+// Keeps one wallet process per user session.
+//
+// The first process holds a named mutex and tags its top-level window. A
+// later launch (a pirate: link, a taskbar relaunch) finds that window, sends
+// it its arguments with WM_COPYDATA and exits before starting an engine, so
+// only one backend ever syncs the wallet files and block cache.
+class SingleInstance {
+ public:
+  SingleInstance();
+  ~SingleInstance();
+
+  SingleInstance(const SingleInstance&) = delete;
+  SingleInstance& operator=(const SingleInstance&) = delete;
+
+  // True when this process owns the instance mutex and should start the app.
+  bool is_primary() const { return is_primary_; }
+
+  // Sends |arguments| to the primary instance's window and lets it take the
+  // foreground. Waits a few seconds for a primary that is still starting.
+  // Returns false if no window accepted them.
+  bool ForwardToPrimary(const std::vector<std::string>& arguments) const;
+
+  // Tags |hwnd| so later launches can find it.
+  static void MarkPrimaryWindow(HWND hwnd);
+
+  // Removes the tag before |hwnd| is destroyed.
+  static void UnmarkPrimaryWindow(HWND hwnd);
+
+  // Returns true and fills |arguments| if |data| is a forwarded launch.
+  static bool ParseForwardedArguments(const COPYDATASTRUCT* data,
+                                      std::vector<std::string>* arguments);
+
+ private:
+  HANDLE mutex_ = nullptr;
+  bool is_primary_ = true;
+};
+
+#endif  // RUNNER_SINGLE_INSTANCE_H_
@@ -0,0 +1,129 @@
+#include "tray_icon.h"
+
+#include <shellapi.h>
+
+#include "resource.h"
+
+namespace {
+constexpr UINT kTrayIconId = 1;
+constexpr wchar_t kTrayTip[] = L"Pirate Wallet - syncing in the background";
+constexpr UINT kMenuOpen = 1;
+constexpr UINT kMenuQuit = 2;
+
+NOTIFYICONDATAW IconData(HWND hwnd) {
+  NOTIFYICONDATAW data = {};
+  data.cbSize = sizeof(data);
+  data.hWnd = hwnd;
+  data.uID = kTrayIconId;
+  return data;
+}
+}  // namespace
+
+TrayIcon::~TrayIcon() {
+  Hide();
+}
+
+bool TrayIcon::Show(HWND hwnd, UINT callback_message) {
+  if (visible()) {
+    return true;
+  }
+  hwnd_ = hwnd;
+  callback_message_ = callback_message;
+  icon_ = static_cast<HICON>(::LoadImageW(
+      ::GetModuleHandleW(nullptr), MAKEINTRESOURCEW(IDI_APP_ICON), IMAGE_ICON,
+      ::GetSystemMetrics(SM_CXSMICON), ::GetSystemMetrics(SM_CYSMICON),
+      LR_DEFAULTCOLOR));
+  if (!Add()) {
+    Hide();
+    return false;
+  }
+  return true;
+}
+
+void TrayIcon::Hide() {
+  if (hwnd_ != nullptr) {
+    NOTIFYICONDATAW data = IconData(hwnd_);
+    ::Shell_NotifyIconW(NIM_DELETE, &data);
+    hwnd_ = nullptr;
+  }
+  if (icon_ != nullptr) {
+    ::DestroyIcon(icon_);
+    icon_ = nullptr;
+  }
+}
+
+void TrayIcon::Restore() {
+  if (visible()) {
+    Add();
+  }
+}
+
+TrayIcon::Command TrayIcon::ShowMenu() {
+  if (!visible()) {
+    return Command::kNone;
+  }
+  HMENU menu = ::CreatePopupMenu();
+  if (menu == nullptr) {
+    return Command::kNone;
+  }
+  ::AppendMenuW(menu, MF_STRING, kMenuOpen, L"Open Pirate Wallet");
+  ::AppendMenuW(menu, MF_SEPARATOR, 0, nullptr);
+  ::AppendMenuW(menu, MF_STRING, kMenuQuit, L"Quit");
+  ::SetMenuDefaultItem(menu, kMenuOpen, FALSE);
+
+  POINT cursor = {};
+  ::GetCursorPos(&cursor);
+  // Without this the menu stays open when the user clicks elsewhere.
+  ::SetForegroundWindow(hwnd_);
+  const UINT chosen = static_cast<UINT>(::TrackPopupMenu(
+      menu, TPM_RETURNCMD | TPM_NONOTIFY | TPM_RIGHTBUTTON, cursor.x, cursor.y,
+      0, hwnd_, nullptr));
+  ::PostMessageW(hwnd_, WM_NULL, 0, 0);
+  ::DestroyMenu(menu);
+
+  switch (chosen) {
+    case kMenuOpen:
+      return Command::kOpen;
+    case kMenuQuit:
+      return Command::kQuit;
+    default:
+      return Command::kNone;
+  }
+}
+
+UINT TrayIcon::taskbar_created_message() {
+  static const UINT message = ::RegisterWindowMessageW(L"TaskbarCreated");
+  return message;
+}
+
+bool TrayIcon::Add() {
+  NOTIFYICONDATAW data = IconData(hwnd_);
+  data.uFlags = NIF_MESSAGE | NIF_ICON | NIF_TIP | NIF_SHOWTIP;
+  data.uCallbackMessage = callback_message_;
+  data.hIcon = icon_;
+  ::wcsncpy_s(data.szTip, kTrayTip, _TRUNCATE);
+  if (!::Shell_NotifyIconW(NIM_ADD, &data)) {
+    return false;
+  }
+  data.uVersion = NOTIFYICON_VERSION_4;
+  ::Shell_NotifyIconW(NIM_SETVERSION, &data);
+  return true;
+}
+
+void SetProcessBackgroundMode(bool enabled) {
+  HANDLE process = ::GetCurrentProcess();
+  // Applies to every thread, including the backend's sync workers; the
+  // THREAD_MODE_ variant would only cover the calling thread.
+  ::SetPriorityClass(process, enabled ? PROCESS_MODE_BACKGROUND_BEGIN
+                                      : PROCESS_MODE_BACKGROUND_END);
+
+  // EcoQoS on Windows 11, throttled execution speed on Windows 10. An empty
+  // control mask hands the choice back to the system.
+  PROCESS_POWER_THROTTLING_STATE throttling = {};
+  throttling.Version = PROCESS_POWER_THROTTLING_CURRENT_VERSION;
+  const ULONG mask = enabled ? PROCESS_POWER_THROTTLING_EXECUTION_SPEED : 0;
+  throttling.ControlMask = mask;
+  throttling.StateMask = mask;
+  ::SetProcessInformation(process, ProcessPowerThrottling, &throttling,
+                          sizeof(throttling));
+}
@@ -0,0 +1,56 @@
+#ifndef RUNNER_TRAY_ICON_H_
+#define RUNNER_TRAY_ICON_H_
+
+#include <windows.h>
+
+// Notification-area icon for a wallet window hidden by close-to-tray.
+//
+// The icon reports clicks to its window as |callback_message| with the
+// mouse or keyboard event in LOWORD(lparam) (NOTIFYICON_VERSION_4).
+// Explorer drops every icon when it restarts; call Restore() when the window
+// receives taskbar_created_message().
+class TrayIcon {
+ public:
+  enum class Command {
+    kNone,
+    kOpen,
+    kQuit,
+  };
+
+  TrayIcon() = default;
+  ~TrayIcon();
+
+  TrayIcon(const TrayIcon&) = delete;
+  TrayIcon& operator=(const TrayIcon&) = delete;
+
+  // Adds the icon for |hwnd|. Returns false if the shell refused it.
+  bool Show(HWND hwnd, UINT callback_message);
+
+  // Removes the icon if it is shown.
+  void Hide();
+
+  // Re-adds a shown icon after Explorer restarted.
+  void Restore();
+
+  bool visible() const { return hwnd_ != nullptr; }
+
+  // Shows the Open / Quit menu at the cursor and returns the chosen command.
+  Command ShowMenu();
+
+  // Broadcast by Explorer once its taskbar exists again.
+  static UINT taskbar_created_message();
+
+ private:
+  bool Add();
+
+  HWND hwnd_ = nullptr;
+  UINT callback_message_ = 0;
+  HICON icon_ = nullptr;
+};
+
+// Lowers the whole process to background CPU, I/O and memory priority and
+// opts it into EcoQoS while |enabled|, so sync left running behind a hidden
+// window yields to everything the user is doing.
+void SetProcessBackgroundMode(bool enabled);
+
+#endif  // RUNNER_TRAY_ICON_H_
@@ -141,6 +141,18 @@ public data class FeeInfo(
     val memoFeeMultiplier: Double,
 )
 
+public enum class ProverState {
+    Cold,
+    Loading,
+    Ready,
+}
+
+public data class ProverStatus(
+    val state: ProverState,
+    val saplingReady: Boolean,
+    val prewarmMs: Long?,
+)
+
 public data class MnemonicInspection(
     val isValid: Boolean,
     val detectedLanguage: MnemonicLanguage?,
@@ -503,6 +515,13 @@ public class PirateWalletSdk(
     public fun getFeeInfo(): FeeInfo =
         parseFeeInfo(invokeResult("get_fee_info"))
 
+    /** Starts loading proving parameters in the background; call when the send screen opens. */
+    public fun prewarmProver(): ProverStatus =
+        parseProverStatus(invokeResult("prewarm_prover"))
+
+    public fun getProverStatus(): ProverStatus =
+        parseProverStatus(invokeResult("get_prover_status"))
+
     public fun startSync(request: SyncRequest) {
         invokeUnit("start_sync", "wallet_id" to request.walletId, "mode" to request.mode)
     }
@@ -855,6 +874,20 @@ private fun parseFeeInfo(value: Any?): FeeInfo {
     )
 }
 
+private fun parseProverStatus(value: Any?): ProverStatus {
+    val json = value.requireObject("prover status")
+    return ProverStatus(
+        state = when (val state = json.requireString("state")) {
+            "cold" -> ProverState.Cold
+            "loading" -> ProverState.Loading
+            "ready" -> ProverState.Ready
+            else -> throw PirateWalletSdkException("Unknown prover state: $state")
+        },
+        saplingReady = json.requireBoolean("sapling_ready"),
+        prewarmMs = json.nullableLong("prewarm_ms"),
+    )
+}
+
 private fun parseSyncStatus(value: Any?): SyncStatus {
     val json = value.requireObject("sync status")
     return SyncStatus(
@@ -5,6 +5,14 @@ public protocol PirateWalletNativeInvoker: Sendable {
     func invoke(requestJson: String, pretty: Bool) throws -> String
 }
 
+/// Invoker that can run requests without parking a thread per call.
+///
+/// `PirateWalletSDK.invokeAsync` prefers this over hopping to its serial
+/// invocation queue, so a slow request does not delay the ones behind it.
+public protocol PirateWalletAsyncNativeInvoker: PirateWalletNativeInvoker {
+    func invokeAsync(requestJson: String, pretty: Bool) async throws -> String
+}
+
 public struct PirateWalletCInvoker: PirateWalletNativeInvoker {
     public init() {}
 
@@ -28,6 +36,143 @@ public struct PirateWalletCInvoker: PirateWalletNativeInvoker {
     }
 }
 
+/// Invoker backed by a persistent `pirate_wallet_service_t` handle.
+///
+/// Responses are read straight out of the handle's reusable arena, so repeated
+/// polling calls do not allocate and free a C string per response.
+public final class PirateWalletHandleInvoker: PirateWalletNativeInvoker, @unchecked Sendable {
+    private let handle: OpaquePointer?
+    private let lock = NSLock()
+
+    public init() {
+        handle = pirate_wallet_service_new()
+    }
+
+    deinit {
+        pirate_wallet_service_free(handle)
+    }
+
+    public func invoke(requestJson: String, pretty: Bool) throws -> String {
+        guard let handle else {
+            throw PirateWalletSdkError.nullResponse
+        }
+
+        var request = requestJson
+        return try request.withUTF8 { requestBytes in
+            // The arena is only valid until the next call on this handle.
+            lock.lock()
+            defer { lock.unlock() }
+
+            var responsePointer: UnsafePointer<CChar>?
+            var responseLength = 0
+            let status = requestBytes.withMemoryRebound(to: CChar.self) { buffer in
+                pirate_wallet_service_invoke_json_arena(
+                    handle,
+                    buffer.baseAddress,
+                    buffer.count,
+                    pretty,
+                    &responsePointer,
+                    &responseLength
+                )
+            }
+            guard status == PIRATE_WALLET_SERVICE_OK, let responsePointer else {
+                throw PirateWalletSdkError.nullResponse
+            }
+
+            let bytes = UnsafeRawPointer(responsePointer).assumingMemoryBound(to: UInt8.self)
+            return String(decoding: UnsafeBufferPointer(start: bytes, count: responseLength), as: UTF8.self)
+        }
+    }
+}
+
+extension PirateWalletHandleInvoker: PirateWalletAsyncNativeInvoker {
+    /// Runs the request through `pirate_wallet_service_invoke_async`.
+    /// Cancelling the calling task cancels the native request.
+    public func invokeAsync(requestJson: String, pretty: Bool) async throws -> String {
+        let pending = PirateWalletPendingRequest()
+        return try await withTaskCancellationHandler {
+            try await withCheckedThrowingContinuation { continuation in
+                let context = Unmanaged.passRetained(PirateWalletAsyncCall(continuation)).toOpaque()
+                var request = requestJson
+                let requestId = request.withUTF8 { requestBytes in
+                    requestBytes.withMemoryRebound(to: CChar.self) { buffer in
+                        pirate_wallet_service_invoke_async(
+                            buffer.baseAddress,
+                            buffer.count,
+                            pretty,
+                            pirateWalletAsyncCallback,
+                            context
+                        )
+                    }
+                }
+                guard requestId != 0 else {
+                    Unmanaged<PirateWalletAsyncCall>.fromOpaque(context).release()
+                    continuation.resume(throwing: PirateWalletSdkError.nullResponse)
+                    return
+                }
+                pending.started(requestId)
+            }
+        } onCancel: {
+            pending.cancel()
+        }
+    }
+}
+
+private final class PirateWalletAsyncCall {
+    let continuation: CheckedContinuation<String, Error>
+
+    init(_ continuation: CheckedContinuation<String, Error>) {
+        self.continuation = continuation
+    }
+}
+
+/// Tracks the native id of one async request so task cancellation can reach
+/// it, including when the task is cancelled before the id is known.
+private final class PirateWalletPendingRequest: @unchecked Sendable {
+    private let lock = NSLock()
+    private var requestId: UInt64 = 0
+    private var cancelled = false
+
+    func started(_ id: UInt64) {
+        lock.lock()
+        requestId = id
+        let cancelNow = cancelled
+        lock.unlock()
+        if cancelNow {
+            _ = pirate_wallet_service_cancel(id)
+        }
+    }
+
+    func cancel() {
+        lock.lock()
+        cancelled = true
+        let id = requestId
+        lock.unlock()
+        if id != 0 {
+            _ = pirate_wallet_service_cancel(id)
+        }
+    }
+}
+
+private let pirateWalletAsyncCallback: pirate_wallet_service_callback_t = { _, status, response, length, userData in
+    guard let userData else {
+        return
+    }
+    let call = Unmanaged<PirateWalletAsyncCall>.fromOpaque(userData).takeRetainedValue()
+    if status == PIRATE_WALLET_SERVICE_CANCELLED {
+        call.continuation.resume(throwing: CancellationError())
+        return
+    }
+    guard status == PIRATE_WALLET_SERVICE_OK, let response else {
+        call.continuation.resume(throwing: PirateWalletSdkError.nullResponse)
+        return
+    }
+    let bytes = UnsafeRawPointer(response).assumingMemoryBound(to: UInt8.self)
+    call.continuation.resume(
+        returning: String(decoding: UnsafeBufferPointer(start: bytes, count: length), as: UTF8.self)
+    )
+}
+
 public final class PirateWalletSDK {
     private let invoker: PirateWalletNativeInvoker
     private let invocationQueue = DispatchQueue(
@@ -36,7 +181,7 @@ public final class PirateWalletSDK {
     )
     public lazy var advancedKeyManagement: PirateWalletAdvancedKeyManagement = PirateWalletAdvancedKeyManagement(sdk: self)
 
-    public init(invoker: PirateWalletNativeInvoker = PirateWalletCInvoker()) {
+    public init(invoker: PirateWalletNativeInvoker = PirateWalletHandleInvoker()) {
         self.invoker = invoker
     }
 
@@ -45,7 +190,10 @@ public final class PirateWalletSDK {
     }
 
     public func invokeAsync(requestJson: String, pretty: Bool = false) async throws -> String {
-        try await withCheckedThrowingContinuation { continuation in
+        if let asyncInvoker = invoker as? PirateWalletAsyncNativeInvoker {
+            return try await asyncInvoker.invokeAsync(requestJson: requestJson, pretty: pretty)
+        }
+        return try await withCheckedThrowingContinuation { continuation in
             invocationQueue.async { [invoker] in
                 do {
                     continuation.resume(
@@ -387,6 +535,16 @@ public final class PirateWalletSDK {
         try decodeResult("get_fee_info", as: FeeInfo.self)
     }
 
+    /// Starts loading proving parameters in the background; call when the
+    /// send screen opens.
+    public func prewarmProver() throws -> ProverStatus {
+        try decodeResult("prewarm_prover", as: ProverStatus.self)
+    }
+
+    public func getProverStatus() throws -> ProverStatus {
+        try decodeResult("get_prover_status", as: ProverStatus.self)
+    }
+
     public func startSync(request: SyncRequest) throws {
         _ = try invokeResult(
             "start_sync",
@@ -1113,6 +1271,10 @@ extension PirateWalletSDK {
         try await decodeResultAsync("get_fee_info", as: FeeInfo.self)
     }
 
+    public func getProverStatusAsync() async throws -> ProverStatus {
+        try await decodeResultAsync("get_prover_status", as: ProverStatus.self)
+    }
+
     public func startSyncAsync(request: SyncRequest) async throws {
         _ = try await invokeResultAsync(
             "start_sync",
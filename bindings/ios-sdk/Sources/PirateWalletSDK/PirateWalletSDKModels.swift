@@ -346,6 +346,18 @@ public struct FeeInfo: Codable, Equatable {
     public let memoFeeMultiplier: Double
 }
 
+public enum ProverState: String, Codable {
+    case cold = "cold"
+    case loading = "loading"
+    case ready = "ready"
+}
+
+public struct ProverStatus: Codable, Equatable {
+    public let state: ProverState
+    public let saplingReady: Bool
+    public let prewarmMs: Int64?
+}
+
 public struct SyncStatus: Codable, Equatable {
     public let localHeight: Int64
     public let targetHeight: Int64
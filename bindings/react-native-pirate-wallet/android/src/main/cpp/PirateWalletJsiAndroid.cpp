@@ -0,0 +1,33 @@
+#include <ReactCommon/CallInvokerHolder.h>
+#include <fbjni/fbjni.h>
+#include <jsi/jsi.h>
+
+#include "PirateWalletJsi.h"
+
+namespace {
+
+using facebook::jni::alias_ref;
+using facebook::react::CallInvokerHolder;
+
+void NativeInstall(alias_ref<jobject>, jlong js_runtime,
+                   alias_ref<CallInvokerHolder::javaobject> call_invoker) {
+  auto* runtime = reinterpret_cast<facebook::jsi::Runtime*>(js_runtime);
+  pirate::InstallPirateWalletJsi(*runtime,
+                                 call_invoker->cthis()->getCallInvoker());
+}
+
+void NativeInvalidate(alias_ref<jobject>, jlong js_runtime) {
+  pirate::InvalidatePirateWalletJsi(
+      *reinterpret_cast<facebook::jsi::Runtime*>(js_runtime));
+}
+
+}  // namespace
+
+JNIEXPORT jint JNI_OnLoad(JavaVM* vm, void*) {
+  return facebook::jni::initialize(vm, [] {
+    facebook::jni::registerNatives(
+        "com/pirate/wallet/reactnative/PirateWalletJsiModule",
+        {makeNativeMethod("nativeInstall", NativeInstall),
+         makeNativeMethod("nativeInvalidate", NativeInvalidate)});
+  });
+}
@@ -0,0 +1,57 @@
+package com.pirate.wallet.reactnative
+
+import com.facebook.react.bridge.ReactApplicationContext
+import com.facebook.react.bridge.ReactContextBaseJavaModule
+import com.facebook.react.bridge.ReactMethod
+import com.facebook.react.turbomodule.core.CallInvokerHolderImpl
+
+/**
+ * Installs the JSI host object from `cpp/PirateWalletJsi.cpp` as
+ * `global.__pirateWalletJsi`. JS calls [install] once before using it; when it
+ * returns false the JS wrapper keeps using [PirateWalletReactNativeModule].
+ */
+class PirateWalletJsiModule(
+    private val reactContext: ReactApplicationContext,
+) : ReactContextBaseJavaModule(reactContext) {
+    override fun getName(): String = "PirateWalletJsi"
+
+    // Runtime the host object went into, until the instance is torn down.
+    @Volatile
+    private var installedRuntime = 0L
+
+    // Synchronous methods run on the JS thread, which the host object needs.
+    @ReactMethod(isBlockingSynchronousMethod = true)
+    fun install(): Boolean {
+        val runtime = reactContext.javaScriptContextHolder?.get() ?: 0L
+        if (runtime == 0L) {
+            return false
+        }
+        val callInvoker = runCatching {
+            reactContext.catalystInstance.jsCallInvokerHolder as? CallInvokerHolderImpl
+        }.getOrNull() ?: return false
+
+        try {
+            System.loadLibrary("pirate_wallet_jsi")
+        } catch (e: UnsatisfiedLinkError) {
+            return false
+        }
+        nativeInstall(runtime, callInvoker)
+        installedRuntime = runtime
+        return true
+    }
+
+    // Pending promises and listeners hold JS functions, so they are dropped
+    // on the JS thread while the runtime is still alive.
+    override fun invalidate() {
+        val runtime = installedRuntime
+        installedRuntime = 0L
+        if (runtime != 0L) {
+            runCatching { reactContext.runOnJSQueueThread { nativeInvalidate(runtime) } }
+        }
+        super.invalidate()
+    }
+
+    private external fun nativeInstall(jsRuntime: Long, callInvoker: CallInvokerHolderImpl)
+
+    private external fun nativeInvalidate(jsRuntime: Long)
+}
@@ -5,14 +5,99 @@ import com.facebook.react.bridge.ReactApplicationContext
 import com.facebook.react.bridge.ReactContextBaseJavaModule
 import com.facebook.react.bridge.ReactMethod
 import java.io.File
+import java.nio.ByteBuffer
+import java.nio.CharBuffer
+import java.nio.charset.CodingErrorAction
 import org.json.JSONObject
 
 internal object NativeBridge {
+    /** `format` for UTF-8 JSON; 1 selects the CBOR codec. */
+    const val FORMAT_JSON = 0
+
     init {
         System.loadLibrary("pirate_ffi_native")
     }
 
     external fun invokeJson(requestJson: String, pretty: Boolean = false): String
+
+    /**
+     * Runs the request in the first [requestLen] bytes of the direct buffer
+     * [request] and writes the response into the direct buffer [response].
+     * Returns the response length, or minus the required length when
+     * [response] is too small; then grow it and call [copyLastResponse] on the
+     * same thread.
+     */
+    external fun invokeDirect(
+        request: ByteBuffer,
+        requestLen: Int,
+        response: ByteBuffer,
+        format: Int,
+        pretty: Boolean,
+    ): Int
+
+    external fun copyLastResponse(response: ByteBuffer): Int
+}
+
+/**
+ * Direct buffers reused across calls, so requests and responses cross JNI as
+ * UTF-8 without a UTF-16 round trip and large responses such as
+ * `list_transactions` do not leave a fresh byte array behind every call.
+ */
+internal object DirectBridge {
+    private const val INITIAL_REQUEST_CAPACITY = 4 * 1024
+    private const val INITIAL_RESPONSE_CAPACITY = 64 * 1024
+
+    // Unpaired surrogates become U+FFFD, as with the String entry point.
+    private val encoder = Charsets.UTF_8.newEncoder()
+        .onMalformedInput(CodingErrorAction.REPLACE)
+        .onUnmappableCharacter(CodingErrorAction.REPLACE)
+    private var request: ByteBuffer = ByteBuffer.allocateDirect(INITIAL_REQUEST_CAPACITY)
+    private var response: ByteBuffer = ByteBuffer.allocateDirect(INITIAL_RESPONSE_CAPACITY)
+    private var scratch = ByteArray(INITIAL_RESPONSE_CAPACITY)
+
+    @Synchronized
+    fun invokeJson(requestJson: String, pretty: Boolean): String {
+        val requestLen = encodeRequest(requestJson)
+        val len = invoke(requestLen, NativeBridge.FORMAT_JSON, pretty)
+        if (scratch.size < len) {
+            scratch = ByteArray(len)
+        }
+        response.position(0)
+        response.get(scratch, 0, len)
+        return String(scratch, 0, len, Charsets.UTF_8)
+    }
+
+    private fun invoke(requestLen: Int, format: Int, pretty: Boolean): Int {
+        val len = NativeBridge.invokeDirect(request, requestLen, response, format, pretty)
+        if (len >= 0) {
+            return len
+        }
+        response = ByteBuffer.allocateDirect(grownCapacity(-len))
+        return NativeBridge.copyLastResponse(response)
+    }
+
+    private fun encodeRequest(requestJson: String): Int {
+        val chars = CharBuffer.wrap(requestJson)
+        while (true) {
+            encoder.reset()
+            request.clear()
+            var result = encoder.encode(chars, request, true)
+            if (result.isUnderflow) {
+                result = encoder.flush(request)
+            }
+            if (result.isUnderflow) {
+                return request.position()
+            }
+            chars.rewind()
+            request = ByteBuffer.allocateDirect(grownCapacity(request.capacity() + 1))
+        }
+    }
+
+    /** Next power of two at or above [required]. */
+    private fun grownCapacity(required: Int): Int {
+        val capacity = Integer.highestOneBit(required)
+        return if (capacity == required || capacity >= (1 shl 30)) required else capacity shl 1
+    }
 }
 
 class PirateWalletReactNativeModule(
@@ -23,7 +108,7 @@ class PirateWalletReactNativeModule(
     @ReactMethod
     fun invoke(requestJson: String, pretty: Boolean, promise: Promise) {
         try {
-            promise.resolve(NativeBridge.invokeJson(requestJson, pretty))
+            promise.resolve(DirectBridge.invokeJson(requestJson, pretty))
         } catch (t: Throwable) {
             promise.reject("PIRATE_WALLET_INVOKE_ERROR", t.message, t)
         }
@@ -7,7 +7,10 @@ import com.facebook.react.uimanager.ViewManager
 
 class PirateWalletReactNativePackage : ReactPackage {
     override fun createNativeModules(reactContext: ReactApplicationContext): List<NativeModule> =
-        listOf(PirateWalletReactNativeModule(reactContext))
+        listOf(
+            PirateWalletReactNativeModule(reactContext),
+            PirateWalletJsiModule(reactContext),
+        )
 
     override fun createViewManagers(reactContext: ReactApplicationContext): List<ViewManager<*, *>> =
         emptyList()
@@ -0,0 +1,574 @@
+#include "PirateWalletJsi.h"
+
+#include <ReactCommon/CallInvoker.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "pirate_wallet_service.h"
+
+namespace pirate {
+namespace {
+
+namespace jsi = facebook::jsi;
+using facebook::react::CallInvoker;
+
+constexpr const char kGlobalName[] = "__pirateWalletJsi";
+
+// First allocation for invokeSyncBuffer. Grows to the largest response seen,
+// up to kMaxBufferHintBytes, so repeated list reads fit in one pass.
+constexpr size_t kInitialBufferHintBytes = 16 * 1024;
+constexpr size_t kMaxBufferHintBytes = 1024 * 1024;
+
+// Backing store for ArrayBuffers handed to JS. The runtime takes ownership,
+// so the response bytes are never copied again after they are written here.
+class OwnedBuffer : public jsi::MutableBuffer {
+ public:
+  explicit OwnedBuffer(std::vector<uint8_t> bytes) : bytes_(std::move(bytes)) {}
+
+  size_t size() const override { return bytes_.size(); }
+  uint8_t* data() override { return bytes_.data(); }
+
+ private:
+  std::vector<uint8_t> bytes_;
+};
+
+jsi::Value MakeArrayBuffer(jsi::Runtime& runtime, std::vector<uint8_t> bytes) {
+  return jsi::ArrayBuffer(runtime,
+                          std::make_shared<OwnedBuffer>(std::move(bytes)));
+}
+
+jsi::Value MakeError(jsi::Runtime& runtime, const char* code,
+                     const char* message) {
+  jsi::Object error = runtime.global()
+                          .getPropertyAsFunction(runtime, "Error")
+                          .callAsConstructor(runtime, message)
+                          .asObject(runtime);
+  error.setProperty(runtime, "code", code);
+  return error;
+}
+
+// What went wrong for a status other than PIRATE_WALLET_SERVICE_OK. Request
+// failures reported by the service itself arrive as an OK status with an
+// error envelope, so these are all transport-level.
+const char* StatusMessage(int32_t status) {
+  switch (status) {
+    case PIRATE_WALLET_SERVICE_CANCELLED:
+      return "Wallet service request was cancelled.";
+    case PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT:
+      return "Wallet service got a null argument or returned no response.";
+    case PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL:
+      return "Wallet service response did not fit the buffer.";
+    case PIRATE_WALLET_SERVICE_ERR_RUNTIME_STARTED:
+      return "Wallet service runtime was already started.";
+    case PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT:
+      return "Wallet service rejected an invalid argument.";
+    default:
+      return "Wallet service request failed.";
+  }
+}
+
+jsi::Value MakeStatusError(jsi::Runtime& runtime, int32_t status) {
+  jsi::Value error = MakeError(runtime,
+                               status == PIRATE_WALLET_SERVICE_CANCELLED
+                                   ? "PIRATE_WALLET_INVOKE_CANCELLED"
+                                   : "PIRATE_WALLET_INVOKE_ERROR",
+                               StatusMessage(status));
+  error.asObject(runtime).setProperty(runtime, "status",
+                                      static_cast<double>(status));
+  return error;
+}
+
+// Calls |callback| from work posted with CallInvoker::invokeAsync, where a
+// JS exception would escape into the invoker. The error goes to
+// console.error instead.
+void CallFromInvoker(jsi::Runtime& runtime, const jsi::Function& callback,
+                     jsi::Value argument) {
+  try {
+    callback.call(runtime, std::move(argument));
+  } catch (const jsi::JSIException& e) {
+    try {
+      jsi::Value console = runtime.global().getProperty(runtime, "console");
+      if (console.isObject()) {
+        console.asObject(runtime)
+            .getPropertyAsFunction(runtime, "error")
+            .call(runtime, jsi::String::createFromUtf8(runtime, e.what()));
+      }
+    } catch (const jsi::JSIException&) {
+      // No usable console; the error has nowhere left to go.
+    }
+  }
+}
+
+std::string RequireString(jsi::Runtime& runtime, const jsi::Value* args,
+                          size_t count, size_t index, const char* name) {
+  if (index >= count || !args[index].isString()) {
+    throw jsi::JSError(runtime, std::string(name) + " must be a string");
+  }
+  return args[index].asString(runtime).utf8(runtime);
+}
+
+bool OptionalBool(const jsi::Value* args, size_t count, size_t index) {
+  return index < count && args[index].isBool() && args[index].getBool();
+}
+
+jsi::Value AmountString(jsi::Runtime& runtime, uint64_t amount) {
+  return jsi::String::createFromAscii(runtime, std::to_string(amount));
+}
+
+// State shared by the host object and the functions it hands out. Everything
+// except the native callbacks runs on the JS thread; those callbacks hold a
+// weak_ptr and only lock it inside work posted back to the JS thread.
+class WalletJsiBinding : public std::enable_shared_from_this<WalletJsiBinding> {
+ public:
+  WalletJsiBinding(jsi::Runtime& runtime, std::shared_ptr<CallInvoker> invoker)
+      : runtime_(runtime),
+        invoker_(std::move(invoker)),
+        service_(pirate_wallet_service_new()) {}
+
+  ~WalletJsiBinding() {
+    Invalidate();
+    pirate_wallet_service_free(service_);
+  }
+
+  // Cancels pending calls and drops their promises and the event listeners.
+  // The JS functions they hold belong to the runtime, so hosts call this (via
+  // InvalidatePirateWalletJsi) on the JS thread before tearing it down.
+  // Completions still in flight find nothing left to settle.
+  void Invalidate() {
+    invalidated_ = true;
+    for (auto& entry : calls_) {
+      pirate_wallet_service_cancel(entry.second.request_id);
+    }
+    calls_.clear();
+    for (auto& entry : listeners_) {
+      // Waits for a callback already running, so the context can go after.
+      pirate_wallet_service_unsubscribe(entry.second.subscription_id);
+      delete entry.second.context;
+    }
+    listeners_.clear();
+  }
+
+  WalletJsiBinding(const WalletJsiBinding&) = delete;
+  WalletJsiBinding& operator=(const WalletJsiBinding&) = delete;
+
+  // invokeSync(requestJson, pretty?) -> string. Blocks the JS thread, so it
+  // is meant for reads that only touch the local database.
+  jsi::Value InvokeSync(jsi::Runtime& runtime, const jsi::Value* args,
+                        size_t count) {
+    const std::string request =
+        RequireString(runtime, args, count, 0, "requestJson");
+    const char* response = nullptr;
+    size_t response_len = 0;
+    int32_t status = service_ == nullptr
+                         ? PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT
+                         : pirate_wallet_service_invoke_json_arena(
+                               service_, request.data(), request.size(),
+                               OptionalBool(args, count, 1), &response,
+                               &response_len);
+    if (status == PIRATE_WALLET_SERVICE_OK && response == nullptr) {
+      status = PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    if (status != PIRATE_WALLET_SERVICE_OK) {
+      throw jsi::JSError(runtime, StatusMessage(status));
+    }
+    return jsi::String::createFromUtf8(
+        runtime, reinterpret_cast<const uint8_t*>(response), response_len);
+  }
+
+  // invokeSyncBuffer(requestJson, pretty?) -> ArrayBuffer of UTF-8 JSON. The
+  // service writes straight into the buffer JS receives.
+  jsi::Value InvokeSyncBuffer(jsi::Runtime& runtime, const jsi::Value* args,
+                              size_t count) {
+    const std::string request =
+        RequireString(runtime, args, count, 0, "requestJson");
+    if (service_ == nullptr) {
+      throw jsi::JSError(
+          runtime, StatusMessage(PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT));
+    }
+    std::vector<uint8_t> bytes(buffer_hint_);
+    size_t response_len = 0;
+    int32_t status = pirate_wallet_service_invoke_json_buffer(
+        service_, request.data(), request.size(), OptionalBool(args, count, 1),
+        bytes.data(), bytes.size(), &response_len);
+    if (status == PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL) {
+      // The response is still in the handle arena; copy it out once rather
+      // than running the request again.
+      const char* response = nullptr;
+      status = pirate_wallet_service_last_response(service_, &response,
+                                                   &response_len);
+      if (status == PIRATE_WALLET_SERVICE_OK && response != nullptr) {
+        bytes = std::vector<uint8_t>(response, response + response_len);
+      }
+      buffer_hint_ = std::min(std::max(buffer_hint_, response_len),
+                              kMaxBufferHintBytes);
+    }
+    if (status != PIRATE_WALLET_SERVICE_OK) {
+      throw jsi::JSError(runtime, StatusMessage(status));
+    }
+    // JS only sees |response_len| bytes, so drop the rest of the hint rather
+    // than leave it held by an ArrayBuffer the GC thinks is small.
+    bytes.resize(response_len);
+    bytes.shrink_to_fit();
+    return MakeArrayBuffer(runtime, std::move(bytes));
+  }
+
+  // invokeCborSync(ArrayBuffer) -> ArrayBuffer. The request is read in place
+  // from the JS buffer.
+  jsi::Value InvokeCborSync(jsi::Runtime& runtime, const jsi::Value* args,
+                            size_t count) {
+    if (count < 1 || !args[0].isObject() ||
+        !args[0].getObject(runtime).isArrayBuffer(runtime)) {
+      throw jsi::JSError(runtime, "request must be an ArrayBuffer");
+    }
+    jsi::ArrayBuffer request =
+        args[0].getObject(runtime).getArrayBuffer(runtime);
+    const uint8_t* response = nullptr;
+    size_t response_len = 0;
+    int32_t status =
+        service_ == nullptr
+            ? PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT
+            : pirate_wallet_service_invoke_cbor_arena(
+                  service_, request.data(runtime), request.size(runtime),
+                  &response, &response_len);
+    if (status == PIRATE_WALLET_SERVICE_OK && response == nullptr) {
+      status = PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    if (status != PIRATE_WALLET_SERVICE_OK) {
+      throw jsi::JSError(runtime, StatusMessage(status));
+    }
+    return MakeArrayBuffer(
+        runtime, std::vector<uint8_t>(response, response + response_len));
+  }
+
+  // invoke(requestJson, pretty?) -> Promise<string>, run on the wallet
+  // service runtime and settled on the JS thread.
+  jsi::Value Invoke(jsi::Runtime& runtime, const jsi::Value* args,
+                    size_t count) {
+    std::string request = RequireString(runtime, args, count, 0, "requestJson");
+    const bool pretty = OptionalBool(args, count, 1);
+    std::weak_ptr<WalletJsiBinding> weak = weak_from_this();
+    auto executor = jsi::Function::createFromHostFunction(
+        runtime, jsi::PropNameID::forAscii(runtime, "executor"), 2,
+        [weak, request = std::move(request), pretty](
+            jsi::Runtime& runtime, const jsi::Value&, const jsi::Value* args,
+            size_t) -> jsi::Value {
+          std::shared_ptr<WalletJsiBinding> self = weak.lock();
+          if (self != nullptr) {
+            self->StartInvoke(runtime, request, pretty,
+                              args[0].getObject(runtime).getFunction(runtime),
+                              args[1].getObject(runtime).getFunction(runtime));
+          }
+          return jsi::Value::undefined();
+        });
+    return runtime.global()
+        .getPropertyAsFunction(runtime, "Promise")
+        .callAsConstructor(runtime, executor);
+  }
+
+  // subscribe(walletId, intervalMs, listener) -> listener id. The listener
+  // receives coalesced sync events on the JS thread.
+  jsi::Value Subscribe(jsi::Runtime& runtime, const jsi::Value* args,
+                       size_t count) {
+    const std::string wallet_id =
+        RequireString(runtime, args, count, 0, "walletId");
+    const double interval_ms =
+        count > 1 && args[1].isNumber() && args[1].getNumber() > 0
+            ? std::min(args[1].getNumber(), 60000.0)
+            : 0;
+    if (count < 3 || !args[2].isObject() ||
+        !args[2].getObject(runtime).isFunction(runtime)) {
+      throw jsi::JSError(runtime, "listener must be a function");
+    }
+    if (invalidated_) {
+      throw jsi::JSError(runtime, "Wallet service binding was invalidated.");
+    }
+
+    const uint64_t listener_id = next_id_++;
+    auto* context = new EventContext{weak_from_this(), invoker_, listener_id};
+    const uint64_t subscription_id = pirate_wallet_service_subscribe(
+        wallet_id.c_str(),
+        static_cast<uint32_t>(interval_ms),
+        &OnWalletEvent, context);
+    if (subscription_id == 0) {
+      delete context;
+      throw jsi::JSError(runtime, "Wallet service rejected the subscription.");
+    }
+    listeners_.emplace(
+        listener_id,
+        Listener{std::make_shared<jsi::Function>(
+                     args[2].getObject(runtime).getFunction(runtime)),
+                 subscription_id, context});
+    return static_cast<double>(listener_id);
+  }
+
+  // unsubscribe(listenerId) -> boolean.
+  jsi::Value Unsubscribe(jsi::Runtime& runtime, const jsi::Value* args,
+                         size_t count) {
+    if (count < 1 || !args[0].isNumber()) {
+      throw jsi::JSError(runtime, "listenerId must be a number");
+    }
+    auto it = listeners_.find(static_cast<uint64_t>(args[0].getNumber()));
+    if (it == listeners_.end()) {
+      return false;
+    }
+    pirate_wallet_service_unsubscribe(it->second.subscription_id);
+    delete it->second.context;
+    listeners_.erase(it);
+    return true;
+  }
+
+ private:
+  struct PendingCall {
+    uint64_t request_id;
+    jsi::Function resolve;
+    jsi::Function reject;
+  };
+
+  struct AsyncContext {
+    std::weak_ptr<WalletJsiBinding> binding;
+    std::shared_ptr<CallInvoker> invoker;
+    uint64_t call_id;
+  };
+
+  struct EventContext {
+    std::weak_ptr<WalletJsiBinding> binding;
+    std::shared_ptr<CallInvoker> invoker;
+    uint64_t listener_id;
+  };
+
+  struct Listener {
+    // Shared so a listener that unsubscribes itself stays alive until its
+    // call returns.
+    std::shared_ptr<jsi::Function> callback;
+    uint64_t subscription_id;
+    EventContext* context;
+  };
+
+  static void OnInvokeCompleted(uint64_t, int32_t status, const char* response,
+                                size_t response_len, void* user_data) {
+    std::unique_ptr<AsyncContext> context(
+        static_cast<AsyncContext*>(user_data));
+    std::string body;
+    if (status == PIRATE_WALLET_SERVICE_OK && response != nullptr) {
+      body.assign(response, response_len);
+    } else if (status == PIRATE_WALLET_SERVICE_OK) {
+      status = PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    context->invoker->invokeAsync(
+        [binding = context->binding, call_id = context->call_id, status,
+         body = std::move(body)]() {
+          if (std::shared_ptr<WalletJsiBinding> self = binding.lock()) {
+            self->Settle(call_id, status, body);
+          }
+        });
+  }
+
+  static void OnWalletEvent(uint64_t, const pirate_wallet_event_t* event,
+                            void* user_data) {
+    const auto* context = static_cast<const EventContext*>(user_data);
+    context->invoker->invokeAsync(
+        [binding = context->binding, listener_id = context->listener_id,
+         event = *event]() {
+          if (std::shared_ptr<WalletJsiBinding> self = binding.lock()) {
+            self->Dispatch(listener_id, event);
+          }
+        });
+  }
+
+  void StartInvoke(jsi::Runtime& runtime, const std::string& request,
+                   bool pretty, jsi::Function resolve, jsi::Function reject) {
+    if (invalidated_) {
+      reject.call(runtime,
+                  MakeError(runtime, "PIRATE_WALLET_INVOKE_ERROR",
+                            "Wallet service binding was invalidated."));
+      return;
+    }
+    const uint64_t call_id = next_id_++;
+    auto* context = new AsyncContext{weak_from_this(), invoker_, call_id};
+    const uint64_t request_id = pirate_wallet_service_invoke_async(
+        request.data(), request.size(), pretty, &OnInvokeCompleted, context);
+    if (request_id == 0) {
+      delete context;
+      reject.call(runtime,
+                  MakeStatusError(runtime,
+                                  PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT));
+      return;
+    }
+    calls_.emplace(call_id, PendingCall{request_id, std::move(resolve),
+                                        std::move(reject)});
+  }
+
+  void Settle(uint64_t call_id, int32_t status, const std::string& body) {
+    auto it = calls_.find(call_id);
+    if (it == calls_.end()) {
+      return;
+    }
+    PendingCall call = std::move(it->second);
+    calls_.erase(it);
+    if (status == PIRATE_WALLET_SERVICE_OK) {
+      CallFromInvoker(
+          runtime_, call.resolve,
+          jsi::String::createFromUtf8(
+              runtime_, reinterpret_cast<const uint8_t*>(body.data()),
+              body.size()));
+    } else {
+      CallFromInvoker(runtime_, call.reject,
+                      MakeStatusError(runtime_, status));
+    }
+  }
+
+  void Dispatch(uint64_t listener_id, const pirate_wallet_event_t& event) {
+    auto it = listeners_.find(listener_id);
+    if (it == listeners_.end()) {
+      return;
+    }
+    std::shared_ptr<jsi::Function> callback = it->second.callback;
+
+    jsi::Runtime& runtime = runtime_;
+    jsi::Object balance(runtime);
+    balance.setProperty(runtime, "total",
+                        AmountString(runtime, event.balance_total));
+    balance.setProperty(runtime, "spendable",
+                        AmountString(runtime, event.balance_spendable));
+    balance.setProperty(runtime, "pending",
+                        AmountString(runtime, event.balance_pending));
+
+    jsi::Object payload(runtime);
+    payload.setProperty(runtime, "changed", static_cast<double>(event.changed));
+    payload.setProperty(runtime, "newTxCount",
+                        static_cast<double>(event.new_tx_count));
+    payload.setProperty(runtime, "localHeight",
+                        static_cast<double>(event.local_height));
+    payload.setProperty(runtime, "targetHeight",
+                        static_cast<double>(event.target_height));
+    payload.setProperty(runtime, "notesDecrypted",
+                        static_cast<double>(event.notes_decrypted));
+    payload.setProperty(runtime, "balance", std::move(balance));
+    CallFromInvoker(runtime, *callback, std::move(payload));
+  }
+
+  jsi::Runtime& runtime_;
+  std::shared_ptr<CallInvoker> invoker_;
+  // Used only from the JS thread, which serializes calls on the handle.
+  pirate_wallet_service_t* service_;
+  size_t buffer_hint_ = kInitialBufferHintBytes;
+  uint64_t next_id_ = 1;
+  bool invalidated_ = false;
+  std::unordered_map<uint64_t, PendingCall> calls_;
+  std::unordered_map<uint64_t, Listener> listeners_;
+};
+
+class WalletJsiHostObject : public jsi::HostObject {
+ public:
+  explicit WalletJsiHostObject(std::shared_ptr<WalletJsiBinding> binding)
+      : binding_(std::move(binding)) {}
+
+  jsi::Value get(jsi::Runtime& runtime, const jsi::PropNameID& name) override {
+    const std::string property = name.utf8(runtime);
+    if (property == "invokeSync") {
+      return Method(runtime, name, 2, &WalletJsiBinding::InvokeSync);
+    }
+    if (property == "invokeSyncBuffer") {
+      return Method(runtime, name, 2, &WalletJsiBinding::InvokeSyncBuffer);
+    }
+    if (property == "invokeCborSync") {
+      return Method(runtime, name, 1, &WalletJsiBinding::InvokeCborSync);
+    }
+    if (property == "invoke") {
+      return Method(runtime, name, 2, &WalletJsiBinding::Invoke);
+    }
+    if (property == "subscribe") {
+      return Method(runtime, name, 3, &WalletJsiBinding::Subscribe);
+    }
+    if (property == "unsubscribe") {
+      return Method(runtime, name, 1, &WalletJsiBinding::Unsubscribe);
+    }
+    return jsi::Value::undefined();
+  }
+
+  std::vector<jsi::PropNameID> getPropertyNames(
+      jsi::Runtime& runtime) override {
+    std::vector<jsi::PropNameID> names;
+    for (const char* name : {"invokeSync", "invokeSyncBuffer", "invokeCborSync",
+                             "invoke", "subscribe", "unsubscribe"}) {
+      names.push_back(jsi::PropNameID::forAscii(runtime, name));
+    }
+    return names;
+  }
+
+ private:
+  using MethodPtr = jsi::Value (WalletJsiBinding::*)(jsi::Runtime&,
+                                                     const jsi::Value*, size_t);
+
+  // The returned function keeps the binding alive on its own, so JS may hold
+  // on to `invokeSync` and friends after dropping the host object.
+  jsi::Value Method(jsi::Runtime& runtime, const jsi::PropNameID& name,
+                    unsigned int arg_count, MethodPtr method) {
+    return jsi::Function::createFromHostFunction(
+        runtime, name, arg_count,
+        [binding = binding_, method](jsi::Runtime& runtime, const jsi::Value&,
+                                     const jsi::Value* args,
+                                     size_t count) -> jsi::Value {
+          return ((*binding).*method)(runtime, args, count);
+        });
+  }
+
+  std::shared_ptr<WalletJsiBinding> binding_;
+};
+
+// Installed bindings by runtime, for InvalidatePirateWalletJsi. A reload can
+// install into a new runtime on a new JS thread while the old one winds down.
+std::mutex g_bindings_mutex;
+
+std::unordered_map<jsi::Runtime*, std::weak_ptr<WalletJsiBinding>>&
+Bindings() {
+  static auto* bindings =
+      new std::unordered_map<jsi::Runtime*, std::weak_ptr<WalletJsiBinding>>();
+  return *bindings;
+}
+
+std::shared_ptr<WalletJsiBinding> TakeBinding(jsi::Runtime& runtime) {
+  std::lock_guard<std::mutex> lock(g_bindings_mutex);
+  auto it = Bindings().find(&runtime);
+  if (it == Bindings().end()) {
+    return nullptr;
+  }
+  std::shared_ptr<WalletJsiBinding> binding = it->second.lock();
+  Bindings().erase(it);
+  return binding;
+}
+
+}  // namespace
+
+void InstallPirateWalletJsi(jsi::Runtime& runtime,
+                            std::shared_ptr<CallInvoker> call_invoker) {
+  // A second install into the same runtime replaces the first binding.
+  if (std::shared_ptr<WalletJsiBinding> previous = TakeBinding(runtime)) {
+    previous->Invalidate();
+  }
+  auto binding =
+      std::make_shared<WalletJsiBinding>(runtime, std::move(call_invoker));
+  {
+    std::lock_guard<std::mutex> lock(g_bindings_mutex);
+    Bindings()[&runtime] = binding;
+  }
+  runtime.global().setProperty(
+      runtime, kGlobalName,
+      jsi::Object::createFromHostObject(
+          runtime, std::make_shared<WalletJsiHostObject>(std::move(binding))));
+}
+
+void InvalidatePirateWalletJsi(jsi::Runtime& runtime) {
+  if (std::shared_ptr<WalletJsiBinding> binding = TakeBinding(runtime)) {
+    binding->Invalidate();
+  }
+}
+
+}  // namespace pirate
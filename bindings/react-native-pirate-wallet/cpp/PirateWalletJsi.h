@@ -0,0 +1,27 @@
+#pragma once
+
+#include <jsi/jsi.h>
+
+#include <memory>
+
+namespace facebook::react {
+class CallInvoker;
+}
+
+namespace pirate {
+
+// Installs `global.__pirateWalletJsi`, a host object that calls the native
+// wallet service without going through the React Native bridge. Must run on
+// the JS thread; `call_invoker` schedules promise settlement and wallet
+// events back onto it.
+void InstallPirateWalletJsi(
+    facebook::jsi::Runtime& runtime,
+    std::shared_ptr<facebook::react::CallInvoker> call_invoker);
+
+// Cancels the calls and drops the promises and event listeners of the binding
+// installed into |runtime|, so none of its JS functions outlive the runtime.
+// Hosts call it on the JS thread when the React instance is torn down; later
+// invoke and subscribe calls on the stale host object are rejected.
+void InvalidatePirateWalletJsi(facebook::jsi::Runtime& runtime);
+
+}  // namespace pirate
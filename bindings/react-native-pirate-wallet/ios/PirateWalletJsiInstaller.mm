@@ -0,0 +1,64 @@
+#import <Foundation/Foundation.h>
+#import <React/RCTBridge+Private.h>
+#import <React/RCTBridgeModule.h>
+#import <ReactCommon/RCTTurboModule.h>
+#import <jsi/jsi.h>
+
+#include "PirateWalletJsi.h"
+
+// Installs the JSI host object from cpp/PirateWalletJsi.cpp. JS calls
+// `install()` once, synchronously, before using `global.__pirateWalletJsi`;
+// when it returns false the JS wrapper keeps using PirateWalletReactNative.
+@interface PirateWalletJsi : NSObject <RCTBridgeModule, RCTInvalidating>
+@end
+
+@implementation PirateWalletJsi {
+  // Runtime the host object went into, until the bridge is invalidated.
+  facebook::jsi::Runtime *_runtime;
+}
+
+@synthesize bridge = _bridge;
+
+RCT_EXPORT_MODULE();
+
++ (BOOL)requiresMainQueueSetup
+{
+  return NO;
+}
+
+RCT_EXPORT_BLOCKING_SYNCHRONOUS_METHOD(install)
+{
+  // Synchronous methods run on the JS thread, which the host object needs.
+  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)self.bridge;
+  if (cxxBridge == nil || ![cxxBridge respondsToSelector:@selector(runtime)] ||
+      cxxBridge.runtime == nullptr) {
+    return @NO;
+  }
+
+  std::shared_ptr<facebook::react::CallInvoker> callInvoker = cxxBridge.jsCallInvoker;
+  if (callInvoker == nullptr) {
+    return @NO;
+  }
+
+  _runtime = static_cast<facebook::jsi::Runtime *>(cxxBridge.runtime);
+  pirate::InstallPirateWalletJsi(*_runtime, callInvoker);
+  return @YES;
+}
+
+// Pending promises and listeners hold JS functions, so they are dropped on
+// the JS thread while the runtime is still alive.
+- (void)invalidate
+{
+  facebook::jsi::Runtime *runtime = _runtime;
+  _runtime = nullptr;
+  RCTCxxBridge *cxxBridge = (RCTCxxBridge *)self.bridge;
+  if (runtime == nullptr || cxxBridge == nil) {
+    return;
+  }
+  [cxxBridge dispatchBlock:^{
+    pirate::InvalidatePirateWalletJsi(*runtime);
+  }
+                     queue:RCTJSThread];
+}
+
+@end
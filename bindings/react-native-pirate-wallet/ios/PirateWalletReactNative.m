@@ -5,7 +5,49 @@
 @interface PirateWalletReactNative : NSObject <RCTBridgeModule>
 @end
 
-@implementation PirateWalletReactNative
+// Carries a promise through pirate_wallet_service_invoke_async. Retained for
+// the lifetime of the request and released by the completion callback.
+@interface PirateWalletPendingInvoke : NSObject
+@property (nonatomic, copy) RCTPromiseResolveBlock resolve;
+@property (nonatomic, copy) RCTPromiseRejectBlock reject;
+@end
+
+@implementation PirateWalletPendingInvoke
+@end
+
+static void PirateWalletInvokeCompleted(uint64_t requestId,
+                                        int32_t status,
+                                        const char *response,
+                                        size_t responseLength,
+                                        void *userData)
+{
+  PirateWalletPendingInvoke *pending = (__bridge_transfer PirateWalletPendingInvoke *)userData;
+  if (status == PIRATE_WALLET_SERVICE_CANCELLED) {
+    pending.reject(@"PIRATE_WALLET_INVOKE_CANCELLED", @"Wallet service request was cancelled.", nil);
+    return;
+  }
+  if (status != PIRATE_WALLET_SERVICE_OK || response == NULL) {
+    pending.reject(@"PIRATE_WALLET_INVOKE_ERROR", @"Wallet service returned a null response.", nil);
+    return;
+  }
+
+  NSString *responseString = [[NSString alloc] initWithBytes:response
+                                                      length:responseLength
+                                                    encoding:NSUTF8StringEncoding];
+  if (responseString == nil) {
+    pending.reject(@"PIRATE_WALLET_INVOKE_ERROR", @"Wallet service returned invalid UTF-8.", nil);
+    return;
+  }
+
+  pending.resolve(responseString);
+}
+
+@implementation PirateWalletReactNative {
+  // Used for calls that must finish before later ones run on this module's
+  // method queue (storage configuration). Responses land in the handle's
+  // arena instead of a fresh C string per call.
+  pirate_wallet_service_t *_service;
+}
 
 RCT_EXPORT_MODULE();
 
@@ -14,6 +56,19 @@ RCT_EXPORT_MODULE();
   return NO;
 }
 
+- (instancetype)init
+{
+  if ((self = [super init])) {
+    _service = pirate_wallet_service_new();
+  }
+  return self;
+}
+
+- (void)dealloc
+{
+  pirate_wallet_service_free(_service);
+}
+
 RCT_REMAP_METHOD(invoke,
                  invoke:(NSString *)requestJson
                  pretty:(BOOL)pretty
@@ -26,21 +81,22 @@ RCT_REMAP_METHOD(invoke,
     return;
   }
 
-  char *responsePtr = pirate_wallet_service_invoke_json(requestCString, pretty);
-  if (responsePtr == NULL) {
-    reject(@"PIRATE_WALLET_INVOKE_ERROR", @"Wallet service returned a null response.", nil);
-    return;
+  // Run on the wallet service runtime so a slow request does not hold up the
+  // calls queued behind it on this module's method queue.
+  PirateWalletPendingInvoke *pending = [PirateWalletPendingInvoke new];
+  pending.resolve = resolve;
+  pending.reject = reject;
+  void *userData = (__bridge_retained void *)pending;
+  uint64_t requestId = pirate_wallet_service_invoke_async(
+    requestCString,
+    [requestJson lengthOfBytesUsingEncoding:NSUTF8StringEncoding],
+    pretty,
+    PirateWalletInvokeCompleted,
+    userData);
+  if (requestId == 0) {
+    CFRelease(userData);
+    reject(@"PIRATE_WALLET_INVOKE_ERROR", @"Wallet service rejected the request.", nil);
   }
-
-  NSString *response = [NSString stringWithUTF8String:responsePtr];
-  pirate_wallet_service_free_string(responsePtr);
-
-  if (response == nil) {
-    reject(@"PIRATE_WALLET_INVOKE_ERROR", @"Wallet service returned invalid UTF-8.", nil);
-    return;
-  }
-
-  resolve(response);
 }
 
 RCT_REMAP_METHOD(configureAccountStorage,
@@ -81,28 +137,34 @@ RCT_REMAP_METHOD(configureAccountStorage,
     return;
   }
 
-  NSString *requestJson = [[NSString alloc] initWithData:requestData encoding:NSUTF8StringEncoding];
-  if (requestJson == nil) {
-    reject(@"PIRATE_WALLET_CONFIGURE_STORAGE_ERROR", @"Storage configuration request was not valid UTF-8.", nil);
+  NSString *response = [self invokeRequest:(const char *)requestData.bytes
+                                    length:requestData.length
+                                    pretty:NO];
+  if (response == nil) {
+    reject(@"PIRATE_WALLET_CONFIGURE_STORAGE_ERROR", @"Wallet service returned an invalid response.", nil);
     return;
   }
 
-  const char *requestCString = [requestJson UTF8String];
-  char *responsePtr = pirate_wallet_service_invoke_json(requestCString, NO);
-  if (responsePtr == NULL) {
-    reject(@"PIRATE_WALLET_CONFIGURE_STORAGE_ERROR", @"Wallet service returned a null response.", nil);
-    return;
-  }
+  resolve(response);
+}
 
-  NSString *response = [NSString stringWithUTF8String:responsePtr];
-  pirate_wallet_service_free_string(responsePtr);
+- (NSString *)invokeRequest:(const char *)request length:(NSUInteger)length pretty:(BOOL)pretty
+{
+  if (_service == NULL) {
+    return nil;
+  }
 
-  if (response == nil) {
-    reject(@"PIRATE_WALLET_CONFIGURE_STORAGE_ERROR", @"Wallet service returned invalid UTF-8.", nil);
-    return;
+  const char *responsePtr = NULL;
+  size_t responseLength = 0;
+  int32_t status = pirate_wallet_service_invoke_json_arena(
+    _service, request, length, pretty, &responsePtr, &responseLength);
+  if (status != PIRATE_WALLET_SERVICE_OK || responsePtr == NULL) {
+    return nil;
   }
 
-  resolve(response);
+  return [[NSString alloc] initWithBytes:responsePtr
+                                  length:responseLength
+                                encoding:NSUTF8StringEncoding];
 }
 
 - (NSString *)storagePathForAccountId:(NSString *)accountId
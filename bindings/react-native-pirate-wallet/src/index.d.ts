@@ -61,6 +61,32 @@ export interface SynchronizerCallbacks {
   onError?(error: Error): void
 }
 
+export const WALLET_EVENT_HEIGHT: 1
+export const WALLET_EVENT_NOTES: 2
+export const WALLET_EVENT_BALANCE: 4
+export const WALLET_EVENT_NEW_TX: 8
+
+export interface WalletEvent {
+  /** Bitmask of WALLET_EVENT_* flags for what changed since the last event. */
+  changed: number
+  newTxCount: number
+  localHeight: number
+  targetHeight: number
+  notesDecrypted: number
+  balance: { total: AmountString; spendable: AmountString; pending: AmountString }
+}
+
+/** `global.__pirateWalletJsi`, installed by the PirateWalletJsi native module. */
+export interface PirateWalletJsiBinding {
+  invoke(requestJson: string, pretty?: boolean): Promise<string>
+  invokeSync(requestJson: string, pretty?: boolean): string
+  /** UTF-8 JSON response envelope, written by the service straight into the buffer. */
+  invokeSyncBuffer(requestJson: string, pretty?: boolean): ArrayBuffer
+  invokeCborSync(request: ArrayBuffer): ArrayBuffer
+  subscribe(walletId: string, intervalMs: number, listener: (event: WalletEvent) => void): number
+  unsubscribe(listenerId: number): boolean
+}
+
 export interface PaymentDisclosure {
   disclosureType: 'sapling' | 'orchard' | string
   txid: string
@@ -148,6 +174,14 @@ export interface FeeInfo {
   memoFeeMultiplier: number
 }
 
+export type ProverState = 'cold' | 'loading' | 'ready'
+
+export interface ProverStatus {
+  state: ProverState
+  saplingReady: boolean
+  prewarmMs: number | null
+}
+
 export class PirateWalletAdvancedKeyManagement {
   listKeyGroups(walletId: string): Promise<any[]>
   exportKeyGroupKeys(walletId: string, keyId: number): Promise<any>
@@ -183,8 +217,16 @@ export class PirateWalletSynchronizer {
 }
 
 export class PirateWalletSdk {
+  constructor(nativeModule?: any, options?: { jsi?: PirateWalletJsiBinding | null })
   advancedKeyManagement: PirateWalletAdvancedKeyManagement
   invoke(requestJson: string, pretty?: boolean): Promise<string>
+  invokeSync(requestJson: string, pretty?: boolean): string
+  supportsWalletEvents(): boolean
+  subscribeWalletEvents(
+    walletId: string,
+    listener: (event: WalletEvent) => void,
+    intervalMs?: number
+  ): () => void
   configureAccountStorage(config: PirateWalletAccountStorageConfig): Promise<any>
   createSynchronizer(walletId: string, config?: SynchronizerConfig): PirateWalletSynchronizer
   buildInfoJson(pretty?: boolean): Promise<string>
@@ -228,6 +270,8 @@ export class PirateWalletSdk {
   exportOrchardPaymentDisclosure(walletId: string, txId: string, actionIndex: number): Promise<string>
   verifyPaymentDisclosure(walletId: string, disclosure: string): Promise<PaymentDisclosureVerification>
   getFeeInfo(): Promise<FeeInfo>
+  prewarmProver(): Promise<ProverStatus>
+  getProverStatus(): Promise<ProverStatus>
   startSync(walletIdOrRequest: any, mode?: SyncMode): Promise<any>
   getSyncStatus(walletId: string): Promise<any>
   cancelSync(walletId: string): Promise<any>
@@ -24,6 +24,58 @@ function getNativeModule() {
   return nativeModule
 }
 
+// Returns the JSI host object from cpp/PirateWalletJsi.cpp, installing it on
+// first use, or null when the app runs without it (remote debugging, a bridge
+// without a JS runtime). Callers then fall back to the bridge module.
+function getJsiBinding() {
+  if (global.__pirateWalletJsi != null) {
+    return global.__pirateWalletJsi
+  }
+
+  try {
+    const installer = require('react-native').NativeModules.PirateWalletJsi
+    if (installer && typeof installer.install === 'function' && installer.install()) {
+      return global.__pirateWalletJsi || null
+    }
+  } catch (error) {
+    // Not running inside React Native, or the installer is not linked.
+  }
+  return null
+}
+
+// Wallet event bits, as delivered in `event.changed`.
+const WALLET_EVENT_HEIGHT = 1
+const WALLET_EVENT_NOTES = 2
+const WALLET_EVENT_BALANCE = 4
+const WALLET_EVENT_NEW_TX = 8
+
+// Reads that only touch the local databases. With JSI they run synchronously
+// on the JS thread, which skips the bridge queue and the promise hop that
+// list-heavy screens otherwise pay per call. Reads scoped to a wallet only do
+// so once that wallet answered an async call: the first one opens and
+// decrypts its database, which is too slow for the JS thread.
+const SYNC_READ_METHODS = new Set([
+  'current_receive_address',
+  'format_amount',
+  'get_active_wallet',
+  'get_balance',
+  'get_build_info',
+  'get_network_info',
+  'get_prover_status',
+  'get_shielded_pool_balances',
+  'get_spendability_status',
+  'get_watch_only_capabilities',
+  'is_valid_shielded_address',
+  'list_address_balances',
+  'list_addresses',
+  'list_transactions',
+  'list_wallets',
+  'parse_amount',
+  'sync_status',
+  'validate_address',
+  'wallet_registry_exists'
+])
+
 const AMOUNT_WIRE_KEYS = new Set([
   'amount',
   'arrrtoshis',
@@ -289,6 +341,7 @@ class PirateWalletSynchronizer {
     this.updatedAtMillis = null
 
     this._timer = null
+    this._unsubscribeEvents = null
     this._subscribers = new Set()
   }
 
@@ -333,6 +386,7 @@ class PirateWalletSynchronizer {
     try {
       await this.sdk.startSync(this.walletId, this.config.syncMode)
       this._schedule(0)
+      this._watchEvents()
     } catch (error) {
       this.status = 'STOPPED'
       this.lastError = error
@@ -350,6 +404,10 @@ class PirateWalletSynchronizer {
       clearTimeout(this._timer)
       this._timer = null
     }
+    if (this._unsubscribeEvents !== null) {
+      this._unsubscribeEvents()
+      this._unsubscribeEvents = null
+    }
 
     this.status = 'STOPPED'
     this.updatedAtMillis = Date.now()
@@ -385,6 +443,23 @@ class PirateWalletSynchronizer {
     }
   }
 
+  // With JSI, wallet events refresh the snapshot as soon as something changes;
+  // polling stays in place as the fallback and for the synced interval.
+  _watchEvents() {
+    if (this._unsubscribeEvents !== null || !this.sdk.supportsWalletEvents()) {
+      return
+    }
+    this._unsubscribeEvents = this.sdk.subscribeWalletEvents(
+      this.walletId,
+      event => {
+        if (this._timer !== null) {
+          this._schedule(0)
+        }
+      },
+      this.config.syncingPollIntervalMs
+    )
+  }
+
   _schedule(delayMs) {
     if (this._timer !== null) {
       clearTimeout(this._timer)
@@ -476,18 +551,71 @@ class PirateWalletSynchronizer {
 }
 
 class PirateWalletSdk {
-  constructor(nativeModule = getNativeModule()) {
+  // Pass `jsi: null` to force the bridge module, for example in tests.
+  constructor(nativeModule = getNativeModule(), options = {}) {
     this._native = nativeModule
+    this._jsi = options.jsi !== undefined ? options.jsi : getJsiBinding()
+    // Wallets whose database an async call has opened this session.
+    this._openWallets = new Set()
     this.advancedKeyManagement = new PirateWalletAdvancedKeyManagement(this)
   }
 
   async invoke(requestJson, pretty = false) {
+    if (this._jsi) {
+      return this._jsi.invoke(requestJson, pretty)
+    }
     return this._native.invoke(requestJson, pretty)
   }
 
+  // Runs the request on the JS thread and returns the response envelope.
+  // Only available with JSI; keep it to reads that do not hit the network.
+  invokeSync(requestJson, pretty = false) {
+    if (!this._jsi) {
+      throw new Error('Synchronous calls need the PirateWalletJsi host object.')
+    }
+    return this._jsi.invokeSync(requestJson, pretty)
+  }
+
+  supportsWalletEvents() {
+    return Boolean(this._jsi)
+  }
+
+  // Calls `listener` with { changed, newTxCount, localHeight, targetHeight,
+  // notesDecrypted, balance: { total, spendable, pending } } at most once per
+  // intervalMs while the wallet changes. Returns an unsubscribe function.
+  subscribeWalletEvents(walletId, listener, intervalMs = 250) {
+    if (!this._jsi) {
+      throw new Error('Wallet events need the PirateWalletJsi host object.')
+    }
+    const listenerId = this._jsi.subscribe(walletId, intervalMs, listener)
+    let subscribed = true
+    return () => {
+      if (subscribed) {
+        subscribed = false
+        this._jsi.unsubscribe(listenerId)
+      }
+    }
+  }
+
   async _call(method, params = {}, pretty = false) {
-    const response = await this.invoke(buildRequest(method, params), pretty)
-    return unwrapEnvelope(response, method)
+    const request = buildRequest(method, params)
+    const walletId = params.wallet_id
+    const sync =
+      Boolean(this._jsi) &&
+      SYNC_READ_METHODS.has(method) &&
+      (walletId === undefined || this._openWallets.has(walletId))
+    const response = sync
+      ? this._jsi.invokeSync(request, pretty)
+      : await this.invoke(request, pretty)
+    const result = unwrapEnvelope(response, method)
+    if (walletId !== undefined) {
+      if (method === 'delete_wallet') {
+        this._openWallets.delete(walletId)
+      } else {
+        this._openWallets.add(walletId)
+      }
+    }
+    return result
   }
 
   // Like _call, but returns the result without camelizing it. Use for RPCs
@@ -532,6 +660,8 @@ class PirateWalletSdk {
       config.passphrase,
       storagePath
     )
+    // Databases are reopened under the new storage and passphrase.
+    this._openWallets.clear()
     return unwrapEnvelope(response, 'configure_wallet_storage')
   }
 
@@ -769,6 +899,16 @@ class PirateWalletSdk {
     return this._call('get_fee_info')
   }
 
+  // Starts loading proving parameters in the background so the first send
+  // does not stall; call when the send screen opens.
+  prewarmProver() {
+    return this._call('prewarm_prover')
+  }
+
+  getProverStatus() {
+    return this._call('get_prover_status')
+  }
+
   startSync(walletIdOrRequest, mode = 'Compact') {
     const request =
       typeof walletIdOrRequest === 'object' && walletIdOrRequest !== null
@@ -869,6 +1009,10 @@ function createPirateWalletSdk() {
 }
 
 module.exports = {
+  WALLET_EVENT_HEIGHT,
+  WALLET_EVENT_NOTES,
+  WALLET_EVENT_BALANCE,
+  WALLET_EVENT_NEW_TX,
   PirateWalletSdk,
   PirateWalletSynchronizer,
   PirateWalletAdvancedKeyManagement,
@@ -14,6 +14,7 @@ pub mod error;
 pub mod fees;
 pub mod keys;
 pub mod memo;
+pub mod memory_budget;
 pub mod mnemonic;
 pub mod notes;
 pub mod params;
@@ -36,7 +37,10 @@ pub use fees::{
 };
 pub use memo::{Memo, MAX_MEMO_LENGTH, MEMO_WARNING_LENGTH};
 pub use mnemonic::{inspect_mnemonic, MnemonicInspection, MnemonicLanguage};
-pub use params::{orchard_params, sapling_params, sapling_prover};
+pub use params::{
+    orchard_params, prewarm_provers, prover_status, sapling_params, sapling_prover, ProverState,
+    ProverStatus,
+};
 pub use qortal_p2sh::{
     build_p2sh_script_sig, build_qortal_p2sh_funding_transaction,
     build_qortal_p2sh_redeem_transaction, build_script_pubkey, QortalP2shFundingPlan,
@@ -0,0 +1,369 @@
+//! Process-wide memory budget for low-RAM devices.
+//!
+//! Sync batches, the prefetch queue, block cache reads and the prover each
+//! size their working set on their own, and on a 2–3 GB phone their sum can
+//! exceed what the OS lets the app keep. A host that knows it runs on such a
+//! device sets a budget once at startup. Each consumer then gets a fixed share
+//! of it: sync and the block cache cap their batch and read sizes to their
+//! share, and the prover waits for earlier builds to release theirs.
+//!
+//! Without a budget nothing is capped or delayed; charges are still counted,
+//! so diagnostics show the high-water marks a budget would have to cover.
+
+use serde::Serialize;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::{Condvar, Mutex};
+use std::time::Instant;
+
+const MB: u64 = 1_000_000;
+
+/// Smallest budget accepted. Below this the fixed costs (Sapling parameters,
+/// one batch of blocks) no longer fit and every consumer would stall.
+pub const MIN_MEMORY_BUDGET_BYTES: u64 = 128 * MB;
+
+/// Part of the process that draws on the memory budget.
+#[derive(Clone, Copy, Debug, PartialEq, Eq)]
+pub enum MemoryConsumer {
+    /// Blocks and decrypted outputs of the batch being scanned.
+    SyncBatch,
+    /// Batches fetched ahead of the scanner.
+    Prefetch,
+    /// Reads from the compact block cache.
+    BlockCache,
+    /// Proving parameters and proof generation during transaction builds.
+    Prover,
+}
+
+const CONSUMERS: [MemoryConsumer; 4] = [
+    MemoryConsumer::SyncBatch,
+    MemoryConsumer::Prefetch,
+    MemoryConsumer::BlockCache,
+    MemoryConsumer::Prover,
+];
+
+impl MemoryConsumer {
+    /// Stable identifier for diagnostics.
+    pub fn as_str(self) -> &'static str {
+        match self {
+            Self::SyncBatch => "sync_batch",
+            Self::Prefetch => "prefetch",
+            Self::BlockCache => "block_cache",
+            Self::Prover => "prover",
+        }
+    }
+
+    /// Percent of the budget this consumer may use. Sync and proving rarely
+    /// overlap on a phone, but the shares still add up to the whole budget so
+    /// they can.
+    fn share_percent(self) -> u64 {
+        match self {
+            Self::SyncBatch => 35,
+            Self::Prefetch => 20,
+            Self::BlockCache => 10,
+            Self::Prover => 35,
+        }
+    }
+
+    fn index(self) -> usize {
+        self as usize
+    }
+}
+
+struct Counters {
+    in_use: AtomicU64,
+    high_water: AtomicU64,
+    /// Part of `in_use` held for the rest of the process.
+    resident: AtomicU64,
+    charges: AtomicU64,
+    waits: AtomicU64,
+    wait_ms_total: AtomicU64,
+}
+
+impl Counters {
+    const fn new() -> Self {
+        Self {
+            in_use: AtomicU64::new(0),
+            high_water: AtomicU64::new(0),
+            resident: AtomicU64::new(0),
+            charges: AtomicU64::new(0),
+            waits: AtomicU64::new(0),
+            wait_ms_total: AtomicU64::new(0),
+        }
+    }
+
+    fn add(&self, bytes: u64) {
+        let now = self.in_use.fetch_add(bytes, Ordering::Relaxed) + bytes;
+        self.high_water.fetch_max(now, Ordering::Relaxed);
+    }
+
+    /// Add `bytes` if they fit under `limit`, or if nothing but resident
+    /// charges is held. Checked and added in one step, so two waiters cannot
+    /// both take the last of the room.
+    fn try_add(&self, bytes: u64, limit: Option<u64>) -> bool {
+        let resident = self.resident.load(Ordering::Relaxed);
+        let reserved = self
+            .in_use
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |in_use| {
+                let fits = match limit {
+                    None => true,
+                    Some(limit) => in_use <= resident || in_use.saturating_add(bytes) <= limit,
+                };
+                fits.then(|| in_use.saturating_add(bytes))
+            });
+        match reserved {
+            Ok(previous) => {
+                self.high_water
+                    .fetch_max(previous.saturating_add(bytes), Ordering::Relaxed);
+                true
+            }
+            Err(_) => false,
+        }
+    }
+
+    fn sub(&self, bytes: u64) {
+        let _ = self
+            .in_use
+            .fetch_update(Ordering::Relaxed, Ordering::Relaxed, |value| {
+                Some(value.saturating_sub(bytes))
+            });
+    }
+}
+
+/// Zero means no budget.
+static BUDGET_BYTES: AtomicU64 = AtomicU64::new(0);
+static TOTAL: Counters = Counters::new();
+static PER_CONSUMER: [Counters; 4] = [
+    Counters::new(),
+    Counters::new(),
+    Counters::new(),
+    Counters::new(),
+];
+/// Woken whenever a charge is released, for [`charge_blocking`].
+static RELEASED: (Mutex<()>, Condvar) = (Mutex::new(()), Condvar::new());
+
+/// Set the budget in bytes, or remove it with `None`. Takes effect at the
+/// next batch, cache read or build; work already sized keeps its size.
+pub fn set_memory_budget(bytes: Option<u64>) {
+    let bytes = bytes.unwrap_or(0);
+    let previous = BUDGET_BYTES.swap(bytes, Ordering::Relaxed);
+    if previous != bytes {
+        tracing::info!(
+            "memory budget {} -> {}",
+            describe_budget(previous),
+            describe_budget(bytes)
+        );
+        // Under the lock, like a release: a waiter between its fit check and
+        // its wait would otherwise sleep through a raised budget.
+        drop(RELEASED.0.lock());
+        RELEASED.1.notify_all();
+    }
+}
+
+fn describe_budget(bytes: u64) -> String {
+    if bytes == 0 {
+        "unlimited".to_string()
+    } else {
+        format!("{} MB", bytes / MB)
+    }
+}
+
+/// The current budget, or `None` when memory is not limited.
+pub fn memory_budget() -> Option<u64> {
+    match BUDGET_BYTES.load(Ordering::Relaxed) {
+        0 => None,
+        bytes => Some(bytes),
+    }
+}
+
+/// Bytes `consumer` may hold at once under the current budget.
+pub fn consumer_limit(consumer: MemoryConsumer) -> Option<u64> {
+    memory_budget().map(|budget| budget / 100 * consumer.share_percent())
+}
+
+/// `configured`, lowered to the consumer's share when a budget is set.
+pub fn cap_to_budget(consumer: MemoryConsumer, configured: u64) -> u64 {
+    consumer_limit(consumer).map_or(configured, |limit| configured.min(limit))
+}
+
+/// Accounted memory held by a consumer. Released when dropped.
+#[must_use = "the charge is released as soon as it is dropped"]
+pub struct MemoryCharge {
+    consumer: MemoryConsumer,
+    bytes: u64,
+}
+
+impl MemoryCharge {
+    /// Bytes held by this charge.
+    pub fn bytes(&self) -> u64 {
+        self.bytes
+    }
+
+    /// Replace the charged amount once the real size is known.
+    pub fn resize(&mut self, bytes: u64) {
+        let counters = &PER_CONSUMER[self.consumer.index()];
+        if bytes > self.bytes {
+            counters.add(bytes - self.bytes);
+            TOTAL.add(bytes - self.bytes);
+        } else if bytes < self.bytes {
+            counters.sub(self.bytes - bytes);
+            TOTAL.sub(self.bytes - bytes);
+            drop(RELEASED.0.lock());
+            RELEASED.1.notify_all();
+        }
+        self.bytes = bytes;
+    }
+}
+
+impl Drop for MemoryCharge {
+    fn drop(&mut self) {
+        PER_CONSUMER[self.consumer.index()].sub(self.bytes);
+        TOTAL.sub(self.bytes);
+        // Take the lock so a waiter cannot miss this between its check and
+        // its wait.
+        drop(RELEASED.0.lock());
+        RELEASED.1.notify_all();
+    }
+}
+
+/// Account `bytes` against `consumer` without waiting. For work whose size
+/// is already capped with [`cap_to_budget`].
+pub fn charge(consumer: MemoryConsumer, bytes: u64) -> MemoryCharge {
+    let counters = &PER_CONSUMER[consumer.index()];
+    counters.charges.fetch_add(1, Ordering::Relaxed);
+    counters.add(bytes);
+    TOTAL.add(bytes);
+    MemoryCharge { consumer, bytes }
+}
+
+/// Account `bytes` against `consumer` for the rest of the process, for
+/// memory that stays loaded once built, such as proving parameters. They
+/// count toward the consumer's share, but a lone [`charge_blocking`] that
+/// does not fit next to them still proceeds instead of waiting forever.
+pub fn charge_resident(consumer: MemoryConsumer, bytes: u64) {
+    let counters = &PER_CONSUMER[consumer.index()];
+    counters.charges.fetch_add(1, Ordering::Relaxed);
+    counters.resident.fetch_add(bytes, Ordering::Relaxed);
+    counters.add(bytes);
+    TOTAL.resident.fetch_add(bytes, Ordering::Relaxed);
+    TOTAL.add(bytes);
+}
+
+/// Like [`charge`], but first waits while other charges hold so much of the
+/// consumer's share that `bytes` would not fit. A charge larger than the whole
+/// share proceeds once the consumer is otherwise idle, so callers never wait
+/// forever. Blocking; call from a blocking context.
+pub fn charge_blocking(consumer: MemoryConsumer, bytes: u64) -> MemoryCharge {
+    let counters = &PER_CONSUMER[consumer.index()];
+    counters.charges.fetch_add(1, Ordering::Relaxed);
+    if !counters.try_add(bytes, consumer_limit(consumer)) {
+        let started = Instant::now();
+        let mut guard = RELEASED.0.lock().unwrap_or_else(|e| e.into_inner());
+        while !counters.try_add(bytes, consumer_limit(consumer)) {
+            guard = RELEASED.1.wait(guard).unwrap_or_else(|e| e.into_inner());
+        }
+        drop(guard);
+        counters.waits.fetch_add(1, Ordering::Relaxed);
+        counters.wait_ms_total.fetch_add(
+            u64::try_from(started.elapsed().as_millis()).unwrap_or(u64::MAX),
+            Ordering::Relaxed,
+        );
+    }
+    TOTAL.add(bytes);
+    MemoryCharge { consumer, bytes }
+}
+
+/// Usage of one consumer.
+#[derive(Debug, Clone, Serialize)]
+pub struct MemoryConsumerStats {
+    /// Consumer identifier, see [`MemoryConsumer::as_str`].
+    pub consumer: &'static str,
+    /// Share of the budget, when one is set.
+    pub limit_bytes: Option<u64>,
+    /// Bytes currently charged.
+    pub in_use_bytes: u64,
+    /// Part of `in_use_bytes` held for the rest of the process.
+    pub resident_bytes: u64,
+    /// Most bytes charged at once since start or the last reset.
+    pub high_water_bytes: u64,
+    /// Charges taken.
+    pub charges: u64,
+    /// Charges that waited for room.
+    pub waits: u64,
+    /// Total time spent waiting, in milliseconds.
+    pub wait_ms_total: u64,
+}
+
+/// Budget and usage for diagnostics.
+#[derive(Debug, Clone, Serialize)]
+pub struct MemoryBudgetStats {
+    /// Configured budget; `None` when memory is not limited.
+    pub budget_bytes: Option<u64>,
+    /// Bytes currently charged across all consumers.
+    pub in_use_bytes: u64,
+    /// Most bytes charged at once across all consumers.
+    pub high_water_bytes: u64,
+    /// Per-consumer usage.
+    pub consumers: Vec<MemoryConsumerStats>,
+}
+
+/// Current budget and usage.
+pub fn memory_budget_stats() -> MemoryBudgetStats {
+    MemoryBudgetStats {
+        budget_bytes: memory_budget(),
+        in_use_bytes: TOTAL.in_use.load(Ordering::Relaxed),
+        high_water_bytes: TOTAL.high_water.load(Ordering::Relaxed),
+        consumers: CONSUMERS
+            .iter()
+            .map(|&consumer| {
+                let counters = &PER_CONSUMER[consumer.index()];
+                MemoryConsumerStats {
+                    consumer: consumer.as_str(),
+                    limit_bytes: consumer_limit(consumer),
+                    in_use_bytes: counters.in_use.load(Ordering::Relaxed),
+                    resident_bytes: counters.resident.load(Ordering::Relaxed),
+                    high_water_bytes: counters.high_water.load(Ordering::Relaxed),
+                    charges: counters.charges.load(Ordering::Relaxed),
+                    waits: counters.waits.load(Ordering::Relaxed),
+                    wait_ms_total: counters.wait_ms_total.load(Ordering::Relaxed),
+                }
+            })
+            .collect(),
+    }
+}
+
+/// Restart high-water marks from current usage and zero the counters.
+pub fn reset_memory_budget_stats() {
+    for counters in PER_CONSUMER.iter().chain(std::iter::once(&TOTAL)) {
+        counters
+            .high_water
+            .store(counters.in_use.load(Ordering::Relaxed), Ordering::Relaxed);
+        counters.charges.store(0, Ordering::Relaxed);
+        counters.waits.store(0, Ordering::Relaxed);
+        counters.wait_ms_total.store(0, Ordering::Relaxed);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn shares_cap_configured_sizes_and_charges_track_high_water() {
+        set_memory_budget(Some(1_000 * MB));
+        assert_eq!(consumer_limit(MemoryConsumer::BlockCache), Some(100 * MB));
+        assert_eq!(cap_to_budget(MemoryConsumer::SyncBatch, 500 * MB), 350 * MB);
+        assert_eq!(cap_to_budget(MemoryConsumer::SyncBatch, MB), MB);
+
+        let before =
+            memory_budget_stats().consumers[MemoryConsumer::Prover.index()].high_water_bytes;
+        let mut first = charge_blocking(MemoryConsumer::Prover, 2_000 * MB);
+        first.resize(3_000 * MB);
+        drop(first);
+        let stats = memory_budget_stats();
+        let prover = &stats.consumers[MemoryConsumer::Prover.index()];
+        assert!(prover.high_water_bytes >= before.max(3_000 * MB));
+
+        set_memory_budget(None);
+        assert_eq!(cap_to_budget(MemoryConsumer::SyncBatch, 500 * MB), 500 * MB);
+    }
+}
@@ -5,17 +5,25 @@
 //! - Orchard proving/verification keys are constructed in-memory via
 //!   `orchard::circuit`.
 //!
-//! The parameters are initialised lazily and cached for reuse.
+//! The parameters are initialised lazily and cached for reuse. Loading the
+//! Sapling prover takes seconds on a phone, so hosts call [`prewarm_provers`]
+//! ahead of the first send and poll [`prover_status`] to know when a build
+//! will no longer stall on it. Orchard sends build their key inside the
+//! transaction builder, so only the Qortal P2SH builders use the cached one.
 
 use bellman::groth16::{Parameters, PreparedVerifyingKey};
 use bls12_381::Bls12;
 use once_cell::sync::OnceCell;
+use serde::Serialize;
 use std::io::Cursor;
 use std::path::PathBuf;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
 use std::sync::Arc;
+use std::time::Instant;
 use tempfile::{Builder, NamedTempFile};
 use zcash_proofs::prover::LocalTxProver;
 
+use crate::memory_budget::{charge_resident, MemoryConsumer};
 use orchard::circuit::{ProvingKey as OrchardProvingKey, VerifyingKey as OrchardVerifyingKey};
 
 /// Cached Sapling proving and verifying parameters.
@@ -76,20 +84,102 @@ pub fn sapling_params() -> &'static SaplingParams {
     CELL.get_or_init(load_sapling_params)
 }
 
+static ORCHARD_PARAMS: OnceCell<OrchardParams> = OnceCell::new();
+static SAPLING_PROVER: OnceCell<LocalTxProver> = OnceCell::new();
+static PREWARM_STARTED: AtomicBool = AtomicBool::new(false);
+/// Milliseconds the first [`prewarm_provers`] took; `u64::MAX` until done.
+static PREWARM_MS: AtomicU64 = AtomicU64::new(u64::MAX);
+
 /// Get shared Orchard parameters (lazy init).
 pub fn orchard_params() -> &'static OrchardParams {
-    static CELL: OnceCell<OrchardParams> = OnceCell::new();
-    CELL.get_or_init(load_orchard_params)
+    ORCHARD_PARAMS.get_or_init(load_orchard_params)
+}
+
+/// Memory one transaction build holds while proving, on top of the shared
+/// parameters: witnesses and multi-exponentiation scratch. A rough figure,
+/// charged against [`crate::memory_budget::MemoryConsumer::Prover`].
+pub const SAPLING_PROVER_WORKING_SET_BYTES: u64 = 100_000_000;
+
+/// Load state of the proving parameters, see [`prover_status`].
+#[derive(Debug, Clone, Copy, PartialEq, Eq, Serialize)]
+#[serde(rename_all = "snake_case")]
+pub enum ProverState {
+    /// Nothing loaded yet; the first build pays for it.
+    Cold,
+    /// A pre-warm or build is loading the parameters.
+    Loading,
+    /// The Sapling prover is loaded; builds start proving at once.
+    Ready,
+}
+
+/// Whether a transaction build would stall on parameter loading.
+#[derive(Debug, Clone, Serialize)]
+pub struct ProverStatus {
+    /// Overall state.
+    pub state: ProverState,
+    /// The Sapling prover is loaded.
+    pub sapling_ready: bool,
+    /// How long the pre-warm took, once it finished.
+    pub prewarm_ms: Option<u64>,
 }
 
-/// Build a `LocalTxProver` using cached Sapling parameters.
+/// Load the Sapling prover so the next transaction build does not wait for
+/// it. Blocking and CPU heavy; run it on a background thread. Later calls
+/// return at once.
+pub fn prewarm_provers() {
+    if PREWARM_STARTED.swap(true, Ordering::AcqRel) {
+        return;
+    }
+    let started = Instant::now();
+    let _ = sapling_prover();
+    let elapsed_ms = u64::try_from(started.elapsed().as_millis()).unwrap_or(u64::MAX - 1);
+    PREWARM_MS.store(elapsed_ms, Ordering::Release);
+    tracing::debug!("proving parameters ready in {}ms", elapsed_ms);
+}
+
+/// Current load state of the proving parameters.
+pub fn prover_status() -> ProverStatus {
+    let sapling_ready = SAPLING_PROVER.get().is_some();
+    let state = if sapling_ready {
+        ProverState::Ready
+    } else if PREWARM_STARTED.load(Ordering::Acquire) {
+        ProverState::Loading
+    } else {
+        ProverState::Cold
+    };
+    let prewarm_ms = match PREWARM_MS.load(Ordering::Acquire) {
+        u64::MAX => None,
+        ms => Some(ms),
+    };
+    ProverStatus {
+        state,
+        sapling_ready,
+        prewarm_ms,
+    }
+}
+
+/// Lengths of the embedded parameter files, recorded the first time they are
+/// checked, so later builds can confirm the files without materialising the
+/// ~50 MB of embedded parameter bytes again.
+static SAPLING_PARAM_LENGTHS: OnceCell<(u64, u64)> = OnceCell::new();
+
+/// Shared `LocalTxProver` over the embedded Sapling parameters, loaded on
+/// first use and kept for the rest of the process.
 ///
-/// Note: The API now requires file paths, so we write parameters to temporary files.
-/// This is less efficient but required by the new API.
-pub fn sapling_prover() -> LocalTxProver {
-    let (spend_path, output_path) = sapling_param_paths();
-    ensure_sapling_param_files(&spend_path, &output_path);
-    LocalTxProver::new(&spend_path, &output_path)
+/// Note: The API requires file paths, so the parameters are written to
+/// temporary files once and read back here. Reading and checking them is the
+/// slow part of a first send, which is why the prover itself is cached. The
+/// loaded parameters stay resident and are charged to the prover's budget.
+pub fn sapling_prover() -> &'static LocalTxProver {
+    SAPLING_PROVER.get_or_init(|| {
+        let (spend_path, output_path) = sapling_param_paths();
+        ensure_sapling_param_files(&spend_path, &output_path);
+        let prover = LocalTxProver::new(&spend_path, &output_path);
+        if let Some(&(spend_len, output_len)) = SAPLING_PARAM_LENGTHS.get() {
+            charge_resident(MemoryConsumer::Prover, spend_len + output_len);
+        }
+        prover
+    })
 }
 
 fn sapling_param_paths() -> (PathBuf, PathBuf) {
@@ -121,18 +211,23 @@ fn sapling_param_paths() -> (PathBuf, PathBuf) {
 }
 
 fn ensure_sapling_param_files(spend_path: &PathBuf, output_path: &PathBuf) {
+    if let Some(&(spend_len, output_len)) = SAPLING_PARAM_LENGTHS.get() {
+        if file_has_len(spend_path, spend_len) && file_has_len(output_path, output_len) {
+            return;
+        }
+    }
     let (spend_bytes, output_bytes) = wagyu_zcash_parameters::load_sapling_parameters();
     ensure_params_file(spend_path, &spend_bytes);
     ensure_params_file(output_path, &output_bytes);
+    let _ = SAPLING_PARAM_LENGTHS.set((spend_bytes.len() as u64, output_bytes.len() as u64));
+}
+
+fn file_has_len(path: &PathBuf, expected_len: u64) -> bool {
+    std::fs::metadata(path).is_ok_and(|meta| meta.len() == expected_len)
 }
 
 fn ensure_params_file(path: &PathBuf, bytes: &[u8]) {
-    let expected_len = bytes.len() as u64;
-    let needs_write = match std::fs::metadata(path) {
-        Ok(meta) => meta.len() != expected_len,
-        Err(_) => true,
-    };
-    if needs_write {
+    if !file_has_len(path, bytes.len() as u64) {
         write_params_file(path, bytes);
     }
 }
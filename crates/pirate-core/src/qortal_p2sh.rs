@@ -3,7 +3,7 @@
 use crate::fees::{apply_dust_policy_add_to_fee, CHANGE_DUST_THRESHOLD};
 use crate::keys::{ExtendedSpendingKey, OrchardExtendedSpendingKey, PaymentAddress};
 use crate::memo::Memo;
-use crate::params::sapling_prover;
+use crate::params::{orchard_params, sapling_prover};
 use crate::selection::{NoteType, SelectableNote};
 use crate::shielded_builder::SelectedSpendNoteRef;
 use crate::transaction::PirateNetwork;
@@ -549,7 +549,7 @@ pub fn build_qortal_p2sh_funding_transaction(
             rng,
         )
         .map_err(|e| Error::TransactionBuild(format!("Failed to build Sapling bundle: {:?}", e)))?
-        .map(|(bundle, _meta)| bundle.create_proofs(&prover, &prover, &mut rng, ()));
+        .map(|(bundle, _meta)| bundle.create_proofs(prover, prover, &mut rng, ()));
 
     let orchard_bundle = if let Some(builder) = orchard_builder {
         builder
@@ -620,11 +620,11 @@ pub fn build_qortal_p2sh_funding_transaction(
         None => None,
     };
 
-    let orchard_proving_key = orchard::circuit::ProvingKey::build();
+    let orchard_proving_key = &orchard_params().proving_key;
     let signed_orchard_bundle = match unauth_tx.orchard_bundle().cloned() {
         Some(bundle) => Some(
             bundle
-                .create_proof(&orchard_proving_key, &mut rng)
+                .create_proof(orchard_proving_key, &mut rng)
                 .map_err(|e| {
                     Error::TransactionBuild(format!("Failed to prove Orchard bundle: {:?}", e))
                 })?
@@ -739,7 +739,7 @@ pub fn build_qortal_p2sh_redeem_transaction(
             &mut rng,
         )
         .map_err(|e| Error::TransactionBuild(format!("Failed to build Sapling bundle: {:?}", e)))?
-        .map(|(bundle, _meta)| bundle.create_proofs(&prover, &prover, &mut rng, ()));
+        .map(|(bundle, _meta)| bundle.create_proofs(prover, prover, &mut rng, ()));
     let orchard_bundle = if let Some(builder) = orchard_builder {
         builder
             .build::<ZatBalance>(&mut rng)
@@ -816,11 +816,11 @@ pub fn build_qortal_p2sh_redeem_transaction(
         None => None,
     };
 
-    let orchard_proving_key = orchard::circuit::ProvingKey::build();
+    let orchard_proving_key = &orchard_params().proving_key;
     let signed_orchard_bundle = match unauth_tx.orchard_bundle().cloned() {
         Some(bundle) => Some(
             bundle
-                .create_proof(&orchard_proving_key, &mut rng)
+                .create_proof(orchard_proving_key, &mut rng)
                 .map_err(|e| {
                     Error::TransactionBuild(format!("Failed to prove Orchard bundle: {:?}", e))
                 })?
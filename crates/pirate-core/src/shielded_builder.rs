@@ -9,7 +9,8 @@
 
 use crate::fees::{apply_dust_policy_add_to_fee, FeeCalculator, CHANGE_DUST_THRESHOLD};
 use crate::keys::{ExtendedSpendingKey, OrchardExtendedSpendingKey, PaymentAddress};
-use crate::params::sapling_prover;
+use crate::memory_budget::{charge_blocking, MemoryConsumer};
+use crate::params::{sapling_prover, SAPLING_PROVER_WORKING_SET_BYTES};
 use crate::selection::{NoteSelector, NoteType, SelectableNote, SelectionStrategy};
 use crate::{Error, Memo, Result};
 use pirate_params::{Network, NetworkType};
@@ -518,8 +519,12 @@ impl ShieldedBuilder {
             None
         };
 
+        // Under a memory budget, wait for other builds to release their proving
+        // scratch before starting ours.
+        let _prover_memory =
+            charge_blocking(MemoryConsumer::Prover, SAPLING_PROVER_WORKING_SET_BYTES);
         // Create prover from cached Sapling parameters
-        let prover: LocalTxProver = sapling_prover();
+        let prover: &LocalTxProver = sapling_prover();
 
         // Create transaction builder with Orchard anchor
         let mut tx_builder = TxBuilder::new(
@@ -793,8 +798,8 @@ impl ShieldedBuilder {
                 &sapling_extsks,
                 &orchard_saks,
                 rng,
-                &prover,
-                &prover,
+                prover,
+                prover,
                 &fee_rule,
             )
             .map_err(|e| {
@@ -4,7 +4,8 @@
 
 use crate::fees::{apply_dust_policy_add_to_fee, FeeCalculator, CHANGE_DUST_THRESHOLD};
 use crate::keys::{ExtendedSpendingKey, PaymentAddress};
-use crate::params::sapling_prover;
+use crate::memory_budget::{charge_blocking, MemoryConsumer};
+use crate::params::{sapling_prover, SAPLING_PROVER_WORKING_SET_BYTES};
 use crate::selection::{NoteSelector, SelectableNote, SelectionStrategy};
 use crate::{Error, Memo, Result};
 use pirate_params::{Network, NetworkType};
@@ -284,8 +285,12 @@ impl TransactionBuilder {
 
         let pending_outputs = self.outputs.clone();
 
+        // Under a memory budget, wait for other builds to release their proving
+        // scratch before starting ours.
+        let _prover_memory =
+            charge_blocking(MemoryConsumer::Prover, SAPLING_PROVER_WORKING_SET_BYTES);
         // Create prover from cached Sapling parameters (loaded once per process)
-        let prover: LocalTxProver = sapling_prover();
+        let prover: &LocalTxProver = sapling_prover();
 
         let sapling_anchor = selection
             .notes
@@ -406,8 +411,8 @@ impl TransactionBuilder {
                 &sapling_extsks,
                 &orchard_saks,
                 rng,
-                &prover,
-                &prover,
+                prover,
+                prover,
                 &fee_rule,
             )
             .map_err(|e| {
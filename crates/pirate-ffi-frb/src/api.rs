@@ -558,11 +558,13 @@ pub fn create_wallet(
     birthday_opt: Option<u32>,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<WalletId> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    service::create_wallet(name, _entropy_len, birthday_opt, mnemonic_language)
+    service::timed("create_wallet", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        service::create_wallet(name, _entropy_len, birthday_opt, mnemonic_language)
+    })
 }
 
 /// Restore wallet from mnemonic
@@ -576,18 +578,22 @@ pub fn restore_wallet(
     birthday_opt: Option<u32>,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<WalletId> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    service::restore_wallet(name, mnemonic, birthday_opt, mnemonic_language)
+    service::timed("restore_wallet", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        service::restore_wallet(name, mnemonic, birthday_opt, mnemonic_language)
+    })
 }
 
 /// Check if wallet registry database file exists (without opening it)
 ///
 /// This allows checking if wallets exist before the database is created or opened.
 pub fn wallet_registry_exists() -> Result<bool> {
-    service::wallet_registry_exists()
+    service::timed("wallet_registry_exists", || {
+        service::wallet_registry_exists()
+    })
 }
 
 /// List all wallets
@@ -595,12 +601,27 @@ pub fn wallet_registry_exists() -> Result<bool> {
 /// Returns empty list if database can't be opened (e.g., passphrase not set)
 /// NOTE: This will CREATE the database file if it doesn't exist (via open_wallet_registry)
 pub fn list_wallets() -> Result<Vec<WalletMeta>> {
-    convert_from_service(service::list_wallets()?)
+    service::timed("list_wallets", || {
+        convert_from_service(service::list_wallets()?)
+    })
 }
 
 /// Switch active wallet
 pub fn switch_wallet(wallet_id: WalletId) -> Result<()> {
-    service::switch_wallet(wallet_id)
+    service::timed("switch_wallet", || service::switch_wallet(wallet_id))
+}
+
+/// Runtime for FRB work that does not run on one of its own: the shared
+/// service runtime, so the worker count and blocking pool the host set with
+/// `pirate_configure_runtime` apply to the Flutter app too.
+fn service_runtime() -> &'static tokio::runtime::Runtime {
+    service::WalletService::runtime()
+}
+
+/// Handle to spawn background work on: the caller's runtime when there is
+/// one, otherwise the service runtime.
+fn background_handle() -> tokio::runtime::Handle {
+    tokio::runtime::Handle::try_current().unwrap_or_else(|_| service_runtime().handle().clone())
 }
 
 async fn run_sync_engine_task<F, T>(sync: Arc<tokio::sync::Mutex<SyncEngine>>, task: F) -> Result<T>
@@ -610,29 +631,19 @@ where
         + 'static,
     T: Send + 'static,
 {
+    // The engine future is not `Send`, so it is driven on a blocking-pool
+    // thread; timers, I/O and anything it spawns use the service runtime.
     let run_task = move || -> Result<T> {
-        let runtime = tokio::runtime::Builder::new_current_thread()
-            .enable_all()
-            .build()
-            .map_err(|e| anyhow!("Failed to build sync runtime: {}", e))?;
-        runtime.block_on(async move {
+        tokio::runtime::Handle::current().block_on(async move {
             let mut engine = sync.lock().await;
             task(&mut engine).await
         })
     };
 
-    if let Ok(handle) = tokio::runtime::Handle::try_current() {
-        let join = handle.spawn_blocking(run_task);
-        join.await
-            .map_err(|e| anyhow!("Sync task join error: {}", e))?
-    } else {
-        let (tx, rx) = tokio::sync::oneshot::channel();
-        std::thread::spawn(move || {
-            let _ = tx.send(run_task());
-        });
-        rx.await
-            .map_err(|e| anyhow!("Sync task thread join error: {}", e))?
-    }
+    service_runtime()
+        .spawn_blocking(run_task)
+        .await
+        .map_err(|e| anyhow!("Sync task join error: {}", e))?
 }
 
 async fn run_on_runtime<F, Fut, T>(task: F) -> Result<T>
@@ -641,19 +652,9 @@ where
     Fut: Future<Output = Result<T>> + 'static,
     T: Send + 'static,
 {
-    let (tx, rx) = tokio::sync::oneshot::channel();
-    std::thread::spawn(move || {
-        let result = (|| -> Result<T> {
-            let runtime = tokio::runtime::Builder::new_current_thread()
-                .enable_all()
-                .build()
-                .map_err(|e| anyhow!("Failed to build runtime: {}", e))?;
-            runtime.block_on(task())
-        })();
-        let _ = tx.send(result);
-    });
-
-    rx.await
+    service_runtime()
+        .spawn_blocking(move || tokio::runtime::Handle::current().block_on(task()))
+        .await
         .map_err(|e| anyhow!("Runtime task join error: {}", e))?
 }
 
@@ -686,33 +687,41 @@ fn escape_json(value: &str) -> String {
 /// IMPORTANT: This function opens/creates the database with the passphrase,
 /// then stores the hash and caches the passphrase in memory for this session.
 pub fn set_app_passphrase(passphrase: String) -> Result<()> {
-    service::set_app_passphrase(passphrase)
+    service::timed("set_app_passphrase", || {
+        service::set_app_passphrase(passphrase)
+    })
 }
 
 /// Check if app passphrase is configured
 pub fn has_app_passphrase() -> Result<bool> {
-    service::has_app_passphrase()
+    service::timed("has_app_passphrase", service::has_app_passphrase)
 }
 
 /// Verify app passphrase by attempting to open the database with it
 pub fn verify_app_passphrase(passphrase: String) -> Result<bool> {
-    service::verify_app_passphrase(passphrase)
+    service::timed("verify_app_passphrase", || {
+        service::verify_app_passphrase(passphrase)
+    })
 }
 
 /// Unlock app with passphrase (caches passphrase in memory for wallet access)
 /// This allows wallets to be decrypted using the passphrase
 pub fn unlock_app(passphrase: String) -> Result<()> {
-    service::unlock_app(passphrase)
+    service::timed("unlock_app", || service::unlock_app(passphrase))
 }
 
 /// Change app passphrase and re-encrypt all wallet data with the new keys.
 pub fn change_app_passphrase(current_passphrase: String, new_passphrase: String) -> Result<()> {
-    service::change_app_passphrase(current_passphrase, new_passphrase)
+    service::timed("change_app_passphrase", || {
+        service::change_app_passphrase(current_passphrase, new_passphrase)
+    })
 }
 
 /// Change passphrase using the cached passphrase from the current session.
 pub fn change_app_passphrase_with_cached(new_passphrase: String) -> Result<()> {
-    service::change_app_passphrase_with_cached(new_passphrase)
+    service::timed("change_app_passphrase_with_cached", || {
+        service::change_app_passphrase_with_cached(new_passphrase)
+    })
 }
 
 /// Reseal registry + wallet DB keys using current platform keystore mode.
@@ -720,32 +729,44 @@ pub fn change_app_passphrase_with_cached(new_passphrase: String) -> Result<()> {
 /// This is used when biometrics are enabled/disabled to rewrap the DB keys
 /// under the appropriate keystore policy without changing the passphrase.
 pub fn reseal_db_keys_for_biometrics() -> Result<()> {
-    service::reseal_db_keys_for_biometrics()
+    service::timed("reseal_db_keys_for_biometrics", || {
+        service::reseal_db_keys_for_biometrics()
+    })
 }
 
 /// Get auto-consolidation setting for a wallet.
 pub fn get_auto_consolidation_enabled(wallet_id: WalletId) -> Result<bool> {
-    service::get_auto_consolidation_enabled(wallet_id)
+    service::timed("get_auto_consolidation_enabled", || {
+        service::get_auto_consolidation_enabled(wallet_id)
+    })
 }
 
 /// Enable or disable auto-consolidation for a wallet.
 pub fn set_auto_consolidation_enabled(wallet_id: WalletId, enabled: bool) -> Result<()> {
-    service::set_auto_consolidation_enabled(wallet_id, enabled)
+    service::timed("set_auto_consolidation_enabled", || {
+        service::set_auto_consolidation_enabled(wallet_id, enabled)
+    })
 }
 
 /// Get the note count threshold that triggers auto-consolidation prompts.
 pub fn get_auto_consolidation_threshold() -> Result<u32> {
-    service::get_auto_consolidation_threshold()
+    service::timed("get_auto_consolidation_threshold", || {
+        service::get_auto_consolidation_threshold()
+    })
 }
 
 /// Count selectable notes eligible for auto-consolidation.
 pub fn get_auto_consolidation_candidate_count(wallet_id: WalletId) -> Result<u32> {
-    service::get_auto_consolidation_candidate_count(wallet_id)
+    service::timed("get_auto_consolidation_candidate_count", || {
+        service::get_auto_consolidation_candidate_count(wallet_id)
+    })
 }
 
 /// Return deterministic spendability status for the wallet.
 pub fn get_spendability_status(wallet_id: WalletId) -> Result<SpendabilityStatus> {
-    convert_from_service(service::get_spendability_status(wallet_id)?)
+    service::timed("get_spendability_status", || {
+        convert_from_service(service::get_spendability_status(wallet_id)?)
+    })
 }
 
 fn ensure_primary_account_key(
@@ -814,22 +835,26 @@ fn ensure_primary_account_key(
 
 /// Get active wallet ID
 pub fn get_active_wallet() -> Result<Option<WalletId>> {
-    service::get_active_wallet()
+    service::timed("get_active_wallet", service::get_active_wallet)
 }
 
 /// Rename wallet
 pub fn rename_wallet(wallet_id: WalletId, new_name: String) -> Result<()> {
-    service::rename_wallet(wallet_id, new_name)
+    service::timed("rename_wallet", || {
+        service::rename_wallet(wallet_id, new_name)
+    })
 }
 
 /// Update wallet birthday height
 pub fn set_wallet_birthday_height(wallet_id: WalletId, birthday_height: u32) -> Result<()> {
-    service::set_wallet_birthday_height(wallet_id, birthday_height)
+    service::timed("set_wallet_birthday_height", || {
+        service::set_wallet_birthday_height(wallet_id, birthday_height)
+    })
 }
 
 /// Delete wallet and its local database
 pub fn delete_wallet(wallet_id: WalletId) -> Result<()> {
-    service::delete_wallet(wallet_id)
+    service::timed("delete_wallet", || service::delete_wallet(wallet_id))
 }
 
 // ============================================================================
@@ -890,7 +915,9 @@ fn should_generate_orchard(wallet_id: &WalletId) -> Result<bool> {
 /// If no address exists, generates and stores the first address (index 0).
 /// Call `next_receive_address` to rotate to a new unlinkable address.
 pub fn current_receive_address(wallet_id: WalletId) -> Result<String> {
-    service::current_receive_address(wallet_id)
+    service::timed("current_receive_address", || {
+        service::current_receive_address(wallet_id)
+    })
 }
 
 /// Generate next receive address (diversifier rotation)
@@ -899,12 +926,16 @@ pub fn current_receive_address(wallet_id: WalletId) -> Result<String> {
 /// Address type (Sapling or Orchard) is determined by network and current block height.
 /// Previous addresses remain valid for receiving funds.
 pub fn next_receive_address(wallet_id: WalletId) -> Result<String> {
-    service::next_receive_address(wallet_id)
+    service::timed("next_receive_address", || {
+        service::next_receive_address(wallet_id)
+    })
 }
 
 /// Label an address for address book
 pub fn label_address(wallet_id: WalletId, addr: String, label: String) -> Result<()> {
-    service::label_address(wallet_id, addr, label)
+    service::timed("label_address", || {
+        service::label_address(wallet_id, addr, label)
+    })
 }
 
 /// Set color tag for a wallet address
@@ -913,16 +944,20 @@ pub fn set_address_color_tag(
     addr: String,
     color_tag: AddressBookColorTag,
 ) -> Result<()> {
-    service::set_address_color_tag(
-        convert_into_service(wallet_id)?,
-        addr,
-        convert_into_service(color_tag)?,
-    )
+    service::timed("set_address_color_tag", || {
+        service::set_address_color_tag(
+            convert_into_service(wallet_id)?,
+            addr,
+            convert_into_service(color_tag)?,
+        )
+    })
 }
 
 /// Get all addresses for wallet with labels
 pub fn list_addresses(wallet_id: WalletId) -> Result<Vec<AddressInfo>> {
-    convert_from_service(service::list_addresses(wallet_id)?)
+    service::timed("list_addresses", || {
+        convert_from_service(service::list_addresses(wallet_id)?)
+    })
 }
 
 /// Get per-address balances for a wallet (optionally filtered by key group).
@@ -930,7 +965,9 @@ pub fn list_address_balances(
     wallet_id: WalletId,
     key_id: Option<i64>,
 ) -> Result<Vec<AddressBalanceInfo>> {
-    convert_from_service(service::list_address_balances(wallet_id, key_id)?)
+    service::timed("list_address_balances", || {
+        convert_from_service(service::list_address_balances(wallet_id, key_id)?)
+    })
 }
 
 fn address_matches_expected_network_prefix(
@@ -982,7 +1019,9 @@ pub(super) fn address_book_color_to_ffi(tag: DbColorTag) -> AddressBookColorTag
 
 /// List address book entries for a wallet
 pub fn list_address_book(wallet_id: WalletId) -> Result<Vec<AddressBookEntryFfi>> {
-    convert_from_service(service::list_address_book(wallet_id)?)
+    service::timed("list_address_book", || {
+        convert_from_service(service::list_address_book(wallet_id)?)
+    })
 }
 
 /// Add an address book entry
@@ -993,13 +1032,15 @@ pub fn add_address_book_entry(
     notes: Option<String>,
     color_tag: AddressBookColorTag,
 ) -> Result<AddressBookEntryFfi> {
-    convert_from_service(service::add_address_book_entry(
-        wallet_id,
-        address,
-        label,
-        notes,
-        convert_into_service(color_tag)?,
-    )?)
+    service::timed("add_address_book_entry", || {
+        convert_from_service(service::add_address_book_entry(
+            wallet_id,
+            address,
+            label,
+            notes,
+            convert_into_service(color_tag)?,
+        )?)
+    })
 }
 
 /// Update an address book entry
@@ -1011,52 +1052,68 @@ pub fn update_address_book_entry(
     color_tag: Option<AddressBookColorTag>,
     is_favorite: Option<bool>,
 ) -> Result<AddressBookEntryFfi> {
-    convert_from_service(service::update_address_book_entry(
-        wallet_id,
-        id,
-        label,
-        notes,
-        match color_tag {
-            Some(value) => Some(convert_into_service(value)?),
-            None => None,
-        },
-        is_favorite,
-    )?)
+    service::timed("update_address_book_entry", || {
+        convert_from_service(service::update_address_book_entry(
+            wallet_id,
+            id,
+            label,
+            notes,
+            match color_tag {
+                Some(value) => Some(convert_into_service(value)?),
+                None => None,
+            },
+            is_favorite,
+        )?)
+    })
 }
 
 /// Delete an address book entry
 pub fn delete_address_book_entry(wallet_id: WalletId, id: i64) -> Result<()> {
-    service::delete_address_book_entry(wallet_id, id)
+    service::timed("delete_address_book_entry", || {
+        service::delete_address_book_entry(wallet_id, id)
+    })
 }
 
 /// Toggle favorite status for an entry
 pub fn toggle_address_book_favorite(wallet_id: WalletId, id: i64) -> Result<bool> {
-    service::toggle_address_book_favorite(wallet_id, id)
+    service::timed("toggle_address_book_favorite", || {
+        service::toggle_address_book_favorite(wallet_id, id)
+    })
 }
 
 /// Mark an address as used
 pub fn mark_address_used(wallet_id: WalletId, address: String) -> Result<()> {
-    service::mark_address_used(wallet_id, address)
+    service::timed("mark_address_used", || {
+        service::mark_address_used(wallet_id, address)
+    })
 }
 
 /// Get label for an address
 pub fn get_label_for_address(wallet_id: WalletId, address: String) -> Result<Option<String>> {
-    service::get_label_for_address(wallet_id, address)
+    service::timed("get_label_for_address", || {
+        service::get_label_for_address(wallet_id, address)
+    })
 }
 
 /// Check if an address exists in the book
 pub fn address_exists_in_book(wallet_id: WalletId, address: String) -> Result<bool> {
-    service::address_exists_in_book(wallet_id, address)
+    service::timed("address_exists_in_book", || {
+        service::address_exists_in_book(wallet_id, address)
+    })
 }
 
 /// Count address book entries
 pub fn get_address_book_count(wallet_id: WalletId) -> Result<u32> {
-    service::get_address_book_count(wallet_id)
+    service::timed("get_address_book_count", || {
+        service::get_address_book_count(wallet_id)
+    })
 }
 
 /// Get entry by ID
 pub fn get_address_book_entry(wallet_id: WalletId, id: i64) -> Result<Option<AddressBookEntryFfi>> {
-    convert_from_service(service::get_address_book_entry(wallet_id, id)?)
+    service::timed("get_address_book_entry", || {
+        convert_from_service(service::get_address_book_entry(wallet_id, id)?)
+    })
 }
 
 /// Get entry by address
@@ -1064,19 +1121,25 @@ pub fn get_address_book_entry_by_address(
     wallet_id: WalletId,
     address: String,
 ) -> Result<Option<AddressBookEntryFfi>> {
-    convert_from_service(service::get_address_book_entry_by_address(
-        wallet_id, address,
-    )?)
+    service::timed("get_address_book_entry_by_address", || {
+        convert_from_service(service::get_address_book_entry_by_address(
+            wallet_id, address,
+        )?)
+    })
 }
 
 /// Search entries by query
 pub fn search_address_book(wallet_id: WalletId, query: String) -> Result<Vec<AddressBookEntryFfi>> {
-    convert_from_service(service::search_address_book(wallet_id, query)?)
+    service::timed("search_address_book", || {
+        convert_from_service(service::search_address_book(wallet_id, query)?)
+    })
 }
 
 /// List favorites
 pub fn get_address_book_favorites(wallet_id: WalletId) -> Result<Vec<AddressBookEntryFfi>> {
-    convert_from_service(service::get_address_book_favorites(wallet_id)?)
+    service::timed("get_address_book_favorites", || {
+        convert_from_service(service::get_address_book_favorites(wallet_id)?)
+    })
 }
 
 /// List recently used addresses
@@ -1084,7 +1147,9 @@ pub fn get_recently_used_addresses(
     wallet_id: WalletId,
     limit: u32,
 ) -> Result<Vec<AddressBookEntryFfi>> {
-    convert_from_service(service::get_recently_used_addresses(wallet_id, limit)?)
+    service::timed("get_recently_used_addresses", || {
+        convert_from_service(service::get_recently_used_addresses(wallet_id, limit)?)
+    })
 }
 
 // ============================================================================
@@ -1095,7 +1160,9 @@ pub fn get_recently_used_addresses(
 ///
 /// Uses the zxviews... Bech32 format for watch-only wallets.
 pub fn export_sapling_viewing_key(wallet_id: WalletId) -> Result<String> {
-    service::export_sapling_viewing_key(wallet_id)
+    service::timed("export_sapling_viewing_key", || {
+        service::export_sapling_viewing_key(wallet_id)
+    })
 }
 
 /// Export Orchard Extended Full Viewing Key as Bech32 (for watch-only wallets)
@@ -1104,7 +1171,9 @@ pub fn export_sapling_viewing_key(wallet_id: WalletId) -> Result<String> {
 /// Uses the standard Orchard viewing key export format.
 /// Use export_sapling_viewing_key() for Sapling viewing keys (zxviews... format).
 pub fn export_orchard_viewing_key(wallet_id: WalletId) -> Result<String> {
-    service::export_orchard_viewing_key(wallet_id)
+    service::timed("export_orchard_viewing_key", || {
+        service::export_orchard_viewing_key(wallet_id)
+    })
 }
 
 /// Import viewing keys (watch-only wallet).
@@ -1117,7 +1186,9 @@ pub fn import_viewing_wallet(
     orchard_viewing_key: Option<String>,
     birthday: u32,
 ) -> Result<WalletId> {
-    service::import_viewing_wallet(name, sapling_viewing_key, orchard_viewing_key, birthday)
+    service::timed("import_viewing_wallet", || {
+        service::import_viewing_wallet(name, sapling_viewing_key, orchard_viewing_key, birthday)
+    })
 }
 
 // ============================================================================
@@ -1126,17 +1197,23 @@ pub fn import_viewing_wallet(
 
 /// List key groups for the active wallet account.
 pub fn list_key_groups(wallet_id: WalletId) -> Result<Vec<KeyGroupInfo>> {
-    convert_from_service(service::list_key_groups(wallet_id)?)
+    service::timed("list_key_groups", || {
+        convert_from_service(service::list_key_groups(wallet_id)?)
+    })
 }
 
 /// Export viewing/spending keys for a specific key group.
 pub fn export_key_group_keys(wallet_id: WalletId, key_id: i64) -> Result<KeyExportInfo> {
-    convert_from_service(service::export_key_group_keys(wallet_id, key_id)?)
+    service::timed("export_key_group_keys", || {
+        convert_from_service(service::export_key_group_keys(wallet_id, key_id)?)
+    })
 }
 
 /// List addresses for a specific key group.
 pub fn list_addresses_for_key(wallet_id: WalletId, key_id: i64) -> Result<Vec<KeyAddressInfo>> {
-    convert_from_service(service::list_addresses_for_key(wallet_id, key_id)?)
+    service::timed("list_addresses_for_key", || {
+        convert_from_service(service::list_addresses_for_key(wallet_id, key_id)?)
+    })
 }
 
 /// Generate a new address for a specific key group.
@@ -1145,7 +1222,9 @@ pub fn generate_address_for_key(
     key_id: i64,
     use_orchard: bool,
 ) -> Result<String> {
-    service::generate_address_for_key(wallet_id, key_id, use_orchard)
+    service::timed("generate_address_for_key", || {
+        service::generate_address_for_key(wallet_id, key_id, use_orchard)
+    })
 }
 
 /// Import a spending key into an existing wallet.
@@ -1156,7 +1235,9 @@ pub fn import_spending_key(
     label: Option<String>,
     birthday_height: u32,
 ) -> Result<i64> {
-    service::import_spending_key(wallet_id, sapling_key, orchard_key, label, birthday_height)
+    service::timed("import_spending_key", || {
+        service::import_spending_key(wallet_id, sapling_key, orchard_key, label, birthday_height)
+    })
 }
 
 /// Export mnemonic seed through the raw advanced path.
@@ -1170,11 +1251,13 @@ pub fn export_seed_raw(
     wallet_id: WalletId,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<String> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    service::export_seed_raw(wallet_id, mnemonic_language)
+    service::timed("export_seed_raw", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        service::export_seed_raw(wallet_id, mnemonic_language)
+    })
 }
 
 /// Export the active wallet seed for immediate KDF swap-engine startup.
@@ -1183,7 +1266,9 @@ pub fn export_seed_raw(
 /// locked, watch-only, and seedless/private-key-import wallet states. The
 /// mnemonic is always rendered as English BIP39 for KDF/Komodo compatibility.
 pub fn export_seed_for_kdf(wallet_id: WalletId) -> Result<String> {
-    service::export_seed_for_kdf(wallet_id)
+    service::timed("export_seed_for_kdf", || {
+        service::export_seed_for_kdf(wallet_id)
+    })
 }
 
 // ============================================================================
@@ -1207,8 +1292,10 @@ pub fn build_tx(
     outputs: Vec<Output>,
     fee_opt: Option<u64>,
 ) -> Result<PendingTx> {
-    let outputs = convert_into_service(outputs)?;
-    convert_from_service(service::build_tx(wallet_id, outputs, fee_opt)?)
+    service::timed("build_tx", || {
+        let outputs = convert_into_service(outputs)?;
+        convert_from_service(service::build_tx(wallet_id, outputs, fee_opt)?)
+    })
 }
 
 /// Build transaction using notes from a specific key group.
@@ -1218,10 +1305,12 @@ pub fn build_tx_for_key(
     outputs: Vec<Output>,
     fee_opt: Option<u64>,
 ) -> Result<PendingTx> {
-    let outputs = convert_into_service(outputs)?;
-    convert_from_service(service::build_tx_for_key(
-        wallet_id, key_id, outputs, fee_opt,
-    )?)
+    service::timed("build_tx_for_key", || {
+        let outputs = convert_into_service(outputs)?;
+        convert_from_service(service::build_tx_for_key(
+            wallet_id, key_id, outputs, fee_opt,
+        )?)
+    })
 }
 
 /// Build transaction using selected key groups or addresses.
@@ -1232,14 +1321,16 @@ pub fn build_tx_filtered(
     key_ids_filter: Option<Vec<i64>>,
     address_ids_filter: Option<Vec<i64>>,
 ) -> Result<PendingTx> {
-    let outputs = convert_into_service(outputs)?;
-    convert_from_service(service::build_tx_filtered(
-        wallet_id,
-        outputs,
-        fee_opt,
-        key_ids_filter,
-        address_ids_filter,
-    )?)
+    service::timed("build_tx_filtered", || {
+        let outputs = convert_into_service(outputs)?;
+        convert_from_service(service::build_tx_filtered(
+            wallet_id,
+            outputs,
+            fee_opt,
+            key_ids_filter,
+            address_ids_filter,
+        )?)
+    })
 }
 
 /// Build a consolidation transaction for a key group.
@@ -1249,12 +1340,14 @@ pub fn build_consolidation_tx(
     target_address: String,
     fee_opt: Option<u64>,
 ) -> Result<PendingTx> {
-    convert_from_service(service::build_consolidation_tx(
-        wallet_id,
-        key_id,
-        target_address,
-        fee_opt,
-    )?)
+    service::timed("build_consolidation_tx", || {
+        convert_from_service(service::build_consolidation_tx(
+            wallet_id,
+            key_id,
+            target_address,
+            fee_opt,
+        )?)
+    })
 }
 
 /// Build a sweep transaction from selected key groups or addresses.
@@ -1266,25 +1359,31 @@ pub fn build_sweep_tx(
     key_ids_filter: Option<Vec<i64>>,
     address_ids_filter: Option<Vec<i64>>,
 ) -> Result<PendingTx> {
-    convert_from_service(service::build_sweep_tx(
-        wallet_id,
-        target_address,
-        fee_opt,
-        key_ids_filter,
-        address_ids_filter,
-    )?)
+    service::timed("build_sweep_tx", || {
+        convert_from_service(service::build_sweep_tx(
+            wallet_id,
+            target_address,
+            fee_opt,
+            key_ids_filter,
+            address_ids_filter,
+        )?)
+    })
 }
 
 /// Sign pending transaction (all spendable notes in the wallet)
 pub fn sign_tx(wallet_id: WalletId, pending: PendingTx) -> Result<SignedTx> {
-    let pending = convert_into_service(pending)?;
-    convert_from_service(service::sign_tx(wallet_id, pending)?)
+    service::timed("sign_tx", || {
+        let pending = convert_into_service(pending)?;
+        convert_from_service(service::sign_tx(wallet_id, pending)?)
+    })
 }
 
 /// Sign pending transaction using notes from a specific key group
 pub fn sign_tx_for_key(wallet_id: WalletId, pending: PendingTx, key_id: i64) -> Result<SignedTx> {
-    let pending = convert_into_service(pending)?;
-    convert_from_service(service::sign_tx_for_key(wallet_id, pending, key_id)?)
+    service::timed("sign_tx_for_key", || {
+        let pending = convert_into_service(pending)?;
+        convert_from_service(service::sign_tx_for_key(wallet_id, pending, key_id)?)
+    })
 }
 
 /// Sign pending transaction using selected key groups or addresses.
@@ -1294,13 +1393,15 @@ pub fn sign_tx_filtered(
     key_ids_filter: Option<Vec<i64>>,
     address_ids_filter: Option<Vec<i64>>,
 ) -> Result<SignedTx> {
-    let pending = convert_into_service(pending)?;
-    convert_from_service(service::sign_tx_filtered(
-        wallet_id,
-        pending,
-        key_ids_filter,
-        address_ids_filter,
-    )?)
+    service::timed("sign_tx_filtered", || {
+        let pending = convert_into_service(pending)?;
+        convert_from_service(service::sign_tx_filtered(
+            wallet_id,
+            pending,
+            key_ids_filter,
+            address_ids_filter,
+        )?)
+    })
 }
 
 /// Broadcast signed transaction to the network
@@ -1308,18 +1409,25 @@ pub fn sign_tx_filtered(
 /// Sends transaction via lightwalletd gRPC SendTransaction.
 /// Returns TxId on success, or error with details.
 pub async fn broadcast_tx(signed: SignedTx) -> Result<TxId> {
-    let signed = convert_into_service(signed)?;
-    service::broadcast_tx(signed).await
+    service::timed_async("broadcast_tx", async move {
+        let signed = convert_into_service(signed)?;
+        service::broadcast_tx(signed).await
+    })
+    .await
 }
 
 /// Estimate fee for transaction without building it
 pub fn estimate_fee(num_outputs: usize, has_memo: bool, fee_policy: Option<String>) -> Result<u64> {
-    service::estimate_fee(num_outputs, has_memo, fee_policy)
+    service::timed("estimate_fee", || {
+        service::estimate_fee(num_outputs, has_memo, fee_policy)
+    })
 }
 
 /// Get fee information
 pub fn get_fee_info() -> Result<FeeInfo> {
-    convert_from_service(service::get_fee_info()?)
+    service::timed("get_fee_info", || {
+        convert_from_service(service::get_fee_info()?)
+    })
 }
 
 /// Fee information for UI
@@ -1341,32 +1449,39 @@ pub struct FeeInfo {
 // Sync
 // ============================================================================
 pub async fn start_sync(wallet_id: WalletId, mode: SyncMode) -> Result<()> {
-    service::start_sync(wallet_id, convert_into_service(mode)?).await
+    service::timed_async("start_sync", async move {
+        service::start_sync(wallet_id, convert_into_service(mode)?).await
+    })
+    .await
 }
 
 /// Get sync status for a wallet with full performance metrics
 pub fn sync_status(wallet_id: WalletId) -> Result<SyncStatus> {
-    convert_from_service(service::sync_status(wallet_id)?)
+    service::timed("sync_status", || {
+        convert_from_service(service::sync_status(wallet_id)?)
+    })
 }
 
 /// Get last checkpoint info for diagnostics
 pub fn get_last_checkpoint(wallet_id: WalletId) -> Result<Option<CheckpointInfo>> {
-    convert_from_service(service::get_last_checkpoint(wallet_id)?)
+    service::timed("get_last_checkpoint", || {
+        convert_from_service(service::get_last_checkpoint(wallet_id)?)
+    })
 }
 
 /// Rescan wallet from specific height
 pub async fn rescan(wallet_id: WalletId, from_height: u32) -> Result<()> {
-    service::rescan(wallet_id, from_height).await
+    service::timed_async("rescan", service::rescan(wallet_id, from_height)).await
 }
 
 /// Cancel ongoing sync for a wallet.
 pub async fn cancel_sync(wallet_id: WalletId) -> Result<()> {
-    service::cancel_sync(wallet_id).await
+    service::timed_async("cancel_sync", service::cancel_sync(wallet_id)).await
 }
 
 /// Check if sync is running for a wallet
 pub fn is_sync_running(wallet_id: WalletId) -> Result<bool> {
-    service::is_sync_running(wallet_id)
+    service::timed("is_sync_running", || service::is_sync_running(wallet_id))
 }
 
 // ============================================================================
@@ -1387,7 +1502,11 @@ pub async fn start_background_sync(
     max_duration_secs: Option<u64>,
     max_blocks: Option<u64>,
 ) -> Result<crate::models::BackgroundSyncResult> {
-    background_sync::start_background_sync(wallet_id, mode, max_duration_secs, max_blocks).await
+    service::timed_async(
+        "start_background_sync",
+        background_sync::start_background_sync(wallet_id, mode, max_duration_secs, max_blocks),
+    )
+    .await
 }
 
 /// Start background sync using round-robin scheduling with warm-wallet priority.
@@ -1399,12 +1518,20 @@ pub async fn start_background_sync_round_robin(
     max_duration_secs: Option<u64>,
     max_blocks: Option<u64>,
 ) -> Result<crate::models::WalletBackgroundSyncResult> {
-    background_sync::start_background_sync_round_robin(mode, max_duration_secs, max_blocks).await
+    service::timed_async("start_background_sync_round_robin", async move {
+        background_sync::start_background_sync_round_robin(mode, max_duration_secs, max_blocks)
+            .await
+    })
+    .await
 }
 
 /// Check if background sync is needed for a wallet
 pub async fn is_background_sync_needed(wallet_id: WalletId) -> Result<bool> {
-    background_sync::is_background_sync_needed(wallet_id).await
+    service::timed_async(
+        "is_background_sync_needed",
+        background_sync::is_background_sync_needed(wallet_id),
+    )
+    .await
 }
 
 /// Get recommended background sync mode based on time since last sync
@@ -1412,7 +1539,9 @@ pub fn get_recommended_background_sync_mode(
     wallet_id: WalletId,
     minutes_since_last: u32,
 ) -> Result<String> {
-    background_sync::get_recommended_background_sync_mode(wallet_id, minutes_since_last)
+    service::timed("get_recommended_background_sync_mode", || {
+        background_sync::get_recommended_background_sync_mode(wallet_id, minutes_since_last)
+    })
 }
 
 // ============================================================================
@@ -1438,17 +1567,37 @@ pub fn set_lightd_endpoint(
     url: String,
     tls_pin_opt: Option<String>,
 ) -> Result<()> {
-    service::set_lightd_endpoint(wallet_id, url, tls_pin_opt)
+    service::timed("set_lightd_endpoint", || {
+        service::set_lightd_endpoint(wallet_id, url, tls_pin_opt)
+    })
 }
 
 /// Get lightwalletd endpoint
 pub fn get_lightd_endpoint(wallet_id: WalletId) -> Result<String> {
-    service::get_lightd_endpoint(wallet_id)
+    service::timed("get_lightd_endpoint", || {
+        service::get_lightd_endpoint(wallet_id)
+    })
 }
 
 /// Get full endpoint configuration
 pub fn get_lightd_endpoint_config(wallet_id: WalletId) -> Result<LightdEndpoint> {
-    convert_from_service(service::get_lightd_endpoint_config(wallet_id)?)
+    service::timed("get_lightd_endpoint_config", || {
+        convert_from_service(service::get_lightd_endpoint_config(wallet_id)?)
+    })
+}
+
+/// Set the mirror lightwalletd URLs sync spreads block fetches across
+pub fn set_lightd_mirrors(wallet_id: WalletId, urls: Vec<String>) -> Result<()> {
+    service::timed("set_lightd_mirrors", || {
+        service::set_lightd_mirrors(wallet_id, urls)
+    })
+}
+
+/// Get the configured mirror lightwalletd URLs
+pub fn get_lightd_mirrors(wallet_id: WalletId) -> Result<Vec<String>> {
+    service::timed("get_lightd_mirrors", || {
+        service::get_lightd_mirrors(wallet_id)
+    })
 }
 
 fn infer_key_network_type_from_addresses(
@@ -1711,22 +1860,22 @@ fn rederive_wallet_keys_for_network(
 
 /// Set network tunnel mode
 pub fn set_tunnel(mode: TunnelMode) -> Result<()> {
-    tunnel::set_tunnel(mode)
+    service::timed("set_tunnel", || tunnel::set_tunnel(mode))
 }
 
 /// Get current tunnel mode
 pub fn get_tunnel() -> Result<TunnelMode> {
-    tunnel::get_tunnel()
+    service::timed("get_tunnel", || tunnel::get_tunnel())
 }
 
 /// Bootstrap tunnel transport early (Tor/I2P/SOCKS5) without unlocking wallets.
 pub async fn bootstrap_tunnel(mode: TunnelMode) -> Result<()> {
-    tunnel::bootstrap_tunnel(mode).await
+    service::timed_async("bootstrap_tunnel", tunnel::bootstrap_tunnel(mode)).await
 }
 
 /// Shutdown any active transport manager (Tor/I2P/SOCKS5).
 pub async fn shutdown_transport() -> Result<()> {
-    tunnel::shutdown_transport().await
+    service::timed_async("shutdown_transport", tunnel::shutdown_transport()).await
 }
 
 /// Configure Tor bridge settings (Snowflake/obfs4/custom) for censorship circumvention.
@@ -1737,24 +1886,35 @@ pub async fn set_tor_bridge_settings(
     bridge_lines: Vec<String>,
     transport_path: Option<String>,
 ) -> Result<()> {
-    tunnel::set_tor_bridge_settings(
-        use_bridges,
-        fallback_to_bridges,
-        transport,
-        bridge_lines,
-        transport_path,
-    )
+    service::timed_async("set_tor_bridge_settings", async move {
+        tunnel::set_tor_bridge_settings(
+            use_bridges,
+            fallback_to_bridges,
+            transport,
+            bridge_lines,
+            transport_path,
+        )
+        .await
+    })
     .await
 }
 
 /// Get current Tor bootstrap status for UI.
 pub async fn get_tor_status() -> Result<String> {
-    tunnel::get_tor_status().await
+    service::timed_async(
+        "get_tor_status",
+        async move { tunnel::get_tor_status().await },
+    )
+    .await
 }
 
 /// Rotate Tor exit circuits for new streams and reconnect sync channels.
 pub async fn rotate_tor_exit() -> Result<()> {
-    tunnel::rotate_tor_exit().await
+    service::timed_async(
+        "rotate_tor_exit",
+        async move { tunnel::rotate_tor_exit().await },
+    )
+    .await
 }
 
 /// Fetch arbitrary text over the currently selected network tunnel.
@@ -1763,7 +1923,11 @@ pub async fn fetch_external_text(
     accept: Option<String>,
     user_agent: Option<String>,
 ) -> Result<String> {
-    service::fetch_external_text(url, accept, user_agent).await
+    service::timed_async(
+        "fetch_external_text",
+        service::fetch_external_text(url, accept, user_agent),
+    )
+    .await
 }
 
 /// Fetch arbitrary bytes over the currently selected network tunnel.
@@ -1772,7 +1936,11 @@ pub async fn fetch_external_bytes(
     accept: Option<String>,
     user_agent: Option<String>,
 ) -> Result<Vec<u8>> {
-    service::fetch_external_bytes(url, accept, user_agent).await
+    service::timed_async(
+        "fetch_external_bytes",
+        service::fetch_external_bytes(url, accept, user_agent),
+    )
+    .await
 }
 
 /// Download an external resource to a local file over the currently selected network tunnel.
@@ -1782,7 +1950,11 @@ pub async fn download_external_to_file(
     accept: Option<String>,
     user_agent: Option<String>,
 ) -> Result<()> {
-    service::download_external_to_file(url, destination_path, accept, user_agent).await
+    service::timed_async(
+        "download_external_to_file",
+        service::download_external_to_file(url, destination_path, accept, user_agent),
+    )
+    .await
 }
 
 // ============================================================================
@@ -1796,7 +1968,9 @@ pub async fn download_external_to_file(
 /// - pending: Unconfirmed unspent notes
 /// - total: spendable + pending
 pub fn get_balance(wallet_id: WalletId) -> Result<Balance> {
-    convert_from_service(service::get_balance(wallet_id)?)
+    service::timed("get_balance", || {
+        convert_from_service(service::get_balance(wallet_id)?)
+    })
 }
 
 /// List transactions
@@ -1804,7 +1978,9 @@ pub fn get_balance(wallet_id: WalletId) -> Result<Balance> {
 /// Returns transaction history from the database, aggregated by transaction ID.
 /// Transactions are sorted by height descending (newest first).
 pub fn list_transactions(wallet_id: WalletId, limit: Option<u32>) -> Result<Vec<TxInfo>> {
-    convert_from_service(service::list_transactions(wallet_id, limit)?)
+    service::timed("list_transactions", || {
+        convert_from_service(service::list_transactions(wallet_id, limit)?)
+    })
 }
 
 /// Fetch and decrypt memo for a specific transaction (lazy memo decoding)
@@ -1827,7 +2003,11 @@ pub async fn fetch_transaction_memo(
     txid: String,
     output_index: Option<u32>,
 ) -> Result<Option<String>> {
-    service::fetch_transaction_memo(wallet_id, txid, output_index).await
+    service::timed_async(
+        "fetch_transaction_memo",
+        service::fetch_transaction_memo(wallet_id, txid, output_index),
+    )
+    .await
 }
 
 /// Export all payment disclosures recoverable by this wallet for an outgoing transaction.
@@ -1835,7 +2015,10 @@ pub async fn export_payment_disclosures(
     wallet_id: WalletId,
     txid: String,
 ) -> Result<Vec<PaymentDisclosure>> {
-    convert_from_service(service::export_payment_disclosures(wallet_id, txid).await?)
+    service::timed_async("export_payment_disclosures", async move {
+        convert_from_service(service::export_payment_disclosures(wallet_id, txid).await?)
+    })
+    .await
 }
 
 /// Export a Sapling payment disclosure for a specific output index.
@@ -1844,7 +2027,11 @@ pub async fn export_sapling_payment_disclosure(
     txid: String,
     output_index: u32,
 ) -> Result<String> {
-    service::export_sapling_payment_disclosure(wallet_id, txid, output_index).await
+    service::timed_async(
+        "export_sapling_payment_disclosure",
+        service::export_sapling_payment_disclosure(wallet_id, txid, output_index),
+    )
+    .await
 }
 
 /// Export an Orchard payment disclosure for a specific action index.
@@ -1853,7 +2040,11 @@ pub async fn export_orchard_payment_disclosure(
     txid: String,
     action_index: u32,
 ) -> Result<String> {
-    service::export_orchard_payment_disclosure(wallet_id, txid, action_index).await
+    service::timed_async(
+        "export_orchard_payment_disclosure",
+        service::export_orchard_payment_disclosure(wallet_id, txid, action_index),
+    )
+    .await
 }
 
 /// Verify and decrypt a Sapling or Orchard payment disclosure.
@@ -1861,7 +2052,10 @@ pub async fn verify_payment_disclosure(
     wallet_id: WalletId,
     disclosure: String,
 ) -> Result<PaymentDisclosureVerification> {
-    convert_from_service(service::verify_payment_disclosure(wallet_id, disclosure).await?)
+    service::timed_async("verify_payment_disclosure", async move {
+        convert_from_service(service::verify_payment_disclosure(wallet_id, disclosure).await?)
+    })
+    .await
 }
 
 async fn fetch_transaction_memo_inner(
@@ -2352,11 +2546,13 @@ pub fn generate_mnemonic(
     word_count: Option<u32>,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<String> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    service::generate_mnemonic(word_count, mnemonic_language)
+    service::timed("generate_mnemonic", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        service::generate_mnemonic(word_count, mnemonic_language)
+    })
 }
 
 /// Validate mnemonic
@@ -2364,16 +2560,20 @@ pub fn validate_mnemonic(
     mnemonic: String,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<bool> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    service::validate_mnemonic(mnemonic, mnemonic_language)
+    service::timed("validate_mnemonic", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        service::validate_mnemonic(mnemonic, mnemonic_language)
+    })
 }
 
 /// Inspect mnemonic validity, language, and ambiguity.
 pub fn inspect_mnemonic(mnemonic: String) -> Result<MnemonicInspection> {
-    convert_from_service(service::inspect_mnemonic(mnemonic)?)
+    service::timed("inspect_mnemonic", || {
+        convert_from_service(service::inspect_mnemonic(mnemonic)?)
+    })
 }
 
 /// Convert a mnemonic phrase to a different display language while preserving seed entropy.
@@ -2382,27 +2582,31 @@ pub fn convert_mnemonic_language(
     source_language: Option<MnemonicLanguage>,
     target_language: MnemonicLanguage,
 ) -> Result<String> {
-    let source_language = match source_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    let target_language = convert_into_service(target_language)?;
-    service::convert_mnemonic_language(mnemonic, source_language, target_language)
+    service::timed("convert_mnemonic_language", || {
+        let source_language = match source_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        let target_language = convert_into_service(target_language)?;
+        service::convert_mnemonic_language(mnemonic, source_language, target_language)
+    })
 }
 
 /// Get network info
 pub fn get_network_info() -> Result<NetworkInfo> {
-    convert_from_service(service::get_network_info()?)
+    service::timed("get_network_info", || {
+        convert_from_service(service::get_network_info()?)
+    })
 }
 
 /// Format amount (arrrtoshis to ARRR)
 pub fn format_amount(arrrtoshis: u64) -> Result<String> {
-    service::format_amount(arrrtoshis)
+    service::timed("format_amount", || service::format_amount(arrrtoshis))
 }
 
 /// Parse amount (ARRR to arrrtoshis)
 pub fn parse_amount(arrr: String) -> Result<u64> {
-    service::parse_amount(arrr)
+    service::timed("parse_amount", || service::parse_amount(arrr))
 }
 
 // ============================================================================
@@ -2425,62 +2629,70 @@ lazy_static::lazy_static! {
 
 /// Set panic PIN for decoy vault
 pub fn set_panic_pin(pin: String) -> Result<()> {
-    service::set_panic_pin(pin)
+    service::timed("set_panic_pin", || service::set_panic_pin(pin))
 }
 
 /// Check if panic PIN is configured
 pub fn has_panic_pin() -> Result<bool> {
-    service::has_panic_pin()
+    service::timed("has_panic_pin", service::has_panic_pin)
 }
 
 /// Verify panic PIN (returns true if PIN matches and activates decoy mode)
 pub fn verify_panic_pin(pin: String) -> Result<bool> {
-    service::verify_panic_pin(pin)
+    service::timed("verify_panic_pin", || service::verify_panic_pin(pin))
 }
 
 /// Check if currently in decoy mode
 pub fn is_decoy_mode() -> Result<bool> {
-    service::is_decoy_mode()
+    service::timed("is_decoy_mode", service::is_decoy_mode)
 }
 
 /// Get current vault mode
 pub fn get_vault_mode() -> Result<String> {
-    service::get_vault_mode()
+    service::timed("get_vault_mode", service::get_vault_mode)
 }
 
 /// Clear panic PIN and disable decoy vault
 pub fn clear_panic_pin() -> Result<()> {
-    service::clear_panic_pin()
+    service::timed("clear_panic_pin", service::clear_panic_pin)
 }
 
 /// Set duress passphrase for decoy vault.
 pub fn set_duress_passphrase(custom_passphrase: Option<String>) -> Result<()> {
-    service::set_duress_passphrase(custom_passphrase)
+    service::timed("set_duress_passphrase", || {
+        service::set_duress_passphrase(custom_passphrase)
+    })
 }
 
 /// Check if a duress passphrase is configured
 pub fn has_duress_passphrase() -> Result<bool> {
-    service::has_duress_passphrase()
+    service::timed("has_duress_passphrase", service::has_duress_passphrase)
 }
 
 /// Clear duress passphrase configuration
 pub fn clear_duress_passphrase() -> Result<()> {
-    service::clear_duress_passphrase()
+    service::timed("clear_duress_passphrase", || {
+        service::clear_duress_passphrase()
+    })
 }
 
 /// Verify duress passphrase (activates decoy mode if correct)
 pub fn verify_duress_passphrase(passphrase: String) -> Result<bool> {
-    service::verify_duress_passphrase(passphrase)
+    service::timed("verify_duress_passphrase", || {
+        service::verify_duress_passphrase(passphrase)
+    })
 }
 
 /// Set decoy wallet name
 pub fn set_decoy_wallet_name(name: String) -> Result<()> {
-    service::set_decoy_wallet_name(name)
+    service::timed("set_decoy_wallet_name", || {
+        service::set_decoy_wallet_name(name)
+    })
 }
 
 /// Exit decoy mode (requires real passphrase re-authentication).
 pub fn exit_decoy_mode(passphrase: String) -> Result<()> {
-    service::exit_decoy_mode(passphrase)
+    service::timed("exit_decoy_mode", || service::exit_decoy_mode(passphrase))
 }
 
 // ============================================================================
@@ -2488,25 +2700,31 @@ pub fn exit_decoy_mode(passphrase: String) -> Result<()> {
 // ============================================================================
 
 pub fn set_debug_logging_enabled(enabled: bool) -> Result<()> {
-    pirate_core::debug_log::set_enabled(enabled);
-    if enabled {
-        RUNTIME_DIAGNOSTICS_STOP.store(false, Ordering::SeqCst);
-        install_runtime_diagnostics();
-    } else {
-        RUNTIME_DIAGNOSTICS_STOP.store(true, Ordering::SeqCst);
-        clear_runtime_marker();
-    }
-    Ok(())
+    service::timed("set_debug_logging_enabled", || {
+        pirate_core::debug_log::set_enabled(enabled);
+        if enabled {
+            RUNTIME_DIAGNOSTICS_STOP.store(false, Ordering::SeqCst);
+            install_runtime_diagnostics();
+        } else {
+            RUNTIME_DIAGNOSTICS_STOP.store(true, Ordering::SeqCst);
+            clear_runtime_marker();
+        }
+        Ok(())
+    })
 }
 
 pub fn get_debug_logging_enabled() -> Result<bool> {
-    Ok(pirate_core::debug_log::is_enabled())
+    service::timed("get_debug_logging_enabled", || {
+        Ok(pirate_core::debug_log::is_enabled())
+    })
 }
 
 pub fn clear_debug_logs() -> Result<()> {
-    pirate_core::debug_log::clear_logs();
-    clear_runtime_marker();
-    Ok(())
+    service::timed("clear_debug_logs", || {
+        pirate_core::debug_log::clear_logs();
+        clear_runtime_marker();
+        Ok(())
+    })
 }
 
 // ============================================================================
@@ -2515,22 +2733,28 @@ pub fn clear_debug_logs() -> Result<()> {
 
 /// Start seed export flow (step 1: show warning)
 pub fn start_seed_export(wallet_id: WalletId) -> Result<String> {
-    seed_export::start_seed_export(wallet_id)
+    service::timed("start_seed_export", || {
+        seed_export::start_seed_export(wallet_id)
+    })
 }
 
 /// Acknowledge seed export warning (step 2)
 pub fn acknowledge_seed_warning() -> Result<String> {
-    seed_export::acknowledge_seed_warning()
+    service::timed("acknowledge_seed_warning", || {
+        seed_export::acknowledge_seed_warning()
+    })
 }
 
 /// Complete biometric step (step 3)
 pub fn complete_seed_biometric(success: bool) -> Result<String> {
-    seed_export::complete_seed_biometric(success)
+    service::timed("complete_seed_biometric", || {
+        seed_export::complete_seed_biometric(success)
+    })
 }
 
 /// Skip biometric (when not available)
 pub fn skip_seed_biometric() -> Result<String> {
-    seed_export::skip_seed_biometric()
+    service::timed("skip_seed_biometric", || seed_export::skip_seed_biometric())
 }
 
 /// Verify passphrase and get seed (step 4 - final)
@@ -2545,11 +2769,13 @@ pub fn export_seed_with_passphrase(
     passphrase: String,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<Vec<String>> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    seed_export::export_seed_with_passphrase(wallet_id, passphrase, mnemonic_language)
+    service::timed("export_seed_with_passphrase", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        seed_export::export_seed_with_passphrase(wallet_id, passphrase, mnemonic_language)
+    })
 }
 
 /// Export seed using cached app passphrase (after biometric approval).
@@ -2557,36 +2783,46 @@ pub fn export_seed_with_cached_passphrase(
     wallet_id: WalletId,
     mnemonic_language: Option<MnemonicLanguage>,
 ) -> Result<Vec<String>> {
-    let mnemonic_language = match mnemonic_language {
-        Some(value) => Some(convert_into_service(value)?),
-        None => None,
-    };
-    seed_export::export_seed_with_cached_passphrase(wallet_id, mnemonic_language)
+    service::timed("export_seed_with_cached_passphrase", || {
+        let mnemonic_language = match mnemonic_language {
+            Some(value) => Some(convert_into_service(value)?),
+            None => None,
+        };
+        seed_export::export_seed_with_cached_passphrase(wallet_id, mnemonic_language)
+    })
 }
 
 /// Cancel seed export flow
 pub fn cancel_seed_export() -> Result<()> {
-    seed_export::cancel_seed_export()
+    service::timed("cancel_seed_export", || seed_export::cancel_seed_export())
 }
 
 /// Get current seed export flow state
 pub fn get_seed_export_state() -> Result<String> {
-    seed_export::get_seed_export_state()
+    service::timed("get_seed_export_state", || {
+        seed_export::get_seed_export_state()
+    })
 }
 
 /// Check if screenshots are blocked during export
 pub fn are_seed_screenshots_blocked() -> Result<bool> {
-    seed_export::are_seed_screenshots_blocked()
+    service::timed("are_seed_screenshots_blocked", || {
+        seed_export::are_seed_screenshots_blocked()
+    })
 }
 
 /// Get clipboard auto-clear remaining seconds
 pub fn get_seed_clipboard_remaining() -> Result<Option<u64>> {
-    seed_export::get_seed_clipboard_remaining()
+    service::timed("get_seed_clipboard_remaining", || {
+        seed_export::get_seed_clipboard_remaining()
+    })
 }
 
 /// Get seed export warning messages
 pub fn get_seed_export_warnings() -> Result<SeedExportWarnings> {
-    seed_export::get_seed_export_warnings()
+    service::timed("get_seed_export_warnings", || {
+        seed_export::get_seed_export_warnings()
+    })
 }
 
 // ============================================================================
@@ -2595,7 +2831,9 @@ pub fn get_seed_export_warnings() -> Result<SeedExportWarnings> {
 
 /// Export Sapling viewing key from full wallet (for creating watch-only on another device)
 pub fn export_sapling_viewing_key_secure(wallet_id: WalletId) -> Result<String> {
-    service::export_sapling_viewing_key_secure(wallet_id)
+    service::timed("export_sapling_viewing_key_secure", || {
+        service::export_sapling_viewing_key_secure(wallet_id)
+    })
 }
 
 /// Import Sapling viewing key to create watch-only wallet
@@ -2604,12 +2842,20 @@ pub fn import_sapling_viewing_key_as_watch_only(
     sapling_viewing_key: String,
     birthday_height: u32,
 ) -> Result<WalletId> {
-    service::import_sapling_viewing_key_as_watch_only(name, sapling_viewing_key, birthday_height)
+    service::timed("import_sapling_viewing_key_as_watch_only", || {
+        service::import_sapling_viewing_key_as_watch_only(
+            name,
+            sapling_viewing_key,
+            birthday_height,
+        )
+    })
 }
 
 /// Get watch-only capabilities for a wallet
 pub fn get_watch_only_capabilities(wallet_id: WalletId) -> Result<WatchOnlyCapabilitiesInfo> {
-    convert_from_service(service::get_watch_only_capabilities(wallet_id)?)
+    service::timed("get_watch_only_capabilities", || {
+        convert_from_service(service::get_watch_only_capabilities(wallet_id)?)
+    })
 }
 
 /// Watch-only capabilities for FFI
@@ -2625,7 +2871,9 @@ pub struct WatchOnlyCapabilitiesInfo {
 
 /// Get watch-only banner info for a wallet
 pub fn get_watch_only_banner(wallet_id: WalletId) -> Result<Option<WatchOnlyBannerInfo>> {
-    convert_from_service(service::get_watch_only_banner(wallet_id)?)
+    service::timed("get_watch_only_banner", || {
+        convert_from_service(service::get_watch_only_banner(wallet_id)?)
+    })
 }
 
 /// Watch-only banner info for FFI
@@ -2639,12 +2887,14 @@ pub struct WatchOnlyBannerInfo {
 
 /// Check if viewing key clipboard should be cleared
 pub fn get_ivk_clipboard_remaining() -> Result<Option<u64>> {
-    service::get_ivk_clipboard_remaining()
+    service::timed("get_ivk_clipboard_remaining", || {
+        service::get_ivk_clipboard_remaining()
+    })
 }
 
 /// Get build information for verification
 pub fn get_build_info() -> Result<BuildInfo> {
-    diagnostics::get_build_info()
+    service::timed("get_build_info", || diagnostics::get_build_info())
 }
 
 /// Get sync logs for diagnostics
@@ -2652,12 +2902,24 @@ pub fn get_sync_logs(
     wallet_id: WalletId,
     limit: Option<u32>,
 ) -> Result<Vec<crate::models::SyncLogEntryFfi>> {
-    diagnostics::get_sync_logs(wallet_id, limit)
+    service::timed("get_sync_logs", || {
+        diagnostics::get_sync_logs(wallet_id, limit)
+    })
+}
+
+/// Per-method call counts and latency histograms of the wallet service, as
+/// JSON. Covers the calls made through these bindings as well as requests
+/// served through the service request path (native C ABI, batch and CBOR
+/// entry points).
+pub fn get_service_stats_json() -> Result<String> {
+    diagnostics::get_service_stats_json()
 }
 
 /// Get checkpoint details at specific height
 pub fn get_checkpoint_details(_wallet_id: WalletId, height: u32) -> Result<Option<CheckpointInfo>> {
-    diagnostics::get_checkpoint_details(_wallet_id, height)
+    service::timed("get_checkpoint_details", || {
+        diagnostics::get_checkpoint_details(_wallet_id, height)
+    })
 }
 
 /// Test connection to a lightwalletd endpoint
@@ -2665,7 +2927,11 @@ pub async fn test_node(
     url: String,
     tls_pin: Option<String>,
 ) -> Result<crate::models::NodeTestResult> {
-    tunnel::test_node(url, tls_pin).await
+    service::timed_async(
+        "test_node",
+        async move { tunnel::test_node(url, tls_pin).await },
+    )
+    .await
 }
 #[cfg(test)]
 mod api_regression_tests;
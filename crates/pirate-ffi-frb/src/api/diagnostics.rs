@@ -17,6 +17,10 @@ pub(super) fn get_sync_logs(
     convert_from_service(service::get_sync_logs(wallet_id, limit)?)
 }
 
+pub(super) fn get_service_stats_json() -> Result<String> {
+    Ok(service::stats_json().to_string())
+}
+
 pub(super) fn get_checkpoint_details(
     wallet_id: WalletId,
     height: u32,
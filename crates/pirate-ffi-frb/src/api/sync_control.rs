@@ -337,20 +337,9 @@ pub(super) fn maybe_trigger_compact_sync(wallet_id: WalletId) {
         return;
     }
 
-    if let Ok(handle) = tokio::runtime::Handle::try_current() {
-        handle.spawn(async move {
-            let _ = start_sync(wallet_id, SyncMode::Compact).await;
-        });
-    } else {
-        std::thread::spawn(move || {
-            if let Ok(runtime) = tokio::runtime::Builder::new_current_thread()
-                .enable_all()
-                .build()
-            {
-                let _ = runtime.block_on(start_sync(wallet_id, SyncMode::Compact));
-            }
-        });
-    }
+    background_handle().spawn(async move {
+        let _ = start_sync(wallet_id, SyncMode::Compact).await;
+    });
 }
 
 pub(super) fn get_spendability_status(wallet_id: WalletId) -> Result<SpendabilityStatus> {
@@ -969,51 +958,21 @@ fn schedule_target_height_update(
         session.last_target_height_update = Some(std::time::Instant::now());
     }
 
-    if let Ok(handle) = tokio::runtime::Handle::try_current() {
-        let sync_clone = Arc::clone(&sync);
-        let session_arc_clone = Arc::clone(&session_arc);
-        handle.spawn(async move {
-            let result = run_sync_engine_task(sync_clone, |engine| {
-                Box::pin(async move {
-                    engine
-                        .update_target_height()
-                        .await
-                        .map_err(anyhow::Error::from)
-                })
+    background_handle().spawn(async move {
+        let result = run_sync_engine_task(sync, |engine| {
+            Box::pin(async move {
+                engine
+                    .update_target_height()
+                    .await
+                    .map_err(anyhow::Error::from)
             })
-            .await;
-            if result.is_ok() {
-                let mut session = session_arc_clone.lock().await;
-                session.last_target_height_update = Some(std::time::Instant::now());
-            }
-        });
-    } else {
-        let sync_clone = Arc::clone(&sync);
-        let session_arc_clone = Arc::clone(&session_arc);
-        std::thread::spawn(move || {
-            let runtime = tokio::runtime::Builder::new_current_thread()
-                .enable_all()
-                .build();
-            if let Ok(runtime) = runtime {
-                runtime.block_on(async move {
-                    let result = run_sync_engine_task(sync_clone, |engine| {
-                        Box::pin(async move {
-                            engine
-                                .update_target_height()
-                                .await
-                                .map_err(anyhow::Error::from)
-                        })
-                    })
-                    .await;
-                    if result.is_ok() {
-                        if let Ok(mut session) = session_arc_clone.try_lock() {
-                            session.last_target_height_update = Some(std::time::Instant::now());
-                        }
-                    }
-                });
-            }
-        });
-    }
+        })
+        .await;
+        if result.is_ok() {
+            let mut session = session_arc.lock().await;
+            session.last_target_height_update = Some(std::time::Instant::now());
+        }
+    });
 }
 
 fn maybe_schedule_sync_recovery(
@@ -1071,20 +1030,9 @@ fn maybe_schedule_sync_recovery(
     });
 
     let wallet_id_clone = wallet_id.clone();
-    if let Ok(handle) = tokio::runtime::Handle::try_current() {
-        handle.spawn(async move {
-            let _ = start_sync(wallet_id_clone, SyncMode::Compact).await;
-        });
-    } else {
-        std::thread::spawn(move || {
-            if let Ok(runtime) = tokio::runtime::Builder::new_current_thread()
-                .enable_all()
-                .build()
-            {
-                let _ = runtime.block_on(start_sync(wallet_id_clone, SyncMode::Compact));
-            }
-        });
-    }
+    background_handle().spawn(async move {
+        let _ = start_sync(wallet_id_clone, SyncMode::Compact).await;
+    });
 }
 
 fn sync_status_inner(wallet_id: WalletId) -> Result<SyncStatus> {
@@ -1680,6 +1680,29 @@ fn wire__crate__api__get_lightd_endpoint_config_impl(
         },
     )
 }
+fn wire__crate__api__get_lightd_mirrors_impl(
+    port_: flutter_rust_bridge::for_generated::MessagePort,
+    wallet_id: impl CstDecode<String>,
+) {
+    FLUTTER_RUST_BRIDGE_HANDLER.wrap_normal::<flutter_rust_bridge::for_generated::DcoCodec, _, _>(
+        flutter_rust_bridge::for_generated::TaskInfo {
+            debug_name: "get_lightd_mirrors",
+            port: Some(port_),
+            mode: flutter_rust_bridge::for_generated::FfiCallMode::Normal,
+        },
+        move || {
+            let api_wallet_id = wallet_id.cst_decode();
+            move |context| {
+                transform_result_dco::<_, _, flutter_rust_bridge::for_generated::anyhow::Error>(
+                    (move || {
+                        let output_ok = crate::api::get_lightd_mirrors(api_wallet_id)?;
+                        Ok(output_ok)
+                    })(),
+                )
+            }
+        },
+    )
+}
 fn wire__crate__api__get_network_info_impl(port_: flutter_rust_bridge::for_generated::MessagePort) {
     FLUTTER_RUST_BRIDGE_HANDLER.wrap_normal::<flutter_rust_bridge::for_generated::DcoCodec, _, _>(
         flutter_rust_bridge::for_generated::TaskInfo {
@@ -1845,6 +1868,27 @@ fn wire__crate__api__get_seed_export_warnings_impl(
         },
     )
 }
+fn wire__crate__api__get_service_stats_json_impl(
+    port_: flutter_rust_bridge::for_generated::MessagePort,
+) {
+    FLUTTER_RUST_BRIDGE_HANDLER.wrap_normal::<flutter_rust_bridge::for_generated::DcoCodec, _, _>(
+        flutter_rust_bridge::for_generated::TaskInfo {
+            debug_name: "get_service_stats_json",
+            port: Some(port_),
+            mode: flutter_rust_bridge::for_generated::FfiCallMode::Normal,
+        },
+        move || {
+            move |context| {
+                transform_result_dco::<_, _, flutter_rust_bridge::for_generated::anyhow::Error>(
+                    (move || {
+                        let output_ok = crate::api::get_service_stats_json()?;
+                        Ok(output_ok)
+                    })(),
+                )
+            }
+        },
+    )
+}
 fn wire__crate__api__get_spendability_status_impl(
     port_: flutter_rust_bridge::for_generated::MessagePort,
     wallet_id: impl CstDecode<String>,
@@ -3001,6 +3045,31 @@ fn wire__crate__api__set_lightd_endpoint_impl(
         },
     )
 }
+fn wire__crate__api__set_lightd_mirrors_impl(
+    port_: flutter_rust_bridge::for_generated::MessagePort,
+    wallet_id: impl CstDecode<String>,
+    urls: impl CstDecode<Vec<String>>,
+) {
+    FLUTTER_RUST_BRIDGE_HANDLER.wrap_normal::<flutter_rust_bridge::for_generated::DcoCodec, _, _>(
+        flutter_rust_bridge::for_generated::TaskInfo {
+            debug_name: "set_lightd_mirrors",
+            port: Some(port_),
+            mode: flutter_rust_bridge::for_generated::FfiCallMode::Normal,
+        },
+        move || {
+            let api_wallet_id = wallet_id.cst_decode();
+            let api_urls = urls.cst_decode();
+            move |context| {
+                transform_result_dco::<_, _, flutter_rust_bridge::for_generated::anyhow::Error>(
+                    (move || {
+                        let output_ok = crate::api::set_lightd_mirrors(api_wallet_id, api_urls)?;
+                        Ok(output_ok)
+                    })(),
+                )
+            }
+        },
+    )
+}
 fn wire__crate__api__set_panic_pin_impl(
     port_: flutter_rust_bridge::for_generated::MessagePort,
     pin: impl CstDecode<String>,
@@ -8551,6 +8620,14 @@ mod io {
         wire__crate__api__get_lightd_endpoint_config_impl(port_, wallet_id)
     }
 
+    #[unsafe(no_mangle)]
+    pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__get_lightd_mirrors(
+        port_: i64,
+        wallet_id: *mut wire_cst_list_prim_u_8_strict,
+    ) {
+        wire__crate__api__get_lightd_mirrors_impl(port_, wallet_id)
+    }
+
     #[unsafe(no_mangle)]
     pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__get_network_info(port_: i64) {
         wire__crate__api__get_network_info_impl(port_)
@@ -8608,6 +8685,11 @@ mod io {
         wire__crate__api__get_seed_export_warnings_impl(port_)
     }
 
+    #[unsafe(no_mangle)]
+    pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__get_service_stats_json(port_: i64) {
+        wire__crate__api__get_service_stats_json_impl(port_)
+    }
+
     #[unsafe(no_mangle)]
     pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__get_spendability_status(
         port_: i64,
@@ -9005,6 +9087,15 @@ mod io {
         wire__crate__api__set_lightd_endpoint_impl(port_, wallet_id, url, tls_pin_opt)
     }
 
+    #[unsafe(no_mangle)]
+    pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__set_lightd_mirrors(
+        port_: i64,
+        wallet_id: *mut wire_cst_list_prim_u_8_strict,
+        urls: *mut wire_cst_list_String,
+    ) {
+        wire__crate__api__set_lightd_mirrors_impl(port_, wallet_id, urls)
+    }
+
     #[unsafe(no_mangle)]
     pub extern "C" fn frbgen_pirate_wallet_wire__crate__api__set_panic_pin(
         port_: i64,
@@ -11695,6 +11786,14 @@ mod web {
         wire__crate__api__get_lightd_endpoint_config_impl(port_, wallet_id)
     }
 
+    #[wasm_bindgen]
+    pub fn wire__crate__api__get_lightd_mirrors(
+        port_: flutter_rust_bridge::for_generated::MessagePort,
+        wallet_id: String,
+    ) {
+        wire__crate__api__get_lightd_mirrors_impl(port_, wallet_id)
+    }
+
     #[wasm_bindgen]
     pub fn wire__crate__api__get_network_info(
         port_: flutter_rust_bridge::for_generated::MessagePort,
@@ -11758,6 +11857,13 @@ mod web {
         wire__crate__api__get_seed_export_warnings_impl(port_)
     }
 
+    #[wasm_bindgen]
+    pub fn wire__crate__api__get_service_stats_json(
+        port_: flutter_rust_bridge::for_generated::MessagePort,
+    ) {
+        wire__crate__api__get_service_stats_json_impl(port_)
+    }
+
     #[wasm_bindgen]
     pub fn wire__crate__api__get_spendability_status(
         port_: flutter_rust_bridge::for_generated::MessagePort,
@@ -12171,6 +12277,15 @@ mod web {
         wire__crate__api__set_lightd_endpoint_impl(port_, wallet_id, url, tls_pin_opt)
     }
 
+    #[wasm_bindgen]
+    pub fn wire__crate__api__set_lightd_mirrors(
+        port_: flutter_rust_bridge::for_generated::MessagePort,
+        wallet_id: String,
+        urls: flutter_rust_bridge::for_generated::wasm_bindgen::JsValue,
+    ) {
+        wire__crate__api__set_lightd_mirrors_impl(port_, wallet_id, urls)
+    }
+
     #[wasm_bindgen]
     pub fn wire__crate__api__set_panic_pin(
         port_: flutter_rust_bridge::for_generated::MessagePort,
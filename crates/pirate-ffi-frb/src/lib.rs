@@ -49,3 +49,205 @@ pub extern "C" fn pirate_debug_log_is_enabled() -> u8 {
 pub extern "C" fn pirate_debug_log_clear() {
     let _ = crate::api::clear_debug_logs();
 }
+
+/// Warm the backend ahead of the first Dart call. Desktop runners call this on
+/// a background thread while the Flutter engine starts; it blocks until the
+/// runtime is built and the registry and block cache files are paged in. The
+/// proving parameters load on their own low-priority thread and keep going
+/// after this returns.
+#[no_mangle]
+pub extern "C" fn pirate_prewarm() {
+    let _ = pirate_wallet_service::prewarm_backend();
+    let _ = pirate_wallet_service::prewarm_prover();
+}
+
+/// Start loading the proving parameters in the background, for the send
+/// screen. Returns at once.
+#[no_mangle]
+pub extern "C" fn pirate_prewarm_prover() {
+    let _ = pirate_wallet_service::prewarm_prover();
+}
+
+/// Entry point for `--headless-sync`. The Linux runner calls this before GTK
+/// starts and exits with the returned status. Options come from the process
+/// arguments; see `HeadlessSyncOptions::from_args`.
+#[cfg(target_os = "linux")]
+#[no_mangle]
+pub extern "C" fn pirate_headless_sync_main() -> i32 {
+    let args = std::env::args()
+        .skip(1)
+        .filter(|arg| arg != "--headless-sync");
+    let result = pirate_wallet_service::HeadlessSyncOptions::from_args(args)
+        .and_then(pirate_wallet_service::run_headless_sync);
+    match result {
+        Ok(()) => 0,
+        Err(e) => {
+            eprintln!("headless sync: {:#}", e);
+            1
+        }
+    }
+}
+
+/// Report host power and window state so running syncs can throttle. Desktop
+/// runners call this from their window and power notifications; each flag is
+/// 0 or 1.
+#[no_mangle]
+pub extern "C" fn pirate_set_sync_power_state(
+    on_ac_power: u8,
+    window_visible: u8,
+    window_focused: u8,
+    session_locked: u8,
+) {
+    pirate_sync_lightd::set_sync_power_state(pirate_sync_lightd::SyncPowerState {
+        on_ac_power: on_ac_power != 0,
+        window_visible: window_visible != 0,
+        window_focused: window_focused != 0,
+        session_locked: session_locked != 0,
+    });
+}
+
+/// Host callback for warm-start snapshots: a JSON document, or an empty
+/// buffer when the stored snapshot must be deleted. The bytes are only valid
+/// during the call; the host copies them, seals them with the platform
+/// keystore and persists them off the calling thread.
+pub type WarmSnapshotCallback = extern "C" fn(data: *const u8, len: usize);
+
+/// Host callback that hands over the snapshot the runner unsealed at startup,
+/// with the same two-call contract as `FastUnlockLoadCallback`.
+pub type WarmSnapshotLoadCallback = extern "C" fn(buffer: *mut u8, capacity: usize) -> usize;
+
+/// Install, or clear with null pointers, the runner's warm-start snapshot
+/// store. Snapshots are built after sync checkpoints only while `store` is
+/// set; `load` lets the first one keep wallets from the previous session.
+#[no_mangle]
+pub extern "C" fn pirate_set_warm_snapshot_host(
+    store: Option<WarmSnapshotCallback>,
+    load: Option<WarmSnapshotLoadCallback>,
+) {
+    pirate_wallet_service::set_warm_snapshot_source(load.map(|load| {
+        Box::new(move || load_from_host(load)) as pirate_wallet_service::WarmSnapshotSource
+    }));
+    pirate_wallet_service::set_warm_snapshot_sink(store.map(|store| {
+        Box::new(move |document: &[u8]| store(document.as_ptr(), document.len()))
+            as pirate_wallet_service::WarmSnapshotSink
+    }));
+}
+
+/// Host callback that receives fast-unlock bundles to seal, with the same
+/// contract as `WarmSnapshotCallback`: an empty buffer deletes the stored
+/// bundle.
+pub type FastUnlockStoreCallback = extern "C" fn(data: *const u8, len: usize);
+
+/// Host callback that hands over the bundle unsealed at startup. Called with
+/// `capacity` 0 it returns the bundle size (0 for none), or
+/// [`FAST_UNLOCK_LOAD_PENDING`] while it is still unsealing; called again with
+/// a buffer of that size it copies the bundle, wipes its own copy and returns
+/// the number of bytes written.
+pub type FastUnlockLoadCallback = extern "C" fn(buffer: *mut u8, capacity: usize) -> usize;
+
+/// Size a fast-unlock loader reports while the bundle is still being
+/// unsealed. The backend asks again shortly instead of running the KDF.
+pub const FAST_UNLOCK_LOAD_PENDING: usize = usize::MAX;
+
+/// Install, or clear with null pointers, the runner's fast-unlock keystore.
+#[no_mangle]
+pub extern "C" fn pirate_set_fast_unlock_host(
+    store: Option<FastUnlockStoreCallback>,
+    load: Option<FastUnlockLoadCallback>,
+) {
+    pirate_wallet_service::set_fast_unlock_sink(store.map(|store| {
+        Box::new(move |bundle: &[u8]| store(bundle.as_ptr(), bundle.len()))
+            as pirate_wallet_service::FastUnlockSink
+    }));
+    pirate_wallet_service::set_fast_unlock_source(load.map(|load| {
+        Box::new(move || match load(std::ptr::null_mut(), 0) {
+            FAST_UNLOCK_LOAD_PENDING => pirate_wallet_service::FastUnlockLoad::Pending,
+            len => read_from_host(load, len).map_or(
+                pirate_wallet_service::FastUnlockLoad::Empty,
+                pirate_wallet_service::FastUnlockLoad::Bundle,
+            ),
+        }) as pirate_wallet_service::FastUnlockSource
+    }));
+}
+
+/// Ask a two-call host loader for its size, then for the bytes.
+fn load_from_host(
+    load: extern "C" fn(buffer: *mut u8, capacity: usize) -> usize,
+) -> Option<Vec<u8>> {
+    read_from_host(load, load(std::ptr::null_mut(), 0))
+}
+
+/// Second half of [`load_from_host`], once the loader reported `len`.
+fn read_from_host(
+    load: extern "C" fn(buffer: *mut u8, capacity: usize) -> usize,
+    len: usize,
+) -> Option<Vec<u8>> {
+    if len == 0 {
+        return None;
+    }
+    let mut bytes = vec![0u8; len];
+    let written = load(bytes.as_mut_ptr(), bytes.len());
+    bytes.truncate(written.min(len));
+    (!bytes.is_empty()).then_some(bytes)
+}
+
+/// Opt in to or out of fast unlock; see `set_fast_unlock_policy`. A
+/// `max_age_secs` of 0 keeps the default grace period.
+#[no_mangle]
+pub extern "C" fn pirate_set_fast_unlock_policy(enabled: u8, max_age_secs: u64) {
+    let max_age = (max_age_secs > 0).then(|| std::time::Duration::from_secs(max_age_secs));
+    pirate_wallet_service::set_fast_unlock_policy(enabled != 0, max_age);
+}
+
+/// Size the shared backend runtime before the first wallet call. Zero keeps
+/// a default; `cpu_affinity_mask` selects CPUs 0..64. Returns 0 on success,
+/// -4 once the runtime has started and -5 for an invalid config.
+#[no_mangle]
+pub extern "C" fn pirate_configure_runtime(
+    worker_threads: u32,
+    max_blocking_threads: u32,
+    cpu_affinity_mask: u64,
+) -> i32 {
+    let config = pirate_wallet_service::RuntimeConfig::from_abi(
+        worker_threads,
+        max_blocking_threads,
+        cpu_affinity_mask,
+    );
+    if config.validate().is_err() {
+        return -5;
+    }
+    match pirate_wallet_service::configure_runtime(config) {
+        Ok(()) => 0,
+        Err(e) => {
+            tracing::warn!("runtime configuration rejected: {}", e);
+            -4
+        }
+    }
+}
+
+/// Cap sync batches, block cache reads and proving to `budget_bytes` of
+/// memory on low-RAM devices; 0 removes the cap. May be called at any time.
+/// Returns 0 on success and -5 for a budget below 128 MB.
+#[no_mangle]
+pub extern "C" fn pirate_set_memory_budget(budget_bytes: u64) -> i32 {
+    match pirate_wallet_service::set_memory_budget((budget_bytes > 0).then_some(budget_bytes)) {
+        Ok(()) => 0,
+        Err(e) => {
+            tracing::warn!("memory budget rejected: {}", e);
+            -5
+        }
+    }
+}
+
+/// Backend startup spans as a JSON array of Chrome trace events, for the
+/// runners' `com.pirate.wallet/perf` channel. The string stays valid until the
+/// next call; callers copy it out right away.
+#[no_mangle]
+pub extern "C" fn pirate_perf_trace_events_json() -> *const std::ffi::c_char {
+    static LAST: std::sync::Mutex<Option<std::ffi::CString>> = std::sync::Mutex::new(None);
+    let json = serde_json::Value::Array(pirate_wallet_service::perf::trace_events()).to_string();
+    let mut last = LAST.lock().unwrap_or_else(|poisoned| poisoned.into_inner());
+    // serde_json escapes NUL inside strings, so this never fails.
+    let text = last.insert(std::ffi::CString::new(json).unwrap_or_default());
+    text.as_ptr()
+}
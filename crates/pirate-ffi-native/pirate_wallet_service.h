@@ -2,14 +2,105 @@
 #define PIRATE_WALLET_SERVICE_H
 
 #include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define PIRATE_WALLET_SERVICE_OK 0
+#define PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT -1
+#define PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL -2
+
+#define PIRATE_WALLET_SERVICE_CANCELLED -3
+
+#define PIRATE_WALLET_SERVICE_ERR_RUNTIME_STARTED -4
+#define PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT -5
+
+#define PIRATE_WALLET_EVENT_HEIGHT 1
+#define PIRATE_WALLET_EVENT_NOTES 2
+#define PIRATE_WALLET_EVENT_BALANCE 4
+#define PIRATE_WALLET_EVENT_NEW_TX 8
+
+typedef struct pirate_wallet_service_t pirate_wallet_service_t;
+
+typedef void (*pirate_wallet_service_callback_t)(uint64_t request_id,
+                                                 int32_t status,
+                                                 const char *response,
+                                                 size_t response_len,
+                                                 void *user_data);
+
+typedef struct pirate_wallet_event_t {
+  uint32_t changed;
+  uint32_t new_tx_count;
+  uint64_t local_height;
+  uint64_t target_height;
+  uint64_t notes_decrypted;
+  uint64_t balance_total;
+  uint64_t balance_spendable;
+  uint64_t balance_pending;
+} pirate_wallet_event_t;
+
+typedef void (*pirate_wallet_event_callback_t)(uint64_t subscription_id,
+                                               const pirate_wallet_event_t *event,
+                                               void *user_data);
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+int32_t pirate_wallet_service_init_runtime(uint32_t worker_threads,
+                                           uint32_t max_blocking_threads,
+                                           uint64_t cpu_affinity_mask);
+
+int32_t pirate_wallet_service_set_memory_budget(uint64_t budget_bytes);
+
 char *pirate_wallet_service_invoke_json(const char *request_json, bool pretty);
 void pirate_wallet_service_free_string(char *ptr);
 
+char *pirate_wallet_service_stats_json(void);
+void pirate_wallet_service_stats_reset(void);
+
+pirate_wallet_service_t *pirate_wallet_service_new(void);
+void pirate_wallet_service_free(pirate_wallet_service_t *service);
+int32_t pirate_wallet_service_invoke_json_arena(pirate_wallet_service_t *service,
+                                                const char *request_json,
+                                                size_t request_len,
+                                                bool pretty,
+                                                const char **response_out,
+                                                size_t *response_len_out);
+int32_t pirate_wallet_service_invoke_json_buffer(pirate_wallet_service_t *service,
+                                                 const char *request_json,
+                                                 size_t request_len,
+                                                 bool pretty,
+                                                 uint8_t *buffer,
+                                                 size_t buffer_len,
+                                                 size_t *response_len_out);
+int32_t pirate_wallet_service_invoke_batch_json_arena(pirate_wallet_service_t *service,
+                                                      const char *requests_json,
+                                                      size_t requests_len,
+                                                      bool pretty,
+                                                      const char **response_out,
+                                                      size_t *response_len_out);
+int32_t pirate_wallet_service_invoke_cbor_arena(pirate_wallet_service_t *service,
+                                                const uint8_t *request,
+                                                size_t request_len,
+                                                const uint8_t **response_out,
+                                                size_t *response_len_out);
+int32_t pirate_wallet_service_last_response(const pirate_wallet_service_t *service,
+                                            const char **response_out,
+                                            size_t *response_len_out);
+
+uint64_t pirate_wallet_service_invoke_async(const char *request_json,
+                                            size_t request_len,
+                                            bool pretty,
+                                            pirate_wallet_service_callback_t callback,
+                                            void *user_data);
+bool pirate_wallet_service_cancel(uint64_t request_id);
+
+uint64_t pirate_wallet_service_subscribe(const char *wallet_id,
+                                         uint32_t interval_ms,
+                                         pirate_wallet_event_callback_t callback,
+                                         void *user_data);
+bool pirate_wallet_service_unsubscribe(uint64_t subscription_id);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,176 @@
+//! Asynchronous, cancellable invoke.
+//!
+//! Requests run on the blocking pool of the shared wallet service runtime and
+//! complete through a C callback, so a single host thread can keep many
+//! requests in flight. Every accepted request gets exactly one callback: either
+//! its response or [`PIRATE_WALLET_SERVICE_CANCELLED`].
+
+use crate::handle::PIRATE_WALLET_SERVICE_OK;
+use pirate_wallet_service::WalletService;
+use std::collections::HashMap;
+use std::os::raw::{c_char, c_void};
+use std::slice;
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::Instant;
+use tokio::sync::Notify;
+
+/// The request was cancelled before it produced a response.
+pub const PIRATE_WALLET_SERVICE_CANCELLED: i32 = -3;
+
+/// Completion callback (`pirate_wallet_service_callback_t` in C).
+///
+/// `response` points to `response_len` bytes of UTF-8 JSON and is only valid
+/// for the duration of the callback. It is null when `status` is
+/// [`PIRATE_WALLET_SERVICE_CANCELLED`]. The callback runs on a runtime thread,
+/// never on the thread that issued the request.
+pub type PirateWalletServiceCallback = Option<
+    unsafe extern "C" fn(
+        request_id: u64,
+        status: i32,
+        response: *const c_char,
+        response_len: usize,
+        user_data: *mut c_void,
+    ),
+>;
+
+struct Completion {
+    callback: unsafe extern "C" fn(u64, i32, *const c_char, usize, *mut c_void),
+    user_data: *mut c_void,
+}
+
+// The host guarantees `user_data` may be handed to the callback from any
+// thread; we never dereference it ourselves.
+unsafe impl Send for Completion {}
+unsafe impl Sync for Completion {}
+
+struct InflightRequest {
+    completion: Completion,
+    delivered: AtomicBool,
+    cancel: Notify,
+}
+
+impl InflightRequest {
+    /// Claim the right to deliver this request's one and only callback.
+    fn claim(&self) -> bool {
+        !self.delivered.swap(true, Ordering::AcqRel)
+    }
+
+    fn deliver(&self, request_id: u64, status: i32, response: *const c_char, response_len: usize) {
+        unsafe {
+            (self.completion.callback)(
+                request_id,
+                status,
+                response,
+                response_len,
+                self.completion.user_data,
+            );
+        }
+    }
+}
+
+static NEXT_REQUEST_ID: AtomicU64 = AtomicU64::new(1);
+
+fn inflight() -> &'static Mutex<HashMap<u64, Arc<InflightRequest>>> {
+    static INFLIGHT: OnceLock<Mutex<HashMap<u64, Arc<InflightRequest>>>> = OnceLock::new();
+    INFLIGHT.get_or_init(|| Mutex::new(HashMap::new()))
+}
+
+fn take_inflight(request_id: u64) -> Option<Arc<InflightRequest>> {
+    inflight()
+        .lock()
+        .unwrap_or_else(|err| err.into_inner())
+        .remove(&request_id)
+}
+
+#[unsafe(no_mangle)]
+/// Start a JSON request without blocking the caller.
+///
+/// Returns a non-zero request id, or `0` if an argument was invalid (in which
+/// case the callback is never invoked).
+///
+/// # Safety
+///
+/// `request_json` must point to `request_len` readable bytes of UTF-8 JSON for
+/// the duration of this call; the bytes are copied before it returns.
+/// `callback` must remain callable, and `user_data` valid, until the callback
+/// for this request has run.
+pub unsafe extern "C" fn pirate_wallet_service_invoke_async(
+    request_json: *const c_char,
+    request_len: usize,
+    pretty: bool,
+    callback: PirateWalletServiceCallback,
+    user_data: *mut c_void,
+) -> u64 {
+    let Some(callback) = callback else {
+        return 0;
+    };
+    if request_json.is_null() && request_len > 0 {
+        return 0;
+    }
+    let request = if request_len == 0 {
+        Vec::new()
+    } else {
+        unsafe { slice::from_raw_parts(request_json.cast::<u8>(), request_len) }.to_vec()
+    };
+
+    let request_id = NEXT_REQUEST_ID.fetch_add(1, Ordering::Relaxed);
+    let entry = Arc::new(InflightRequest {
+        completion: Completion {
+            callback,
+            user_data,
+        },
+        delivered: AtomicBool::new(false),
+        cancel: Notify::new(),
+    });
+    inflight()
+        .lock()
+        .unwrap_or_else(|err| err.into_inner())
+        .insert(request_id, Arc::clone(&entry));
+
+    let submitted = Instant::now();
+    WalletService::runtime().spawn_blocking(move || {
+        if entry.delivered.load(Ordering::Acquire) {
+            // Cancelled before a blocking thread picked it up.
+            return;
+        }
+        let mut out = Vec::new();
+        let finished = WalletService::new().execute_json_until(
+            &request,
+            pretty,
+            &mut out,
+            submitted,
+            entry.cancel.notified(),
+        );
+        take_inflight(request_id);
+        if finished && entry.claim() {
+            entry.deliver(request_id, PIRATE_WALLET_SERVICE_OK, out.as_ptr().cast(), out.len());
+        }
+    });
+
+    request_id
+}
+
+#[unsafe(no_mangle)]
+/// Cancel a request started with [`pirate_wallet_service_invoke_async`].
+///
+/// Returns `true` if the request was still pending. Its callback is then
+/// invoked with [`PIRATE_WALLET_SERVICE_CANCELLED`] and any late result is
+/// discarded. Returns `false` for unknown ids and for requests whose response
+/// callback has already been claimed.
+pub extern "C" fn pirate_wallet_service_cancel(request_id: u64) -> bool {
+    let Some(entry) = take_inflight(request_id) else {
+        return false;
+    };
+    if !entry.claim() {
+        return false;
+    }
+    entry.cancel.notify_one();
+
+    // Deliver off the caller's thread so hosts never see the callback
+    // re-entrantly from inside `cancel`.
+    WalletService::runtime().spawn_blocking(move || {
+        entry.deliver(request_id, PIRATE_WALLET_SERVICE_CANCELLED, std::ptr::null(), 0);
+    });
+    true
+}
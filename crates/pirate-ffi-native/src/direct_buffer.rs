@@ -0,0 +1,166 @@
+//! `java.nio.ByteBuffer` entry points for the Android bridge.
+//!
+//! `invokeJson` decodes the request `String` from UTF-16 and builds a new
+//! `String` for the response: two full copies per call, and garbage for the
+//! collector proportional to the response. These entry points read the
+//! request straight out of a direct buffer the host fills with UTF-8 JSON or
+//! CBOR, and write the response into a second direct buffer the host keeps
+//! between calls. The response is built in a per-thread arena, so a host
+//! whose buffer was too small can grow it and copy the response out without
+//! running the request again. Responses can carry keys and balances, so the
+//! arena is wiped before each reuse and when its thread exits.
+
+use jni::objects::{JByteBuffer, JClass};
+use jni::sys::{jboolean, jint};
+use jni::JNIEnv;
+use pirate_wallet_service::WalletService;
+use std::cell::RefCell;
+use zeroize::Zeroize;
+
+/// `format` value for UTF-8 JSON requests and responses.
+pub const DIRECT_FORMAT_JSON: jint = 0;
+/// `format` value for the CBOR codec; see `pirate_wallet_service_invoke_cbor_arena`.
+pub const DIRECT_FORMAT_CBOR: jint = 1;
+
+/// Response of the last call on a thread, zeroed when the thread exits.
+#[derive(Default)]
+struct ResponseArena(Vec<u8>);
+
+impl Drop for ResponseArena {
+    fn drop(&mut self) {
+        self.0.zeroize();
+    }
+}
+
+thread_local! {
+    /// Response of the last call on this thread. Its allocation is reused.
+    static LAST_RESPONSE: RefCell<ResponseArena> = RefCell::new(ResponseArena::default());
+}
+
+/// Address and capacity of a direct buffer's native storage; a null address
+/// for an empty buffer.
+fn direct_region(env: &JNIEnv, buffer: &JByteBuffer) -> jni::errors::Result<(*mut u8, usize)> {
+    let capacity = env.get_direct_buffer_capacity(buffer)?;
+    if capacity == 0 {
+        return Ok((std::ptr::null_mut(), 0));
+    }
+    Ok((env.get_direct_buffer_address(buffer)?, capacity))
+}
+
+fn regions_overlap((a, a_len): (*mut u8, usize), (b, b_len): (*mut u8, usize)) -> bool {
+    let (a, b) = (a as usize, b as usize);
+    a_len > 0 && b_len > 0 && a < b.saturating_add(b_len) && b < a.saturating_add(a_len)
+}
+
+/// Copy `response` into `buffer`. Returns its length, or minus the length
+/// when the buffer is too small.
+fn copy_response(env: &JNIEnv, buffer: &JByteBuffer, response: &[u8]) -> jni::errors::Result<jint> {
+    let len = jint::try_from(response.len()).unwrap_or(jint::MAX);
+    let (address, capacity) = direct_region(env, buffer)?;
+    if response.len() > capacity {
+        return Ok(-len);
+    }
+    if !response.is_empty() {
+        // SAFETY: the region is the buffer's native storage, valid for the
+        // JNI call, and no other slice of it is alive here.
+        let target = unsafe { std::slice::from_raw_parts_mut(address, response.len()) };
+        target.copy_from_slice(response);
+    }
+    Ok(len)
+}
+
+fn throw_illegal_argument(env: &mut JNIEnv, message: &str) -> jint {
+    let _ = env.throw_new("java/lang/IllegalArgumentException", message);
+    0
+}
+
+fn invoke_direct(
+    mut env: JNIEnv,
+    request: JByteBuffer,
+    request_len: jint,
+    response: JByteBuffer,
+    format: jint,
+    pretty: jboolean,
+) -> jint {
+    if format != DIRECT_FORMAT_JSON && format != DIRECT_FORMAT_CBOR {
+        return throw_illegal_argument(&mut env, "unknown request format");
+    }
+    let Ok((request_address, request_capacity)) = direct_region(&env, &request) else {
+        return throw_illegal_argument(&mut env, "request must be a direct ByteBuffer");
+    };
+    let Some(request_len) = usize::try_from(request_len)
+        .ok()
+        .filter(|&len| len <= request_capacity)
+    else {
+        return throw_illegal_argument(&mut env, "requestLen exceeds the request buffer");
+    };
+    // The response is written while the request is still borrowed.
+    match direct_region(&env, &response) {
+        Ok(response_region) if regions_overlap((request_address, request_len), response_region) => {
+            return throw_illegal_argument(&mut env, "request and response buffers overlap");
+        }
+        Ok(_) => {}
+        Err(_) => return throw_illegal_argument(&mut env, "response must be a direct ByteBuffer"),
+    }
+    let request_bytes: &[u8] = if request_len == 0 {
+        &[]
+    } else {
+        // SAFETY: the region is the request buffer's native storage, valid
+        // for this JNI call, and the response region does not overlap it.
+        unsafe { std::slice::from_raw_parts(request_address, request_len) }
+    };
+
+    LAST_RESPONSE.with(|last| {
+        let mut last = last.borrow_mut();
+        let out = &mut last.0;
+        out.zeroize();
+        let service = WalletService::new();
+        if format == DIRECT_FORMAT_CBOR {
+            service.execute_cbor_into(request_bytes, out);
+        } else {
+            service.execute_json_into(request_bytes, pretty != 0, out);
+        }
+        match copy_response(&env, &response, out) {
+            Ok(len) => len,
+            Err(_) => throw_illegal_argument(&mut env, "response must be a direct ByteBuffer"),
+        }
+    })
+}
+
+fn copy_last_response(mut env: JNIEnv, response: JByteBuffer) -> jint {
+    LAST_RESPONSE.with(
+        |last| match copy_response(&env, &response, &last.borrow().0) {
+            Ok(len) => len,
+            Err(_) => throw_illegal_argument(&mut env, "response must be a direct ByteBuffer"),
+        },
+    )
+}
+
+/// Run the request held in the first `requestLen` bytes of `request` and
+/// write the response envelope into `response`, both direct buffers. Returns
+/// the response length. When `response` is too small the result is minus the
+/// required length; grow the buffer and call `copyLastResponse` on the same
+/// thread instead of running the request again.
+#[unsafe(no_mangle)]
+pub extern "system" fn Java_com_pirate_wallet_reactnative_NativeBridge_invokeDirect(
+    env: JNIEnv,
+    _class: JClass,
+    request: JByteBuffer,
+    request_len: jint,
+    response: JByteBuffer,
+    format: jint,
+    pretty: jboolean,
+) -> jint {
+    invoke_direct(env, request, request_len, response, format, pretty)
+}
+
+/// Copy the last response produced on this thread into `response`, with the
+/// same return convention as `invokeDirect`.
+#[unsafe(no_mangle)]
+pub extern "system" fn Java_com_pirate_wallet_reactnative_NativeBridge_copyLastResponse(
+    env: JNIEnv,
+    _class: JClass,
+    response: JByteBuffer,
+) -> jint {
+    copy_last_response(env, response)
+}
@@ -0,0 +1,221 @@
+//! Push-based wallet events.
+//!
+//! A subscription delivers coalesced deltas (height advanced, new notes,
+//! balance changed, new transactions) through a C callback, so hosts no longer
+//! poll `sync_status` through `invoke_json` and re-parse the full status.
+
+use pirate_wallet_service::streams::{
+    wallet_event_stream, WalletEventDelta, WALLET_EVENT_BALANCE, WALLET_EVENT_HEIGHT,
+    WALLET_EVENT_NEW_TX, WALLET_EVENT_NOTES,
+};
+use pirate_wallet_service::WalletService;
+use std::cell::Cell;
+use std::collections::HashMap;
+use std::ffi::CStr;
+use std::os::raw::{c_char, c_void};
+use std::sync::atomic::{AtomicBool, AtomicU64, Ordering};
+use std::sync::{Arc, Mutex, OnceLock};
+use std::time::Duration;
+use tokio::sync::Notify;
+
+/// `changed` bit: `local_height` or `target_height` moved.
+pub const PIRATE_WALLET_EVENT_HEIGHT: u32 = WALLET_EVENT_HEIGHT;
+/// `changed` bit: `notes_decrypted` grew.
+pub const PIRATE_WALLET_EVENT_NOTES: u32 = WALLET_EVENT_NOTES;
+/// `changed` bit: one of the balance fields moved.
+pub const PIRATE_WALLET_EVENT_BALANCE: u32 = WALLET_EVENT_BALANCE;
+/// `changed` bit: `new_tx_count` transactions were discovered.
+pub const PIRATE_WALLET_EVENT_NEW_TX: u32 = WALLET_EVENT_NEW_TX;
+
+/// Coalescing interval used when the host passes `0`.
+const DEFAULT_INTERVAL_MS: u32 = 250;
+/// Lower bound on the coalescing interval.
+const MIN_INTERVAL_MS: u32 = 50;
+
+/// Wallet change notification (`pirate_wallet_event_t` in C).
+///
+/// Every field holds the current value; `changed` flags the ones that moved
+/// since the previous event. The first event of a subscription has the
+/// height, notes and balance bits set.
+#[repr(C)]
+#[derive(Debug, Clone, Copy)]
+pub struct PirateWalletEvent {
+    pub changed: u32,
+    pub new_tx_count: u32,
+    pub local_height: u64,
+    pub target_height: u64,
+    pub notes_decrypted: u64,
+    pub balance_total: u64,
+    pub balance_spendable: u64,
+    pub balance_pending: u64,
+}
+
+impl From<WalletEventDelta> for PirateWalletEvent {
+    fn from(delta: WalletEventDelta) -> Self {
+        Self {
+            changed: delta.changed,
+            new_tx_count: delta.new_tx_count,
+            local_height: delta.local_height,
+            target_height: delta.target_height,
+            notes_decrypted: delta.notes_decrypted,
+            balance_total: delta.balance_total,
+            balance_spendable: delta.balance_spendable,
+            balance_pending: delta.balance_pending,
+        }
+    }
+}
+
+/// Event callback (`pirate_wallet_event_callback_t` in C).
+///
+/// `event` is only valid for the duration of the callback. Callbacks for one
+/// subscription never overlap and run on a runtime thread.
+pub type PirateWalletEventCallback = Option<
+    unsafe extern "C" fn(
+        subscription_id: u64,
+        event: *const PirateWalletEvent,
+        user_data: *mut c_void,
+    ),
+>;
+
+struct Subscription {
+    callback: unsafe extern "C" fn(u64, *const PirateWalletEvent, *mut c_void),
+    user_data: *mut c_void,
+    active: AtomicBool,
+    /// Held while the callback runs so unsubscribe can wait for it.
+    delivering: Mutex<()>,
+    /// Wakes the delivery task so an idle subscription stops promptly.
+    stopped: Notify,
+}
+
+// The host guarantees `user_data` may be handed to the callback from any
+// thread; we never dereference it ourselves.
+unsafe impl Send for Subscription {}
+unsafe impl Sync for Subscription {}
+
+thread_local! {
+    /// Subscription whose callback is running on this thread, if any.
+    static DELIVERING: Cell<u64> = const { Cell::new(0) };
+}
+
+impl Subscription {
+    /// Returns false once the subscription has been cancelled.
+    fn deliver(&self, subscription_id: u64, event: &PirateWalletEvent) -> bool {
+        let _guard = self
+            .delivering
+            .lock()
+            .unwrap_or_else(|err| err.into_inner());
+        if !self.active.load(Ordering::Acquire) {
+            return false;
+        }
+        DELIVERING.with(|current| current.set(subscription_id));
+        unsafe {
+            (self.callback)(subscription_id, event, self.user_data);
+        }
+        DELIVERING.with(|current| current.set(0));
+        self.active.load(Ordering::Acquire)
+    }
+}
+
+static NEXT_SUBSCRIPTION_ID: AtomicU64 = AtomicU64::new(1);
+
+fn subscriptions() -> &'static Mutex<HashMap<u64, Arc<Subscription>>> {
+    static SUBSCRIPTIONS: OnceLock<Mutex<HashMap<u64, Arc<Subscription>>>> = OnceLock::new();
+    SUBSCRIPTIONS.get_or_init(|| Mutex::new(HashMap::new()))
+}
+
+fn take_subscription(subscription_id: u64) -> Option<Arc<Subscription>> {
+    subscriptions()
+        .lock()
+        .unwrap_or_else(|err| err.into_inner())
+        .remove(&subscription_id)
+}
+
+#[unsafe(no_mangle)]
+/// Subscribe to coalesced wallet events for `wallet_id`.
+///
+/// At most one event is delivered per `interval_ms` (`0` selects 250 ms;
+/// values below 50 ms are raised to 50 ms), and only when something changed.
+/// Returns a non-zero subscription id, or `0` if an argument was invalid.
+///
+/// # Safety
+///
+/// `wallet_id` must be a valid NUL-terminated UTF-8 string for the duration of
+/// this call. `callback` must remain callable, and `user_data` valid, until
+/// [`pirate_wallet_service_unsubscribe`] has returned for this subscription.
+pub unsafe extern "C" fn pirate_wallet_service_subscribe(
+    wallet_id: *const c_char,
+    interval_ms: u32,
+    callback: PirateWalletEventCallback,
+    user_data: *mut c_void,
+) -> u64 {
+    let Some(callback) = callback else {
+        return 0;
+    };
+    if wallet_id.is_null() {
+        return 0;
+    }
+    let Ok(wallet_id) = unsafe { CStr::from_ptr(wallet_id) }.to_str() else {
+        return 0;
+    };
+    let wallet_id = wallet_id.to_owned();
+    let interval_ms = match interval_ms {
+        0 => DEFAULT_INTERVAL_MS,
+        ms => ms.max(MIN_INTERVAL_MS),
+    };
+
+    let subscription_id = NEXT_SUBSCRIPTION_ID.fetch_add(1, Ordering::Relaxed);
+    let subscription = Arc::new(Subscription {
+        callback,
+        user_data,
+        active: AtomicBool::new(true),
+        delivering: Mutex::new(()),
+        stopped: Notify::new(),
+    });
+    subscriptions()
+        .lock()
+        .unwrap_or_else(|err| err.into_inner())
+        .insert(subscription_id, Arc::clone(&subscription));
+
+    WalletService::runtime().spawn(async move {
+        let interval = Duration::from_millis(u64::from(interval_ms));
+        let mut events = wallet_event_stream(wallet_id, interval).await;
+        loop {
+            let delta = tokio::select! {
+                _ = subscription.stopped.notified() => break,
+                delta = events.recv() => delta,
+            };
+            let Some(delta) = delta else {
+                break;
+            };
+            if !subscription.deliver(subscription_id, &PirateWalletEvent::from(delta)) {
+                break;
+            }
+        }
+    });
+
+    subscription_id
+}
+
+#[unsafe(no_mangle)]
+/// Stop a subscription started with [`pirate_wallet_service_subscribe`].
+///
+/// When called outside the subscription's own callback, this waits for a
+/// callback that is already running, so no callback runs after it returns.
+/// Calling it from inside the callback is allowed. Returns `false` for
+/// unknown ids.
+pub extern "C" fn pirate_wallet_service_unsubscribe(subscription_id: u64) -> bool {
+    let Some(subscription) = take_subscription(subscription_id) else {
+        return false;
+    };
+    subscription.active.store(false, Ordering::Release);
+    subscription.stopped.notify_one();
+    if DELIVERING.with(|current| current.get()) != subscription_id {
+        drop(
+            subscription
+                .delivering
+                .lock()
+                .unwrap_or_else(|err| err.into_inner()),
+        );
+    }
+    true
+}
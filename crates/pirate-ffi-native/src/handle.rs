@@ -0,0 +1,285 @@
+//! Handle-based entry points.
+//!
+//! A host creates one `pirate_wallet_service_t` and passes it to every call.
+//! The handle owns a response arena that is reused across calls, so hot
+//! polling paths (`get_balance`, `list_transactions`) do not allocate a new
+//! `CString` per response and hosts get an explicit length instead of running
+//! `strlen` over the result.
+
+use pirate_wallet_service::WalletService;
+use std::os::raw::c_char;
+use std::slice;
+use std::sync::Mutex;
+
+/// The call completed and the response is available.
+pub const PIRATE_WALLET_SERVICE_OK: i32 = 0;
+/// A required pointer argument was null.
+pub const PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT: i32 = -1;
+/// The caller-provided buffer cannot hold the response. The required length is
+/// written to `response_len_out` and the response is kept in the handle arena.
+pub const PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL: i32 = -2;
+
+/// Opaque service context exported to C as `pirate_wallet_service_t`.
+pub struct PirateWalletServiceHandle {
+    service: WalletService,
+    arena: Mutex<Vec<u8>>,
+}
+
+impl PirateWalletServiceHandle {
+    fn new() -> Self {
+        Self {
+            service: WalletService::new(),
+            arena: Mutex::new(Vec::new()),
+        }
+    }
+
+    /// Run `request_json` and leave the NUL-terminated response in the arena.
+    /// Returns the arena pointer and the response length (without the NUL).
+    fn invoke_into_arena(&self, request_json: &[u8], pretty: bool) -> (*const u8, usize) {
+        self.respond_into_arena(|service, arena| {
+            service.execute_json_into(request_json, pretty, arena)
+        })
+    }
+
+    fn respond_into_arena(
+        &self,
+        respond: impl FnOnce(&WalletService, &mut Vec<u8>),
+    ) -> (*const u8, usize) {
+        let mut arena = self.arena.lock().unwrap_or_else(|err| err.into_inner());
+        respond(&self.service, &mut arena);
+        let len = arena.len();
+        arena.push(0);
+        (arena.as_ptr(), len)
+    }
+
+    fn last_response(&self) -> (*const u8, usize) {
+        let arena = self.arena.lock().unwrap_or_else(|err| err.into_inner());
+        match arena.len() {
+            0 => (std::ptr::null(), 0),
+            len => (arena.as_ptr(), len - 1),
+        }
+    }
+}
+
+/// # Safety
+///
+/// `ptr`/`len` must describe a readable byte range for the duration of the
+/// call. A null `ptr` is only accepted together with `len == 0`.
+unsafe fn request_bytes<'a>(ptr: *const c_char, len: usize) -> Option<&'a [u8]> {
+    if ptr.is_null() {
+        return (len == 0).then_some(&[][..]);
+    }
+    Some(unsafe { slice::from_raw_parts(ptr.cast::<u8>(), len) })
+}
+
+#[unsafe(no_mangle)]
+/// Create a service context. Free it with [`pirate_wallet_service_free`].
+pub extern "C" fn pirate_wallet_service_new() -> *mut PirateWalletServiceHandle {
+    Box::into_raw(Box::new(PirateWalletServiceHandle::new()))
+}
+
+#[unsafe(no_mangle)]
+/// # Safety
+///
+/// `service` must be null or a pointer returned by
+/// [`pirate_wallet_service_new`] that has not been freed yet. Any response
+/// pointer obtained from this handle is invalid after this call.
+pub unsafe extern "C" fn pirate_wallet_service_free(service: *mut PirateWalletServiceHandle) {
+    if service.is_null() {
+        return;
+    }
+
+    unsafe {
+        drop(Box::from_raw(service));
+    }
+}
+
+#[unsafe(no_mangle)]
+/// Execute a JSON request and return a pointer to the response held in the
+/// handle arena.
+///
+/// The response is NUL-terminated for convenience, but `response_len_out`
+/// holds its length so hosts can decode it without scanning. It stays valid
+/// until the next invoke on the same handle or until the handle is freed.
+///
+/// # Safety
+///
+/// `service` must be a live handle from [`pirate_wallet_service_new`].
+/// `request_json` must point to `request_len` readable bytes of UTF-8 JSON.
+/// `response_out` and `response_len_out` must be writable. Hosts sharing one
+/// handle between threads must serialize calls on it.
+pub unsafe extern "C" fn pirate_wallet_service_invoke_json_arena(
+    service: *mut PirateWalletServiceHandle,
+    request_json: *const c_char,
+    request_len: usize,
+    pretty: bool,
+    response_out: *mut *const c_char,
+    response_len_out: *mut usize,
+) -> i32 {
+    if service.is_null() || response_out.is_null() || response_len_out.is_null() {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    let Some(request) = (unsafe { request_bytes(request_json, request_len) }) else {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    };
+
+    let service = unsafe { &*service };
+    let (ptr, len) = service.invoke_into_arena(request, pretty);
+    unsafe {
+        *response_out = ptr.cast();
+        *response_len_out = len;
+    }
+    PIRATE_WALLET_SERVICE_OK
+}
+
+#[unsafe(no_mangle)]
+/// Execute a JSON request and copy the response into a caller-owned buffer.
+///
+/// The response is not NUL-terminated; its length is written to
+/// `response_len_out`. When `buffer_len` is too small this returns
+/// [`PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL`] with the required length, and
+/// the response can still be read through
+/// [`pirate_wallet_service_last_response`] without re-running the request.
+///
+/// # Safety
+///
+/// `service` must be a live handle from [`pirate_wallet_service_new`].
+/// `request_json` must point to `request_len` readable bytes of UTF-8 JSON.
+/// `buffer` must point to `buffer_len` writable bytes (it may be null when
+/// `buffer_len` is zero). `response_len_out` must be writable.
+pub unsafe extern "C" fn pirate_wallet_service_invoke_json_buffer(
+    service: *mut PirateWalletServiceHandle,
+    request_json: *const c_char,
+    request_len: usize,
+    pretty: bool,
+    buffer: *mut u8,
+    buffer_len: usize,
+    response_len_out: *mut usize,
+) -> i32 {
+    if service.is_null() || response_len_out.is_null() || (buffer.is_null() && buffer_len > 0) {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    let Some(request) = (unsafe { request_bytes(request_json, request_len) }) else {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    };
+
+    let service = unsafe { &*service };
+    let (ptr, len) = service.invoke_into_arena(request, pretty);
+    unsafe {
+        *response_len_out = len;
+    }
+    if len > buffer_len {
+        return PIRATE_WALLET_SERVICE_ERR_BUFFER_TOO_SMALL;
+    }
+    unsafe {
+        std::ptr::copy_nonoverlapping(ptr, buffer, len);
+    }
+    PIRATE_WALLET_SERVICE_OK
+}
+
+#[unsafe(no_mangle)]
+/// Execute a JSON array of requests in one call and return a JSON array of
+/// response envelopes, in request order, held in the handle arena.
+///
+/// Consecutive read-only requests run concurrently and share wallet database
+/// handles; other requests run in order between them. The response pointer
+/// has the same lifetime as one returned by
+/// [`pirate_wallet_service_invoke_json_arena`].
+///
+/// # Safety
+///
+/// Same requirements as [`pirate_wallet_service_invoke_json_arena`], with
+/// `requests_json` holding a JSON array.
+pub unsafe extern "C" fn pirate_wallet_service_invoke_batch_json_arena(
+    service: *mut PirateWalletServiceHandle,
+    requests_json: *const c_char,
+    requests_len: usize,
+    pretty: bool,
+    response_out: *mut *const c_char,
+    response_len_out: *mut usize,
+) -> i32 {
+    if service.is_null() || response_out.is_null() || response_len_out.is_null() {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    let Some(requests) = (unsafe { request_bytes(requests_json, requests_len) }) else {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    };
+
+    let service = unsafe { &*service };
+    let (ptr, len) = service.respond_into_arena(|service, arena| {
+        service.execute_json_batch_into(requests, pretty, arena)
+    });
+    unsafe {
+        *response_out = ptr.cast();
+        *response_len_out = len;
+    }
+    PIRATE_WALLET_SERVICE_OK
+}
+
+#[unsafe(no_mangle)]
+/// Execute a CBOR-encoded request and return the CBOR response envelope held
+/// in the handle arena.
+///
+/// The request schema and envelope match the JSON entry points; `txid`,
+/// `memo_hex` and raw transaction bytes are CBOR byte strings instead of hex
+/// or number arrays. The response is binary, so use `response_len_out` rather
+/// than a terminator. It has the same lifetime as a response from
+/// [`pirate_wallet_service_invoke_json_arena`].
+///
+/// # Safety
+///
+/// `service` must be a live handle from [`pirate_wallet_service_new`].
+/// `request` must point to `request_len` readable bytes. `response_out` and
+/// `response_len_out` must be writable.
+pub unsafe extern "C" fn pirate_wallet_service_invoke_cbor_arena(
+    service: *mut PirateWalletServiceHandle,
+    request: *const u8,
+    request_len: usize,
+    response_out: *mut *const u8,
+    response_len_out: *mut usize,
+) -> i32 {
+    if service.is_null() || response_out.is_null() || response_len_out.is_null() {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+    let Some(request) = (unsafe { request_bytes(request.cast(), request_len) }) else {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    };
+
+    let service = unsafe { &*service };
+    let (ptr, len) =
+        service.respond_into_arena(|service, arena| service.execute_cbor_into(request, arena));
+    unsafe {
+        *response_out = ptr;
+        *response_len_out = len;
+    }
+    PIRATE_WALLET_SERVICE_OK
+}
+
+#[unsafe(no_mangle)]
+/// Return the most recent response held in the handle arena.
+///
+/// `response_out` is set to null when the handle has not produced a response
+/// yet. The pointer has the same lifetime as one returned by
+/// [`pirate_wallet_service_invoke_json_arena`].
+///
+/// # Safety
+///
+/// `service` must be a live handle from [`pirate_wallet_service_new`].
+/// `response_out` and `response_len_out` must be writable.
+pub unsafe extern "C" fn pirate_wallet_service_last_response(
+    service: *const PirateWalletServiceHandle,
+    response_out: *mut *const c_char,
+    response_len_out: *mut usize,
+) -> i32 {
+    if service.is_null() || response_out.is_null() || response_len_out.is_null() {
+        return PIRATE_WALLET_SERVICE_ERR_NULL_ARGUMENT;
+    }
+
+    let service = unsafe { &*service };
+    let (ptr, len) = service.last_response();
+    unsafe {
+        *response_out = ptr.cast();
+        *response_len_out = len;
+    }
+    PIRATE_WALLET_SERVICE_OK
+}
@@ -1,3 +1,17 @@
+mod async_invoke;
+#[cfg(target_os = "android")]
+mod direct_buffer;
+mod events;
+mod handle;
+mod runtime;
+
+pub use async_invoke::*;
+#[cfg(target_os = "android")]
+pub use direct_buffer::*;
+pub use events::*;
+pub use handle::*;
+pub use runtime::*;
+
 use pirate_wallet_service::WalletService;
 use std::ffi::{CStr, CString};
 use std::os::raw::c_char;
@@ -63,6 +77,21 @@ pub unsafe extern "C" fn pirate_wallet_service_invoke_json(
     owned_json_ptr(service.execute_json(request, pretty))
 }
 
+#[unsafe(no_mangle)]
+/// Per-method call counts and latency histograms (parse, queue wait,
+/// execution, serialization) for every request served so far, as JSON.
+/// Free the result with [`pirate_wallet_service_free_string`].
+pub extern "C" fn pirate_wallet_service_stats_json() -> *mut c_char {
+    owned_json_ptr(pirate_wallet_service::stats_json().to_string())
+}
+
+#[unsafe(no_mangle)]
+/// Zero the counters behind [`pirate_wallet_service_stats_json`], e.g. before
+/// measuring one screen.
+pub extern "C" fn pirate_wallet_service_stats_reset() {
+    pirate_wallet_service::reset_stats();
+}
+
 #[cfg(target_os = "android")]
 fn invoke_json_from_jni(mut env: JNIEnv, request_json: JString, pretty: jboolean) -> jstring {
     let request_json = match env.get_string(&request_json) {
@@ -0,0 +1,45 @@
+//! Runtime sizing entry point.
+//!
+//! Hosts that know the machine (core count, server vs phone) size the shared
+//! service runtime before their first request. Hosts that never call this get
+//! the default two-worker runtime.
+
+use pirate_wallet_service::{configure_runtime, RuntimeConfig};
+
+/// The runtime already started, or was configured with different values.
+pub const PIRATE_WALLET_SERVICE_ERR_RUNTIME_STARTED: i32 = -4;
+/// A size was out of range.
+pub const PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT: i32 = -5;
+
+/// Size the service runtime. Pass 0 to keep the default for a size.
+/// `cpu_affinity_mask` is a bit mask over CPUs 0..64 (0 for no hint); it is
+/// applied on Linux and Android only.
+///
+/// Must be called before the first request on any entry point.
+#[unsafe(no_mangle)]
+pub extern "C" fn pirate_wallet_service_init_runtime(
+    worker_threads: u32,
+    max_blocking_threads: u32,
+    cpu_affinity_mask: u64,
+) -> i32 {
+    let config = RuntimeConfig::from_abi(worker_threads, max_blocking_threads, cpu_affinity_mask);
+    if config.validate().is_err() {
+        return PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT;
+    }
+    match configure_runtime(config) {
+        Ok(()) => crate::PIRATE_WALLET_SERVICE_OK,
+        Err(_) => PIRATE_WALLET_SERVICE_ERR_RUNTIME_STARTED,
+    }
+}
+
+/// Cap sync batches, block cache reads and proving to `budget_bytes` of
+/// memory, for low-RAM devices. Pass 0 to remove the budget. Budgets below
+/// 128 MB are rejected. Unlike the runtime sizes this may be called at any
+/// time, for example on a memory warning.
+#[unsafe(no_mangle)]
+pub extern "C" fn pirate_wallet_service_set_memory_budget(budget_bytes: u64) -> i32 {
+    match pirate_wallet_service::set_memory_budget((budget_bytes > 0).then_some(budget_bytes)) {
+        Ok(()) => crate::PIRATE_WALLET_SERVICE_OK,
+        Err(_) => PIRATE_WALLET_SERVICE_ERR_INVALID_ARGUMENT,
+    }
+}
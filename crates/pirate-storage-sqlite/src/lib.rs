@@ -31,6 +31,7 @@ pub mod migrations;
 pub mod models;
 /// In-memory app passphrase storage.
 pub mod passphrase_store;
+pub mod pool;
 pub mod repository;
 pub mod scan_queue;
 pub mod screenshot_guard;
@@ -63,6 +64,7 @@ pub use keystore::{
 };
 pub use models::*;
 pub use passphrase_store::{clear_passphrase, get_passphrase, is_passphrase_set, set_passphrase};
+pub use pool::{Lease, PoolStats, PooledDatabase};
 pub use repository::Repository;
 pub use scan_queue::{
     ScanQueueStorage, ScanRangeRow, SCAN_PRIORITY_FOUND_NOTE, SCAN_PRIORITY_HISTORIC,
@@ -0,0 +1,391 @@
+//! Process-wide pool of opened wallet databases.
+//!
+//! Every `Database::open_existing` runs the SQLCipher key schedule, switches
+//! the journal to WAL and reads the schema back before the first query, and
+//! closing the handle throws away its prepared-statement cache. Sync and the
+//! service layer used to pay that on almost every call. The pool keeps opened
+//! handles per database file and key and lends them out through
+//! [`PooledDatabase`]; statements prepared with `prepare_cached` survive
+//! between borrowers.
+//!
+//! SQLite in WAL mode already runs readers alongside the single writer the
+//! file lock allows, so the pool does not separate the two: it bounds how
+//! many handles stay open per file and briefly waits for one to come back
+//! before opening past that bound.
+
+use crate::{encryption::EncryptionKey, security::MasterKey, Database, Result};
+use parking_lot::{Condvar, Mutex};
+use serde::Serialize;
+use sha2::{Digest, Sha256};
+use std::collections::HashMap;
+use std::ops::{Deref, DerefMut};
+use std::path::{Path, PathBuf};
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
+
+/// Handles kept open per database file. Sync holds one for a whole run and
+/// borrows a couple more for note persistence and status reads.
+pub const MAX_POOLED_PER_DATABASE: usize = 4;
+
+/// How long a checkout waits for a busy pool before opening an extra handle.
+/// Short on purpose: a caller may already hold a handle from the same pool.
+const CHECKOUT_WAIT: Duration = Duration::from_millis(25);
+
+/// Statements cached per pooled connection (rusqlite defaults to 16).
+const STATEMENT_CACHE_CAPACITY: usize = 64;
+
+#[derive(Clone, PartialEq, Eq, Hash)]
+struct PoolKey {
+    path: PathBuf,
+    /// Digest of both keys, so a handle is never lent under other keys.
+    key_tag: [u8; 32],
+}
+
+impl PoolKey {
+    fn new(path: &Path, key: &EncryptionKey, master_key: &MasterKey) -> Self {
+        let mut hasher = Sha256::new();
+        hasher.update(b"pirate-db-pool");
+        hasher.update(key.as_bytes());
+        hasher.update(master_key.as_bytes());
+        Self {
+            path: path.to_path_buf(),
+            key_tag: hasher.finalize().into(),
+        }
+    }
+}
+
+#[derive(Default)]
+struct Slot {
+    idle: Vec<Database>,
+    lent: usize,
+}
+
+#[derive(Default)]
+struct PoolState {
+    slots: HashMap<PoolKey, Slot>,
+    /// Bumped by `clear`; handles lent out before that are closed on return.
+    generation: u64,
+    stats: PoolStats,
+}
+
+struct Pool {
+    state: Mutex<PoolState>,
+    returned: Condvar,
+}
+
+fn pool() -> &'static Pool {
+    static POOL: OnceLock<Pool> = OnceLock::new();
+    POOL.get_or_init(|| Pool {
+        state: Mutex::new(PoolState::default()),
+        returned: Condvar::new(),
+    })
+}
+
+/// Pool counters since start or the last [`reset_stats`].
+#[derive(Debug, Clone, Copy, Default, Serialize)]
+pub struct PoolStats {
+    /// Checkouts served by an idle handle.
+    pub hits: u64,
+    /// Checkouts that opened a new handle.
+    pub misses: u64,
+    /// Checkouts that found every handle lent out and waited.
+    pub waits: u64,
+    /// Waits that ended without a handle coming back.
+    pub wait_timeouts: u64,
+    /// Total time spent waiting, in microseconds.
+    pub wait_us_total: u64,
+    /// Longest single wait, in microseconds.
+    pub wait_us_max: u64,
+    /// Returned handles closed because the pool was full or cleared.
+    pub closed_on_return: u64,
+    /// Handles currently idle in the pool.
+    pub idle: usize,
+    /// Handles currently lent out.
+    pub in_use: usize,
+}
+
+/// A database handle borrowed from the pool. Derefs to [`Database`] and goes
+/// back to the pool when dropped.
+pub struct PooledDatabase {
+    db: Option<Database>,
+    lease: Option<Lease>,
+}
+
+impl PooledDatabase {
+    /// Split into the handle and its lease, for callers that share the handle
+    /// through `Rc`. Hand it back with [`Lease::release`]; dropping the lease
+    /// alone just stops counting the handle as lent.
+    pub fn into_parts(mut self) -> (Database, Lease) {
+        let db = self.db.take().expect("pooled database present until drop");
+        let lease = self.lease.take().expect("pooled lease present until drop");
+        (db, lease)
+    }
+}
+
+impl Deref for PooledDatabase {
+    type Target = Database;
+
+    fn deref(&self) -> &Self::Target {
+        self.db
+            .as_ref()
+            .expect("pooled database present until drop")
+    }
+}
+
+impl DerefMut for PooledDatabase {
+    fn deref_mut(&mut self) -> &mut Self::Target {
+        self.db
+            .as_mut()
+            .expect("pooled database present until drop")
+    }
+}
+
+impl Drop for PooledDatabase {
+    fn drop(&mut self) {
+        if let (Some(db), Some(lease)) = (self.db.take(), self.lease.take()) {
+            lease.release(db);
+        }
+    }
+}
+
+/// Proof that a handle was lent by the pool.
+pub struct Lease {
+    key: PoolKey,
+    generation: u64,
+    returned: bool,
+}
+
+impl Lease {
+    /// Return `db`, which must be the handle this lease came with. It is kept
+    /// for the next borrower unless the pool is full or was cleared since.
+    pub fn release(mut self, db: Database) {
+        self.returned = true;
+        let pool = pool();
+        let closed = {
+            let mut state = pool.state.lock();
+            let current = state.generation == self.generation;
+            let keep = match state.slots.get_mut(&self.key) {
+                Some(slot) => {
+                    slot.lent = slot.lent.saturating_sub(1);
+                    current && slot.idle.len() < MAX_POOLED_PER_DATABASE
+                }
+                None => false,
+            };
+            if keep {
+                if let Some(slot) = state.slots.get_mut(&self.key) {
+                    slot.idle.push(db);
+                }
+                None
+            } else {
+                state.stats.closed_on_return += 1;
+                Some(db)
+            }
+        };
+        pool.returned.notify_one();
+        // Close outside the lock; SQLCipher may checkpoint the WAL here.
+        drop(closed);
+    }
+}
+
+impl Drop for Lease {
+    fn drop(&mut self) {
+        if self.returned {
+            return;
+        }
+        let pool = pool();
+        let mut state = pool.state.lock();
+        if let Some(slot) = state.slots.get_mut(&self.key) {
+            slot.lent = slot.lent.saturating_sub(1);
+        }
+        drop(state);
+        pool.returned.notify_one();
+    }
+}
+
+impl Database {
+    /// Borrow a handle to an existing encrypted database from the process-wide
+    /// pool, opening one with [`Database::open_existing`] when none is idle.
+    pub fn open_pooled<P: AsRef<Path>>(
+        path: P,
+        key: &EncryptionKey,
+        master_key: MasterKey,
+    ) -> Result<PooledDatabase> {
+        let path = path.as_ref();
+        let pool_key = PoolKey::new(path, key, &master_key);
+        let pool = pool();
+
+        let generation = {
+            let mut state = pool.state.lock();
+            let busy = state
+                .slots
+                .get(&pool_key)
+                .is_some_and(|slot| slot.idle.is_empty() && slot.lent >= MAX_POOLED_PER_DATABASE);
+            if busy {
+                let started = Instant::now();
+                let deadline = started + CHECKOUT_WAIT;
+                while state
+                    .slots
+                    .get(&pool_key)
+                    .is_some_and(|slot| slot.idle.is_empty())
+                {
+                    if pool.returned.wait_until(&mut state, deadline).timed_out() {
+                        state.stats.wait_timeouts += 1;
+                        break;
+                    }
+                }
+                let waited = u64::try_from(started.elapsed().as_micros()).unwrap_or(u64::MAX);
+                state.stats.waits += 1;
+                state.stats.wait_us_total = state.stats.wait_us_total.saturating_add(waited);
+                state.stats.wait_us_max = state.stats.wait_us_max.max(waited);
+            }
+
+            let state = &mut *state;
+            let generation = state.generation;
+            let slot = state.slots.entry(pool_key.clone()).or_default();
+            slot.lent += 1;
+            if let Some(db) = slot.idle.pop() {
+                state.stats.hits += 1;
+                return Ok(PooledDatabase {
+                    db: Some(db),
+                    lease: Some(Lease {
+                        key: pool_key,
+                        generation,
+                        returned: false,
+                    }),
+                });
+            }
+            state.stats.misses += 1;
+            generation
+        };
+
+        // The lease is taken before opening so a failed open gives back its
+        // place in the pool when dropped.
+        let lease = Lease {
+            key: pool_key,
+            generation,
+            returned: false,
+        };
+        let db = Database::open_existing(path, key, master_key)?;
+        db.conn()
+            .set_prepared_statement_cache_capacity(STATEMENT_CACHE_CAPACITY);
+        Ok(PooledDatabase {
+            db: Some(db),
+            lease: Some(lease),
+        })
+    }
+
+    /// Hand a handle that was opened directly (for example with
+    /// [`Database::open`], which also runs migrations) to the pool, so it is
+    /// kept for later [`Database::open_pooled`] calls with the same keys.
+    pub fn into_pooled<P: AsRef<Path>>(self, path: P, key: &EncryptionKey) -> PooledDatabase {
+        let pool_key = PoolKey::new(path.as_ref(), key, self.master_key());
+        let generation = {
+            let mut state = pool().state.lock();
+            let generation = state.generation;
+            state.slots.entry(pool_key.clone()).or_default().lent += 1;
+            generation
+        };
+        self.conn()
+            .set_prepared_statement_cache_capacity(STATEMENT_CACHE_CAPACITY);
+        PooledDatabase {
+            db: Some(self),
+            lease: Some(Lease {
+                key: pool_key,
+                generation,
+                returned: false,
+            }),
+        }
+    }
+}
+
+/// Close every idle handle. Handles still lent out are closed when they come
+/// back. Call when the session ends or keys change.
+pub fn clear() {
+    let closed: Vec<Database> = {
+        let mut state = pool().state.lock();
+        state.generation += 1;
+        state.slots.retain(|_, slot| slot.lent > 0);
+        state
+            .slots
+            .values_mut()
+            .flat_map(|slot| slot.idle.drain(..))
+            .collect()
+    };
+    pool().returned.notify_all();
+    drop(closed);
+}
+
+/// Close idle handles to the database at `path`, before the file is deleted
+/// or replaced.
+pub fn clear_path(path: &Path) {
+    let closed: Vec<Database> = {
+        let mut state = pool().state.lock();
+        state.generation += 1;
+        let mut closed = Vec::new();
+        state.slots.retain(|key, slot| {
+            if key.path != path {
+                return true;
+            }
+            closed.append(&mut slot.idle);
+            slot.lent > 0
+        });
+        closed
+    };
+    pool().returned.notify_all();
+    drop(closed);
+}
+
+/// Current pool counters.
+pub fn stats() -> PoolStats {
+    let state = pool().state.lock();
+    let mut stats = state.stats;
+    stats.idle = state.slots.values().map(|slot| slot.idle.len()).sum();
+    stats.in_use = state.slots.values().map(|slot| slot.lent).sum();
+    stats
+}
+
+/// Zero the counters; idle and in-use figures are live and not affected.
+pub fn reset_stats() {
+    pool().state.lock().stats = PoolStats::default();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+    use crate::security::EncryptionAlgorithm;
+    use tempfile::NamedTempFile;
+
+    #[test]
+    fn returned_handles_are_reused_for_the_same_keys_only() {
+        let file = NamedTempFile::new().unwrap();
+        let salt = crate::security::generate_salt();
+        let key = EncryptionKey::from_passphrase("pool-test", &salt).unwrap();
+        let master_key = MasterKey::generate(EncryptionAlgorithm::ChaCha20Poly1305);
+        Database::open(file.path(), &key, master_key.clone())
+            .unwrap()
+            .into_pooled(file.path(), &key);
+
+        let before = stats();
+        let first = Database::open_pooled(file.path(), &key, master_key.clone()).unwrap();
+        first
+            .conn()
+            .query_row("SELECT COUNT(*) FROM sqlite_master", [], |row| {
+                row.get::<_, i64>(0)
+            })
+            .unwrap();
+        let second = Database::open_pooled(file.path(), &key, master_key.clone()).unwrap();
+        drop(first);
+        drop(second);
+        let _third = Database::open_pooled(file.path(), &key, master_key).unwrap();
+        let after = stats();
+        // Other tests share the process-wide pool, so compare deltas.
+        assert!(after.hits >= before.hits + 2);
+
+        let other_master = MasterKey::generate(EncryptionAlgorithm::ChaCha20Poly1305);
+        let misses = stats().misses;
+        let _other = Database::open_pooled(file.path(), &key, other_master).unwrap();
+        assert!(stats().misses > misses);
+
+        clear_path(file.path());
+    }
+}
@@ -18,6 +18,16 @@ pub const BASE_BACKOFF_MS: u64 = 50;
 /// Maximum backoff duration in milliseconds
 pub const MAX_BACKOFF_MS: u64 = 1000;
 
+/// Written after every batch; prepared once per pooled connection.
+const SAVE_SYNC_STATE_SQL: &str = r#"
+    UPDATE sync_state SET
+        local_height = ?1,
+        target_height = ?2,
+        last_checkpoint_height = ?3,
+        updated_at = ?4
+    WHERE id = 1
+"#;
+
 /// Sync state record
 #[derive(Debug, Clone)]
 pub struct SyncStateRow {
@@ -79,22 +89,15 @@ impl<'a> SyncStateStorage<'a> {
         let updated_at = chrono::Utc::now().to_rfc3339();
 
         self.execute_with_retry(|| {
-            self.db.conn().execute(
-                r#"
-                UPDATE sync_state SET
-                    local_height = ?1,
-                    target_height = ?2,
-                    last_checkpoint_height = ?3,
-                    updated_at = ?4
-                WHERE id = 1
-                "#,
-                params![
+            self.db
+                .conn()
+                .prepare_cached(SAVE_SYNC_STATE_SQL)?
+                .execute(params![
                     local_height,
                     target_height,
                     last_checkpoint_height,
                     updated_at
-                ],
-            )?;
+                ])?;
             Ok(())
         })
     }
@@ -111,22 +114,12 @@ impl<'a> SyncStateStorage<'a> {
         let last_checkpoint_height = to_sql_i64(last_checkpoint_height)?;
         let updated_at = chrono::Utc::now().to_rfc3339();
 
-        tx.execute(
-            r#"
-            UPDATE sync_state SET
-                local_height = ?1,
-                target_height = ?2,
-                last_checkpoint_height = ?3,
-                updated_at = ?4
-            WHERE id = 1
-            "#,
-            params![
-                local_height,
-                target_height,
-                last_checkpoint_height,
-                updated_at
-            ],
-        )?;
+        tx.prepare_cached(SAVE_SYNC_STATE_SQL)?.execute(params![
+            local_height,
+            target_height,
+            last_checkpoint_height,
+            updated_at
+        ])?;
 
         Ok(())
     }
@@ -252,7 +245,7 @@ impl<'a> SyncStateStorage<'a> {
         }
 
         let updated_at = chrono::Utc::now().to_rfc3339();
-        let mut stmt = tx.prepare(
+        let mut stmt = tx.prepare_cached(
             r#"
             INSERT INTO chain_blocks (height, hash, prev_hash, time, updated_at)
             VALUES (?1, ?2, ?3, ?4, ?5)
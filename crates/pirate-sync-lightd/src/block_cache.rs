@@ -1,18 +1,28 @@
 //! Shared compact block cache for multi-wallet sync.
 
+use crate::block_pack::BlockPack;
 use crate::client::CompactBlockData;
 use crate::{Error, Result};
 use directories::ProjectDirs;
 use once_cell::sync::Lazy;
 use parking_lot::Mutex;
-use rusqlite::{params, Connection};
+use pirate_core::memory_budget::{self, MemoryConsumer};
+use rusqlite::{params, Connection, OpenFlags};
 use sha2::{Digest, Sha256};
 use std::collections::HashMap;
 use std::path::{Path, PathBuf};
+use std::sync::Arc;
 use tokio::sync::Notify;
 
-pub struct BlockCache {
-    path: PathBuf,
+/// Selects the pack backend for block caches when set to `pack`; anything
+/// else keeps the SQLite cache.
+const CACHE_FORMAT_ENV: &str = "PIRATE_BLOCK_CACHE_FORMAT";
+
+pub enum BlockCache {
+    /// One SQLite database per endpoint, a JSON blob per block.
+    Sqlite { path: PathBuf },
+    /// Append-only segment files, see [`crate::block_pack`].
+    Pack(Arc<BlockPack>),
 }
 
 #[derive(Clone, Debug, Hash, PartialEq, Eq)]
@@ -25,6 +35,15 @@ struct RangeKey {
 static INFLIGHT_RANGES: Lazy<Mutex<HashMap<RangeKey, std::sync::Arc<Notify>>>> =
     Lazy::new(|| Mutex::new(HashMap::new()));
 
+/// Idle connections per SQLite cache file. Sync opens the cache for every
+/// batch; reusing connections keeps their page cache and prepared statements
+/// warm. A path is present once its schema has been created.
+static SQLITE_IDLE: Lazy<Mutex<HashMap<PathBuf, Vec<Connection>>>> =
+    Lazy::new(|| Mutex::new(HashMap::new()));
+
+/// Connections kept per cache file: one batch writer and one reader.
+const MAX_IDLE_CONNECTIONS: usize = 2;
+
 pub enum InflightLease {
     Leader(InflightToken),
     Follower(std::sync::Arc<Notify>),
@@ -92,6 +111,10 @@ fn find_overlap_locked(
 
 impl BlockCache {
     pub fn for_endpoint(endpoint: &str) -> Result<Self> {
+        if pack_format_enabled() {
+            let dir = pack_dir_for_endpoint(endpoint)?;
+            return Ok(Self::Pack(BlockPack::open(dir)?));
+        }
         let path = cache_path_for_endpoint(endpoint)?;
         Self::new(path)
     }
@@ -100,9 +123,12 @@ impl BlockCache {
         if start > end {
             return Ok(Vec::new());
         }
+        if let Self::Pack(pack) = self {
+            return pack.load_range(start, end);
+        }
 
         let conn = self.open_conn()?;
-        let mut stmt = conn.prepare(
+        let mut stmt = conn.prepare_cached(
             "SELECT height, data FROM blocks WHERE height BETWEEN ?1 AND ?2 ORDER BY height ASC",
         ).map_err(|e| Error::Storage(e.to_string()))?;
 
@@ -113,19 +139,47 @@ impl BlockCache {
             })
             .map_err(|e| Error::Storage(e.to_string()))?;
 
-        let mut blocks = Vec::new();
+        // Rows are held as they decode; the charge tracks their encoded size
+        // so the cache's high-water mark covers SQLite reads as well as packs.
+        let mut memory = memory_budget::charge(MemoryConsumer::BlockCache, 0);
+        let mut blocks = Vec::with_capacity(end.saturating_sub(start).saturating_add(1) as usize);
         for row in rows {
             let data = row.map_err(|e| Error::Storage(e.to_string()))?;
+            memory.resize(memory.bytes() + data.len() as u64);
             blocks.push(decode_block(&data)?);
         }
 
         Ok(blocks)
     }
 
+    /// Heights cached in `start..=end`, without decoding them. Lets callers
+    /// skip reading a range that is only partly cached.
+    pub fn count_range(&self, start: u64, end: u64) -> Result<usize> {
+        if start > end {
+            return Ok(0);
+        }
+        if let Self::Pack(pack) = self {
+            return pack.count_range(start, end);
+        }
+
+        let conn = self.open_conn()?;
+        let count: i64 = conn
+            .query_row(
+                "SELECT COUNT(*) FROM blocks WHERE height BETWEEN ?1 AND ?2",
+                params![start as i64, end as i64],
+                |row| row.get(0),
+            )
+            .map_err(|e| Error::Storage(e.to_string()))?;
+        Ok(count.max(0) as usize)
+    }
+
     pub fn store_blocks(&self, blocks: &[CompactBlockData]) -> Result<()> {
         if blocks.is_empty() {
             return Ok(());
         }
+        if let Self::Pack(pack) = self {
+            return pack.store_blocks(blocks);
+        }
 
         let conn = self.open_conn()?;
         let tx = conn
@@ -133,7 +187,7 @@ impl BlockCache {
             .map_err(|e| Error::Storage(e.to_string()))?;
         {
             let mut stmt = tx
-                .prepare("INSERT OR REPLACE INTO blocks (height, data) VALUES (?1, ?2)")
+                .prepare_cached("INSERT OR REPLACE INTO blocks (height, data) VALUES (?1, ?2)")
                 .map_err(|e| Error::Storage(e.to_string()))?;
 
             for block in blocks {
@@ -150,6 +204,9 @@ impl BlockCache {
         if start > end {
             return Ok(0);
         }
+        if let Self::Pack(pack) = self {
+            return pack.delete_range(start, end);
+        }
 
         let conn = self.open_conn()?;
         conn.execute(
@@ -160,6 +217,9 @@ impl BlockCache {
     }
 
     pub fn delete_above(&self, height: u64) -> Result<usize> {
+        if let Self::Pack(pack) = self {
+            return pack.delete_above(height);
+        }
         let conn = self.open_conn()?;
         conn.execute(
             "DELETE FROM blocks WHERE height > ?1",
@@ -172,7 +232,10 @@ impl BlockCache {
         if let Some(parent) = path.parent() {
             std::fs::create_dir_all(parent).map_err(|e| Error::Storage(e.to_string()))?;
         }
-        let cache = Self { path };
+        if SQLITE_IDLE.lock().contains_key(&path) {
+            return Ok(Self::Sqlite { path });
+        }
+        let cache = Self::Sqlite { path };
         let conn = cache.open_conn()?;
         conn.execute_batch(
             "CREATE TABLE IF NOT EXISTS blocks (
@@ -182,14 +245,107 @@ impl BlockCache {
              CREATE INDEX IF NOT EXISTS idx_blocks_height ON blocks(height);",
         )
         .map_err(|e| Error::Storage(e.to_string()))?;
+        SQLITE_IDLE.lock().entry(conn.path.clone()).or_default();
+        drop(conn);
         Ok(cache)
     }
 
-    fn open_conn(&self) -> Result<Connection> {
-        Connection::open(&self.path).map_err(|e| Error::Storage(e.to_string()))
+    fn open_conn(&self) -> Result<CacheConnection> {
+        match self {
+            Self::Sqlite { path } => {
+                let idle = SQLITE_IDLE.lock().get_mut(path).and_then(Vec::pop);
+                let conn = match idle {
+                    Some(conn) => conn,
+                    None => {
+                        let conn =
+                            Connection::open(path).map_err(|e| Error::Storage(e.to_string()))?;
+                        // Lets a batch write proceed while another sync reads.
+                        conn.execute_batch("PRAGMA journal_mode=WAL;")
+                            .map_err(|e| Error::Storage(e.to_string()))?;
+                        conn
+                    }
+                };
+                Ok(CacheConnection {
+                    conn: Some(conn),
+                    path: path.clone(),
+                })
+            }
+            Self::Pack(_) => Err(Error::Storage("block pack has no SQLite connection".into())),
+        }
     }
 }
 
+/// A cache connection that goes back to `SQLITE_IDLE` when dropped.
+struct CacheConnection {
+    conn: Option<Connection>,
+    path: PathBuf,
+}
+
+impl std::ops::Deref for CacheConnection {
+    type Target = Connection;
+
+    fn deref(&self) -> &Connection {
+        self.conn
+            .as_ref()
+            .expect("cache connection present until drop")
+    }
+}
+
+impl Drop for CacheConnection {
+    fn drop(&mut self) {
+        let Some(conn) = self.conn.take() else {
+            return;
+        };
+        let mut idle = SQLITE_IDLE.lock();
+        let pooled = idle.entry(std::mem::take(&mut self.path)).or_default();
+        if pooled.len() < MAX_IDLE_CONNECTIONS {
+            pooled.push(conn);
+        }
+    }
+}
+
+/// Pull the height index of every endpoint cache into the OS page cache so the
+/// first `load_range` after a cold boot does not wait on disk seeks. Caches are
+/// opened read-only and nothing is decoded. Pack caches have their index logs
+/// replayed into memory instead. Returns how many caches were read.
+pub fn prewarm_indices() -> usize {
+    let Ok(base) = cache_base_dir() else {
+        return 0;
+    };
+    let Ok(entries) = std::fs::read_dir(&base) else {
+        return 0;
+    };
+
+    let mut warmed = crate::block_pack::prewarm_packs(&base);
+    for entry in entries.flatten() {
+        let path = entry.path();
+        let is_cache = path
+            .file_name()
+            .and_then(|name| name.to_str())
+            .is_some_and(|name| name.starts_with("block_cache_") && name.ends_with(".db"));
+        if !is_cache {
+            continue;
+        }
+        let Ok(conn) = Connection::open_with_flags(
+            &path,
+            OpenFlags::SQLITE_OPEN_READ_ONLY | OpenFlags::SQLITE_OPEN_NO_MUTEX,
+        ) else {
+            continue;
+        };
+        // Counting through the index visits every index page without
+        // touching the block blobs.
+        let walked = conn.query_row(
+            "SELECT COUNT(height) FROM blocks INDEXED BY idx_blocks_height",
+            [],
+            |row| row.get::<_, i64>(0),
+        );
+        if walked.is_ok() {
+            warmed += 1;
+        }
+    }
+    warmed
+}
+
 fn cache_base_dir() -> Result<PathBuf> {
     if let Ok(dir) = std::env::var("PIRATE_BLOCK_CACHE_DIR") {
         if !dir.trim().is_empty() {
@@ -230,6 +386,19 @@ fn cache_path_for_endpoint(endpoint: &str) -> Result<PathBuf> {
     Ok(base.join(format!("block_cache_{}.db", short)))
 }
 
+fn pack_dir_for_endpoint(endpoint: &str) -> Result<PathBuf> {
+    let base = cache_base_dir()?;
+    let hash = Sha256::digest(endpoint.as_bytes());
+    let short = hex::encode(&hash[..8]);
+    Ok(base.join(format!("block_pack_{}", short)))
+}
+
+fn pack_format_enabled() -> bool {
+    std::env::var(CACHE_FORMAT_ENV)
+        .map(|format| format.trim().eq_ignore_ascii_case("pack"))
+        .unwrap_or(false)
+}
+
 fn encode_block(block: &CompactBlockData) -> Result<Vec<u8>> {
     // Use serde for serialization to avoid prost version conflicts
     serde_json::to_vec(block).map_err(|e| Error::Storage(e.to_string()))
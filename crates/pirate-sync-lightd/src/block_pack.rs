@@ -0,0 +1,988 @@
+//! Append-only compact block pack files.
+//!
+//! An alternative to the SQLite block cache for long rescans and multi-wallet
+//! sync, where per-row queries and JSON decoding dominate. Each endpoint gets
+//! a directory of segments, one per [`SEGMENT_SPAN`] heights:
+//!
+//! - `<segment>.blocks`: a header (magic and compaction generation) followed
+//!   by blocks in a fixed binary layout, appended in the order they were
+//!   stored. Decoding is a sequence of length-prefixed copies, no parsing.
+//! - `<segment>.index`: an append-only log of 16-byte entries mapping a
+//!   height to its record, or a tombstone dropping a height range. Replaying
+//!   the log gives the live height-to-offset map, later entries winning.
+//!
+//! A range is read with one positional read covering its records, so a batch
+//! costs a single syscall served from the OS page cache. The crate does not
+//! use unsafe code, which rules out memory maps; positional reads also stay
+//! sound when another process truncates a segment underneath us.
+//!
+//! Reorgs are cheap: `delete_above` unlinks whole segments above the fork,
+//! appends one tombstone to the boundary segment and truncates its block file
+//! back to the last live record. Open packs are shared process-wide, so every
+//! wallet syncing against an endpoint reads the same segments.
+//!
+//! Other processes (a second app instance, the background sync service) may
+//! have the same pack open. Writers hold an exclusive lock on the pack's
+//! `LOCK` file and replay any index entries appended meanwhile before adding
+//! their own; readers hold it shared while replaying an index. Once dead
+//! records (overwritten or tombstoned heights) outweigh live ones, a write
+//! compacts the segment: live records are copied into fresh files that are
+//! renamed over the old ones with the generation bumped. Other processes
+//! notice the new generation, or a changed index length, and reopen both
+//! files before their next read or write. Handles they already hold keep
+//! reading the old files until then.
+
+use crate::client::{
+    CompactBlockData, CompactOrchardAction, CompactSaplingOutput, CompactSaplingSpend, CompactTx,
+};
+use crate::{Error, Result};
+use once_cell::sync::Lazy;
+use parking_lot::{Mutex, MutexGuard, RwLock};
+use pirate_core::memory_budget::{self, MemoryConsumer};
+use std::collections::{BTreeMap, HashMap};
+use std::fs::{File, OpenOptions};
+use std::io::{Read, Seek, SeekFrom, Write};
+use std::path::{Path, PathBuf};
+use std::sync::Arc;
+
+/// Heights per segment. Large enough that a full chain needs a few dozen open
+/// files, small enough that a reorg touches one segment.
+const SEGMENT_SPAN: u64 = 100_000;
+const MAGIC: &[u8; 5] = b"PBPK\x01";
+/// Magic plus a 24-bit little-endian compaction generation. Files written
+/// before compaction existed carry zero.
+const HEADER_LEN: usize = 8;
+const GENERATION_MASK: u32 = 0x00ff_ffff;
+const INDEX_ENTRY_LEN: usize = 16;
+/// Index entry `len` marking a tombstone; `offset` then holds the last
+/// height delta of the dropped range.
+const TOMBSTONE: u32 = u32::MAX;
+/// Past this ratio of span to live bytes a range is read record by record
+/// rather than with one read over dead space. Spans larger than the block
+/// cache share of the memory budget are read record by record as well.
+const MAX_SPAN_WASTE: u64 = 4;
+/// A segment is compacted once its dead bytes exceed both its live bytes and
+/// this floor, so small segments are not rewritten for a few stale records.
+const COMPACT_MIN_DEAD_BYTES: u64 = 4 * 1024 * 1024;
+const LOCK_FILE: &str = "LOCK";
+
+const TX_HAS_INDEX: u8 = 1;
+const TX_HAS_FEE: u8 = 2;
+
+static PACKS: Lazy<Mutex<HashMap<PathBuf, Arc<BlockPack>>>> =
+    Lazy::new(|| Mutex::new(HashMap::new()));
+
+#[derive(Clone, Copy)]
+struct Entry {
+    offset: u64,
+    len: u32,
+}
+
+struct Segment {
+    base: u64,
+    data_path: PathBuf,
+    index_path: PathBuf,
+    data: File,
+    entries: BTreeMap<u64, Entry>,
+    /// Append position: end of the last live record.
+    data_len: u64,
+    /// Sum of live record lengths; the rest of `data_len` is dead.
+    live_len: u64,
+    /// Bytes of the index log replayed so far.
+    index_len: u64,
+    /// Compaction generation of the block file `data` reads.
+    generation: u32,
+    /// The files were removed by another process; the next append
+    /// recreates them.
+    missing: bool,
+}
+
+/// The cross-process lock on a pack's `LOCK` file, which is never deleted.
+/// File locks are per open file rather than per thread, so the mutex keeps
+/// two threads of this process from holding the one lock at once.
+struct PackLock {
+    file: Mutex<File>,
+}
+
+struct PackGuard<'a> {
+    file: MutexGuard<'a, File>,
+}
+
+impl PackLock {
+    fn open(dir: &Path) -> Result<Self> {
+        let file = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(false)
+            .open(dir.join(LOCK_FILE))
+            .map_err(storage)?;
+        Ok(Self {
+            file: Mutex::new(file),
+        })
+    }
+
+    /// For appends, tombstones, segment removal and compaction.
+    fn exclusive(&self) -> Result<PackGuard<'_>> {
+        let file = self.file.lock();
+        File::lock(&file).map_err(storage)?;
+        Ok(PackGuard { file })
+    }
+
+    /// For replaying an index, so it never sees a compaction half done.
+    fn shared(&self) -> Result<PackGuard<'_>> {
+        let file = self.file.lock();
+        File::lock_shared(&file).map_err(storage)?;
+        Ok(PackGuard { file })
+    }
+}
+
+impl Drop for PackGuard<'_> {
+    fn drop(&mut self) {
+        let _ = File::unlock(&self.file);
+    }
+}
+
+/// Block pack for one endpoint.
+pub(crate) struct BlockPack {
+    dir: PathBuf,
+    lock: PackLock,
+    segments: Mutex<HashMap<u64, Arc<RwLock<Segment>>>>,
+}
+
+impl BlockPack {
+    /// Shared pack rooted at `dir`, created on first use.
+    pub(crate) fn open(dir: PathBuf) -> Result<Arc<Self>> {
+        let mut packs = PACKS.lock();
+        if let Some(pack) = packs.get(&dir) {
+            return Ok(pack.clone());
+        }
+        std::fs::create_dir_all(&dir).map_err(|e| Error::Storage(e.to_string()))?;
+        let pack = Arc::new(Self {
+            lock: PackLock::open(&dir)?,
+            dir: dir.clone(),
+            segments: Mutex::new(HashMap::new()),
+        });
+        packs.insert(dir, pack.clone());
+        Ok(pack)
+    }
+
+    pub(crate) fn load_range(&self, start: u64, end: u64) -> Result<Vec<CompactBlockData>> {
+        let mut blocks = Vec::new();
+        if start > end {
+            return Ok(blocks);
+        }
+        for id in start / SEGMENT_SPAN..=end / SEGMENT_SPAN {
+            let Some(segment) = self.segment(id, false, None)? else {
+                continue;
+            };
+            self.reload_if_stale(&segment)?;
+            segment.read().load_range(start, end, &mut blocks)?;
+        }
+        Ok(blocks)
+    }
+
+    /// Live heights stored in `start..=end`, from the index alone.
+    pub(crate) fn count_range(&self, start: u64, end: u64) -> Result<usize> {
+        if start > end {
+            return Ok(0);
+        }
+        let mut count = 0;
+        for id in start / SEGMENT_SPAN..=end / SEGMENT_SPAN {
+            let Some(segment) = self.segment(id, false, None)? else {
+                continue;
+            };
+            self.reload_if_stale(&segment)?;
+            count += segment.read().entries.range(start..=end).count();
+        }
+        Ok(count)
+    }
+
+    pub(crate) fn store_blocks(&self, blocks: &[CompactBlockData]) -> Result<()> {
+        let mut by_segment: BTreeMap<u64, Vec<&CompactBlockData>> = BTreeMap::new();
+        for block in blocks {
+            by_segment
+                .entry(block.height / SEGMENT_SPAN)
+                .or_default()
+                .push(block);
+        }
+        let guard = self.lock.exclusive()?;
+        for (id, blocks) in by_segment {
+            if let Some(segment) = self.segment(id, true, Some(&guard))? {
+                let mut segment = segment.write();
+                segment.append(&blocks)?;
+                segment.compact_if_sparse()?;
+            }
+        }
+        Ok(())
+    }
+
+    pub(crate) fn delete_range(&self, start: u64, end: u64) -> Result<usize> {
+        if start > end {
+            return Ok(0);
+        }
+        let guard = self.lock.exclusive()?;
+        let mut removed = 0;
+        for id in self.segment_ids_on_disk()? {
+            let base = id * SEGMENT_SPAN;
+            if base > end || base + SEGMENT_SPAN <= start {
+                continue;
+            }
+            if start <= base && end >= base + SEGMENT_SPAN - 1 {
+                removed += self.remove_segment(id)?;
+            } else if let Some(segment) = self.segment(id, false, Some(&guard))? {
+                let mut segment = segment.write();
+                removed += segment.drop_range(start.max(base), end)?;
+                segment.compact_if_sparse()?;
+            }
+        }
+        Ok(removed)
+    }
+
+    pub(crate) fn delete_above(&self, height: u64) -> Result<usize> {
+        self.delete_range(height.saturating_add(1), u64::MAX)
+    }
+
+    /// Replay every segment index into memory. Returns how many segments
+    /// were loaded.
+    pub(crate) fn prewarm(&self) -> Result<usize> {
+        let mut loaded = 0;
+        for id in self.segment_ids_on_disk()? {
+            if self.segment(id, false, None)?.is_some() {
+                loaded += 1;
+            }
+        }
+        Ok(loaded)
+    }
+
+    /// Open segment `id`. Opening replays its index, which needs the pack
+    /// lock: `held` if the caller has it, otherwise it is taken shared.
+    fn segment(
+        &self,
+        id: u64,
+        create: bool,
+        held: Option<&PackGuard<'_>>,
+    ) -> Result<Option<Arc<RwLock<Segment>>>> {
+        if let Some(segment) = self.segments.lock().get(&id) {
+            return Ok(Some(segment.clone()));
+        }
+        let _shared = match held {
+            Some(_) => None,
+            None => Some(self.lock.shared()?),
+        };
+        let mut segments = self.segments.lock();
+        if let Some(segment) = segments.get(&id) {
+            return Ok(Some(segment.clone()));
+        }
+        let (data_path, index_path) = self.segment_paths(id);
+        if !create && !index_path.exists() {
+            return Ok(None);
+        }
+        let segment = Arc::new(RwLock::new(Segment::open(
+            id * SEGMENT_SPAN,
+            data_path,
+            index_path,
+        )?));
+        segments.insert(id, segment.clone());
+        Ok(Some(segment))
+    }
+
+    /// Replay what other processes appended since this segment was read.
+    fn reload_if_stale(&self, segment: &RwLock<Segment>) -> Result<()> {
+        if !segment.read().index_is_stale() {
+            return Ok(());
+        }
+        let _shared = self.lock.shared()?;
+        let mut segment = segment.write();
+        if segment.index_is_stale() {
+            segment.reload()?;
+        }
+        Ok(())
+    }
+
+    fn remove_segment(&self, id: u64) -> Result<usize> {
+        let mut segments = self.segments.lock();
+        let removed = match segments.remove(&id) {
+            Some(segment) => segment.read().entries.len(),
+            None => 0,
+        };
+        let (data_path, index_path) = self.segment_paths(id);
+        for path in [index_path, data_path] {
+            match std::fs::remove_file(&path) {
+                Ok(()) => {}
+                Err(e) if e.kind() == std::io::ErrorKind::NotFound => {}
+                Err(e) => return Err(Error::Storage(e.to_string())),
+            }
+        }
+        Ok(removed)
+    }
+
+    fn segment_paths(&self, id: u64) -> (PathBuf, PathBuf) {
+        (
+            self.dir.join(format!("{:08}.blocks", id)),
+            self.dir.join(format!("{:08}.index", id)),
+        )
+    }
+
+    fn segment_ids_on_disk(&self) -> Result<Vec<u64>> {
+        let entries = match std::fs::read_dir(&self.dir) {
+            Ok(entries) => entries,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => return Ok(Vec::new()),
+            Err(e) => return Err(Error::Storage(e.to_string())),
+        };
+        let mut ids: Vec<u64> = entries
+            .flatten()
+            .filter_map(|entry| {
+                let name = entry.file_name();
+                name.to_str()?.strip_suffix(".index")?.parse().ok()
+            })
+            .collect();
+        ids.sort_unstable();
+        Ok(ids)
+    }
+}
+
+impl Segment {
+    fn open(base: u64, data_path: PathBuf, index_path: PathBuf) -> Result<Self> {
+        let mut data = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(false)
+            .open(&data_path)
+            .map_err(storage)?;
+        let mut header = [0u8; HEADER_LEN];
+        let valid = data.read_exact(&mut header).is_ok() && parse_header(&header).is_some();
+        if !valid {
+            // New, torn or foreign file: start the segment over.
+            data.set_len(0).map_err(storage)?;
+            data.write_all(&header_bytes(0)).map_err(storage)?;
+            File::create(&index_path).map_err(storage)?;
+        }
+        let mut segment = Self {
+            base,
+            data_path,
+            index_path,
+            data,
+            entries: BTreeMap::new(),
+            data_len: HEADER_LEN as u64,
+            live_len: 0,
+            index_len: 0,
+            generation: 0,
+            missing: false,
+        };
+        segment.reload()?;
+        Ok(segment)
+    }
+
+    /// Whether the files on disk differ from what was replayed: another
+    /// process appended, deleted, compacted or removed the segment. Length
+    /// alone misses a compaction that leaves the index as long as before, so
+    /// the block file's generation is compared too.
+    fn index_is_stale(&self) -> bool {
+        let index_len = std::fs::metadata(&self.index_path).map(|meta| meta.len());
+        match index_len {
+            Ok(len) => {
+                len != self.index_len || read_generation(&self.data_path) != Some(self.generation)
+            }
+            Err(_) => !self.missing,
+        }
+    }
+
+    fn reload(&mut self) -> Result<()> {
+        let index = match std::fs::read(&self.index_path) {
+            Ok(index) => index,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => Vec::new(),
+            Err(e) => return Err(storage(e)),
+        };
+        self.entries.clear();
+        self.index_len = 0;
+        self.data_len = HEADER_LEN as u64;
+        self.live_len = 0;
+        // A compaction elsewhere renames a new block file over the one this
+        // handle reads, so reopen it to match the index just read. Never
+        // create it here: a missing file means the segment was removed.
+        let data = match OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&self.data_path)
+        {
+            Ok(data) => data,
+            Err(e) if e.kind() == std::io::ErrorKind::NotFound => {
+                self.missing = true;
+                return Ok(());
+            }
+            Err(e) => return Err(storage(e)),
+        };
+        self.data = data;
+        self.missing = false;
+        let mut header = [0u8; HEADER_LEN];
+        read_exact_at(&self.data, &mut header, 0)?;
+        self.generation = parse_header(&header)
+            .ok_or_else(|| Error::Storage("block pack header is invalid".to_string()))?;
+        let file_len = self.data.metadata().map_err(storage)?.len();
+        for raw in index.chunks_exact(INDEX_ENTRY_LEN) {
+            let delta = u32::from_le_bytes(raw[0..4].try_into().unwrap_or_default());
+            let len = u32::from_le_bytes(raw[4..8].try_into().unwrap_or_default());
+            let offset = u64::from_le_bytes(raw[8..16].try_into().unwrap_or_default());
+            let height = self.base + delta as u64;
+            if len == TOMBSTONE {
+                let last = self.base.saturating_add(offset);
+                let doomed: Vec<u64> = self.entries.range(height..=last).map(|(h, _)| *h).collect();
+                for height in doomed {
+                    self.entries.remove(&height);
+                }
+            } else if offset >= HEADER_LEN as u64 && offset + len as u64 <= file_len {
+                self.entries.insert(height, Entry { offset, len });
+            }
+        }
+        self.index_len = (index.len() - index.len() % INDEX_ENTRY_LEN) as u64;
+        self.data_len = self.live_end();
+        self.live_len = self.entries.values().map(|entry| entry.len as u64).sum();
+        Ok(())
+    }
+
+    fn live_end(&self) -> u64 {
+        self.entries
+            .values()
+            .map(|entry| entry.offset + entry.len as u64)
+            .max()
+            .unwrap_or(HEADER_LEN as u64)
+    }
+
+    fn load_range(&self, start: u64, end: u64, out: &mut Vec<CompactBlockData>) -> Result<()> {
+        let entries: Vec<(u64, Entry)> = self
+            .entries
+            .range(start..=end)
+            .map(|(height, entry)| (*height, *entry))
+            .collect();
+        if entries.is_empty() {
+            return Ok(());
+        }
+        let first = entries.iter().map(|(_, e)| e.offset).min().unwrap_or(0);
+        let last = entries
+            .iter()
+            .map(|(_, e)| e.offset + e.len as u64)
+            .max()
+            .unwrap_or(0);
+        let live: u64 = entries.iter().map(|(_, e)| e.len as u64).sum();
+
+        out.reserve(entries.len());
+        let span_len = last - first;
+        let span_fits_budget =
+            span_len <= memory_budget::cap_to_budget(MemoryConsumer::BlockCache, span_len);
+        if span_len <= live.saturating_mul(MAX_SPAN_WASTE) && span_fits_budget {
+            let _span_memory = memory_budget::charge(MemoryConsumer::BlockCache, span_len);
+            let mut span = vec![0u8; span_len as usize];
+            read_exact_at(&self.data, &mut span, first)?;
+            for (height, entry) in entries {
+                let at = (entry.offset - first) as usize;
+                out.push(decode_record(height, &span[at..at + entry.len as usize])?);
+            }
+        } else {
+            let mut record = Vec::new();
+            for (height, entry) in entries {
+                record.resize(entry.len as usize, 0);
+                read_exact_at(&self.data, &mut record, entry.offset)?;
+                out.push(decode_record(height, &record)?);
+            }
+        }
+        Ok(())
+    }
+
+    fn append(&mut self, blocks: &[&CompactBlockData]) -> Result<()> {
+        if self.index_is_stale() {
+            self.reload()?;
+        }
+        if self.missing {
+            self.recreate()?;
+        }
+        let mut records = Vec::new();
+        let mut index = Vec::with_capacity(blocks.len() * INDEX_ENTRY_LEN);
+        let mut placed = Vec::with_capacity(blocks.len());
+        for block in blocks {
+            let offset = self.data_len + records.len() as u64;
+            encode_record(block, &mut records);
+            let len = (self.data_len + records.len() as u64 - offset) as u32;
+            index.extend_from_slice(&((block.height - self.base) as u32).to_le_bytes());
+            index.extend_from_slice(&len.to_le_bytes());
+            index.extend_from_slice(&offset.to_le_bytes());
+            placed.push((block.height, Entry { offset, len }));
+        }
+
+        // Drop any torn tail past the last live record before appending.
+        self.data.set_len(self.data_len).map_err(storage)?;
+        self.data
+            .seek(SeekFrom::Start(self.data_len))
+            .map_err(storage)?;
+        self.data.write_all(&records).map_err(storage)?;
+        self.append_index(&index)?;
+
+        self.data_len += records.len() as u64;
+        for (height, entry) in placed {
+            self.live_len += entry.len as u64;
+            if let Some(replaced) = self.entries.insert(height, entry) {
+                self.live_len -= replaced.len as u64;
+            }
+        }
+        Ok(())
+    }
+
+    fn drop_range(&mut self, start: u64, end: u64) -> Result<usize> {
+        if self.index_is_stale() {
+            self.reload()?;
+        }
+        let last = end.min(self.base + SEGMENT_SPAN - 1);
+        let doomed: Vec<u64> = self.entries.range(start..=last).map(|(h, _)| *h).collect();
+        if doomed.is_empty() {
+            return Ok(0);
+        }
+        let mut tombstone = [0u8; INDEX_ENTRY_LEN];
+        tombstone[0..4].copy_from_slice(&((start - self.base) as u32).to_le_bytes());
+        tombstone[4..8].copy_from_slice(&TOMBSTONE.to_le_bytes());
+        tombstone[8..16].copy_from_slice(&(last - self.base).to_le_bytes());
+        self.append_index(&tombstone)?;
+
+        for height in &doomed {
+            if let Some(entry) = self.entries.remove(height) {
+                self.live_len -= entry.len as u64;
+            }
+        }
+        let live_end = self.live_end();
+        if live_end < self.data_len {
+            self.data.set_len(live_end).map_err(storage)?;
+            self.data_len = live_end;
+        }
+        Ok(doomed.len())
+    }
+
+    /// Start empty files for a segment another process removed. Called
+    /// with the pack lock held exclusively, so no other writer races it.
+    fn recreate(&mut self) -> Result<()> {
+        let mut data = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .create(true)
+            .truncate(true)
+            .open(&self.data_path)
+            .map_err(storage)?;
+        data.write_all(&header_bytes(0)).map_err(storage)?;
+        File::create(&self.index_path).map_err(storage)?;
+        self.data = data;
+        self.generation = 0;
+        self.missing = false;
+        Ok(())
+    }
+
+    /// Rewrite the segment with only its live records once dead ones
+    /// dominate. Called with the pack lock held exclusively.
+    fn compact_if_sparse(&mut self) -> Result<()> {
+        let dead = self.data_len - HEADER_LEN as u64 - self.live_len;
+        if dead < COMPACT_MIN_DEAD_BYTES || dead <= self.live_len {
+            return Ok(());
+        }
+        self.compact()
+    }
+
+    fn compact(&mut self) -> Result<()> {
+        let generation = self.generation.wrapping_add(1) & GENERATION_MASK;
+        let data_tmp = self.data_path.with_extension("blocks.compact");
+        let index_tmp = self.index_path.with_extension("index.compact");
+        let mut data = std::io::BufWriter::new(File::create(&data_tmp).map_err(storage)?);
+        let mut index = Vec::with_capacity(self.entries.len() * INDEX_ENTRY_LEN);
+        let mut entries = BTreeMap::new();
+        let mut offset = HEADER_LEN as u64;
+        let mut record = Vec::new();
+        data.write_all(&header_bytes(generation)).map_err(storage)?;
+        for (height, entry) in &self.entries {
+            record.resize(entry.len as usize, 0);
+            read_exact_at(&self.data, &mut record, entry.offset)?;
+            data.write_all(&record).map_err(storage)?;
+            index.extend_from_slice(&((height - self.base) as u32).to_le_bytes());
+            index.extend_from_slice(&entry.len.to_le_bytes());
+            index.extend_from_slice(&offset.to_le_bytes());
+            entries.insert(
+                *height,
+                Entry {
+                    offset,
+                    len: entry.len,
+                },
+            );
+            offset += entry.len as u64;
+        }
+        let data = data.into_inner().map_err(|e| storage(e.into_error()))?;
+        data.sync_all().map_err(storage)?;
+        drop(data);
+        std::fs::write(&index_tmp, &index).map_err(storage)?;
+
+        // Block file first: until the index follows, the old index's offsets
+        // only reach other processes through block file handles they already
+        // hold, and replaying waits on the lock held here.
+        std::fs::rename(&data_tmp, &self.data_path).map_err(storage)?;
+        std::fs::rename(&index_tmp, &self.index_path).map_err(storage)?;
+        self.data = OpenOptions::new()
+            .read(true)
+            .write(true)
+            .open(&self.data_path)
+            .map_err(storage)?;
+        self.entries = entries;
+        self.data_len = offset;
+        self.index_len = index.len() as u64;
+        self.generation = generation;
+        Ok(())
+    }
+
+    fn append_index(&mut self, bytes: &[u8]) -> Result<()> {
+        let mut index = OpenOptions::new()
+            .write(true)
+            .create(true)
+            .truncate(false)
+            .open(&self.index_path)
+            .map_err(storage)?;
+        // Cut a torn trailing entry so new entries stay aligned.
+        index.set_len(self.index_len).map_err(storage)?;
+        index
+            .seek(SeekFrom::Start(self.index_len))
+            .map_err(storage)?;
+        index.write_all(bytes).map_err(storage)?;
+        self.index_len += bytes.len() as u64;
+        Ok(())
+    }
+}
+
+/// Segments of every pack under `base`, replayed into memory. Returns how
+/// many packs were read.
+pub(crate) fn prewarm_packs(base: &Path) -> usize {
+    let Ok(entries) = std::fs::read_dir(base) else {
+        return 0;
+    };
+    let mut warmed = 0;
+    for entry in entries.flatten() {
+        let path = entry.path();
+        let is_pack = path.is_dir()
+            && path
+                .file_name()
+                .and_then(|name| name.to_str())
+                .is_some_and(|name| name.starts_with("block_pack_"));
+        if !is_pack {
+            continue;
+        }
+        if let Ok(pack) = BlockPack::open(path) {
+            if pack.prewarm().is_ok() {
+                warmed += 1;
+            }
+        }
+    }
+    warmed
+}
+
+fn header_bytes(generation: u32) -> [u8; HEADER_LEN] {
+    let mut header = [0u8; HEADER_LEN];
+    header[..MAGIC.len()].copy_from_slice(MAGIC);
+    header[MAGIC.len()..].copy_from_slice(&generation.to_le_bytes()[..HEADER_LEN - MAGIC.len()]);
+    header
+}
+
+/// The generation in a block file header, or `None` if it is not one.
+fn parse_header(header: &[u8; HEADER_LEN]) -> Option<u32> {
+    if &header[..MAGIC.len()] != MAGIC {
+        return None;
+    }
+    let mut generation = [0u8; 4];
+    generation[..HEADER_LEN - MAGIC.len()].copy_from_slice(&header[MAGIC.len()..]);
+    Some(u32::from_le_bytes(generation))
+}
+
+/// Generation of the block file at `path`; `None` if it is missing or has
+/// no valid header.
+fn read_generation(path: &Path) -> Option<u32> {
+    let file = File::open(path).ok()?;
+    let mut header = [0u8; HEADER_LEN];
+    read_exact_at(&file, &mut header, 0).ok()?;
+    parse_header(&header)
+}
+
+fn storage(e: std::io::Error) -> Error {
+    Error::Storage(e.to_string())
+}
+
+#[cfg(unix)]
+fn read_exact_at(file: &File, buf: &mut [u8], offset: u64) -> Result<()> {
+    use std::os::unix::fs::FileExt;
+    file.read_exact_at(buf, offset).map_err(storage)
+}
+
+#[cfg(windows)]
+fn read_exact_at(file: &File, mut buf: &mut [u8], mut offset: u64) -> Result<()> {
+    use std::os::windows::fs::FileExt;
+    while !buf.is_empty() {
+        match file.seek_read(buf, offset) {
+            Ok(0) => {
+                return Err(Error::Storage("block pack record truncated".to_string()));
+            }
+            Ok(n) => {
+                buf = &mut buf[n..];
+                offset += n as u64;
+            }
+            Err(e) if e.kind() == std::io::ErrorKind::Interrupted => {}
+            Err(e) => return Err(storage(e)),
+        }
+    }
+    Ok(())
+}
+
+fn put_u32(out: &mut Vec<u8>, value: u32) {
+    out.extend_from_slice(&value.to_le_bytes());
+}
+
+fn put_bytes(out: &mut Vec<u8>, bytes: &[u8]) {
+    put_u32(out, bytes.len() as u32);
+    out.extend_from_slice(bytes);
+}
+
+fn encode_record(block: &CompactBlockData, out: &mut Vec<u8>) {
+    out.extend_from_slice(&block.height.to_le_bytes());
+    put_u32(out, block.proto_version);
+    put_u32(out, block.time);
+    put_bytes(out, &block.hash);
+    put_bytes(out, &block.prev_hash);
+    put_bytes(out, &block.header);
+    put_u32(out, block.transactions.len() as u32);
+    for tx in &block.transactions {
+        let mut flags = 0;
+        if tx.index.is_some() {
+            flags |= TX_HAS_INDEX;
+        }
+        if tx.fee.is_some() {
+            flags |= TX_HAS_FEE;
+        }
+        out.push(flags);
+        out.extend_from_slice(&tx.index.unwrap_or(0).to_le_bytes());
+        put_u32(out, tx.fee.unwrap_or(0));
+        put_bytes(out, &tx.hash);
+        put_u32(out, tx.spends.len() as u32);
+        for spend in &tx.spends {
+            put_bytes(out, &spend.nf);
+        }
+        put_u32(out, tx.outputs.len() as u32);
+        for output in &tx.outputs {
+            put_bytes(out, &output.cmu);
+            put_bytes(out, &output.ephemeral_key);
+            put_bytes(out, &output.ciphertext);
+        }
+        put_u32(out, tx.actions.len() as u32);
+        for action in &tx.actions {
+            put_bytes(out, &action.nullifier);
+            put_bytes(out, &action.cmx);
+            put_bytes(out, &action.ephemeral_key);
+            put_bytes(out, &action.enc_ciphertext);
+            put_bytes(out, &action.out_ciphertext);
+        }
+    }
+}
+
+struct Reader<'a> {
+    bytes: &'a [u8],
+}
+
+impl<'a> Reader<'a> {
+    fn take(&mut self, len: usize) -> Result<&'a [u8]> {
+        if self.bytes.len() < len {
+            return Err(Error::Storage("block pack record truncated".to_string()));
+        }
+        let (head, rest) = self.bytes.split_at(len);
+        self.bytes = rest;
+        Ok(head)
+    }
+
+    fn u8(&mut self) -> Result<u8> {
+        Ok(self.take(1)?[0])
+    }
+
+    fn u32(&mut self) -> Result<u32> {
+        let raw = self.take(4)?;
+        Ok(u32::from_le_bytes([raw[0], raw[1], raw[2], raw[3]]))
+    }
+
+    fn u64(&mut self) -> Result<u64> {
+        let mut raw = [0u8; 8];
+        raw.copy_from_slice(self.take(8)?);
+        Ok(u64::from_le_bytes(raw))
+    }
+
+    fn bytes(&mut self) -> Result<Vec<u8>> {
+        let len = self.u32()? as usize;
+        Ok(self.take(len)?.to_vec())
+    }
+
+    /// Element count, bounded by the bytes left so a corrupt record cannot
+    /// request a huge allocation.
+    fn count(&mut self) -> Result<usize> {
+        let count = self.u32()? as usize;
+        if count > self.bytes.len() {
+            return Err(Error::Storage("block pack record corrupt".to_string()));
+        }
+        Ok(count)
+    }
+}
+
+fn decode_record(height: u64, bytes: &[u8]) -> Result<CompactBlockData> {
+    let mut reader = Reader { bytes };
+    let stored_height = reader.u64()?;
+    if stored_height != height {
+        return Err(Error::Storage(format!(
+            "block pack record at {} holds height {}",
+            height, stored_height
+        )));
+    }
+    let proto_version = reader.u32()?;
+    let time = reader.u32()?;
+    let hash = reader.bytes()?;
+    let prev_hash = reader.bytes()?;
+    let header = reader.bytes()?;
+    let tx_count = reader.count()?;
+    let mut transactions = Vec::with_capacity(tx_count);
+    for _ in 0..tx_count {
+        let flags = reader.u8()?;
+        let index = reader.u64()?;
+        let fee = reader.u32()?;
+        let hash = reader.bytes()?;
+        let spend_count = reader.count()?;
+        let mut spends = Vec::with_capacity(spend_count);
+        for _ in 0..spend_count {
+            spends.push(CompactSaplingSpend {
+                nf: reader.bytes()?,
+            });
+        }
+        let output_count = reader.count()?;
+        let mut outputs = Vec::with_capacity(output_count);
+        for _ in 0..output_count {
+            outputs.push(CompactSaplingOutput {
+                cmu: reader.bytes()?,
+                ephemeral_key: reader.bytes()?,
+                ciphertext: reader.bytes()?,
+            });
+        }
+        let action_count = reader.count()?;
+        let mut actions = Vec::with_capacity(action_count);
+        for _ in 0..action_count {
+            actions.push(CompactOrchardAction {
+                nullifier: reader.bytes()?,
+                cmx: reader.bytes()?,
+                ephemeral_key: reader.bytes()?,
+                enc_ciphertext: reader.bytes()?,
+                out_ciphertext: reader.bytes()?,
+            });
+        }
+        transactions.push(CompactTx {
+            index: (flags & TX_HAS_INDEX != 0).then_some(index),
+            hash,
+            fee: (flags & TX_HAS_FEE != 0).then_some(fee),
+            spends,
+            outputs,
+            actions,
+        });
+    }
+    if !reader.bytes.is_empty() {
+        return Err(Error::Storage(format!(
+            "block pack record at {} has trailing bytes",
+            height
+        )));
+    }
+    Ok(CompactBlockData {
+        proto_version,
+        height,
+        hash,
+        prev_hash,
+        time,
+        header,
+        transactions,
+    })
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn block(height: u64) -> CompactBlockData {
+        CompactBlockData {
+            proto_version: 1,
+            height,
+            hash: vec![height as u8; 32],
+            prev_hash: vec![height.wrapping_sub(1) as u8; 32],
+            time: height as u32,
+            header: Vec::new(),
+            transactions: vec![CompactTx {
+                index: Some(0),
+                hash: vec![7; 32],
+                fee: None,
+                spends: vec![CompactSaplingSpend { nf: vec![1; 32] }],
+                outputs: vec![CompactSaplingOutput {
+                    cmu: vec![2; 32],
+                    ephemeral_key: vec![3; 32],
+                    ciphertext: vec![4; 52],
+                }],
+                actions: Vec::new(),
+            }],
+        }
+    }
+
+    #[test]
+    fn stores_loads_and_truncates_across_segments() {
+        let dir = tempfile::tempdir().unwrap();
+        let pack = BlockPack::open(dir.path().join("block_pack_test")).unwrap();
+        let base = SEGMENT_SPAN - 8;
+        let blocks: Vec<_> = (base..base + 10).map(block).collect();
+        // Later batch first, as parallel fetches can finish out of order.
+        pack.store_blocks(&blocks[5..]).unwrap();
+        pack.store_blocks(&blocks[..5]).unwrap();
+
+        let loaded = pack.load_range(base, base + 9).unwrap();
+        assert_eq!(loaded.len(), 10);
+        assert_eq!(loaded[7].height, base + 7);
+        assert_eq!(loaded[7].hash, blocks[7].hash);
+        assert_eq!(loaded[7].transactions[0].fee, None);
+        assert_eq!(loaded[7].transactions[0].outputs[0].ciphertext.len(), 52);
+
+        assert_eq!(pack.delete_above(base + 2).unwrap(), 7);
+        assert_eq!(pack.load_range(base, base + 9).unwrap().len(), 3);
+        pack.store_blocks(&[block(base + 3)]).unwrap();
+
+        // A fresh replay of the index logs sees the same state.
+        pack.segments.lock().clear();
+        let loaded = pack.load_range(base, base + 9).unwrap();
+        let heights: Vec<u64> = loaded.iter().map(|b| b.height).collect();
+        assert_eq!(heights, vec![base, base + 1, base + 2, base + 3]);
+    }
+
+    #[test]
+    fn other_handles_follow_compaction_and_removal() {
+        let dir = tempfile::tempdir().unwrap();
+        let data_path = dir.path().join("00000000.blocks");
+        let index_path = dir.path().join("00000000.index");
+        let open = || Segment::open(0, data_path.clone(), index_path.clone()).unwrap();
+        let mut writer = open();
+        writer.append(&[&block(1), &block(2)]).unwrap();
+        writer.append(&[&block(1)]).unwrap();
+        let mut reader = open();
+
+        // Compacting drops the overwritten record; one more append brings the
+        // index back to the length the reader replayed.
+        writer.compact().unwrap();
+        writer.append(&[&block(3)]).unwrap();
+        assert_eq!(writer.index_len, reader.index_len);
+        assert!(reader.index_is_stale());
+        reader.reload().unwrap();
+        let mut loaded = Vec::new();
+        reader.load_range(1, 3, &mut loaded).unwrap();
+        let heights: Vec<u64> = loaded.iter().map(|b| b.height).collect();
+        assert_eq!(heights, vec![1, 2, 3]);
+
+        std::fs::remove_file(&index_path).unwrap();
+        std::fs::remove_file(&data_path).unwrap();
+        assert!(reader.index_is_stale());
+        reader.reload().unwrap();
+        assert!(!data_path.exists() && !index_path.exists());
+        assert!(!reader.index_is_stale());
+    }
+}
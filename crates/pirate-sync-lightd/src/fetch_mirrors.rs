@@ -0,0 +1,313 @@
+//! Block range fetching spread over several lightwalletd servers.
+//!
+//! The engine's own client is endpoint 0; mirrors configured for the wallet
+//! follow it. Each prefetched range goes to the endpoint with the lowest
+//! expected finish time, estimated from a per-block latency average and the
+//! ranges it already has in flight. A range that runs well past its
+//! estimate is raced against a second endpoint and whichever answers first
+//! wins, so one slow Tor circuit or overloaded server cannot hold up the
+//! queue. A failing endpoint hands its range to the next best one at once
+//! and sits out a growing cooldown before it gets new work.
+
+use crate::cancel::CancelToken;
+use crate::client::{CompactBlockData, LightClient};
+use crate::{Error, Result};
+use parking_lot::Mutex;
+use std::future::Future;
+use std::sync::Arc;
+use std::time::{Duration, Instant};
+use tokio::task::JoinSet;
+
+/// Weight of the newest sample in the per-block latency average.
+const LATENCY_EWMA_ALPHA: f64 = 0.3;
+/// A fetch is hedged once it runs this many times over its estimate.
+const HEDGE_FACTOR: f64 = 3.0;
+const MIN_HEDGE_DELAY: Duration = Duration::from_secs(2);
+const MAX_HEDGE_DELAY: Duration = Duration::from_secs(30);
+/// Hedge delay for an endpoint nothing is known about yet.
+const UNKNOWN_HEDGE_DELAY: Duration = Duration::from_secs(15);
+const MAX_COOLDOWN: Duration = Duration::from_secs(60);
+
+#[derive(Default)]
+struct Health {
+    /// Average microseconds per fetched block.
+    us_per_block: Option<f64>,
+    in_flight: u32,
+    failures: u32,
+    cooldown_until: Option<Instant>,
+}
+
+impl Health {
+    fn cooling_down(&self, now: Instant) -> bool {
+        self.cooldown_until.is_some_and(|until| until > now)
+    }
+
+    fn observe(&mut self, us_per_block: f64) {
+        self.us_per_block = Some(match self.us_per_block {
+            Some(prev) => prev + LATENCY_EWMA_ALPHA * (us_per_block - prev),
+            None => us_per_block,
+        });
+    }
+}
+
+struct Endpoint {
+    client: LightClient,
+    health: Mutex<Health>,
+}
+
+pub(crate) struct FetchMirrors {
+    endpoints: Vec<Endpoint>,
+}
+
+impl FetchMirrors {
+    /// `primary` first, then every mirror whose URL differs from the
+    /// endpoints before it.
+    pub(crate) fn new(primary: LightClient, mirrors: Vec<LightClient>) -> Self {
+        let mut endpoints: Vec<Endpoint> = Vec::with_capacity(mirrors.len() + 1);
+        for client in std::iter::once(primary).chain(mirrors) {
+            if endpoints
+                .iter()
+                .any(|existing| existing.client.endpoint() == client.endpoint())
+            {
+                continue;
+            }
+            endpoints.push(Endpoint {
+                client,
+                health: Mutex::new(Health::default()),
+            });
+        }
+        Self { endpoints }
+    }
+
+    pub(crate) fn len(&self) -> usize {
+        self.endpoints.len()
+    }
+
+    fn best_known_us_per_block(&self) -> Option<f64> {
+        self.endpoints
+            .iter()
+            .filter_map(|endpoint| endpoint.health.lock().us_per_block)
+            .reduce(f64::min)
+    }
+
+    /// Endpoint not in `tried` with the lowest expected finish time.
+    /// Endpoints in cooldown are only used when nothing else is left.
+    fn pick(&self, tried: &[usize]) -> Option<usize> {
+        let now = Instant::now();
+        // Unmeasured endpoints are scored like the fastest one so they get
+        // tried early instead of never.
+        let fallback = self.best_known_us_per_block().unwrap_or(1.0);
+        let mut best: Option<(bool, f64, usize)> = None;
+        for (index, endpoint) in self.endpoints.iter().enumerate() {
+            if tried.contains(&index) {
+                continue;
+            }
+            let health = endpoint.health.lock();
+            let cooling = health.cooling_down(now);
+            let score =
+                f64::from(health.in_flight + 1) * health.us_per_block.unwrap_or(fallback).max(1.0);
+            let better = match best {
+                None => true,
+                Some((best_cooling, best_score, _)) => {
+                    (cooling, score) < (best_cooling, best_score)
+                }
+            };
+            if better {
+                best = Some((cooling, score, index));
+            }
+        }
+        best.map(|(_, _, index)| index)
+    }
+
+    fn hedge_delay(&self, index: usize, blocks: u64) -> Duration {
+        let own = self.endpoints[index].health.lock().us_per_block;
+        let estimate = own.or_else(|| self.best_known_us_per_block());
+        match estimate {
+            Some(us_per_block) => {
+                Duration::from_micros((us_per_block * blocks as f64 * HEDGE_FACTOR) as u64)
+                    .clamp(MIN_HEDGE_DELAY, MAX_HEDGE_DELAY)
+            }
+            None => UNKNOWN_HEDGE_DELAY,
+        }
+    }
+
+    fn record_failure(&self, index: usize) {
+        let mut health = self.endpoints[index].health.lock();
+        health.failures = health.failures.saturating_add(1);
+        let cooldown = Duration::from_secs(1u64 << health.failures.min(6)).min(MAX_COOLDOWN);
+        health.cooldown_until = Some(Instant::now() + cooldown);
+    }
+
+    /// Fetch `start..=end`, trying endpoints in order of expected finish
+    /// time. `fetch` runs the actual download (cache lookup, retries) against
+    /// one client; it is called again for each hedge or reassignment.
+    pub(crate) async fn fetch<F, Fut>(
+        self: Arc<Self>,
+        start: u64,
+        end: u64,
+        cancel: CancelToken,
+        fetch: F,
+    ) -> Result<Vec<CompactBlockData>>
+    where
+        F: Fn(LightClient) -> Fut + Send + Sync,
+        Fut: Future<Output = Result<Vec<CompactBlockData>>> + Send + 'static,
+    {
+        let blocks = end.saturating_sub(start) + 1;
+        let mut racers: JoinSet<(usize, Result<Vec<CompactBlockData>>)> = JoinSet::new();
+        let mut tried: Vec<usize> = Vec::new();
+        let mut last_error: Option<Error> = None;
+
+        let launch = |racers: &mut JoinSet<_>, tried: &mut Vec<usize>| -> Option<Instant> {
+            let index = self.pick(tried)?;
+            tried.push(index);
+            let run = fetch(self.endpoints[index].client.clone());
+            let guard = InFlight::start(self.clone(), index, blocks);
+            racers.spawn(async move {
+                let result = run.await;
+                (index, guard.finish(result))
+            });
+            Some(Instant::now() + self.hedge_delay(index, blocks))
+        };
+
+        let mut hedge_at = launch(&mut racers, &mut tried);
+
+        loop {
+            let deadline = hedge_at;
+            let hedge = async move {
+                match deadline {
+                    Some(at) => tokio::time::sleep_until(at.into()).await,
+                    None => std::future::pending().await,
+                }
+            };
+            tokio::select! {
+                _ = cancel.cancelled() => return Err(Error::Cancelled),
+                _ = hedge => {
+                    hedge_at = None;
+                    if let Some(at) = launch(&mut racers, &mut tried) {
+                        tracing::debug!(
+                            "Hedging blocks {}-{} on a second endpoint ({} tried)",
+                            start,
+                            end,
+                            tried.len()
+                        );
+                        hedge_at = Some(at);
+                    }
+                }
+                joined = racers.join_next() => {
+                    let Some(joined) = joined else {
+                        return Err(last_error.unwrap_or_else(|| {
+                            Error::Sync("no lightwalletd endpoint available".to_string())
+                        }));
+                    };
+                    let error = match joined {
+                        // Dropping `racers` aborts the fetches that lost.
+                        Ok((_, Ok(blocks))) => return Ok(blocks),
+                        Ok((_, Err(Error::Cancelled))) => return Err(Error::Cancelled),
+                        Ok((index, Err(e))) => {
+                            tracing::warn!(
+                                "Endpoint {} failed blocks {}-{}: {}",
+                                self.endpoints[index].client.endpoint(),
+                                start,
+                                end,
+                                e
+                            );
+                            e
+                        }
+                        Err(e) => Error::Sync(format!("block fetch task failed: {}", e)),
+                    };
+                    last_error = Some(error);
+                    if let Some(at) = launch(&mut racers, &mut tried) {
+                        hedge_at = Some(at);
+                    } else if racers.is_empty() {
+                        return Err(last_error.take().unwrap_or(Error::Cancelled));
+                    }
+                }
+            }
+        }
+    }
+}
+
+/// Counts a fetch against its endpoint's in-flight load. A fetch aborted
+/// because another endpoint won the race still tells us this one took at
+/// least as long as it ran.
+struct InFlight {
+    mirrors: Arc<FetchMirrors>,
+    index: usize,
+    blocks: u64,
+    started: Instant,
+    finished: bool,
+}
+
+impl InFlight {
+    fn start(mirrors: Arc<FetchMirrors>, index: usize, blocks: u64) -> Self {
+        mirrors.endpoints[index].health.lock().in_flight += 1;
+        Self {
+            mirrors,
+            index,
+            blocks,
+            started: Instant::now(),
+            finished: false,
+        }
+    }
+
+    fn us_per_block(&self) -> f64 {
+        self.started.elapsed().as_micros() as f64 / self.blocks.max(1) as f64
+    }
+
+    fn finish(mut self, result: Result<Vec<CompactBlockData>>) -> Result<Vec<CompactBlockData>> {
+        self.finished = true;
+        match &result {
+            Ok(_) => {
+                let mut health = self.mirrors.endpoints[self.index].health.lock();
+                health.observe(self.us_per_block());
+                health.failures = 0;
+                health.cooldown_until = None;
+            }
+            Err(Error::Cancelled) => {}
+            Err(_) => self.mirrors.record_failure(self.index),
+        }
+        result
+    }
+}
+
+impl Drop for InFlight {
+    fn drop(&mut self) {
+        let us_per_block = self.us_per_block();
+        let mut health = self.mirrors.endpoints[self.index].health.lock();
+        health.in_flight = health.in_flight.saturating_sub(1);
+        if !self.finished && health.us_per_block.map_or(true, |prev| prev < us_per_block) {
+            health.observe(us_per_block);
+        }
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn mirrors(urls: &[&str]) -> Arc<FetchMirrors> {
+        let mut clients = urls.iter().map(|url| LightClient::new(url.to_string()));
+        let primary = clients.next().unwrap();
+        Arc::new(FetchMirrors::new(primary, clients.collect()))
+    }
+
+    #[test]
+    fn picks_spread_load_and_skip_cooling_endpoints() {
+        let set = mirrors(&["https://a:9067", "https://b:9067", "https://a:9067"]);
+        assert_eq!(set.len(), 2);
+
+        let first = InFlight::start(set.clone(), 0, 100);
+        assert_eq!(set.pick(&[]), Some(1));
+        drop(first);
+
+        set.endpoints[0].health.lock().us_per_block = Some(10_000.0);
+        set.endpoints[1].health.lock().us_per_block = Some(1_000.0);
+        assert_eq!(set.pick(&[]), Some(1));
+
+        set.record_failure(1);
+        assert_eq!(set.pick(&[]), Some(0));
+        // A cooling endpoint is still better than none.
+        assert_eq!(set.pick(&[0]), Some(1));
+        assert_eq!(set.pick(&[0, 1]), None);
+    }
+}
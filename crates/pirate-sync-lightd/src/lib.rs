@@ -10,9 +10,11 @@
 pub mod background;
 pub mod background_logger;
 mod block_cache;
+mod block_pack;
 pub mod cancel;
 pub mod client;
 pub mod error;
+mod fetch_mirrors;
 pub mod orchard;
 pub mod pipeline;
 pub mod privacy;
@@ -26,6 +28,7 @@ pub use background::{
     BackgroundSyncConfig, BackgroundSyncMode, BackgroundSyncOrchestrator, BackgroundSyncResult,
 };
 pub use background_logger::{BackgroundSyncEvent, BackgroundSyncLogger};
+pub use block_cache::prewarm_indices as prewarm_block_cache_indices;
 pub use cancel::CancelToken;
 pub use client::{
     bootstrap_transport, fetch_spki_pin, i2p_status, rotate_tor_exit, shutdown_transport,
@@ -37,16 +40,17 @@ pub use client::{
 };
 pub use error::{Error, Result};
 pub use pipeline::{
-    DecryptedNote, PerfCounters, PerfSnapshot, PipelineConfig, PipelineResult, SyncPipeline,
-    MINI_CHECKPOINT_INTERVAL, PIPELINE_BATCH_SIZE,
+    DecryptStageTimings, DecryptedNote, PerfCounters, PerfSnapshot, PipelineConfig, PipelineResult,
+    SyncPipeline, MINI_CHECKPOINT_INTERVAL, PIPELINE_BATCH_SIZE,
 };
 pub use pirate_net::{I2pStatus, TorStatus};
 pub use privacy::{BackgroundSyncTunnelGuard, TunnelConfig, TunnelManager};
 pub use progress::{PerfCountersSnapshot, SyncProgress, SyncStage};
 pub use sync::{SyncConfig, SyncEngine};
 pub use sync_profile::{
-    begin_sync_profile_session, detect_device_snapshot, detect_sync_profile,
-    record_sync_profile_failure, record_sync_profile_success, sync_config_for_detected_device,
-    sync_config_for_profile, SyncDeviceClass, SyncDeviceSnapshot, SyncProfileSelection,
-    SyncWorkload,
+    begin_sync_profile_session, current_sync_power_profile, detect_device_snapshot,
+    detect_sync_profile, fair_share_parallel_decrypt, record_sync_profile_failure,
+    record_sync_profile_success, set_priority_sync_wallet, set_sync_power_state,
+    sync_config_for_detected_device, sync_config_for_profile, SyncDeviceClass, SyncDeviceSnapshot,
+    SyncPowerProfile, SyncPowerState, SyncProfileSelection, SyncWorkload,
 };
@@ -11,6 +11,7 @@
 //! - blocks_per_second
 //! - notes_decrypted
 //! - last_batch_ms
+//! - per-stage trial decryption throughput (flatten, decrypt, per-core)
 
 use crate::client::{CompactBlockData, LightClient};
 use crate::sapling::trial_decrypt::try_decrypt_compact_output;
@@ -48,6 +49,44 @@ pub struct PerfCounters {
     pub total_time_ms: AtomicU64,
     /// Number of batches processed
     pub batches_processed: AtomicU64,
+    /// Sapling outputs trial-decrypted
+    pub sapling_outputs_scanned: AtomicU64,
+    /// Orchard actions trial-decrypted
+    pub orchard_actions_scanned: AtomicU64,
+    /// Wall time spent flattening batches for decryption, in microseconds
+    pub flatten_us: AtomicU64,
+    /// Wall time spent in trial decryption, in microseconds
+    pub decrypt_us: AtomicU64,
+    /// Worker time spent on Sapling outputs, in microseconds
+    pub sapling_decrypt_cpu_us: AtomicU64,
+    /// Worker time spent on Orchard actions, in microseconds
+    pub orchard_decrypt_cpu_us: AtomicU64,
+}
+
+/// Stage timings of one trial-decryption batch
+#[derive(Debug, Default, Clone, Copy)]
+pub struct DecryptStageTimings {
+    /// Sapling outputs in the batch
+    pub sapling_outputs: u64,
+    /// Orchard actions in the batch
+    pub orchard_actions: u64,
+    /// Wall time flattening blocks into decryption inputs
+    pub flatten_us: u64,
+    /// Wall time of the decryption stage
+    pub decrypt_us: u64,
+    /// Summed worker time on Sapling outputs
+    pub sapling_cpu_us: u64,
+    /// Summed worker time on Orchard actions
+    pub orchard_cpu_us: u64,
+}
+
+/// Items per second given a count and microseconds, 0 before any time is
+/// recorded.
+fn per_second(items: u64, us: u64) -> f64 {
+    if us == 0 {
+        return 0.0;
+    }
+    items as f64 / (us as f64 / 1_000_000.0)
 }
 
 impl PerfCounters {
@@ -87,8 +126,26 @@ impl PerfCounters {
         self.batches_processed.fetch_add(1, Ordering::Relaxed);
     }
 
+    /// Record the stage timings of a trial-decryption batch
+    pub fn record_trial_decrypt(&self, stages: &DecryptStageTimings) {
+        self.sapling_outputs_scanned
+            .fetch_add(stages.sapling_outputs, Ordering::Relaxed);
+        self.orchard_actions_scanned
+            .fetch_add(stages.orchard_actions, Ordering::Relaxed);
+        self.flatten_us
+            .fetch_add(stages.flatten_us, Ordering::Relaxed);
+        self.decrypt_us
+            .fetch_add(stages.decrypt_us, Ordering::Relaxed);
+        self.sapling_decrypt_cpu_us
+            .fetch_add(stages.sapling_cpu_us, Ordering::Relaxed);
+        self.orchard_decrypt_cpu_us
+            .fetch_add(stages.orchard_cpu_us, Ordering::Relaxed);
+    }
+
     /// Get snapshot of counters
     pub fn snapshot(&self) -> PerfSnapshot {
+        let sapling = self.sapling_outputs_scanned.load(Ordering::Relaxed);
+        let orchard = self.orchard_actions_scanned.load(Ordering::Relaxed);
         PerfSnapshot {
             blocks_processed: self.blocks_processed.load(Ordering::Relaxed),
             notes_decrypted: self.notes_decrypted.load(Ordering::Relaxed),
@@ -96,6 +153,22 @@ impl PerfCounters {
             last_batch_ms: self.last_batch_ms.load(Ordering::Relaxed),
             blocks_per_second: self.blocks_per_second(),
             avg_batch_ms: self.avg_batch_ms(),
+            flatten_outputs_per_second: per_second(
+                sapling + orchard,
+                self.flatten_us.load(Ordering::Relaxed),
+            ),
+            decrypt_outputs_per_second: per_second(
+                sapling + orchard,
+                self.decrypt_us.load(Ordering::Relaxed),
+            ),
+            sapling_outputs_per_core_second: per_second(
+                sapling,
+                self.sapling_decrypt_cpu_us.load(Ordering::Relaxed),
+            ),
+            orchard_actions_per_core_second: per_second(
+                orchard,
+                self.orchard_decrypt_cpu_us.load(Ordering::Relaxed),
+            ),
         }
     }
 
@@ -107,6 +180,12 @@ impl PerfCounters {
         self.last_batch_ms.store(0, Ordering::Relaxed);
         self.total_time_ms.store(0, Ordering::Relaxed);
         self.batches_processed.store(0, Ordering::Relaxed);
+        self.sapling_outputs_scanned.store(0, Ordering::Relaxed);
+        self.orchard_actions_scanned.store(0, Ordering::Relaxed);
+        self.flatten_us.store(0, Ordering::Relaxed);
+        self.decrypt_us.store(0, Ordering::Relaxed);
+        self.sapling_decrypt_cpu_us.store(0, Ordering::Relaxed);
+        self.orchard_decrypt_cpu_us.store(0, Ordering::Relaxed);
     }
 }
 
@@ -125,6 +204,14 @@ pub struct PerfSnapshot {
     pub blocks_per_second: f64,
     /// Average batch time in ms
     pub avg_batch_ms: u64,
+    /// Outputs and actions flattened per second
+    pub flatten_outputs_per_second: f64,
+    /// Outputs and actions trial-decrypted per second of wall time
+    pub decrypt_outputs_per_second: f64,
+    /// Sapling outputs trial-decrypted per second of one worker
+    pub sapling_outputs_per_core_second: f64,
+    /// Orchard actions trial-decrypted per second of one worker
+    pub orchard_actions_per_core_second: f64,
 }
 
 /// Note type (Sapling or Orchard)
@@ -682,6 +769,28 @@ mod tests {
         assert_eq!(counters.avg_batch_ms(), 900); // (1000+800)/2
     }
 
+    #[test]
+    fn test_perf_counters_decrypt_stages() {
+        let counters = PerfCounters::new();
+        counters.record_trial_decrypt(&DecryptStageTimings {
+            sapling_outputs: 3_000,
+            orchard_actions: 1_000,
+            flatten_us: 2_000,
+            decrypt_us: 500_000,
+            sapling_cpu_us: 1_500_000,
+            orchard_cpu_us: 1_000_000,
+        });
+
+        let snapshot = counters.snapshot();
+        assert_eq!(snapshot.flatten_outputs_per_second, 2_000_000.0);
+        assert_eq!(snapshot.decrypt_outputs_per_second, 8_000.0);
+        assert_eq!(snapshot.sapling_outputs_per_core_second, 2_000.0);
+        assert_eq!(snapshot.orchard_actions_per_core_second, 1_000.0);
+
+        counters.reset();
+        assert_eq!(counters.snapshot().decrypt_outputs_per_second, 0.0);
+    }
+
     #[test]
     fn test_lazy_memo_decode() {
         let mut note = DecryptedNote::new(
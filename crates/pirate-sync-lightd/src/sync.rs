@@ -11,11 +11,13 @@
 
 use crate::block_cache::{acquire_inflight, BlockCache, InflightLease};
 use crate::client::{CompactBlockData, TransportMode};
+use crate::fetch_mirrors::FetchMirrors;
 use crate::orchard::full_decrypt::decrypt_orchard_memo_from_raw_tx_with_ivk_bytes;
 use crate::pipeline::NoteType;
-use crate::pipeline::{DecryptedNote, OrchardDecryptedNoteInit, PerfCounters};
+use crate::pipeline::{DecryptStageTimings, DecryptedNote, OrchardDecryptedNoteInit, PerfCounters};
 use crate::progress::SyncStage;
 use crate::sapling::full_decrypt::decrypt_memo_from_raw_tx_with_ivk_bytes;
+use crate::sync_profile::{current_sync_power_profile, fair_share_parallel_decrypt};
 use crate::{CancelToken, Error, LightClient, Result, SyncProgress};
 use directories::ProjectDirs;
 use group::ff::PrimeField;
@@ -40,6 +42,7 @@ use pirate_core::keys::{
     OrchardExtendedSpendingKey, OrchardPaymentAddress as PirateOrchardPaymentAddress,
     PaymentAddress as PiratePaymentAddress,
 };
+use pirate_core::memory_budget::{self, MemoryCharge, MemoryConsumer};
 use pirate_core::transaction::PirateNetwork;
 use pirate_params::consensus::ConsensusParams;
 use pirate_params::{Network as PirateParamsNetwork, NetworkType};
@@ -66,6 +69,7 @@ use std::collections::{HashMap, HashSet, VecDeque};
 use std::env;
 use std::io::Cursor;
 use std::path::{Path, PathBuf};
+use std::sync::atomic::{AtomicUsize, Ordering};
 use std::sync::{Arc, OnceLock};
 use std::time::{Duration, Instant};
 use subtle::CtOption;
@@ -255,6 +259,9 @@ const MAX_RETRY_ATTEMPTS: u32 = 3;
 const RETRY_BACKOFF_MS: u64 = 100;
 // BridgeTree snapshot retention removed -- ShardTree is persistent in SQLite.
 const MIN_PARALLEL_OUTPUTS: usize = 256;
+/// Trial-decryption chunks queued per worker, so faster workers can take
+/// over the tail of a batch.
+const DECRYPT_CHUNKS_PER_WORKER: usize = 4;
 const SPENDABILITY_REASON_ERR_WITNESS_REPAIR_QUEUED: &str = "ERR_WITNESS_REPAIR_QUEUED";
 const SPENDABILITY_MIN_CONFIRMATIONS: u32 = 1;
 const LOW_HEIGHT_BATCH_CAP_HEIGHT: u64 = 10_000;
@@ -373,6 +380,8 @@ pub struct SyncEngine {
     enrich_semaphore: Arc<tokio::sync::Semaphore>,
     /// Last tip height where queue-based witness integrity check completed.
     last_witness_check_height: Arc<RwLock<u64>>,
+    /// Extra lightwalletd servers prefetched ranges are spread over
+    fetch_mirrors: Option<Arc<FetchMirrors>>,
 }
 
 struct PrefetchTask {
@@ -380,6 +389,8 @@ struct PrefetchTask {
     end: u64,
     estimated_bytes: u64,
     handle: tokio::task::JoinHandle<Result<Vec<CompactBlockData>>>,
+    /// Prefetch share of the memory budget, held until the batch is scanned.
+    memory: MemoryCharge,
 }
 
 struct ServerBatchHintTask {
@@ -483,6 +494,7 @@ impl SyncEngine {
             cancel: CancelToken::new(),
             enrich_semaphore: Arc::new(tokio::sync::Semaphore::new(enrich_limit)),
             last_witness_check_height: Arc::new(RwLock::new(0)),
+            fetch_mirrors: None,
         }
     }
 
@@ -494,7 +506,7 @@ impl SyncEngine {
             Some(s) => s.clone(),
             None => return Ok(()),
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let repo = Repository::new(&db);
         let notes = repo.get_spend_reconciliation_notes(sink.account_id)?;
         let mut loaded = 0u64;
@@ -579,6 +591,7 @@ impl SyncEngine {
             cancel: CancelToken::new(),
             enrich_semaphore: Arc::new(tokio::sync::Semaphore::new(enrich_limit)),
             last_witness_check_height: Arc::new(RwLock::new(0)),
+            fetch_mirrors: None,
         }
     }
 
@@ -615,9 +628,19 @@ impl SyncEngine {
             cancel: CancelToken::new(),
             enrich_semaphore: Arc::new(tokio::sync::Semaphore::new(enrich_limit)),
             last_witness_check_height: Arc::new(RwLock::new(0)),
+            fetch_mirrors: None,
         }
     }
 
+    /// Spread prefetched block ranges over `mirrors` as well as the engine's
+    /// own client. Mirrors must serve the same chain; they connect on first
+    /// use. Passing none keeps single-endpoint fetching.
+    pub fn with_fetch_mirrors(mut self, mirrors: Vec<LightClient>) -> Self {
+        let mirrors = FetchMirrors::new(self.client.clone(), mirrors);
+        self.fetch_mirrors = (mirrors.len() > 1).then(|| Arc::new(mirrors));
+        self
+    }
+
     /// Get performance counters reference
     pub fn perf_counters(&self) -> Arc<PerfCounters> {
         Arc::clone(&self.perf)
@@ -675,7 +698,8 @@ impl SyncEngine {
         self.wallet_id = Some(wallet_id.clone());
         self.network_type = network_type;
 
-        let db = Database::open(&db_path, &key, master_key.clone())?;
+        // Keep the migrated handle for the pooled opens that follow.
+        let db = Database::open(&db_path, &key, master_key.clone())?.into_pooled(&db_path, &key);
         let repo = Repository::new(&db);
 
         // Load wallet secret to know account id (if present)
@@ -801,8 +825,7 @@ impl SyncEngine {
 
         if let Some(ref sink) = self.storage {
             let stored_height = {
-                let db =
-                    Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+                let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
                 let sync_state = SyncStateStorage::new(&db).load_sync_state()?;
                 sync_state.local_height
             };
@@ -981,7 +1004,7 @@ impl SyncEngine {
             Some(s) => s,
             None => return Ok(None),
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let repo = Repository::new(&db);
         let (_spendable, _pending, total) =
             repo.calculate_balance(sink.account_id, current_height, min_depth)?;
@@ -1000,7 +1023,7 @@ impl SyncEngine {
             Some(s) => s,
             None => return Ok(None),
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let repo = Repository::new(&db);
         let txs = repo.get_transactions(sink.account_id, None, current_height, 0)?;
         let count = txs
@@ -1249,7 +1272,7 @@ impl SyncEngine {
         let Some(sink) = self.storage.as_ref() else {
             return Ok(false);
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let height_u32 = u32::try_from(height).unwrap_or(u32::MAX);
         let has: bool = db
             .conn()
@@ -1409,7 +1432,7 @@ impl SyncEngine {
         let Some(sink) = self.storage.as_ref() else {
             return Ok(());
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let tx = db.conn().unchecked_transaction().map_err(|e| {
             Error::Sync(format!("Failed to start shardtree seed transaction: {}", e))
         })?;
@@ -1513,7 +1536,7 @@ impl SyncEngine {
         let Some(sink) = self.storage.as_ref() else {
             return Ok(());
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let conn = db.conn();
 
         let sapling_pos: Option<i64> = conn
@@ -1594,8 +1617,8 @@ impl SyncEngine {
         let db = if let Some(db) = db_session {
             db
         } else {
-            owned_db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
-            &owned_db
+            owned_db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
+            &*owned_db
         };
         let repo = Repository::new(db);
         let spendability = SpendabilityStateStorage::new(db);
@@ -1813,7 +1836,7 @@ impl SyncEngine {
             Some(s) => s,
             None => return Ok(None),
         };
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let scan_queue = ScanQueueStorage::new(&db);
         let spendability = SpendabilityStateStorage::new(&db);
         let Some(row) = scan_queue.next_found_note_range()? else {
@@ -2268,7 +2291,7 @@ impl SyncEngine {
         follow_tip: bool,
     ) -> Result<()> {
         let run_db = match self.storage.as_ref() {
-            Some(sink) => Some(Database::open_existing(
+            Some(sink) => Some(Database::open_pooled(
                 &sink.db_path,
                 &sink.key,
                 sink.master_key.clone(),
@@ -2308,7 +2331,7 @@ impl SyncEngine {
         let mut last_sync_state_flush = Instant::now();
         // Resume deterministic FoundNote repairs queued by previous runs.
         if follow_tip {
-            if let Some(db) = run_db.as_ref() {
+            if let Some(db) = run_db.as_deref() {
                 let scan_queue = ScanQueueStorage::new(db);
                 if let Ok(Some(row)) = scan_queue.next_found_note_range() {
                     if row.status == "pending" {
@@ -2348,7 +2371,7 @@ impl SyncEngine {
             }
         }
 
-        if let Some(db) = run_db.as_ref() {
+        if let Some(db) = run_db.as_deref() {
             let sapling_position = *self.sapling_tree_position.read().await;
             let orchard_position = *self.orchard_tree_position.read().await;
             historical_prefill_state = Some(
@@ -2434,7 +2457,7 @@ impl SyncEngine {
         // reflects the current known local range immediately, even before the
         // first periodic sync-state flush.
         if self.storage.is_some() {
-            if let Some(db) = run_db.as_ref() {
+            if let Some(db) = run_db.as_deref() {
                 let scan_queue = ScanQueueStorage::new(db);
                 let historic_start = (self.birthday_height as u64).max(1);
                 let historic_end = current_height
@@ -2523,6 +2546,21 @@ impl SyncEngine {
                     return Err(Error::Cancelled);
                 }
 
+                // Back off while the desktop runner reports battery, a hidden
+                // window or a locked session.
+                let power_profile = current_sync_power_profile();
+                let batch_pause = power_profile.batch_pause();
+                if !batch_pause.is_zero() {
+                    tokio::select! {
+                        _ = tokio::time::sleep(batch_pause) => {},
+                        _ = self.cancel.cancelled() => {
+                            Self::abort_prefetch_queue(&mut prefetch_queue, &mut queued_prefetch_bytes);
+                            Self::abort_pending_server_batch_hint(&mut pending_server_group_hint);
+                            return Err(Error::Cancelled);
+                        }
+                    }
+                }
+
                 let batch_start_time = Instant::now();
                 let mut persist_ms: u128 = 0;
                 let mut apply_spends_ms: u128 = 0;
@@ -2539,7 +2577,7 @@ impl SyncEngine {
                     BatchTuning {
                         target_bytes: current_target_bytes,
                         avg_block_size_estimate,
-                        max_batch_blocks: current_max_batch_blocks,
+                        max_batch_blocks: power_profile.max_batch_blocks(current_max_batch_blocks),
                     },
                     (&mut server_group_end_hint, &mut pending_server_group_hint),
                 )
@@ -2551,6 +2589,7 @@ impl SyncEngine {
                     end: batch_end,
                     estimated_bytes,
                     handle,
+                    memory: prefetch_memory,
                 } = prefetch_queue.pop_front().ok_or_else(|| {
                     Error::Sync(format!(
                         "Prefetch queue unexpectedly empty at height {}",
@@ -2875,6 +2914,11 @@ impl SyncEngine {
                     .sum();
                 let avg_block_size = total_block_size / blocks.len().max(1) as u64;
                 avg_block_size_estimate = avg_block_size.max(1);
+                // The fetched blocks now belong to this batch rather than the
+                // prefetch queue; charge them where the scan will hold them.
+                drop(prefetch_memory);
+                let _batch_memory =
+                    memory_budget::charge(MemoryConsumer::SyncBatch, total_block_size);
                 let is_heavy_batch = avg_block_size > self.config.heavy_block_threshold_bytes;
 
                 if is_heavy_batch {
@@ -2929,7 +2973,7 @@ impl SyncEngine {
                     BatchTuning {
                         target_bytes: current_target_bytes,
                         avg_block_size_estimate,
-                        max_batch_blocks: current_max_batch_blocks,
+                        max_batch_blocks: power_profile.max_batch_blocks(current_max_batch_blocks),
                     },
                     (&mut server_group_end_hint, &mut pending_server_group_hint),
                 )
@@ -3147,7 +3191,7 @@ impl SyncEngine {
                         }
                         tx_meta_prepare_ms = tx_meta_prepare_start.elapsed().as_millis();
 
-                        let persist_result = if let Some(db) = run_db.as_ref() {
+                        let persist_result = if let Some(db) = run_db.as_deref() {
                             sink.persist_notes_with_db(
                                 db,
                                 &notes,
@@ -3206,7 +3250,7 @@ impl SyncEngine {
                     }
                     // #endregion
                     let apply_start = Instant::now();
-                    self.apply_spends(&blocks, run_db.as_ref()).await?;
+                    self.apply_spends(&blocks, run_db.as_deref()).await?;
                     apply_spends_ms = apply_start.elapsed().as_millis();
                     // #region agent log
                     if verbose_sync_batch_logging_enabled() {
@@ -3223,7 +3267,7 @@ impl SyncEngine {
                     // #endregion
                 }
 
-                if let (Some(sink), Some(db)) = (self.storage.as_ref(), run_db.as_ref()) {
+                if let (Some(sink), Some(db)) = (self.storage.as_ref(), run_db.as_deref()) {
                     sink.save_chain_blocks_with_db(db, &blocks)?;
                 }
 
@@ -3371,7 +3415,7 @@ impl SyncEngine {
                     || last_sync_state_flush.elapsed().as_millis()
                         >= self.config.sync_state_flush_interval_ms as u128;
                 let sync_state_ms = if should_flush_sync_state {
-                    if let (Some(db), Some(trees)) = (run_db.as_ref(), warm_trees.take()) {
+                    if let (Some(db), Some(trees)) = (run_db.as_deref(), warm_trees.take()) {
                         warm_trees = Some(trees.flush_and_reload(db.conn())?);
                     }
                     let include_aux_state_update = aux_state.as_ref().is_some_and(|aux| {
@@ -3388,7 +3432,7 @@ impl SyncEngine {
                         end,
                         last_checkpoint_height,
                         include_aux_state_update,
-                        run_db.as_ref(),
+                        run_db.as_deref(),
                     )
                     .await?;
                     let elapsed_ms = sync_state_start.elapsed().as_millis();
@@ -3493,7 +3537,7 @@ impl SyncEngine {
                         {
                             Ok(()) => {
                                 if let (Some(db), Some(trees)) =
-                                    (run_db.as_ref(), warm_trees.take())
+                                    (run_db.as_deref(), warm_trees.take())
                                 {
                                     warm_trees = Some(trees.flush_and_reload(db.conn())?);
                                 }
@@ -3512,7 +3556,7 @@ impl SyncEngine {
                     }
 
                     match self
-                        .check_witnesses_and_queue_rescans(tip_height, run_db.as_ref())
+                        .check_witnesses_and_queue_rescans(tip_height, run_db.as_deref())
                         .await
                     {
                         Ok(Some((repair_from_height, repair_end_exclusive))) => {
@@ -3574,7 +3618,7 @@ impl SyncEngine {
                         end,
                         e
                     );
-                } else if let (Some(db), Some(trees)) = (run_db.as_ref(), warm_trees.take()) {
+                } else if let (Some(db), Some(trees)) = (run_db.as_deref(), warm_trees.take()) {
                     warm_trees = Some(trees.flush_and_reload(db.conn())?);
                 }
                 match self
@@ -3630,7 +3674,7 @@ impl SyncEngine {
             if current > last_checkpoint_height {
                 match self.create_checkpoint(current, warm_trees.as_mut()).await {
                     Ok(()) => {
-                        if let (Some(db), Some(trees)) = (run_db.as_ref(), warm_trees.take()) {
+                        if let (Some(db), Some(trees)) = (run_db.as_deref(), warm_trees.take()) {
                             warm_trees = Some(trees.flush_and_reload(db.conn())?);
                         }
                         last_checkpoint_height = current;
@@ -3648,7 +3692,7 @@ impl SyncEngine {
             }
 
             match self
-                .check_witnesses_and_queue_rescans(current, run_db.as_ref())
+                .check_witnesses_and_queue_rescans(current, run_db.as_deref())
                 .await
             {
                 Ok(Some((repair_from_height, repair_end_exclusive))) => {
@@ -3870,12 +3914,42 @@ impl SyncEngine {
         }
     }
 
+    /// Fetch from a mirror client, connecting it the first time it is used.
+    /// Blocks are cached and deduplicated under `cache_endpoint`, the
+    /// wallet's primary endpoint, so every mirror fills the one cache sync
+    /// reads from.
+    async fn fetch_blocks_from_endpoint(
+        client: LightClient,
+        cache_endpoint: String,
+        start: u64,
+        end: u64,
+        cancel: CancelToken,
+        wallet_id: Option<String>,
+    ) -> Result<Vec<CompactBlockData>> {
+        if !client.is_connected() {
+            client.connect().await?;
+        }
+        Self::fetch_blocks_cached(client, &cache_endpoint, start, end, cancel, wallet_id).await
+    }
+
     async fn fetch_blocks_with_retry_inner(
         client: LightClient,
         start: u64,
         end: u64,
         cancel: CancelToken,
         wallet_id: Option<String>,
+    ) -> Result<Vec<CompactBlockData>> {
+        let cache_endpoint = client.endpoint().to_string();
+        Self::fetch_blocks_cached(client, &cache_endpoint, start, end, cancel, wallet_id).await
+    }
+
+    async fn fetch_blocks_cached(
+        client: LightClient,
+        cache_endpoint: &str,
+        start: u64,
+        end: u64,
+        cancel: CancelToken,
+        wallet_id: Option<String>,
     ) -> Result<Vec<CompactBlockData>> {
         if start > end {
             return Ok(Vec::new());
@@ -3887,9 +3961,18 @@ impl SyncEngine {
 
         let expected_blocks = end.saturating_sub(start).saturating_add(1) as usize;
 
-        if let Ok(cache) = BlockCache::for_endpoint(client.endpoint()) {
-            match cache.load_range(start, end) {
-                Ok(blocks) if blocks.len() == expected_blocks => {
+        if let Ok(cache) = BlockCache::for_endpoint(cache_endpoint) {
+            // Count first so a partly cached range is not decoded only to be
+            // fetched again.
+            let cached = match cache.count_range(start, end) {
+                Ok(count) if count == expected_blocks => {
+                    cache.load_range(start, end).map(|blocks| (count, blocks))
+                }
+                Ok(count) => Ok((count, Vec::new())),
+                Err(e) => Err(e),
+            };
+            match cached {
+                Ok((_, blocks)) if blocks.len() == expected_blocks => {
                     tracing::debug!(
                         "Block cache hit for {}-{} ({} blocks)",
                         start,
@@ -3917,12 +4000,12 @@ impl SyncEngine {
                         return Ok(blocks);
                     }
                 }
-                Ok(blocks) if !blocks.is_empty() => {
+                Ok((count, _)) if count > 0 => {
                     tracing::debug!(
                         "Block cache partial hit for {}-{} ({} of {})",
                         start,
                         end,
-                        blocks.len(),
+                        count,
                         expected_blocks
                     );
                     if verbose_sync_batch_logging_enabled() {
@@ -3933,12 +4016,7 @@ impl SyncEngine {
                         let id = format!("{:08x}", ts);
                         append_debug_log_line(&format!(
                             r#"{{"id":"log_{}","timestamp":{},"location":"sync.rs:block_cache","message":"block cache partial","data":{{"start":{},"end":{},"blocks":{},"expected":{}}},"sessionId":"debug-session","runId":"run1","hypothesisId":"B"}}"#,
-                            id,
-                            ts,
-                            start,
-                            end,
-                            blocks.len(),
-                            expected_blocks
+                            id, ts, start, end, count, expected_blocks
                         ));
                     }
                 }
@@ -3961,7 +4039,7 @@ impl SyncEngine {
         }
 
         loop {
-            let inflight = acquire_inflight(client.endpoint(), start, end);
+            let inflight = acquire_inflight(cache_endpoint, start, end);
 
             match inflight {
                 InflightLease::Follower(notify) => {
@@ -3969,8 +4047,14 @@ impl SyncEngine {
                         _ = notify.notified() => {}
                         _ = cancel.cancelled() => return Err(Error::Cancelled),
                     }
-                    if let Ok(cache) = BlockCache::for_endpoint(client.endpoint()) {
-                        if let Ok(blocks) = cache.load_range(start, end) {
+                    if let Ok(cache) = BlockCache::for_endpoint(cache_endpoint) {
+                        let complete = cache
+                            .count_range(start, end)
+                            .is_ok_and(|count| count == expected_blocks);
+                        if let Some(blocks) = complete
+                            .then(|| cache.load_range(start, end).ok())
+                            .flatten()
+                        {
                             if blocks.len() == expected_blocks
                                 && Self::cached_blocks_are_canonical(
                                     &client, &cache, start, end, &blocks,
@@ -4007,7 +4091,7 @@ impl SyncEngine {
 
                         match fetch {
                             Ok(blocks) => {
-                                if let Ok(cache) = BlockCache::for_endpoint(client.endpoint()) {
+                                if let Ok(cache) = BlockCache::for_endpoint(cache_endpoint) {
                                     if let Err(e) = cache.store_blocks(&blocks) {
                                         tracing::debug!(
                                             "Block cache store failed for {}-{}: {}",
@@ -4158,8 +4242,13 @@ impl SyncEngine {
             orchard_scopes: &orchard_scopes,
             orchard_fvks: &orchard_fvks,
             decrypt_pool: self.decrypt_pool.as_ref(),
-            max_parallel: self.config.max_parallel_decrypt,
+            max_parallel: fair_share_parallel_decrypt(
+                current_sync_power_profile().max_parallel_decrypt(self.config.max_parallel_decrypt),
+                self.wallet_id.as_deref(),
+            ),
         })?;
+        self.perf
+            .record_trial_decrypt(&decrypt_result.telemetry.stages);
         let all_notes = decrypt_result.notes;
 
         if verbose_sync_batch_logging_enabled() || !all_notes.is_empty() {
@@ -4198,14 +4287,34 @@ impl SyncEngine {
         let client = self.client.clone();
         let cancel = self.cancel.clone();
         let wallet_id = self.wallet_id.clone();
-        let handle = tokio::spawn(async move {
-            SyncEngine::fetch_blocks_with_retry_inner(client, start, end, cancel, wallet_id).await
-        });
+        let handle = match self.fetch_mirrors.clone() {
+            Some(mirrors) => tokio::spawn(async move {
+                let inner_cancel = cancel.clone();
+                let cache_endpoint = client.endpoint().to_string();
+                mirrors
+                    .fetch(start, end, cancel, move |client| {
+                        SyncEngine::fetch_blocks_from_endpoint(
+                            client,
+                            cache_endpoint.clone(),
+                            start,
+                            end,
+                            inner_cancel.clone(),
+                            wallet_id.clone(),
+                        )
+                    })
+                    .await
+            }),
+            None => tokio::spawn(async move {
+                SyncEngine::fetch_blocks_with_retry_inner(client, start, end, cancel, wallet_id)
+                    .await
+            }),
+        };
         PrefetchTask {
             start,
             end,
             estimated_bytes,
             handle,
+            memory: memory_budget::charge(MemoryConsumer::Prefetch, estimated_bytes),
         }
     }
 
@@ -4285,8 +4394,17 @@ impl SyncEngine {
             return Ok(());
         }
 
-        let max_depth = self.config.prefetch_queue_depth.max(1);
-        let max_bytes = self.config.prefetch_queue_max_bytes.max(1);
+        // Keep at least one range in flight per endpoint.
+        let max_depth = self.config.prefetch_queue_depth.max(
+            self.fetch_mirrors
+                .as_ref()
+                .map_or(1, |mirrors| mirrors.len()),
+        );
+        let max_bytes = memory_budget::cap_to_budget(
+            MemoryConsumer::Prefetch,
+            self.config.prefetch_queue_max_bytes,
+        )
+        .max(1);
         let mut next_start = prefetch_queue
             .back()
             .map(|task| task.end.saturating_add(1))
@@ -4338,6 +4456,19 @@ impl SyncEngine {
         Ok(())
     }
 
+    /// Compact bytes one batch may hold: the configured cap, lowered to the
+    /// sync share of the memory budget when one is set. Decrypted notes,
+    /// commitments and tree updates roughly double a batch while it is
+    /// scanned, so only half the share goes to the blocks themselves.
+    fn batch_memory_cap(&self) -> Option<u64> {
+        let budget_cap = memory_budget::consumer_limit(MemoryConsumer::SyncBatch)
+            .map(|limit| (limit / 2).max(self.config.min_batch_bytes));
+        match (self.config.max_batch_memory_bytes, budget_cap) {
+            (Some(configured), Some(budget)) => Some(configured.min(budget)),
+            (configured, budget) => configured.or(budget),
+        }
+    }
+
     async fn compute_batch_end(
         &self,
         current_height: u64,
@@ -4349,7 +4480,8 @@ impl SyncEngine {
         let mut target_bytes = batch_tuning
             .target_bytes
             .clamp(self.config.min_batch_bytes, self.config.max_batch_bytes);
-        if let Some(max_memory) = self.config.max_batch_memory_bytes {
+        let batch_memory_cap = self.batch_memory_cap();
+        if let Some(max_memory) = batch_memory_cap {
             target_bytes = target_bytes.min(max_memory);
         }
 
@@ -4363,7 +4495,7 @@ impl SyncEngine {
             .max(self.config.min_batch_size)
             .min(self.config.max_batch_size);
         let mut min_batch_blocks = self.config.min_batch_size.max(1).min(max_batch_blocks);
-        if let Some(max_memory) = self.config.max_batch_memory_bytes {
+        if let Some(max_memory) = batch_memory_cap {
             let memory_safe_blocks = (max_memory / estimated_block_bytes).max(1);
             max_batch_blocks = max_batch_blocks.min(memory_safe_blocks);
             min_batch_blocks = min_batch_blocks.min(max_batch_blocks);
@@ -4607,8 +4739,7 @@ impl SyncEngine {
         let mut fallback_group = keys.first().cloned();
         if fallback_group.is_none() {
             let secret = {
-                let db =
-                    Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+                let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
                 let repo = Repository::new(&db);
                 let wallet_id = wallet_id
                     .as_ref()
@@ -5204,8 +5335,7 @@ impl SyncEngine {
 
         if orchard_ivk_bytes.is_none() {
             let secret = {
-                let db =
-                    Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+                let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
                 let repo = Repository::new(&db);
                 let wallet_id = self
                     .wallet_id
@@ -5608,7 +5738,7 @@ impl SyncEngine {
             return Ok(ShardtreePersistResult::default());
         };
 
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let tx = db
             .conn()
             .unchecked_transaction()
@@ -6239,8 +6369,8 @@ impl SyncEngine {
         let db = if let Some(db) = db {
             db
         } else {
-            owned_db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
-            &owned_db
+            owned_db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
+            &*owned_db
         };
         let repo = Repository::new(db);
         let notes = repo.get_spend_reconciliation_notes(sink.account_id)?;
@@ -6389,8 +6519,8 @@ impl SyncEngine {
         let db = if let Some(db) = db {
             db
         } else {
-            owned_db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
-            &owned_db
+            owned_db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
+            &*owned_db
         };
         let repo = Repository::new(db);
         let notes = repo.get_spend_reconciliation_notes(sink.account_id)?;
@@ -6506,7 +6636,7 @@ impl SyncEngine {
     /// Get current Sapling anchor from the ShardTree, if available.
     pub fn get_sapling_anchor_from_shardtree(&self) -> Option<[u8; 32]> {
         let sink = self.storage.as_ref()?;
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone()).ok()?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone()).ok()?;
         let repo = Repository::new(&db);
         let spendability = SpendabilityStateStorage::new(&db);
         let anchors = spendability
@@ -6522,7 +6652,7 @@ impl SyncEngine {
     /// Get current Orchard anchor from the ShardTree, if available.
     pub fn get_orchard_anchor_from_shardtree(&self) -> Option<[u8; 32]> {
         let sink = self.storage.as_ref()?;
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone()).ok()?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone()).ok()?;
         let repo = Repository::new(&db);
         let spendability = SpendabilityStateStorage::new(&db);
         let anchors = spendability
@@ -6558,7 +6688,7 @@ impl SyncEngine {
             return Ok(());
         }
 
-        let db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         let tx = db
             .conn()
             .unchecked_transaction()
@@ -6655,8 +6785,8 @@ impl SyncEngine {
                 db
             } else {
                 owned_db =
-                    Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
-                &owned_db
+                    Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
+                &*owned_db
             };
             let scan_queue = ScanQueueStorage::new(db);
             let historic_start = (self.birthday_height as u64).max(1);
@@ -6731,7 +6861,7 @@ impl SyncEngine {
             return Ok(checkpoint_height);
         };
 
-        let mut db = Database::open_existing(&sink.db_path, &sink.key, sink.master_key.clone())?;
+        let mut db = Database::open_pooled(&sink.db_path, &sink.key, sink.master_key.clone())?;
         truncate_above_height(&mut db, checkpoint_height)?;
 
         self.nullifier_cache.clear();
@@ -7106,7 +7236,7 @@ impl StorageSink {
         tx_fees: &HashMap<String, i64>,
         position_mappings: &PositionMaps,
     ) -> Result<PersistNotesResult> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         self.persist_notes_with_db(&db, notes, tx_times, tx_fees, position_mappings)
     }
 
@@ -7562,7 +7692,7 @@ impl StorageSink {
         output_index: i64,
         note_type: NoteType,
     ) -> Result<Option<NoteRecord>> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         let note_type = match note_type {
             NoteType::Sapling => pirate_storage_sqlite::models::NoteType::Sapling,
@@ -7577,7 +7707,7 @@ impl StorageSink {
     }
 
     fn list_orchard_note_refs(&self) -> Result<Vec<OrchardNoteRef>> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         Ok(repo.get_orchard_note_refs(self.account_id)?)
     }
@@ -7589,7 +7719,7 @@ impl StorageSink {
         note_type: NoteType,
         memo: Option<&[u8]>,
     ) -> Result<()> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         let note_type = match note_type {
             NoteType::Sapling => pirate_storage_sqlite::models::NoteType::Sapling,
@@ -7610,7 +7740,7 @@ impl StorageSink {
         fallback_entries: &[([u8; 32], [u8; 32])],
         tx_meta: &[(String, i64, i64, i64)],
     ) -> Result<(u64, u64)> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         self.apply_spend_updates_with_txmeta_with_db(&db, spend_updates, fallback_entries, tx_meta)
     }
 
@@ -7637,25 +7767,25 @@ impl StorageSink {
         if entries.is_empty() {
             return Ok(0);
         }
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         Ok(repo.upsert_unlinked_spend_nullifiers_with_txid(self.account_id, entries)?)
     }
 
     fn upsert_tx_memo(&self, txid_hex: &str, memo: &[u8]) -> Result<()> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         Ok(repo.upsert_tx_memo(txid_hex, memo)?)
     }
 
     fn get_tx_memo(&self, txid_hex: &str) -> Result<Option<Vec<u8>>> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let repo = Repository::new(&db);
         Ok(repo.get_tx_memo(txid_hex)?)
     }
 
     fn load_sync_state(&self) -> Result<pirate_storage_sqlite::sync_state::SyncStateRow> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let sync_state = SyncStateStorage::new(&db);
         Ok(sync_state.load_sync_state()?)
     }
@@ -7666,7 +7796,7 @@ impl StorageSink {
         target_height: u64,
         last_checkpoint_height: u64,
     ) -> Result<()> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         self.save_sync_state_with_db(&db, local_height, target_height, last_checkpoint_height)
     }
 
@@ -7699,13 +7829,13 @@ impl StorageSink {
     }
 
     fn load_chain_block(&self, height: u64) -> Result<Option<ChainBlockRow>> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let sync_state = SyncStateStorage::new(&db);
         Ok(sync_state.load_chain_block(height)?)
     }
 
     fn load_latest_chain_block(&self) -> Result<Option<ChainBlockRow>> {
-        let db = Database::open_existing(&self.db_path, &self.key, self.master_key.clone())?;
+        let db = Database::open_pooled(&self.db_path, &self.key, self.master_key.clone())?;
         let sync_state = SyncStateStorage::new(&db);
         Ok(sync_state.load_latest_chain_block()?)
     }
@@ -7808,20 +7938,10 @@ type CompactDecryptResult<D> = Option<(
     usize,
 )>;
 
-#[derive(Debug, Default, Clone)]
-struct DecryptBackendTelemetry {
-    cpu_ms: u128,
-}
-
 #[derive(Debug, Default, Clone)]
 struct TrialDecryptTelemetry {
     cpu_ms: u128,
-}
-
-impl TrialDecryptTelemetry {
-    fn merge_stage(&mut self, stage: &DecryptBackendTelemetry, _note_type: NoteType) {
-        self.cpu_ms += stage.cpu_ms;
-    }
+    stages: DecryptStageTimings,
 }
 
 struct TrialDecryptBatchResult {
@@ -7842,102 +7962,36 @@ struct TrialDecryptBatchInputs<'a> {
     max_parallel: usize,
 }
 
-fn try_compact_note_decryption_parallel<D, Output>(
-    pool: &rayon::ThreadPool,
-    ivks: &[D::IncomingViewingKey],
-    outputs: &[(D, Output)],
-    max_parallel: usize,
-) -> Vec<CompactDecryptResult<D>>
-where
-    D: zcash_note_encryption::BatchDomain + Sync,
-    Output: ShieldedOutput<D, COMPACT_NOTE_SIZE> + Sync,
-    D::IncomingViewingKey: Sync,
-    D::Note: Send,
-    D::Recipient: Send,
-{
-    if ivks.is_empty() {
-        return (0..outputs.len()).map(|_| None).collect();
-    }
-
-    let outputs_len = outputs.len();
-    if outputs_len == 0 {
-        return Vec::new();
-    }
-
-    let max_parallel = max_parallel.max(1);
-    if max_parallel == 1 || outputs_len < MIN_PARALLEL_OUTPUTS {
-        return note_batch::try_compact_note_decryption(ivks, outputs);
-    }
-
-    let mut chunk_size = outputs_len.div_ceil(max_parallel);
-    if chunk_size < MIN_PARALLEL_OUTPUTS {
-        chunk_size = MIN_PARALLEL_OUTPUTS;
-    }
-    let chunk_count = outputs_len.div_ceil(chunk_size);
-    if chunk_count <= 1 {
-        return note_batch::try_compact_note_decryption(ivks, outputs);
-    }
-
-    pool.install(|| {
-        outputs
-            .par_chunks(chunk_size)
-            .map(|chunk| note_batch::try_compact_note_decryption(ivks, chunk))
-            .collect::<Vec<_>>()
-            .into_iter()
-            .flatten()
-            .collect()
-    })
+/// Trial-decryption inputs of a batch flattened across its blocks.
+///
+/// This is as close to a structure-of-arrays layout as the batch API allows.
+/// `zcash_note_encryption::batch` takes `&[(D, Output)]`, and the per-output
+/// decryption after key agreement is private to that crate, so the inputs
+/// stay as contiguous `(domain, output)` pairs. The outputs are fixed-size
+/// inline arrays with no heap pointers. Per-output metadata lives in parallel
+/// arrays, so the hot loop never touches it.
+#[derive(Default)]
+struct FlattenedOutputs {
+    sapling_outputs: Vec<(SaplingDomain, SaplingBatchOutput)>,
+    sapling_meta: Vec<SaplingOutputMeta>,
+    orchard_outputs: Vec<(OrchardDomain, CompactAction)>,
+    orchard_meta: Vec<OrchardOutputMeta>,
 }
 
-fn try_compact_note_decryption_backend<D, Output>(
-    pool: &rayon::ThreadPool,
-    ivks: &[D::IncomingViewingKey],
-    outputs: &[(D, Output)],
-    max_parallel: usize,
-) -> (Vec<CompactDecryptResult<D>>, DecryptBackendTelemetry)
-where
-    D: zcash_note_encryption::BatchDomain + Sync,
-    Output: ShieldedOutput<D, COMPACT_NOTE_SIZE> + Sync,
-    D::IncomingViewingKey: Sync,
-    D::Note: Send,
-    D::Recipient: Send,
-{
-    let started = Instant::now();
-    let results = try_compact_note_decryption_parallel(pool, ivks, outputs, max_parallel);
-    let telemetry = DecryptBackendTelemetry {
-        cpu_ms: started.elapsed().as_millis(),
-    };
-    (results, telemetry)
-}
-
-fn trial_decrypt_batch_impl(
-    inputs: TrialDecryptBatchInputs<'_>,
-) -> Result<TrialDecryptBatchResult> {
-    let TrialDecryptBatchInputs {
-        blocks,
-        sapling_ivks,
-        sapling_key_ids,
-        sapling_scopes,
-        orchard_ivks,
-        orchard_key_ids,
-        orchard_scopes,
-        orchard_fvks,
-        decrypt_pool,
-        max_parallel,
-    } = inputs;
-
-    let mut sapling_outputs: Vec<(SaplingDomain, SaplingBatchOutput)> = Vec::new();
-    let mut sapling_meta: Vec<SaplingOutputMeta> = Vec::new();
-    let mut orchard_outputs: Vec<(OrchardDomain, CompactAction)> = Vec::new();
-    let mut orchard_meta: Vec<OrchardOutputMeta> = Vec::new();
+impl FlattenedOutputs {
+    fn from_block(block: &CompactBlockData, sapling: bool, orchard: bool) -> Self {
+        let mut flat = Self::default();
+        flat.push_block(block, sapling, orchard);
+        flat
+    }
 
-    for block in blocks {
+    fn push_block(&mut self, block: &CompactBlockData, sapling: bool, orchard: bool) {
         let height = block.height;
         for (tx_idx, tx) in block.transactions.iter().enumerate() {
             let tx_index = tx.index.unwrap_or(tx_idx as u64) as usize;
             let tx_hash = tx.hash.clone();
 
-            if !sapling_ivks.is_empty() {
+            if sapling {
                 for (output_idx, output) in tx.outputs.iter().enumerate() {
                     if output.cmu.len() != 32
                         || output.ephemeral_key.len() != 32
@@ -7957,7 +8011,7 @@ fn trial_decrypt_batch_impl(
                         &PirateNetwork::default(),
                         BlockHeight::from_u32(height as u32),
                     ));
-                    sapling_outputs.push((
+                    self.sapling_outputs.push((
                         domain,
                         SaplingBatchOutput {
                             epk,
@@ -7965,7 +8019,7 @@ fn trial_decrypt_batch_impl(
                             ciphertext,
                         },
                     ));
-                    sapling_meta.push(SaplingOutputMeta {
+                    self.sapling_meta.push(SaplingOutputMeta {
                         height,
                         tx_index,
                         output_index: output_idx,
@@ -7974,7 +8028,7 @@ fn trial_decrypt_batch_impl(
                 }
             }
 
-            if !orchard_ivks.is_empty() {
+            if orchard {
                 for (action_idx, action) in tx.actions.iter().enumerate() {
                     if action.cmx.len() != 32
                         || action.nullifier.len() != 32
@@ -8012,8 +8066,8 @@ fn trial_decrypt_batch_impl(
                         enc_ciphertext,
                     );
                     let domain = OrchardDomain::for_compact_action(&compact_action);
-                    orchard_outputs.push((domain, compact_action));
-                    orchard_meta.push(OrchardOutputMeta {
+                    self.orchard_outputs.push((domain, compact_action));
+                    self.orchard_meta.push(OrchardOutputMeta {
                         height,
                         tx_index,
                         output_index: action_idx,
@@ -8025,19 +8079,238 @@ fn trial_decrypt_batch_impl(
         }
     }
 
-    let mut notes = Vec::new();
-    let mut telemetry = TrialDecryptTelemetry::default();
+    fn append(&mut self, mut other: Self) {
+        self.sapling_outputs.append(&mut other.sapling_outputs);
+        self.sapling_meta.append(&mut other.sapling_meta);
+        self.orchard_outputs.append(&mut other.orchard_outputs);
+        self.orchard_meta.append(&mut other.orchard_meta);
+    }
+}
 
-    if !sapling_ivks.is_empty() && !sapling_outputs.is_empty() {
-        let (sapling_results, sapling_telemetry) = try_compact_note_decryption_backend(
-            decrypt_pool,
-            sapling_ivks,
-            &sapling_outputs,
-            max_parallel,
+/// Flatten `blocks`, in parallel on `pool` when more than one worker is
+/// allowed: point decoding and copies are a visible share of a batch.
+fn flatten_outputs(
+    pool: &rayon::ThreadPool,
+    blocks: &[CompactBlockData],
+    sapling: bool,
+    orchard: bool,
+    max_parallel: usize,
+) -> FlattenedOutputs {
+    let mut flat = FlattenedOutputs::default();
+    if max_parallel <= 1 || blocks.len() <= 1 {
+        for block in blocks {
+            flat.push_block(block, sapling, orchard);
+        }
+        return flat;
+    }
+    let per_block: Vec<FlattenedOutputs> = pool.install(|| {
+        blocks
+            .par_iter()
+            .map(|block| FlattenedOutputs::from_block(block, sapling, orchard))
+            .collect()
+    });
+    let sapling_len = per_block.iter().map(|b| b.sapling_outputs.len()).sum();
+    let orchard_len = per_block.iter().map(|b| b.orchard_outputs.len()).sum();
+    flat.sapling_outputs.reserve(sapling_len);
+    flat.sapling_meta.reserve(sapling_len);
+    flat.orchard_outputs.reserve(orchard_len);
+    flat.orchard_meta.reserve(orchard_len);
+    for block in per_block {
+        flat.append(block);
+    }
+    flat
+}
+
+/// One chunk of flattened outputs to trial-decrypt.
+enum DecryptJob {
+    Sapling(std::ops::Range<usize>),
+    Orchard(std::ops::Range<usize>),
+}
+
+enum DecryptChunk {
+    Sapling(Vec<CompactDecryptResult<SaplingDomain>>),
+    Orchard(Vec<CompactDecryptResult<OrchardDomain>>),
+}
+
+struct DecryptResults {
+    sapling: Vec<CompactDecryptResult<SaplingDomain>>,
+    orchard: Vec<CompactDecryptResult<OrchardDomain>>,
+    sapling_cpu: Duration,
+    orchard_cpu: Duration,
+}
+
+fn push_decrypt_jobs(
+    jobs: &mut Vec<DecryptJob>,
+    len: usize,
+    chunk: usize,
+    job: fn(std::ops::Range<usize>) -> DecryptJob,
+) {
+    let mut start = 0;
+    while start < len {
+        let end = (start + chunk).min(len);
+        jobs.push(job(start..end));
+        start = end;
+    }
+}
+
+/// Trial-decrypt Sapling outputs and Orchard actions against every IVK of
+/// the wallet in one pass. Both are cut into chunks of at least
+/// [`MIN_PARALLEL_OUTPUTS`], a few per worker, and up to `max_parallel`
+/// workers on `pool` pull chunks from a shared queue until it is empty. A
+/// worker that draws cheap chunks keeps taking more, so uneven chunks or a
+/// busy core no longer leave the batch waiting on one straggler.
+fn run_trial_decrypt_jobs(
+    pool: &rayon::ThreadPool,
+    sapling_ivks: &[PreparedIncomingViewingKey],
+    orchard_ivks: &[OrchardPreparedIncomingViewingKey],
+    flat: &FlattenedOutputs,
+    max_parallel: usize,
+) -> DecryptResults {
+    let max_parallel = max_parallel.max(1);
+    let total = flat.sapling_outputs.len() + flat.orchard_outputs.len();
+    let chunk = total
+        .div_ceil(max_parallel * DECRYPT_CHUNKS_PER_WORKER)
+        .max(MIN_PARALLEL_OUTPUTS);
+    let mut jobs = Vec::new();
+    if !sapling_ivks.is_empty() {
+        push_decrypt_jobs(
+            &mut jobs,
+            flat.sapling_outputs.len(),
+            chunk,
+            DecryptJob::Sapling,
+        );
+    }
+    if !orchard_ivks.is_empty() {
+        push_decrypt_jobs(
+            &mut jobs,
+            flat.orchard_outputs.len(),
+            chunk,
+            DecryptJob::Orchard,
         );
-        telemetry.merge_stage(&sapling_telemetry, NoteType::Sapling);
+    }
 
-        for (idx, result) in sapling_results.into_iter().enumerate() {
+    let run_job = |job: &DecryptJob| {
+        let started = Instant::now();
+        let chunk = match job {
+            DecryptJob::Sapling(range) => {
+                DecryptChunk::Sapling(note_batch::try_compact_note_decryption(
+                    sapling_ivks,
+                    &flat.sapling_outputs[range.clone()],
+                ))
+            }
+            DecryptJob::Orchard(range) => {
+                DecryptChunk::Orchard(note_batch::try_compact_note_decryption(
+                    orchard_ivks,
+                    &flat.orchard_outputs[range.clone()],
+                ))
+            }
+        };
+        (chunk, started.elapsed())
+    };
+
+    let workers = max_parallel.min(jobs.len());
+    let mut done: Vec<(usize, (DecryptChunk, Duration))> = if workers <= 1 {
+        jobs.iter().map(run_job).enumerate().collect()
+    } else {
+        let next = AtomicUsize::new(0);
+        pool.install(|| {
+            (0..workers)
+                .into_par_iter()
+                .with_max_len(1)
+                .flat_map_iter(|_| {
+                    let mut done = Vec::new();
+                    loop {
+                        let index = next.fetch_add(1, Ordering::Relaxed);
+                        let Some(job) = jobs.get(index) else {
+                            break;
+                        };
+                        done.push((index, run_job(job)));
+                    }
+                    done
+                })
+                .collect()
+        })
+    };
+    done.sort_unstable_by_key(|(index, _)| *index);
+
+    let mut results = DecryptResults {
+        sapling: Vec::with_capacity(flat.sapling_outputs.len()),
+        orchard: Vec::with_capacity(flat.orchard_outputs.len()),
+        sapling_cpu: Duration::ZERO,
+        orchard_cpu: Duration::ZERO,
+    };
+    for (_, (chunk, elapsed)) in done {
+        match chunk {
+            DecryptChunk::Sapling(chunk) => {
+                results.sapling.extend(chunk);
+                results.sapling_cpu += elapsed;
+            }
+            DecryptChunk::Orchard(chunk) => {
+                results.orchard.extend(chunk);
+                results.orchard_cpu += elapsed;
+            }
+        }
+    }
+    results
+}
+
+fn trial_decrypt_batch_impl(
+    inputs: TrialDecryptBatchInputs<'_>,
+) -> Result<TrialDecryptBatchResult> {
+    let TrialDecryptBatchInputs {
+        blocks,
+        sapling_ivks,
+        sapling_key_ids,
+        sapling_scopes,
+        orchard_ivks,
+        orchard_key_ids,
+        orchard_scopes,
+        orchard_fvks,
+        decrypt_pool,
+        max_parallel,
+    } = inputs;
+
+    let flatten_started = Instant::now();
+    let flat = flatten_outputs(
+        decrypt_pool,
+        blocks,
+        !sapling_ivks.is_empty(),
+        !orchard_ivks.is_empty(),
+        max_parallel,
+    );
+    let flatten_elapsed = flatten_started.elapsed();
+
+    let decrypt_started = Instant::now();
+    let results = run_trial_decrypt_jobs(
+        decrypt_pool,
+        sapling_ivks,
+        orchard_ivks,
+        &flat,
+        max_parallel,
+    );
+    let decrypt_elapsed = decrypt_started.elapsed();
+
+    let FlattenedOutputs {
+        sapling_outputs,
+        sapling_meta,
+        orchard_meta,
+        ..
+    } = flat;
+    let telemetry = TrialDecryptTelemetry {
+        cpu_ms: (results.sapling_cpu + results.orchard_cpu).as_millis(),
+        stages: DecryptStageTimings {
+            sapling_outputs: sapling_outputs.len() as u64,
+            orchard_actions: orchard_meta.len() as u64,
+            flatten_us: flatten_elapsed.as_micros() as u64,
+            decrypt_us: decrypt_elapsed.as_micros() as u64,
+            sapling_cpu_us: results.sapling_cpu.as_micros() as u64,
+            orchard_cpu_us: results.orchard_cpu.as_micros() as u64,
+        },
+    };
+    let mut notes = Vec::new();
+
+    if !sapling_ivks.is_empty() {
+        for (idx, result) in results.sapling.into_iter().enumerate() {
             if let Some(((note, address), ivk_index)) = result {
                 let meta = &sapling_meta[idx];
                 let (leadbyte, rseed_bytes) = sapling_rseed_to_bytes(&note);
@@ -8070,16 +8343,8 @@ fn trial_decrypt_batch_impl(
         }
     }
 
-    if !orchard_ivks.is_empty() && !orchard_outputs.is_empty() {
-        let (orchard_results, orchard_telemetry) = try_compact_note_decryption_backend(
-            decrypt_pool,
-            orchard_ivks,
-            &orchard_outputs,
-            max_parallel,
-        );
-        telemetry.merge_stage(&orchard_telemetry, NoteType::Orchard);
-
-        for (idx, result) in orchard_results.into_iter().enumerate() {
+    if !orchard_ivks.is_empty() {
+        for (idx, result) in results.orchard.into_iter().enumerate() {
             if let Some(((note, address), ivk_index)) = result {
                 let meta = &orchard_meta[idx];
                 let value = note.value().inner();
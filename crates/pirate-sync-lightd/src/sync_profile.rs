@@ -2,10 +2,11 @@
 
 use crate::sync::SyncConfig;
 use directories::ProjectDirs;
+use parking_lot::RwLock;
 use serde::{Deserialize, Serialize};
 use std::fs;
 use std::path::{Path, PathBuf};
-use std::sync::atomic::{AtomicUsize, Ordering};
+use std::sync::atomic::{AtomicU8, AtomicUsize, Ordering};
 use std::time::{Duration, Instant};
 use sysinfo::{Disks, System};
 
@@ -15,8 +16,13 @@ const MAX_CRASH_DOWNGRADE_STEPS: u8 = 2;
 const SUCCESSFUL_SYNCS_TO_RECOVER: u8 = 2;
 const SYNC_PROFILE_STATE_FILE: &str = "sync_profile_state.json";
 const SYNC_PROFILE_STATE_PATH_ENV: &str = "PIRATE_SYNC_PROFILE_STATE_PATH";
+const REDUCED_BATCH_PAUSE: Duration = Duration::from_millis(100);
+const TRICKLE_BATCH_PAUSE: Duration = Duration::from_secs(2);
+const TRICKLE_MAX_BATCH_BLOCKS: u64 = 500;
 
 static ACTIVE_SYNC_PROFILE_SESSIONS: AtomicUsize = AtomicUsize::new(0);
+static SYNC_POWER_PROFILE: AtomicU8 = AtomicU8::new(SyncPowerProfile::Full as u8);
+static PRIORITY_SYNC_WALLET: RwLock<Option<String>> = RwLock::new(None);
 
 /// Coarse device class used to choose generic sync performance settings.
 ///
@@ -81,6 +87,35 @@ pub struct SyncProfileSelection {
     pub downgrade_steps: u8,
 }
 
+/// Host power and visibility, as reported by the desktop runners.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+pub struct SyncPowerState {
+    /// Running on mains power rather than battery.
+    pub on_ac_power: bool,
+    /// The wallet window is shown and not minimized.
+    pub window_visible: bool,
+    /// The wallet window has keyboard focus.
+    pub window_focused: bool,
+    /// The user session is locked or the machine is about to sleep.
+    pub session_locked: bool,
+}
+
+/// How hard a running sync may push the machine right now.
+///
+/// Unlike [`SyncDeviceClass`], which is picked once per session, this can
+/// change between batches; the sync loop re-reads it before every batch.
+#[derive(Clone, Copy, Debug, Eq, PartialEq)]
+#[repr(u8)]
+pub enum SyncPowerProfile {
+    /// On AC power with the window in front: the configured profile as is.
+    Full = 0,
+    /// In the background or on battery: fewer decrypt workers, short pauses.
+    Reduced = 1,
+    /// Idle on battery: one worker and small, spaced-out batches, enough to
+    /// keep up with the chain tip.
+    Trickle = 2,
+}
+
 #[derive(Clone, Copy, Debug)]
 struct SyncProfileSpec {
     max_parallel_decrypt: usize,
@@ -234,6 +269,114 @@ impl SyncDeviceClass {
     }
 }
 
+impl SyncPowerState {
+    /// Map the reported host state to a throttling profile.
+    pub fn profile(self) -> SyncPowerProfile {
+        let idle = self.session_locked || !self.window_visible;
+        if !self.on_ac_power && idle {
+            SyncPowerProfile::Trickle
+        } else if self.on_ac_power && self.window_focused && !idle {
+            SyncPowerProfile::Full
+        } else {
+            SyncPowerProfile::Reduced
+        }
+    }
+}
+
+impl SyncPowerProfile {
+    /// Stable human-readable identifier for local logs and diagnostics.
+    pub fn as_str(self) -> &'static str {
+        match self {
+            Self::Full => "full",
+            Self::Reduced => "reduced",
+            Self::Trickle => "trickle",
+        }
+    }
+
+    fn from_u8(value: u8) -> Self {
+        match value {
+            1 => Self::Reduced,
+            2 => Self::Trickle,
+            _ => Self::Full,
+        }
+    }
+
+    /// Trial-decrypt parallelism to use instead of the configured `max`.
+    pub fn max_parallel_decrypt(self, max: usize) -> usize {
+        let max = max.max(1);
+        match self {
+            Self::Full => max,
+            Self::Reduced => max.div_ceil(2),
+            Self::Trickle => 1,
+        }
+    }
+
+    /// Upper bound on blocks per batch, applied over the adaptive batch size.
+    pub fn max_batch_blocks(self, max: u64) -> u64 {
+        match self {
+            Self::Full | Self::Reduced => max,
+            Self::Trickle => max.min(TRICKLE_MAX_BATCH_BLOCKS),
+        }
+    }
+
+    /// Pause inserted before each batch.
+    pub fn batch_pause(self) -> Duration {
+        match self {
+            Self::Full => Duration::ZERO,
+            Self::Reduced => REDUCED_BATCH_PAUSE,
+            Self::Trickle => TRICKLE_BATCH_PAUSE,
+        }
+    }
+}
+
+/// Record the host power state reported by a desktop runner. Takes effect at
+/// the next batch of any running sync.
+pub fn set_sync_power_state(state: SyncPowerState) {
+    let profile = state.profile();
+    let previous =
+        SyncPowerProfile::from_u8(SYNC_POWER_PROFILE.swap(profile as u8, Ordering::Relaxed));
+    if previous != profile {
+        tracing::info!(
+            "sync power profile {} -> {} ({:?})",
+            previous.as_str(),
+            profile.as_str(),
+            state
+        );
+    }
+}
+
+/// Current throttling profile. [`SyncPowerProfile::Full`] until a runner
+/// reports otherwise, so mobile and headless builds are never throttled.
+pub fn current_sync_power_profile() -> SyncPowerProfile {
+    SyncPowerProfile::from_u8(SYNC_POWER_PROFILE.load(Ordering::Relaxed))
+}
+
+/// Mark the wallet whose sync should get the larger share of decrypt workers
+/// while several wallets sync at once, normally the wallet on screen.
+pub fn set_priority_sync_wallet(wallet_id: Option<&str>) {
+    *PRIORITY_SYNC_WALLET.write() = wallet_id.map(str::to_string);
+}
+
+/// This session's share of `max` decrypt workers while other sync sessions
+/// run in the same process. Sessions split the budget evenly, except the
+/// priority wallet, which counts twice. No sharing with a single session.
+pub fn fair_share_parallel_decrypt(max: usize, wallet_id: Option<&str>) -> usize {
+    let sessions = ACTIVE_SYNC_PROFILE_SESSIONS.load(Ordering::Relaxed);
+    let priority = PRIORITY_SYNC_WALLET.read();
+    let is_priority = wallet_id.is_some() && priority.as_deref() == wallet_id;
+    decrypt_share(max, sessions, priority.is_some(), is_priority)
+}
+
+fn decrypt_share(max: usize, sessions: usize, has_priority: bool, is_priority: bool) -> usize {
+    let max = max.max(1);
+    if sessions <= 1 {
+        return max;
+    }
+    let shares = sessions + usize::from(has_priority);
+    let weight = if is_priority { 2 } else { 1 };
+    (max * weight / shares).max(1)
+}
+
 impl SyncDeviceSnapshot {
     /// Select a coarse profile from this snapshot.
     pub fn profile(self) -> SyncDeviceClass {
@@ -647,6 +790,47 @@ mod tests {
         assert_eq!(config.target_batch_bytes, 192 * MB);
     }
 
+    #[test]
+    fn power_state_maps_to_throttle_profile() {
+        let focused_on_ac = SyncPowerState {
+            on_ac_power: true,
+            window_visible: true,
+            window_focused: true,
+            session_locked: false,
+        };
+        assert_eq!(focused_on_ac.profile(), SyncPowerProfile::Full);
+
+        let minimized_on_ac = SyncPowerState {
+            window_visible: false,
+            window_focused: false,
+            ..focused_on_ac
+        };
+        assert_eq!(minimized_on_ac.profile(), SyncPowerProfile::Reduced);
+
+        let focused_on_battery = SyncPowerState {
+            on_ac_power: false,
+            ..focused_on_ac
+        };
+        assert_eq!(focused_on_battery.profile(), SyncPowerProfile::Reduced);
+
+        let locked_on_battery = SyncPowerState {
+            session_locked: true,
+            ..focused_on_battery
+        };
+        assert_eq!(locked_on_battery.profile(), SyncPowerProfile::Trickle);
+        assert_eq!(SyncPowerProfile::Trickle.max_parallel_decrypt(16), 1);
+        assert_eq!(SyncPowerProfile::Reduced.max_parallel_decrypt(5), 3);
+        assert_eq!(SyncPowerProfile::Trickle.max_batch_blocks(8_000), 500);
+    }
+
+    #[test]
+    fn priority_wallet_gets_double_decrypt_share() {
+        assert_eq!(decrypt_share(16, 1, true, false), 16);
+        assert_eq!(decrypt_share(16, 3, true, true), 8);
+        assert_eq!(decrypt_share(16, 3, true, false), 4);
+        assert_eq!(decrypt_share(2, 4, false, false), 1);
+    }
+
     #[test]
     fn crash_guard_downgrades_then_recovers_after_successes() {
         let dir = tempfile::tempdir().unwrap();
@@ -40,7 +40,7 @@ use pirate_storage_sqlite::{
     passphrase_store, platform_keystore,
     security::{generate_salt, AppPassphrase, EncryptionAlgorithm, MasterKey, SealedKey},
     Account, AccountKey, AddressType, Database, EncryptionKey, KeyScope, KeyType, KeystoreResult,
-    Repository, ScanQueueStorage, SpendabilityStateStorage, WalletSecret,
+    PooledDatabase, Repository, ScanQueueStorage, SpendabilityStateStorage, WalletSecret,
 };
 use pirate_sync_lightd::client::{LightClient, RetryConfig};
 use pirate_sync_lightd::SyncEngine;
@@ -71,37 +71,55 @@ pub(crate) mod background_sync;
 pub(crate) mod diagnostics;
 pub(crate) mod encrypted_db;
 pub(crate) mod endpoint;
+pub(crate) mod fast_unlock;
+#[cfg(target_os = "linux")]
+pub(crate) mod headless;
 pub(crate) mod key_management;
 pub(crate) mod panic_duress;
 pub(crate) mod payment_disclosure;
+pub(crate) mod prewarm;
 pub(crate) mod provisioning;
 pub(crate) mod qortal;
 pub(crate) mod qortal_p2sh;
 pub(crate) mod seed_export;
 pub(crate) mod sync_control;
+pub(crate) mod sync_scheduler;
 pub(crate) mod tunnel;
 pub(crate) mod tx_flow;
 pub(crate) mod wallet_registry;
+pub(crate) mod warm_snapshot;
 
 pub use self::diagnostics::CheckpointInfo;
 pub use self::endpoint::{
     LightdEndpoint, DEFAULT_LIGHTD_HOST, DEFAULT_LIGHTD_PORT, DEFAULT_LIGHTD_USE_TLS,
 };
+pub use self::fast_unlock::{
+    set_fast_unlock_policy, set_fast_unlock_sink, set_fast_unlock_source, FastUnlockLoad,
+    FastUnlockSink, FastUnlockSource, FAST_UNLOCK_BUNDLE_VERSION, FAST_UNLOCK_DEFAULT_MAX_AGE,
+};
+#[cfg(target_os = "linux")]
+pub use self::headless::{run_headless_sync, HeadlessSyncOptions};
 use self::panic_duress::{ensure_not_decoy, is_decoy_mode_active};
 pub use self::payment_disclosure::{
     export_orchard_payment_disclosure, export_payment_disclosures,
     export_sapling_payment_disclosure, verify_payment_disclosure,
 };
+pub use self::prewarm::{prewarm_backend, prewarm_prover, prover_status, PrewarmReport};
 pub use self::qortal::{
     qortal_balance, qortal_list_transactions, qortal_send, qortal_sync_status, QortalSendRequest,
 };
 pub use self::qortal_p2sh::{QortalP2shRedeemRequest, QortalP2shSendRequest};
 pub use self::seed_export::SeedExportWarnings;
+pub use self::sync_scheduler::{schedule_wallet_syncs, SyncScheduleReport};
 use self::wallet_registry::{
     auto_consolidation_enabled, ensure_wallet_registry_loaded, get_wallet_meta,
     load_wallet_registry_activity, load_wallet_registry_state, persist_wallet_meta,
     set_active_wallet_registry, touch_wallet_last_synced, touch_wallet_last_used,
 };
+pub use self::warm_snapshot::{
+    set_warm_snapshot_sink, set_warm_snapshot_source, WarmSnapshotSink, WarmSnapshotSource,
+    WARM_SNAPSHOT_VERSION,
+};
 use encrypted_db::{
     app_passphrase, get_registry_setting, open_wallet_db_for, open_wallet_db_with_passphrase,
     open_wallet_registry, set_registry_setting, set_wallet_base_dir_override, wallet_db_key_path,
@@ -118,12 +136,55 @@ lazy_static::lazy_static! {
     static ref TUNNEL_MODE: Arc<RwLock<TunnelMode>> = Arc::new(RwLock::new(TunnelMode::Tor));
     /// Pending tunnel mode to persist once registry is available.
     static ref PENDING_TUNNEL_MODE: Arc<RwLock<Option<TunnelMode>>> = Arc::new(RwLock::new(None));
+    static ref WALLET_DB_SESSION_KEYS: RwLock<HashMap<String, SessionWalletKeys>> =
+        RwLock::new(HashMap::new());
 }
 
 #[derive(Default)]
 struct WalletDbCacheState {
     epoch: u64,
-    entries: HashMap<String, Rc<Database>>,
+    entries: HashMap<String, CachedWalletDb>,
+}
+
+/// A thread's handle to a wallet database, borrowed from the process-wide
+/// pool. Dropping the entry hands the handle back once no caller still holds
+/// a clone of it.
+struct CachedWalletDb {
+    db: Option<Rc<Database>>,
+    lease: Option<pirate_storage_sqlite::Lease>,
+}
+
+impl CachedWalletDb {
+    fn new(db: PooledDatabase) -> Self {
+        let (db, lease) = db.into_parts();
+        Self {
+            db: Some(Rc::new(db)),
+            lease: Some(lease),
+        }
+    }
+
+    fn db(&self) -> Option<Rc<Database>> {
+        self.db.clone()
+    }
+}
+
+impl Drop for CachedWalletDb {
+    fn drop(&mut self) {
+        let (Some(db), Some(lease)) = (self.db.take(), self.lease.take()) else {
+            return;
+        };
+        if let Ok(db) = Rc::try_unwrap(db) {
+            lease.release(db);
+        }
+    }
+}
+
+/// Keys of wallet databases opened during this session, so a thread whose
+/// cache misses borrows a pooled handle instead of deriving keys and running
+/// migrations again. Cleared together with the per-thread caches.
+struct SessionWalletKeys {
+    db_key: zeroize::Zeroizing<[u8; 32]>,
+    master_key: MasterKey,
 }
 
 thread_local! {
@@ -1961,6 +2022,67 @@ pub fn set_lightd_endpoint(
     Ok(())
 }
 
+/// Set extra lightwalletd servers that sync spreads compact block downloads
+/// over, next to the wallet's endpoint. Mirrors use TLS certificate
+/// validation without a pin and apply from the next sync start. An empty list
+/// turns mirroring off.
+pub fn set_lightd_mirrors(wallet_id: WalletId, urls: Vec<String>) -> Result<()> {
+    ensure_wallet_registry_loaded()?;
+    let primary = endpoint::get_lightd_endpoint_config(wallet_id.clone())?;
+    let primary_network = endpoint::detect_network_from_endpoint(&primary.host, primary.port);
+
+    let mut mirrors: Vec<LightdEndpoint> = Vec::with_capacity(urls.len());
+    for url in &urls {
+        let mirror = endpoint::mirror_from_url(url)?;
+        let mirror_network = endpoint::detect_network_from_endpoint(&mirror.host, mirror.port);
+        if let (Some(expected), Some(found)) = (primary_network, mirror_network) {
+            if expected != found {
+                return Err(anyhow!(
+                    "Mirror {} serves {:?}, wallet endpoint serves {:?}",
+                    mirror.url(),
+                    found,
+                    expected
+                ));
+            }
+        }
+        if mirror.url() != primary.url() && !mirrors.iter().any(|m| m.url() == mirror.url()) {
+            mirrors.push(mirror);
+        }
+    }
+
+    if !WALLETS.read().iter().any(|w| w.id == wallet_id) {
+        return Err(anyhow!("Wallet not found: {}", wallet_id));
+    }
+    let stored: Vec<String> = mirrors.iter().map(LightdEndpoint::url).collect();
+    let registry_db = open_wallet_registry()?;
+    let value = if stored.is_empty() {
+        None
+    } else {
+        Some(serde_json::to_string(&stored)?)
+    };
+    set_registry_setting(
+        &registry_db,
+        &endpoint::mirrors_registry_key(&wallet_id),
+        value.as_deref(),
+    )?;
+
+    tracing::info!(
+        "Set {} lightd mirror(s) for wallet {}",
+        mirrors.len(),
+        wallet_id
+    );
+    endpoint::cache_lightd_mirrors(wallet_id, mirrors);
+    Ok(())
+}
+
+/// Get the mirror URLs configured with [`set_lightd_mirrors`].
+pub fn get_lightd_mirrors(wallet_id: WalletId) -> Result<Vec<String>> {
+    Ok(endpoint::get_lightd_mirrors(&wallet_id)
+        .iter()
+        .map(LightdEndpoint::url)
+        .collect())
+}
+
 /// Get lightwalletd endpoint
 pub fn get_lightd_endpoint(wallet_id: WalletId) -> Result<String> {
     endpoint::get_lightd_endpoint(wallet_id)
@@ -2734,6 +2856,7 @@ pub fn clear_wallet_state(wallet_id: WalletId) -> Result<()> {
     let (_db, repo) = open_wallet_db_for(&wallet_id)?;
     repo.clear_chain_state()?;
     sync_control::clear_wallet_sync_state(&wallet_id);
+    warm_snapshot::forget_wallet(&wallet_id);
     Ok(())
 }
 
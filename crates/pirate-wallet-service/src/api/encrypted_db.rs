@@ -2,6 +2,7 @@ use super::*;
 use directories::ProjectDirs;
 use std::rc::Rc;
 use std::sync::OnceLock;
+use zeroize::Zeroizing;
 
 static WALLET_BASE_DIR_OVERRIDE: OnceLock<RwLock<Option<PathBuf>>> = OnceLock::new();
 
@@ -224,7 +225,8 @@ pub(super) fn reseal_wallet_db_key(wallet_id: &str, passphrase: &str) -> Result<
 }
 
 pub(super) fn derive_db_key(passphrase: &str, salt: &[u8; 32]) -> Result<EncryptionKey> {
-    EncryptionKey::from_passphrase(passphrase, salt)
+    fast_unlock::derive_key(passphrase, salt)
+        .map(EncryptionKey::from_bytes)
         .map_err(|e| anyhow!("Failed to derive db key: {}", e))
 }
 
@@ -294,7 +296,7 @@ pub(super) fn open_encrypted_db_with_migration(
 
 pub(super) fn registry_master_key(passphrase: &str) -> Result<MasterKey> {
     let salt = Sha256::digest(b"wallet-registry");
-    AppPassphrase::derive_key(passphrase, &salt[..16])
+    derive_master_key(passphrase, &salt[..16])
         .map_err(|e| anyhow!("Failed to derive registry master key: {}", e))
 }
 
@@ -384,10 +386,16 @@ pub(super) fn set_registry_setting(db: &Database, key: &str, value: Option<&str>
 
 pub(super) fn wallet_master_key(wallet_id: &str, passphrase: &str) -> Result<MasterKey> {
     let salt = Sha256::digest(wallet_id.as_bytes());
-    AppPassphrase::derive_key(passphrase, &salt[..16])
+    derive_master_key(passphrase, &salt[..16])
         .map_err(|e| anyhow!("Failed to derive master key: {}", e))
 }
 
+/// Same key as `AppPassphrase::derive_key`, through the fast-unlock cache.
+fn derive_master_key(passphrase: &str, salt: &[u8]) -> pirate_storage_sqlite::Result<MasterKey> {
+    let key = Zeroizing::new(fast_unlock::derive_key(passphrase, salt)?);
+    MasterKey::from_bytes(&key[..], EncryptionAlgorithm::ChaCha20Poly1305)
+}
+
 pub(super) fn open_wallet_db_with_passphrase(
     wallet_id: &str,
     passphrase: &str,
@@ -416,10 +424,46 @@ pub(super) fn open_wallet_db_with_passphrase(
 
 pub(super) fn wallet_db_keys(wallet_id: &str) -> Result<(EncryptionKey, MasterKey)> {
     let passphrase = app_passphrase()?;
-    let (_db, key, master_key) = open_wallet_db_with_passphrase(wallet_id, &passphrase)?;
+    let (_db, key, master_key) = checkout_wallet_db(wallet_id, &passphrase)?;
     Ok((key, master_key))
 }
 
+/// Borrow a pooled handle to the wallet database. The first open in a session
+/// derives the keys and runs migrations; later ones reuse the keys and, while
+/// one is idle, an already open handle.
+fn checkout_wallet_db(
+    wallet_id: &str,
+    passphrase: &str,
+) -> Result<(PooledDatabase, EncryptionKey, MasterKey)> {
+    let path = wallet_db_path_for(wallet_id)?;
+    let session_keys = WALLET_DB_SESSION_KEYS.read().get(wallet_id).map(|keys| {
+        (
+            EncryptionKey::from_bytes(*keys.db_key),
+            keys.master_key.clone(),
+        )
+    });
+    if let Some((key, master_key)) = session_keys {
+        match Database::open_pooled(&path, &key, master_key.clone()) {
+            Ok(db) => return Ok((db, key, master_key)),
+            Err(e) => {
+                tracing::debug!("pooled open of {} failed, reopening: {}", wallet_id, e);
+                WALLET_DB_SESSION_KEYS.write().remove(wallet_id);
+            }
+        }
+    }
+
+    let (db, key, master_key) = open_wallet_db_with_passphrase(wallet_id, passphrase)?;
+    WALLET_DB_SESSION_KEYS.write().insert(
+        wallet_id.to_string(),
+        SessionWalletKeys {
+            db_key: Zeroizing::new(*key.as_bytes()),
+            master_key: master_key.clone(),
+        },
+    );
+    let db = db.into_pooled(&path, &key);
+    Ok((db, key, master_key))
+}
+
 fn invalidate_wallet_db_cache_epoch() {
     WALLET_DB_CACHE_EPOCH.fetch_add(1, Ordering::SeqCst);
 }
@@ -439,6 +483,10 @@ pub(super) fn invalidate_wallet_db_cache_for(wallet_id: &str) {
     WALLET_DB_CACHE.with(|cache| {
         cache.borrow_mut().entries.remove(wallet_id);
     });
+    WALLET_DB_SESSION_KEYS.write().remove(wallet_id);
+    if let Ok(path) = wallet_db_path_for(wallet_id) {
+        pirate_storage_sqlite::pool::clear_path(&path);
+    }
     invalidate_wallet_db_cache_epoch();
 }
 
@@ -446,6 +494,8 @@ pub(super) fn invalidate_all_wallet_db_caches() {
     WALLET_DB_CACHE.with(|cache| {
         cache.borrow_mut().entries.clear();
     });
+    WALLET_DB_SESSION_KEYS.write().clear();
+    pirate_storage_sqlite::pool::clear();
     invalidate_wallet_db_cache_epoch();
 }
 
@@ -463,19 +513,19 @@ pub(super) fn open_wallet_db_for(wallet_id: &str) -> Result<(Rc<Database>, Repos
             let db = borrowed
                 .entries
                 .get(wallet_id)
-                .cloned()
+                .and_then(CachedWalletDb::db)
                 .ok_or_else(|| anyhow!("Wallet database cache miss"))?;
             let repo = Repository::from_shared(Rc::clone(&db));
             Ok((db, repo))
         });
     }
 
-    let (db, _key, _master_key) = open_wallet_db_with_passphrase(wallet_id, &passphrase)?;
+    let (db, _key, _master_key) = checkout_wallet_db(wallet_id, &passphrase)?;
     WALLET_DB_CACHE.with(|cache| {
         cache
             .borrow_mut()
             .entries
-            .insert(wallet_id.to_string(), Rc::new(db));
+            .insert(wallet_id.to_string(), CachedWalletDb::new(db));
     });
 
     WALLET_DB_CACHE.with(|cache| {
@@ -483,7 +533,7 @@ pub(super) fn open_wallet_db_for(wallet_id: &str) -> Result<(Rc<Database>, Repos
         let db = borrowed
             .entries
             .get(wallet_id)
-            .cloned()
+            .and_then(CachedWalletDb::db)
             .ok_or_else(|| anyhow!("Wallet database cache miss after insert"))?;
         let repo = Repository::from_shared(Rc::clone(&db));
         Ok((db, repo))
@@ -554,8 +604,19 @@ pub(super) fn unlock_app(passphrase: String) -> Result<()> {
         return Err(anyhow!("Wallet registry database not found"));
     }
 
-    let db = open_wallet_registry_with_passphrase(&passphrase)?;
-    let is_valid = verify_app_passphrase_with_db(&db, &passphrase)?;
+    // A bundle from the previous session stands in for Argon2id; the
+    // registry still has to open with its keys before it counts.
+    let fast = fast_unlock::prime(&passphrase);
+    let db = match open_wallet_registry_with_passphrase(&passphrase) {
+        Ok(db) => db,
+        Err(e) if fast => {
+            tracing::warn!("Fast-unlock keys did not open the registry: {}", e);
+            fast_unlock::forget();
+            open_wallet_registry_with_passphrase(&passphrase)?
+        }
+        Err(e) => return Err(e),
+    };
+    let is_valid = fast || verify_app_passphrase_with_db(&db, &passphrase)?;
     if !is_valid {
         return Err(anyhow!("Invalid passphrase"));
     }
@@ -564,6 +625,9 @@ pub(super) fn unlock_app(passphrase: String) -> Result<()> {
         panic_duress::deactivate_decoy();
     }
 
+    if !fast {
+        fast_unlock::publish(&passphrase);
+    }
     passphrase_store::set_passphrase(passphrase);
     REGISTRY_LOADED.store(false, Ordering::SeqCst);
     invalidate_all_wallet_db_caches();
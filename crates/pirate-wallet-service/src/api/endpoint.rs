@@ -18,6 +18,9 @@ lazy_static::lazy_static! {
     /// Persisted endpoint per wallet (in production, stored encrypted)
     static ref LIGHTD_ENDPOINTS: Arc<RwLock<HashMap<WalletId, LightdEndpoint>>> =
         Arc::new(RwLock::new(HashMap::new()));
+    /// Extra servers per wallet that sync spreads block downloads over
+    static ref LIGHTD_MIRRORS: Arc<RwLock<HashMap<WalletId, Vec<LightdEndpoint>>>> =
+        Arc::new(RwLock::new(HashMap::new()));
 }
 
 /// Lightwalletd endpoint configuration
@@ -135,15 +138,50 @@ pub(super) fn cache_lightd_endpoint(wallet_id: WalletId, endpoint: LightdEndpoin
 
 pub(super) fn remove_cached_lightd_endpoint(wallet_id: &WalletId) {
     LIGHTD_ENDPOINTS.write().remove(wallet_id);
+    LIGHTD_MIRRORS.write().remove(wallet_id);
 }
 
 pub(super) fn clear_cached_lightd_endpoints() {
     LIGHTD_ENDPOINTS.write().clear();
+    LIGHTD_MIRRORS.write().clear();
+}
+
+/// Registry key holding a wallet's mirror URLs as a JSON array.
+pub(super) fn mirrors_registry_key(wallet_id: &str) -> String {
+    format!("lightd_mirrors_{}", wallet_id)
+}
+
+pub(super) fn cache_lightd_mirrors(wallet_id: WalletId, mirrors: Vec<LightdEndpoint>) {
+    let mut cached = LIGHTD_MIRRORS.write();
+    if mirrors.is_empty() {
+        cached.remove(&wallet_id);
+    } else {
+        cached.insert(wallet_id, mirrors);
+    }
+}
+
+pub(super) fn get_lightd_mirrors(wallet_id: &WalletId) -> Vec<LightdEndpoint> {
+    LIGHTD_MIRRORS
+        .read()
+        .get(wallet_id)
+        .cloned()
+        .unwrap_or_default()
+}
+
+pub(super) fn mirror_from_url(url: &str) -> Result<LightdEndpoint> {
+    endpoint_from_url(
+        url,
+        DEFAULT_LIGHTD_USE_TLS,
+        None,
+        Some(CUSTOM_ENDPOINT_LABEL.to_string()),
+    )
 }
 
 pub(super) fn load_registry_endpoints(db: &Database, wallets: &[WalletMeta]) -> Result<()> {
     let mut endpoints = LIGHTD_ENDPOINTS.write();
     endpoints.clear();
+    let mut mirrors = LIGHTD_MIRRORS.write();
+    mirrors.clear();
 
     for wallet in wallets {
         let endpoint_key = format!("lightd_endpoint_{}", wallet.id);
@@ -170,6 +208,24 @@ pub(super) fn load_registry_endpoints(db: &Database, wallets: &[WalletMeta]) ->
                 }
             }
         }
+
+        if let Some(stored) = get_registry_setting(db, &mirrors_registry_key(&wallet.id))? {
+            let urls: Vec<String> = serde_json::from_str(&stored).unwrap_or_else(|e| {
+                tracing::warn!(
+                    "Failed to parse stored mirrors for wallet {}: {}",
+                    wallet.id,
+                    e
+                );
+                Vec::new()
+            });
+            let parsed: Vec<LightdEndpoint> = urls
+                .iter()
+                .filter_map(|url| mirror_from_url(url).ok())
+                .collect();
+            if !parsed.is_empty() {
+                mirrors.insert(wallet.id.clone(), parsed);
+            }
+        }
     }
 
     Ok(())
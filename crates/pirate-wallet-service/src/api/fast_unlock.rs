@@ -0,0 +1,435 @@
+use super::*;
+use pirate_storage_sqlite::security::derive_key_bytes;
+use rand::RngCore;
+use serde::{Deserialize, Serialize};
+use zeroize::{Zeroize, Zeroizing};
+
+/// Schema version of the fast-unlock bundle. Bundles with another version are
+/// dropped and the next unlock runs the full KDF.
+pub const FAST_UNLOCK_BUNDLE_VERSION: u32 = 1;
+
+/// How long a bundle may stand in for the KDF when the host does not pick a
+/// limit. After that one full unlock is required to issue a new bundle.
+pub const FAST_UNLOCK_DEFAULT_MAX_AGE: Duration = Duration::from_secs(7 * 24 * 60 * 60);
+
+/// A registry plus a handful of wallets needs two keys each; anything beyond
+/// this is a stream of wrong passphrases and not worth remembering.
+const FAST_UNLOCK_MAX_CACHED_KEYS: usize = 64;
+
+/// How long an unlock waits for a host that is still unsealing the bundle.
+/// Shorter than the KDF it would save, so waiting never costs more than it
+/// can win.
+const FAST_UNLOCK_LOAD_WAIT: Duration = Duration::from_millis(1500);
+const FAST_UNLOCK_LOAD_POLL: Duration = Duration::from_millis(20);
+
+/// Domain separator for the passphrase verifier stored in the bundle.
+const VERIFIER_DOMAIN: &[u8] = b"pirate-fast-unlock-verifier-v1";
+
+/// Receives each encoded bundle in plaintext so the host can seal it with the
+/// platform keystore. An empty slice means "delete the stored bundle".
+pub type FastUnlockSink = Box<dyn Fn(&[u8]) + Send + Sync>;
+
+/// What the host has for this launch when asked, see [`FastUnlockSource`].
+pub enum FastUnlockLoad {
+    /// The unsealed bundle. Hosts give it out once per launch.
+    Bundle(Vec<u8>),
+    /// No bundle stored, or it could not be unsealed.
+    Empty,
+    /// The host is still unsealing the bundle; ask again.
+    Pending,
+}
+
+/// Hands over the unsealed bundle.
+pub type FastUnlockSource = Box<dyn Fn() -> FastUnlockLoad + Send + Sync>;
+
+struct FastUnlockPolicy {
+    enabled: bool,
+    max_age: Duration,
+}
+
+/// One Argon2id result, tagged with a process-local keyed hash of the
+/// passphrase and salt so only the passphrase that produced it finds it again.
+struct CachedKey {
+    tag: [u8; 32],
+    salt: Vec<u8>,
+    key: Zeroizing<[u8; 32]>,
+}
+
+#[derive(Default)]
+struct FastUnlockState {
+    keys: Vec<CachedKey>,
+    /// Plaintext bundle from the host, kept until an unlock accepts it.
+    staged: Option<Zeroizing<Vec<u8>>>,
+    /// The source gave its answer for this launch.
+    fetched: bool,
+    /// Expiry of the bundle this session is exporting; re-exports keep it so
+    /// opening another wallet does not extend the grace period.
+    expires_at: Option<i64>,
+}
+
+#[derive(Serialize, Deserialize)]
+struct Bundle {
+    v: u32,
+    created_at: i64,
+    expires_at: i64,
+    verifier_salt: String,
+    verifier: String,
+    keys: Vec<BundleKey>,
+}
+
+#[derive(Serialize, Deserialize)]
+struct BundleKey {
+    salt: String,
+    key: String,
+}
+
+impl Drop for BundleKey {
+    fn drop(&mut self) {
+        self.key.zeroize();
+    }
+}
+
+lazy_static::lazy_static! {
+    static ref POLICY: RwLock<FastUnlockPolicy> = RwLock::new(FastUnlockPolicy {
+        enabled: false,
+        max_age: FAST_UNLOCK_DEFAULT_MAX_AGE,
+    });
+    static ref SINK: RwLock<Option<FastUnlockSink>> = RwLock::new(None);
+    static ref SOURCE: RwLock<Option<FastUnlockSource>> = RwLock::new(None);
+    static ref STATE: parking_lot::Mutex<FastUnlockState> =
+        parking_lot::Mutex::new(FastUnlockState::default());
+    static ref TAG_KEY: Zeroizing<[u8; 32]> = {
+        let mut key = Zeroizing::new([0u8; 32]);
+        rand::thread_rng().fill_bytes(&mut key[..]);
+        key
+    };
+}
+
+/// Register the host that seals and persists fast-unlock bundles. Passing
+/// `None` detaches it.
+pub fn set_fast_unlock_sink(sink: Option<FastUnlockSink>) {
+    *SINK.write() = sink;
+}
+
+/// Opt in to (or out of) fast unlock.
+///
+/// While enabled, every passphrase KDF result is remembered for the session
+/// and, after an unlock with the full KDF, exported to the sink so the host
+/// can seal it with the OS account keystore. The next launch then checks the
+/// passphrase against the bundle and opens the databases with the stored keys
+/// instead of running Argon2id again. The trade-off: until `max_age` runs out,
+/// the derived keys are protected by the OS account instead of by the KDF
+/// cost, and anyone able to unseal the bundle can test passphrase guesses at
+/// hash speed. Disabling forgets the cache and deletes the stored bundle.
+pub fn set_fast_unlock_policy(enabled: bool, max_age: Option<Duration>) {
+    {
+        let mut policy = POLICY.write();
+        policy.enabled = enabled;
+        policy.max_age = max_age.unwrap_or(FAST_UNLOCK_DEFAULT_MAX_AGE);
+    }
+    if !enabled {
+        forget();
+    }
+}
+
+/// Register where the bundle sealed by the previous session comes from. The
+/// first unlock after fast unlock was enabled asks it, waiting briefly while
+/// it reports [`FastUnlockLoad::Pending`]; once it answers with a bundle or
+/// [`FastUnlockLoad::Empty`] it is not asked again this launch.
+pub fn set_fast_unlock_source(source: Option<FastUnlockSource>) {
+    *SOURCE.write() = source;
+}
+
+/// Argon2id for `passphrase` and `salt`, answered from the session cache when
+/// fast unlock is enabled and this pair was derived (or primed) before.
+pub(super) fn derive_key(passphrase: &str, salt: &[u8]) -> pirate_storage_sqlite::Result<[u8; 32]> {
+    if !POLICY.read().enabled {
+        return derive_key_bytes(passphrase, salt);
+    }
+    let tag = cache_tag(passphrase, salt);
+    if let Some(cached) = STATE.lock().keys.iter().find(|k| digest_eq(&k.tag, &tag)) {
+        return Ok(*cached.key);
+    }
+
+    let key = derive_key_bytes(passphrase, salt)?;
+    let exporting = {
+        let mut state = STATE.lock();
+        remember(&mut state, tag, salt, &key);
+        state.expires_at.is_some()
+    };
+    // Keys for the unlocked passphrase join the stored bundle; keys for a
+    // passphrase that is merely being checked never do.
+    if exporting
+        && passphrase_store::get_passphrase().is_ok_and(|current| current.as_str() == passphrase)
+    {
+        export(passphrase);
+    }
+    Ok(key)
+}
+
+/// Try the staged bundle for `passphrase`. On success its keys are in the
+/// cache, the bundle is consumed and the caller may skip the passphrase hash
+/// check; the databases still reject keys that do not match. A bundle that is
+/// stale, expired or unreadable is dropped; a wrong passphrase leaves it in
+/// place for the next attempt.
+pub(super) fn prime(passphrase: &str) -> bool {
+    let (enabled, max_age) = {
+        let policy = POLICY.read();
+        (policy.enabled, policy.max_age)
+    };
+    if !enabled {
+        STATE.lock().staged = None;
+        return false;
+    }
+    fetch_staged();
+    let mut state = STATE.lock();
+    let Some(staged) = state.staged.as_ref() else {
+        return false;
+    };
+    let bundle: Bundle = match serde_json::from_slice(staged) {
+        Ok(bundle) => bundle,
+        Err(e) => {
+            tracing::debug!("Dropping unreadable fast-unlock bundle: {}", e);
+            state.staged = None;
+            return false;
+        }
+    };
+
+    let now = chrono::Utc::now().timestamp();
+    let max_age = i64::try_from(max_age.as_secs()).unwrap_or(i64::MAX);
+    let expires_at = bundle
+        .expires_at
+        .min(bundle.created_at.saturating_add(max_age));
+    if bundle.v != FAST_UNLOCK_BUNDLE_VERSION || now >= expires_at || now < bundle.created_at {
+        tracing::info!("Fast-unlock bundle expired; using the passphrase KDF");
+        state.staged = None;
+        return false;
+    }
+
+    let Ok(verifier_salt) = hex::decode(&bundle.verifier_salt) else {
+        state.staged = None;
+        return false;
+    };
+    let verifier = keyed_digest(
+        VERIFIER_DOMAIN,
+        &[&verifier_salt[..], passphrase.as_bytes()],
+    );
+    if !hex::decode(&bundle.verifier).is_ok_and(|stored| digest_eq(&stored, &verifier)) {
+        return false;
+    }
+
+    let mut primed = Vec::with_capacity(bundle.keys.len());
+    for entry in &bundle.keys {
+        let salt = hex::decode(&entry.salt);
+        let key = hex::decode(&entry.key).map(Zeroizing::new);
+        match (salt, key) {
+            (Ok(salt), Ok(key)) if key.len() == 32 => {
+                let mut bytes = Zeroizing::new([0u8; 32]);
+                bytes.copy_from_slice(&key);
+                primed.push((salt, bytes));
+            }
+            _ => {
+                state.staged = None;
+                return false;
+            }
+        }
+    }
+
+    state.staged = None;
+    state.expires_at = Some(expires_at);
+    for (salt, key) in primed {
+        let tag = cache_tag(passphrase, &salt);
+        remember(&mut state, tag, &salt, &key);
+    }
+    true
+}
+
+/// Start a new grace period after an unlock that ran the full KDF and export
+/// the keys derived for `passphrase` so far.
+pub(super) fn publish(passphrase: &str) {
+    let (enabled, max_age) = {
+        let policy = POLICY.read();
+        (policy.enabled, policy.max_age)
+    };
+    if !enabled || SINK.read().is_none() {
+        return;
+    }
+    let max_age = i64::try_from(max_age.as_secs()).unwrap_or(i64::MAX);
+    STATE.lock().expires_at = Some(chrono::Utc::now().timestamp().saturating_add(max_age));
+    export(passphrase);
+}
+
+/// Forget every derived key and delete the stored bundle. Used when fast
+/// unlock is disabled, the passphrase or storage namespace changes, a decoy
+/// vault opens, or the stored keys turned out not to open the databases.
+pub(super) fn forget() {
+    {
+        let mut state = STATE.lock();
+        state.keys.clear();
+        state.staged = None;
+        state.fetched = true;
+        state.expires_at = None;
+    }
+    deliver(&[]);
+}
+
+fn fetch_staged() {
+    let source = SOURCE.read();
+    let Some(source) = source.as_ref() else {
+        return;
+    };
+    if STATE.lock().fetched {
+        return;
+    }
+    let started = std::time::Instant::now();
+    let bundle = loop {
+        match source() {
+            FastUnlockLoad::Bundle(bundle) => break Some(Zeroizing::new(bundle)),
+            FastUnlockLoad::Empty => break None,
+            FastUnlockLoad::Pending if started.elapsed() < FAST_UNLOCK_LOAD_WAIT => {
+                std::thread::sleep(FAST_UNLOCK_LOAD_POLL);
+            }
+            FastUnlockLoad::Pending => {
+                // Not settled: the next unlock asks again.
+                tracing::info!("Fast-unlock bundle still loading; using the passphrase KDF");
+                return;
+            }
+        }
+    };
+    let mut state = STATE.lock();
+    // A forget() while waiting already decided this launch's bundle.
+    if std::mem::replace(&mut state.fetched, true) {
+        return;
+    }
+    if let Some(bundle) = bundle.filter(|bundle| !bundle.is_empty()) {
+        state.staged = Some(bundle);
+    }
+}
+
+fn remember(state: &mut FastUnlockState, tag: [u8; 32], salt: &[u8], key: &[u8; 32]) {
+    if state.keys.iter().any(|k| digest_eq(&k.tag, &tag)) {
+        return;
+    }
+    if state.keys.len() >= FAST_UNLOCK_MAX_CACHED_KEYS {
+        state.keys.remove(0);
+    }
+    state.keys.push(CachedKey {
+        tag,
+        salt: salt.to_vec(),
+        key: Zeroizing::new(*key),
+    });
+}
+
+fn export(passphrase: &str) {
+    let document = {
+        let state = STATE.lock();
+        let Some(expires_at) = state.expires_at else {
+            return;
+        };
+        encode(
+            &state,
+            passphrase,
+            chrono::Utc::now().timestamp(),
+            expires_at,
+        )
+    };
+    if !document.is_empty() {
+        deliver(&document);
+    }
+}
+
+fn encode(
+    state: &FastUnlockState,
+    passphrase: &str,
+    created_at: i64,
+    expires_at: i64,
+) -> Zeroizing<Vec<u8>> {
+    let keys: Vec<BundleKey> = state
+        .keys
+        .iter()
+        .filter(|k| digest_eq(&k.tag, &cache_tag(passphrase, &k.salt)))
+        .map(|k| BundleKey {
+            salt: hex::encode(&k.salt),
+            key: hex::encode(&k.key[..]),
+        })
+        .collect();
+    if keys.is_empty() {
+        return Zeroizing::new(Vec::new());
+    }
+
+    let mut verifier_salt = [0u8; 16];
+    rand::thread_rng().fill_bytes(&mut verifier_salt);
+    let verifier = keyed_digest(
+        VERIFIER_DOMAIN,
+        &[&verifier_salt[..], passphrase.as_bytes()],
+    );
+    let bundle = Bundle {
+        v: FAST_UNLOCK_BUNDLE_VERSION,
+        created_at,
+        expires_at,
+        verifier_salt: hex::encode(verifier_salt),
+        verifier: hex::encode(verifier),
+        keys,
+    };
+    Zeroizing::new(serde_json::to_vec(&bundle).unwrap_or_default())
+}
+
+fn deliver(document: &[u8]) {
+    if let Some(sink) = SINK.read().as_ref() {
+        sink(document);
+    }
+}
+
+fn cache_tag(passphrase: &str, salt: &[u8]) -> [u8; 32] {
+    keyed_digest(&TAG_KEY[..], &[salt, passphrase.as_bytes()])
+}
+
+/// SHA-256 over a fixed key and length-prefixed parts, so no two part lists
+/// hash the same input.
+fn keyed_digest(key: &[u8], parts: &[&[u8]]) -> [u8; 32] {
+    let mut hasher = Sha256::new();
+    hasher.update(key);
+    for part in parts {
+        hasher.update((part.len() as u64).to_le_bytes());
+        hasher.update(*part);
+    }
+    hasher.finalize().into()
+}
+
+fn digest_eq(a: &[u8], b: &[u8]) -> bool {
+    a.len() == b.len() && a.iter().zip(b).fold(0u8, |acc, (x, y)| acc | (x ^ y)) == 0
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    fn state_with_key(passphrase: &str, salt: &[u8], key: [u8; 32]) -> FastUnlockState {
+        let mut state = FastUnlockState::default();
+        remember(&mut state, cache_tag(passphrase, salt), salt, &key);
+        remember(
+            &mut state,
+            cache_tag("other", b"salt-2"),
+            b"salt-2",
+            &[9u8; 32],
+        );
+        state
+    }
+
+    #[test]
+    fn bundle_carries_only_keys_for_the_exporting_passphrase() {
+        let state = state_with_key("correct horse", b"salt-1", [7u8; 32]);
+        let document = encode(&state, "correct horse", 100, 200);
+        let bundle: Bundle = serde_json::from_slice(&document).unwrap();
+        assert_eq!(bundle.v, FAST_UNLOCK_BUNDLE_VERSION);
+        assert_eq!(bundle.expires_at, 200);
+        assert_eq!(bundle.keys.len(), 1);
+        assert_eq!(bundle.keys[0].salt, hex::encode(b"salt-1"));
+        assert_eq!(bundle.keys[0].key, hex::encode([7u8; 32]));
+
+        let verifier_salt = hex::decode(&bundle.verifier_salt).unwrap();
+        let expected = keyed_digest(VERIFIER_DOMAIN, &[&verifier_salt[..], b"correct horse"]);
+        assert_eq!(bundle.verifier, hex::encode(expected));
+        assert!(encode(&state, "nobody", 100, 200).is_empty());
+    }
+}
@@ -0,0 +1,209 @@
+//! Headless sync daemon for Linux hosts that only keep wallets synced.
+//!
+//! The desktop runner hands over to [`run_headless_sync`] before GTK or the
+//! Flutter engine start. Registered wallets sync concurrently in this one
+//! process through the sync scheduler, so they share the per-endpoint block
+//! cache and its in-flight range de-duplication: each compact block is
+//! downloaded once. Status is served as one JSON document per connection on a
+//! local Unix socket.
+
+use super::*;
+use std::io::{BufRead, Write};
+use std::os::unix::fs::{FileTypeExt, PermissionsExt};
+use std::os::unix::net::{UnixListener, UnixStream};
+use std::time::Instant;
+use tokio::signal::unix::{signal, SignalKind};
+
+const STATUS_SOCKET_NAME: &str = "pirate-wallet-headless.sock";
+const DEFAULT_RESYNC_INTERVAL: Duration = Duration::from_secs(30);
+
+/// Command-line options for [`run_headless_sync`].
+#[derive(Debug, Clone, PartialEq, Eq)]
+pub struct HeadlessSyncOptions {
+    /// File holding the app passphrase; stdin is read when unset.
+    pub passphrase_file: Option<PathBuf>,
+    /// Unix socket that serves sync status.
+    pub status_socket: PathBuf,
+    /// How often idle wallets are re-synced to follow the chain tip.
+    pub resync_interval: Duration,
+}
+
+impl HeadlessSyncOptions {
+    /// Parse `--passphrase-file=PATH`, `--status-socket=PATH` and
+    /// `--resync-interval-secs=N`. Unknown arguments are rejected so a typo
+    /// does not silently fall back to a default.
+    pub fn from_args<I>(args: I) -> Result<Self>
+    where
+        I: IntoIterator<Item = String>,
+    {
+        let mut options = Self {
+            passphrase_file: None,
+            status_socket: default_status_socket()?,
+            resync_interval: DEFAULT_RESYNC_INTERVAL,
+        };
+        for arg in args {
+            if let Some(path) = arg.strip_prefix("--passphrase-file=") {
+                options.passphrase_file = Some(PathBuf::from(path));
+            } else if let Some(path) = arg.strip_prefix("--status-socket=") {
+                options.status_socket = PathBuf::from(path);
+            } else if let Some(secs) = arg.strip_prefix("--resync-interval-secs=") {
+                let secs: u64 = secs
+                    .parse()
+                    .map_err(|_| anyhow!("Invalid --resync-interval-secs: {}", secs))?;
+                options.resync_interval = Duration::from_secs(secs.max(1));
+            } else {
+                return Err(anyhow!("Unknown headless sync argument: {}", arg));
+            }
+        }
+        Ok(options)
+    }
+}
+
+/// Unlock the registry, keep every wallet syncing and serve status until
+/// SIGTERM or SIGINT. Blocks the calling thread.
+pub fn run_headless_sync(options: HeadlessSyncOptions) -> Result<()> {
+    let passphrase = read_passphrase(options.passphrase_file.as_deref())?;
+    unlock_app(passphrase)?;
+
+    let listener = bind_status_socket(&options.status_socket)?;
+    let started = Instant::now();
+    std::thread::Builder::new()
+        .name("headless-status".to_string())
+        .spawn(move || serve_status(listener, started))?;
+    tracing::info!(
+        "headless sync running; status on {}",
+        options.status_socket.display()
+    );
+
+    let result = crate::service::WalletService::runtime().block_on(async {
+        let mut terminate = signal(SignalKind::terminate())?;
+        let mut interrupt = signal(SignalKind::interrupt())?;
+        let mut ticker = tokio::time::interval(options.resync_interval);
+        loop {
+            tokio::select! {
+                _ = ticker.tick() => start_idle_syncs().await,
+                _ = terminate.recv() => break,
+                _ = interrupt.recv() => break,
+            }
+        }
+        for wallet in list_wallets().unwrap_or_default() {
+            if let Err(e) = cancel_sync(wallet.id.clone()).await {
+                tracing::warn!("headless sync: cancel {} failed: {}", wallet.id, e);
+            }
+        }
+        Ok::<(), anyhow::Error>(())
+    });
+
+    let _ = fs::remove_file(&options.status_socket);
+    result
+}
+
+/// `$XDG_RUNTIME_DIR` is per-user and 0700; fall back to the wallet data
+/// directory when it is unset (e.g. a system service without a session).
+fn default_status_socket() -> Result<PathBuf> {
+    if let Some(dir) = env::var_os("XDG_RUNTIME_DIR").filter(|dir| !dir.is_empty()) {
+        return Ok(PathBuf::from(dir).join(STATUS_SOCKET_NAME));
+    }
+    Ok(encrypted_db::wallet_base_dir()?.join(STATUS_SOCKET_NAME))
+}
+
+fn read_passphrase(path: Option<&Path>) -> Result<String> {
+    let mut passphrase = match path {
+        Some(path) => fs::read_to_string(path)
+            .map_err(|e| anyhow!("Failed to read {}: {}", path.display(), e))?,
+        None => {
+            let mut line = String::new();
+            std::io::stdin().lock().read_line(&mut line)?;
+            line
+        }
+    };
+    while passphrase.ends_with('\n') || passphrase.ends_with('\r') {
+        passphrase.pop();
+    }
+    if passphrase.is_empty() {
+        return Err(anyhow!("App passphrase required"));
+    }
+    Ok(passphrase)
+}
+
+fn bind_status_socket(path: &Path) -> Result<UnixListener> {
+    // A socket left by a daemon that was killed would make bind fail; never
+    // remove anything that is not a socket.
+    if let Ok(metadata) = fs::symlink_metadata(path) {
+        if !metadata.file_type().is_socket() {
+            return Err(anyhow!("{} exists and is not a socket", path.display()));
+        }
+        fs::remove_file(path)?;
+    }
+    if let Some(parent) = path.parent() {
+        fs::create_dir_all(parent)?;
+    }
+    let listener = UnixListener::bind(path)?;
+    fs::set_permissions(path, fs::Permissions::from_mode(0o600))?;
+    Ok(listener)
+}
+
+/// Top up running syncs through the scheduler. Completed syncs stop at the
+/// tip, so this is also what follows new blocks.
+async fn start_idle_syncs() {
+    match schedule_wallet_syncs(None).await {
+        Ok(report) if !report.started.is_empty() => {
+            tracing::info!("headless sync: started {:?}", report.started);
+        }
+        Ok(_) => {}
+        Err(e) => tracing::warn!("headless sync: schedule failed: {}", e),
+    }
+}
+
+fn serve_status(listener: UnixListener, started: Instant) {
+    for stream in listener.incoming() {
+        match stream {
+            Ok(stream) => write_status(stream, started),
+            Err(e) => tracing::warn!("headless sync: status accept failed: {}", e),
+        }
+    }
+}
+
+fn write_status(mut stream: UnixStream, started: Instant) {
+    let wallets: Vec<serde_json::Value> = list_wallets()
+        .unwrap_or_default()
+        .into_iter()
+        .map(|wallet| {
+            let status = sync_status(wallet.id.clone()).ok();
+            serde_json::json!({
+                "id": wallet.id,
+                "name": wallet.name,
+                "running": is_sync_running(wallet.id.clone()).unwrap_or(false),
+                "status": status,
+            })
+        })
+        .collect();
+    let document = serde_json::json!({
+        "uptime_secs": started.elapsed().as_secs(),
+        "wallets": wallets,
+    });
+    let _ = writeln!(stream, "{}", document);
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn parses_headless_sync_arguments() {
+        let options = HeadlessSyncOptions::from_args([
+            "--passphrase-file=/run/credentials/pass".to_string(),
+            "--status-socket=/tmp/status.sock".to_string(),
+            "--resync-interval-secs=0".to_string(),
+        ])
+        .unwrap();
+        assert_eq!(
+            options.passphrase_file,
+            Some(PathBuf::from("/run/credentials/pass"))
+        );
+        assert_eq!(options.status_socket, PathBuf::from("/tmp/status.sock"));
+        assert_eq!(options.resync_interval, Duration::from_secs(1));
+
+        assert!(HeadlessSyncOptions::from_args(["--passphrase=x".to_string()]).is_err());
+    }
+}
@@ -204,6 +204,8 @@ pub(super) fn verify_panic_pin(pin: String) -> Result<bool> {
         vault
             .activate_decoy()
             .map_err(|e| anyhow!("Failed to activate decoy: {}", e))?;
+        warm_snapshot::forget_all();
+        fast_unlock::forget();
         tracing::warn!("Decoy vault activated via panic PIN");
     }
 
@@ -337,6 +339,8 @@ pub(super) fn verify_duress_passphrase(passphrase: String) -> Result<bool> {
             .activate_decoy()
             .map_err(|e| anyhow!("Failed to activate decoy: {}", e))?;
         ensure_decoy_wallet_state();
+        warm_snapshot::forget_all();
+        fast_unlock::forget();
         tracing::warn!("Decoy vault activated via duress passphrase");
     }
 
@@ -0,0 +1,110 @@
+use super::*;
+use pirate_core::ProverStatus;
+use std::io::Read;
+use std::sync::OnceLock;
+use std::time::Instant;
+
+/// What a pre-warm pass touched, for startup logging.
+#[derive(Debug, Clone, Default)]
+pub struct PrewarmReport {
+    pub registry_bytes: u64,
+    pub block_caches: usize,
+    pub elapsed_ms: u64,
+}
+
+static PREWARM: OnceLock<PrewarmReport> = OnceLock::new();
+
+/// Warm the backend before the UI asks for anything: pull the wallet registry
+/// files into the OS page cache and walk the block cache indices. The registry
+/// is SQLCipher-encrypted and the app is still locked here, so its files are
+/// read rather than opened. The shared runtime is not built here, so the host
+/// can still size it with `configure_runtime`.
+///
+/// Safe to call from any thread and more than once; only the first call does
+/// work, later calls wait for it and return the same report.
+pub fn prewarm_backend() -> PrewarmReport {
+    PREWARM
+        .get_or_init(|| {
+            let _span = crate::perf::span("prewarm_backend");
+            let started = Instant::now();
+
+            let mut report = PrewarmReport::default();
+            if let Ok(base) = encrypted_db::wallet_base_dir() {
+                for name in [
+                    "wallet_registry.db",
+                    "wallet_registry.salt",
+                    "wallet_registry.dbkey",
+                ] {
+                    report.registry_bytes += read_through(&base.join(name));
+                }
+            }
+            report.block_caches = pirate_sync_lightd::prewarm_block_cache_indices();
+            report.elapsed_ms = started.elapsed().as_millis() as u64;
+            tracing::debug!(
+                "backend prewarm: {} registry bytes, {} block caches in {}ms",
+                report.registry_bytes,
+                report.block_caches,
+                report.elapsed_ms
+            );
+            report
+        })
+        .clone()
+}
+
+/// Start loading the Sapling prover on a low-priority background thread, so
+/// the first send does not freeze on it. Runners call this from their startup
+/// pre-warm and the app on its first visit to the send screen. Returns at once
+/// with the current status; poll [`prover_status`] for `ready`. The parameters
+/// stay loaded for the session.
+pub fn prewarm_prover() -> ProverStatus {
+    static STARTED: OnceLock<()> = OnceLock::new();
+    STARTED.get_or_init(|| {
+        let spawned = std::thread::Builder::new()
+            .name("pirate-prover-prewarm".to_string())
+            .spawn(|| {
+                let _span = crate::perf::span("prewarm_prover");
+                lower_current_thread_priority();
+                pirate_core::prewarm_provers();
+            });
+        if let Err(e) = spawned {
+            tracing::warn!("prover prewarm thread failed to start: {}", e);
+        }
+    });
+    prover_status()
+}
+
+/// Whether a transaction build would still wait for proving parameters.
+pub fn prover_status() -> ProverStatus {
+    pirate_core::prover_status()
+}
+
+/// Let the UI and sync threads win over the pre-warm when cores are busy.
+/// On Linux and Android `setpriority` with id 0 applies to the calling thread
+/// only.
+#[cfg(any(target_os = "linux", target_os = "android"))]
+fn lower_current_thread_priority() {
+    // SAFETY: setpriority takes plain integers and touches no memory of ours.
+    let result = unsafe { libc::setpriority(libc::PRIO_PROCESS, 0, 10) };
+    if result != 0 {
+        tracing::debug!("prover prewarm thread priority change refused");
+    }
+}
+
+#[cfg(not(any(target_os = "linux", target_os = "android")))]
+fn lower_current_thread_priority() {}
+
+/// Read `path` start to end and discard the bytes, leaving it in the page
+/// cache. Missing files count as zero.
+fn read_through(path: &Path) -> u64 {
+    let Ok(mut file) = fs::File::open(path) else {
+        return 0;
+    };
+    let mut buffer = vec![0u8; 256 * 1024];
+    let mut total = 0u64;
+    loop {
+        match file.read(&mut buffer) {
+            Ok(0) | Err(_) => return total,
+            Ok(n) => total += n as u64,
+        }
+    }
+}
@@ -116,6 +116,7 @@ fn cache_sync_status(wallet_id: &WalletId, status: &SyncStatus) {
     SYNC_STATUS_SNAPSHOT_CACHE
         .write()
         .insert(wallet_id.clone(), status.clone());
+    warm_snapshot::note_sync_checkpoint(wallet_id, status, false);
 }
 
 fn get_cached_sync_status(wallet_id: &WalletId) -> Option<SyncStatus> {
@@ -530,6 +531,22 @@ impl Default for SyncSession {
     }
 }
 
+/// Clients for the wallet's configured mirrors, on the same transport and
+/// timeouts as the primary sync client.
+fn mirror_clients(wallet_id: &WalletId) -> Vec<LightClient> {
+    endpoint::get_lightd_mirrors(wallet_id)
+        .iter()
+        .map(|mirror| {
+            LightClient::with_config(tunnel::light_client_config_for_endpoint(
+                mirror,
+                RetryConfig::default(),
+                std::time::Duration::from_secs(30),
+                std::time::Duration::from_secs(60),
+            ))
+        })
+        .collect()
+}
+
 pub(super) async fn start_sync(wallet_id: WalletId, mode: SyncMode) -> Result<()> {
     ensure_not_decoy("Sync")?;
     tracing::info!("Starting sync for wallet {} in mode {:?}", wallet_id, mode);
@@ -767,6 +784,7 @@ pub(super) async fn start_sync(wallet_id: WalletId, mode: SyncMode) -> Result<()
 
     let client = LightClient::with_config(client_config);
     let sync = match SyncEngine::with_client_and_config(client, birthday_height, config)
+        .with_fetch_mirrors(mirror_clients(&wallet_id))
         .with_wallet_at_path(
             wallet_id.clone(),
             db_path,
@@ -889,6 +907,11 @@ pub(super) async fn start_sync(wallet_id: WalletId, mode: SyncMode) -> Result<()
         match &result {
             Ok(()) => {
                 tracing::info!("Sync task exited for wallet {}", wallet_id_for_task);
+                warm_snapshot::note_sync_checkpoint(
+                    &wallet_id_for_task,
+                    &session.last_status,
+                    true,
+                );
                 if let Ok(registry_db) = open_wallet_registry() {
                     if let Err(e) = touch_wallet_last_synced(&registry_db, &wallet_id_for_task) {
                         tracing::warn!(
@@ -1992,6 +2015,7 @@ pub(super) async fn rescan(wallet_id: WalletId, from_height: u32) -> Result<()>
 
     let client = LightClient::with_config(client_config);
     let sync = match SyncEngine::with_client_and_config(client, effective_from_height, config)
+        .with_fetch_mirrors(mirror_clients(&wallet_id))
         .with_wallet_at_path(
             wallet_id.clone(),
             db_path,
@@ -2383,6 +2407,8 @@ pub(super) fn active_sync_wallet_ids() -> Vec<WalletId> {
 }
 
 pub(super) fn clear_all_runtime_state() {
+    warm_snapshot::forget_all();
+    fast_unlock::forget();
     SYNC_SESSIONS.write().clear();
     SYNC_RUNTIME_HANDLES.write().clear();
     SYNC_STATUS_SNAPSHOT_CACHE.write().clear();
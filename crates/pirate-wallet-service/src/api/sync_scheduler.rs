@@ -0,0 +1,83 @@
+//! Concurrent sync across registered wallets.
+//!
+//! Each call tops up the number of running syncs to a concurrency limit. The
+//! active wallet always starts first, even over the limit, and is marked as
+//! the priority wallet so its trial decryption gets the larger share of
+//! workers. Remaining slots go to idle wallets round-robin, so a long list of
+//! wallets does not starve its tail. All sessions share the per-endpoint
+//! block cache, so a compact block range is fetched once for every wallet.
+
+use super::*;
+use serde::{Deserialize, Serialize};
+use std::sync::atomic::{AtomicUsize, Ordering};
+
+/// Where the next round-robin pass starts in the idle wallet list.
+static SCHEDULE_CURSOR: AtomicUsize = AtomicUsize::new(0);
+
+/// Outcome of one [`schedule_wallet_syncs`] pass.
+#[derive(Debug, Clone, Default, Serialize, Deserialize)]
+pub struct SyncScheduleReport {
+    /// Concurrency limit the pass used.
+    pub max_concurrent: u32,
+    /// Wallets whose sync was started by this pass.
+    pub started: Vec<WalletId>,
+    /// Wallets that were already syncing.
+    pub running: Vec<WalletId>,
+    /// Idle wallets left for a later pass.
+    pub deferred: Vec<WalletId>,
+}
+
+/// A quarter of the cores, 1 to 4: each sync already fans its own trial
+/// decryption out over the decrypt pool.
+fn default_max_concurrent() -> usize {
+    (num_cpus::get() / 4).clamp(1, 4)
+}
+
+/// Start compact sync for idle wallets up to `max_concurrent` running syncs
+/// (a CPU-based default when unset). Call again whenever syncs finish or the
+/// active wallet changes.
+pub async fn schedule_wallet_syncs(max_concurrent: Option<u32>) -> Result<SyncScheduleReport> {
+    let limit = max_concurrent
+        .map(|limit| limit.max(1) as usize)
+        .unwrap_or_else(default_max_concurrent);
+    let active = get_active_wallet().ok().flatten();
+    pirate_sync_lightd::set_priority_sync_wallet(active.as_deref());
+
+    let mut report = SyncScheduleReport {
+        max_concurrent: limit as u32,
+        ..SyncScheduleReport::default()
+    };
+    let mut idle = Vec::new();
+    for wallet in list_wallets()? {
+        if is_sync_running(wallet.id.clone()).unwrap_or(false) {
+            report.running.push(wallet.id);
+        } else if active.as_deref() == Some(wallet.id.as_str()) {
+            start_scheduled(wallet.id, &mut report).await;
+        } else {
+            idle.push(wallet.id);
+        }
+    }
+
+    let slots = limit.saturating_sub(report.running.len() + report.started.len());
+    if !idle.is_empty() {
+        let offset = SCHEDULE_CURSOR.load(Ordering::Relaxed) % idle.len();
+        idle.rotate_left(offset);
+        let take = slots.min(idle.len());
+        SCHEDULE_CURSOR.store(offset + take, Ordering::Relaxed);
+        report.deferred = idle.split_off(take);
+        for wallet_id in idle {
+            start_scheduled(wallet_id, &mut report).await;
+        }
+    }
+    Ok(report)
+}
+
+async fn start_scheduled(wallet_id: WalletId, report: &mut SyncScheduleReport) {
+    match start_sync(wallet_id.clone(), SyncMode::Compact).await {
+        Ok(()) => report.started.push(wallet_id),
+        Err(e) => {
+            tracing::warn!("sync scheduler: start {} failed: {}", wallet_id, e);
+            report.deferred.push(wallet_id);
+        }
+    }
+}
@@ -356,6 +356,7 @@ pub(super) fn delete_wallet(wallet_id: WalletId) -> Result<()> {
     }
 
     sync_control::clear_wallet_sync_state(&wallet_id);
+    warm_snapshot::forget_wallet(&wallet_id);
     encrypted_db::invalidate_wallet_db_cache_for(&wallet_id);
 
     endpoint::remove_cached_lightd_endpoint(&wallet_id);
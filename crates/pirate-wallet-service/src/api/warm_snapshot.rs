@@ -0,0 +1,282 @@
+use super::*;
+use serde::{Deserialize, Serialize};
+use std::time::Instant;
+
+/// Schema version of the warm-start document. Readers drop documents with a
+/// version they do not know.
+pub const WARM_SNAPSHOT_VERSION: u32 = 1;
+
+/// Newest transactions kept per wallet; enough for the dashboard list.
+const WARM_SNAPSHOT_TX_LIMIT: u32 = 20;
+
+/// Checkpoints land every few seconds while catching up; the dashboard only
+/// needs a recent picture, not every one of them.
+const WARM_SNAPSHOT_MIN_INTERVAL: Duration = Duration::from_secs(30);
+
+/// Receives each encoded snapshot. An empty slice means "forget the stored
+/// snapshot".
+pub type WarmSnapshotSink = Box<dyn Fn(&[u8]) + Send + Sync>;
+
+/// Hands over the document the previous session persisted, or `None` when
+/// the host has none.
+pub type WarmSnapshotSource = Box<dyn Fn() -> Option<Vec<u8>> + Send + Sync>;
+
+#[derive(Debug, Clone, Serialize, Deserialize)]
+struct WalletSnapshot {
+    wallet_id: WalletId,
+    synced_height: u64,
+    balance: Balance,
+    transactions: Vec<TxInfo>,
+}
+
+#[derive(Serialize)]
+struct SnapshotDocument<'a> {
+    v: u32,
+    saved_at: i64,
+    active_wallet_id: Option<WalletId>,
+    wallets: Vec<&'a WalletSnapshot>,
+}
+
+#[derive(Deserialize)]
+struct StoredDocument {
+    v: u32,
+    #[serde(default)]
+    wallets: Vec<WalletSnapshot>,
+}
+
+#[derive(Default)]
+struct SnapshotState {
+    wallets: BTreeMap<WalletId, WalletSnapshot>,
+    last_published: HashMap<WalletId, Instant>,
+    /// The persisted document was merged in (or there was none), so encoding
+    /// `wallets` no longer drops wallets this session has not synced.
+    seeded: bool,
+    /// Checkpoint heights waiting for the publish thread, newest per wallet.
+    pending: BTreeMap<WalletId, u64>,
+    /// A publish thread is draining `pending`.
+    publishing: bool,
+}
+
+lazy_static::lazy_static! {
+    static ref SINK: RwLock<Option<WarmSnapshotSink>> = RwLock::new(None);
+    static ref SOURCE: RwLock<Option<WarmSnapshotSource>> = RwLock::new(None);
+    static ref STATE: parking_lot::Mutex<SnapshotState> =
+        parking_lot::Mutex::new(SnapshotState::default());
+}
+
+/// Register the host that seals and persists warm-start snapshots. Desktop
+/// runners install one so the dashboard can paint the last known balance and
+/// transactions before the wallet database is open; without a sink nothing is
+/// built. Passing `None` detaches it.
+pub fn set_warm_snapshot_sink(sink: Option<WarmSnapshotSink>) {
+    *SINK.write() = sink;
+}
+
+/// Register where the previous session's document comes from. It is read
+/// once, before the first snapshot is written, so wallets this session has
+/// not synced yet keep their entries.
+pub fn set_warm_snapshot_source(source: Option<WarmSnapshotSource>) {
+    *SOURCE.write() = source;
+}
+
+/// Called whenever sync caches a status. Builds and publishes a fresh
+/// snapshot on a helper thread when the wallet reached a new checkpoint, at
+/// most once per `WARM_SNAPSHOT_MIN_INTERVAL` per wallet. `force` skips the
+/// interval and height checks, for the final status of a sync run. Checkpoints
+/// that arrive while a publish is running are queued, newest per wallet.
+pub(super) fn note_sync_checkpoint(wallet_id: &WalletId, status: &SyncStatus, force: bool) {
+    let Some(height) = status.last_checkpoint else {
+        return;
+    };
+    if SINK.read().is_none() || is_decoy_mode_active() {
+        return;
+    }
+    {
+        let mut state = STATE.lock();
+        let unchanged = state
+            .wallets
+            .get(wallet_id)
+            .is_some_and(|snapshot| snapshot.synced_height == height);
+        let recent = state
+            .last_published
+            .get(wallet_id)
+            .is_some_and(|at| at.elapsed() < WARM_SNAPSHOT_MIN_INTERVAL);
+        if !force && (unchanged || recent) {
+            return;
+        }
+        state.pending.insert(wallet_id.clone(), height);
+        if std::mem::replace(&mut state.publishing, true) {
+            return;
+        }
+    }
+
+    std::thread::spawn(|| loop {
+        let Some((wallet_id, height)) = ({
+            let mut state = STATE.lock();
+            let next = state.pending.pop_first();
+            state.publishing = next.is_some();
+            next
+        }) else {
+            return;
+        };
+        let _span = crate::perf::span("warm_snapshot_publish");
+        if let Err(e) = publish(&wallet_id, height) {
+            tracing::debug!("warm snapshot for {} skipped: {}", wallet_id, e);
+        }
+    });
+}
+
+/// Drop `wallet_id` from the stored snapshot, after it was deleted or its
+/// chain state was cleared.
+pub(super) fn forget_wallet(wallet_id: &WalletId) {
+    let document = {
+        let mut state = STATE.lock();
+        seed_locked(&mut state);
+        state.last_published.remove(wallet_id);
+        state.pending.remove(wallet_id);
+        state.wallets.remove(wallet_id);
+        encode(&state)
+    };
+    deliver(&document);
+}
+
+/// Forget every snapshot, including the one the host persisted earlier. Used
+/// when the passphrase or storage namespace changes and when a decoy vault is
+/// opened, so real balances never outlive the state they came from.
+pub(super) fn forget_all() {
+    {
+        let mut state = STATE.lock();
+        state.wallets.clear();
+        state.last_published.clear();
+        state.pending.clear();
+        state.seeded = true;
+    }
+    deliver(&[]);
+}
+
+fn publish(wallet_id: &WalletId, height: u64) -> Result<()> {
+    let balance = get_balance(wallet_id.clone())?;
+    let transactions = list_transactions(wallet_id.clone(), Some(WARM_SNAPSHOT_TX_LIMIT))?
+        .into_iter()
+        .map(|tx| TxInfo { memo: None, ..tx })
+        .collect();
+    // The reads above can race a wallet switch into decoy mode.
+    if is_decoy_mode_active() {
+        return Ok(());
+    }
+
+    let document = {
+        let mut state = STATE.lock();
+        seed_locked(&mut state);
+        state.wallets.insert(
+            wallet_id.clone(),
+            WalletSnapshot {
+                wallet_id: wallet_id.clone(),
+                synced_height: height,
+                balance,
+                transactions,
+            },
+        );
+        state
+            .last_published
+            .insert(wallet_id.clone(), Instant::now());
+        encode(&state)
+    };
+    deliver(&document);
+    Ok(())
+}
+
+/// Merge the previous session's wallets into `state` the first time it is
+/// written after the host registered its source. Entries built this session
+/// win over stored ones.
+fn seed_locked(state: &mut SnapshotState) {
+    if state.seeded {
+        return;
+    }
+    let document = {
+        let source = SOURCE.read();
+        let Some(source) = source.as_ref() else {
+            return;
+        };
+        state.seeded = true;
+        source()
+    };
+    let Some(stored) = document.as_deref().and_then(decode) else {
+        return;
+    };
+    for snapshot in stored.wallets {
+        state
+            .wallets
+            .entry(snapshot.wallet_id.clone())
+            .or_insert(snapshot);
+    }
+}
+
+fn decode(document: &[u8]) -> Option<StoredDocument> {
+    serde_json::from_slice::<StoredDocument>(document)
+        .ok()
+        .filter(|stored| stored.v == WARM_SNAPSHOT_VERSION)
+}
+
+fn encode(state: &SnapshotState) -> Vec<u8> {
+    if state.wallets.is_empty() {
+        return Vec::new();
+    }
+    let document = SnapshotDocument {
+        v: WARM_SNAPSHOT_VERSION,
+        saved_at: chrono::Utc::now().timestamp(),
+        active_wallet_id: ACTIVE_WALLET.read().clone(),
+        wallets: state.wallets.values().collect(),
+    };
+    serde_json::to_vec(&document).unwrap_or_default()
+}
+
+fn deliver(document: &[u8]) {
+    if let Some(sink) = SINK.read().as_ref() {
+        sink(document);
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn encode_is_versioned_and_empty_without_wallets() {
+        let mut state = SnapshotState::default();
+        assert!(encode(&state).is_empty());
+
+        state.wallets.insert(
+            "w1".to_string(),
+            WalletSnapshot {
+                wallet_id: "w1".to_string(),
+                synced_height: 2_500_000,
+                balance: Balance {
+                    total: 5,
+                    spendable: 4,
+                    pending: 1,
+                },
+                transactions: vec![TxInfo {
+                    txid: "ab".to_string(),
+                    height: Some(2_499_990),
+                    timestamp: 1,
+                    amount: -3,
+                    fee: 1,
+                    memo: None,
+                    confirmed: true,
+                }],
+            },
+        );
+        let value: serde_json::Value = serde_json::from_slice(&encode(&state)).unwrap();
+        assert_eq!(value["v"], WARM_SNAPSHOT_VERSION);
+        assert_eq!(value["wallets"][0]["wallet_id"], "w1");
+        assert_eq!(value["wallets"][0]["synced_height"], 2_500_000);
+        assert_eq!(value["wallets"][0]["transactions"][0]["txid"], "ab");
+
+        let stored = decode(&encode(&state)).unwrap();
+        assert_eq!(stored.wallets.len(), 1);
+        assert_eq!(stored.wallets[0].synced_height, 2_500_000);
+        assert_eq!(stored.wallets[0].balance.spendable, 4);
+        assert!(decode(br#"{"v":99,"wallets":[]}"#).is_none());
+    }
+}
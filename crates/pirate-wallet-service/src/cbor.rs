@@ -0,0 +1,169 @@
+//! CBOR wire format for the native service.
+//!
+//! Requests and responses use the same schema as the JSON entry points; the
+//! values are translated through `serde_json::Value` so every method works
+//! without a per-method codec. Byte fields that JSON has to spell out as hex
+//! strings or number arrays travel as CBOR byte strings instead.
+
+use ciborium::value::{Integer, Value as CborValue};
+use serde_json::{Map, Number, Value};
+
+/// Fields carried as hex strings in JSON. Bytes keep the order of the hex
+/// string (display order for txids).
+const HEX_FIELDS: &[&str] = &["txid", "memo_hex"];
+/// Fields carried as arrays of byte values in JSON.
+const BYTE_ARRAY_FIELDS: &[&str] = &["raw"];
+
+/// Decode a CBOR request into the JSON value the request schema expects.
+pub(crate) fn decode_request(bytes: &[u8]) -> Result<Value, String> {
+    let value: CborValue = ciborium::de::from_reader(bytes).map_err(|e| e.to_string())?;
+    from_cbor(value, None)
+}
+
+/// Encode a JSON value as CBOR into `out`. `bytes_result` marks a response
+/// whose `result` is itself a byte array (`fetch_external_bytes`).
+pub(crate) fn encode_response(
+    value: Value,
+    bytes_result: bool,
+    out: &mut Vec<u8>,
+) -> Result<(), String> {
+    let key = bytes_result.then_some(BYTE_ARRAY_FIELDS[0]);
+    let value = match value {
+        Value::Object(map) => CborValue::Map(
+            map.into_iter()
+                .map(|(k, v)| {
+                    let field = if k == "result" { key } else { Some(k.as_str()) };
+                    let v = to_cbor(v, field);
+                    (CborValue::Text(k), v)
+                })
+                .collect(),
+        ),
+        other => to_cbor(other, None),
+    };
+    ciborium::ser::into_writer(&value, out).map_err(|e| e.to_string())
+}
+
+fn to_cbor(value: Value, field: Option<&str>) -> CborValue {
+    match value {
+        Value::Null => CborValue::Null,
+        Value::Bool(b) => CborValue::Bool(b),
+        Value::Number(n) => {
+            if let Some(u) = n.as_u64() {
+                CborValue::Integer(u.into())
+            } else if let Some(i) = n.as_i64() {
+                CborValue::Integer(i.into())
+            } else {
+                CborValue::Float(n.as_f64().unwrap_or_default())
+            }
+        }
+        Value::String(s) => {
+            if field.is_some_and(|f| HEX_FIELDS.contains(&f)) {
+                if let Ok(bytes) = hex::decode(&s) {
+                    return CborValue::Bytes(bytes);
+                }
+            }
+            CborValue::Text(s)
+        }
+        Value::Array(items) => {
+            if field.is_some_and(|f| BYTE_ARRAY_FIELDS.contains(&f)) {
+                let bytes: Option<Vec<u8>> = items
+                    .iter()
+                    .map(|item| item.as_u64().and_then(|b| u8::try_from(b).ok()))
+                    .collect();
+                if let Some(bytes) = bytes {
+                    return CborValue::Bytes(bytes);
+                }
+            }
+            CborValue::Array(items.into_iter().map(|item| to_cbor(item, None)).collect())
+        }
+        Value::Object(map) => CborValue::Map(
+            map.into_iter()
+                .map(|(k, v)| {
+                    let v = to_cbor(v, Some(k.as_str()));
+                    (CborValue::Text(k), v)
+                })
+                .collect(),
+        ),
+    }
+}
+
+fn from_cbor(value: CborValue, field: Option<&str>) -> Result<Value, String> {
+    Ok(match value {
+        CborValue::Null => Value::Null,
+        CborValue::Bool(b) => Value::Bool(b),
+        CborValue::Integer(i) => integer_to_json(i)?,
+        CborValue::Float(f) => Number::from_f64(f)
+            .map(Value::Number)
+            .ok_or_else(|| format!("unsupported float {f}"))?,
+        CborValue::Text(s) => Value::String(s),
+        CborValue::Bytes(bytes) => {
+            if field.is_some_and(|f| BYTE_ARRAY_FIELDS.contains(&f)) {
+                Value::Array(bytes.into_iter().map(Value::from).collect())
+            } else {
+                Value::String(hex::encode(bytes))
+            }
+        }
+        CborValue::Array(items) => Value::Array(
+            items
+                .into_iter()
+                .map(|item| from_cbor(item, None))
+                .collect::<Result<_, _>>()?,
+        ),
+        CborValue::Map(entries) => {
+            let mut map = Map::with_capacity(entries.len());
+            for (k, v) in entries {
+                let CborValue::Text(k) = k else {
+                    return Err("map keys must be text".to_string());
+                };
+                let v = from_cbor(v, Some(k.as_str()))?;
+                map.insert(k, v);
+            }
+            Value::Object(map)
+        }
+        CborValue::Tag(_, inner) => from_cbor(*inner, field)?,
+        _ => return Err("unsupported CBOR value".to_string()),
+    })
+}
+
+fn integer_to_json(i: Integer) -> Result<Value, String> {
+    let wide = i128::from(i);
+    if let Ok(u) = u64::try_from(wide) {
+        Ok(Value::from(u))
+    } else if let Ok(s) = i64::try_from(wide) {
+        Ok(Value::from(s))
+    } else {
+        Err(format!("integer out of range: {wide}"))
+    }
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn hex_and_byte_fields_round_trip_as_byte_strings() {
+        let json = serde_json::json!({
+            "ok": true,
+            "result": [{ "txid": "00ff", "memo": "hi", "raw": [1, 2, 3] }],
+        });
+        let mut out = Vec::new();
+        encode_response(json.clone(), false, &mut out).unwrap();
+
+        let field = |value: &CborValue, name: &str| -> CborValue {
+            value
+                .as_map()
+                .unwrap()
+                .iter()
+                .find(|(k, _)| k.as_text() == Some(name))
+                .map(|(_, v)| v.clone())
+                .unwrap()
+        };
+        let cbor: CborValue = ciborium::de::from_reader(out.as_slice()).unwrap();
+        let tx = field(&cbor, "result").as_array().unwrap()[0].clone();
+        assert_eq!(field(&tx, "txid"), CborValue::Bytes(vec![0x00, 0xff]));
+        assert_eq!(field(&tx, "memo"), CborValue::Text("hi".into()));
+        assert_eq!(field(&tx, "raw"), CborValue::Bytes(vec![1, 2, 3]));
+
+        assert_eq!(decode_request(&out).unwrap(), json);
+    }
+}
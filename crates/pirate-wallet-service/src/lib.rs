@@ -2,11 +2,17 @@
 
 pub mod api;
 pub mod background;
+mod cbor;
 pub mod models;
+pub mod perf;
+pub mod runtime;
 pub mod service;
+pub mod stats;
 pub mod streams;
 
 pub use api::*;
 pub use models::*;
 pub use pirate_core::{MnemonicInspection, MnemonicLanguage};
+pub use runtime::{configure_runtime, runtime_config, set_memory_budget, RuntimeConfig};
 pub use service::*;
+pub use stats::{reset_stats, stats_json, timed, timed_async};
@@ -0,0 +1,120 @@
+//! Startup timeline for the service.
+//!
+//! Spans are timed with a monotonic clock and exported as Chrome trace-event
+//! JSON with wall-clock microsecond timestamps, so desktop runners can merge
+//! them with their own startup events. Only the first `MAX_SPANS` spans are
+//! kept: this is a startup timeline, not a profiler.
+
+use parking_lot::Mutex;
+use serde_json::{json, Value};
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::{Instant, SystemTime, UNIX_EPOCH};
+
+const MAX_SPANS: usize = 1024;
+
+struct SpanRecord {
+    name: &'static str,
+    thread: u64,
+    start_us: u64,
+    dur_us: u64,
+}
+
+struct Timeline {
+    origin: Instant,
+    origin_unix_us: u64,
+    spans: Mutex<Vec<SpanRecord>>,
+}
+
+fn timeline() -> &'static Timeline {
+    static TIMELINE: OnceLock<Timeline> = OnceLock::new();
+    TIMELINE.get_or_init(|| Timeline {
+        origin: Instant::now(),
+        origin_unix_us: SystemTime::now()
+            .duration_since(UNIX_EPOCH)
+            .map(|d| d.as_micros() as u64)
+            .unwrap_or_default(),
+        spans: Mutex::new(Vec::new()),
+    })
+}
+
+fn thread_index() -> u64 {
+    static NEXT: AtomicU64 = AtomicU64::new(1);
+    thread_local! {
+        static INDEX: u64 = NEXT.fetch_add(1, Ordering::Relaxed);
+    }
+    INDEX.with(|index| *index)
+}
+
+/// Open span; recorded when dropped.
+#[must_use]
+pub struct Span {
+    name: &'static str,
+    started: Instant,
+}
+
+/// Start a span named `name`.
+pub fn span(name: &'static str) -> Span {
+    // Pin the origin before the first span starts so its offset is never
+    // negative.
+    let _ = timeline();
+    Span {
+        name,
+        started: Instant::now(),
+    }
+}
+
+impl Drop for Span {
+    fn drop(&mut self) {
+        let timeline = timeline();
+        let mut spans = timeline.spans.lock();
+        if spans.len() >= MAX_SPANS {
+            return;
+        }
+        spans.push(SpanRecord {
+            name: self.name,
+            thread: thread_index(),
+            start_us: self.started.duration_since(timeline.origin).as_micros() as u64,
+            dur_us: self.started.elapsed().as_micros() as u64,
+        });
+    }
+}
+
+/// Recorded spans as Chrome trace-event objects (`"ph": "X"`).
+pub fn trace_events() -> Vec<Value> {
+    let timeline = timeline();
+    let pid = std::process::id();
+    timeline
+        .spans
+        .lock()
+        .iter()
+        .map(|span| {
+            json!({
+                "name": span.name,
+                "cat": "service",
+                "ph": "X",
+                "ts": timeline.origin_unix_us + span.start_us,
+                "dur": span.dur_us,
+                "pid": pid,
+                "tid": span.thread,
+            })
+        })
+        .collect()
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn dropped_spans_become_complete_events() {
+        drop(span("perf_test_span"));
+        let events = trace_events();
+        let event = events
+            .iter()
+            .find(|event| event["name"] == "perf_test_span")
+            .expect("span recorded");
+        assert_eq!(event["ph"], "X");
+        assert!(event["ts"].as_u64().unwrap() >= timeline().origin_unix_us);
+    }
+}
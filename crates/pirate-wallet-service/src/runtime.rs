@@ -0,0 +1,187 @@
+//! Sizing for the process-wide service runtime.
+//!
+//! Hosts call [`configure_runtime`] once, before the first request, to size
+//! the runtime for the machine: a phone wants the small default, a server
+//! syncing many wallets wants more workers. The runtime is built lazily on the
+//! first request, so configuration after that point is rejected rather than
+//! silently ignored.
+//!
+//! The memory budget rides along in the same config but, unlike the thread
+//! counts, can change later through [`set_memory_budget`], for example when
+//! the OS reports memory pressure.
+
+use anyhow::{anyhow, Result};
+use pirate_core::memory_budget::MIN_MEMORY_BUDGET_BYTES;
+use serde::{Deserialize, Serialize};
+use std::sync::atomic::{AtomicBool, AtomicUsize, Ordering};
+use std::sync::{Arc, OnceLock};
+
+const DEFAULT_WORKER_THREADS: usize = 2;
+const MAX_WORKER_THREADS: usize = 256;
+
+/// Runtime sizing passed in by the host. Unset fields keep their defaults.
+#[derive(Debug, Clone, Default, PartialEq, Eq, Serialize, Deserialize)]
+pub struct RuntimeConfig {
+    /// Async worker threads. Defaults to 2.
+    pub worker_threads: Option<usize>,
+    /// Upper bound on the blocking pool (SQLite, file I/O). Defaults to
+    /// tokio's own limit.
+    pub max_blocking_threads: Option<usize>,
+    /// CPUs the runtime threads should run on. Only a hint: applied on Linux
+    /// and Android, ignored elsewhere and when the OS refuses it.
+    pub cpu_affinity: Option<Vec<usize>>,
+    /// Memory budget in bytes for sync batches, block cache reads and
+    /// proving, for low-RAM devices. Unlimited by default.
+    #[serde(default)]
+    pub memory_budget_bytes: Option<u64>,
+}
+
+static RUNTIME_CONFIG: OnceLock<RuntimeConfig> = OnceLock::new();
+static RUNTIME_BUILT: AtomicBool = AtomicBool::new(false);
+
+impl RuntimeConfig {
+    /// Build a config from the C ABI shape, where 0 means "default" and the
+    /// affinity is a bit mask over CPUs 0..64.
+    pub fn from_abi(worker_threads: u32, max_blocking_threads: u32, affinity_mask: u64) -> Self {
+        let cpus: Vec<usize> = (0..64)
+            .filter(|cpu| affinity_mask & (1u64 << cpu) != 0)
+            .collect();
+        Self {
+            worker_threads: (worker_threads > 0).then_some(worker_threads as usize),
+            max_blocking_threads: (max_blocking_threads > 0)
+                .then_some(max_blocking_threads as usize),
+            cpu_affinity: (!cpus.is_empty()).then_some(cpus),
+            memory_budget_bytes: None,
+        }
+    }
+
+    /// Reject sizes the runtime builder would panic on.
+    pub fn validate(&self) -> Result<()> {
+        if let Some(workers) = self.worker_threads {
+            if workers == 0 || workers > MAX_WORKER_THREADS {
+                return Err(anyhow!(
+                    "worker_threads must be between 1 and {}",
+                    MAX_WORKER_THREADS
+                ));
+            }
+        }
+        if self.max_blocking_threads == Some(0) {
+            return Err(anyhow!("max_blocking_threads must be at least 1"));
+        }
+        if self
+            .cpu_affinity
+            .as_ref()
+            .is_some_and(|cpus| cpus.is_empty())
+        {
+            return Err(anyhow!("cpu_affinity must list at least one CPU"));
+        }
+        validate_memory_budget(self.memory_budget_bytes)
+    }
+}
+
+fn validate_memory_budget(bytes: Option<u64>) -> Result<()> {
+    if bytes.is_some_and(|bytes| bytes < MIN_MEMORY_BUDGET_BYTES) {
+        return Err(anyhow!(
+            "memory_budget_bytes must be at least {}",
+            MIN_MEMORY_BUDGET_BYTES
+        ));
+    }
+    Ok(())
+}
+
+/// Set the runtime sizing. Must run before the first service request;
+/// calling it again with the same config is a no-op.
+pub fn configure_runtime(config: RuntimeConfig) -> Result<()> {
+    config.validate()?;
+    if RUNTIME_BUILT.load(Ordering::Acquire) {
+        return Err(anyhow!("Runtime already started"));
+    }
+    let stored = RUNTIME_CONFIG.get_or_init(|| config.clone());
+    if *stored != config {
+        return Err(anyhow!("Runtime already configured"));
+    }
+    pirate_core::memory_budget::set_memory_budget(config.memory_budget_bytes);
+    Ok(())
+}
+
+/// Set or clear the memory budget. Unlike the rest of [`RuntimeConfig`] this
+/// may be called at any time; sync and builds pick it up at their next batch.
+pub fn set_memory_budget(bytes: Option<u64>) -> Result<()> {
+    validate_memory_budget(bytes)?;
+    pirate_core::memory_budget::set_memory_budget(bytes);
+    Ok(())
+}
+
+/// The config the runtime was (or will be) built with.
+pub fn runtime_config() -> RuntimeConfig {
+    RUNTIME_CONFIG.get().cloned().unwrap_or_default()
+}
+
+pub(crate) fn build_runtime() -> tokio::runtime::Runtime {
+    RUNTIME_BUILT.store(true, Ordering::Release);
+    // Freeze whatever was configured so a late configure_runtime fails.
+    let config = RUNTIME_CONFIG.get_or_init(RuntimeConfig::default).clone();
+
+    let mut builder = tokio::runtime::Builder::new_multi_thread();
+    builder
+        .worker_threads(config.worker_threads.unwrap_or(DEFAULT_WORKER_THREADS))
+        .enable_all();
+    if let Some(max_blocking) = config.max_blocking_threads {
+        builder.max_blocking_threads(max_blocking);
+    }
+    if let Some(cpus) = config.cpu_affinity {
+        // Spread threads over the allowed CPUs instead of pinning them all
+        // to one set, so workers do not migrate between cores.
+        let cpus = Arc::new(cpus);
+        let next = Arc::new(AtomicUsize::new(0));
+        builder.on_thread_start(move || {
+            let index = next.fetch_add(1, Ordering::Relaxed);
+            pin_current_thread(cpus[index % cpus.len()]);
+        });
+    }
+    builder
+        .build()
+        .expect("failed to build wallet service runtime")
+}
+
+#[cfg(any(target_os = "linux", target_os = "android"))]
+fn pin_current_thread(cpu: usize) {
+    if cpu >= libc::CPU_SETSIZE as usize {
+        return;
+    }
+    // SAFETY: `set` is a plain bit set owned by this frame, and
+    // sched_setaffinity only reads `size_of::<cpu_set_t>()` bytes of it.
+    let result = unsafe {
+        let mut set: libc::cpu_set_t = std::mem::zeroed();
+        libc::CPU_SET(cpu, &mut set);
+        libc::sched_setaffinity(0, std::mem::size_of::<libc::cpu_set_t>(), &set)
+    };
+    if result != 0 {
+        tracing::debug!("runtime thread affinity to CPU {} refused", cpu);
+    }
+}
+
+#[cfg(not(any(target_os = "linux", target_os = "android")))]
+fn pin_current_thread(_cpu: usize) {}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn abi_zero_means_default() {
+        assert_eq!(RuntimeConfig::from_abi(0, 0, 0), RuntimeConfig::default());
+
+        let config = RuntimeConfig::from_abi(8, 64, 0b1010);
+        assert_eq!(config.worker_threads, Some(8));
+        assert_eq!(config.max_blocking_threads, Some(64));
+        assert_eq!(config.cpu_affinity, Some(vec![1, 3]));
+        assert!(config.validate().is_ok());
+        assert!(RuntimeConfig {
+            worker_threads: Some(0),
+            ..RuntimeConfig::default()
+        }
+        .validate()
+        .is_err());
+    }
+}
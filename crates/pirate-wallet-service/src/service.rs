@@ -1,6 +1,8 @@
+use crate::stats::MethodStats;
 use anyhow::Result;
 use serde::{Deserialize, Serialize};
 use serde_json::{json, to_value, Value};
+use std::time::Instant;
 
 pub use crate::{
     AddressBalanceInfo, AddressBookColorTag, AddressBookEntryFfi, AddressInfo, AddressValidation,
@@ -102,6 +104,8 @@ pub enum WalletServiceRequest {
         wallet_id: WalletId,
     },
     GetFeeInfo,
+    PrewarmProver,
+    GetProverStatus,
     GetAutoConsolidationThreshold,
     GetAutoConsolidationCandidateCount {
         wallet_id: WalletId,
@@ -264,6 +268,13 @@ pub enum WalletServiceRequest {
         url: String,
         tls_pin_opt: Option<String>,
     },
+    GetLightdMirrors {
+        wallet_id: WalletId,
+    },
+    SetLightdMirrors {
+        wallet_id: WalletId,
+        urls: Vec<String>,
+    },
     GetTunnel,
     SetTunnel {
         mode: TunnelMode,
@@ -311,6 +322,9 @@ pub enum WalletServiceRequest {
     CancelSync {
         wallet_id: WalletId,
     },
+    ScheduleWalletSyncs {
+        max_concurrent: Option<u32>,
+    },
     Rescan {
         wallet_id: WalletId,
         from_height: u32,
@@ -430,6 +444,203 @@ pub enum WalletServiceRequest {
     },
 }
 
+impl WalletServiceRequest {
+    /// Requests that only read wallet state and may run concurrently inside a
+    /// batch. `CurrentReceiveAddress` may store the address it derives, which
+    /// is idempotent.
+    pub fn is_read_only(&self) -> bool {
+        matches!(
+            self,
+            Self::GetBuildInfo
+                | Self::WalletRegistryExists
+                | Self::ListWallets
+                | Self::GetActiveWallet
+                | Self::HasAppPassphrase
+                | Self::CurrentReceiveAddress { .. }
+                | Self::ListAddresses { .. }
+                | Self::ListAddressBalances { .. }
+                | Self::GetBalance { .. }
+                | Self::GetShieldedPoolBalances { .. }
+                | Self::GetFeeInfo
+                | Self::GetProverStatus
+                | Self::GetAutoConsolidationThreshold
+                | Self::GetAutoConsolidationCandidateCount { .. }
+                | Self::GetSpendabilityStatus { .. }
+                | Self::ListKeyGroups { .. }
+                | Self::ListTransactions { .. }
+                | Self::ListNotes { .. }
+                | Self::GetTransactionDetails { .. }
+                | Self::ListAddressBook { .. }
+                | Self::GetLabelForAddress { .. }
+                | Self::AddressExistsInBook { .. }
+                | Self::GetAddressBookCount { .. }
+                | Self::GetAddressBookEntry { .. }
+                | Self::GetAddressBookEntryByAddress { .. }
+                | Self::SearchAddressBook { .. }
+                | Self::GetAddressBookFavorites { .. }
+                | Self::GetRecentlyUsedAddresses { .. }
+                | Self::IsValidShieldedAddress { .. }
+                | Self::ValidateAddress { .. }
+                | Self::GetLightdEndpoint { .. }
+                | Self::GetLightdEndpointConfig { .. }
+                | Self::GetLightdMirrors { .. }
+                | Self::GetTunnel
+                | Self::GetTorStatus
+                | Self::SyncStatus { .. }
+                | Self::GetWatchOnlyCapabilities { .. }
+                | Self::GetWatchOnlyBanner { .. }
+                | Self::GetVaultMode
+                | Self::GetDebugLoggingEnabled
+                | Self::GetCheckpointDetails { .. }
+                | Self::ValidateMnemonic { .. }
+                | Self::GetNetworkInfo
+                | Self::FormatAmount { .. }
+                | Self::ParseAmount { .. }
+        )
+    }
+
+    /// The `method` tag this request is serialized with.
+    pub fn method_name(&self) -> &'static str {
+        match self {
+            Self::GetBuildInfo => "get_build_info",
+            Self::WalletRegistryExists => "wallet_registry_exists",
+            Self::ListWallets => "list_wallets",
+            Self::GetActiveWallet => "get_active_wallet",
+            Self::CreateWallet { .. } => "create_wallet",
+            Self::RestoreWallet { .. } => "restore_wallet",
+            Self::ImportViewingWallet { .. } => "import_viewing_wallet",
+            Self::SwitchWallet { .. } => "switch_wallet",
+            Self::RenameWallet { .. } => "rename_wallet",
+            Self::SetWalletBirthdayHeight { .. } => "set_wallet_birthday_height",
+            Self::DeleteWallet { .. } => "delete_wallet",
+            Self::ConfigureWalletStorage { .. } => "configure_wallet_storage",
+            Self::SetAppPassphrase { .. } => "set_app_passphrase",
+            Self::HasAppPassphrase => "has_app_passphrase",
+            Self::VerifyAppPassphrase { .. } => "verify_app_passphrase",
+            Self::UnlockApp { .. } => "unlock_app",
+            Self::ChangeAppPassphrase { .. } => "change_app_passphrase",
+            Self::ChangeAppPassphraseWithCached { .. } => "change_app_passphrase_with_cached",
+            Self::CurrentReceiveAddress { .. } => "current_receive_address",
+            Self::NextReceiveAddress { .. } => "next_receive_address",
+            Self::LabelAddress { .. } => "label_address",
+            Self::SetAddressColorTag { .. } => "set_address_color_tag",
+            Self::ListAddresses { .. } => "list_addresses",
+            Self::ListAddressBalances { .. } => "list_address_balances",
+            Self::GetBalance { .. } => "get_balance",
+            Self::GetShieldedPoolBalances { .. } => "get_shielded_pool_balances",
+            Self::GetFeeInfo => "get_fee_info",
+            Self::PrewarmProver => "prewarm_prover",
+            Self::GetProverStatus => "get_prover_status",
+            Self::GetAutoConsolidationThreshold => "get_auto_consolidation_threshold",
+            Self::GetAutoConsolidationCandidateCount { .. } => {
+                "get_auto_consolidation_candidate_count"
+            }
+            Self::GetSpendabilityStatus { .. } => "get_spendability_status",
+            Self::ListKeyGroups { .. } => "list_key_groups",
+            Self::ExportKeyGroupKeys { .. } => "export_key_group_keys",
+            Self::ImportSpendingKey { .. } => "import_spending_key",
+            Self::ExportSeedRaw { .. } => "export_seed_raw",
+            Self::ListTransactions { .. } => "list_transactions",
+            Self::QortalSyncStatus { .. } => "qortal_sync_status",
+            Self::QortalBalance { .. } => "qortal_balance",
+            Self::QortalListTransactions { .. } => "qortal_list_transactions",
+            Self::QortalSend { .. } => "qortal_send",
+            Self::QortalSendP2sh { .. } => "qortal_send_p2sh",
+            Self::QortalRedeemP2sh { .. } => "qortal_redeem_p2sh",
+            Self::ListNotes { .. } => "list_notes",
+            Self::ClearWalletState { .. } => "clear_wallet_state",
+            Self::FetchTransactionMemo { .. } => "fetch_transaction_memo",
+            Self::GetTransactionDetails { .. } => "get_transaction_details",
+            Self::ExportPaymentDisclosures { .. } => "export_payment_disclosures",
+            Self::ExportSaplingPaymentDisclosure { .. } => "export_sapling_payment_disclosure",
+            Self::ExportOrchardPaymentDisclosure { .. } => "export_orchard_payment_disclosure",
+            Self::VerifyPaymentDisclosure { .. } => "verify_payment_disclosure",
+            Self::ListAddressBook { .. } => "list_address_book",
+            Self::AddAddressBookEntry { .. } => "add_address_book_entry",
+            Self::UpdateAddressBookEntry { .. } => "update_address_book_entry",
+            Self::DeleteAddressBookEntry { .. } => "delete_address_book_entry",
+            Self::ToggleAddressBookFavorite { .. } => "toggle_address_book_favorite",
+            Self::MarkAddressUsed { .. } => "mark_address_used",
+            Self::GetLabelForAddress { .. } => "get_label_for_address",
+            Self::AddressExistsInBook { .. } => "address_exists_in_book",
+            Self::GetAddressBookCount { .. } => "get_address_book_count",
+            Self::GetAddressBookEntry { .. } => "get_address_book_entry",
+            Self::GetAddressBookEntryByAddress { .. } => "get_address_book_entry_by_address",
+            Self::SearchAddressBook { .. } => "search_address_book",
+            Self::GetAddressBookFavorites { .. } => "get_address_book_favorites",
+            Self::GetRecentlyUsedAddresses { .. } => "get_recently_used_addresses",
+            Self::IsValidShieldedAddress { .. } => "is_valid_shielded_address",
+            Self::ValidateAddress { .. } => "validate_address",
+            Self::GetLightdEndpoint { .. } => "get_lightd_endpoint",
+            Self::GetLightdEndpointConfig { .. } => "get_lightd_endpoint_config",
+            Self::SetLightdEndpoint { .. } => "set_lightd_endpoint",
+            Self::GetLightdMirrors { .. } => "get_lightd_mirrors",
+            Self::SetLightdMirrors { .. } => "set_lightd_mirrors",
+            Self::GetTunnel => "get_tunnel",
+            Self::SetTunnel { .. } => "set_tunnel",
+            Self::BootstrapTunnel { .. } => "bootstrap_tunnel",
+            Self::ShutdownTransport => "shutdown_transport",
+            Self::SetTorBridgeSettings { .. } => "set_tor_bridge_settings",
+            Self::GetTorStatus => "get_tor_status",
+            Self::RotateTorExit => "rotate_tor_exit",
+            Self::FetchExternalText { .. } => "fetch_external_text",
+            Self::FetchExternalBytes { .. } => "fetch_external_bytes",
+            Self::DownloadExternalToFile { .. } => "download_external_to_file",
+            Self::TestNode { .. } => "test_node",
+            Self::StartSync { .. } => "start_sync",
+            Self::SyncStatus { .. } => "sync_status",
+            Self::CancelSync { .. } => "cancel_sync",
+            Self::ScheduleWalletSyncs { .. } => "schedule_wallet_syncs",
+            Self::Rescan { .. } => "rescan",
+            Self::BuildTx { .. } => "build_tx",
+            Self::SignTx { .. } => "sign_tx",
+            Self::BroadcastTx { .. } => "broadcast_tx",
+            Self::StartSeedExport { .. } => "start_seed_export",
+            Self::AcknowledgeSeedWarning => "acknowledge_seed_warning",
+            Self::CompleteSeedBiometric { .. } => "complete_seed_biometric",
+            Self::SkipSeedBiometric => "skip_seed_biometric",
+            Self::ExportSeedWithPassphrase { .. } => "export_seed_with_passphrase",
+            Self::ExportSeedWithCachedPassphrase { .. } => "export_seed_with_cached_passphrase",
+            Self::CancelSeedExport => "cancel_seed_export",
+            Self::GetSeedExportState => "get_seed_export_state",
+            Self::GetSeedExportWarnings => "get_seed_export_warnings",
+            Self::ExportSaplingViewingKey { .. } => "export_sapling_viewing_key",
+            Self::ExportOrchardViewingKey { .. } => "export_orchard_viewing_key",
+            Self::ExportSaplingViewingKeySecure { .. } => "export_sapling_viewing_key_secure",
+            Self::ImportSaplingViewingKeyAsWatchOnly { .. } => {
+                "import_sapling_viewing_key_as_watch_only"
+            }
+            Self::GetWatchOnlyCapabilities { .. } => "get_watch_only_capabilities",
+            Self::GetWatchOnlyBanner { .. } => "get_watch_only_banner",
+            Self::GetIvkClipboardRemaining => "get_ivk_clipboard_remaining",
+            Self::SetPanicPin { .. } => "set_panic_pin",
+            Self::HasPanicPin => "has_panic_pin",
+            Self::VerifyPanicPin { .. } => "verify_panic_pin",
+            Self::IsDecoyMode => "is_decoy_mode",
+            Self::GetVaultMode => "get_vault_mode",
+            Self::ClearPanicPin => "clear_panic_pin",
+            Self::SetDuressPassphrase { .. } => "set_duress_passphrase",
+            Self::HasDuressPassphrase => "has_duress_passphrase",
+            Self::ClearDuressPassphrase => "clear_duress_passphrase",
+            Self::VerifyDuressPassphrase { .. } => "verify_duress_passphrase",
+            Self::SetDecoyWalletName { .. } => "set_decoy_wallet_name",
+            Self::ExitDecoyMode { .. } => "exit_decoy_mode",
+            Self::SetDebugLoggingEnabled { .. } => "set_debug_logging_enabled",
+            Self::GetDebugLoggingEnabled => "get_debug_logging_enabled",
+            Self::ClearDebugLogs => "clear_debug_logs",
+            Self::GetSyncLogs { .. } => "get_sync_logs",
+            Self::GetCheckpointDetails { .. } => "get_checkpoint_details",
+            Self::ValidateConsensusBranch { .. } => "validate_consensus_branch",
+            Self::GenerateMnemonic { .. } => "generate_mnemonic",
+            Self::ValidateMnemonic { .. } => "validate_mnemonic",
+            Self::InspectMnemonic { .. } => "inspect_mnemonic",
+            Self::GetNetworkInfo => "get_network_info",
+            Self::FormatAmount { .. } => "format_amount",
+            Self::ParseAmount { .. } => "parse_amount",
+        }
+    }
+}
+
 #[derive(Debug, Clone, Serialize, Deserialize)]
 pub struct JsonEnvelope {
     pub ok: bool,
@@ -448,8 +659,33 @@ impl WalletService {
     }
 
     pub async fn execute(&self, request: WalletServiceRequest) -> Result<Value> {
+        self.execute_queued(request, None).await
+    }
+
+    /// Execute `request` and record it in [`crate::stats`]. `queued_at` is
+    /// when the host handed it over, for the queue-wait histogram.
+    async fn execute_queued(
+        &self,
+        request: WalletServiceRequest,
+        queued_at: Option<Instant>,
+    ) -> Result<Value> {
+        let stats = crate::stats::method(request.method_name());
+        let started = Instant::now();
+        if let Some(queued_at) = queued_at {
+            stats
+                .queue
+                .record(started.saturating_duration_since(queued_at));
+        }
+        let result = self.dispatch(request).await;
+        stats.record_call(started.elapsed(), result.is_ok());
+        result
+    }
+
+    async fn dispatch(&self, request: WalletServiceRequest) -> Result<Value> {
         use crate as ffi;
 
+        let _span = crate::perf::span(request.method_name());
+
         match request {
             WalletServiceRequest::GetBuildInfo => serialize(ffi::get_build_info()?),
             WalletServiceRequest::WalletRegistryExists => serialize(ffi::wallet_registry_exists()?),
@@ -574,6 +810,8 @@ impl WalletService {
                 serialize(ffi::get_shielded_pool_balances(wallet_id)?)
             }
             WalletServiceRequest::GetFeeInfo => serialize(ffi::get_fee_info()?),
+            WalletServiceRequest::PrewarmProver => serialize(ffi::prewarm_prover()),
+            WalletServiceRequest::GetProverStatus => serialize(ffi::prover_status()),
             WalletServiceRequest::GetAutoConsolidationThreshold => {
                 serialize(ffi::get_auto_consolidation_threshold()?)
             }
@@ -746,6 +984,13 @@ impl WalletService {
                 ffi::set_lightd_endpoint(wallet_id, url, tls_pin_opt)?;
                 Ok(ack())
             }
+            WalletServiceRequest::GetLightdMirrors { wallet_id } => {
+                serialize(ffi::get_lightd_mirrors(wallet_id)?)
+            }
+            WalletServiceRequest::SetLightdMirrors { wallet_id, urls } => {
+                ffi::set_lightd_mirrors(wallet_id, urls)?;
+                Ok(ack())
+            }
             WalletServiceRequest::GetTunnel => serialize(ffi::get_tunnel()?),
             WalletServiceRequest::SetTunnel { mode } => {
                 ffi::set_tunnel(mode)?;
@@ -814,6 +1059,9 @@ impl WalletService {
                 ffi::cancel_sync(wallet_id).await?;
                 Ok(ack())
             }
+            WalletServiceRequest::ScheduleWalletSyncs { max_concurrent } => {
+                serialize(ffi::schedule_wallet_syncs(max_concurrent).await?)
+            }
             WalletServiceRequest::Rescan {
                 wallet_id,
                 from_height,
@@ -966,7 +1214,8 @@ impl WalletService {
         }
     }
 
-    pub fn execute_blocking(&self, request: WalletServiceRequest) -> Result<Value> {
+    /// Process-wide runtime shared by every service entry point.
+    pub fn runtime() -> &'static tokio::runtime::Runtime {
         // Use a process-wide persistent runtime so background tasks spawned by a
         // request keep running after the call returns. `start_sync` spawns the
         // sync engine onto this runtime; with the previous per-call
@@ -975,49 +1224,337 @@ impl WalletService {
         // that drives the service entirely through `execute_blocking` (e.g. the
         // React Native binding) could therefore never make sync progress.
         static RUNTIME: std::sync::OnceLock<tokio::runtime::Runtime> = std::sync::OnceLock::new();
-        let runtime = RUNTIME.get_or_init(|| {
-            tokio::runtime::Builder::new_multi_thread()
-                .worker_threads(2)
-                .enable_all()
-                .build()
-                .expect("failed to build wallet service runtime")
-        });
-        runtime.block_on(self.execute(request))
+        // Sized by `crate::runtime::configure_runtime`, two workers by default.
+        RUNTIME.get_or_init(crate::runtime::build_runtime)
+    }
+
+    pub fn execute_blocking(&self, request: WalletServiceRequest) -> Result<Value> {
+        let queued_at = Instant::now();
+        Self::runtime().block_on(self.execute_queued(request, Some(queued_at)))
     }
 
     pub fn execute_json(&self, request_json: &str, pretty: bool) -> String {
-        let response = match serde_json::from_str::<WalletServiceRequest>(request_json) {
-            Ok(request) => match self.execute_blocking(request) {
-                Ok(result) => JsonEnvelope {
-                    ok: true,
-                    result: Some(result),
-                    error: None,
-                },
-                Err(err) => JsonEnvelope {
+        let mut out = Vec::new();
+        self.execute_json_into(request_json.as_bytes(), pretty, &mut out);
+        // serde_json only ever emits UTF-8, so this conversion cannot fail in
+        // practice; keep the envelope shape if it somehow does.
+        String::from_utf8(out).unwrap_or_else(|_| SERIALIZE_FAILURE_JSON.to_string())
+    }
+
+    /// Execute a JSON request given as raw UTF-8 bytes and write the response
+    /// envelope into `out`.
+    ///
+    /// `out` is cleared first and its allocation is reused, so hosts that keep
+    /// one buffer per native handle avoid a fresh response allocation per call.
+    pub fn execute_json_into(&self, request_json: &[u8], pretty: bool, out: &mut Vec<u8>) {
+        match parse_request(request_json) {
+            Ok((request, stats)) => {
+                let response = JsonEnvelope::from_result(self.execute_blocking(request));
+                let started = Instant::now();
+                write_envelope(&response, pretty, out);
+                stats.serialize.record(started.elapsed());
+            }
+            Err(err) => write_envelope(&JsonEnvelope::invalid_request(&err), pretty, out),
+        }
+    }
+
+    /// Execute a CBOR-encoded request and write the CBOR response envelope
+    /// into `out`.
+    ///
+    /// Uses the same request schema and `{ok, result, error}` envelope as the
+    /// JSON entry points, with hex fields such as `txid` and byte arrays such
+    /// as `raw` carried as CBOR byte strings.
+    pub fn execute_cbor_into(&self, request_cbor: &[u8], out: &mut Vec<u8>) {
+        out.clear();
+        let received = Instant::now();
+        let parsed = crate::cbor::decode_request(request_cbor).and_then(|value| {
+            serde_json::from_value::<WalletServiceRequest>(value).map_err(|e| e.to_string())
+        });
+        let mut stats = None;
+        let (response, bytes_result) = match parsed {
+            Ok(request) => {
+                let method = crate::stats::method(request.method_name());
+                method.parse.record(received.elapsed());
+                stats = Some(method);
+                let bytes_result =
+                    matches!(request, WalletServiceRequest::FetchExternalBytes { .. });
+                (
+                    JsonEnvelope::from_result(self.execute_blocking(request)),
+                    bytes_result,
+                )
+            }
+            Err(err) => {
+                crate::stats::method(crate::stats::INVALID_REQUEST).record_rejected();
+                (
+                    JsonEnvelope {
+                        ok: false,
+                        result: None,
+                        error: Some(format!("Invalid request CBOR: {}", err)),
+                    },
+                    false,
+                )
+            }
+        };
+
+        let started = Instant::now();
+        let encoded = to_value(&response)
+            .map_err(|e| e.to_string())
+            .and_then(|value| crate::cbor::encode_response(value, bytes_result, out));
+        if encoded.is_err() {
+            out.clear();
+            let failure = JsonEnvelope {
+                ok: false,
+                result: None,
+                error: Some("Failed to serialize response".to_string()),
+            };
+            if let Ok(value) = to_value(&failure) {
+                let _ = crate::cbor::encode_response(value, false, out);
+            }
+        }
+        if let Some(stats) = stats {
+            stats.serialize.record(started.elapsed());
+        }
+    }
+
+    /// Execute a JSON array of requests and write a JSON array of response
+    /// envelopes, in request order, into `out`.
+    ///
+    /// Runs of read-only requests (see [`WalletServiceRequest::is_read_only`])
+    /// execute concurrently: requests for the same wallet share one thread,
+    /// and with it one opened wallet database, while different wallets run in
+    /// parallel on the runtime's blocking pool. Any other request is a barrier
+    /// that runs alone, after everything before it. A body that is not a JSON
+    /// array produces a single error envelope instead of an array.
+    pub fn execute_json_batch_into(&self, requests_json: &[u8], pretty: bool, out: &mut Vec<u8>) {
+        match serde_json::from_slice::<Vec<Value>>(requests_json) {
+            Ok(items) => {
+                let responses = Self::runtime().block_on(self.execute_batch(items));
+                write_envelope(&responses, pretty, out);
+            }
+            Err(err) => write_envelope(&JsonEnvelope::invalid_request(&err), pretty, out),
+        }
+    }
+
+    async fn execute_batch(&self, items: Vec<Value>) -> Vec<JsonEnvelope> {
+        let mut responses: Vec<Option<JsonEnvelope>> = vec![None; items.len()];
+        let mut read_only = BatchGroups::default();
+
+        for (index, item) in items.into_iter().enumerate() {
+            let wallet_id = item
+                .get("wallet_id")
+                .and_then(Value::as_str)
+                .map(str::to_owned);
+            let received = Instant::now();
+            let request = match serde_json::from_value::<WalletServiceRequest>(item) {
+                Ok(request) => {
+                    crate::stats::method(request.method_name())
+                        .parse
+                        .record(received.elapsed());
+                    request
+                }
+                Err(err) => {
+                    crate::stats::method(crate::stats::INVALID_REQUEST).record_rejected();
+                    responses[index] = Some(JsonEnvelope::invalid_request(&err));
+                    continue;
+                }
+            };
+            if request.is_read_only() {
+                read_only.push(wallet_id, index, request);
+                continue;
+            }
+            std::mem::take(&mut read_only).run(&mut responses).await;
+            responses[index] = Some(JsonEnvelope::from_result(self.execute(request).await));
+        }
+        read_only.run(&mut responses).await;
+
+        responses
+            .into_iter()
+            .map(|response| {
+                response.unwrap_or_else(|| JsonEnvelope {
                     ok: false,
                     result: None,
-                    error: Some(err.to_string()),
-                },
+                    error: Some("Batch request did not complete".to_string()),
+                })
+            })
+            .collect()
+    }
+
+    /// Like [`Self::execute_json_into`], but gives up at the request's next
+    /// await point once `cancelled` resolves.
+    ///
+    /// `submitted` is when the host handed the request over; the time until
+    /// it starts executing is recorded as queue wait. Returns `false` if the
+    /// request was cancelled, in which case `out` is left empty. Synchronous
+    /// storage work between await points still runs to completion. Must not be
+    /// called from inside an async context; hosts run it on a blocking thread
+    /// of [`Self::runtime`].
+    pub fn execute_json_until<C>(
+        &self,
+        request_json: &[u8],
+        pretty: bool,
+        out: &mut Vec<u8>,
+        submitted: Instant,
+        cancelled: C,
+    ) -> bool
+    where
+        C: std::future::Future<Output = ()>,
+    {
+        out.clear();
+        let (request, stats) = match parse_request(request_json) {
+            Ok(parsed) => parsed,
+            Err(err) => {
+                write_envelope(&JsonEnvelope::invalid_request(&err), pretty, out);
+                return true;
+            }
+        };
+
+        let result = Self::runtime().block_on(async {
+            tokio::select! {
+                biased;
+                _ = cancelled => None,
+                result = self.execute_queued(request, Some(submitted)) => Some(result),
+            }
+        });
+        match result {
+            Some(result) => {
+                let started = Instant::now();
+                write_envelope(&JsonEnvelope::from_result(result), pretty, out);
+                stats.serialize.record(started.elapsed());
+                true
+            }
+            None => false,
+        }
+    }
+}
+
+impl JsonEnvelope {
+    fn from_result(result: Result<Value>) -> Self {
+        match result {
+            Ok(result) => Self {
+                ok: true,
+                result: Some(result),
+                error: None,
             },
-            Err(err) => JsonEnvelope {
+            Err(err) => Self {
                 ok: false,
                 result: None,
-                error: Some(format!("Invalid request JSON: {}", err)),
+                error: Some(err.to_string()),
             },
+        }
+    }
+
+    fn invalid_request(err: &serde_json::Error) -> Self {
+        Self {
+            ok: false,
+            result: None,
+            error: Some(format!("Invalid request JSON: {}", err)),
+        }
+    }
+}
+
+type BatchItem = (usize, WalletServiceRequest);
+
+/// Read-only batch requests waiting for the next barrier, grouped by wallet.
+#[derive(Default)]
+struct BatchGroups {
+    groups: Vec<(Option<String>, Vec<BatchItem>)>,
+}
+
+impl BatchGroups {
+    fn push(&mut self, wallet_id: Option<String>, index: usize, request: WalletServiceRequest) {
+        // Requests without a wallet do not touch a wallet database, so each
+        // gets its own group and can run in parallel with everything else.
+        if wallet_id.is_some() {
+            if let Some((_, items)) = self.groups.iter_mut().find(|(id, _)| *id == wallet_id) {
+                items.push((index, request));
+                return;
+            }
+        }
+        self.groups.push((wallet_id, vec![(index, request)]));
+    }
+
+    /// Run every group and store the envelopes in `responses`.
+    ///
+    /// The largest group runs on the calling thread, which usually already
+    /// holds that wallet's database open; the others go to blocking threads.
+    async fn run(self, responses: &mut [Option<JsonEnvelope>]) {
+        let mut groups: Vec<Vec<BatchItem>> = self.groups.into_iter().map(|(_, g)| g).collect();
+        let Some(largest) = (0..groups.len()).max_by_key(|&i| groups[i].len()) else {
+            return;
         };
+        let local = groups.swap_remove(largest);
 
-        if pretty {
-            serde_json::to_string_pretty(&response).unwrap_or_else(|_| {
-                "{\"ok\":false,\"error\":\"Failed to serialize response\"}".to_string()
-            })
-        } else {
-            serde_json::to_string(&response).unwrap_or_else(|_| {
-                "{\"ok\":false,\"error\":\"Failed to serialize response\"}".to_string()
+        let spawned: Vec<_> = groups
+            .into_iter()
+            .map(|group| {
+                tokio::task::spawn_blocking(move || {
+                    WalletService::runtime().block_on(run_batch_group(group))
+                })
             })
+            .collect();
+
+        for (index, response) in run_batch_group(local).await {
+            responses[index] = Some(response);
+        }
+        for handle in spawned {
+            match handle.await {
+                Ok(results) => {
+                    for (index, response) in results {
+                        responses[index] = Some(response);
+                    }
+                }
+                Err(err) => tracing::warn!("Batch request group failed: {}", err),
+            }
+        }
+    }
+}
+
+/// Run one group concurrently on the current thread.
+async fn run_batch_group(group: Vec<BatchItem>) -> Vec<(usize, JsonEnvelope)> {
+    let service = WalletService::new();
+    futures::future::join_all(group.into_iter().map(|(index, request)| async move {
+        (
+            index,
+            JsonEnvelope::from_result(service.execute(request).await),
+        )
+    }))
+    .await
+}
+
+/// Parse a JSON request, recording the parse time under its method. Bodies
+/// that do not parse count against [`crate::stats::INVALID_REQUEST`].
+fn parse_request(
+    request_json: &[u8],
+) -> std::result::Result<(WalletServiceRequest, &'static MethodStats), serde_json::Error> {
+    let received = Instant::now();
+    match serde_json::from_slice::<WalletServiceRequest>(request_json) {
+        Ok(request) => {
+            let stats = crate::stats::method(request.method_name());
+            stats.parse.record(received.elapsed());
+            Ok((request, stats))
+        }
+        Err(err) => {
+            crate::stats::method(crate::stats::INVALID_REQUEST).record_rejected();
+            Err(err)
         }
     }
 }
 
+const SERIALIZE_FAILURE_JSON: &str = "{\"ok\":false,\"error\":\"Failed to serialize response\"}";
+
+fn write_envelope<T: Serialize>(response: &T, pretty: bool, out: &mut Vec<u8>) {
+    out.clear();
+    let written = if pretty {
+        serde_json::to_writer_pretty(&mut *out, response)
+    } else {
+        serde_json::to_writer(&mut *out, response)
+    };
+    if written.is_err() {
+        out.clear();
+        out.extend_from_slice(SERIALIZE_FAILURE_JSON.as_bytes());
+    }
+}
+
 fn ack() -> Value {
     json!({ "acknowledged": true })
 }
@@ -1029,3 +1566,38 @@ fn serialize<T: Serialize>(value: T) -> Result<Value> {
 fn serialize_amount(value: u64) -> Result<Value> {
     Ok(Value::String(value.to_string()))
 }
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn batch_keeps_request_order_and_reports_item_errors() {
+        let requests = br#"[
+            {"method":"format_amount","arrrtoshis":"100000000"},
+            {"method":"no_such_method"},
+            {"method":"parse_amount","arrr":"1.5"}
+        ]"#;
+        let mut out = Vec::new();
+        WalletService::new().execute_json_batch_into(requests, false, &mut out);
+
+        let responses: Vec<JsonEnvelope> = serde_json::from_slice(&out).unwrap();
+        assert_eq!(responses.len(), 3);
+        assert!(responses[0].ok);
+        assert!(!responses[1].ok);
+        assert_eq!(responses[2].result, Some(Value::String("150000000".into())));
+    }
+
+    #[test]
+    fn batch_rejects_non_array_body() {
+        let mut out = Vec::new();
+        WalletService::new().execute_json_batch_into(
+            br#"{"method":"get_build_info"}"#,
+            false,
+            &mut out,
+        );
+
+        let response: JsonEnvelope = serde_json::from_slice(&out).unwrap();
+        assert!(!response.ok);
+    }
+}
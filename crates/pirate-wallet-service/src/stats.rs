@@ -0,0 +1,308 @@
+//! Per-method request counters and latency histograms.
+//!
+//! Every [`crate::service::WalletServiceRequest`] variant gets a call and
+//! error count plus four histograms: request parsing, queue wait (from the
+//! host handing the request over until it starts executing), execution, and
+//! response serialization. Together they tell a slow screen caused by JSON
+//! work apart from one waiting behind long tasks on the runtime or one stuck
+//! in storage or the network.
+//!
+//! Histograms are log-linear like HDR histograms: eight buckets per power of
+//! two of microseconds, so every recorded value is kept to within 12.5%.
+//! Recording is a handful of relaxed atomic adds and the method lookup is a
+//! read lock on a small map, cheap enough to stay on in release builds.
+//!
+//! The wallet database pool's hit, miss and wait counters ride along under
+//! `db_pool`, since a miss there is a full SQLCipher open inside a request,
+//! and the memory budget with its per-consumer high-water marks under
+//! `memory_budget`.
+
+use parking_lot::RwLock;
+use serde_json::{json, Map, Value};
+use std::collections::HashMap;
+use std::future::Future;
+use std::sync::atomic::{AtomicU64, Ordering};
+use std::sync::OnceLock;
+use std::time::{Duration, Instant};
+
+const SUB_BUCKET_BITS: u32 = 3;
+const SUB_BUCKETS: u64 = 1 << SUB_BUCKET_BITS;
+/// Values are exact below this; above it they share a power-of-two range.
+const LINEAR_LIMIT: u64 = SUB_BUCKETS * 2;
+/// Longest distinguishable value is just under 2^37 µs (about 38 hours).
+const MAX_MAGNITUDE: u32 = 36;
+const BUCKETS: usize = ((MAX_MAGNITUDE - SUB_BUCKET_BITS + 2) as usize) * SUB_BUCKETS as usize;
+
+/// Method name used for request bodies that do not parse.
+pub const INVALID_REQUEST: &str = "invalid_request";
+
+fn bucket_index(value_us: u64) -> usize {
+    if value_us < LINEAR_LIMIT {
+        return value_us as usize;
+    }
+    let value_us = value_us.min((1u64 << (MAX_MAGNITUDE + 1)) - 1);
+    let magnitude = 63 - value_us.leading_zeros();
+    let shift = magnitude - SUB_BUCKET_BITS;
+    ((shift as u64 + 1) * SUB_BUCKETS + (value_us >> shift) - SUB_BUCKETS) as usize
+}
+
+/// Smallest value that lands in bucket `index`.
+fn bucket_floor(index: usize) -> u64 {
+    let index = index as u64;
+    if index < LINEAR_LIMIT {
+        return index;
+    }
+    let shift = index / SUB_BUCKETS - 1;
+    (index % SUB_BUCKETS + SUB_BUCKETS) << shift
+}
+
+/// Largest value that lands in bucket `index`.
+fn bucket_ceiling(index: usize) -> u64 {
+    bucket_floor(index + 1) - 1
+}
+
+/// Latency histogram in microseconds.
+pub struct Histogram {
+    buckets: Box<[AtomicU64]>,
+    sum_us: AtomicU64,
+    max_us: AtomicU64,
+}
+
+impl Histogram {
+    fn new() -> Self {
+        Self {
+            buckets: (0..BUCKETS).map(|_| AtomicU64::new(0)).collect(),
+            sum_us: AtomicU64::new(0),
+            max_us: AtomicU64::new(0),
+        }
+    }
+
+    pub fn record(&self, elapsed: Duration) {
+        let value_us = elapsed.as_micros().min(u64::MAX as u128) as u64;
+        self.buckets[bucket_index(value_us)].fetch_add(1, Ordering::Relaxed);
+        self.sum_us.fetch_add(value_us, Ordering::Relaxed);
+        self.max_us.fetch_max(value_us, Ordering::Relaxed);
+    }
+
+    fn reset(&self) {
+        for bucket in self.buckets.iter() {
+            bucket.store(0, Ordering::Relaxed);
+        }
+        self.sum_us.store(0, Ordering::Relaxed);
+        self.max_us.store(0, Ordering::Relaxed);
+    }
+
+    /// Count, mean, p50/p90/p99/max and the non-empty buckets as
+    /// `[ceiling_us, count]` pairs. Buckets are read one by one while other
+    /// threads record, so a snapshot can be off by in-flight calls.
+    fn to_json(&self) -> Value {
+        let counts: Vec<u64> = self
+            .buckets
+            .iter()
+            .map(|bucket| bucket.load(Ordering::Relaxed))
+            .collect();
+        let count: u64 = counts.iter().sum();
+        let max_us = self.max_us.load(Ordering::Relaxed);
+        let percentile = |fraction: f64| -> u64 {
+            if count == 0 {
+                return 0;
+            }
+            let rank = ((count as f64 * fraction).ceil() as u64).max(1);
+            let mut seen = 0;
+            for (index, bucket_count) in counts.iter().enumerate() {
+                seen += bucket_count;
+                if seen >= rank {
+                    return bucket_ceiling(index).min(max_us);
+                }
+            }
+            max_us
+        };
+        let buckets: Vec<Value> = counts
+            .iter()
+            .enumerate()
+            .filter(|(_, count)| **count > 0)
+            .map(|(index, count)| json!([bucket_ceiling(index), count]))
+            .collect();
+        json!({
+            "count": count,
+            "mean_us": if count > 0 { self.sum_us.load(Ordering::Relaxed) / count } else { 0 },
+            "p50_us": percentile(0.50),
+            "p90_us": percentile(0.90),
+            "p99_us": percentile(0.99),
+            "max_us": max_us,
+            "buckets": buckets,
+        })
+    }
+}
+
+/// Counters and histograms for one request method.
+pub struct MethodStats {
+    calls: AtomicU64,
+    errors: AtomicU64,
+    pub parse: Histogram,
+    pub queue: Histogram,
+    pub execute: Histogram,
+    pub serialize: Histogram,
+}
+
+impl MethodStats {
+    fn new() -> Self {
+        Self {
+            calls: AtomicU64::new(0),
+            errors: AtomicU64::new(0),
+            parse: Histogram::new(),
+            queue: Histogram::new(),
+            execute: Histogram::new(),
+            serialize: Histogram::new(),
+        }
+    }
+
+    /// Count a finished call and record how long it executed.
+    pub fn record_call(&self, elapsed: Duration, ok: bool) {
+        self.calls.fetch_add(1, Ordering::Relaxed);
+        if !ok {
+            self.errors.fetch_add(1, Ordering::Relaxed);
+        }
+        self.execute.record(elapsed);
+    }
+
+    /// Count a request that failed before it could execute.
+    pub fn record_rejected(&self) {
+        self.calls.fetch_add(1, Ordering::Relaxed);
+        self.errors.fetch_add(1, Ordering::Relaxed);
+    }
+
+    fn reset(&self) {
+        self.calls.store(0, Ordering::Relaxed);
+        self.errors.store(0, Ordering::Relaxed);
+        self.parse.reset();
+        self.queue.reset();
+        self.execute.reset();
+        self.serialize.reset();
+    }
+
+    fn to_json(&self) -> Value {
+        json!({
+            "calls": self.calls.load(Ordering::Relaxed),
+            "errors": self.errors.load(Ordering::Relaxed),
+            "parse": self.parse.to_json(),
+            "queue": self.queue.to_json(),
+            "execute": self.execute.to_json(),
+            "serialize": self.serialize.to_json(),
+        })
+    }
+}
+
+struct Registry {
+    since: RwLock<Instant>,
+    // Entries are leaked: there is one per method name, a fixed set, and
+    // handing out `&'static` keeps the record path free of reference counts.
+    methods: RwLock<HashMap<&'static str, &'static MethodStats>>,
+}
+
+fn registry() -> &'static Registry {
+    static REGISTRY: OnceLock<Registry> = OnceLock::new();
+    REGISTRY.get_or_init(|| Registry {
+        since: RwLock::new(Instant::now()),
+        methods: RwLock::new(HashMap::new()),
+    })
+}
+
+/// Stats for `method`, created on first use.
+pub fn method(method: &'static str) -> &'static MethodStats {
+    let registry = registry();
+    if let Some(stats) = registry.methods.read().get(method) {
+        return stats;
+    }
+    registry
+        .methods
+        .write()
+        .entry(method)
+        .or_insert_with(|| Box::leak(Box::new(MethodStats::new())))
+}
+
+/// Run `call` as one call of `name`. For hosts that call the wallet functions
+/// directly, like the Flutter bindings, instead of going through a
+/// [`crate::service::WalletServiceRequest`]; both land in the same entry.
+pub fn timed<T>(name: &'static str, call: impl FnOnce() -> anyhow::Result<T>) -> anyhow::Result<T> {
+    let started = Instant::now();
+    let result = call();
+    method(name).record_call(started.elapsed(), result.is_ok());
+    result
+}
+
+/// [`timed`] for async calls.
+pub async fn timed_async<T>(
+    name: &'static str,
+    call: impl Future<Output = anyhow::Result<T>>,
+) -> anyhow::Result<T> {
+    let started = Instant::now();
+    let result = call.await;
+    method(name).record_call(started.elapsed(), result.is_ok());
+    result
+}
+
+/// Every method seen so far, keyed by name, plus the collection window.
+pub fn stats_json() -> Value {
+    let registry = registry();
+    let mut methods = Map::new();
+    let mut entries: Vec<(&'static str, &'static MethodStats)> = registry
+        .methods
+        .read()
+        .iter()
+        .map(|(name, stats)| (*name, *stats))
+        .collect();
+    entries.sort_by_key(|(name, _)| *name);
+    for (name, stats) in entries {
+        methods.insert(name.to_string(), stats.to_json());
+    }
+    json!({
+        "window_ms": registry.since.read().elapsed().as_millis() as u64,
+        "methods": methods,
+        "db_pool": serde_json::to_value(pirate_storage_sqlite::pool::stats())
+            .unwrap_or(Value::Null),
+        "memory_budget": serde_json::to_value(pirate_core::memory_budget::memory_budget_stats())
+            .unwrap_or(Value::Null),
+    })
+}
+
+/// Zero every counter and histogram and restart the collection window.
+pub fn reset_stats() {
+    let registry = registry();
+    *registry.since.write() = Instant::now();
+    for stats in registry.methods.read().values() {
+        stats.reset();
+    }
+    pirate_storage_sqlite::pool::reset_stats();
+    pirate_core::memory_budget::reset_memory_budget_stats();
+}
+
+#[cfg(test)]
+mod tests {
+    use super::*;
+
+    #[test]
+    fn buckets_keep_values_within_an_eighth() {
+        for value in [0u64, 7, 15, 16, 17, 100, 1_000, 65_535, 1 << 30] {
+            let index = bucket_index(value);
+            assert!(index < BUCKETS);
+            assert!(bucket_floor(index) <= value && value <= bucket_ceiling(index));
+            assert!(bucket_ceiling(index) - bucket_floor(index) <= value / 8);
+        }
+        assert_eq!(bucket_index(u64::MAX), BUCKETS - 1);
+    }
+
+    #[test]
+    fn percentiles_come_from_recorded_calls() {
+        let stats = method("stats_test_method");
+        for ms in 1..=100u64 {
+            stats.record_call(Duration::from_millis(ms), ms != 100);
+        }
+        let json = stats.to_json();
+        assert_eq!(json["calls"], 100);
+        assert_eq!(json["errors"], 1);
+        let p50 = json["execute"]["p50_us"].as_u64().unwrap();
+        assert!((50_000..=56_250).contains(&p50), "p50 {}", p50);
+        assert_eq!(json["execute"]["max_us"], 100_000);
+    }
+}
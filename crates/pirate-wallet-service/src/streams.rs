@@ -217,6 +217,184 @@ pub async fn balance_stream(wallet_id: String) -> mpsc::Receiver<Balance> {
     rx
 }
 
+/// `WalletEventDelta::changed` bit: local or target height moved.
+pub const WALLET_EVENT_HEIGHT: u32 = 1 << 0;
+/// `WalletEventDelta::changed` bit: the sync engine decrypted new notes.
+pub const WALLET_EVENT_NOTES: u32 = 1 << 1;
+/// `WalletEventDelta::changed` bit: total, spendable or pending balance moved.
+pub const WALLET_EVENT_BALANCE: u32 = 1 << 2;
+/// `WalletEventDelta::changed` bit: transactions not seen before were found.
+pub const WALLET_EVENT_NEW_TX: u32 = 1 << 3;
+
+/// Compact wallet change notification.
+///
+/// All fields carry the current value; `changed` says which of them moved
+/// since the previous delta. The first delta of a stream has the height,
+/// notes and balance bits set; transactions already in the wallet when the
+/// stream starts are not reported, so `WALLET_EVENT_NEW_TX` only appears once
+/// new ones arrive.
+#[derive(Debug, Clone, Copy, Default, PartialEq, Eq)]
+pub struct WalletEventDelta {
+    /// Bitmask of `WALLET_EVENT_*` flags.
+    pub changed: u32,
+    /// Local block height
+    pub local_height: u64,
+    /// Target block height
+    pub target_height: u64,
+    /// Notes decrypted in the current sync session
+    pub notes_decrypted: u64,
+    /// Total balance
+    pub balance_total: u64,
+    /// Spendable balance
+    pub balance_spendable: u64,
+    /// Pending balance (unconfirmed)
+    pub balance_pending: u64,
+    /// Transactions found since the previous delta
+    pub new_tx_count: u32,
+}
+
+/// How many recent transactions are compared when looking for new ones.
+const WALLET_EVENT_TX_WINDOW: u32 = 100;
+/// Balance and transactions are re-read at least this often even when the
+/// sync status is unchanged, so mempool activity is still reported.
+const WALLET_EVENT_IDLE_REFRESH: Duration = Duration::from_secs(5);
+
+/// Folds sampled wallet state into deltas.
+#[derive(Default)]
+struct WalletEventTracker {
+    last: Option<WalletEventDelta>,
+    seen_txids: std::collections::HashSet<String>,
+}
+
+impl WalletEventTracker {
+    /// Record the sync status. Returns true when height or notes moved, which
+    /// means balance and transactions are worth re-reading.
+    fn observe_status(&self, next: &mut WalletEventDelta, status: &SyncStatus) -> bool {
+        next.local_height = status.local_height;
+        next.target_height = status.target_height;
+        next.notes_decrypted = status.notes_decrypted;
+        match self.last {
+            Some(last) => {
+                last.local_height != next.local_height
+                    || last.target_height != next.target_height
+                    || last.notes_decrypted != next.notes_decrypted
+            }
+            None => true,
+        }
+    }
+
+    fn observe_transactions(&mut self, next: &mut WalletEventDelta, transactions: &[TxInfo]) {
+        let first = self.last.is_none() && self.seen_txids.is_empty();
+        let mut new_count = 0u32;
+        for tx_info in transactions {
+            if self.seen_txids.insert(tx_info.txid.clone()) && !first {
+                new_count = new_count.saturating_add(1);
+            }
+        }
+        if self.seen_txids.len() > 1000 {
+            self.seen_txids = transactions.iter().map(|tx| tx.txid.clone()).collect();
+        }
+        next.new_tx_count = next.new_tx_count.saturating_add(new_count);
+    }
+
+    /// Compare `next` with the previous delta. Returns the delta to emit, if
+    /// anything changed.
+    fn finish(&mut self, mut next: WalletEventDelta) -> Option<WalletEventDelta> {
+        next.changed = match self.last {
+            None => WALLET_EVENT_HEIGHT | WALLET_EVENT_NOTES | WALLET_EVENT_BALANCE,
+            Some(last) => {
+                let mut changed = 0;
+                if last.local_height != next.local_height
+                    || last.target_height != next.target_height
+                {
+                    changed |= WALLET_EVENT_HEIGHT;
+                }
+                if next.notes_decrypted > last.notes_decrypted {
+                    changed |= WALLET_EVENT_NOTES;
+                }
+                if last.balance_total != next.balance_total
+                    || last.balance_spendable != next.balance_spendable
+                    || last.balance_pending != next.balance_pending
+                {
+                    changed |= WALLET_EVENT_BALANCE;
+                }
+                changed
+            }
+        };
+        if next.new_tx_count > 0 {
+            next.changed |= WALLET_EVENT_NEW_TX;
+        }
+        self.last = Some(WalletEventDelta {
+            new_tx_count: 0,
+            ..next
+        });
+        (next.changed != 0).then_some(next)
+    }
+}
+
+/// Coalesced wallet event stream.
+///
+/// Samples the sync status once per `interval` and emits at most one
+/// [`WalletEventDelta`] per sample, only when something changed. Balance and
+/// recent transactions are re-read when the sync status moved, or every few
+/// seconds otherwise, so an idle wallet costs one status read per interval.
+pub async fn wallet_event_stream(
+    wallet_id: String,
+    interval: Duration,
+) -> mpsc::Receiver<WalletEventDelta> {
+    let (tx, rx) = mpsc::channel(16);
+
+    tokio::spawn(async move {
+        let mut tracker = WalletEventTracker::default();
+        let mut last_refresh: Option<std::time::Instant> = None;
+        let mut ticker = tokio::time::interval(interval);
+        ticker.set_missed_tick_behavior(tokio::time::MissedTickBehavior::Delay);
+
+        loop {
+            ticker.tick().await;
+            if tx.is_closed() {
+                break;
+            }
+
+            let mut next = tracker.last.unwrap_or_default();
+            next.new_tx_count = 0;
+            let status_moved = match sync_status(wallet_id.clone()) {
+                Ok(status) => tracker.observe_status(&mut next, &status),
+                Err(e) => {
+                    tracing::debug!("Wallet event stream status failed: {:?}", e);
+                    false
+                }
+            };
+
+            let refresh_due =
+                last_refresh.is_none_or(|at| at.elapsed() >= WALLET_EVENT_IDLE_REFRESH);
+            if status_moved || refresh_due {
+                last_refresh = Some(std::time::Instant::now());
+                if let Ok(balance) = crate::api::get_balance(wallet_id.clone()) {
+                    next.balance_total = balance.total;
+                    next.balance_spendable = balance.spendable;
+                    next.balance_pending = balance.pending;
+                }
+                if let Ok(transactions) =
+                    crate::api::list_transactions(wallet_id.clone(), Some(WALLET_EVENT_TX_WINDOW))
+                {
+                    tracker.observe_transactions(&mut next, &transactions);
+                }
+            }
+
+            if let Some(delta) = tracker.finish(next) {
+                if tx.send(delta).await.is_err() {
+                    break;
+                }
+            }
+        }
+
+        tracing::debug!("Wallet event stream ended for wallet {}", wallet_id);
+    });
+
+    rx
+}
+
 /// Get latest sync status snapshot (non-streaming)
 pub fn get_sync_status_snapshot(wallet_id: &str) -> Option<SyncStatus> {
     sync_status(wallet_id.to_string()).ok()
@@ -237,4 +415,34 @@ mod tests {
         // Stream should be created
         assert!(!rx.is_closed());
     }
+
+    #[test]
+    fn test_wallet_event_tracker_reports_only_changes() {
+        let mut tracker = WalletEventTracker::default();
+        let first = tracker
+            .finish(WalletEventDelta {
+                local_height: 10,
+                balance_total: 5,
+                ..Default::default()
+            })
+            .expect("first delta is always emitted");
+        assert_eq!(
+            first.changed,
+            WALLET_EVENT_HEIGHT | WALLET_EVENT_NOTES | WALLET_EVENT_BALANCE
+        );
+
+        let unchanged = tracker.last.unwrap();
+        assert_eq!(tracker.finish(unchanged), None);
+
+        let moved = tracker
+            .finish(WalletEventDelta {
+                local_height: 11,
+                new_tx_count: 2,
+                ..unchanged
+            })
+            .unwrap();
+        assert_eq!(moved.changed, WALLET_EVENT_HEIGHT | WALLET_EVENT_NEW_TX);
+        assert_eq!(moved.new_tx_count, 2);
+        assert_eq!(tracker.last.unwrap().new_tx_count, 0);
+    }
 }
@@ -9,6 +9,8 @@ ANDROID_SRC="$PROJECT_ROOT/bindings/android-sdk/src/main/jniLibs"
 ANDROID_DST="$PLUGIN_DIR/android/src/main/jniLibs"
 IOS_SRC="$PROJECT_ROOT/bindings/ios-sdk/Frameworks/PirateWalletNative.xcframework"
 IOS_DST_DIR="$PLUGIN_DIR/ios/Frameworks"
+FFI_HEADER="$PROJECT_ROOT/crates/pirate-ffi-native/pirate_wallet_service.h"
+HEADER_DST_DIR="$PLUGIN_DIR/android/src/main/cpp/include"
 
 if [[ ! -d "$ANDROID_SRC" ]]; then
   echo "Missing Android JNI libraries: $ANDROID_SRC" >&2
@@ -20,12 +22,17 @@ if [[ ! -d "$IOS_SRC" ]]; then
   exit 1
 fi
 
-mkdir -p "$ANDROID_DST" "$IOS_DST_DIR"
+mkdir -p "$ANDROID_DST" "$IOS_DST_DIR" "$HEADER_DST_DIR"
 rm -rf "$ANDROID_DST"/*
 cp -R "$ANDROID_SRC"/. "$ANDROID_DST"/
 
 rm -rf "$IOS_DST_DIR/PirateWalletNative.xcframework"
 cp -R "$IOS_SRC" "$IOS_DST_DIR/"
 
+# The Android JSI library compiles against the C API; on iOS the header ships
+# inside the XCFramework.
+cp "$FFI_HEADER" "$HEADER_DST_DIR/"
+
 echo "Staged Android JNI libraries into $ANDROID_DST"
 echo "Staged iOS XCFramework into $IOS_DST_DIR"
+echo "Staged C API header into $HEADER_DST_DIR"